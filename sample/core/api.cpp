@@ -68,7 +68,7 @@ rt::SysNamespaceInitializer::SysNamespaceInitializer(InitFn fn) {
 }
 
 
-gc::Local<rt::Value> rt::create_sys_namespace_value(const gc::Local<rt::ExecContext>& context) {
+rt::ValueLoc rt::create_sys_namespace_value(const gc::Local<rt::ExecContext>& context) {
 	std::size_t class_id = s_init_sys_namespace.get_class_id();
 	gc::Local<SysClass> cls = context->get_value_factory()->get_sys_class(class_id);
 	return gc::create<SysNamespaceValue>(cls);
@@ -88,6 +88,7 @@ void link__api() {
 	void link__api_file();
 	void link__api_io();
 	void link__api_socket();
+	void link__api_thread();
 
 	link__api_basic();
 	link__api_collections();
@@ -95,4 +96,5 @@ void link__api() {
 	link__api_file();
 	link__api_io();
 	link__api_socket();
+	link__api_thread();
 }
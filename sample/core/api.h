@@ -48,7 +48,10 @@ namespace syn_script {
 			SysNamespaceInitializer(InitFn fn);
 		};
 
-		gc::Local<Value> create_sys_namespace_value(const gc::Local<rt::ExecContext>& context);
+		ValueLoc create_sys_namespace_value(const gc::Local<rt::ExecContext>& context);
+
+		//Waits until all threads started by scripts have finished. GC is disabled while waiting.
+		void wait_for_script_threads();
 
 	}
 }
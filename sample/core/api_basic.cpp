@@ -86,7 +86,7 @@ ss::StringLoc rt::StringValue::to_string(const gc::Local<ExecContext>& context)
 	return m_value;
 }
 
-gc::Local<rt::Value> rt::StringValue::get_array_element(const gc::Local<ExecContext>& context, std::size_t index) {
+rt::ValueLoc rt::StringValue::get_array_element(const gc::Local<ExecContext>& context, std::size_t index) {
 	if (index >= m_value->length()) throw RuntimeError("Index out of bounds");
 	return context->get_value_factory()->get_integer_value(m_value->char_at(index));
 }
@@ -95,7 +95,7 @@ ss::StringLoc rt::StringValue::typeof(const gc::Local<ExecContext>& context) con
 	return gc::create<String>("string");
 }
 
-bool rt::StringValue::value_equals(const gc::Local<const Value>& value) const {
+bool rt::StringValue::value_equals(const ValueLoc& value) const {
 	const StringValue* v = dynamic_cast<const StringValue*>(value.get());
 	return v && m_value->equals(v->m_value);
 }
@@ -104,12 +104,18 @@ std::size_t rt::StringValue::value_hash_code() const {
 	return m_value->hash_code();
 }
 
-int rt::StringValue::value_compare_to(const gc::Local<Value>& value) const {
+int rt::StringValue::value_compare_to(const ValueLoc& value) const {
 	const StringValue* v = dynamic_cast<const StringValue*>(value.get());
 	if (!v) throw RuntimeError("wrong type");
 	return m_value->compare_to(v->m_value);
 }
 
+rt::ValueLoc rt::StringValue::copy_value(ValueCopier& copier) {
+	//A string is immutable, but a concatenation is flattened on access, so the copy is made flat.
+	StringLoc str = gc::create<String>(m_value->get_std_string());
+	return gc::create<StringValue>(str);
+}
+
 std::size_t rt::StringValue::get_sys_class_id() const {
 	return API::get_class_id();
 }
@@ -213,7 +219,7 @@ gc::Local<rt::ValueArray> rt::StringValue::api_get_lines(const gc::Local<ExecCon
 	return array;
 }
 
-bool rt::StringValue::api_equals(const gc::Local<ExecContext>& context, const gc::Local<const Value>& value) {
+bool rt::StringValue::api_equals(const gc::Local<ExecContext>& context, const ValueLoc& value) {
 	const Value* other_value = value.get();
 	const StringValue* other_str_value = dynamic_cast<const StringValue*>(other_value);
 	bool result = other_str_value ? m_value->equals(other_str_value->m_value) : false;
@@ -238,7 +244,7 @@ ss::ScriptIntegerType rt::StringValue::api_compare_to(
 	return int_to_scriptint(d);
 }
 
-gc::Local<rt::Value> rt::StringValue::api_char(const gc::Local<ExecContext>& context, ss::ScriptIntegerType code) {
+rt::ValueLoc rt::StringValue::api_char(const gc::Local<ExecContext>& context, ss::ScriptIntegerType code) {
 	char c = scriptint_to_char_ex(code);
 	return context->get_value_factory()->get_char_string_value(c);
 }
@@ -268,7 +274,7 @@ void rt::ByteArrayValue::initialize(const gc::Local<ss::ByteArray>& array) {
 	m_array = array;
 }
 
-gc::Local<rt::Value> rt::ByteArrayValue::get_array_element(
+rt::ValueLoc rt::ByteArrayValue::get_array_element(
 	const gc::Local<ExecContext>& context,
 	std::size_t index)
 {
@@ -283,7 +289,7 @@ gc::Local<rt::Value> rt::ByteArrayValue::get_array_element(
 void rt::ByteArrayValue::set_array_element(
 	const gc::Local<ExecContext>& context,
 	std::size_t index,
-	const gc::Local<Value>& value)
+	const ValueLoc& value)
 {
 	std::size_t length = m_array->length();
 	if (index >= length) throw RuntimeError("Array index out of bounds");
@@ -301,6 +307,13 @@ gc::Local<ss::ByteArray> rt::ByteArrayValue::get_array() const {
 	return m_array;
 }
 
+rt::ValueLoc rt::ByteArrayValue::copy_value(ValueCopier& copier) {
+	const std::size_t length = m_array->length();
+	gc::Local<ByteArray> array = ByteArray::create(length);
+	std::copy(m_array->raw_array(), m_array->raw_array(length), array->raw_array());
+	return gc::create<ByteArrayValue>(array);
+}
+
 std::size_t rt::ByteArrayValue::get_sys_class_id() const {
 	return API::get_class_id();
 }
@@ -370,7 +383,7 @@ public:
 
 	StringLoc to_string(const gc::Local<ExecContext>& context) const override;
 
-	gc::Local<Value> get_array_element(const gc::Local<ExecContext>& context, std::size_t index) override;
+	ValueLoc get_array_element(const gc::Local<ExecContext>& context, std::size_t index) override;
 
 protected:
 	std::size_t get_sys_class_id() const override;
@@ -385,7 +398,7 @@ private:
 	ScriptIntegerType api_char_at(const gc::Local<ExecContext>& context, ScriptIntegerType index);
 	StringLoc api_to_string(const gc::Local<ExecContext>& context);
 	void api_append_char(const gc::Local<ExecContext>& context, ScriptIntegerType value);
-	void api_append(const gc::Local<ExecContext>& context, const gc::Local<Value>& value);
+	void api_append(const gc::Local<ExecContext>& context, const ValueLoc& value);
 	void api_clear(const gc::Local<ExecContext>& context);
 
 public:
@@ -430,7 +443,7 @@ ss::StringLoc rt::StringBufferValue::to_string(const gc::Local<ExecContext>& con
 	return gc::create<String>(data, m_size);
 }
 
-gc::Local<rt::Value> rt::StringBufferValue::get_array_element(
+rt::ValueLoc rt::StringBufferValue::get_array_element(
 	const gc::Local<ExecContext>& context,
 	std::size_t index)
 {
@@ -485,16 +498,14 @@ void rt::StringBufferValue::api_append_char(const gc::Local<ExecContext>& contex
 	(*m_array)[m_size++] = c;
 }
 
-void rt::StringBufferValue::api_append(const gc::Local<ExecContext>& context, const gc::Local<Value>& value) {
+void rt::StringBufferValue::api_append(const gc::Local<ExecContext>& context, const ValueLoc& value) {
 	StringLoc str = value->to_string(context);
 	std::size_t len = str->length();
 	if (!len) return;
 
 	if (len > m_capacity || m_capacity - len < m_size) expand(m_size + len);
 
-	char* dst_data = m_array->raw_array() + m_size;
-	const char* src_data = str->get_raw_data();
-	for (std::size_t i = 0; i < len; ++i) dst_data[i] = src_data[i];
+	str->copy_to(m_array->raw_array() + m_size);
 
 	m_size += len;
 }
@@ -503,6 +514,107 @@ void rt::StringBufferValue::api_clear(const gc::Local<ExecContext>& context) {
 	m_size = 0;
 }
 
+//
+//GCStatsValue
+//
+
+namespace syn_script {
+	namespace rt {
+		class GCStatsValue;
+	}
+}
+
+//A snapshot of GC statistics, returned by sys.gc_stats().
+class rt::GCStatsValue : public SysObjectValue {
+	NONCOPYABLE(GCStatsValue);
+
+	gc::Statistics m_statistics;
+
+public:
+	GCStatsValue(){}
+	void initialize(const gc::Statistics& statistics);
+
+protected:
+	std::size_t get_sys_class_id() const override;
+
+private:
+	ScriptIntegerType api_max_heap_size(const gc::Local<ExecContext>& context);
+	ScriptIntegerType api_heap_limit(const gc::Local<ExecContext>& context);
+	ScriptIntegerType api_used_heap(const gc::Local<ExecContext>& context);
+	ScriptIntegerType api_live_size(const gc::Local<ExecContext>& context);
+	ScriptIntegerType api_full_collections(const gc::Local<ExecContext>& context);
+	ScriptIntegerType api_minor_collections(const gc::Local<ExecContext>& context);
+	ScriptIntegerType api_max_pause_ms(const gc::Local<ExecContext>& context);
+	ScriptIntegerType api_pause_target_ms(const gc::Local<ExecContext>& context);
+	ScriptIntegerType api_pauses(const gc::Local<ExecContext>& context);
+	ScriptIntegerType api_long_pauses(const gc::Local<ExecContext>& context);
+
+public:
+	class API;
+};
+
+class rt::GCStatsValue::API : public SysAPI<GCStatsValue> {
+	void init() override {
+		bld->add_field("max_heap_size", &GCStatsValue::api_max_heap_size);
+		bld->add_field("heap_limit", &GCStatsValue::api_heap_limit);
+		bld->add_field("used_heap", &GCStatsValue::api_used_heap);
+		bld->add_field("live_size", &GCStatsValue::api_live_size);
+		bld->add_field("full_collections", &GCStatsValue::api_full_collections);
+		bld->add_field("minor_collections", &GCStatsValue::api_minor_collections);
+		bld->add_field("max_pause_ms", &GCStatsValue::api_max_pause_ms);
+		bld->add_field("pause_target_ms", &GCStatsValue::api_pause_target_ms);
+		bld->add_field("pauses", &GCStatsValue::api_pauses);
+		bld->add_field("long_pauses", &GCStatsValue::api_long_pauses);
+	}
+};
+
+void rt::GCStatsValue::initialize(const gc::Statistics& statistics) {
+	m_statistics = statistics;
+}
+
+std::size_t rt::GCStatsValue::get_sys_class_id() const {
+	return API::get_class_id();
+}
+
+ss::ScriptIntegerType rt::GCStatsValue::api_max_heap_size(const gc::Local<ExecContext>& context) {
+	return m_statistics.m_max_heap_size;
+}
+
+ss::ScriptIntegerType rt::GCStatsValue::api_heap_limit(const gc::Local<ExecContext>& context) {
+	return m_statistics.m_heap_limit;
+}
+
+ss::ScriptIntegerType rt::GCStatsValue::api_used_heap(const gc::Local<ExecContext>& context) {
+	return m_statistics.m_used_heap;
+}
+
+ss::ScriptIntegerType rt::GCStatsValue::api_live_size(const gc::Local<ExecContext>& context) {
+	return m_statistics.m_live_size;
+}
+
+ss::ScriptIntegerType rt::GCStatsValue::api_full_collections(const gc::Local<ExecContext>& context) {
+	return m_statistics.m_full_collections;
+}
+
+ss::ScriptIntegerType rt::GCStatsValue::api_minor_collections(const gc::Local<ExecContext>& context) {
+	return m_statistics.m_minor_collections;
+}
+
+ss::ScriptIntegerType rt::GCStatsValue::api_max_pause_ms(const gc::Local<ExecContext>& context) {
+	return m_statistics.m_max_pause_ms;
+}
+
+ss::ScriptIntegerType rt::GCStatsValue::api_pause_target_ms(const gc::Local<ExecContext>& context) {
+	return m_statistics.m_pause_target_ms;
+}
+
+ss::ScriptIntegerType rt::GCStatsValue::api_pauses(const gc::Local<ExecContext>& context) {
+	return m_statistics.m_pauses;
+}
+
+ss::ScriptIntegerType rt::GCStatsValue::api_long_pauses(const gc::Local<ExecContext>& context) {
+	return m_statistics.m_long_pauses;
+}
 
 //
 //(Functions)
@@ -514,7 +626,8 @@ namespace syn_script {
 		StringLoc api_current_time_str(const gc::Local<ExecContext>& context);
 		ScriptIntegerType api_str_to_int(const gc::Local<ExecContext>& context, const StringLoc& str);
 		bool api_windows(const gc::Local<ExecContext>& context);
-		gc::Local<Value> api_args(const gc::Local<ExecContext>& context);
+		ValueLoc api_args(const gc::Local<ExecContext>& context);
+		gc::Local<GCStatsValue> api_gc_stats(const gc::Local<ExecContext>& context);
 	}
 }
 
@@ -575,10 +688,14 @@ bool rt::api_windows(const gc::Local<ExecContext>& context) {
 	return pf::IS_WINDOWS;
 }
 
-gc::Local<rt::Value> rt::api_args(const gc::Local<ExecContext>& context) {
+rt::ValueLoc rt::api_args(const gc::Local<ExecContext>& context) {
 	return context->get_value_factory()->get_arguments_value();
 }
 
+gc::Local<rt::GCStatsValue> rt::api_gc_stats(const gc::Local<ExecContext>& context) {
+	return gc::create<GCStatsValue>(gc::get_statistics());
+}
+
 //
 //(Misc.)
 //
@@ -588,9 +705,11 @@ namespace {
 		bld.add_class<rt::StringValue>("String");
 		bld.add_class<rt::ByteArrayValue>("Bytes");
 		bld.add_class<rt::StringBufferValue>("StringBuffer");
+		bld.add_class<rt::GCStatsValue>("GCStats");
 		bld.add_static_method("current_time_millis", &rt::api_current_time_millis);
 		bld.add_static_method("current_time_str", &rt::api_current_time_str);
 		bld.add_static_method("str_to_int", &rt::api_str_to_int);
+		bld.add_static_method("gc_stats", &rt::api_gc_stats);
 		bld.add_static_field("windows", &rt::api_windows);
 		bld.add_static_field("args", &rt::api_args);
 	});
@@ -44,13 +44,14 @@ public:
 	StringLoc get_string() const override;
 	StringLoc to_string(const gc::Local<ExecContext>& context) const override;
 
-	gc::Local<Value> get_array_element(const gc::Local<ExecContext>& context, std::size_t index) override;
+	ValueLoc get_array_element(const gc::Local<ExecContext>& context, std::size_t index) override;
 
 	StringLoc typeof(const gc::Local<ExecContext>& context) const override;
 
-	bool value_equals(const gc::Local<const Value>& value) const override;
+	bool value_equals(const ValueLoc& value) const override;
 	std::size_t value_hash_code() const override;
-	int value_compare_to(const gc::Local<Value>& value) const override;
+	int value_compare_to(const ValueLoc& value) const override;
+	ValueLoc copy_value(ValueCopier& copier) override;
 
 protected:
 	std::size_t get_sys_class_id() const override;
@@ -77,9 +78,9 @@ private:
 
 	gc::Local<ByteArrayValue> api_get_bytes(const gc::Local<ExecContext>& context);
 	gc::Local<ValueArray> api_get_lines(const gc::Local<ExecContext>& context);
-	bool api_equals(const gc::Local<ExecContext>& context, const gc::Local<const Value>& value);
+	bool api_equals(const gc::Local<ExecContext>& context, const ValueLoc& value);
 	ScriptIntegerType api_compare_to(const gc::Local<ExecContext>& context, const gc::Local<StringValue>& value);
-	static gc::Local<Value> api_char(const gc::Local<ExecContext>& context, ScriptIntegerType code);
+	static ValueLoc api_char(const gc::Local<ExecContext>& context, ScriptIntegerType code);
 
 public:
 	class API;
@@ -99,14 +100,15 @@ public:
 	void gc_enumerate_refs() override;
 	void initialize(const gc::Local<ByteArray>& array);
 
-	gc::Local<Value> get_array_element(const gc::Local<ExecContext>& context, std::size_t index) override;
+	ValueLoc get_array_element(const gc::Local<ExecContext>& context, std::size_t index) override;
 
 	void set_array_element(
 		const gc::Local<ExecContext>& context,
 		std::size_t index,
-		const gc::Local<Value>& value) override;
+		const ValueLoc& value) override;
 
 	gc::Local<ByteArray> get_array() const;
+	ValueLoc copy_value(ValueCopier& copier) override;
 
 protected:
 	std::size_t get_sys_class_id() const override;
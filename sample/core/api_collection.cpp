@@ -63,12 +63,14 @@ public:
 
 	StringLoc to_string(const gc::Local<ExecContext>& context) const override;
 	bool iterate(InternalValueIterator& iterator) override;
-	gc::Local<Value> get_array_element(const gc::Local<ExecContext>& context, std::size_t index) override;
+	ValueLoc get_array_element(const gc::Local<ExecContext>& context, std::size_t index) override;
 
 	void set_array_element(
 		const gc::Local<ExecContext>& context,
 		std::size_t index,
-		const gc::Local<Value>& value) override;
+		const ValueLoc& value) override;
+
+	ValueLoc copy_value(ValueCopier& copier) override;
 
 protected:
 	std::size_t get_sys_class_id() const override;
@@ -83,12 +85,12 @@ private:
 	bool api_is_empty(const gc::Local<ExecContext>& context);
 	ScriptIntegerType api_size(const gc::Local<ExecContext>& context);
 	void api_clear(const gc::Local<ExecContext>& context);
-	bool api_contains(const gc::Local<ExecContext>& context, const gc::Local<Value>& value);
-	ScriptIntegerType api_index_of(const gc::Local<ExecContext>& context, const gc::Local<Value>& value);
-	gc::Local<Value> api_get(const gc::Local<ExecContext>& context, ScriptIntegerType index);
+	bool api_contains(const gc::Local<ExecContext>& context, const ValueLoc& value);
+	ScriptIntegerType api_index_of(const gc::Local<ExecContext>& context, const ValueLoc& value);
+	ValueLoc api_get(const gc::Local<ExecContext>& context, ScriptIntegerType index);
 	void api_remove(const gc::Local<ExecContext>& context, ScriptIntegerType index);
 	gc::Local<ValueArray> api_to_array(const gc::Local<ExecContext>& context);
-	void api_add(const gc::Local<ExecContext>& context, const gc::Local<Value>& value);
+	void api_add(const gc::Local<ExecContext>& context, const ValueLoc& value);
 	void api_sort(const gc::Local<ExecContext>& context);
 
 public:
@@ -142,7 +144,7 @@ bool rt::ArrayListValue::iterate(InternalValueIterator& iterator) {
 	return true;
 }
 
-gc::Local<rt::Value> rt::ArrayListValue::get_array_element(
+rt::ValueLoc rt::ArrayListValue::get_array_element(
 	const gc::Local<ExecContext>& context,
 	std::size_t index)
 {
@@ -153,13 +155,20 @@ gc::Local<rt::Value> rt::ArrayListValue::get_array_element(
 void rt::ArrayListValue::set_array_element(
 	const gc::Local<ExecContext>& context,
 	std::size_t index,
-	const gc::Local<Value>& value)
+	const ValueLoc& value)
 {
 	assert(!!value);
 	if (index >= m_size) throw RuntimeError("index out of bounds");
 	(*m_array)[index] = value;
 }
 
+rt::ValueLoc rt::ArrayListValue::copy_value(ValueCopier& copier) {
+	gc::Local<ArrayListValue> list = gc::create<ArrayListValue>(m_size);
+	for (std::size_t i = 0; i < m_size; ++i) (*list->m_array)[i] = copier.copy((*m_array)[i]);
+	list->m_size = m_size;
+	return list;
+}
+
 std::size_t rt::ArrayListValue::get_sys_class_id() const {
 	return API::get_class_id();
 }
@@ -189,7 +198,7 @@ void rt::ArrayListValue::api_clear(const gc::Local<ExecContext>& context) {
 	m_size = 0;
 }
 
-bool rt::ArrayListValue::api_contains(const gc::Local<ExecContext>& context, const gc::Local<Value>& value) {
+bool rt::ArrayListValue::api_contains(const gc::Local<ExecContext>& context, const ValueLoc& value) {
 	assert(!!value);
 	for (std::size_t i = 0; i < m_size; ++i) {
 		if (value->value_equals((*m_array)[i])) return true;
@@ -197,7 +206,7 @@ bool rt::ArrayListValue::api_contains(const gc::Local<ExecContext>& context, con
 	return false;
 }
 
-ss::ScriptIntegerType rt::ArrayListValue::api_index_of(const gc::Local<ExecContext>& context, const gc::Local<Value>& value) {
+ss::ScriptIntegerType rt::ArrayListValue::api_index_of(const gc::Local<ExecContext>& context, const ValueLoc& value) {
 	assert(!!value);
 	for (std::size_t i = 0; i < m_size; ++i) {
 		if (value->value_equals((*m_array)[i])) return size_to_scriptint_ex(i);
@@ -205,7 +214,7 @@ ss::ScriptIntegerType rt::ArrayListValue::api_index_of(const gc::Local<ExecConte
 	return int_to_scriptint(-1);
 }
 
-gc::Local<rt::Value> rt::ArrayListValue::api_get(
+rt::ValueLoc rt::ArrayListValue::api_get(
 	const gc::Local<ExecContext>& context,
 	ss::ScriptIntegerType index)
 {
@@ -226,14 +235,14 @@ void rt::ArrayListValue::api_remove(
 	(*m_array)[m_size] = nullptr;
 }
 
-gc::Local<gc::Array<rt::Value>> rt::ArrayListValue::api_to_array(const gc::Local<ExecContext>& context) {
+gc::Local<rt::ValueArray> rt::ArrayListValue::api_to_array(const gc::Local<ExecContext>& context) {
 	//TODO Cache empty arrays.
 	gc::Local<ValueArray> array = ValueArray::create(m_size);
 	for (std::size_t i = 0; i < m_size; ++i) (*array)[i] = (*m_array)[i];
 	return array;
 }
 
-void rt::ArrayListValue::api_add(const gc::Local<ExecContext>& context, const gc::Local<Value>& value) {
+void rt::ArrayListValue::api_add(const gc::Local<ExecContext>& context, const ValueLoc& value) {
 	std::size_t capacity = m_array->length();
 	if (m_size >= capacity) {
 		std::size_t delta_capacity = capacity >> 1;
@@ -267,6 +276,7 @@ public:
 
 	StringLoc to_string(const gc::Local<ExecContext>& context) const override;
 	bool iterate(InternalValueIterator& iterator) override;
+	ValueLoc copy_value(ValueCopier& copier) override;
 
 protected:
 	std::size_t get_sys_class_id() const override;
@@ -277,10 +287,10 @@ private:
 	bool api_is_empty(const gc::Local<ExecContext>& context);
 	ScriptIntegerType api_size(const gc::Local<ExecContext>& context);
 	void api_clear(const gc::Local<ExecContext>& context);
-	bool api_contains(const gc::Local<ExecContext>& context, const gc::Local<Value>& value);
-	bool api_add(const gc::Local<ExecContext>& context, const gc::Local<Value>& value);
-	bool api_remove(const gc::Local<ExecContext>& context, const gc::Local<Value>& value);
-	gc::Local<gc::Array<Value>> api_to_array(const gc::Local<ExecContext>& context);
+	bool api_contains(const gc::Local<ExecContext>& context, const ValueLoc& value);
+	bool api_add(const gc::Local<ExecContext>& context, const ValueLoc& value);
+	bool api_remove(const gc::Local<ExecContext>& context, const ValueLoc& value);
+	gc::Local<ValueArray> api_to_array(const gc::Local<ExecContext>& context);
 
 public:
 	class API;
@@ -339,6 +349,17 @@ bool rt::HashSetValue::iterate(InternalValueIterator& iterator) {
 	return true;
 }
 
+rt::ValueLoc rt::HashSetValue::copy_value(ValueCopier& copier) {
+	gc::Local<HashSetValue> set = gc::create<HashSetValue>();
+	ValueHashMap::Iterator iter = m_map->iterator();
+	while (!iter.end()) {
+		ValueLoc value = copier.copy(iter.key());
+		set->m_map->put(value, value);
+		iter.next();
+	}
+	return set;
+}
+
 std::size_t rt::HashSetValue::get_sys_class_id() const {
 	return API::get_class_id();
 }
@@ -359,23 +380,23 @@ void rt::HashSetValue::api_clear(const gc::Local<ExecContext>& context) {
 	m_map->clear();
 }
 
-bool rt::HashSetValue::api_contains(const gc::Local<ExecContext>& context, const gc::Local<Value>& value) {
+bool rt::HashSetValue::api_contains(const gc::Local<ExecContext>& context, const ValueLoc& value) {
 	assert(!!value);
 	return m_map->contains(value);
 }
 
-bool rt::HashSetValue::api_add(const gc::Local<ExecContext>& context, const gc::Local<Value>& value) {
+bool rt::HashSetValue::api_add(const gc::Local<ExecContext>& context, const ValueLoc& value) {
 	assert(!!value);
-	gc::Local<Value> old_value = m_map->put(value, value);
+	ValueLoc old_value = m_map->put(value, value);
 	return !old_value;
 }
 
-bool rt::HashSetValue::api_remove(const gc::Local<ExecContext>& context, const gc::Local<Value>& value) {
-	gc::Local<Value> old_value = m_map->remove(value);
+bool rt::HashSetValue::api_remove(const gc::Local<ExecContext>& context, const ValueLoc& value) {
+	ValueLoc old_value = m_map->remove(value);
 	return !!old_value;
 }
 
-gc::Local<gc::Array<rt::Value>> rt::HashSetValue::api_to_array(const gc::Local<ExecContext>& context) {
+gc::Local<rt::ValueArray> rt::HashSetValue::api_to_array(const gc::Local<ExecContext>& context) {
 	return m_map->keys();
 }
 
@@ -415,17 +436,29 @@ const gc::Ref<rt::ValueHashMap>& rt::HashMapValue::get_map() const {
 	return m_map;
 }
 
+rt::ValueLoc rt::HashMapValue::copy_value(ValueCopier& copier) {
+	gc::Local<HashMapValue> map = gc::create<HashMapValue>();
+	ValueHashMap::Iterator iter = m_map->iterator();
+	while (!iter.end()) {
+		ValueLoc key = copier.copy(iter.key());
+		ValueLoc value = copier.copy(iter.value());
+		map->m_map->put(key, value);
+		iter.next();
+	}
+	return map;
+}
+
 std::size_t rt::HashMapValue::get_sys_class_id() const {
 	return API::get_class_id();
 }
 
-void rt::HashMapValue::check_key(const gc::Local<Value>& key) const {
+void rt::HashMapValue::check_key(const ValueLoc& key) const {
 	if (!key) throw RuntimeError("key == null");
 }
 
-gc::Local<rt::Value> rt::HashMapValue::external_value(
+rt::ValueLoc rt::HashMapValue::external_value(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<Value>& value) const
+	const ValueLoc& value) const
 {
 	return !!value ? value : context->get_value_factory()->get_null_value();
 }
@@ -446,36 +479,36 @@ void rt::HashMapValue::api_clear(const gc::Local<ExecContext>& context) {
 	m_map->clear();
 }
 
-bool rt::HashMapValue::api_contains(const gc::Local<ExecContext>& context, const gc::Local<Value>& key) {
+bool rt::HashMapValue::api_contains(const gc::Local<ExecContext>& context, const ValueLoc& key) {
 	check_key(key);
 	return m_map->contains(key);
 }
 
-gc::Local<rt::Value> rt::HashMapValue::api_get(const gc::Local<ExecContext>& context, const gc::Local<Value>& key) {
+rt::ValueLoc rt::HashMapValue::api_get(const gc::Local<ExecContext>& context, const ValueLoc& key) {
 	check_key(key);
 	return external_value(context, m_map->get(key));
 }
 
-gc::Local<rt::Value> rt::HashMapValue::api_remove(
+rt::ValueLoc rt::HashMapValue::api_remove(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<Value>& key)
+	const ValueLoc& key)
 {
 	check_key(key);
 	return external_value(context, m_map->remove(key));
 }
 
-gc::Local<gc::Array<rt::Value>> rt::HashMapValue::api_keys(const gc::Local<ExecContext>& context) {
+gc::Local<rt::ValueArray> rt::HashMapValue::api_keys(const gc::Local<ExecContext>& context) {
 	return m_map->keys();
 }
 
-gc::Local<gc::Array<rt::Value>> rt::HashMapValue::api_values(const gc::Local<ExecContext>& context) {
+gc::Local<rt::ValueArray> rt::HashMapValue::api_values(const gc::Local<ExecContext>& context) {
 	return m_map->values();
 }
 
-gc::Local<rt::Value> rt::HashMapValue::api_put(
+rt::ValueLoc rt::HashMapValue::api_put(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<Value>& key,
-	const gc::Local<Value>& value)
+	const ValueLoc& key,
+	const ValueLoc& value)
 {
 	check_key(key);
 	return external_value(context, m_map->put(key, value));
@@ -26,22 +26,23 @@
 #include "sysclassbld.h"
 #include "sysvalue.h"
 #include "value__dec.h"
+#include "value_handle.h"
 
 namespace syn_script {
 	namespace rt {
 
-		inline std::size_t value_hash_fn(const gc::Local<rt::Value>& key) {
+		inline std::size_t value_hash_fn(const rt::ValueLoc& key) {
 			assert(!!key);
 			return key->value_hash_code();
 		}
 
-		inline bool value_equals_fn(const gc::Local<rt::Value>& key1, const gc::Local<rt::Value>& key2) {
+		inline bool value_equals_fn(const rt::ValueLoc& key1, const rt::ValueLoc& key2) {
 			assert(!!key1);
 			assert(!!key2);
 			return key1->value_equals(key2);
 		}
 
-		typedef gc::BasicGenericHashMap<rt::Value, rt::Value, value_hash_fn, value_equals_fn> ValueHashMap;
+		typedef gc::BasicGenericHashMap<rt::ValueLoc, rt::ValueArray, value_hash_fn, value_equals_fn> ValueHashMap;
 
 		//
 		//HashMapValue
@@ -58,32 +59,33 @@ namespace syn_script {
 			void initialize();
 
 			const gc::Ref<ValueHashMap>& get_map() const;
+			ValueLoc copy_value(ValueCopier& copier) override;
 
 		protected:
 			std::size_t get_sys_class_id() const override;
 
 		private:
-			void check_key(const gc::Local<Value>& key) const;
+			void check_key(const ValueLoc& key) const;
 
-			gc::Local<Value> external_value(
+			ValueLoc external_value(
 				const gc::Local<ExecContext>& context,
-				const gc::Local<Value>& value) const;
+				const ValueLoc& value) const;
 
 			static gc::Local<HashMapValue> api_create(const gc::Local<ExecContext>& context);
 
 			bool api_is_empty(const gc::Local<ExecContext>& context);
 			ScriptIntegerType api_size(const gc::Local<ExecContext>& context);
 			void api_clear(const gc::Local<ExecContext>& context);
-			bool api_contains(const gc::Local<ExecContext>& context, const gc::Local<Value>& key);
-			gc::Local<Value> api_get(const gc::Local<ExecContext>& context, const gc::Local<Value>& key);
-			gc::Local<Value> api_remove(const gc::Local<ExecContext>& context, const gc::Local<Value>& key);
-			gc::Local<gc::Array<Value>> api_keys(const gc::Local<ExecContext>& context);
-			gc::Local<gc::Array<Value>> api_values(const gc::Local<ExecContext>& context);
+			bool api_contains(const gc::Local<ExecContext>& context, const ValueLoc& key);
+			ValueLoc api_get(const gc::Local<ExecContext>& context, const ValueLoc& key);
+			ValueLoc api_remove(const gc::Local<ExecContext>& context, const ValueLoc& key);
+			gc::Local<ValueArray> api_keys(const gc::Local<ExecContext>& context);
+			gc::Local<ValueArray> api_values(const gc::Local<ExecContext>& context);
 
-			gc::Local<Value> api_put(
+			ValueLoc api_put(
 				const gc::Local<ExecContext>& context,
-				const gc::Local<Value>& key,
-				const gc::Local<Value>& value);
+				const ValueLoc& key,
+				const ValueLoc& value);
 
 		public:
 			class API;
@@ -41,18 +41,18 @@ namespace {
 
 namespace syn_script {
 	namespace rt {
-		gc::Local<Value> api_execute_2(
+		ValueLoc api_execute_2(
 			const gc::Local<ExecContext>& context,
 			const StringLoc& file_name,
 			const StringLoc& code);
 
-		gc::Local<Value> api_execute_3(
+		ValueLoc api_execute_3(
 			const gc::Local<ExecContext>& context,
 			const StringLoc& file_name,
 			const StringLoc& code,
 			const gc::Local<HashMapValue>& scope);
 
-		gc::Local<Value> api_execute_ex(
+		ValueLoc api_execute_ex(
 			const gc::Local<ExecContext>& context,
 			const gc::Local<ValueArray>& sources,
 			const gc::Local<HashMapValue>& scope);
@@ -66,7 +66,7 @@ namespace {
 
 	struct RootScopeName {
 		gc::Local<rt::NameDescriptor> m_name_descriptor;
-		gc::Local<rt::Value> m_value;
+		rt::ValueLoc m_value;
 	};
 
 	//
@@ -89,10 +89,10 @@ namespace {
 
 			gc::Local<rt::ValueArray> keys = m_scope_map->keys();
 			for (std::size_t i = 0, n = keys->length(); i < n; ++i) {
-				gc::Local<rt::Value> key = (*keys)[i];
+				rt::ValueLoc key = (*keys)[i];
 				ss::StringLoc name = key->get_string();
 
-				gc::Local<rt::Value> value = m_scope_map->get(key);
+				rt::ValueLoc value = m_scope_map->get(key);
 				assert(!!value);
 
 				RootScopeName name_rec;
@@ -123,7 +123,7 @@ namespace {
 		}
 	}
 
-	gc::Local<rt::Value> execute_scripts(
+	rt::ValueLoc execute_scripts(
 		const gc::Local<rt::ExecContext>& context,
 		gc::Local<SourceArray> sources,
 		const gc::Local<rt::HashMapValue>& scope)
@@ -148,7 +148,7 @@ namespace {
 	}
 }
 
-gc::Local<rt::Value> rt::api_execute_2(
+rt::ValueLoc rt::api_execute_2(
 	const gc::Local<ExecContext>& context,
 	const ss::StringLoc& file_name,
 	const ss::StringLoc& code)
@@ -156,7 +156,7 @@ gc::Local<rt::Value> rt::api_execute_2(
 	return api_execute_3(context, file_name, code, nullptr);
 }
 
-gc::Local<rt::Value> rt::api_execute_3(
+rt::ValueLoc rt::api_execute_3(
 	const gc::Local<ExecContext>& context,
 	const ss::StringLoc& file_name,
 	const ss::StringLoc& code,
@@ -166,7 +166,7 @@ gc::Local<rt::Value> rt::api_execute_3(
 	return execute_scripts(context, sources, scope);
 }
 
-gc::Local<rt::Value> rt::api_execute_ex(
+rt::ValueLoc rt::api_execute_ex(
 	const gc::Local<ExecContext>& context,
 	const gc::Local<ValueArray>& sources,
 	const gc::Local<HashMapValue>& scope)
@@ -175,7 +175,7 @@ gc::Local<rt::Value> rt::api_execute_ex(
 	gc::Local<SourceArray> adapted_sources = SourceArray::create(count);
 
 	for (std::size_t i = 0; i < count; ++i) {
-		gc::Local<Value> value = sources->get(i);
+		ValueLoc value = sources->get(i);
 		gc::Local<ArrayValue> array_value = value.cast<ArrayValue>();
 		gc::Local<ValueArray> array = array_value->get_array();
 		if (2 != array->length()) throw RuntimeError("Invalid argument: array length != 2");
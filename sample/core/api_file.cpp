@@ -87,7 +87,7 @@ private:
 	bool api_is_file(const gc::Local<ExecContext>& context);
 	bool api_is_directory(const gc::Local<ExecContext>& context);
 	ScriptIntegerType api_get_size(const gc::Local<ExecContext>& context);
-	gc::Local<gc::Array<Value>> api_list_files(const gc::Local<ExecContext>& context);
+	gc::Local<ValueArray> api_list_files(const gc::Local<ExecContext>& context);
 	gc::Local<ByteArrayValue> api_read_bytes(const gc::Local<ExecContext>& context);
 	StringLoc api_read_text(const gc::Local<ExecContext>& context);
 	void api_write_text_1(const gc::Local<ExecContext>& context, const StringLoc& text);
@@ -241,11 +241,11 @@ ss::ScriptIntegerType rt::FileValue::api_get_size(const gc::Local<ExecContext>&
 	return ulonglong_to_scriptint_opt(info.m_size);
 }
 
-gc::Local<gc::Array<rt::Value>> rt::FileValue::api_list_files(const gc::Local<ExecContext>& context) {
+gc::Local<rt::ValueArray> rt::FileValue::api_list_files(const gc::Local<ExecContext>& context) {
 	gc::Local<StringArray> files = pf::list_files(m_path);
 	std::size_t cnt = files->length();
 	
-	gc::Local<gc::Array<Value>> values = gc::Array<Value>::create(cnt);
+	gc::Local<ValueArray> values = ValueArray::create(cnt);
 	for (std::size_t i = 0; i < cnt; ++i) {
 		StringLoc path = files->get(i);
 		values->get(i) = gc::create<FileValue>(path);
@@ -17,6 +17,7 @@
 //Input/output API.
 
 #include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <limits>
@@ -54,6 +55,7 @@ class rt::TextOutputValue::API : public SysAPI<TextOutputValue> {
 		bld->add_method("print", &TextOutputValue::api_print);
 		bld->add_method("println", &TextOutputValue::api_println_0);
 		bld->add_method("println", &TextOutputValue::api_println_1);
+		bld->add_method("flush", &TextOutputValue::api_flush);
 		bld->add_method("close", &TextOutputValue::api_close);
 	}
 };
@@ -66,9 +68,13 @@ std::size_t rt::TextOutputValue::get_sys_class_id() const {
 	return API::get_class_id();
 }
 
+bool rt::TextOutputValue::is_line_flushed() const {
+	return false;
+}
+
 void rt::TextOutputValue::close(){}
 
-void rt::TextOutputValue::api_print(const gc::Local<ExecContext>& context, const gc::Local<Value>& value) {
+void rt::TextOutputValue::api_print(const gc::Local<ExecContext>& context, const ValueLoc& value) {
 	std::ostream& out = get_out();
 	rt::OperandType type = value->get_operand_type();
 	if (rt::OperandType::INTEGER == type) {
@@ -87,15 +93,22 @@ void rt::TextOutputValue::api_print(const gc::Local<ExecContext>& context, const
 
 void rt::TextOutputValue::api_println_0(const gc::Local<ExecContext>& context) {
 	std::ostream& out = get_out();
-	out << std::endl;
+	out << '\n';
+	if (is_line_flushed()) out.flush();
 	if (out.fail()) throw RuntimeError("Write error");
 }
 
-void rt::TextOutputValue::api_println_1(const gc::Local<ExecContext>& context, const gc::Local<Value>& value) {
+void rt::TextOutputValue::api_println_1(const gc::Local<ExecContext>& context, const ValueLoc& value) {
 	api_print(context, value);
 	api_println_0(context);
 }
 
+void rt::TextOutputValue::api_flush(const gc::Local<ExecContext>& context) {
+	std::ostream& out = get_out();
+	out.flush();
+	if (out.fail()) throw RuntimeError("Write error");
+}
+
 void rt::TextOutputValue::api_close(const gc::Local<ExecContext>& context) {
 	close();
 }
@@ -111,6 +124,9 @@ public:
 	StdOutTextOutputValue(){}
 
 	std::ostream& get_out() override;
+
+protected:
+	bool is_line_flushed() const override;
 };
 
 //
@@ -121,6 +137,10 @@ std::ostream& rt::StdOutTextOutputValue::get_out() {
 	return std::cout;
 }
 
+bool rt::StdOutTextOutputValue::is_line_flushed() const {
+	return true;
+}
+
 //
 //FileTextOutputValue
 //
@@ -141,6 +161,25 @@ void rt::FileTextOutputValue::close() {
 	m_out.close();
 }
 
+//
+//(Buffer size)
+//
+
+namespace {
+	const std::size_t DEFAULT_BUFFER_SIZE = 8192;
+	const std::size_t MAX_BUFFER_SIZE = (std::size_t)16 << 20;
+
+	void check_buffer_size(std::size_t size) {
+		if (!size || size > MAX_BUFFER_SIZE) throw ss::RuntimeError("Invalid buffer size");
+	}
+
+	void check_bounds(const gc::Local<ss::ByteArray>& buffer, std::size_t ofs, std::size_t len) {
+		if (!buffer) throw ss::RuntimeError("Buffer is null");
+		std::size_t array_len = buffer->length();
+		if (len > array_len || ofs > array_len - len) throw ss::RuntimeError("Index out of bounds");
+	}
+}
+
 //
 //BinaryInputValue::API
 //
@@ -150,6 +189,8 @@ class rt::BinaryInputValue::API : public SysAPI<BinaryInputValue> {
 		bld->add_method("read_byte", &BinaryInputValue::api_read_byte);
 		bld->add_method("read", &BinaryInputValue::api_read_1);
 		bld->add_method("read", &BinaryInputValue::api_read_3);
+		bld->add_method("read_line", &BinaryInputValue::api_read_line);
+		bld->add_method("set_buffer_size", &BinaryInputValue::api_set_buffer_size);
 		bld->add_method("close", &BinaryInputValue::api_close);
 	}
 };
@@ -158,38 +199,103 @@ class rt::BinaryInputValue::API : public SysAPI<BinaryInputValue> {
 //BinaryInputValue
 //
 
-std::size_t rt::BinaryInputValue::get_sys_class_id() const {
-	return API::get_class_id();
+rt::BinaryInputValue::BinaryInputValue()
+	: m_buffer_size(DEFAULT_BUFFER_SIZE),
+	m_pos(0),
+	m_end(0)
+{}
+
+std::size_t rt::BinaryInputValue::read(char* ptr, std::size_t len, bool all) {
+	std::size_t count = std::min(len, m_end - m_pos);
+	if (count) {
+		std::memcpy(ptr, m_buffer.get() + m_pos, count);
+		m_pos += count;
+	}
+
+	while (count < len && (all || !count)) {
+		std::size_t rest = len - count;
+		if (rest >= m_buffer_size) {
+			//Large blocks are read directly.
+			std::size_t n = read_raw(ptr + count, rest);
+			if (!n) break;
+			count += n;
+		} else {
+			if (!fill()) break;
+			std::size_t n = std::min(rest, m_end);
+			std::memcpy(ptr + count, m_buffer.get(), n);
+			m_pos = n;
+			count += n;
+		}
+	}
+
+	return count;
 }
 
-int rt::BinaryInputValue::read(const gc::Local<ss::ByteArray>& buffer, std::size_t ofs, std::size_t len) {
-	std::size_t array_len = buffer->length();
-	if (len > array_len || ofs > array_len - len) throw RuntimeError("Index out of bounds");
+bool rt::BinaryInputValue::read_line(std::string& line) {
+	line.clear();
+	bool found = false;
 
-	static_assert(sizeof(int) <= sizeof(std::size_t), "Wrong type size");
-	std::size_t intmax = static_cast<std::size_t>(std::numeric_limits<int>::max());
-	if (len > intmax) len = intmax;
+	for (;;) {
+		if (m_pos == m_end && !fill()) break;
+		found = true;
 
-	char* ptr = buffer->raw_array() + ofs;
-	std::size_t initial_len = len;
-	while (len--) {
-		int k = read();
-		if (k == -1) break;
+		const char* begin = m_buffer.get() + m_pos;
+		const char* lf = static_cast<const char*>(std::memchr(begin, '\n', m_end - m_pos));
+		if (lf) {
+			line.append(begin, lf);
+			m_pos += lf - begin + 1;
+			if (!line.empty() && '\r' == line.back()) line.pop_back();
+			break;
+		}
 
-		assert(k >= 0);
-		unsigned char uc = k;
-		*ptr++ = reinterpret_cast<char&>(uc);
+		line.append(begin, m_end - m_pos);
+		m_pos = m_end;
 	}
 
-	std::size_t count = initial_len - len;
-	return static_cast<int>(count);
+	return found;
 }
 
-int rt::BinaryInputValue::read(const gc::Local<ss::ByteArray>& buffer) {
-	return read(buffer, 0, buffer->length());
+void rt::BinaryInputValue::set_buffer_size(std::size_t size) {
+	check_buffer_size(size);
+
+	//Bytes which have been read into the buffer, but not consumed yet, are kept.
+	std::size_t unread = m_end - m_pos;
+	if (unread) {
+		std::unique_ptr<char[]> buffer(new char[std::max(size, unread)]);
+		std::memcpy(buffer.get(), m_buffer.get() + m_pos, unread);
+		m_buffer = std::move(buffer);
+	} else {
+		m_buffer.reset();
+	}
+
+	m_buffer_size = size;
+	m_pos = 0;
+	m_end = unread;
 }
 
-void rt::BinaryInputValue::close(){}
+void rt::BinaryInputValue::close() {
+	m_buffer.reset();
+	m_pos = 0;
+	m_end = 0;
+	close_raw();
+}
+
+std::size_t rt::BinaryInputValue::get_sys_class_id() const {
+	return API::get_class_id();
+}
+
+void rt::BinaryInputValue::close_raw(){}
+
+//Reads the next block from the source. Returns false at the end of the input.
+bool rt::BinaryInputValue::fill() {
+	assert(m_pos == m_end);
+	if (!m_buffer) m_buffer.reset(new char[m_buffer_size]);
+
+	m_pos = 0;
+	m_end = 0;
+	m_end = read_raw(m_buffer.get(), m_buffer_size);
+	return m_end > 0;
+}
 
 ss::ScriptIntegerType rt::BinaryInputValue::api_read_byte(const gc::Local<ExecContext>& context) {
 	return int_to_scriptint_ex(read());
@@ -203,14 +309,33 @@ ss::ScriptIntegerType rt::BinaryInputValue::api_read_3(
 {
 	std::size_t sofs = scriptint_to_size_ex(ofs);
 	std::size_t slen = scriptint_to_size_ex(len);
-	return read(buffer, sofs, slen);
+	check_bounds(buffer, sofs, slen);
+
+	static_assert(sizeof(int) <= sizeof(std::size_t), "Wrong type size");
+	std::size_t intmax = static_cast<std::size_t>(std::numeric_limits<int>::max());
+	if (slen > intmax) slen = intmax;
+	if (!slen) return 0;
+
+	std::size_t count = read(buffer->raw_array() + sofs, slen, true);
+	return count ? size_to_scriptint_ex(count) : int_to_scriptint_ex(-1);
 }
 
 ss::ScriptIntegerType rt::BinaryInputValue::api_read_1(
 	const gc::Local<ExecContext>& context,
 	const gc::Local<ss::ByteArray>& buffer)
 {
-	return read(buffer);
+	if (!buffer) throw RuntimeError("Buffer is null");
+	return api_read_3(context, buffer, 0, size_to_scriptint_ex(buffer->length()));
+}
+
+ss::StringLoc rt::BinaryInputValue::api_read_line(const gc::Local<ExecContext>& context) {
+	std::string line;
+	if (!read_line(line)) return nullptr;
+	return gc::create<String>(line);
+}
+
+void rt::BinaryInputValue::api_set_buffer_size(const gc::Local<ExecContext>& context, ss::ScriptIntegerType size) {
+	set_buffer_size(scriptint_to_size_ex(size));
 }
 
 void rt::BinaryInputValue::api_close(const gc::Local<ExecContext>& context) {
@@ -226,6 +351,8 @@ class rt::BinaryOutputValue::API : public SysAPI<BinaryOutputValue> {
 		bld->add_method("write_byte", &BinaryOutputValue::api_write_byte);
 		bld->add_method("write", &BinaryOutputValue::api_write_1);
 		bld->add_method("write", &BinaryOutputValue::api_write_3);
+		bld->add_method("flush", &BinaryOutputValue::api_flush);
+		bld->add_method("set_buffer_size", &BinaryOutputValue::api_set_buffer_size);
 		bld->add_method("close", &BinaryOutputValue::api_close);
 	}
 };
@@ -234,27 +361,83 @@ class rt::BinaryOutputValue::API : public SysAPI<BinaryOutputValue> {
 //BinaryOutputValue
 //
 
+rt::BinaryOutputValue::BinaryOutputValue()
+	: m_buffer_size(DEFAULT_BUFFER_SIZE),
+	m_capacity(0),
+	m_pos(0)
+{}
+
+void rt::BinaryOutputValue::write(const char* ptr, std::size_t len) {
+	if (len >= m_buffer_size) {
+		//Large blocks are written directly.
+		flush_buffer();
+		write_raw(ptr, len);
+		return;
+	}
+
+	while (len) {
+		if (m_pos == m_capacity) make_room();
+		std::size_t n = std::min(len, m_capacity - m_pos);
+		std::memcpy(m_buffer.get() + m_pos, ptr, n);
+		m_pos += n;
+		ptr += n;
+		len -= n;
+	}
+}
+
+void rt::BinaryOutputValue::flush() {
+	flush_buffer();
+	flush_raw();
+}
+
+void rt::BinaryOutputValue::set_buffer_size(std::size_t size) {
+	check_buffer_size(size);
+	flush_buffer();
+	m_buffer.reset();
+	m_buffer_size = size;
+	m_capacity = 0;
+}
+
+void rt::BinaryOutputValue::close() {
+	flush_buffer();
+	m_buffer.reset();
+	m_capacity = 0;
+	close_raw();
+}
+
 std::size_t rt::BinaryOutputValue::get_sys_class_id() const {
 	return API::get_class_id();
 }
 
-void rt::BinaryOutputValue::write(const gc::Local<ss::ByteArray>& buffer, std::size_t ofs, std::size_t len) {
-	std::size_t array_len = buffer->length();
-	if (len > array_len || ofs > array_len - len) throw RuntimeError("Index out of bounds");
+void rt::BinaryOutputValue::flush_raw(){}
 
-	const char* ptr = buffer->raw_array() + ofs;
-	while (len--) {
-		char c = *ptr++;
-		int k = reinterpret_cast<unsigned char&>(c);
-		write(k);
-	}
+void rt::BinaryOutputValue::close_raw(){}
+
+//Returns the buffered bytes which have not been written yet. Used by destructors of derived classes, which must
+//write the bytes without write_raw(): referenced objects may already be deleted, and errors cannot be reported.
+std::size_t rt::BinaryOutputValue::get_pending_bytes(const char*& ptr) const {
+	ptr = m_buffer.get();
+	return m_pos;
 }
 
-void rt::BinaryOutputValue::write(const gc::Local<ss::ByteArray>& buffer) {
-	write(buffer, 0, buffer->length());
+//Writes the buffered bytes to the destination.
+void rt::BinaryOutputValue::flush_buffer() {
+	if (m_pos) {
+		//The bytes are dropped if the write fails, so a failed write is not repeated.
+		std::size_t len = m_pos;
+		m_pos = 0;
+		write_raw(m_buffer.get(), len);
+	}
 }
 
-void rt::BinaryOutputValue::close(){}
+//Empties the buffer, allocating it if it has not been allocated yet.
+void rt::BinaryOutputValue::make_room() {
+	flush_buffer();
+	if (!m_capacity) {
+		m_buffer.reset(new char[m_buffer_size]);
+		m_capacity = m_buffer_size;
+	}
+}
 
 void rt::BinaryOutputValue::api_write_byte(const gc::Local<ExecContext>& context, ss::ScriptIntegerType value) {
 	int ivalue = scriptint_to_int_ex(value);
@@ -269,11 +452,21 @@ void rt::BinaryOutputValue::api_write_3(
 {
 	std::size_t sofs = scriptint_to_size_ex(ofs);
 	std::size_t slen = scriptint_to_size_ex(len);
-	write(buffer, sofs, slen);
+	check_bounds(buffer, sofs, slen);
+	write(buffer->raw_array() + sofs, slen);
 }
 
 void rt::BinaryOutputValue::api_write_1(const gc::Local<ExecContext>& context, const gc::Local<ss::ByteArray>& buffer) {
-	write(buffer);
+	if (!buffer) throw RuntimeError("Buffer is null");
+	write(buffer->raw_array(), buffer->length());
+}
+
+void rt::BinaryOutputValue::api_flush(const gc::Local<ExecContext>& context) {
+	flush();
+}
+
+void rt::BinaryOutputValue::api_set_buffer_size(const gc::Local<ExecContext>& context, ss::ScriptIntegerType size) {
+	set_buffer_size(scriptint_to_size_ex(size));
 }
 
 void rt::BinaryOutputValue::api_close(const gc::Local<ExecContext>& context) {
@@ -286,44 +479,24 @@ void rt::BinaryOutputValue::api_close(const gc::Local<ExecContext>& context) {
 
 void rt::FileBinaryInputValue::initialize(const ss::StringLoc& path) {
 	const std::string path_str = path->get_std_string();
+
+	//The stream is not buffered, since BinaryInputValue has its own buffer.
+	m_in.rdbuf()->pubsetbuf(nullptr, 0);
 	m_in.open(path_str, std::ios_base::out | std::ios_base::binary);
 	if (m_in.fail()) throw RuntimeError(std::string("Unable to open file: ") + path_str);
 }
 
-int rt::FileBinaryInputValue::read() {
-	char c;
-	m_in.read(&c, 1);
-	if (m_in.eof()) return -1;
-	if (m_in.fail()) throw RuntimeError("Read error");
-
-	return reinterpret_cast<unsigned char&>(c);
-}
-
-int rt::FileBinaryInputValue::read(const gc::Local<ss::ByteArray>& buffer, std::size_t ofs, std::size_t len) {
-	std::size_t array_len = buffer->length();
-	if (len > array_len || ofs > array_len - len) throw RuntimeError("Index out of bounds");
-
+std::size_t rt::FileBinaryInputValue::read_raw(char* ptr, std::size_t len) {
 	const std::streamsize sizemax = std::numeric_limits<std::streamsize>::max();
-	if (len > sizemax) len = static_cast<std::size_t>(sizemax);
+	if (len > static_cast<std::size_t>(sizemax)) len = static_cast<std::size_t>(sizemax);
 
-	static_assert(sizeof(int) <= sizeof(std::size_t), "Wrong sizeof");
-	const std::size_t intmax = static_cast<std::size_t>(std::numeric_limits<int>::max());
-	if (len > intmax) len = static_cast<std::size_t>(intmax);
-
-	char* ptr = buffer->raw_array() + ofs;
 	m_in.read(ptr, len);
-
-	if (m_in.eof()) {
-		std::streamsize count = m_in.gcount();
-		return count > 0 ? static_cast<int>(count) : -1;
-	} else if (m_in.fail()) {
-		throw RuntimeError("Read error");
-	} else {
-		return static_cast<int>(len);
-	}
+	if (m_in.eof()) return static_cast<std::size_t>(m_in.gcount());
+	if (m_in.fail()) throw RuntimeError("Read error");
+	return len;
 }
 
-void rt::FileBinaryInputValue::close() {
+void rt::FileBinaryInputValue::close_raw() {
 	m_in.close();
 }
 
@@ -331,32 +504,35 @@ void rt::FileBinaryInputValue::close() {
 //FileBinaryOutputValue
 //
 
+rt::FileBinaryOutputValue::~FileBinaryOutputValue() {
+	//Stream errors do not throw exceptions, so they are ignored.
+	const char* ptr;
+	std::size_t len = get_pending_bytes(ptr);
+	if (len) m_out.write(ptr, len);
+}
+
 void rt::FileBinaryOutputValue::initialize(const ss::StringLoc& path, bool append) {
 	const std::string path_str = path->get_std_string();
 	std::ios_base::openmode mode = append ? (std::ios_base::app | std::ios_base::ate)
 		: static_cast<std::ios_base::openmode>(0);
+
+	//The stream is not buffered, since BinaryOutputValue has its own buffer.
+	m_out.rdbuf()->pubsetbuf(nullptr, 0);
 	m_out.open(path_str, std::ios_base::out | std::ios_base::binary | mode);
 	if (m_out.fail()) throw RuntimeError(std::string("Unable to open file: ") + path_str);
 }
 
-void rt::FileBinaryOutputValue::write(int value) {
-	assert(value >= 0);
-	unsigned char uc = value;
-	m_out.put(reinterpret_cast<char&>(uc));
+void rt::FileBinaryOutputValue::write_raw(const char* ptr, std::size_t len) {
+	m_out.write(ptr, len);
 	if (m_out.fail()) throw RuntimeError("Write error");
 }
 
-void rt::FileBinaryOutputValue::write(const gc::Local<ss::ByteArray>& buffer, std::size_t ofs, std::size_t len) {
-	std::size_t array_len = buffer->length();
-	if (len > array_len || ofs > array_len - len) throw RuntimeError("Index out of bounds");
-
-	const char* ptr = buffer->raw_array() + ofs;
-	m_out.write(ptr, len);
-
+void rt::FileBinaryOutputValue::flush_raw() {
+	m_out.flush();
 	if (m_out.fail()) throw RuntimeError("Write error");
 }
 
-void rt::FileBinaryOutputValue::close() {
+void rt::FileBinaryOutputValue::close_raw() {
 	m_out.close();
 }
 
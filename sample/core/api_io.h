@@ -20,7 +20,9 @@
 #define SYNSAMPLE_CORE_API_IO_H_INCLUDED
 
 #include <fstream>
+#include <memory>
 #include <ostream>
+#include <string>
 
 #include "api.h"
 #include "gc.h"
@@ -51,12 +53,15 @@ namespace syn_script {
 		protected:
 			std::size_t get_sys_class_id() const override;
 
+			//Returns true if the output is flushed after every line.
+			virtual bool is_line_flushed() const;
 			virtual void close();
 
 		private:
-			void api_print(const gc::Local<ExecContext>& context, const gc::Local<Value>& value);
+			void api_print(const gc::Local<ExecContext>& context, const ValueLoc& value);
 			void api_println_0(const gc::Local<ExecContext>& context);
-			void api_println_1(const gc::Local<ExecContext>& context, const gc::Local<Value>& value);
+			void api_println_1(const gc::Local<ExecContext>& context, const ValueLoc& value);
+			void api_flush(const gc::Local<ExecContext>& context);
 			void api_close(const gc::Local<ExecContext>& context);
 		};
 
@@ -83,24 +88,52 @@ namespace syn_script {
 		//BinaryInputValue
 		//
 
+		//Buffered binary input. The source is read in blocks of the buffer size.
 		class BinaryInputValue : public SysObjectValue {
 			NONCOPYABLE(BinaryInputValue);
 
 			friend class SysAPI<BinaryInputValue>;
 			class API;
 
+			std::unique_ptr<char[]> m_buffer;
+			std::size_t m_buffer_size;
+			std::size_t m_pos;
+			std::size_t m_end;
+
 		protected:
-			BinaryInputValue(){}
+			BinaryInputValue();
+
+		public:
+			//Returns the next byte, or -1 at the end of the input.
+			int read() {
+				if (m_pos == m_end && !fill()) return -1;
+				return static_cast<unsigned char>(m_buffer[m_pos++]);
+			}
+
+			//Reads up to len bytes, returns 0 at the end of the input. Unless all is set, stops after the first
+			//read from the source, so it does not wait for more data than is available.
+			std::size_t read(char* ptr, std::size_t len, bool all);
+
+			//Reads a line terminated by LF, dropping the LF and a CR before it. Returns false at the end of the
+			//input.
+			bool read_line(std::string& line);
+
+			//Returns the number of bytes which have been read from the source, but not consumed yet.
+			std::size_t available() const { return m_end - m_pos; }
+
+			void set_buffer_size(std::size_t size);
+			void close();
 
 		protected:
 			std::size_t get_sys_class_id() const override;
 
-			virtual int read() = 0;
-			virtual int read(const gc::Local<ByteArray>& buffer, std::size_t ofs, std::size_t len);
-			virtual int read(const gc::Local<ByteArray>& buffer);
-			virtual void close();
+			//Reads up to len bytes from the source, returns 0 at the end of the input.
+			virtual std::size_t read_raw(char* ptr, std::size_t len) = 0;
+			virtual void close_raw();
 
 		private:
+			bool fill();
+
 			ScriptIntegerType api_read_byte(const gc::Local<ExecContext>& context);
 			
 			ScriptIntegerType api_read_3(
@@ -110,32 +143,56 @@ namespace syn_script {
 				ScriptIntegerType len);
 
 			ScriptIntegerType api_read_1(const gc::Local<ExecContext>& context, const gc::Local<ByteArray>& buffer);
-
-			virtual void api_close(const gc::Local<ExecContext>& context);
+			StringLoc api_read_line(const gc::Local<ExecContext>& context);
+			void api_set_buffer_size(const gc::Local<ExecContext>& context, ScriptIntegerType size);
+			void api_close(const gc::Local<ExecContext>& context);
 		};
 
 		//
 		//BinaryOutputValue
 		//
 
+		//Buffered binary output. Bytes are written to the destination when the buffer is full, or on flush() and
+		//close(). Derived classes write the remaining bytes when the output is destroyed without being closed.
 		class BinaryOutputValue : public SysObjectValue {
 			NONCOPYABLE(BinaryOutputValue);
 
 			friend class SysAPI<BinaryOutputValue>;
 			class API;
 
+			std::unique_ptr<char[]> m_buffer;
+			std::size_t m_buffer_size;
+			std::size_t m_capacity;
+			std::size_t m_pos;
+
 		protected:
-			BinaryOutputValue(){}
+			BinaryOutputValue();
+
+		public:
+			void write(int value) {
+				if (m_pos == m_capacity) make_room();
+				unsigned char uc = value;
+				m_buffer[m_pos++] = static_cast<char>(uc);
+			}
+
+			void write(const char* ptr, std::size_t len);
+			void flush();
+			void set_buffer_size(std::size_t size);
+			void close();
 
 		protected:
 			std::size_t get_sys_class_id() const override;
 
-			virtual void write(int value) = 0;
-			virtual void write(const gc::Local<ByteArray>& buffer, std::size_t ofs, std::size_t len);
-			virtual void write(const gc::Local<ByteArray>& buffer);
-			virtual void close();
+			virtual void write_raw(const char* ptr, std::size_t len) = 0;
+			virtual void flush_raw();
+			virtual void close_raw();
+
+			std::size_t get_pending_bytes(const char*& ptr) const;
 
 		private:
+			void flush_buffer();
+			void make_room();
+
 			void api_write_byte(const gc::Local<ExecContext>& context, ScriptIntegerType value);
 			
 			void api_write_3(
@@ -145,6 +202,8 @@ namespace syn_script {
 				ScriptIntegerType len);
 
 			void api_write_1(const gc::Local<ExecContext>& context, const gc::Local<ByteArray>& buffer);
+			void api_flush(const gc::Local<ExecContext>& context);
+			void api_set_buffer_size(const gc::Local<ExecContext>& context, ScriptIntegerType size);
 			void api_close(const gc::Local<ExecContext>& context);
 		};
 
@@ -162,9 +221,8 @@ namespace syn_script {
 			void initialize(const StringLoc& path);
 
 		protected:
-			int read() override;
-			virtual int read(const gc::Local<ByteArray>& buffer, std::size_t ofs, std::size_t len) override;
-			void close() override;
+			std::size_t read_raw(char* ptr, std::size_t len) override;
+			void close_raw() override;
 		};
 
 		//
@@ -178,12 +236,13 @@ namespace syn_script {
 
 		public:
 			FileBinaryOutputValue(){}
+			~FileBinaryOutputValue();
 			void initialize(const StringLoc& path, bool append);
 
 		protected:
-			void write(int value) override;
-			void write(const gc::Local<ByteArray>& buffer, std::size_t ofs, std::size_t len) override;
-			void close() override;
+			void write_raw(const char* ptr, std::size_t len) override;
+			void flush_raw() override;
+			void close_raw() override;
 		};
 
 	}
@@ -16,19 +16,26 @@
 
 //Socket API.
 
+#include <cstring>
 #include <iostream>
+#include <limits>
 #include <memory>
 #include <ostream>
+#include <string>
+#include <vector>
 
 #include "api.h"
 #include "api_basic.h"
+#include "api_io.h"
 #include "common.h"
 #include "gc.h"
+#include "platform.h"
 #include "platform_socket.h"
 #include "scope.h"
 #include "sysclass.h"
 #include "sysclassbld__imp.h"
 #include "value_core.h"
+#include "value_stack.h"
 
 namespace ss = syn_script;
 namespace gc = ss::gc;
@@ -37,19 +44,69 @@ namespace pf = ss::platform;
 
 namespace syn_script {
 	namespace rt {
+		class SocketInputValue;
+		class SocketOutputValue;
 		class SocketValue;
 		class ServerSocketValue;
+		class SocketWatch;
+		class EventTimer;
+		class EventLoopValue;
 	}
 }
 
+//
+//SocketInputValue : definition
+//
+
+class rt::SocketInputValue : public BinaryInputValue {
+	NONCOPYABLE(SocketInputValue);
+
+	gc::Ref<pf::Socket> m_socket;
+
+public:
+	SocketInputValue(){}
+	void gc_enumerate_refs() override;
+	void initialize(const gc::Local<pf::Socket>& socket);
+
+protected:
+	std::size_t read_raw(char* ptr, std::size_t len) override;
+};
+
+//
+//SocketOutputValue : definition
+//
+
+//Output bytes still buffered when the object is deleted are dropped: they are sent only by flush() or close(),
+//since a GC destructor must not perform network I/O, which could block the collection.
+class rt::SocketOutputValue : public BinaryOutputValue {
+	NONCOPYABLE(SocketOutputValue);
+
+	gc::Ref<pf::Socket> m_socket;
+
+public:
+	SocketOutputValue(){}
+	void gc_enumerate_refs() override;
+	void initialize(const gc::Local<pf::Socket>& socket);
+
+protected:
+	void write_raw(const char* ptr, std::size_t len) override;
+};
+
 //
 //SocketValue : definition
 //
 
+//Socket with buffered input and output. Pending output is flushed before reading, so a request is sent before
+//waiting for the response.
 class rt::SocketValue : public SysObjectValue {
 	NONCOPYABLE(SocketValue);
 
+	friend class EventLoopValue;
+
 	gc::Ref<pf::Socket> m_socket;
+	gc::Ref<SocketInputValue> m_in;
+	gc::Ref<SocketOutputValue> m_out;
+	gc::Ref<SocketWatch> m_watch;
 
 public:
 	SocketValue(){}
@@ -60,14 +117,6 @@ protected:
 	std::size_t get_sys_class_id() const override;
 
 private:
-	int read();
-	int read(const gc::Local<ByteArray>& buffer);
-	int read(const gc::Local<ByteArray>& buffer, std::size_t ofs, std::size_t len);
-
-	void write(int value);
-	void write(const gc::Local<ByteArray>& buffer);
-	void write(const gc::Local<ByteArray>& buffer, std::size_t ofs, std::size_t len);
-
 	static gc::Local<SocketValue> api_create(
 		const gc::Local<ExecContext>& context,
 		const StringLoc& host,
@@ -85,6 +134,7 @@ private:
 		ScriptIntegerType ofs,
 		ScriptIntegerType len);
 
+	StringLoc api_read_line(const gc::Local<ExecContext>& context);
 	void api_write_byte(const gc::Local<ExecContext>& context, ScriptIntegerType value);
 	void api_write_1(const gc::Local<ExecContext>& context, const gc::Local<ByteArray>& buffer);
 
@@ -94,6 +144,8 @@ private:
 		ScriptIntegerType ofs,
 		ScriptIntegerType len);
 
+	void api_flush(const gc::Local<ExecContext>& context);
+	void api_set_buffer_size(const gc::Local<ExecContext>& context, ScriptIntegerType size);
 	void api_close(const gc::Local<ExecContext>& context);
 
 public:
@@ -107,7 +159,10 @@ public:
 class rt::ServerSocketValue : public SysObjectValue {
 	NONCOPYABLE(ServerSocketValue);
 
+	friend class EventLoopValue;
+
 	gc::Ref<pf::ServerSocket> m_server_socket;
+	gc::Ref<SocketWatch> m_watch;
 
 public:
 	ServerSocketValue(){}
@@ -126,6 +181,141 @@ public:
 	class API;
 };
 
+//
+//SocketWatch : definition
+//
+
+//Registration of a socket or a server socket in an event loop. The token is the index of the watch in the loop
+//and identifies the socket in the poller.
+class rt::SocketWatch : public gc::Object {
+	NONCOPYABLE(SocketWatch);
+
+public:
+	gc::Ref<EventLoopValue> m_loop;
+	std::size_t m_token;
+	gc::Ref<SocketValue> m_socket;
+	gc::Ref<ServerSocketValue> m_server_socket;
+	ValueRef m_callback;
+
+	SocketWatch(){}
+	void gc_enumerate_refs() override;
+
+	void initialize(
+		const gc::Local<EventLoopValue>& loop,
+		std::size_t token,
+		const gc::Local<SocketValue>& socket,
+		const gc::Local<ServerSocketValue>& server_socket,
+		const ValueLoc& callback);
+};
+
+//
+//EventTimer : definition
+//
+
+class rt::EventTimer : public gc::Object {
+	NONCOPYABLE(EventTimer);
+
+public:
+	pf::TimeMs_t m_time;
+	ScriptIntegerType m_id;
+	ValueRef m_callback;
+
+	EventTimer(){}
+	void gc_enumerate_refs() override;
+	void initialize(pf::TimeMs_t time, ScriptIntegerType id, const ValueLoc& callback);
+
+	bool is_before(const gc::Local<EventTimer>& timer) const;
+};
+
+//
+//EventLoopValue : definition
+//
+
+//Multiplexes sockets and timers on one thread: run() waits for events and invokes the callbacks. A watched socket
+//is switched to non-blocking mode; its own read and write methods still wait, so output written by a callback is
+//sent before the callback returns. Waiting for events is a GC-disabled region, so an idle loop does not delay a
+//collection.
+class rt::EventLoopValue : public SysObjectValue {
+	NONCOPYABLE(EventLoopValue);
+
+	std::unique_ptr<pf::SocketPoller> m_poller;
+	gc::Ref<gc::Array<SocketWatch>> m_watches;
+	std::vector<std::size_t> m_free_tokens;
+	std::size_t m_watch_count;
+
+	//Tokens of the sockets which have input buffered in SocketValue, so the poller would not report them.
+	std::vector<std::size_t> m_buffered_tokens;
+	std::vector<std::size_t> m_ready_tokens;
+
+	//Binary heap, ordered by time and id.
+	gc::Ref<gc::Array<EventTimer>> m_timers;
+	std::size_t m_timer_count;
+	ScriptIntegerType m_last_timer_id;
+
+	std::unique_ptr<char[]> m_read_buffer;
+	bool m_running;
+	bool m_stopped;
+
+public:
+	EventLoopValue();
+	void gc_enumerate_refs() override;
+	void initialize();
+
+	void remove_watch(const gc::Local<SocketWatch>& watch);
+
+protected:
+	std::size_t get_sys_class_id() const override;
+
+private:
+	gc::Local<SocketWatch> add_watch(
+		pf::SocketHandle handle,
+		const gc::Local<SocketValue>& socket,
+		const gc::Local<ServerSocketValue>& server_socket,
+		const ValueLoc& callback);
+
+	void dispatch(const gc::Local<ExecContext>& context, std::size_t token);
+	void dispatch_accept(const gc::Local<ExecContext>& context, const gc::Local<SocketWatch>& watch);
+	void dispatch_data(const gc::Local<ExecContext>& context, const gc::Local<SocketWatch>& watch);
+	void dispatch_timers(const gc::Local<ExecContext>& context);
+	int get_wait_timeout() const;
+
+	void add_timer(const gc::Local<EventTimer>& timer);
+	void remove_timer(std::size_t index);
+	void sift_timer_up(std::size_t index);
+	void sift_timer_down(std::size_t index);
+
+	static void invoke_callback(
+		const gc::Local<ExecContext>& context,
+		const ValueLoc& callback,
+		const ArgSpan& arguments);
+
+	static gc::Local<EventLoopValue> api_create(const gc::Local<ExecContext>& context);
+
+	void api_on_accept(
+		const gc::Local<ExecContext>& context,
+		const gc::Local<ServerSocketValue>& server_socket,
+		const ValueLoc& callback);
+
+	void api_on_data(
+		const gc::Local<ExecContext>& context,
+		const gc::Local<SocketValue>& socket,
+		const ValueLoc& callback);
+
+	void api_remove(const gc::Local<ExecContext>& context, const ValueLoc& socket);
+
+	ScriptIntegerType api_set_timeout(
+		const gc::Local<ExecContext>& context,
+		ScriptIntegerType delay,
+		const ValueLoc& callback);
+
+	void api_cancel_timeout(const gc::Local<ExecContext>& context, ScriptIntegerType id);
+	void api_run(const gc::Local<ExecContext>& context);
+	void api_stop(const gc::Local<ExecContext>& context);
+
+public:
+	class API;
+};
+
 //
 //SocketValue::API
 //
@@ -138,63 +328,68 @@ class rt::SocketValue::API : public SysAPI<SocketValue> {
 		bld->add_method("read_byte", &SocketValue::api_read_byte);
 		bld->add_method("read", &SocketValue::api_read_1);
 		bld->add_method("read", &SocketValue::api_read_3);
+		bld->add_method("read_line", &SocketValue::api_read_line);
 		bld->add_method("write_byte", &SocketValue::api_write_byte);
 		bld->add_method("write", &SocketValue::api_write_1);
 		bld->add_method("write", &SocketValue::api_write_3);
+		bld->add_method("flush", &SocketValue::api_flush);
+		bld->add_method("set_buffer_size", &SocketValue::api_set_buffer_size);
 		bld->add_method("close", &SocketValue::api_close);
 	}
 };
 
 //
-//SocketValue : implementation
+//SocketInputValue : implementation
 //
 
-void rt::SocketValue::gc_enumerate_refs() {
+void rt::SocketInputValue::gc_enumerate_refs() {
 	gc_ref(m_socket);
 }
 
-void rt::SocketValue::initialize(const gc::Local<pf::Socket>& socket) {
-	assert(!!socket);
+void rt::SocketInputValue::initialize(const gc::Local<pf::Socket>& socket) {
 	m_socket = socket;
 }
 
-std::size_t rt::SocketValue::get_sys_class_id() const {
-	return API::get_class_id();
+std::size_t rt::SocketInputValue::read_raw(char* ptr, std::size_t len) {
+	return m_socket->read(ptr, len);
 }
 
-int rt::SocketValue::read() {
-	char buffer;
-	std::size_t count = m_socket->read(&buffer, 1);
-	unsigned char uc = reinterpret_cast<unsigned char&>(buffer);
-	return count ? uc : -1;
-}
+//
+//SocketOutputValue : implementation
+//
 
-int rt::SocketValue::read(const gc::Local<ss::ByteArray>& buffer) {
-	return read(buffer, 0, buffer->length());
+void rt::SocketOutputValue::gc_enumerate_refs() {
+	gc_ref(m_socket);
 }
 
-int rt::SocketValue::read(const gc::Local<ss::ByteArray>& buffer, std::size_t ofs, std::size_t len) {
-	static_assert(sizeof(int) <= sizeof(std::size_t), "Wrong type size");
-	std::size_t intmax = static_cast<std::size_t>(std::numeric_limits<int>::max());
-	if (len > intmax) len = intmax;
+void rt::SocketOutputValue::initialize(const gc::Local<pf::Socket>& socket) {
+	m_socket = socket;
+}
 
-	std::size_t count = m_socket->read(buffer->raw_array() + ofs, len);
-	if (!count) return -1;
-	return static_cast<int>(count);
+void rt::SocketOutputValue::write_raw(const char* ptr, std::size_t len) {
+	m_socket->write(ptr, len);
 }
 
-void rt::SocketValue::write(int value) {
-	unsigned char uc = value;
-	char buffer = reinterpret_cast<char&>(uc);
-	m_socket->write(&buffer, 1);
+//
+//SocketValue : implementation
+//
+
+void rt::SocketValue::gc_enumerate_refs() {
+	gc_ref(m_socket);
+	gc_ref(m_in);
+	gc_ref(m_out);
+	gc_ref(m_watch);
 }
 
-void rt::SocketValue::write(const gc::Local<ss::ByteArray>& buffer) {
-	write(buffer, 0, buffer->length());
+void rt::SocketValue::initialize(const gc::Local<pf::Socket>& socket) {
+	assert(!!socket);
+	m_socket = socket;
+	m_in = gc::create<SocketInputValue>(socket);
+	m_out = gc::create<SocketOutputValue>(socket);
 }
 
-void rt::SocketValue::write(const gc::Local<ss::ByteArray>& buffer, std::size_t ofs, std::size_t len) {
-	m_socket->write(buffer->raw_array() + ofs, len);
+std::size_t rt::SocketValue::get_sys_class_id() const {
+	return API::get_class_id();
 }
 
 gc::Local<rt::SocketValue> rt::SocketValue::api_create(
@@ -217,7 +412,8 @@ ss::ScriptIntegerType rt::SocketValue::api_get_remote_port(const gc::Local<ExecC
 }
 
 ss::ScriptIntegerType rt::SocketValue::api_read_byte(const gc::Local<ExecContext>& context) {
-	return int_to_scriptint_ex(read());
+	m_out->flush();
+	return int_to_scriptint_ex(m_in->read());
 }
 
 ss::ScriptIntegerType rt::SocketValue::api_read_1(
@@ -225,7 +421,7 @@ ss::ScriptIntegerType rt::SocketValue::api_read_1(
 	const gc::Local<ss::ByteArray>& buffer)
 {
 	if (!buffer) throw RuntimeError("Buffer is null");
-	return int_to_scriptint_ex(read(buffer));
+	return api_read_3(context, buffer, 0, size_to_scriptint_ex(buffer->length()));
 }
 	
 ss::ScriptIntegerType rt::SocketValue::api_read_3(
@@ -240,12 +436,27 @@ ss::ScriptIntegerType rt::SocketValue::api_read_3(
 
 	std::size_t sofs = scriptint_to_size_ex(ofs);
 	std::size_t slen = scriptint_to_size_ex(len);
-	return read(buffer, sofs, slen);
+
+	static_assert(sizeof(int) <= sizeof(std::size_t), "Wrong type size");
+	std::size_t intmax = static_cast<std::size_t>(std::numeric_limits<int>::max());
+	if (slen > intmax) slen = intmax;
+
+	//Returns the data which is available, without waiting for the whole buffer to be filled.
+	m_out->flush();
+	std::size_t count = m_in->read(buffer->raw_array() + sofs, slen, false);
+	return count ? size_to_scriptint_ex(count) : int_to_scriptint_ex(-1);
+}
+
+ss::StringLoc rt::SocketValue::api_read_line(const gc::Local<ExecContext>& context) {
+	m_out->flush();
+	std::string line;
+	if (!m_in->read_line(line)) return nullptr;
+	return gc::create<String>(line);
 }
 
 void rt::SocketValue::api_write_byte(const gc::Local<ExecContext>& context, ss::ScriptIntegerType value) {
 	int ivalue = scriptint_to_int_ex(value);
-	write(ivalue);
+	m_out->write(ivalue);
 }
 
 void rt::SocketValue::api_write_1(
@@ -253,7 +464,7 @@ void rt::SocketValue::api_write_1(
 	const gc::Local<ss::ByteArray>& buffer)
 {
 	if (!buffer) throw RuntimeError("Buffer is null");
-	write(buffer);
+	m_out->write(buffer->raw_array(), buffer->length());
 }
 
 void rt::SocketValue::api_write_3(
@@ -263,13 +474,35 @@ void rt::SocketValue::api_write_3(
 	ss::ScriptIntegerType len)
 {
 	if (!buffer) throw RuntimeError("Buffer is null");
+	std::size_t buffer_size = buffer->length();
+	if (len > buffer_size || ofs > buffer_size - len) throw RuntimeError("Index out of bounds");
 
 	std::size_t sofs = scriptint_to_size_ex(ofs);
 	std::size_t slen = scriptint_to_size_ex(len);
-	write(buffer, sofs, slen);
+	m_out->write(buffer->raw_array() + sofs, slen);
+}
+
+void rt::SocketValue::api_flush(const gc::Local<ExecContext>& context) {
+	m_out->flush();
+}
+
+void rt::SocketValue::api_set_buffer_size(const gc::Local<ExecContext>& context, ss::ScriptIntegerType size) {
+	std::size_t ssize = scriptint_to_size_ex(size);
+	m_in->set_buffer_size(ssize);
+	m_out->set_buffer_size(ssize);
 }
 
 void rt::SocketValue::api_close(const gc::Local<ExecContext>& context) {
+	if (!!m_watch) m_watch->m_loop->remove_watch(m_watch);
+
+	//The socket is closed even if the buffered output cannot be sent.
+	try {
+		m_out->close();
+	} catch (...) {
+		m_socket->close();
+		throw;
+	}
+	m_in->close();
 	m_socket->close();
 }
 
@@ -291,6 +524,7 @@ class rt::ServerSocketValue::API : public SysAPI<ServerSocketValue> {
 
 void rt::ServerSocketValue::gc_enumerate_refs() {
 	gc_ref(m_server_socket);
+	gc_ref(m_watch);
 }
 
 void rt::ServerSocketValue::initialize(const gc::Local<pf::ServerSocket>& server_socket) {
@@ -317,9 +551,424 @@ gc::Local<rt::SocketValue> rt::ServerSocketValue::api_accept(const gc::Local<Exe
 }
 
 void rt::ServerSocketValue::api_close(const gc::Local<ExecContext>& context) {
+	if (!!m_watch) m_watch->m_loop->remove_watch(m_watch);
 	m_server_socket->close();
 }
 
+//
+//SocketWatch : implementation
+//
+
+void rt::SocketWatch::gc_enumerate_refs() {
+	gc_ref(m_loop);
+	gc_ref(m_socket);
+	gc_ref(m_server_socket);
+	gc_ref(m_callback);
+}
+
+void rt::SocketWatch::initialize(
+	const gc::Local<EventLoopValue>& loop,
+	std::size_t token,
+	const gc::Local<SocketValue>& socket,
+	const gc::Local<ServerSocketValue>& server_socket,
+	const ValueLoc& callback)
+{
+	m_loop = loop;
+	m_token = token;
+	m_socket = socket;
+	m_server_socket = server_socket;
+	m_callback = callback;
+}
+
+//
+//EventTimer : implementation
+//
+
+void rt::EventTimer::gc_enumerate_refs() {
+	gc_ref(m_callback);
+}
+
+void rt::EventTimer::initialize(pf::TimeMs_t time, ss::ScriptIntegerType id, const ValueLoc& callback) {
+	m_time = time;
+	m_id = id;
+	m_callback = callback;
+}
+
+//Timers with the same time are ordered by id, so they are invoked in the order of creation.
+bool rt::EventTimer::is_before(const gc::Local<EventTimer>& timer) const {
+	if (m_time != timer->m_time) return m_time < timer->m_time;
+	return m_id < timer->m_id;
+}
+
+//
+//EventLoopValue::API
+//
+
+class rt::EventLoopValue::API : public SysAPI<EventLoopValue> {
+	void init() override {
+		bld->add_constructor(api_create);
+		bld->add_method("on_accept", &EventLoopValue::api_on_accept);
+		bld->add_method("on_data", &EventLoopValue::api_on_data);
+		bld->add_method("remove", &EventLoopValue::api_remove);
+		bld->add_method("set_timeout", &EventLoopValue::api_set_timeout);
+		bld->add_method("cancel_timeout", &EventLoopValue::api_cancel_timeout);
+		bld->add_method("run", &EventLoopValue::api_run);
+		bld->add_method("stop", &EventLoopValue::api_stop);
+	}
+};
+
+//
+//EventLoopValue : implementation
+//
+
+namespace {
+	const std::size_t MAX_READY_SOCKETS = 256;
+	const std::size_t READ_BLOCK_SIZE = 16384;
+
+	//Limits the number of connections accepted at once, so that other sockets are not starved.
+	const std::size_t ACCEPT_BATCH_SIZE = 64;
+}
+
+rt::EventLoopValue::EventLoopValue()
+	: m_watch_count(0),
+	m_timer_count(0),
+	m_last_timer_id(0),
+	m_running(false),
+	m_stopped(false)
+{}
+
+void rt::EventLoopValue::gc_enumerate_refs() {
+	gc_ref(m_watches);
+	gc_ref(m_timers);
+}
+
+void rt::EventLoopValue::initialize() {
+	m_poller = pf::create_socket_poller();
+	m_ready_tokens.resize(MAX_READY_SOCKETS);
+}
+
+void rt::EventLoopValue::remove_watch(const gc::Local<SocketWatch>& watch) {
+	assert(watch->m_loop.get() == this);
+
+	if (!!watch->m_socket) {
+		m_poller->remove(watch->m_socket->m_socket->get_handle());
+		watch->m_socket->m_watch = nullptr;
+	} else {
+		m_poller->remove(watch->m_server_socket->m_server_socket->get_handle());
+		watch->m_server_socket->m_watch = nullptr;
+	}
+
+	(*m_watches)[watch->m_token] = nullptr;
+	m_free_tokens.push_back(watch->m_token);
+	--m_watch_count;
+}
+
+std::size_t rt::EventLoopValue::get_sys_class_id() const {
+	return API::get_class_id();
+}
+
+gc::Local<rt::SocketWatch> rt::EventLoopValue::add_watch(
+	pf::SocketHandle handle,
+	const gc::Local<SocketValue>& socket,
+	const gc::Local<ServerSocketValue>& server_socket,
+	const ValueLoc& callback)
+{
+	if (callback.is_null()) throw RuntimeError("Callback is null");
+
+	std::size_t token;
+	if (!m_free_tokens.empty()) {
+		token = m_free_tokens.back();
+	} else {
+		token = m_watch_count;
+		std::size_t capacity = !m_watches ? 0 : m_watches->length();
+		if (token == capacity) {
+			gc::Local<gc::Array<SocketWatch>> watches = gc::Array<SocketWatch>::create(std::max<std::size_t>(capacity * 2, 16));
+			for (std::size_t i = 0; i < capacity; ++i) (*watches)[i] = (*m_watches)[i];
+			m_watches = watches;
+		}
+	}
+
+	m_poller->add(handle, token);
+	if (!m_free_tokens.empty()) m_free_tokens.pop_back();
+
+	gc::Local<SocketWatch> watch = gc::create<SocketWatch>(self(this), token, socket, server_socket, callback);
+	(*m_watches)[token] = watch;
+	++m_watch_count;
+	return watch;
+}
+
+void rt::EventLoopValue::dispatch(const gc::Local<ExecContext>& context, std::size_t token) {
+	//The socket may have been removed by a callback invoked for another event.
+	gc::Local<SocketWatch> watch = (*m_watches)[token];
+	if (!watch) return;
+
+	if (!!watch->m_socket) {
+		dispatch_data(context, watch);
+	} else {
+		dispatch_accept(context, watch);
+	}
+}
+
+void rt::EventLoopValue::dispatch_accept(const gc::Local<ExecContext>& context, const gc::Local<SocketWatch>& watch) {
+	gc::Local<ServerSocketValue> server_socket = watch->m_server_socket;
+
+	ValueStackWindow arguments(1);
+	for (std::size_t i = 0; i < ACCEPT_BATCH_SIZE && !m_stopped; ++i) {
+		//The callback may have removed the server socket.
+		if (server_socket->m_watch.get() != watch.get()) break;
+
+		gc::Local<pf::Socket> socket = server_socket->m_server_socket->try_accept();
+		if (!socket) break;
+
+		gc::Local<SocketValue> socket_value = gc::create<SocketValue>(socket);
+		arguments.get_values()[0] = socket_value;
+		invoke_callback(context, watch->m_callback, arguments.get_span());
+	}
+}
+
+void rt::EventLoopValue::dispatch_data(const gc::Local<ExecContext>& context, const gc::Local<SocketWatch>& watch) {
+	gc::Local<SocketValue> socket = watch->m_socket;
+
+	gc::Local<ByteArray> data;
+	std::size_t available = socket->m_in->available();
+	if (available) {
+		data = ByteArray::create(available);
+		socket->m_in->read(data->raw_array(), available, false);
+	} else {
+		if (!m_read_buffer) m_read_buffer.reset(new char[READ_BLOCK_SIZE]);
+
+		//A failed connection is reported as the end of the input, so that one client cannot stop the loop.
+		std::size_t count;
+		try {
+			count = socket->m_socket->try_read(m_read_buffer.get(), READ_BLOCK_SIZE);
+		} catch (const RuntimeError&) {
+			count = 0;
+		}
+
+		if (pf::SOCKET_WOULD_BLOCK == count) return;
+		if (count) {
+			data = ByteArray::create(count);
+			std::memcpy(data->raw_array(), m_read_buffer.get(), count);
+		}
+	}
+
+	ValueStackWindow arguments(1);
+	if (!!data) {
+		arguments.get_values()[0] = gc::create<ByteArrayValue>(data);
+	} else {
+		remove_watch(watch);
+		arguments.get_values()[0] = context->get_value_factory()->get_null_value();
+	}
+
+	invoke_callback(context, watch->m_callback, arguments.get_span());
+}
+
+void rt::EventLoopValue::dispatch_timers(const gc::Local<ExecContext>& context) {
+	if (!m_timer_count) return;
+
+	//Timers added by the callbacks are not invoked before the next wait.
+	const pf::TimeMs_t now = pf::get_current_time_millis();
+	const ScriptIntegerType last_id = m_last_timer_id;
+	while (m_timer_count && !m_stopped) {
+		gc::Local<EventTimer> timer = (*m_timers)[0];
+		if (timer->m_time > now || timer->m_id > last_id) break;
+
+		remove_timer(0);
+		invoke_callback(context, timer->m_callback, ArgSpan());
+	}
+}
+
+int rt::EventLoopValue::get_wait_timeout() const {
+	if (!m_timer_count) return -1;
+
+	const pf::TimeMs_t now = pf::get_current_time_millis();
+	const pf::TimeMs_t time = (*m_timers)[0]->m_time;
+	if (time <= now) return 0;
+
+	const pf::TimeMs_t max_timeout = std::numeric_limits<int>::max();
+	return static_cast<int>(std::min(time - now, max_timeout));
+}
+
+void rt::EventLoopValue::add_timer(const gc::Local<EventTimer>& timer) {
+	std::size_t capacity = !m_timers ? 0 : m_timers->length();
+	if (m_timer_count == capacity) {
+		gc::Local<gc::Array<EventTimer>> timers = gc::Array<EventTimer>::create(std::max<std::size_t>(capacity * 2, 16));
+		for (std::size_t i = 0; i < capacity; ++i) (*timers)[i] = (*m_timers)[i];
+		m_timers = timers;
+	}
+
+	std::size_t index = m_timer_count++;
+	(*m_timers)[index] = timer;
+	sift_timer_up(index);
+}
+
+void rt::EventLoopValue::remove_timer(std::size_t index) {
+	assert(index < m_timer_count);
+
+	std::size_t last = --m_timer_count;
+	(*m_timers)[index] = (*m_timers)[last];
+	(*m_timers)[last] = nullptr;
+
+	if (index < last) {
+		sift_timer_down(index);
+		sift_timer_up(index);
+	}
+}
+
+void rt::EventLoopValue::sift_timer_up(std::size_t index) {
+	gc::Local<EventTimer> timer = (*m_timers)[index];
+	while (index) {
+		std::size_t parent = (index - 1) / 2;
+		gc::Local<EventTimer> parent_timer = (*m_timers)[parent];
+		if (!timer->is_before(parent_timer)) break;
+		(*m_timers)[index] = parent_timer;
+		index = parent;
+	}
+	(*m_timers)[index] = timer;
+}
+
+void rt::EventLoopValue::sift_timer_down(std::size_t index) {
+	gc::Local<EventTimer> timer = (*m_timers)[index];
+	for (;;) {
+		std::size_t child = index * 2 + 1;
+		if (child >= m_timer_count) break;
+		if (child + 1 < m_timer_count && (*m_timers)[child + 1]->is_before((*m_timers)[child])) ++child;
+
+		gc::Local<EventTimer> child_timer = (*m_timers)[child];
+		if (!child_timer->is_before(timer)) break;
+		(*m_timers)[index] = child_timer;
+		index = child;
+	}
+	(*m_timers)[index] = timer;
+}
+
+//An exception thrown by a callback terminates run(), like an unhandled exception terminates a script.
+void rt::EventLoopValue::invoke_callback(
+	const gc::Local<ExecContext>& context,
+	const ValueLoc& callback,
+	const ArgSpan& arguments)
+{
+	ValueLoc exception;
+	callback.invoke(context, arguments, exception);
+	if (!!exception) {
+		const ExceptionValue* e = dynamic_cast<const ExceptionValue*>(exception.get());
+		assert(e);
+		e->print_stack_trace(context);
+		throw RuntimeError("Unhandled exception in an event loop callback");
+	}
+}
+
+gc::Local<rt::EventLoopValue> rt::EventLoopValue::api_create(const gc::Local<ExecContext>& context) {
+	return gc::create<EventLoopValue>();
+}
+
+void rt::EventLoopValue::api_on_accept(
+	const gc::Local<ExecContext>& context,
+	const gc::Local<ServerSocketValue>& server_socket,
+	const ValueLoc& callback)
+{
+	if (!server_socket) throw RuntimeError("Server socket is null");
+	if (!!server_socket->m_watch) throw RuntimeError("Server socket is already in an event loop");
+
+	gc::Local<pf::ServerSocket> socket = server_socket->m_server_socket;
+	socket->set_non_blocking(true);
+	server_socket->m_watch = add_watch(socket->get_handle(), nullptr, server_socket, callback);
+}
+
+void rt::EventLoopValue::api_on_data(
+	const gc::Local<ExecContext>& context,
+	const gc::Local<SocketValue>& socket,
+	const ValueLoc& callback)
+{
+	if (!socket) throw RuntimeError("Socket is null");
+	if (!!socket->m_watch) throw RuntimeError("Socket is already in an event loop");
+
+	gc::Local<pf::Socket> pf_socket = socket->m_socket;
+	pf_socket->set_non_blocking(true);
+	gc::Local<SocketWatch> watch = add_watch(pf_socket->get_handle(), socket, nullptr, callback);
+	socket->m_watch = watch;
+
+	if (socket->m_in->available()) m_buffered_tokens.push_back(watch->m_token);
+}
+
+void rt::EventLoopValue::api_remove(const gc::Local<ExecContext>& context, const ValueLoc& socket) {
+	gc::Local<SocketValue> socket_value = socket.cast_opt<SocketValue>();
+	gc::Local<ServerSocketValue> server_socket_value = socket.cast_opt<ServerSocketValue>();
+
+	gc::Local<SocketWatch> watch;
+	if (!!socket_value) {
+		watch = socket_value->m_watch;
+	} else if (!!server_socket_value) {
+		watch = server_socket_value->m_watch;
+	} else {
+		throw RuntimeError("Not a socket");
+	}
+
+	if (!!watch && watch->m_loop.get() == this) remove_watch(watch);
+}
+
+ss::ScriptIntegerType rt::EventLoopValue::api_set_timeout(
+	const gc::Local<ExecContext>& context,
+	ss::ScriptIntegerType delay,
+	const ValueLoc& callback)
+{
+	if (scriptint_sign(delay) < 0) throw RuntimeError("Negative delay");
+	std::size_t sdelay = scriptint_to_size_ex(delay);
+	if (callback.is_null()) throw RuntimeError("Callback is null");
+
+	const pf::TimeMs_t time = pf::get_current_time_millis() + sdelay;
+	ScriptIntegerType id = ++m_last_timer_id;
+	add_timer(gc::create<EventTimer>(time, id, callback));
+	return id;
+}
+
+void rt::EventLoopValue::api_cancel_timeout(const gc::Local<ExecContext>& context, ss::ScriptIntegerType id) {
+	for (std::size_t i = 0; i < m_timer_count; ++i) {
+		if ((*m_timers)[i]->m_id == id) {
+			remove_timer(i);
+			break;
+		}
+	}
+}
+
+void rt::EventLoopValue::api_run(const gc::Local<ExecContext>& context) {
+	if (m_running) throw RuntimeError("Event loop is already running");
+
+	m_running = true;
+	m_stopped = false;
+
+	try {
+		while (!m_stopped && (m_watch_count || m_timer_count)) {
+			int timeout = m_buffered_tokens.empty() ? get_wait_timeout() : 0;
+
+			std::size_t count;
+			{
+				gc::disable_guard disable_guard;
+				count = m_poller->wait(m_ready_tokens.data(), m_ready_tokens.size(), timeout);
+			}
+
+			for (std::size_t i = 0; i < count && !m_stopped; ++i) dispatch(context, m_ready_tokens[i]);
+
+			std::vector<std::size_t> buffered_tokens;
+			buffered_tokens.swap(m_buffered_tokens);
+			for (std::size_t token : buffered_tokens) {
+				if (!m_stopped) dispatch(context, token);
+			}
+
+			dispatch_timers(context);
+		}
+	} catch (...) {
+		m_running = false;
+		throw;
+	}
+
+	m_running = false;
+}
+
+void rt::EventLoopValue::api_stop(const gc::Local<ExecContext>& context) {
+	m_stopped = true;
+}
+
 //
 //(Functions)
 //
@@ -328,6 +977,7 @@ namespace {
 	rt::SysNamespaceInitializer s_sys_namespace_initializer([](rt::SysClassBuilder<rt::SysNamespaceValue>& bld){
 		bld.add_class<rt::SocketValue>("Socket");
 		bld.add_class<rt::ServerSocketValue>("ServerSocket");
+		bld.add_class<rt::EventLoopValue>("EventLoop");
 	});
 }
 
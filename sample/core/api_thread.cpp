@@ -0,0 +1,695 @@
+/*
+ * Copyright 2014 Anton Karmanov
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//Thread API.
+//
+//Every thread executes its own script, with its own name table, value factory and execution context, so threads
+//do not share interpreter state. Threads communicate through channels. A value is copied when it is sent to
+//another thread (see Value::copy_value()): strings, byte arrays, arrays and collections are copied deeply, numbers
+//and booleans are immediate or immutable, channels are shared. Other values (functions, objects) cannot be sent.
+
+#include <condition_variable>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "api.h"
+#include "api_basic.h"
+#include "api_collection.h"
+#include "common.h"
+#include "gc.h"
+#include "name.h"
+#include "scope.h"
+#include "script.h"
+#include "sysclass.h"
+#include "sysclassbld__imp.h"
+#include "value_core.h"
+
+namespace ss = syn_script;
+namespace gc = ss::gc;
+namespace rt = ss::rt;
+
+namespace syn_script {
+	namespace rt {
+		class ChannelValue;
+		class ThreadValue;
+		class WorkerPoolValue;
+
+		ScriptIntegerType api_cpu_count(const gc::Local<ExecContext>& context);
+	}
+}
+
+namespace {
+	//Number of running script threads. Guarded by the mutex.
+	std::mutex g_threads_mutex;
+	std::condition_variable g_threads_condition;
+	std::size_t g_threads_count = 0;
+
+	//
+	//SendValueCopier
+	//
+
+	//Copies a value sent to another thread. Values are copied recursively, so the depth is limited (a value
+	//containing itself cannot be sent).
+	class SendValueCopier : public rt::ValueCopier {
+		NONCOPYABLE(SendValueCopier);
+
+		static const std::size_t MAX_DEPTH = 256;
+
+		std::size_t m_depth;
+
+	public:
+		SendValueCopier() : m_depth(0){}
+
+		rt::ValueLoc copy(const rt::ValueLoc& value) override {
+			if (m_depth == MAX_DEPTH) throw ss::RuntimeError("The value is too deep to be sent to another thread");
+			++m_depth;
+			rt::ValueLoc result = value->copy_value(*this);
+			--m_depth;
+			return result;
+		}
+	};
+
+	rt::ValueLoc send_value(const rt::ValueLoc& value) {
+		SendValueCopier copier;
+		return copier.copy(value);
+	}
+
+	ss::StringLoc send_string(const ss::StringLoc& str) {
+		return gc::create<ss::String>(str->get_std_string());
+	}
+
+	//
+	//ThreadScopeInitializer
+	//
+
+	//Declares constants for the entries of the scope map passed to a thread.
+	class ThreadScopeInitializer : public rt::ScriptScopeInitializer {
+		NONCOPYABLE(ThreadScopeInitializer);
+
+		gc::Local<rt::ValueHashMap> m_scope_map;
+		std::vector<gc::Local<rt::NameDescriptor>> m_name_descriptors;
+		std::vector<rt::ValueLoc> m_values;
+
+	public:
+		ThreadScopeInitializer(const gc::Local<rt::ValueHashMap>& scope_map)
+			: m_scope_map(scope_map)
+		{}
+
+		void bind(ss::NameRegistry& name_registry, rt::BindScope& scope) override {
+			if (!m_scope_map) return;
+
+			gc::Local<rt::ValueArray> keys = m_scope_map->keys();
+			for (std::size_t i = 0, n = keys->length(); i < n; ++i) {
+				rt::ValueLoc key = (*keys)[i];
+				gc::Local<const ss::NameInfo> name_info = name_registry.register_name(key->get_string());
+				m_name_descriptors.push_back(scope.declare_sys_constant(name_info));
+				m_values.push_back(m_scope_map->get(key));
+			}
+		}
+
+		void exec(const gc::Local<rt::ExecContext>& context, const gc::Local<rt::ExecScope>& scope) override {
+			for (std::size_t i = 0, n = m_values.size(); i < n; ++i) {
+				m_name_descriptors[i]->set_initialize(scope, m_values[i]);
+			}
+		}
+	};
+}
+
+//
+//ChannelValue : definition
+//
+
+//Unbounded queue of values shared by threads. The queue is modified only while the mutex is locked, and
+//no memory is allocated then, so the owner of the mutex never waits for garbage collection.
+class rt::ChannelValue : public SysObjectValue {
+	NONCOPYABLE(ChannelValue);
+
+	static const std::size_t INITIAL_CAPACITY = 16;
+
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+
+	//Circular buffer of values.
+	gc::Ref<ValueArray> m_values;
+	std::size_t m_head;
+	std::size_t m_count;
+	bool m_closed;
+
+public:
+	ChannelValue(){}
+	void gc_enumerate_refs() override;
+	void initialize();
+
+	ValueLoc copy_value(ValueCopier& copier) override;
+
+	//Adds a value which has already been copied for sending.
+	void send(const ValueLoc& value);
+
+	//Takes the next value. If the channel is empty, waits for a value, unless wait is false. Returns false if
+	//there is no value: the channel is empty and either closed or wait is false.
+	bool receive(ValueLoc& value, bool wait);
+
+	void close();
+
+protected:
+	std::size_t get_sys_class_id() const override;
+
+private:
+	static gc::Local<ChannelValue> api_create(const gc::Local<ExecContext>& context);
+	void api_send(const gc::Local<ExecContext>& context, const ValueLoc& value);
+	ValueLoc api_receive(const gc::Local<ExecContext>& context);
+	ValueLoc api_poll(const gc::Local<ExecContext>& context);
+	void api_close(const gc::Local<ExecContext>& context);
+
+public:
+	class API;
+};
+
+//
+//ThreadValue : definition
+//
+
+//A thread executing a script. The native thread takes a local reference to this object, so the object is not
+//deleted until the thread finishes.
+class rt::ThreadValue : public SysObjectValue {
+	NONCOPYABLE(ThreadValue);
+
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	bool m_started;
+	bool m_finished;
+	bool m_failed;
+
+	gc::Ref<gc::Array<ScriptSource>> m_sources;
+	gc::Ref<StringArray> m_arguments;
+	gc::Ref<HashMapValue> m_scope;
+	ExecutionMode m_execution_mode;
+	ValueRef m_result;
+
+public:
+	ThreadValue(){}
+	void gc_enumerate_refs() override;
+
+	void initialize(
+		const gc::Local<gc::Array<ScriptSource>>& sources,
+		const gc::Local<StringArray>& arguments,
+		const gc::Local<HashMapValue>& scope,
+		ExecutionMode execution_mode);
+
+	//Creates a thread executing the specified code. The names and values of the scope are declared as constants
+	//in the script of the thread; the scope is copied.
+	static gc::Local<ThreadValue> create(
+		const gc::Local<ExecContext>& context,
+		const StringLoc& file_name,
+		const StringLoc& code,
+		const gc::Local<HashMapValue>& scope);
+
+	void start();
+
+	//Waits until the thread finishes, and returns the value returned by its script.
+	ValueLoc join();
+
+protected:
+	std::size_t get_sys_class_id() const override;
+
+private:
+	static void thread_main(ThreadValue* thread_ptr);
+	void run();
+	void finish(bool ok, const ValueLoc& result);
+
+	static gc::Local<ThreadValue> api_create_2(
+		const gc::Local<ExecContext>& context,
+		const StringLoc& file_name,
+		const StringLoc& code);
+
+	static gc::Local<ThreadValue> api_create_3(
+		const gc::Local<ExecContext>& context,
+		const StringLoc& file_name,
+		const StringLoc& code,
+		const gc::Local<HashMapValue>& scope);
+
+	ValueLoc api_join(const gc::Local<ExecContext>& context);
+
+public:
+	class API;
+};
+
+//
+//WorkerPoolValue : definition
+//
+
+//A number of threads executing the same script. The threads take jobs from a common channel, which is declared
+//in their scripts as the constant "jobs".
+class rt::WorkerPoolValue : public SysObjectValue {
+	NONCOPYABLE(WorkerPoolValue);
+
+	gc::Ref<ChannelValue> m_jobs;
+	gc::Ref<gc::Array<ThreadValue>> m_threads;
+
+public:
+	WorkerPoolValue(){}
+	void gc_enumerate_refs() override;
+
+	void initialize(
+		const gc::Local<ChannelValue>& jobs,
+		const gc::Local<gc::Array<ThreadValue>>& threads);
+
+protected:
+	std::size_t get_sys_class_id() const override;
+
+private:
+	static gc::Local<WorkerPoolValue> api_create_3(
+		const gc::Local<ExecContext>& context,
+		ScriptIntegerType size,
+		const StringLoc& file_name,
+		const StringLoc& code);
+
+	static gc::Local<WorkerPoolValue> api_create_4(
+		const gc::Local<ExecContext>& context,
+		ScriptIntegerType size,
+		const StringLoc& file_name,
+		const StringLoc& code,
+		const gc::Local<HashMapValue>& scope);
+
+	ScriptIntegerType api_size(const gc::Local<ExecContext>& context);
+	void api_submit(const gc::Local<ExecContext>& context, const ValueLoc& value);
+	gc::Local<ValueArray> api_join(const gc::Local<ExecContext>& context);
+
+public:
+	class API;
+};
+
+//
+//ChannelValue : implementation
+//
+
+class rt::ChannelValue::API : public SysAPI<ChannelValue> {
+	void init() override {
+		bld->add_constructor(&ChannelValue::api_create);
+		bld->add_method("send", &ChannelValue::api_send);
+		bld->add_method("receive", &ChannelValue::api_receive);
+		bld->add_method("poll", &ChannelValue::api_poll);
+		bld->add_method("close", &ChannelValue::api_close);
+	}
+};
+
+void rt::ChannelValue::gc_enumerate_refs() {
+	SysObjectValue::gc_enumerate_refs();
+	gc_ref(m_values);
+}
+
+void rt::ChannelValue::initialize() {
+	m_values = ValueArray::create(INITIAL_CAPACITY);
+	m_head = 0;
+	m_count = 0;
+	m_closed = false;
+}
+
+rt::ValueLoc rt::ChannelValue::copy_value(ValueCopier& copier) {
+	return self(this);
+}
+
+void rt::ChannelValue::send(const ValueLoc& value) {
+	for (;;) {
+		std::size_t capacity;
+		{
+			gc::lock_guard lock(m_mutex);
+			if (m_closed) throw RuntimeError("Channel is closed");
+
+			capacity = m_values->length();
+			if (m_count < capacity) {
+				(*m_values)[(m_head + m_count) % capacity] = value;
+				++m_count;
+				m_condition.notify_one();
+				return;
+			}
+		}
+
+		//The buffer is full. A larger one is allocated without the lock, and used unless another thread has
+		//already replaced the buffer.
+		gc::Local<ValueArray> values = ValueArray::create(capacity * 2);
+
+		gc::lock_guard lock(m_mutex);
+		if (m_values->length() == capacity && m_count == capacity) {
+			for (std::size_t i = 0; i < m_count; ++i) (*values)[i] = (*m_values)[(m_head + i) % capacity];
+			m_values = values;
+			m_head = 0;
+		}
+	}
+}
+
+bool rt::ChannelValue::receive(ValueLoc& value, bool wait) {
+	for (;;) {
+		{
+			gc::lock_guard lock(m_mutex);
+			if (m_count) {
+				value = (*m_values)[m_head];
+				(*m_values)[m_head] = nullptr;
+				m_head = (m_head + 1) % m_values->length();
+				--m_count;
+				return true;
+			}
+			if (m_closed || !wait) return false;
+		}
+
+		//Only the counter and the flag are accessed while waiting, so GC can be disabled.
+		gc::disable_guard disable_guard;
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_condition.wait(lock, [this]{ return m_count || m_closed; });
+	}
+}
+
+void rt::ChannelValue::close() {
+	gc::lock_guard lock(m_mutex);
+	m_closed = true;
+	m_condition.notify_all();
+}
+
+std::size_t rt::ChannelValue::get_sys_class_id() const {
+	return API::get_class_id();
+}
+
+gc::Local<rt::ChannelValue> rt::ChannelValue::api_create(const gc::Local<ExecContext>& context) {
+	return gc::create<ChannelValue>();
+}
+
+void rt::ChannelValue::api_send(const gc::Local<ExecContext>& context, const ValueLoc& value) {
+	send(send_value(value));
+}
+
+rt::ValueLoc rt::ChannelValue::api_receive(const gc::Local<ExecContext>& context) {
+	ValueLoc value;
+	if (!receive(value, true)) return context->get_value_factory()->get_null_value();
+	return value;
+}
+
+rt::ValueLoc rt::ChannelValue::api_poll(const gc::Local<ExecContext>& context) {
+	ValueLoc value;
+	if (!receive(value, false)) return context->get_value_factory()->get_null_value();
+	return value;
+}
+
+void rt::ChannelValue::api_close(const gc::Local<ExecContext>& context) {
+	close();
+}
+
+//
+//ThreadValue : implementation
+//
+
+class rt::ThreadValue::API : public SysAPI<ThreadValue> {
+	void init() override {
+		bld->add_constructor(&ThreadValue::api_create_2);
+		bld->add_constructor(&ThreadValue::api_create_3);
+		bld->add_method("join", &ThreadValue::api_join);
+	}
+};
+
+void rt::ThreadValue::gc_enumerate_refs() {
+	SysObjectValue::gc_enumerate_refs();
+	gc_ref(m_sources);
+	gc_ref(m_arguments);
+	gc_ref(m_scope);
+	gc_ref(m_result);
+}
+
+void rt::ThreadValue::initialize(
+	const gc::Local<gc::Array<ScriptSource>>& sources,
+	const gc::Local<StringArray>& arguments,
+	const gc::Local<HashMapValue>& scope,
+	ExecutionMode execution_mode)
+{
+	m_started = false;
+	m_finished = false;
+	m_failed = false;
+	m_sources = sources;
+	m_arguments = arguments;
+	m_scope = scope;
+	m_execution_mode = execution_mode;
+}
+
+gc::Local<rt::ThreadValue> rt::ThreadValue::create(
+	const gc::Local<ExecContext>& context,
+	const StringLoc& file_name,
+	const StringLoc& code,
+	const gc::Local<HashMapValue>& scope)
+{
+	//Strings are copied, since a concatenation is flattened on access.
+	gc::Local<gc::Array<ScriptSource>> sources = get_single_script_source(send_string(file_name), send_string(code));
+
+	//The thread gets the same command line arguments.
+	gc::Local<ArrayValue> arguments_value = context->get_value_factory()->get_arguments_value().cast<ArrayValue>();
+	gc::Local<ValueArray> arguments_array = arguments_value->get_array();
+	const std::size_t count = arguments_array->length();
+	gc::Local<StringArray> arguments = StringArray::create(count);
+	for (std::size_t i = 0; i < count; ++i) (*arguments)[i] = send_string((*arguments_array)[i]->to_string(context));
+
+	gc::Local<HashMapValue> scope_copy;
+	if (!!scope) scope_copy = send_value(scope).cast<HashMapValue>();
+
+	ExecutionMode execution_mode = context->get_bind_context()->get_execution_mode();
+	return gc::create<ThreadValue>(sources, arguments, scope_copy, execution_mode);
+}
+
+void rt::ThreadValue::start() {
+	{
+		std::lock_guard<std::mutex> lock(g_threads_mutex);
+		++g_threads_count;
+	}
+
+	//Until the new thread takes a local reference to this object, the object is referenced by this thread,
+	//which waits with GC disabled.
+	gc::disable_guard disable_guard;
+
+	try {
+		std::thread thread(&ThreadValue::thread_main, this);
+		thread.detach();
+	} catch (const std::system_error&) {
+		std::lock_guard<std::mutex> lock(g_threads_mutex);
+		--g_threads_count;
+		throw RuntimeError("Cannot start a thread");
+	}
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_condition.wait(lock, [this]{ return m_started; });
+}
+
+rt::ValueLoc rt::ThreadValue::join() {
+	{
+		gc::disable_guard disable_guard;
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_condition.wait(lock, [this]{ return m_finished; });
+	}
+
+	if (m_failed) throw RuntimeError("Thread failed");
+	return m_result;
+}
+
+void rt::ThreadValue::thread_main(ThreadValue* thread_ptr) {
+	{
+		gc::manage_thread_guard manage_guard("script");
+		gc::enable_guard enable_guard;
+
+		gc::Local<ThreadValue> thread = thread_ptr->self(thread_ptr);
+		{
+			std::lock_guard<std::mutex> lock(thread->m_mutex);
+			thread->m_started = true;
+		}
+		thread->m_condition.notify_all();
+
+		thread->run();
+	}
+
+	//The thread does not use the GC anymore.
+	std::lock_guard<std::mutex> lock(g_threads_mutex);
+	if (!--g_threads_count) g_threads_condition.notify_all();
+}
+
+void rt::ThreadValue::run() {
+	bool ok = false;
+	ValueLoc result;
+
+	try {
+		gc::Local<ValueHashMap> scope_map;
+		if (!!m_scope) scope_map = m_scope->get_map();
+
+		ThreadScopeInitializer initializer(scope_map);
+		ValueLoc script_result;
+		ok = execute_thread_script(m_sources, m_arguments, m_execution_mode, initializer, script_result);
+		if (ok) result = send_value(script_result);
+	} catch (const BasicError& e) {
+		std::cerr << e << std::endl;
+		ok = false;
+	} catch (const gc::out_of_memory&) {
+		std::cerr << "Out of memory!\n";
+		ok = false;
+	}
+
+	finish(ok, result);
+}
+
+void rt::ThreadValue::finish(bool ok, const ValueLoc& result) {
+	m_result = ok ? result : ValueFactory::get_null_value();
+	m_failed = !ok;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_finished = true;
+	}
+	m_condition.notify_all();
+}
+
+std::size_t rt::ThreadValue::get_sys_class_id() const {
+	return API::get_class_id();
+}
+
+gc::Local<rt::ThreadValue> rt::ThreadValue::api_create_2(
+	const gc::Local<ExecContext>& context,
+	const StringLoc& file_name,
+	const StringLoc& code)
+{
+	return api_create_3(context, file_name, code, nullptr);
+}
+
+gc::Local<rt::ThreadValue> rt::ThreadValue::api_create_3(
+	const gc::Local<ExecContext>& context,
+	const StringLoc& file_name,
+	const StringLoc& code,
+	const gc::Local<HashMapValue>& scope)
+{
+	gc::Local<ThreadValue> thread = create(context, file_name, code, scope);
+	thread->start();
+	return thread;
+}
+
+rt::ValueLoc rt::ThreadValue::api_join(const gc::Local<ExecContext>& context) {
+	return join();
+}
+
+//
+//WorkerPoolValue : implementation
+//
+
+class rt::WorkerPoolValue::API : public SysAPI<WorkerPoolValue> {
+	void init() override {
+		bld->add_constructor(&WorkerPoolValue::api_create_3);
+		bld->add_constructor(&WorkerPoolValue::api_create_4);
+		bld->add_method("size", &WorkerPoolValue::api_size);
+		bld->add_method("submit", &WorkerPoolValue::api_submit);
+		bld->add_method("join", &WorkerPoolValue::api_join);
+	}
+};
+
+void rt::WorkerPoolValue::gc_enumerate_refs() {
+	SysObjectValue::gc_enumerate_refs();
+	gc_ref(m_jobs);
+	gc_ref(m_threads);
+}
+
+void rt::WorkerPoolValue::initialize(
+	const gc::Local<ChannelValue>& jobs,
+	const gc::Local<gc::Array<ThreadValue>>& threads)
+{
+	m_jobs = jobs;
+	m_threads = threads;
+}
+
+std::size_t rt::WorkerPoolValue::get_sys_class_id() const {
+	return API::get_class_id();
+}
+
+gc::Local<rt::WorkerPoolValue> rt::WorkerPoolValue::api_create_3(
+	const gc::Local<ExecContext>& context,
+	ScriptIntegerType size,
+	const StringLoc& file_name,
+	const StringLoc& code)
+{
+	return api_create_4(context, size, file_name, code, nullptr);
+}
+
+gc::Local<rt::WorkerPoolValue> rt::WorkerPoolValue::api_create_4(
+	const gc::Local<ExecContext>& context,
+	ScriptIntegerType size,
+	const StringLoc& file_name,
+	const StringLoc& code,
+	const gc::Local<HashMapValue>& scope)
+{
+	const std::size_t count = scriptint_to_size_ex(size);
+	if (!count) throw RuntimeError("Worker pool size must be positive");
+
+	gc::Local<ChannelValue> jobs = gc::create<ChannelValue>();
+
+	//The channel is added to the scope of each worker, overriding a value with the same name.
+	gc::Local<HashMapValue> worker_scope = !!scope ? send_value(scope).cast<HashMapValue>() : gc::create<HashMapValue>();
+	ValueLoc jobs_name = gc::create<StringValue>(gc::create<String>("jobs"));
+	worker_scope->get_map()->put(jobs_name, jobs);
+
+	gc::Local<gc::Array<ThreadValue>> threads = gc::Array<ThreadValue>::create(count);
+	for (std::size_t i = 0; i < count; ++i) (*threads)[i] = ThreadValue::create(context, file_name, code, worker_scope);
+
+	gc::Local<WorkerPoolValue> pool = gc::create<WorkerPoolValue>(jobs, threads);
+	for (std::size_t i = 0; i < count; ++i) (*threads)[i]->start();
+	return pool;
+}
+
+ss::ScriptIntegerType rt::WorkerPoolValue::api_size(const gc::Local<ExecContext>& context) {
+	return size_to_scriptint_ex(m_threads->length());
+}
+
+void rt::WorkerPoolValue::api_submit(const gc::Local<ExecContext>& context, const ValueLoc& value) {
+	m_jobs->send(send_value(value));
+}
+
+gc::Local<rt::ValueArray> rt::WorkerPoolValue::api_join(const gc::Local<ExecContext>& context) {
+	//No more jobs: the workers finish when the channel becomes empty.
+	m_jobs->close();
+
+	const std::size_t count = m_threads->length();
+	gc::Local<ValueArray> results = ValueArray::create(count);
+	for (std::size_t i = 0; i < count; ++i) (*results)[i] = (*m_threads)[i]->join();
+	return results;
+}
+
+//
+//(Functions)
+//
+
+ss::ScriptIntegerType rt::api_cpu_count(const gc::Local<ExecContext>& context) {
+	unsigned int count = std::thread::hardware_concurrency();
+	return size_to_scriptint_ex(count ? count : 1);
+}
+
+void rt::wait_for_script_threads() {
+	gc::disable_guard disable_guard;
+	std::unique_lock<std::mutex> lock(g_threads_mutex);
+	g_threads_condition.wait(lock, []{ return !g_threads_count; });
+}
+
+namespace {
+	rt::SysNamespaceInitializer s_sys_namespace_initializer([](rt::SysClassBuilder<rt::SysNamespaceValue>& bld){
+		bld.add_class<rt::ChannelValue>("Channel");
+		bld.add_class<rt::ThreadValue>("Thread");
+		bld.add_class<rt::WorkerPoolValue>("WorkerPool");
+		bld.add_static_method("cpu_count", &rt::api_cpu_count);
+	});
+}
+
+void link__api_thread(){}
@@ -20,6 +20,7 @@
 
 #include "ast.h"
 #include "ast_combined.h"
+#include "bytecode.h"
 #include "gc.h"
 #include "scope.h"
 #include "value.h"
@@ -35,7 +36,6 @@ namespace gc = ss::gc;
 
 void ast::Declaration::gc_enumerate_refs() {
 	Node::gc_enumerate_refs();
-	gc_ref(m_syn_pos);
 	gc_ref(m_syn_name);
 	gc_ref(m_name_descriptor);
 }
@@ -48,7 +48,7 @@ void ast::Declaration::syn_name(const SynName& name) {
 	m_syn_name = name;
 }
 
-const gc::Ref<ss::TextPos>& ast::Declaration::get_pos() const {
+const ss::TextPos& ast::Declaration::get_pos() const {
 	return m_syn_pos;
 }
 
@@ -56,8 +56,8 @@ const gc::Ref<ast::AstName>& ast::Declaration::get_name() const {
 	return m_syn_name;
 }
 
-const rt::NameDescriptor* ast::Declaration::get_name_descriptor() const {
-	return m_name_descriptor.get();
+const gc::Ref<const rt::NameDescriptor>& ast::Declaration::get_name_descriptor() const {
+	return m_name_descriptor;
 }
 
 ast::ast_ptr<ast::FunctionDeclaration> ast::Declaration::get_function_opt() {
@@ -76,12 +76,16 @@ void ast::Declaration::bind_declare(rt::BindContext* context, rt::BindScope* sco
 void ast::Declaration::exec_define(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope,
-	gc::Local<rt::Value>& exception)
+	rt::ValueLoc& exception)
 {
 	scope->check_id(m_scope_id);
 	exec_define_0(context, scope, exception, m_name_descriptor.get());
 }
 
+void ast::Declaration::compile_define(rt::CodeCompiler* compiler) {
+	compile_define_0(compiler, m_name_descriptor.get());
+}
+
 //
 //VariableDeclaration
 //
@@ -113,11 +117,11 @@ void ast::VariableDeclaration::bind_define(rt::BindContext* context, rt::BindSco
 void ast::VariableDeclaration::exec_define_0(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope,
-	gc::Local<rt::Value>& exception,
+	rt::ValueLoc& exception,
 	const rt::NameDescriptor* name_desc)
 {
 	if (!!m_syn_expression) {
-		gc::Local<rt::Value> value = m_syn_expression->evaluate(context, scope, exception);
+		rt::ValueLoc value = m_syn_expression->evaluate(context, scope, exception);
 		if (!!exception) return;
 
 		if (value->is_void()) throw RuntimeError(get_pos(), "Cannot initialize a variable with void value");
@@ -126,6 +130,16 @@ void ast::VariableDeclaration::exec_define_0(
 	}
 }
 
+void ast::VariableDeclaration::compile_define_0(rt::CodeCompiler* compiler, const rt::NameDescriptor* name_desc) {
+	if (!!m_syn_expression) {
+		rt::CodeRegisterGuard guard(compiler);
+		rt::CodeReg value = compiler->allocate_register();
+		m_syn_expression->compile(compiler, value);
+		compiler->emit_check_initialize(get_pos(), value);
+		compiler->emit_initialize(name_desc, value);
+	}
+}
+
 //
 //ConstantDeclaration
 //
@@ -157,14 +171,21 @@ void ast::ConstantDeclaration::bind_define(rt::BindContext* context, rt::BindSco
 void ast::ConstantDeclaration::exec_define_0(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope,
-	gc::Local<rt::Value>& exception,
+	rt::ValueLoc& exception,
 	const rt::NameDescriptor* name_desc)
 {
-	gc::Local<rt::Value> value = m_syn_expression->evaluate(context, scope, exception);
+	rt::ValueLoc value = m_syn_expression->evaluate(context, scope, exception);
 	if (!!exception) return;
 	name_desc->set_initialize(scope, value);
 }
 
+void ast::ConstantDeclaration::compile_define_0(rt::CodeCompiler* compiler, const rt::NameDescriptor* name_desc) {
+	rt::CodeRegisterGuard guard(compiler);
+	rt::CodeReg value = compiler->allocate_register();
+	m_syn_expression->compile(compiler, value);
+	compiler->emit_initialize(name_desc, value);
+}
+
 //
 //FunctionDeclaration
 //
@@ -216,19 +237,22 @@ void ast::FunctionDeclaration::bind_define(rt::BindContext* context, rt::BindSco
 void ast::FunctionDeclaration::exec_define_0(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope,
-	gc::Local<rt::Value>& exception,
+	rt::ValueLoc& exception,
 	const rt::NameDescriptor* name_desc)
 {
 	//Nothing.
 }
 
+void ast::FunctionDeclaration::compile_define_0(rt::CodeCompiler* compiler, const rt::NameDescriptor* name_desc) {
+	//Nothing.
+}
+
 //
 //FunctionFormalParameters
 //
 
 void ast::FunctionFormalParameters::gc_enumerate_refs() {
 	Node::gc_enumerate_refs();
-	gc_ref(m_syn_pos);
 	gc_ref(m_syn_parameters);
 }
 
@@ -240,7 +264,7 @@ void ast::FunctionFormalParameters::syn_parameters(const ast_ptr<const ast_node_
 	m_syn_parameters = parameters;
 }
 
-const gc::Ref<ss::TextPos>& ast::FunctionFormalParameters::get_pos() const {
+const ss::TextPos& ast::FunctionFormalParameters::get_pos() const {
 	return m_syn_pos;
 }
 
@@ -254,7 +278,6 @@ const ast::ast_ref<const ast::ast_node_list<ast::AstName>>& ast::FunctionFormalP
 
 void ast::FunctionBody::gc_enumerate_refs() {
 	Node::gc_enumerate_refs();
-	gc_ref(m_syn_pos);
 	gc_ref(m_syn_block);
 }
 
@@ -266,7 +289,7 @@ void ast::FunctionBody::syn_block(const ast_ptr<Block>& block) {
 	m_syn_block = block;
 }
 
-const gc::Ref<ss::TextPos>& ast::FunctionBody::get_pos() const {
+const ss::TextPos& ast::FunctionBody::get_pos() const {
 	return m_syn_pos;
 }
 
@@ -304,19 +327,23 @@ gc::Local<const rt::NameDescriptor> ast::ClassDeclaration::bind_declare_0(
 }
 
 void ast::ClassDeclaration::bind_define(rt::BindContext* context, rt::BindScope* scope) {
-	m_expression = gc::create<ClassExpression>(get_pos().local(), m_syn_body.local());
+	m_expression = gc::create<ClassExpression>(get_pos(), m_syn_body.local());
 	m_expression->bind(context, scope);
 }
 
 void ast::ClassDeclaration::exec_define_0(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope,
-	gc::Local<rt::Value>& exception,
+	rt::ValueLoc& exception,
 	const rt::NameDescriptor* name_desc)
 {
 	//Nothing.
 }
 
+void ast::ClassDeclaration::compile_define_0(rt::CodeCompiler* compiler, const rt::NameDescriptor* name_desc) {
+	//Nothing.
+}
+
 //
 //ClassBody
 //
@@ -24,6 +24,7 @@
 #include "ast.h"
 #include "ast__dec.h"
 #include "ast_type.h"
+#include "bytecode__dec.h"
 #include "gc.h"
 #include "scope.h"
 
@@ -37,7 +38,7 @@ namespace syn_script {
 		class Declaration : public Node {
 			NONCOPYABLE(Declaration);
 		
-			gc::Ref<TextPos> m_syn_pos;
+			TextPos m_syn_pos;
 			gc::Ref<AstName> m_syn_name;
 
 			rt::ScopeID m_scope_id;
@@ -53,9 +54,9 @@ namespace syn_script {
 			void syn_name(const SynName&);
 
 		public:
-			const gc::Ref<TextPos>& get_pos() const;
+			const TextPos& get_pos() const;
 			const gc::Ref<AstName>& get_name() const;
-			const rt::NameDescriptor* get_name_descriptor() const;
+			const gc::Ref<const rt::NameDescriptor>& get_name_descriptor() const;
 			virtual ast_ptr<FunctionDeclaration> get_function_opt();
 			virtual ModifierType get_default_access() const;
 
@@ -65,7 +66,9 @@ namespace syn_script {
 			void exec_define(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope,
-				gc::Local<rt::Value>& exception);
+				rt::ValueLoc& exception);
+
+			void compile_define(rt::CodeCompiler* compiler);
 
 		protected:
 			virtual rt::DeclarationType get_declaration_type() const = 0;
@@ -77,8 +80,10 @@ namespace syn_script {
 			virtual void exec_define_0(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope,
-				gc::Local<rt::Value>& exception,
+				rt::ValueLoc& exception,
 				const rt::NameDescriptor* name_desc) = 0;
+
+			virtual void compile_define_0(rt::CodeCompiler* compiler, const rt::NameDescriptor* name_desc) = 0;
 		};
 
 		//
@@ -112,8 +117,10 @@ namespace syn_script {
 			void exec_define_0(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope,
-				gc::Local<rt::Value>& exception,
+				rt::ValueLoc& exception,
 				const rt::NameDescriptor* name_desc) override;
+
+			void compile_define_0(rt::CodeCompiler* compiler, const rt::NameDescriptor* name_desc) override;
 		};
 
 		//
@@ -147,8 +154,10 @@ namespace syn_script {
 			void exec_define_0(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope,
-				gc::Local<rt::Value>& exception,
+				rt::ValueLoc& exception,
 				const rt::NameDescriptor* name_desc) override;
+
+			void compile_define_0(rt::CodeCompiler* compiler, const rt::NameDescriptor* name_desc) override;
 		};
 
 		//
@@ -190,8 +199,10 @@ namespace syn_script {
 			void exec_define_0(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope,
-				gc::Local<rt::Value>& exception,
+				rt::ValueLoc& exception,
 				const rt::NameDescriptor* name_desc) override;
+
+			void compile_define_0(rt::CodeCompiler* compiler, const rt::NameDescriptor* name_desc) override;
 		};
 
 		//
@@ -201,7 +212,7 @@ namespace syn_script {
 		class FunctionFormalParameters : public Node {
 			NONCOPYABLE(FunctionFormalParameters);
 
-			gc::Ref<TextPos> m_syn_pos;
+			TextPos m_syn_pos;
 			ast_ref<const ast_node_list<AstName>> m_syn_parameters;
 
 		public:
@@ -216,7 +227,7 @@ namespace syn_script {
 			void syn_parameters(const ast_ptr<const ast_node_list<AstName>>&);
 
 		public:
-			const gc::Ref<TextPos>& get_pos() const;
+			const TextPos& get_pos() const;
 			const ast_ref<const ast_node_list<AstName>>& get_parameters() const;
 		};
 
@@ -227,7 +238,7 @@ namespace syn_script {
 		class FunctionBody : public Node {
 			NONCOPYABLE(FunctionBody);
 
-			gc::Ref<TextPos> m_syn_pos;
+			TextPos m_syn_pos;
 			ast_ref<Block> m_syn_block;
 
 		public:
@@ -242,7 +253,7 @@ namespace syn_script {
 			void syn_block(const ast_ptr<Block>&);
 
 		public:
-			const gc::Ref<TextPos>& get_pos() const;
+			const TextPos& get_pos() const;
 			const ast_ref<Block>& get_block();
 		};
 
@@ -282,8 +293,10 @@ namespace syn_script {
 			void exec_define_0(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope,
-				gc::Local<rt::Value>& exception,
+				rt::ValueLoc& exception,
 				const rt::NameDescriptor* name_desc) override;
+
+			void compile_define_0(rt::CodeCompiler* compiler, const rt::NameDescriptor* name_desc) override;
 		};
 
 		//
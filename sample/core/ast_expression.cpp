@@ -21,12 +21,14 @@
 #include "api_basic.h"
 #include "ast.h"
 #include "ast_combined.h"
+#include "bytecode.h"
 #include "gc.h"
 #include "name.h"
 #include "scope.h"
 #include "stacktrace.h"
 #include "value.h"
 #include "value_core.h"
+#include "value_stack.h"
 
 namespace ss = syn_script;
 namespace ast = ss::ast;
@@ -35,23 +37,22 @@ namespace gc = ss::gc;
 
 namespace {
 
-	gc::Local<gc::Array<rt::Value>> evaluate_arguments(
+	//Evaluates the arguments into a value stack window. Returns false if an exception has been thrown.
+	bool evaluate_arguments(
 		const gc::Local<rt::ExecContext>& context,
 		const gc::Local<rt::ExecScope>& scope,
 		const ast::ast_ref<const ast::ast_node_list<ast::Expression>>& syn_arguments,
-		gc::Local<rt::Value>& exception)
+		const rt::ValueStackWindow& arguments,
+		rt::ValueLoc& exception)
 	{
-		std::size_t arg_cnt = syn_arguments->size();
-
-		gc::Local<gc::Array<rt::Value>> arguments = gc::Array<rt::Value>::create(arg_cnt);
-		for (std::size_t i = 0; i < arg_cnt; ++i) {
+		rt::ValueRef* values = arguments.get_values();
+		for (std::size_t i = 0, n = syn_arguments->size(); i < n; ++i) {
 			const ast::ast_ref<ast::Expression>& syn_arg = (*syn_arguments)[i];
-			gc::Local<rt::Value> arg = syn_arg->evaluate(context, scope, exception);
-			if (!!exception) return arguments;
-			arguments->get(i) = arg;
+			rt::ValueLoc arg = syn_arg->evaluate(context, scope, exception);
+			if (!!exception) return false;
+			values[i] = arg;
 		}
-
-		return arguments;
+		return true;
 	}
 
 }
@@ -60,7 +61,7 @@ namespace {
 //Expression
 //
 
-gc::Local<ss::TextPos> ast::Expression::get_start_pos() const {
+ss::TextPos ast::Expression::get_start_pos() const {
 	return get_pos();
 }
 
@@ -76,53 +77,99 @@ bool ast::Expression::is_instantiation_allowed() const {
 	return false;
 }
 
-gc::Local<rt::Value> ast::Expression::evaluate(
+rt::ValueLoc ast::Expression::evaluate(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope,
-	gc::Local<rt::Value>& exception)
+	rt::ValueLoc& exception)
 {
 	try {
-		gc::Local<rt::Value> result = evaluate_0(context, scope, exception);
+		rt::ValueLoc result = evaluate_0(context, scope, exception);
 		assert(!!exception || !!result);
 		return result;
 	} catch (const RuntimeError& e) {
 		exception = ThrowStatement::create_exception_value(get_pos(), e);
-		return gc::Local<rt::Value>();
+		return rt::ValueLoc();
 	}
 }
 
-gc::Local<rt::Value> ast::Expression::modify(
+rt::ValueLoc ast::Expression::modify(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope,
-	gc::Local<rt::Value>& exception,
+	rt::ValueLoc& exception,
 	rt::ValueModifier& modifier)
 {
 	try {
-		gc::Local<rt::Value> result = modify_0(context, scope, exception, modifier);
+		rt::ValueLoc result = modify_0(context, scope, exception, modifier);
 		assert(!!result);
 		return result;
 	} catch (const RuntimeError& e) {
 		exception = ThrowStatement::create_exception_value(get_pos(), e);
-		return gc::Local<rt::Value>();
+		return rt::ValueLoc();
 	}
 }
 
-gc::Local<rt::Value> ast::Expression::modify_0(
+rt::ValueLoc ast::Expression::modify_0(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope,
-	gc::Local<rt::Value>& exception,
+	rt::ValueLoc& exception,
 	rt::ValueModifier& modifier)
 {
 	throw RuntimeError("Not an lvalue");
 }
 
+void ast::Expression::compile(rt::CodeCompiler* compiler, rt::CodeReg dst) {
+	compiler->emit_evaluate(dst, self(this));
+}
+
+void ast::Expression::compile_modify(rt::CodeCompiler* compiler, rt::CodeModifier& modifier, rt::CodeReg dst) {
+	throw SystemError(get_pos(), "Not an lvalue");
+}
+
+rt::ValueLoc ast::Expression::evaluate_invocation(
+	const gc::Local<rt::ExecContext>& context,
+	const gc::Local<rt::ExecScope>& scope,
+	const TextPos& pos,
+	const ast_ref<const ast_node_list<Expression>>& arguments,
+	rt::ValueLoc& exception)
+{
+	rt::ValueLoc function = evaluate(context, scope, exception);
+	if (!!exception) return context->get_undefined_value();
+
+	rt::ValueStackWindow values(arguments->size());
+	if (!evaluate_arguments(context, scope, arguments, values, exception)) {
+		return context->get_undefined_value();
+	}
+
+	rt::StackTraceMark stack_trace(pos);
+	rt::ValueLoc value = function->invoke(context, values.get_span(), exception);
+	if (!!exception) return context->get_undefined_value();
+
+	return value;
+}
+
+void ast::Expression::compile_invocation(
+	rt::CodeCompiler* compiler,
+	const TextPos& pos,
+	rt::CodeReg dst,
+	const ast_ref<const ast_node_list<Expression>>& arguments)
+{
+	rt::CodeRegisterGuard guard(compiler);
+	rt::CodeReg function = compiler->allocate_register();
+	compile(compiler, function);
+
+	std::size_t arg_cnt = arguments->size();
+	rt::CodeReg values = compiler->allocate_registers(arg_cnt);
+	for (std::size_t i = 0; i < arg_cnt; ++i) (*arguments)[i]->compile(compiler, values + i);
+
+	compiler->emit_invoke(pos, dst, function, values, arg_cnt);
+}
+
 //
 //BinaryExpression
 //
 
 void ast::BinaryExpression::gc_enumerate_refs() {
 	Expression::gc_enumerate_refs();
-	gc_ref(m_syn_pos);
 	gc_ref(m_syn_left);
 	gc_ref(m_syn_right);
 }
@@ -155,11 +202,11 @@ const ast::ast_ref<ast::Expression>& ast::BinaryExpression::get_right() const {
 	return m_syn_right;
 }
 
-gc::Local<ss::TextPos> ast::BinaryExpression::get_pos() const {
+ss::TextPos ast::BinaryExpression::get_pos() const {
 	return m_syn_pos;
 }
 
-gc::Local<ss::TextPos> ast::BinaryExpression::get_start_pos() const {
+ss::TextPos ast::BinaryExpression::get_start_pos() const {
 	return m_syn_left->get_start_pos();
 }
 
@@ -222,25 +269,25 @@ void ast::BinaryExpression::bind(rt::BindContext* context, rt::BindScope* scope)
 class ast::AssignmentExpression::Modifier : public rt::ValueModifier {
 	const gc::Local<rt::ExecContext> m_context;
 	const rt::BinaryOperator* m_op;
-	const gc::Local<rt::Value> m_right_value;
+	const rt::ValueLoc m_right_value;
 
 public:
 	Modifier(
 		const gc::Local<rt::ExecContext>& context,
 		const rt::BinaryOperator* op,
-		const gc::Local<rt::Value>& right_value)
+		const rt::ValueLoc& right_value)
 		: m_context(context),
 		m_op(op),
 		m_right_value(right_value)
 	{}
 
-	gc::Local<rt::Value> modify_short(gc::Local<rt::Value>& result) override {
+	rt::ValueLoc modify_short(rt::ValueLoc& result) override {
 		if (m_op) return nullptr;
 		result = m_right_value;
 		return m_right_value;
 	}
 
-	gc::Local<rt::Value> modify(const gc::Local<rt::Value>& value, gc::Local<rt::Value>& result) override {
+	rt::ValueLoc modify(const rt::ValueLoc& value, rt::ValueLoc& result) override {
 		if (m_op) {
 			result = m_op->evaluate(m_context, value, m_right_value);
 		} else {
@@ -251,6 +298,43 @@ public:
 	}
 };
 
+//
+//AssignmentExpression::CodeModifier
+//
+
+class ast::AssignmentExpression::CodeModifier : public rt::CodeModifier {
+	const rt::BinaryOperator* m_op;
+	const rt::CodeReg m_right_value;
+
+public:
+	CodeModifier(const rt::BinaryOperator* op, rt::CodeReg right_value)
+		: m_op(op),
+		m_right_value(right_value)
+	{}
+
+	bool compile_short(rt::CodeCompiler* compiler, rt::CodeReg result, rt::CodeReg* new_value) override {
+		if (m_op) return false;
+		compiler->emit_move(result, m_right_value);
+		*new_value = m_right_value;
+		return true;
+	}
+
+	void compile(
+		rt::CodeCompiler* compiler,
+		const TextPos& pos,
+		rt::CodeReg old_value,
+		rt::CodeReg new_value,
+		rt::CodeReg result) override
+	{
+		if (m_op) {
+			compiler->emit_binary(pos, m_op, new_value, old_value, m_right_value);
+		} else {
+			compiler->emit_move(new_value, m_right_value);
+		}
+		compiler->emit_move(result, new_value);
+	}
+};
+
 //
 //AssignmentExpression
 //
@@ -270,30 +354,37 @@ void ast::AssignmentExpression::bind(rt::BindContext* context, rt::BindScope* sc
 	}
 }
 
-gc::Local<rt::Value> ast::AssignmentExpression::evaluate_0(
+rt::ValueLoc ast::AssignmentExpression::evaluate_0(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope,
-	gc::Local<rt::Value>& exception)
+	rt::ValueLoc& exception)
 {
-	gc::Local<rt::Value> right = get_right()->evaluate(context, scope, exception);
+	rt::ValueLoc right = get_right()->evaluate(context, scope, exception);
 	if (!!exception) return context->get_undefined_value();
 
 	if (right->is_undefined()) throw RuntimeError(get_pos(), "The value is undefined");
 	if (right->is_void()) throw RuntimeError(get_pos(), "Cannot assign a void value");
 
 	Modifier modifier(context, get_op(), right);
-	gc::Local<rt::Value> result = get_left()->modify(context, scope, exception, modifier);
+	rt::ValueLoc result = get_left()->modify(context, scope, exception, modifier);
 	assert(!!exception || !!result);
 	return result;
 }
 
+void ast::AssignmentExpression::compile(rt::CodeCompiler* compiler, rt::CodeReg dst) {
+	get_right()->compile(compiler, dst);
+	compiler->emit_check_assign(get_pos(), dst);
+
+	CodeModifier modifier(get_op(), dst);
+	get_left()->compile_modify(compiler, modifier, dst);
+}
+
 //
 //ConditionalExpression
 //
 
 void ast::ConditionalExpression::gc_enumerate_refs() {
 	Expression::gc_enumerate_refs();
-	gc_ref(m_syn_pos);
 	gc_ref(m_syn_condition);
 	gc_ref(m_syn_true_expression);
 	gc_ref(m_syn_false_expression);
@@ -315,11 +406,11 @@ void ast::ConditionalExpression::syn_false_expression(const ast_ptr<Expression>&
 	m_syn_false_expression = false_expression;
 }
 
-gc::Local<ss::TextPos> ast::ConditionalExpression::get_pos() const {
+ss::TextPos ast::ConditionalExpression::get_pos() const {
 	return m_syn_pos;
 }
 
-gc::Local<ss::TextPos> ast::ConditionalExpression::get_start_pos() const {
+ss::TextPos ast::ConditionalExpression::get_start_pos() const {
 	return m_syn_condition->get_start_pos();
 }
 
@@ -339,12 +430,12 @@ void ast::ConditionalExpression::bind(rt::BindContext* context, rt::BindScope* s
 	m_syn_false_expression->bind(context, scope);
 }
 
-gc::Local<rt::Value> ast::ConditionalExpression::evaluate_0(
+rt::ValueLoc ast::ConditionalExpression::evaluate_0(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope,
-	gc::Local<rt::Value>& exception)
+	rt::ValueLoc& exception)
 {
-	gc::Local<rt::Value> condition = m_syn_condition->evaluate(context, scope, exception);
+	rt::ValueLoc condition = m_syn_condition->evaluate(context, scope, exception);
 	if (!!exception) return context->get_undefined_value();
 
 	const ast_ref<Expression>& expression = condition->get_boolean()
@@ -352,6 +443,24 @@ gc::Local<rt::Value> ast::ConditionalExpression::evaluate_0(
 	return expression->evaluate(context, scope, exception);
 }
 
+void ast::ConditionalExpression::compile(rt::CodeCompiler* compiler, rt::CodeReg dst) {
+	rt::CodeLabel false_label;
+	rt::CodeLabel end_label;
+
+	{
+		rt::CodeRegisterGuard guard(compiler);
+		rt::CodeReg condition = compiler->allocate_register();
+		m_syn_condition->compile(compiler, condition);
+		compiler->emit_jump_if_false(m_syn_pos, condition, false_label);
+	}
+
+	m_syn_true_expression->compile(compiler, dst);
+	compiler->emit_jump(end_label);
+	compiler->bind_label(false_label);
+	m_syn_false_expression->compile(compiler, dst);
+	compiler->bind_label(end_label);
+}
+
 //
 //RegularBinaryExpression
 //
@@ -361,19 +470,19 @@ void ast::RegularBinaryExpression::bind(rt::BindContext* context, rt::BindScope*
 	assert(get_op());
 }
 
-gc::Local<rt::Value> ast::RegularBinaryExpression::evaluate_0(
+rt::ValueLoc ast::RegularBinaryExpression::evaluate_0(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope,
-	gc::Local<rt::Value>& exception)
+	rt::ValueLoc& exception)
 {
 	const rt::BinaryOperator* op = get_op();
 
-	gc::Local<rt::Value> a = get_left()->evaluate(context, scope, exception);
+	rt::ValueLoc a = get_left()->evaluate(context, scope, exception);
 	if (!!exception) return context->get_undefined_value();
 
-	gc::Local<rt::Value> result = op->evaluate_short(context, a);
+	rt::ValueLoc result = op->evaluate_short(context, a);
 	if (!result) {
-		gc::Local<rt::Value> b = get_right()->evaluate(context, scope, exception);
+		rt::ValueLoc b = get_right()->evaluate(context, scope, exception);
 		if (!!exception) return context->get_undefined_value();
 
 		result = op->evaluate(context, a, b);
@@ -382,13 +491,26 @@ gc::Local<rt::Value> ast::RegularBinaryExpression::evaluate_0(
 	return result;
 }
 
+void ast::RegularBinaryExpression::compile(rt::CodeCompiler* compiler, rt::CodeReg dst) {
+	const rt::BinaryOperator* op = get_op();
+	rt::CodeLabel end_label;
+
+	get_left()->compile(compiler, dst);
+	compiler->emit_binary_short(get_pos(), op, dst, dst, end_label);
+
+	rt::CodeRegisterGuard guard(compiler);
+	rt::CodeReg b = compiler->allocate_register();
+	get_right()->compile(compiler, b);
+	compiler->emit_binary(get_pos(), op, dst, dst, b);
+	compiler->bind_label(end_label);
+}
+
 //
 //UnaryExpression
 //
 
 void ast::UnaryExpression::gc_enumerate_refs() {
 	Expression::gc_enumerate_refs();
-	gc_ref(m_syn_pos);
 	gc_ref(m_syn_expression);
 }
 
@@ -400,7 +522,7 @@ void ast::UnaryExpression::syn_expression(const ast_ptr<Expression>& expression)
 	m_syn_expression = expression;
 }
 
-gc::Local<ss::TextPos> ast::UnaryExpression::get_pos() const {
+ss::TextPos ast::UnaryExpression::get_pos() const {
 	return m_syn_pos;
 }
 
@@ -438,17 +560,22 @@ void ast::RegularUnaryExpression::bind(rt::BindContext* context, rt::BindScope*
 	}
 }
 
-gc::Local<rt::Value> ast::RegularUnaryExpression::evaluate_0(
+rt::ValueLoc ast::RegularUnaryExpression::evaluate_0(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope,
-	gc::Local<rt::Value>& exception)
+	rt::ValueLoc& exception)
 {
-	gc::Local<rt::Value> a = get_expression()->evaluate(context, scope, exception);
+	rt::ValueLoc a = get_expression()->evaluate(context, scope, exception);
 	if (!!exception) return context->get_undefined_value();
 
 	return m_op->evaluate(context, a);
 }
 
+void ast::RegularUnaryExpression::compile(rt::CodeCompiler* compiler, rt::CodeReg dst) {
+	get_expression()->compile(compiler, dst);
+	compiler->emit_unary(get_pos(), m_op, dst, dst);
+}
+
 //
 //IncrementDecrementExpression::Modifier
 //
@@ -463,7 +590,7 @@ public:
 		m_expression(expression)
 	{}
 
-	gc::Local<rt::Value> modify(const gc::Local<rt::Value>& value, gc::Local<rt::Value>& result) override {
+	rt::ValueLoc modify(const rt::ValueLoc& value, rt::ValueLoc& result) override {
 		if (value->is_undefined()) {
 			throw RuntimeError(m_expression->get_pos(), "The value of the operand is undefined");
 		}
@@ -471,7 +598,7 @@ public:
 			throw RuntimeError(m_expression->get_pos(), "The value of the operand is void");
 		}
 
-		gc::Local<rt::Value> new_value;
+		rt::ValueLoc new_value;
 		rt::OperandType type = value->get_operand_type();
 		if (rt::OperandType::INTEGER == type) {
 			ScriptIntegerType x = value->get_integer();
@@ -488,6 +615,35 @@ public:
 	}
 };
 
+//
+//IncrementDecrementExpression::CodeModifier
+//
+
+class ast::IncrementDecrementExpression::CodeModifier : public rt::CodeModifier {
+	const IncrementDecrementExpression* const m_expression;
+
+public:
+	explicit CodeModifier(const IncrementDecrementExpression* expression)
+		: m_expression(expression)
+	{}
+
+	void compile(
+		rt::CodeCompiler* compiler,
+		const TextPos& pos,
+		rt::CodeReg old_value,
+		rt::CodeReg new_value,
+		rt::CodeReg result) override
+	{
+		compiler->emit_increment(
+			m_expression->get_pos(),
+			m_expression->m_syn_increment,
+			m_expression->m_syn_postfix,
+			old_value,
+			new_value,
+			result);
+	}
+};
+
 //
 //IncrementDecrementExpression
 //
@@ -500,28 +656,38 @@ void ast::IncrementDecrementExpression::syn_postfix(bool postfix) {
 	m_syn_postfix = postfix;
 }
 
-gc::Local<ss::TextPos> ast::IncrementDecrementExpression::get_start_pos() const {
+ss::TextPos ast::IncrementDecrementExpression::get_start_pos() const {
 	return m_syn_postfix ? get_expression()->get_start_pos() : get_pos();
 }
 
-gc::Local<rt::Value> ast::IncrementDecrementExpression::evaluate_0(
+rt::ValueLoc ast::IncrementDecrementExpression::evaluate_0(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope,
-	gc::Local<rt::Value>& exception)
+	rt::ValueLoc& exception)
 {
 	Modifier modifier(context, this);
 	return get_expression()->modify(context, scope, exception, modifier);
 }
 
+void ast::IncrementDecrementExpression::compile(rt::CodeCompiler* compiler, rt::CodeReg dst) {
+	const ast_ref<Expression>& expression = get_expression();
+	if (expression->is_assignment_allowed()) {
+		CodeModifier modifier(this);
+		expression->compile_modify(compiler, modifier, dst);
+	} else {
+		Expression::compile(compiler, dst);
+	}
+}
+
 //
 //MemberExpression
 //
 
 void ast::MemberExpression::gc_enumerate_refs() {
 	TerminalExpression::gc_enumerate_refs();
-	gc_ref(m_syn_pos);
 	gc_ref(m_syn_object);
 	gc_ref(m_syn_name);
+	gc_ref(m_member_cache);
 }
 
 void ast::MemberExpression::syn_pos(const SynPos& pos) {
@@ -536,11 +702,11 @@ void ast::MemberExpression::syn_name(const SynName& name) {
 	m_syn_name = name;
 }
 
-gc::Local<ss::TextPos> ast::MemberExpression::get_pos() const {
+ss::TextPos ast::MemberExpression::get_pos() const {
 	return m_syn_pos;
 }
 
-gc::Local<ss::TextPos> ast::MemberExpression::get_start_pos() const {
+ss::TextPos ast::MemberExpression::get_start_pos() const {
 	return m_syn_object->get_start_pos();
 }
 
@@ -558,48 +724,120 @@ bool ast::MemberExpression::is_instantiation_allowed() const {
 
 void ast::MemberExpression::bind(rt::BindContext* context, rt::BindScope* scope) {
 	m_syn_object->bind(context, scope);
+	m_member_cache = gc::create<rt::MemberCache>();
 }
 
-gc::Local<rt::Value> ast::MemberExpression::evaluate_0(
+rt::ValueLoc ast::MemberExpression::evaluate_0(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope,
-	gc::Local<rt::Value>& exception)
+	rt::ValueLoc& exception)
 {
-	gc::Local<rt::Value> object = m_syn_object->evaluate(context, scope, exception);
+	rt::ValueLoc object = m_syn_object->evaluate(context, scope, exception);
 	if (!!exception) return context->get_undefined_value();
 
-	return object->get_member(context, scope, m_syn_name->get_info());
+	return object->get_member(context, scope, m_syn_name->get_info(), *m_member_cache);
 }
 
-gc::Local<rt::Value> ast::MemberExpression::modify_0(
+rt::ValueLoc ast::MemberExpression::modify_0(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope,
-	gc::Local<rt::Value>& exception,
+	rt::ValueLoc& exception,
 	rt::ValueModifier& modifier)
 {
-	gc::Local<rt::Value> object = m_syn_object->evaluate(context, scope, exception);
+	rt::ValueLoc object = m_syn_object->evaluate(context, scope, exception);
 	if (!!exception) return exception;
 
-	gc::Local<rt::Value> result;
-	gc::Local<rt::Value> new_value = modifier.modify_short(result);
+	rt::ValueLoc result;
+	rt::ValueLoc new_value = modifier.modify_short(result);
 	if (!new_value) {
-		//TODO Do not lookup the member by name twice here.
-		gc::Local<rt::Value> old_value = object->get_member(context, scope, m_syn_name->get_info());
+		rt::ValueLoc old_value = object->get_member(context, scope, m_syn_name->get_info(), *m_member_cache);
 		new_value = modifier.modify(old_value, result);
 		assert(!!new_value);
 	}
 
-	object->set_member(context, scope, m_syn_name->get_info(), new_value);
+	object->set_member(context, scope, m_syn_name->get_info(), new_value, *m_member_cache);
 	return result;
 }
 
+void ast::MemberExpression::compile(rt::CodeCompiler* compiler, rt::CodeReg dst) {
+	rt::CodeRegisterGuard guard(compiler);
+	rt::CodeReg object = compiler->allocate_register();
+	m_syn_object->compile(compiler, object);
+	compiler->emit_get_member(m_syn_pos, dst, object, m_syn_name->get_info());
+}
+
+void ast::MemberExpression::compile_modify(
+	rt::CodeCompiler* compiler,
+	rt::CodeModifier& modifier,
+	rt::CodeReg dst)
+{
+	rt::CodeRegisterGuard guard(compiler);
+	rt::CodeReg object = compiler->allocate_register();
+	m_syn_object->compile(compiler, object);
+
+	rt::CodeReg new_value;
+	if (!modifier.compile_short(compiler, dst, &new_value)) {
+		rt::CodeReg old_value = compiler->allocate_register();
+		compiler->emit_get_member(m_syn_pos, old_value, object, m_syn_name->get_info());
+		new_value = compiler->allocate_register();
+		modifier.compile(compiler, m_syn_pos, old_value, new_value, dst);
+	}
+
+	compiler->emit_set_member(m_syn_pos, object, m_syn_name->get_info(), new_value);
+}
+
+//Invokes the member directly, so that API methods do not have to create a method value.
+rt::ValueLoc ast::MemberExpression::evaluate_invocation(
+	const gc::Local<rt::ExecContext>& context,
+	const gc::Local<rt::ExecScope>& scope,
+	const TextPos& pos,
+	const ast_ref<const ast_node_list<Expression>>& arguments,
+	rt::ValueLoc& exception)
+{
+	rt::ValueLoc object = m_syn_object->evaluate(context, scope, exception);
+	if (!!exception) return context->get_undefined_value();
+
+	rt::ValueStackWindow values(arguments->size());
+	if (!evaluate_arguments(context, scope, arguments, values, exception)) {
+		return context->get_undefined_value();
+	}
+
+	rt::StackTraceMark stack_trace(pos);
+	rt::ValueLoc value = object->invoke_member(
+		context,
+		scope,
+		m_syn_name->get_info(),
+		values.get_span(),
+		*m_member_cache,
+		exception);
+	if (!!exception) return context->get_undefined_value();
+
+	return value;
+}
+
+void ast::MemberExpression::compile_invocation(
+	rt::CodeCompiler* compiler,
+	const TextPos& pos,
+	rt::CodeReg dst,
+	const ast_ref<const ast_node_list<Expression>>& arguments)
+{
+	rt::CodeRegisterGuard guard(compiler);
+	rt::CodeReg object = compiler->allocate_register();
+	m_syn_object->compile(compiler, object);
+
+	std::size_t arg_cnt = arguments->size();
+	rt::CodeReg values = compiler->allocate_registers(arg_cnt);
+	for (std::size_t i = 0; i < arg_cnt; ++i) (*arguments)[i]->compile(compiler, values + i);
+
+	compiler->emit_invoke_member(pos, dst, object, m_syn_name->get_info(), values, arg_cnt);
+}
+
 //
 //InvocationExpression
 //
 
 void ast::InvocationExpression::gc_enumerate_refs() {
 	TerminalExpression::gc_enumerate_refs();
-	gc_ref(m_syn_pos);
 	gc_ref(m_syn_function);
 	gc_ref(m_syn_arguments);
 }
@@ -616,11 +854,11 @@ void ast::InvocationExpression::syn_arguments(const ast_ptr<const ast_node_list<
 	m_syn_arguments = arguments;
 }
 
-gc::Local<ss::TextPos> ast::InvocationExpression::get_pos() const {
+ss::TextPos ast::InvocationExpression::get_pos() const {
 	return m_syn_pos;
 }
 
-gc::Local<ss::TextPos> ast::InvocationExpression::get_start_pos() const {
+ss::TextPos ast::InvocationExpression::get_start_pos() const {
 	return m_syn_function->get_start_pos();
 }
 
@@ -642,22 +880,16 @@ void ast::InvocationExpression::bind(rt::BindContext* context, rt::BindScope* sc
 	}
 }
 
-gc::Local<rt::Value> ast::InvocationExpression::evaluate_0(
+rt::ValueLoc ast::InvocationExpression::evaluate_0(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope,
-	gc::Local<rt::Value>& exception)
+	rt::ValueLoc& exception)
 {
-	gc::Local<rt::Value> function = m_syn_function->evaluate(context, scope, exception);
-	if (!!exception) return context->get_undefined_value();
-
-	gc::Local<gc::Array<rt::Value>> arguments = evaluate_arguments(context, scope, m_syn_arguments, exception);
-	if (!!exception) return context->get_undefined_value();
-
-	rt::StackTraceMark stack_trace(m_syn_pos);
-	gc::Local<rt::Value> value = function->invoke(context, arguments, exception);
-	if (!!exception) return context->get_undefined_value();
+	return m_syn_function->evaluate_invocation(context, scope, m_syn_pos, m_syn_arguments, exception);
+}
 
-	return value;
+void ast::InvocationExpression::compile(rt::CodeCompiler* compiler, rt::CodeReg dst) {
+	m_syn_function->compile_invocation(compiler, m_syn_pos, dst, m_syn_arguments);
 }
 
 //
@@ -666,7 +898,6 @@ gc::Local<rt::Value> ast::InvocationExpression::evaluate_0(
 
 void ast::NewObjectExpression::gc_enumerate_refs() {
 	TerminalExpression::gc_enumerate_refs();
-	gc_ref(m_syn_pos);
 	gc_ref(m_syn_type_expr);
 	gc_ref(m_syn_arguments);
 }
@@ -683,7 +914,7 @@ void ast::NewObjectExpression::syn_arguments(const ast_ptr<const ast_node_list<E
 	m_syn_arguments = arguments;
 }
 
-gc::Local<ss::TextPos> ast::NewObjectExpression::get_pos() const {
+ss::TextPos ast::NewObjectExpression::get_pos() const {
 	return m_syn_pos;
 }
 
@@ -697,31 +928,44 @@ void ast::NewObjectExpression::bind(rt::BindContext* context, rt::BindScope* sco
 	}
 }
 
-gc::Local<rt::Value> ast::NewObjectExpression::evaluate_0(
+rt::ValueLoc ast::NewObjectExpression::evaluate_0(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope,
-	gc::Local<rt::Value>& exception)
+	rt::ValueLoc& exception)
 {
-	gc::Local<rt::Value> type = m_syn_type_expr->evaluate(context, scope, exception);
+	rt::ValueLoc type = m_syn_type_expr->evaluate(context, scope, exception);
 	if (!!exception) return context->get_undefined_value();
 
-	gc::Local<gc::Array<rt::Value>> arguments = evaluate_arguments(context, scope, m_syn_arguments, exception);
-	if (!!exception) return context->get_undefined_value();
+	rt::ValueStackWindow arguments(m_syn_arguments->size());
+	if (!evaluate_arguments(context, scope, m_syn_arguments, arguments, exception)) {
+		return context->get_undefined_value();
+	}
 
 	rt::StackTraceMark stack_trace(m_syn_pos);
-	gc::Local<rt::Value> value = type->instantiate(context, arguments, exception);
+	rt::ValueLoc value = type->instantiate(context, arguments.get_span(), exception);
 	if (!!exception) return context->get_undefined_value();
 
 	return value;
 }
 
+void ast::NewObjectExpression::compile(rt::CodeCompiler* compiler, rt::CodeReg dst) {
+	rt::CodeRegisterGuard guard(compiler);
+	rt::CodeReg type = compiler->allocate_register();
+	m_syn_type_expr->compile(compiler, type);
+
+	std::size_t arg_cnt = m_syn_arguments->size();
+	rt::CodeReg arguments = compiler->allocate_registers(arg_cnt);
+	for (std::size_t i = 0; i < arg_cnt; ++i) (*m_syn_arguments)[i]->compile(compiler, arguments + i);
+
+	compiler->emit_instantiate(m_syn_pos, dst, type, arguments, arg_cnt);
+}
+
 //
 //NewArrayExpression
 //
 
 void ast::NewArrayExpression::gc_enumerate_refs() {
 	TerminalExpression::gc_enumerate_refs();
-	gc_ref(m_syn_pos);
 	gc_ref(m_syn_length);
 }
 
@@ -733,7 +977,7 @@ void ast::NewArrayExpression::syn_length(const ast_ptr<Expression>& length) {
 	m_syn_length = length;
 }
 
-gc::Local<ss::TextPos> ast::NewArrayExpression::get_pos() const {
+ss::TextPos ast::NewArrayExpression::get_pos() const {
 	return m_syn_pos;
 }
 
@@ -741,12 +985,12 @@ void ast::NewArrayExpression::bind(rt::BindContext* context, rt::BindScope* scop
 	m_syn_length->bind(context, scope);
 }
 
-gc::Local<rt::Value> ast::NewArrayExpression::evaluate_0(
+rt::ValueLoc ast::NewArrayExpression::evaluate_0(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope,
-	gc::Local<rt::Value>& exception)
+	rt::ValueLoc& exception)
 {
-	gc::Local<rt::Value> length = m_syn_length->evaluate(context, scope, exception);
+	rt::ValueLoc length = m_syn_length->evaluate(context, scope, exception);
 	if (!!exception) return context->get_undefined_value();
 
 	ScriptIntegerType len = length->get_integer();
@@ -754,12 +998,12 @@ gc::Local<rt::Value> ast::NewArrayExpression::evaluate_0(
 	if (len < 0 || len > max_len) throw RuntimeError(m_syn_pos, "Array length out of range");
 	
 	const std::size_t array_len = scriptint_to_size(len);
-	gc::Local<gc::Array<rt::Value>> array = gc::Array<rt::Value>::create(array_len);
-
-	gc::Local<rt::Value> nullval = context->get_value_factory()->get_null_value();
-	for (std::size_t i = 0; i < len; ++i) (*array)[i] = nullval;
+	return gc::create<rt::ArrayValue>(array_len);
+}
 
-	return gc::create<rt::ArrayValue>(array);
+void ast::NewArrayExpression::compile(rt::CodeCompiler* compiler, rt::CodeReg dst) {
+	m_syn_length->compile(compiler, dst);
+	compiler->emit_new_array(m_syn_pos, dst, dst);
 }
 
 //
@@ -768,7 +1012,6 @@ gc::Local<rt::Value> ast::NewArrayExpression::evaluate_0(
 
 void ast::ArrayExpression::gc_enumerate_refs() {
 	TerminalExpression::gc_enumerate_refs();
-	gc_ref(m_syn_pos);
 	gc_ref(m_syn_expressions);
 }
 
@@ -780,7 +1023,7 @@ void ast::ArrayExpression::syn_expressions(const ast_ptr<const ast_node_list<Exp
 	m_syn_expressions = expressions;
 }
 
-gc::Local<ss::TextPos> ast::ArrayExpression::get_pos() const {
+ss::TextPos ast::ArrayExpression::get_pos() const {
 	return m_syn_pos;
 }
 
@@ -790,31 +1033,38 @@ void ast::ArrayExpression::bind(rt::BindContext* context, rt::BindScope* scope)
 	}
 }
 
-gc::Local<rt::Value> ast::ArrayExpression::evaluate_0(
+rt::ValueLoc ast::ArrayExpression::evaluate_0(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope,
-	gc::Local<rt::Value>& exception)
+	rt::ValueLoc& exception)
 {
 	std::size_t len = m_syn_expressions->size();
-	gc::Local<gc::Array<rt::Value>> array = gc::Array<rt::Value>::create(len);
+	gc::Local<rt::ValueArray> array = rt::ValueArray::create(len);
 
 	for (std::size_t i = 0; i < len; ++i) {
-		gc::Local<rt::Value> value = (*m_syn_expressions)[i]->evaluate(context, scope, exception);
+		rt::ValueLoc value = (*m_syn_expressions)[i]->evaluate(context, scope, exception);
 		if (!!exception) return context->get_undefined_value();
 		array->get(i) = value;
 	}
 
-	gc::Local<rt::ArrayValue> array_value = gc::create<rt::ArrayValue>(array);
+	gc::Local<rt::ArrayValue> array_value = gc::create<rt::ArrayValue>(array->raw_array(), len);
 	return array_value;
 }
 
+void ast::ArrayExpression::compile(rt::CodeCompiler* compiler, rt::CodeReg dst) {
+	rt::CodeRegisterGuard guard(compiler);
+	std::size_t len = m_syn_expressions->size();
+	rt::CodeReg elements = compiler->allocate_registers(len);
+	for (std::size_t i = 0; i < len; ++i) (*m_syn_expressions)[i]->compile(compiler, elements + i);
+	compiler->emit_array(dst, elements, len);
+}
+
 //
 //SubscriptExpression
 //
 
 void ast::SubscriptExpression::gc_enumerate_refs() {
 	TerminalExpression::gc_enumerate_refs();
-	gc_ref(m_syn_pos);
 	gc_ref(m_syn_array);
 	gc_ref(m_syn_index);
 }
@@ -831,11 +1081,11 @@ void ast::SubscriptExpression::syn_index(const ast_ptr<Expression>& index) {
 	m_syn_index = index;
 }
 
-gc::Local<ss::TextPos> ast::SubscriptExpression::get_pos() const {
+ss::TextPos ast::SubscriptExpression::get_pos() const {
 	return m_syn_pos;
 }
 
-gc::Local<ss::TextPos> ast::SubscriptExpression::get_start_pos() const {
+ss::TextPos ast::SubscriptExpression::get_start_pos() const {
 	return m_syn_array->get_start_pos();
 }
 
@@ -856,38 +1106,38 @@ void ast::SubscriptExpression::bind(rt::BindContext* context, rt::BindScope* sco
 	m_syn_index->bind(context, scope);
 }
 
-gc::Local<rt::Value> ast::SubscriptExpression::evaluate_0(
+rt::ValueLoc ast::SubscriptExpression::evaluate_0(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope,
-	gc::Local<rt::Value>& exception)
+	rt::ValueLoc& exception)
 {
-	gc::Local<rt::Value> array = m_syn_array->evaluate(context, scope, exception);
+	rt::ValueLoc array = m_syn_array->evaluate(context, scope, exception);
 	if (!!exception) return context->get_undefined_value();
 
 	std::size_t idx = evaluate_index(context, scope, exception);
 	if (!!exception) return context->get_undefined_value();
 
-	gc::Local<rt::Value> result = array->get_array_element(context, idx);
+	rt::ValueLoc result = array->get_array_element(context, idx);
 	assert(!!result);
 	return result;
 }
 
-gc::Local<rt::Value> ast::SubscriptExpression::modify_0(
+rt::ValueLoc ast::SubscriptExpression::modify_0(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope,
-	gc::Local<rt::Value>& exception,
+	rt::ValueLoc& exception,
 	rt::ValueModifier& modifier)
 {
-	gc::Local<rt::Value> array = m_syn_array->evaluate(context, scope, exception);
+	rt::ValueLoc array = m_syn_array->evaluate(context, scope, exception);
 	if (!!exception) return exception;
 
 	std::size_t idx = evaluate_index(context, scope, exception);
 	if (!!exception) return exception;
 
-	gc::Local<rt::Value> result;
-	gc::Local<rt::Value> new_value = modifier.modify_short(result);
+	rt::ValueLoc result;
+	rt::ValueLoc new_value = modifier.modify_short(result);
 	if (!new_value) {
-		gc::Local<rt::Value> old_value = array->get_array_element(context, idx);
+		rt::ValueLoc old_value = array->get_array_element(context, idx);
 		new_value = modifier.modify(old_value, result);
 		assert(!!new_value);
 	}
@@ -899,9 +1149,9 @@ gc::Local<rt::Value> ast::SubscriptExpression::modify_0(
 std::size_t ast::SubscriptExpression::evaluate_index(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope,
-	gc::Local<rt::Value>& exception)
+	rt::ValueLoc& exception)
 {
-	gc::Local<rt::Value> index = m_syn_index->evaluate(context, scope, exception);
+	rt::ValueLoc index = m_syn_index->evaluate(context, scope, exception);
 	if (!!exception) return 0;
 
 	ScriptIntegerType idx = index->get_integer();
@@ -910,6 +1160,37 @@ std::size_t ast::SubscriptExpression::evaluate_index(
 	return static_cast<std::size_t>(idx);
 }
 
+void ast::SubscriptExpression::compile(rt::CodeCompiler* compiler, rt::CodeReg dst) {
+	rt::CodeRegisterGuard guard(compiler);
+	rt::CodeReg array = compiler->allocate_register();
+	m_syn_array->compile(compiler, array);
+	rt::CodeReg index = compiler->allocate_register();
+	m_syn_index->compile(compiler, index);
+	compiler->emit_get_element(m_syn_pos, dst, array, index);
+}
+
+void ast::SubscriptExpression::compile_modify(
+	rt::CodeCompiler* compiler,
+	rt::CodeModifier& modifier,
+	rt::CodeReg dst)
+{
+	rt::CodeRegisterGuard guard(compiler);
+	rt::CodeReg array = compiler->allocate_register();
+	m_syn_array->compile(compiler, array);
+	rt::CodeReg index = compiler->allocate_register();
+	m_syn_index->compile(compiler, index);
+
+	rt::CodeReg new_value;
+	if (!modifier.compile_short(compiler, dst, &new_value)) {
+		rt::CodeReg old_value = compiler->allocate_register();
+		compiler->emit_get_element(m_syn_pos, old_value, array, index);
+		new_value = compiler->allocate_register();
+		modifier.compile(compiler, m_syn_pos, old_value, new_value, dst);
+	}
+
+	compiler->emit_set_element(m_syn_pos, array, index, new_value);
+}
+
 //
 //NameExpression
 //
@@ -924,7 +1205,7 @@ void ast::NameExpression::syn_name(const SynName& name) {
 	m_syn_name = name;
 }
 
-gc::Local<ss::TextPos> ast::NameExpression::get_pos() const {
+ss::TextPos ast::NameExpression::get_pos() const {
 	return m_syn_name->pos();
 }
 
@@ -951,49 +1232,70 @@ void ast::NameExpression::bind(rt::BindContext* context, rt::BindScope* scope) {
 	m_name_descriptor = scope->lookup(m_syn_name);
 }
 
-gc::Local<rt::Value> ast::NameExpression::evaluate_0(
+rt::ValueLoc ast::NameExpression::evaluate_0(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope,
-	gc::Local<rt::Value>& exception)
+	rt::ValueLoc& exception)
 {
 	scope->check_id(m_scope_id);
-	gc::Local<rt::Value> value = m_name_descriptor->get(scope);
+	rt::ValueLoc value = m_name_descriptor->get(scope);
 	assert(!value->is_void());
 	if (value->is_undefined()) throw RuntimeError(m_syn_name->pos(), "Undefined value");
 	return value;
 }
 
-gc::Local<rt::Value> ast::NameExpression::modify_0(
+rt::ValueLoc ast::NameExpression::modify_0(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope,
-	gc::Local<rt::Value>& exception,
+	rt::ValueLoc& exception,
 	rt::ValueModifier& modifier)
 {
 	scope->check_id(m_scope_id);
 
-	gc::Local<rt::Value> result;
-	gc::Local<rt::Value> old_value = m_name_descriptor->get(scope);
-	gc::Local<rt::Value> new_value = modifier.modify(old_value, result);
+	rt::ValueLoc result;
+	rt::ValueLoc old_value = m_name_descriptor->get(scope);
+	rt::ValueLoc new_value = modifier.modify(old_value, result);
 	assert(!!result);
 
 	m_name_descriptor->set_modify(scope, new_value);
 	return result;
 }
 
+void ast::NameExpression::compile(rt::CodeCompiler* compiler, rt::CodeReg dst) {
+	compiler->emit_load_name(get_pos(), dst, m_name_descriptor);
+}
+
+void ast::NameExpression::compile_modify(
+	rt::CodeCompiler* compiler,
+	rt::CodeModifier& modifier,
+	rt::CodeReg dst)
+{
+	rt::CodeRegisterGuard guard(compiler);
+
+	rt::CodeReg new_value;
+	if (!modifier.compile_short(compiler, dst, &new_value)) {
+		rt::CodeReg old_value = compiler->allocate_register();
+		compiler->emit_load_variable(old_value, m_name_descriptor.get());
+		new_value = compiler->allocate_register();
+		modifier.compile(compiler, get_pos(), old_value, new_value, dst);
+	}
+
+	compiler->emit_store_variable(m_name_descriptor.get(), new_value);
+}
+
 //
 //ThisExpression
 //
 
 void ast::ThisExpression::gc_enumerate_refs() {
 	TerminalExpression::gc_enumerate_refs();
-	gc_ref(m_syn_pos);
 }
 
 void ast::ThisExpression::syn_pos(const SynPos& pos) {
 	m_syn_pos = pos;
 }
 
-gc::Local<ss::TextPos> ast::ThisExpression::get_pos() const {
+ss::TextPos ast::ThisExpression::get_pos() const {
 	return m_syn_pos;
 }
 
@@ -1004,14 +1306,18 @@ void ast::ThisExpression::bind(rt::BindContext* context, rt::BindScope* scope) {
 	}
 }
 
-gc::Local<rt::Value> ast::ThisExpression::evaluate_0(
+rt::ValueLoc ast::ThisExpression::evaluate_0(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope,
-	gc::Local<rt::Value>& exception)
+	rt::ValueLoc& exception)
 {
 	return scope->get_this(m_scope_ofs);
 }
 
+void ast::ThisExpression::compile(rt::CodeCompiler* compiler, rt::CodeReg dst) {
+	compiler->emit_load_this(m_syn_pos, dst, m_scope_ofs);
+}
+
 //
 //FunctionExpression
 //
@@ -1042,11 +1348,11 @@ void ast::FunctionExpression::syn_body(const ast_ptr<FunctionBody>& body) {
 	m_syn_body = body;
 }
 
-gc::Local<ss::TextPos> ast::FunctionExpression::get_pos() const {
+ss::TextPos ast::FunctionExpression::get_pos() const {
 	return m_syn_body->get_pos();;
 }
 
-gc::Local<ss::TextPos> ast::FunctionExpression::get_start_pos() const {
+ss::TextPos ast::FunctionExpression::get_start_pos() const {
 	return !!m_syn_parameters ? m_syn_parameters->get_pos() : m_syn_body->get_pos();
 }
 
@@ -1055,6 +1361,7 @@ bool ast::FunctionExpression::is_invocation_allowed() const {
 }
 
 void ast::FunctionExpression::bind(rt::BindContext* context, rt::BindScope* scope) {
+	m_source = SourceRef(get_pos());
 	std::unique_ptr<rt::BindScope> sub_scope = scope->create_nested_scope(false);
 
 	if (!!m_syn_parameters) {
@@ -1070,31 +1377,35 @@ void ast::FunctionExpression::bind(rt::BindContext* context, rt::BindScope* scop
 	m_scope_descriptor = sub_scope->create_scope_descriptor();
 }
 
-gc::Local<rt::Value> ast::FunctionExpression::evaluate_0(
+rt::ValueLoc ast::FunctionExpression::evaluate_0(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope,
-	gc::Local<rt::Value>& exception)
+	rt::ValueLoc& exception)
 {
 	return gc::create<rt::FunctionValue>(scope, self(this));
 }
 
-gc::Local<rt::Value> ast::FunctionExpression::invoke(
+void ast::FunctionExpression::compile(rt::CodeCompiler* compiler, rt::CodeReg dst) {
+	compiler->emit_function(dst, self(this));
+}
+
+rt::ValueLoc ast::FunctionExpression::invoke(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope,
-	const gc::Local<gc::Array<rt::Value>>& arguments,
-	gc::Local<rt::Value>& exception) const
+	const rt::ArgSpan& arguments,
+	rt::ValueLoc& exception) const
 {
 	gc::Local<rt::ExecScope> sub_scope =
-		scope->create_nested_scope(m_scope_descriptor, gc::Local<rt::Value>());
+		scope->create_nested_scope(m_scope_descriptor, rt::ValueLoc());
 
 	if (!!m_syn_parameters) {
 		ast_ptr<const ast::ast_node_list<ast::AstName>> parameters = m_syn_parameters->get_parameters();
-		std::size_t arg_cnt = arguments->length();
+		std::size_t arg_cnt = arguments.length();
 		if (arg_cnt != parameters->size()) throw RuntimeError("Wrong number of arguments");
 
 		for (std::size_t i = 0; i < arg_cnt; ++i) {
 			gc::Local<rt::NameDescriptor> name_desc = (*m_parameter_descriptors)[i];
-			gc::Local<rt::Value> v = arguments->get(i);
+			rt::ValueLoc v = arguments.get(i);
 			name_desc->set_initialize(sub_scope, v);
 		}
 	}
@@ -1116,7 +1427,6 @@ gc::Local<rt::Value> ast::FunctionExpression::invoke(
 
 void ast::ClassExpression::gc_enumerate_refs() {
 	TerminalExpression::gc_enumerate_refs();
-	gc_ref(m_syn_pos);
 	gc_ref(m_syn_body);
 	gc_ref(m_scope_descriptor);
 }
@@ -1136,7 +1446,7 @@ void ast::ClassExpression::syn_body(const ast_ptr<ClassBody>& body) {
 	m_syn_body = body;
 }
 
-gc::Local<ss::TextPos> ast::ClassExpression::get_pos() const {
+ss::TextPos ast::ClassExpression::get_pos() const {
 	return m_syn_pos;
 }
 
@@ -1145,6 +1455,7 @@ bool ast::ClassExpression::is_instantiation_allowed() const {
 }
 
 void ast::ClassExpression::bind(rt::BindContext* context, rt::BindScope* scope) {
+	m_source = SourceRef(m_syn_pos);
 	std::unique_ptr<rt::BindScope> sub_scope = scope->create_nested_scope(true);
 
 	m_syn_body->bind_constructor();
@@ -1164,19 +1475,23 @@ void ast::ClassExpression::bind(rt::BindContext* context, rt::BindScope* scope)
 	m_scope_descriptor = sub_scope->create_scope_descriptor();
 }
 
-gc::Local<rt::Value> ast::ClassExpression::evaluate_0(
+rt::ValueLoc ast::ClassExpression::evaluate_0(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope,
-	gc::Local<rt::Value>& exception)
+	rt::ValueLoc& exception)
 {
 	return gc::create<rt::ClassValue>(scope, self(this));
 }
 
-gc::Local<rt::Value> ast::ClassExpression::instantiate(
+void ast::ClassExpression::compile(rt::CodeCompiler* compiler, rt::CodeReg dst) {
+	compiler->emit_class(dst, self(this));
+}
+
+rt::ValueLoc ast::ClassExpression::instantiate(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope,
-	const gc::Local<gc::Array<rt::Value>>& arguments,
-	gc::Local<rt::Value>& exception) const
+	const rt::ArgSpan& arguments,
+	rt::ValueLoc& exception) const
 {
 	gc::Local<rt::ObjectValue> object = gc::create<rt::ObjectValue>(self(this), scope, m_scope_descriptor.local());
 	gc::Local<rt::ExecScope> object_scope = object->get_object_scope();
@@ -1189,7 +1504,7 @@ gc::Local<rt::Value> ast::ClassExpression::instantiate(
 	ast_ptr<FunctionDeclaration> constructor = m_syn_body->get_constructor();
 	if (!!constructor) {
 		const ast_ref<FunctionExpression>& con_expr = constructor->get_expression();
-		gc::Local<rt::Value> value = con_expr->invoke(context, object_scope, arguments, exception);
+		rt::ValueLoc value = con_expr->invoke(context, object_scope, arguments, exception);
 		if (!!exception) return context->get_undefined_value();
 		if (!value->is_void()) throw RuntimeError(constructor->get_pos(), "Constructor must return nothing");
 	}
@@ -1197,28 +1512,44 @@ gc::Local<rt::Value> ast::ClassExpression::instantiate(
 	return object;
 }
 
-gc::Local<rt::Value> ast::ClassExpression::get_object_member(
+rt::ValueLoc ast::ClassExpression::get_object_member(
 	const gc::Local<rt::ExecScope>& object_scope,
 	const gc::Local<rt::ExecScope>& access_scope,
-	const gc::Local<const ss::NameInfo>& name_info) const
+	const gc::Local<const ss::NameInfo>& name_info,
+	rt::MemberCache& cache) const
 {
-	const ast_ref<Declaration>& d = access_declaration(access_scope, name_info);
-	return d->get_name_descriptor()->get(object_scope);
+	return find_member_descriptor(access_scope, name_info, cache)->get(object_scope);
 }
 
 void ast::ClassExpression::set_object_member(
 	const gc::Local<rt::ExecScope>& object_scope,
 	const gc::Local<rt::ExecScope>& access_scope,
 	const gc::Local<const ss::NameInfo>& name_info,
-	const gc::Local<rt::Value>& value) const
+	const rt::ValueLoc& value,
+	rt::MemberCache& cache) const
 {
-	const ast_ref<Declaration>& d = access_declaration(access_scope, name_info);
-	const rt::NameDescriptor* desc = d->get_name_descriptor();
+	const rt::NameDescriptor* desc = find_member_descriptor(access_scope, name_info, cache);
 	if (rt::DeclarationType::VARIABLE != desc->get_declaration_type()) {
 		throw RuntimeError(
 			std::string("Cannot modify a non-variable member: ") + name_info->get_str()->get_std_string());
 	}
-	d->get_name_descriptor()->set_modify(object_scope, value);
+	desc->set_modify(object_scope, value);
+}
+
+const rt::NameDescriptor* ast::ClassExpression::find_member_descriptor(
+	const gc::Local<rt::ExecScope>& access_scope,
+	const gc::Local<const ss::NameInfo>& name_info,
+	rt::MemberCache& cache) const
+{
+	//The access scope of a particular member access site is always the same, so the result of the accessibility
+	//check can be cached together with the descriptor.
+	const gc::Object* cached = cache.get(this);
+	if (cached) return static_cast<const rt::NameDescriptor*>(cached);
+
+	const ast_ref<Declaration>& d = access_declaration(access_scope, name_info);
+	const gc::Ref<const rt::NameDescriptor>& desc = d->get_name_descriptor();
+	cache.put(self(this), desc.local());
+	return desc.get();
 }
 
 const ast::ast_ref<ast::Declaration>& ast::ClassExpression::access_declaration(
@@ -1254,14 +1585,18 @@ void ast::LiteralExpression::bind(rt::BindContext* context, rt::BindScope* scope
 	m_value = get_runtime_value(context);
 }
 
-gc::Local<rt::Value> ast::LiteralExpression::evaluate_0(
+rt::ValueLoc ast::LiteralExpression::evaluate_0(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope,
-	gc::Local<rt::Value>& exception)
+	rt::ValueLoc& exception)
 {
 	return m_value;
 }
 
+void ast::LiteralExpression::compile(rt::CodeCompiler* compiler, rt::CodeReg dst) {
+	compiler->emit_load_constant(dst, m_value);
+}
+
 //
 //IntegerLiteralExpression
 //
@@ -1275,11 +1610,11 @@ void ast::IntegerLiteralExpression::syn_value(const SynInteger& value) {
 	m_syn_value = value;
 }
 
-gc::Local<ss::TextPos> ast::IntegerLiteralExpression::get_pos() const {
+ss::TextPos ast::IntegerLiteralExpression::get_pos() const {
 	return m_syn_value->pos();
 }
 
-gc::Local<rt::Value> ast::IntegerLiteralExpression::get_runtime_value(rt::BindContext* context) const {
+rt::ValueLoc ast::IntegerLiteralExpression::get_runtime_value(rt::BindContext* context) const {
 	return context->get_value_factory()->get_integer_value(m_syn_value->value());
 }
 
@@ -1296,11 +1631,11 @@ void ast::FloatingPointLiteralExpression::syn_value(const SynFloat& value) {
 	m_syn_value = value;
 }
 
-gc::Local<ss::TextPos> ast::FloatingPointLiteralExpression::get_pos() const {
+ss::TextPos ast::FloatingPointLiteralExpression::get_pos() const {
 	return m_syn_value->pos();
 }
 
-gc::Local<rt::Value> ast::FloatingPointLiteralExpression::get_runtime_value(rt::BindContext* context) const {
+rt::ValueLoc ast::FloatingPointLiteralExpression::get_runtime_value(rt::BindContext* context) const {
 	return context->get_value_factory()->get_float_value(m_syn_value->value());
 }
 
@@ -1317,11 +1652,11 @@ void ast::StringLiteralExpression::syn_value(const SynString& value) {
 	m_syn_value = value;
 }
 
-gc::Local<ss::TextPos> ast::StringLiteralExpression::get_pos() const {
+ss::TextPos ast::StringLiteralExpression::get_pos() const {
 	return m_syn_value->pos();
 }
 
-gc::Local<rt::Value> ast::StringLiteralExpression::get_runtime_value(rt::BindContext* context) const {
+rt::ValueLoc ast::StringLiteralExpression::get_runtime_value(rt::BindContext* context) const {
 	//TODO Use cache for empty strings.
 	//TODO Use cache for constant string literals defined in the code.
 	return gc::create<rt::StringValue>(m_syn_value->value());
@@ -1333,7 +1668,6 @@ gc::Local<rt::Value> ast::StringLiteralExpression::get_runtime_value(rt::BindCon
 
 void ast::BooleanLiteralExpression::gc_enumerate_refs() {
 	Expression::gc_enumerate_refs();
-	gc_ref(m_syn_pos);
 }
 
 void ast::BooleanLiteralExpression::syn_pos(const SynPos& pos) {
@@ -1344,7 +1678,7 @@ void ast::BooleanLiteralExpression::syn_value(bool value) {
 	m_syn_value = value;
 }
 
-gc::Local<ss::TextPos> ast::BooleanLiteralExpression::get_pos() const {
+ss::TextPos ast::BooleanLiteralExpression::get_pos() const {
 	return m_syn_pos;
 }
 
@@ -1352,28 +1686,31 @@ void ast::BooleanLiteralExpression::bind(rt::BindContext* context, rt::BindScope
 	//Nothing.
 }
 
-gc::Local<rt::Value> ast::BooleanLiteralExpression::evaluate_0(
+rt::ValueLoc ast::BooleanLiteralExpression::evaluate_0(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope,
-	gc::Local<rt::Value>& exception)
+	rt::ValueLoc& exception)
 {
 	return context->get_value_factory()->get_boolean_value(m_syn_value);
 }
 
+void ast::BooleanLiteralExpression::compile(rt::CodeCompiler* compiler, rt::CodeReg dst) {
+	compiler->emit_load_constant(dst, rt::ValueLoc::from_word(rt::ValueWord::encode_boolean(m_syn_value)));
+}
+
 //
 //NullExpression
 //
 
 void ast::NullExpression::gc_enumerate_refs() {
 	Expression::gc_enumerate_refs();
-	gc_ref(m_syn_pos);
 }
 
 void ast::NullExpression::syn_pos(const SynPos& pos) {
 	m_syn_pos = pos;
 }
 
-gc::Local<ss::TextPos> ast::NullExpression::get_pos() const {
+ss::TextPos ast::NullExpression::get_pos() const {
 	return m_syn_pos;
 }
 
@@ -1381,21 +1718,24 @@ void ast::NullExpression::bind(rt::BindContext* context, rt::BindScope* scope) {
 	//Nothing.
 }
 
-gc::Local<rt::Value> ast::NullExpression::evaluate_0(
+rt::ValueLoc ast::NullExpression::evaluate_0(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope,
-	gc::Local<rt::Value>& exception)
+	rt::ValueLoc& exception)
 {
 	return context->get_value_factory()->get_null_value();
 }
 
+void ast::NullExpression::compile(rt::CodeCompiler* compiler, rt::CodeReg dst) {
+	compiler->emit_load_constant(dst, rt::ValueLoc::from_word(rt::ValueWord::NULL_VALUE));
+}
+
 //
 //TypeofExpression
 //
 
 void ast::TypeofExpression::gc_enumerate_refs() {
 	TerminalExpression::gc_enumerate_refs();
-	gc_ref(m_syn_pos);
 	gc_ref(m_syn_expression);
 }
 
@@ -1407,7 +1747,7 @@ void ast::TypeofExpression::syn_expression(const ast_ptr<Expression>& expression
 	m_syn_expression = expression;
 }
 
-gc::Local<ss::TextPos> ast::TypeofExpression::get_pos() const {
+ss::TextPos ast::TypeofExpression::get_pos() const {
 	return m_syn_pos;
 }
 
@@ -1415,14 +1755,19 @@ void ast::TypeofExpression::bind(rt::BindContext* context, rt::BindScope* scope)
 	m_syn_expression->bind(context, scope);
 }
 
-gc::Local<rt::Value> ast::TypeofExpression::evaluate_0(
+rt::ValueLoc ast::TypeofExpression::evaluate_0(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope,
-	gc::Local<rt::Value>& exception)
+	rt::ValueLoc& exception)
 {
-	gc::Local<rt::Value> value = m_syn_expression->evaluate(context, scope, exception);
+	rt::ValueLoc value = m_syn_expression->evaluate(context, scope, exception);
 	if (!!exception) return value;
 
 	StringLoc str = value->typeof(context);
 	return context->get_value_factory()->get_string_value(str);
 }
+
+void ast::TypeofExpression::compile(rt::CodeCompiler* compiler, rt::CodeReg dst) {
+	m_syn_expression->compile(compiler, dst);
+	compiler->emit_typeof(m_syn_pos, dst, dst);
+}
@@ -24,6 +24,7 @@
 #include "ast.h"
 #include "ast__dec.h"
 #include "ast_type.h"
+#include "bytecode__dec.h"
 #include "gc.h"
 #include "op.h"
 #include "scope.h"
@@ -43,8 +44,8 @@ namespace syn_script {
 			Expression(){}
 
 		public:
-			virtual gc::Local<TextPos> get_pos() const = 0;
-			virtual gc::Local<TextPos> get_start_pos() const;
+			virtual TextPos get_pos() const = 0;
+			virtual TextPos get_start_pos() const;
 
 			virtual bool is_assignment_allowed() const;
 			virtual bool is_invocation_allowed() const;
@@ -52,27 +53,50 @@ namespace syn_script {
 
 			virtual void bind(rt::BindContext* context, rt::BindScope* scope) = 0;
 
-			gc::Local<rt::Value> evaluate(
+			//Emits bytecode which evaluates the expression into the register. By default the expression is evaluated
+			//by the AST interpreter.
+			virtual void compile(rt::CodeCompiler* compiler, rt::CodeReg dst);
+
+			//Emits bytecode which modifies the lvalue. Called only if is_assignment_allowed() returns true.
+			virtual void compile_modify(rt::CodeCompiler* compiler, rt::CodeModifier& modifier, rt::CodeReg dst);
+
+			//Evaluates an invocation of the value of this expression. Overridden by expressions which can invoke
+			//the value without materializing it (a method of an object).
+			virtual rt::ValueLoc evaluate_invocation(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope,
-				gc::Local<rt::Value>& exception);
+				const TextPos& pos,
+				const ast_ref<const ast_node_list<Expression>>& arguments,
+				rt::ValueLoc& exception);
+
+			//Emits bytecode which invokes the value of this expression.
+			virtual void compile_invocation(
+				rt::CodeCompiler* compiler,
+				const TextPos& pos,
+				rt::CodeReg dst,
+				const ast_ref<const ast_node_list<Expression>>& arguments);
+
+			rt::ValueLoc evaluate(
+				const gc::Local<rt::ExecContext>& context,
+				const gc::Local<rt::ExecScope>& scope,
+				rt::ValueLoc& exception);
 
-			gc::Local<rt::Value> modify(
+			rt::ValueLoc modify(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope,
-				gc::Local<rt::Value>& exception,
+				rt::ValueLoc& exception,
 				rt::ValueModifier& modifier);
 
 		protected:
-			virtual gc::Local<rt::Value> evaluate_0(
+			virtual rt::ValueLoc evaluate_0(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope,
-				gc::Local<rt::Value>& exception) = 0;
+				rt::ValueLoc& exception) = 0;
 
-			virtual gc::Local<rt::Value> modify_0(
+			virtual rt::ValueLoc modify_0(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope,
-				gc::Local<rt::Value>& exception,
+				rt::ValueLoc& exception,
 				rt::ValueModifier& modifier);
 		};
 
@@ -83,7 +107,7 @@ namespace syn_script {
 		class ConditionalExpression : public Expression {
 			NONCOPYABLE(ConditionalExpression);
 
-			gc::Ref<TextPos> m_syn_pos;
+			TextPos m_syn_pos;
 			ast_ref<Expression> m_syn_condition;
 			ast_ref<Expression> m_syn_true_expression;
 			ast_ref<Expression> m_syn_false_expression;
@@ -102,19 +126,20 @@ namespace syn_script {
 			void syn_false_expression(const ast_ptr<Expression>&);
 
 		public:
-			gc::Local<TextPos> get_pos() const override;
-			gc::Local<TextPos> get_start_pos() const override;
+			TextPos get_pos() const override;
+			TextPos get_start_pos() const override;
 
 			bool is_invocation_allowed() const override;
 			bool is_instantiation_allowed() const override;
 
 			void bind(rt::BindContext* context, rt::BindScope* scope) override;
+			void compile(rt::CodeCompiler* compiler, rt::CodeReg dst) override;
 
 		protected:
-			gc::Local<rt::Value> evaluate_0(
+			rt::ValueLoc evaluate_0(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope,
-				gc::Local<rt::Value>& exception) override;
+				rt::ValueLoc& exception) override;
 		};
 
 		//
@@ -124,7 +149,7 @@ namespace syn_script {
 		class BinaryExpression : public Expression {
 			NONCOPYABLE(BinaryExpression);
 
-			gc::Ref<TextPos> m_syn_pos;
+			TextPos m_syn_pos;
 			AstBinOp m_syn_op;
 			ast_ref<Expression> m_syn_left;
 			ast_ref<Expression> m_syn_right;
@@ -148,8 +173,8 @@ namespace syn_script {
 			const ast_ref<Expression>& get_right() const;
 
 		public:
-			gc::Local<TextPos> get_pos() const override;
-			gc::Local<TextPos> get_start_pos() const override final;
+			TextPos get_pos() const override;
+			TextPos get_start_pos() const override final;
 
 			void bind(rt::BindContext* context, rt::BindScope* scope) override;
 		};
@@ -162,6 +187,7 @@ namespace syn_script {
 			NONCOPYABLE(AssignmentExpression);
 
 			class Modifier;
+			class CodeModifier;
 
 		public:
 			AssignmentExpression(){}
@@ -170,12 +196,13 @@ namespace syn_script {
 			bool is_instantiation_allowed() const override;
 
 			void bind(rt::BindContext* context, rt::BindScope* scope) override;
+			void compile(rt::CodeCompiler* compiler, rt::CodeReg dst) override;
 
 		protected:
-			gc::Local<rt::Value> evaluate_0(
+			rt::ValueLoc evaluate_0(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope,
-				gc::Local<rt::Value>& exception) override;
+				rt::ValueLoc& exception) override;
 		};
 
 		//
@@ -189,12 +216,13 @@ namespace syn_script {
 			RegularBinaryExpression(){}
 
 			void bind(rt::BindContext* context, rt::BindScope* scope) override;
+			void compile(rt::CodeCompiler* compiler, rt::CodeReg dst) override;
 
 		protected:
-			gc::Local<rt::Value> evaluate_0(
+			rt::ValueLoc evaluate_0(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope,
-				gc::Local<rt::Value>& exception) override;
+				rt::ValueLoc& exception) override;
 		};
 
 		//
@@ -204,7 +232,7 @@ namespace syn_script {
 		class UnaryExpression : public Expression {
 			NONCOPYABLE(UnaryExpression);
 
-			gc::Ref<TextPos> m_syn_pos;
+			TextPos m_syn_pos;
 			ast_ref<Expression> m_syn_expression;
 
 		protected:
@@ -217,7 +245,7 @@ namespace syn_script {
 			void syn_expression(const ast_ptr<Expression>&);
 
 		public:
-			gc::Local<TextPos> get_pos() const override;
+			TextPos get_pos() const override;
 			const ast_ref<Expression>& get_expression() const;
 
 			void bind(rt::BindContext* context, rt::BindScope* scope) override;
@@ -243,12 +271,13 @@ namespace syn_script {
 
 		public:
 			void bind(rt::BindContext* context, rt::BindScope* scope) override;
+			void compile(rt::CodeCompiler* compiler, rt::CodeReg dst) override;
 
 		protected:
-			gc::Local<rt::Value> evaluate_0(
+			rt::ValueLoc evaluate_0(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope,
-				gc::Local<rt::Value>& exception) override;
+				rt::ValueLoc& exception) override;
 		};
 
 		//
@@ -259,6 +288,7 @@ namespace syn_script {
 			NONCOPYABLE(IncrementDecrementExpression);
 
 			class Modifier;
+			class CodeModifier;
 
 			bool m_syn_increment;
 			bool m_syn_postfix;
@@ -272,13 +302,15 @@ namespace syn_script {
 			void syn_postfix(bool);
 
 		public:
-			gc::Local<TextPos> get_start_pos() const override;
+			TextPos get_start_pos() const override;
+
+			void compile(rt::CodeCompiler* compiler, rt::CodeReg dst) override;
 
 		protected:
-			gc::Local<rt::Value> evaluate_0(
+			rt::ValueLoc evaluate_0(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope,
-				gc::Local<rt::Value>& exception) override;
+				rt::ValueLoc& exception) override;
 		};
 
 		//
@@ -299,10 +331,12 @@ namespace syn_script {
 		class MemberExpression : public TerminalExpression {
 			NONCOPYABLE(MemberExpression);
 
-			gc::Ref<TextPos> m_syn_pos;
+			TextPos m_syn_pos;
 			ast_ref<Expression> m_syn_object;
 			gc::Ref<AstName> m_syn_name;
 
+			gc::Ref<rt::MemberCache> m_member_cache;
+
 		public:
 			MemberExpression(){}
 
@@ -316,25 +350,40 @@ namespace syn_script {
 			void syn_name(const SynName&);
 
 		public:
-			gc::Local<TextPos> get_pos() const override;
-			gc::Local<TextPos> get_start_pos() const override;
+			TextPos get_pos() const override;
+			TextPos get_start_pos() const override;
 
 			bool is_assignment_allowed() const override;
 			bool is_invocation_allowed() const override;
 			bool is_instantiation_allowed() const override;
 
 			void bind(rt::BindContext* context, rt::BindScope* scope) override;
+			void compile(rt::CodeCompiler* compiler, rt::CodeReg dst) override;
+			void compile_modify(rt::CodeCompiler* compiler, rt::CodeModifier& modifier, rt::CodeReg dst) override;
+
+			rt::ValueLoc evaluate_invocation(
+				const gc::Local<rt::ExecContext>& context,
+				const gc::Local<rt::ExecScope>& scope,
+				const TextPos& pos,
+				const ast_ref<const ast_node_list<Expression>>& arguments,
+				rt::ValueLoc& exception) override;
+
+			void compile_invocation(
+				rt::CodeCompiler* compiler,
+				const TextPos& pos,
+				rt::CodeReg dst,
+				const ast_ref<const ast_node_list<Expression>>& arguments) override;
 
 		protected:
-			gc::Local<rt::Value> evaluate_0(
+			rt::ValueLoc evaluate_0(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope,
-				gc::Local<rt::Value>& exception) override;
+				rt::ValueLoc& exception) override;
 
-			gc::Local<rt::Value> modify_0(
+			rt::ValueLoc modify_0(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope,
-				gc::Local<rt::Value>& exception,
+				rt::ValueLoc& exception,
 				rt::ValueModifier& modifier) override;
 		};
 
@@ -345,7 +394,7 @@ namespace syn_script {
 		class InvocationExpression : public TerminalExpression {
 			NONCOPYABLE(InvocationExpression);
 
-			gc::Ref<TextPos> m_syn_pos;
+			TextPos m_syn_pos;
 			ast_ref<Expression> m_syn_function;
 			ast_ref<const ast_node_list<Expression>> m_syn_arguments;
 
@@ -362,19 +411,20 @@ namespace syn_script {
 			void syn_arguments(const ast_ptr<const ast_node_list<Expression>>&);
 
 		public:
-			gc::Local<TextPos> get_pos() const override;
-			gc::Local<TextPos> get_start_pos() const override;
+			TextPos get_pos() const override;
+			TextPos get_start_pos() const override;
 
 			bool is_invocation_allowed() const override;
 			bool is_instantiation_allowed() const override;
 
 			void bind(rt::BindContext* context, rt::BindScope* scope) override;
+			void compile(rt::CodeCompiler* compiler, rt::CodeReg dst) override;
 
 		protected:
-			gc::Local<rt::Value> evaluate_0(
+			rt::ValueLoc evaluate_0(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope,
-				gc::Local<rt::Value>& exception) override;
+				rt::ValueLoc& exception) override;
 		};
 
 		//
@@ -384,7 +434,7 @@ namespace syn_script {
 		class NewObjectExpression : public TerminalExpression {
 			NONCOPYABLE(NewObjectExpression);
 
-			gc::Ref<TextPos> m_syn_pos;
+			TextPos m_syn_pos;
 			ast_ref<Expression> m_syn_type_expr;
 			ast_ref<const ast_node_list<Expression>> m_syn_arguments;
 
@@ -401,15 +451,16 @@ namespace syn_script {
 			void syn_arguments(const ast_ptr<const ast_node_list<Expression>>&);
 
 		public:
-			gc::Local<TextPos> get_pos() const override;
+			TextPos get_pos() const override;
 
 			void bind(rt::BindContext* context, rt::BindScope* scope) override;
+			void compile(rt::CodeCompiler* compiler, rt::CodeReg dst) override;
 
 		protected:
-			gc::Local<rt::Value> evaluate_0(
+			rt::ValueLoc evaluate_0(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope,
-				gc::Local<rt::Value>& exception) override;
+				rt::ValueLoc& exception) override;
 		};
 
 		//
@@ -419,7 +470,7 @@ namespace syn_script {
 		class NewArrayExpression : public TerminalExpression {
 			NONCOPYABLE(NewArrayExpression);
 
-			gc::Ref<TextPos> m_syn_pos;
+			TextPos m_syn_pos;
 			ast_ref<Expression> m_syn_length;
 
 		public:
@@ -434,15 +485,16 @@ namespace syn_script {
 			void syn_length(const ast_ptr<Expression>&);
 
 		public:
-			gc::Local<TextPos> get_pos() const override;
+			TextPos get_pos() const override;
 
 			void bind(rt::BindContext* context, rt::BindScope* scope) override;
+			void compile(rt::CodeCompiler* compiler, rt::CodeReg dst) override;
 
 		protected:
-			gc::Local<rt::Value> evaluate_0(
+			rt::ValueLoc evaluate_0(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope,
-				gc::Local<rt::Value>& exception) override;
+				rt::ValueLoc& exception) override;
 		};
 
 		//
@@ -452,7 +504,7 @@ namespace syn_script {
 		class ArrayExpression : public TerminalExpression {
 			NONCOPYABLE(ArrayExpression);
 
-			gc::Ref<TextPos> m_syn_pos;
+			TextPos m_syn_pos;
 			ast_ref<const ast_node_list<Expression>> m_syn_expressions;
 
 		public:
@@ -467,15 +519,16 @@ namespace syn_script {
 			void syn_expressions(const ast_ptr<const ast_node_list<Expression>>&);
 
 		public:
-			gc::Local<TextPos> get_pos() const override;
+			TextPos get_pos() const override;
 
 			void bind(rt::BindContext* context, rt::BindScope* scope) override;
+			void compile(rt::CodeCompiler* compiler, rt::CodeReg dst) override;
 
 		protected:
-			gc::Local<rt::Value> evaluate_0(
+			rt::ValueLoc evaluate_0(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope,
-				gc::Local<rt::Value>& exception) override;
+				rt::ValueLoc& exception) override;
 		};
 
 		//
@@ -485,7 +538,7 @@ namespace syn_script {
 		class SubscriptExpression : public TerminalExpression {
 			NONCOPYABLE(SubscriptExpression);
 
-			gc::Ref<TextPos> m_syn_pos;
+			TextPos m_syn_pos;
 			ast_ref<Expression> m_syn_array;
 			ast_ref<Expression> m_syn_index;
 
@@ -502,32 +555,34 @@ namespace syn_script {
 			void syn_index(const ast_ptr<Expression>&);
 
 		public:
-			gc::Local<TextPos> get_pos() const override;
-			gc::Local<TextPos> get_start_pos() const override;
+			TextPos get_pos() const override;
+			TextPos get_start_pos() const override;
 
 			bool is_assignment_allowed() const override;
 			bool is_invocation_allowed() const override;
 			bool is_instantiation_allowed() const override;
 
 			void bind(rt::BindContext* context, rt::BindScope* scope) override;
+			void compile(rt::CodeCompiler* compiler, rt::CodeReg dst) override;
+			void compile_modify(rt::CodeCompiler* compiler, rt::CodeModifier& modifier, rt::CodeReg dst) override;
 
 		protected:
-			gc::Local<rt::Value> evaluate_0(
+			rt::ValueLoc evaluate_0(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope,
-				gc::Local<rt::Value>& exception) override;
+				rt::ValueLoc& exception) override;
 
-			gc::Local<rt::Value> modify_0(
+			rt::ValueLoc modify_0(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope,
-				gc::Local<rt::Value>& exception,
+				rt::ValueLoc& exception,
 				rt::ValueModifier& modifier) override;
 
 		private:
 			std::size_t evaluate_index(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope,
-				gc::Local<rt::Value>& exception);
+				rt::ValueLoc& exception);
 		};
 
 		//
@@ -553,24 +608,26 @@ namespace syn_script {
 			void syn_name(const SynName&);
 
 		public:
-			gc::Local<TextPos> get_pos() const override;
+			TextPos get_pos() const override;
 
 			bool is_assignment_allowed() const override;
 			bool is_invocation_allowed() const override;
 			bool is_instantiation_allowed() const override;
 
 			void bind(rt::BindContext* context, rt::BindScope* scope) override;
+			void compile(rt::CodeCompiler* compiler, rt::CodeReg dst) override;
+			void compile_modify(rt::CodeCompiler* compiler, rt::CodeModifier& modifier, rt::CodeReg dst) override;
 
 		protected:
-			gc::Local<rt::Value> evaluate_0(
+			rt::ValueLoc evaluate_0(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope,
-				gc::Local<rt::Value>& exception) override;
+				rt::ValueLoc& exception) override;
 		
-			gc::Local<rt::Value> modify_0(
+			rt::ValueLoc modify_0(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope,
-				gc::Local<rt::Value>& exception,
+				rt::ValueLoc& exception,
 				rt::ValueModifier& modifier) override;
 		};
 
@@ -581,7 +638,7 @@ namespace syn_script {
 		class ThisExpression : public TerminalExpression {
 			NONCOPYABLE(ThisExpression);
 
-			gc::Ref<TextPos> m_syn_pos;
+			TextPos m_syn_pos;
 
 			std::size_t m_scope_ofs;
 
@@ -596,15 +653,16 @@ namespace syn_script {
 			void syn_pos(const SynPos&);
 
 		public:
-			gc::Local<TextPos> get_pos() const override;
+			TextPos get_pos() const override;
 
 			void bind(rt::BindContext* context, rt::BindScope* scope) override;
+			void compile(rt::CodeCompiler* compiler, rt::CodeReg dst) override;
 
 		protected:
-			gc::Local<rt::Value> evaluate_0(
+			rt::ValueLoc evaluate_0(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope,
-				gc::Local<rt::Value>& exception) override;
+				rt::ValueLoc& exception) override;
 		};
 
 		//
@@ -620,6 +678,9 @@ namespace syn_script {
 			gc::Ref<gc::Array<rt::NameDescriptor>> m_parameter_descriptors;
 			gc::Ref<rt::ScopeDescriptor> m_scope_descriptor;
 
+			//Function values may outlive the script, so they keep its source registered.
+			SourceRef m_source;
+
 		public:
 			FunctionExpression(){}
 
@@ -636,24 +697,25 @@ namespace syn_script {
 			void syn_body(const ast_ptr<FunctionBody>&);
 
 		public:
-			gc::Local<TextPos> get_pos() const override;
-			gc::Local<TextPos> get_start_pos() const override;
+			TextPos get_pos() const override;
+			TextPos get_start_pos() const override;
 
 			bool is_invocation_allowed() const override;
 
 			void bind(rt::BindContext* context, rt::BindScope* scope) override;
+			void compile(rt::CodeCompiler* compiler, rt::CodeReg dst) override;
 
-			gc::Local<rt::Value> invoke(
+			rt::ValueLoc invoke(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope,
-				const gc::Local<gc::Array<rt::Value>>& arguments,
-				gc::Local<rt::Value>& exception) const;
+				const rt::ArgSpan& arguments,
+				rt::ValueLoc& exception) const;
 
 		protected:
-			gc::Local<rt::Value> evaluate_0(
+			rt::ValueLoc evaluate_0(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope,
-				gc::Local<rt::Value>& exception) override;
+				rt::ValueLoc& exception) override;
 		};
 
 		//
@@ -663,11 +725,14 @@ namespace syn_script {
 		class ClassExpression : public TerminalExpression {
 			NONCOPYABLE(ClassExpression);
 
-			gc::Ref<TextPos> m_syn_pos;
+			TextPos m_syn_pos;
 			ast_ref<ClassBody> m_syn_body;
 
 			gc::Ref<rt::ScopeDescriptor> m_scope_descriptor;
 
+			//Class values may outlive the script, so they keep its source registered.
+			SourceRef m_source;
+
 		public:
 			ClassExpression(){}
 
@@ -684,36 +749,44 @@ namespace syn_script {
 			void syn_body(const ast_ptr<ClassBody>&);
 
 		public:
-			gc::Local<TextPos> get_pos() const override;
+			TextPos get_pos() const override;
 
 			bool is_instantiation_allowed() const override;
 
 			void bind(rt::BindContext* context, rt::BindScope* scope) override;
+			void compile(rt::CodeCompiler* compiler, rt::CodeReg dst) override;
 
-			gc::Local<rt::Value> instantiate(
+			rt::ValueLoc instantiate(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope,
-				const gc::Local<gc::Array<rt::Value>>& arguments,
-				gc::Local<rt::Value>& exception) const;
+				const rt::ArgSpan& arguments,
+				rt::ValueLoc& exception) const;
 
-			gc::Local<rt::Value> get_object_member(
+			rt::ValueLoc get_object_member(
 				const gc::Local<rt::ExecScope>& object_scope,
 				const gc::Local<rt::ExecScope>& access_scope,
-				const gc::Local<const NameInfo>& name_info) const;
+				const gc::Local<const NameInfo>& name_info,
+				rt::MemberCache& cache) const;
 
 			void set_object_member(
 				const gc::Local<rt::ExecScope>& object_scope,
 				const gc::Local<rt::ExecScope>& access_scope,
 				const gc::Local<const NameInfo>& name_info,
-				const gc::Local<rt::Value>& value) const;
+				const rt::ValueLoc& value,
+				rt::MemberCache& cache) const;
 
 		protected:
-			gc::Local<rt::Value> evaluate_0(
+			rt::ValueLoc evaluate_0(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope,
-				gc::Local<rt::Value>& exception) override;
+				rt::ValueLoc& exception) override;
 
 		private:
+			const rt::NameDescriptor* find_member_descriptor(
+				const gc::Local<rt::ExecScope>& access_scope,
+				const gc::Local<const NameInfo>& name_info,
+				rt::MemberCache& cache) const;
+
 			const ast_ref<Declaration>& access_declaration(
 				const gc::Local<rt::ExecScope>& access_scope,
 				const gc::Local<const NameInfo>& name_info) const;
@@ -730,7 +803,7 @@ namespace syn_script {
 			NONCOPYABLE(LiteralExpression);
 
 		private:
-			gc::Ref<rt::Value> m_value;
+			rt::ValueRef m_value;
 
 		protected:
 			LiteralExpression(){}
@@ -741,14 +814,15 @@ namespace syn_script {
 
 		public:
 			void bind(rt::BindContext* context, rt::BindScope* scope) override final;
+			void compile(rt::CodeCompiler* compiler, rt::CodeReg dst) override final;
 
 		protected:
-			gc::Local<rt::Value> evaluate_0(
+			rt::ValueLoc evaluate_0(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope,
-				gc::Local<rt::Value>& exception) override final;
+				rt::ValueLoc& exception) override final;
 			
-			virtual gc::Local<rt::Value> get_runtime_value(rt::BindContext* context) const = 0;
+			virtual rt::ValueLoc get_runtime_value(rt::BindContext* context) const = 0;
 		};
 
 		//
@@ -769,10 +843,10 @@ namespace syn_script {
 			void syn_value(const SynInteger&);
 
 		public:
-			gc::Local<TextPos> get_pos() const override;
+			TextPos get_pos() const override;
 
 		protected:
-			gc::Local<rt::Value> get_runtime_value(rt::BindContext* context) const override;
+			rt::ValueLoc get_runtime_value(rt::BindContext* context) const override;
 		};
 
 		//
@@ -793,10 +867,10 @@ namespace syn_script {
 			void syn_value(const SynFloat&);
 
 		public:
-			gc::Local<TextPos> get_pos() const override;
+			TextPos get_pos() const override;
 
 		protected:
-			gc::Local<rt::Value> get_runtime_value(rt::BindContext* context) const override;
+			rt::ValueLoc get_runtime_value(rt::BindContext* context) const override;
 		};
 
 		//
@@ -819,10 +893,10 @@ namespace syn_script {
 			void syn_value(const SynString&);
 
 		public:
-			gc::Local<TextPos> get_pos() const override;
+			TextPos get_pos() const override;
 
 		protected:
-			gc::Local<rt::Value> get_runtime_value(rt::BindContext* context) const override;
+			rt::ValueLoc get_runtime_value(rt::BindContext* context) const override;
 		};
 
 		//
@@ -832,7 +906,7 @@ namespace syn_script {
 		class BooleanLiteralExpression : public Expression {
 			NONCOPYABLE(BooleanLiteralExpression);
 
-			gc::Ref<TextPos> m_syn_pos;
+			TextPos m_syn_pos;
 			bool m_syn_value;
 
 		public:
@@ -847,15 +921,16 @@ namespace syn_script {
 			void syn_value(bool);
 
 		public:
-			gc::Local<TextPos> get_pos() const override;
+			TextPos get_pos() const override;
 
 			void bind(rt::BindContext* context, rt::BindScope* scope) override;
+			void compile(rt::CodeCompiler* compiler, rt::CodeReg dst) override;
 
 		protected:
-			gc::Local<rt::Value> evaluate_0(
+			rt::ValueLoc evaluate_0(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope,
-				gc::Local<rt::Value>& exception) override;
+				rt::ValueLoc& exception) override;
 		};
 
 		//
@@ -865,7 +940,7 @@ namespace syn_script {
 		class NullExpression : public Expression {
 			NONCOPYABLE(NullExpression);
 
-			gc::Ref<TextPos> m_syn_pos;
+			TextPos m_syn_pos;
 
 		public:
 			NullExpression(){}
@@ -878,15 +953,16 @@ namespace syn_script {
 			void syn_pos(const SynPos&);
 
 		public:
-			gc::Local<TextPos> get_pos() const override;
+			TextPos get_pos() const override;
 
 			void bind(rt::BindContext* context, rt::BindScope* scope) override;
+			void compile(rt::CodeCompiler* compiler, rt::CodeReg dst) override;
 
 		protected:
-			gc::Local<rt::Value> evaluate_0(
+			rt::ValueLoc evaluate_0(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope,
-				gc::Local<rt::Value>& exception) override;
+				rt::ValueLoc& exception) override;
 		};
 
 		//
@@ -896,7 +972,7 @@ namespace syn_script {
 		class TypeofExpression : public TerminalExpression {
 			NONCOPYABLE(TypeofExpression);
 
-			gc::Ref<TextPos> m_syn_pos;
+			TextPos m_syn_pos;
 			ast_ref<Expression> m_syn_expression;
 
 		public:
@@ -911,15 +987,16 @@ namespace syn_script {
 			void syn_expression(const ast_ptr<Expression>&);
 
 		public:
-			gc::Local<TextPos> get_pos() const override;
+			TextPos get_pos() const override;
 
 			void bind(rt::BindContext* context, rt::BindScope* scope) override;
+			void compile(rt::CodeCompiler* compiler, rt::CodeReg dst) override;
 
 		protected:
-			gc::Local<rt::Value> evaluate_0(
+			rt::ValueLoc evaluate_0(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope,
-				gc::Local<rt::Value>& exception) override;
+				rt::ValueLoc& exception) override;
 		};
 
 	}
@@ -19,6 +19,7 @@
 #include "api.h"
 #include "ast.h"
 #include "ast_combined.h"
+#include "bytecode.h"
 #include "gc.h"
 #include "name.h"
 #include "scope.h"
@@ -44,6 +45,10 @@ void ast::Script::syn_block(const ast_ptr<Block>& block) {
 	m_syn_block = block;
 }
 
+void ast::Script::set_source(const ss::SourceRef& source) {
+	m_source = source;
+}
+
 gc::Local<ast::Block> ast::Script::get_block() const {
 	return m_syn_block;
 }
@@ -57,6 +62,7 @@ void ast::Block::gc_enumerate_refs() {
 	gc_ref(m_syn_statements);
 	gc_ref(m_declarations);
 	gc_ref(m_statements);
+	gc_ref(m_code);
 }
 
 void ast::Block::syn_statements(const ast_ptr<const ast_node_list<Statement>>& statements) {
@@ -78,11 +84,29 @@ void ast::Block::bind_define(rt::BindContext* context, rt::BindScope* scope) {
 	for (const ast_ref<Statement>& s : *m_statements) s->bind(context, scope);
 }
 
+void ast::Block::compile() {
+	if (!!m_code) return;
+
+	rt::CodeCompiler compiler;
+	compile_inline(&compiler);
+	m_code = compiler.create_code_block();
+}
+
+void ast::Block::compile_inline(rt::CodeCompiler* compiler) {
+	for (const ast_ref<Declaration>& d : *m_declarations) d->compile_define(compiler);
+	for (const ast_ref<Statement>& s : *m_statements) s->compile(compiler);
+}
+
 rt::StatementResult ast::Block::execute(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope)
 {
-	gc::Local<rt::Value> exception;
+	if (rt::ExecutionMode::BYTECODE == context->get_bind_context()->get_execution_mode()) {
+		compile();
+		return m_code->execute(context, scope);
+	}
+
+	rt::ValueLoc exception;
 	for (const ast_ref<Declaration>& d : *m_declarations) {
 		d->exec_define(context, scope, exception);
 		if (!!exception) return rt::StatementResult::exception(exception);
@@ -25,6 +25,7 @@
 #include "ast.h"
 #include "ast__dec.h"
 #include "ast_type.h"
+#include "bytecode__dec.h"
 #include "name__dec.h"
 #include "scope.h"
 #include "sysclass__dec.h"
@@ -41,6 +42,8 @@ namespace syn_script {
 
 			ast_ref<Block> m_syn_block;
 
+			SourceRef m_source;
+
 		public:
 			Script(){}
 
@@ -52,6 +55,7 @@ namespace syn_script {
 			void syn_block(const ast_ptr<Block>&);
 
 		public:
+			void set_source(const SourceRef& source);
 			gc::Local<Block> get_block() const;
 		};
 
@@ -67,6 +71,8 @@ namespace syn_script {
 			ast_ref<const ast_node_list<Declaration>> m_declarations;
 			ast_ref<const ast_node_list<Statement>> m_statements;
 
+			gc::Ref<rt::CodeBlock> m_code;
+
 		public:
 			Block(){}
 
@@ -81,6 +87,13 @@ namespace syn_script {
 			void bind(rt::BindContext* context, rt::BindScope* scope);
 			void bind_declare(rt::BindContext* context, rt::BindScope* scope);
 			void bind_define(rt::BindContext* context, rt::BindScope* scope);
+
+			//Compiles the block into bytecode, if not compiled yet.
+			void compile();
+
+			//Emits the code of the block into an enclosing unit.
+			void compile_inline(rt::CodeCompiler* compiler);
+
 			rt::StatementResult execute(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope);
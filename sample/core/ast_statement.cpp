@@ -19,6 +19,7 @@
 #include "api_basic.h"
 #include "ast.h"
 #include "ast_combined.h"
+#include "bytecode.h"
 #include "gc.h"
 #include "scope.h"
 #include "stacktrace.h"
@@ -45,6 +46,10 @@ rt::StatementResult ast::Statement::execute(
 	}
 }
 
+void ast::Statement::compile(rt::CodeCompiler* compiler) {
+	compiler->emit_execute(self(this));
+}
+
 //
 //DeclarationStatement
 //
@@ -58,7 +63,7 @@ void ast::DeclarationStatement::syn_declaration(const ast_ptr<Declaration>& decl
 	m_syn_declaration = declaration;
 }
 
-gc::Local<ss::TextPos> ast::DeclarationStatement::get_pos() const {
+ss::TextPos ast::DeclarationStatement::get_pos() const {
 	return m_syn_declaration->get_pos();
 }
 
@@ -75,13 +80,17 @@ rt::StatementResult ast::DeclarationStatement::execute_0(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope)
 {
-	gc::Local<rt::Value> exception;
+	rt::ValueLoc exception;
 	m_syn_declaration->exec_define(context, scope, exception);
 	if (!!exception) return rt::StatementResult::exception(exception);
 
 	return rt::StatementResult::none();
 }
 
+void ast::DeclarationStatement::compile(rt::CodeCompiler* compiler) {
+	m_syn_declaration->compile_define(compiler);
+}
+
 //
 //ExecutionStatement
 //
@@ -96,14 +105,13 @@ ast::ast_ptr<ast::Declaration> ast::ExecutionStatement::get_declaration() const
 
 void ast::EmptyStatement::gc_enumerate_refs() {
 	ExecutionStatement::gc_enumerate_refs();
-	gc_ref(m_syn_pos);
 }
 
 void ast::EmptyStatement::syn_pos(const SynPos& pos) {
 	m_syn_pos = pos;
 }
 
-gc::Local<ss::TextPos> ast::EmptyStatement::get_pos() const {
+ss::TextPos ast::EmptyStatement::get_pos() const {
 	return m_syn_pos;
 }
 
@@ -118,6 +126,10 @@ rt::StatementResult ast::EmptyStatement::execute_0(
 	return rt::StatementResult::none();
 }
 
+void ast::EmptyStatement::compile(rt::CodeCompiler* compiler) {
+	//Nothing.
+}
+
 //
 //ExpressionStatement
 //
@@ -131,7 +143,7 @@ void ast::ExpressionStatement::syn_expression(const ast_ptr<Expression>& express
 	m_syn_expression = expression;
 }
 
-gc::Local<ss::TextPos> ast::ExpressionStatement::get_pos() const {
+ss::TextPos ast::ExpressionStatement::get_pos() const {
 	return m_syn_expression->get_start_pos();
 }
 
@@ -143,19 +155,24 @@ rt::StatementResult ast::ExpressionStatement::execute_0(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope)
 {
-	gc::Local<rt::Value> exception;
+	rt::ValueLoc exception;
 	m_syn_expression->evaluate(context, scope, exception);
 	if (!!exception) return rt::StatementResult::exception(exception);
 	return rt::StatementResult::none();
 }
 
+void ast::ExpressionStatement::compile(rt::CodeCompiler* compiler) {
+	rt::CodeRegisterGuard guard(compiler);
+	rt::CodeReg value = compiler->allocate_register();
+	m_syn_expression->compile(compiler, value);
+}
+
 //
 //IfStatement
 //
 
 void ast::IfStatement::gc_enumerate_refs() {
 	ExecutionStatement::gc_enumerate_refs();
-	gc_ref(m_syn_pos);
 	gc_ref(m_syn_expression);
 	gc_ref(m_syn_true_statement);
 	gc_ref(m_syn_false_statement);
@@ -177,7 +194,7 @@ void ast::IfStatement::syn_false_statement(const ast_ptr<Statement>& false_state
 	m_syn_false_statement = false_statement;
 }
 
-gc::Local<ss::TextPos> ast::IfStatement::get_pos() const {
+ss::TextPos ast::IfStatement::get_pos() const {
 	return m_syn_pos;
 }
 
@@ -191,8 +208,8 @@ rt::StatementResult ast::IfStatement::execute_0(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope)
 {
-	gc::Local<rt::Value> exception;
-	gc::Local<rt::Value> value = m_syn_expression->evaluate(context, scope, exception);
+	rt::ValueLoc exception;
+	rt::ValueLoc value = m_syn_expression->evaluate(context, scope, exception);
 	if (!!exception) return rt::StatementResult::exception(exception);
 
 	if (value->get_boolean()) {
@@ -204,13 +221,35 @@ rt::StatementResult ast::IfStatement::execute_0(
 	}
 }
 
+void ast::IfStatement::compile(rt::CodeCompiler* compiler) {
+	rt::CodeLabel false_label;
+
+	{
+		rt::CodeRegisterGuard guard(compiler);
+		rt::CodeReg condition = compiler->allocate_register();
+		m_syn_expression->compile(compiler, condition);
+		compiler->emit_jump_if_false(m_syn_pos, condition, false_label);
+	}
+
+	m_syn_true_statement->compile(compiler);
+
+	if (!!m_syn_false_statement) {
+		rt::CodeLabel end_label;
+		compiler->emit_jump(end_label);
+		compiler->bind_label(false_label);
+		m_syn_false_statement->compile(compiler);
+		compiler->bind_label(end_label);
+	} else {
+		compiler->bind_label(false_label);
+	}
+}
+
 //
 //LoopStatement
 //
 
 void ast::LoopStatement::gc_enumerate_refs() {
 	ExecutionStatement::gc_enumerate_refs();
-	gc_ref(m_syn_pos);
 	gc_ref(m_syn_expression);
 	gc_ref(m_syn_statement);
 	gc_ref(m_scope_descriptor);
@@ -228,7 +267,7 @@ void ast::LoopStatement::syn_statement(const ast_ptr<Statement>& statement) {
 	m_syn_statement = statement;
 }
 
-gc::Local<ss::TextPos> ast::LoopStatement::get_pos() const {
+ss::TextPos ast::LoopStatement::get_pos() const {
 	return m_syn_pos;
 }
 
@@ -240,6 +279,10 @@ const ast::ast_ref<ast::Statement>& ast::LoopStatement::get_statement() const {
 	return m_syn_statement;
 }
 
+const gc::Ref<rt::ScopeDescriptor>& ast::LoopStatement::get_scope_descriptor() const {
+	return m_scope_descriptor;
+}
+
 void ast::LoopStatement::bind(rt::BindContext* context, rt::BindScope* scope) {
 	std::unique_ptr<rt::BindScope> sub_scope = scope->create_nested_block(true);
 
@@ -254,7 +297,7 @@ rt::StatementResult ast::LoopStatement::execute_0(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope)
 {
-	gc::Local<rt::ExecScope> sub_scope = scope->create_nested_scope(m_scope_descriptor, gc::Local<rt::Value>());
+	gc::Local<rt::ExecScope> sub_scope = scope->enter_block(m_scope_descriptor);
 	return exec_loop(context, sub_scope);
 }
 
@@ -270,14 +313,14 @@ rt::StatementResult ast::RegularLoopStatement::exec_loop(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope)
 {
-	gc::Local<rt::Value> exception;
+	rt::ValueLoc exception;
 
 	exec_loop_init(context, scope, exception);
 	if (!!exception) return rt::StatementResult::exception(exception);
 
 	for (;;) {
 		if (!!get_expression()) {
-			gc::Local<rt::Value> value = get_expression()->evaluate(context, scope, exception);
+			rt::ValueLoc value = get_expression()->evaluate(context, scope, exception);
 			if (!!exception) return rt::StatementResult::exception(exception);
 			if (!value->get_boolean()) break;
 		}
@@ -294,15 +337,45 @@ rt::StatementResult ast::RegularLoopStatement::exec_loop(
 
 		exec_loop_update(context, scope, exception);
 		if (!!exception) return rt::StatementResult::exception(exception);
+
+		gc::synchronize();
 	}
 
 	return rt::StatementResult::none();
 }
 
+void ast::RegularLoopStatement::compile(rt::CodeCompiler* compiler) {
+	rt::CodeLabel condition_label;
+	rt::CodeLabel continue_label;
+	rt::CodeLabel break_label;
+
+	compiler->emit_enter_scope(get_scope_descriptor());
+	compile_loop_init(compiler);
+
+	compiler->bind_label(condition_label);
+	if (!!get_expression()) {
+		rt::CodeRegisterGuard guard(compiler);
+		rt::CodeReg condition = compiler->allocate_register();
+		get_expression()->compile(compiler, condition);
+		compiler->emit_jump_if_false(get_pos(), condition, break_label);
+	}
+
+	compiler->begin_loop(break_label, continue_label);
+	get_statement()->compile(compiler);
+	compiler->end_loop();
+
+	compiler->bind_label(continue_label);
+	compile_loop_update(compiler);
+	compiler->emit_loop(condition_label);
+
+	compiler->bind_label(break_label);
+	compiler->emit_leave_scope(get_scope_descriptor());
+}
+
 void ast::RegularLoopStatement::exec_loop_init(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope,
-	gc::Local<rt::Value>& exception)
+	rt::ValueLoc& exception)
 {
 	//Nothing.
 }
@@ -310,11 +383,19 @@ void ast::RegularLoopStatement::exec_loop_init(
 void ast::RegularLoopStatement::exec_loop_update(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope,
-	gc::Local<rt::Value>& exception)
+	rt::ValueLoc& exception)
 {
 	//Nothing.
 }
 
+void ast::RegularLoopStatement::compile_loop_init(rt::CodeCompiler* compiler) {
+	//Nothing.
+}
+
+void ast::RegularLoopStatement::compile_loop_update(rt::CodeCompiler* compiler) {
+	//Nothing.
+}
+
 //
 //RegularForStatement
 //
@@ -341,7 +422,7 @@ void ast::RegularForStatement::bind_loop(rt::BindContext* context, rt::BindScope
 void ast::RegularForStatement::exec_loop_init(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope,
-	gc::Local<rt::Value>& exception)
+	rt::ValueLoc& exception)
 {
 	if (!!m_syn_init) m_syn_init->execute(context, scope, exception);
 }
@@ -349,7 +430,7 @@ void ast::RegularForStatement::exec_loop_init(
 void ast::RegularForStatement::exec_loop_update(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope,
-	gc::Local<rt::Value>& exception)
+	rt::ValueLoc& exception)
 {
 	for (const ast_ref<Expression>& expr : *m_syn_update) {
 		expr->evaluate(context, scope, exception);
@@ -357,6 +438,16 @@ void ast::RegularForStatement::exec_loop_update(
 	}
 }
 
+void ast::RegularForStatement::compile_loop_init(rt::CodeCompiler* compiler) {
+	if (!!m_syn_init) m_syn_init->compile(compiler);
+}
+
+void ast::RegularForStatement::compile_loop_update(rt::CodeCompiler* compiler) {
+	rt::CodeRegisterGuard guard(compiler);
+	rt::CodeReg value = compiler->allocate_register();
+	for (const ast_ref<Expression>& expr : *m_syn_update) expr->compile(compiler, value);
+}
+
 //
 //ForEachValueIterator
 //
@@ -378,7 +469,8 @@ public:
 		m_result(rt::StatementResultType::NONE)
 	{}
 
-	bool iterate(const gc::Local<rt::Value>& value) override {
+	bool iterate(const rt::ValueLoc& value) override {
+		gc::synchronize();
 		m_stmt->m_name_descriptor->set_modify(m_scope, value);
 		m_result = m_stmt->get_statement()->execute(m_context, m_scope);
 		return rt::StatementResultType::NONE == m_result.get_type()
@@ -416,8 +508,8 @@ rt::StatementResult ast::ForEachStatement::exec_loop(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope)
 {
-	gc::Local<rt::Value> exception;
-	gc::Local<rt::Value> value = get_expression()->evaluate(context, scope, exception);
+	rt::ValueLoc exception;
+	rt::ValueLoc value = get_expression()->evaluate(context, scope, exception);
 	if (!!exception) return rt::StatementResult::exception(exception);
 	assert(!!value);
 
@@ -450,7 +542,7 @@ void ast::VariableForInit::bind(rt::BindContext* context, rt::BindScope* scope)
 void ast::VariableForInit::execute(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope,
-	gc::Local<rt::Value>& exception)
+	rt::ValueLoc& exception)
 {
 	for (const ast_ref<ForVariableDeclaration>& var : *m_syn_variables) {
 		var->execute(context, scope, exception);
@@ -458,6 +550,10 @@ void ast::VariableForInit::execute(
 	}
 }
 
+void ast::VariableForInit::compile(rt::CodeCompiler* compiler) {
+	for (const ast_ref<ForVariableDeclaration>& var : *m_syn_variables) var->compile(compiler);
+}
+
 //
 //ForVariableDeclaration
 //
@@ -485,13 +581,20 @@ void ast::ForVariableDeclaration::bind(rt::BindContext* context, rt::BindScope*
 void ast::ForVariableDeclaration::execute(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope,
-	gc::Local<rt::Value>& exception)
+	rt::ValueLoc& exception)
 {
-	gc::Local<rt::Value> value = m_syn_expression->evaluate(context, scope, exception);
+	rt::ValueLoc value = m_syn_expression->evaluate(context, scope, exception);
 	if (!!exception) return;
 	m_name_descriptor->set_initialize(scope, value);
 }
 
+void ast::ForVariableDeclaration::compile(rt::CodeCompiler* compiler) {
+	rt::CodeRegisterGuard guard(compiler);
+	rt::CodeReg value = compiler->allocate_register();
+	m_syn_expression->compile(compiler, value);
+	compiler->emit_initialize(m_name_descriptor.get(), value);
+}
+
 //
 //ExpressionForInit
 //
@@ -512,7 +615,7 @@ void ast::ExpressionForInit::bind(rt::BindContext* context, rt::BindScope* scope
 void ast::ExpressionForInit::execute(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope,
-	gc::Local<rt::Value>& exception)
+	rt::ValueLoc& exception)
 {
 	for (const ast_ref<Expression>& expr : *m_syn_expressions) {
 		expr->evaluate(context, scope, exception);
@@ -520,13 +623,18 @@ void ast::ExpressionForInit::execute(
 	}
 }
 
+void ast::ExpressionForInit::compile(rt::CodeCompiler* compiler) {
+	rt::CodeRegisterGuard guard(compiler);
+	rt::CodeReg value = compiler->allocate_register();
+	for (const ast_ref<Expression>& expr : *m_syn_expressions) expr->compile(compiler, value);
+}
+
 //
 //BlockStatement
 //
 
 void ast::BlockStatement::gc_enumerate_refs() {
 	ExecutionStatement::gc_enumerate_refs();
-	gc_ref(m_syn_pos);
 	gc_ref(m_syn_block);
 	gc_ref(m_scope_descriptor);
 }
@@ -539,7 +647,7 @@ void ast::BlockStatement::syn_block(const ast_ptr<Block>& block) {
 	m_syn_block = block;
 }
 
-gc::Local<ss::TextPos> ast::BlockStatement::get_pos() const {
+ss::TextPos ast::BlockStatement::get_pos() const {
 	return m_syn_pos;
 }
 
@@ -553,17 +661,22 @@ rt::StatementResult ast::BlockStatement::execute_0(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope)
 {
-	gc::Local<rt::ExecScope> sub_scope = scope->create_nested_scope(m_scope_descriptor, nullptr);
+	gc::Local<rt::ExecScope> sub_scope = scope->enter_block(m_scope_descriptor);
 	return m_syn_block->execute(context, sub_scope);
 }
 
+void ast::BlockStatement::compile(rt::CodeCompiler* compiler) {
+	compiler->emit_enter_scope(m_scope_descriptor);
+	m_syn_block->compile_inline(compiler);
+	compiler->emit_leave_scope(m_scope_descriptor);
+}
+
 //
 //TryStatement
 //
 
 void ast::TryStatement::gc_enumerate_refs() {
 	ExecutionStatement::gc_enumerate_refs();
-	gc_ref(m_syn_pos);
 	gc_ref(m_syn_try_statement);
 	gc_ref(m_syn_catch_variable);
 	gc_ref(m_syn_catch_statement);
@@ -592,7 +705,7 @@ void ast::TryStatement::syn_finally_statement(const ast_ptr<Statement>& finally_
 	m_syn_finally_statement = finally_statement;
 }
 
-gc::Local<ss::TextPos> ast::TryStatement::get_pos() const {
+ss::TextPos ast::TryStatement::get_pos() const {
 	return m_syn_pos;
 }
 
@@ -614,8 +727,7 @@ rt::StatementResult ast::TryStatement::execute_0(
 	rt::StatementResult result = m_syn_try_statement->execute(context, scope);
 
 	if (rt::StatementResultType::THROW == result.get_type() && !!m_syn_catch_statement) {
-		gc::Local<rt::ExecScope> sub_scope =
-			scope->create_nested_scope(m_catch_scope_descriptor, gc::Local<rt::Value>());
+		gc::Local<rt::ExecScope> sub_scope = scope->enter_block(m_catch_scope_descriptor);
 		m_catch_name_descriptor->set_initialize(sub_scope, result.get_value());
 		result = m_syn_catch_statement->execute(context, sub_scope);
 	}
@@ -636,14 +748,13 @@ rt::StatementResult ast::TryStatement::execute_0(
 
 void ast::ControlStatement::gc_enumerate_refs() {
 	ExecutionStatement::gc_enumerate_refs();
-	gc_ref(m_syn_pos);
 }
 
 void ast::ControlStatement::syn_pos(const SynPos& pos) {
 	m_syn_pos = pos;
 }
 
-gc::Local<ss::TextPos> ast::ControlStatement::get_pos() const {
+ss::TextPos ast::ControlStatement::get_pos() const {
 	return m_syn_pos;
 }
 
@@ -664,6 +775,10 @@ rt::StatementResult ast::ContinueStatement::execute_0(
 	return rt::StatementResult(rt::StatementResultType::CONTINUE);
 }
 
+void ast::ContinueStatement::compile(rt::CodeCompiler* compiler) {
+	compiler->emit_continue();
+}
+
 //
 //BreakStatement
 //
@@ -681,6 +796,10 @@ rt::StatementResult ast::BreakStatement::execute_0(
 	return rt::StatementResult(rt::StatementResultType::BREAK);
 }
 
+void ast::BreakStatement::compile(rt::CodeCompiler* compiler) {
+	compiler->emit_break();
+}
+
 //
 //ReturnStatement
 //
@@ -702,9 +821,9 @@ rt::StatementResult ast::ReturnStatement::execute_0(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope)
 {
-	gc::Local<rt::Value> result;
+	rt::ValueLoc result;
 	if (!!m_syn_return_value) {
-		gc::Local<rt::Value> exception;
+		rt::ValueLoc exception;
 		result = m_syn_return_value->evaluate(context, scope, exception);
 		if (!!exception) return rt::StatementResult::exception(exception);
 	} else {
@@ -714,6 +833,17 @@ rt::StatementResult ast::ReturnStatement::execute_0(
 	return rt::StatementResult(rt::StatementResultType::RETURN, result);
 }
 
+void ast::ReturnStatement::compile(rt::CodeCompiler* compiler) {
+	if (!!m_syn_return_value) {
+		rt::CodeRegisterGuard guard(compiler);
+		rt::CodeReg value = compiler->allocate_register();
+		m_syn_return_value->compile(compiler, value);
+		compiler->emit_return(value);
+	} else {
+		compiler->emit_return_void();
+	}
+}
+
 //
 //ThrowStatement
 //
@@ -731,19 +861,19 @@ void ast::ThrowStatement::bind(rt::BindContext* context, rt::BindScope* scope) {
 	m_syn_expression->bind(context, scope);
 }
 
-gc::Local<rt::Value> ast::ThrowStatement::create_exception_value(
-	const gc::Local<ss::TextPos>& text_pos,
+rt::ValueLoc ast::ThrowStatement::create_exception_value(
+	const ss::TextPos& text_pos,
 	const ss::RuntimeError& e)
 {
 	StringLoc str = gc::create<String>(e.get_msg());
-	gc::Local<rt::Value> value = gc::create<rt::StringValue>(str);
-	const gc::Local<TextPos>& actual_pos = !!e.get_pos() ? e.get_pos() : text_pos;
+	rt::ValueLoc value = gc::create<rt::StringValue>(str);
+	const TextPos& actual_pos = !!e.get_pos() ? e.get_pos() : text_pos;
 	return create_exception_value(actual_pos, value);
 }
 
-gc::Local<rt::Value> ast::ThrowStatement::create_exception_value(
-	const gc::Local<ss::TextPos>& text_pos,
-	const gc::Local<rt::Value>& value)
+rt::ValueLoc ast::ThrowStatement::create_exception_value(
+	const ss::TextPos& text_pos,
+	const rt::ValueLoc& value)
 {
 	return gc::create<rt::ExceptionValue>(value, rt::StackTraceMark::get_stack_trace(text_pos));
 }
@@ -752,10 +882,17 @@ rt::StatementResult ast::ThrowStatement::execute_0(
 	const gc::Local<rt::ExecContext>& context,
 	const gc::Local<rt::ExecScope>& scope)
 {
-	gc::Local<rt::Value> exception;
-	gc::Local<rt::Value> value = m_syn_expression->evaluate(context, scope, exception);
-	if (!exception && !dynamic_cast<rt::ExceptionValue*>(value.get())) {
-		value = create_exception_value(get_pos(), value);
-	}
+	rt::ValueLoc exception;
+	rt::ValueLoc value = m_syn_expression->evaluate(context, scope, exception);
+	if (!!exception) return rt::StatementResult::exception(exception);
+
+	if (!dynamic_cast<rt::ExceptionValue*>(value.get())) value = create_exception_value(get_pos(), value);
 	return rt::StatementResult::exception(value);
 }
+
+void ast::ThrowStatement::compile(rt::CodeCompiler* compiler) {
+	rt::CodeRegisterGuard guard(compiler);
+	rt::CodeReg value = compiler->allocate_register();
+	m_syn_expression->compile(compiler, value);
+	compiler->emit_throw(get_pos(), value);
+}
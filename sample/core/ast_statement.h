@@ -24,6 +24,7 @@
 #include "ast.h"
 #include "ast__dec.h"
 #include "ast_type.h"
+#include "bytecode__dec.h"
 #include "gc.h"
 #include "scope.h"
 
@@ -41,10 +42,14 @@ namespace syn_script {
 			Statement(){}
 
 		public:
-			virtual gc::Local<TextPos> get_pos() const = 0;
+			virtual TextPos get_pos() const = 0;
 			virtual ast_ptr<Declaration> get_declaration() const = 0;
 			virtual void bind(rt::BindContext* context, rt::BindScope* scope) = 0;
 
+			//Emits bytecode which executes the statement. By default the statement is executed by the AST
+			//interpreter.
+			virtual void compile(rt::CodeCompiler* compiler);
+
 			rt::StatementResult execute(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope);
@@ -75,9 +80,10 @@ namespace syn_script {
 			void syn_declaration(const ast_ptr<Declaration>&);
 
 		public:
-			gc::Local<TextPos> get_pos() const override final;
+			TextPos get_pos() const override final;
 			ast_ptr<Declaration> get_declaration() const override final;
 			void bind(rt::BindContext* context, rt::BindScope* scope) override;
+			void compile(rt::CodeCompiler* compiler) override;
 
 		protected:
 			rt::StatementResult execute_0(
@@ -106,7 +112,7 @@ namespace syn_script {
 		class EmptyStatement : public ExecutionStatement {
 			NONCOPYABLE(EmptyStatement);
 
-			gc::Ref<TextPos> m_syn_pos;
+			TextPos m_syn_pos;
 
 		public:
 			EmptyStatement(){}
@@ -119,9 +125,10 @@ namespace syn_script {
 			void syn_pos(const SynPos&);
 
 		public:
-			gc::Local<TextPos> get_pos() const override;
+			TextPos get_pos() const override;
 
 			void bind(rt::BindContext* context, rt::BindScope* scope) override;
+			void compile(rt::CodeCompiler* compiler) override;
 
 		protected:
 			rt::StatementResult execute_0(
@@ -149,9 +156,10 @@ namespace syn_script {
 			void syn_expression(const ast_ptr<Expression>&);
 
 		public:
-			gc::Local<TextPos> get_pos() const override;
+			TextPos get_pos() const override;
 
 			void bind(rt::BindContext* context, rt::BindScope* scope) override;
+			void compile(rt::CodeCompiler* compiler) override;
 
 		protected:
 			rt::StatementResult execute_0(
@@ -166,7 +174,7 @@ namespace syn_script {
 		class IfStatement : public ExecutionStatement {
 			NONCOPYABLE(IfStatement);
 
-			gc::Ref<TextPos> m_syn_pos;
+			TextPos m_syn_pos;
 			ast_ref<Expression> m_syn_expression;
 			ast_ref<Statement> m_syn_true_statement;
 			ast_ref<Statement> m_syn_false_statement;
@@ -185,9 +193,10 @@ namespace syn_script {
 			void syn_false_statement(const ast_ptr<Statement>&);
 
 		public:
-			gc::Local<TextPos> get_pos() const override;
+			TextPos get_pos() const override;
 
 			void bind(rt::BindContext* context, rt::BindScope* scope) override;
+			void compile(rt::CodeCompiler* compiler) override;
 
 		protected:
 			rt::StatementResult execute_0(
@@ -202,7 +211,7 @@ namespace syn_script {
 		class LoopStatement : public ExecutionStatement {
 			NONCOPYABLE(LoopStatement);
 
-			gc::Ref<TextPos> m_syn_pos;
+			TextPos m_syn_pos;
 			ast_ref<Expression> m_syn_expression;
 			ast_ref<Statement> m_syn_statement;
 
@@ -219,7 +228,7 @@ namespace syn_script {
 			void syn_statement(const ast_ptr<Statement>&);
 
 		public:
-			gc::Local<TextPos> get_pos() const override final;
+			TextPos get_pos() const override final;
 			const ast_ref<Expression>& get_expression() const;
 			const ast_ref<Statement>& get_statement() const;
 
@@ -231,6 +240,8 @@ namespace syn_script {
 				const gc::Local<rt::ExecScope>& scope) override final;
 
 		protected:
+			const gc::Ref<rt::ScopeDescriptor>& get_scope_descriptor() const;
+
 			virtual void bind_loop(rt::BindContext* context, rt::BindScope* scope);
 
 			virtual rt::StatementResult exec_loop(
@@ -248,6 +259,10 @@ namespace syn_script {
 		protected:
 			RegularLoopStatement(){}
 
+		public:
+			void compile(rt::CodeCompiler* compiler) override final;
+
+		protected:
 			rt::StatementResult exec_loop(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope) override final;
@@ -255,12 +270,15 @@ namespace syn_script {
 			virtual void exec_loop_init(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope,
-				gc::Local<rt::Value>& exception);
+				rt::ValueLoc& exception);
 
 			virtual void exec_loop_update(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope,
-				gc::Local<rt::Value>& exception);
+				rt::ValueLoc& exception);
+
+			virtual void compile_loop_init(rt::CodeCompiler* compiler);
+			virtual void compile_loop_update(rt::CodeCompiler* compiler);
 		};
 
 		//
@@ -301,12 +319,15 @@ namespace syn_script {
 			void exec_loop_init(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope,
-				gc::Local<rt::Value>& exception) override;
+				rt::ValueLoc& exception) override;
 
 			void exec_loop_update(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope,
-				gc::Local<rt::Value>& exception) override;
+				rt::ValueLoc& exception) override;
+
+			void compile_loop_init(rt::CodeCompiler* compiler) override;
+			void compile_loop_update(rt::CodeCompiler* compiler) override;
 		};
 
 		//
@@ -356,11 +377,12 @@ namespace syn_script {
 
 		public:
 			virtual void bind(rt::BindContext* context, rt::BindScope* scope) = 0;
+			virtual void compile(rt::CodeCompiler* compiler) = 0;
 
 			virtual void execute(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope,
-				gc::Local<rt::Value>& exception) = 0;
+				rt::ValueLoc& exception) = 0;
 		};
 
 		//
@@ -384,11 +406,12 @@ namespace syn_script {
 
 		public:
 			void bind(rt::BindContext* context, rt::BindScope* scope) override;
+			void compile(rt::CodeCompiler* compiler) override;
 
 			void execute(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope,
-				gc::Local<rt::Value>& exception) override;
+				rt::ValueLoc& exception) override;
 		};
 
 		//
@@ -416,11 +439,12 @@ namespace syn_script {
 
 		public:
 			void bind(rt::BindContext* context, rt::BindScope* scope);
+			void compile(rt::CodeCompiler* compiler);
 
 			void execute(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope,
-				gc::Local<rt::Value>& exception);
+				rt::ValueLoc& exception);
 		};
 
 		//
@@ -444,11 +468,12 @@ namespace syn_script {
 
 		public:
 			void bind(rt::BindContext* context, rt::BindScope* scope) override;
+			void compile(rt::CodeCompiler* compiler) override;
 
 			void execute(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope,
-				gc::Local<rt::Value>& exception) override;
+				rt::ValueLoc& exception) override;
 		};
 
 		//
@@ -458,7 +483,7 @@ namespace syn_script {
 		class BlockStatement : public ExecutionStatement {
 			NONCOPYABLE(BlockStatement);
 
-			gc::Ref<TextPos> m_syn_pos;
+			TextPos m_syn_pos;
 			ast_ref<Block> m_syn_block;
 
 			gc::Ref<rt::ScopeDescriptor> m_scope_descriptor;
@@ -475,9 +500,10 @@ namespace syn_script {
 			void syn_block(const ast_ptr<Block>&);
 
 		public:
-			gc::Local<TextPos> get_pos() const override;
+			TextPos get_pos() const override;
 
 			void bind(rt::BindContext* context, rt::BindScope* scope) override;
+			void compile(rt::CodeCompiler* compiler) override;
 
 		protected:
 			rt::StatementResult execute_0(
@@ -492,7 +518,7 @@ namespace syn_script {
 		class TryStatement : public ExecutionStatement {
 			NONCOPYABLE(TryStatement);
 
-			gc::Ref<TextPos> m_syn_pos;
+			TextPos m_syn_pos;
 			ast_ref<Statement> m_syn_try_statement;
 			gc::Ref<AstName> m_syn_catch_variable;
 			ast_ref<Statement> m_syn_catch_statement;
@@ -516,7 +542,7 @@ namespace syn_script {
 			void syn_finally_statement(const ast_ptr<Statement>&);
 
 		public:
-			gc::Local<TextPos> get_pos() const override;
+			TextPos get_pos() const override;
 
 			void bind(rt::BindContext* context, rt::BindScope* scope) override;
 
@@ -533,7 +559,7 @@ namespace syn_script {
 		class ControlStatement : public ExecutionStatement {
 			NONCOPYABLE(ControlStatement);
 
-			gc::Ref<TextPos> m_syn_pos;
+			TextPos m_syn_pos;
 
 		protected:
 			ControlStatement(){}
@@ -544,7 +570,7 @@ namespace syn_script {
 			void syn_pos(const SynPos&);
 
 		public:
-			gc::Local<TextPos> get_pos() const override final;
+			TextPos get_pos() const override final;
 		};
 
 		//
@@ -558,6 +584,7 @@ namespace syn_script {
 			ContinueStatement(){}
 
 			void bind(rt::BindContext* context, rt::BindScope* scope) override;
+			void compile(rt::CodeCompiler* compiler) override;
 
 		protected:
 			rt::StatementResult execute_0(
@@ -576,6 +603,7 @@ namespace syn_script {
 			BreakStatement(){}
 
 			void bind(rt::BindContext* context, rt::BindScope* scope) override;
+			void compile(rt::CodeCompiler* compiler) override;
 
 		protected:
 			rt::StatementResult execute_0(
@@ -604,6 +632,7 @@ namespace syn_script {
 
 		public:
 			void bind(rt::BindContext* context, rt::BindScope* scope) override;
+			void compile(rt::CodeCompiler* compiler) override;
 
 		protected:
 			rt::StatementResult execute_0(
@@ -632,20 +661,20 @@ namespace syn_script {
 
 		public:
 			void bind(rt::BindContext* context, rt::BindScope* scope) override;
+			void compile(rt::CodeCompiler* compiler) override;
 
-			static gc::Local<rt::Value> create_exception_value(
-				const gc::Local<TextPos>& text_pos,
+			static rt::ValueLoc create_exception_value(
+				const TextPos& text_pos,
 				const RuntimeError& e);
 
+			static rt::ValueLoc create_exception_value(
+				const TextPos& text_pos,
+				const rt::ValueLoc& value);
+
 		protected:
 			rt::StatementResult execute_0(
 				const gc::Local<rt::ExecContext>& context,
 				const gc::Local<rt::ExecScope>& scope) override;
-
-		private:
-			static gc::Local<rt::Value> create_exception_value(
-				const gc::Local<TextPos>& text_pos,
-				const gc::Local<rt::Value>& value);
 		};
 
 	}
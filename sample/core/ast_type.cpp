@@ -30,16 +30,11 @@ namespace gc = ss::gc;
 //AstValue
 //
 
-void ast::AstValue::gc_enumerate_refs() {
-	gc::Object::gc_enumerate_refs();
-	gc_ref(m_pos);
-}
-
-void ast::AstValue::initialize(const gc::Local<ss::TextPos>& pos) {
+void ast::AstValue::initialize(const ss::TextPos& pos) {
 	m_pos = pos;
 }
 
-const gc::Ref<ss::TextPos>& ast::AstValue::pos() const {
+const ss::TextPos& ast::AstValue::pos() const {
 	return m_pos;
 }
 
@@ -47,7 +42,7 @@ const gc::Ref<ss::TextPos>& ast::AstValue::pos() const {
 //AstInteger
 //
 
-void ast::AstInteger::initialize(const gc::Local<ss::TextPos>& pos, ss::ScriptIntegerType value) {
+void ast::AstInteger::initialize(const ss::TextPos& pos, ss::ScriptIntegerType value) {
 	AstValue::initialize(pos);
 	m_value = value;
 }
@@ -60,7 +55,7 @@ ss::ScriptIntegerType ast::AstInteger::value() const {
 //AstFloat
 //
 
-void ast::AstFloat::initialize(const gc::Local<ss::TextPos>& pos, ss::ScriptFloatType value) {
+void ast::AstFloat::initialize(const ss::TextPos& pos, ss::ScriptFloatType value) {
 	AstValue::initialize(pos);
 	m_value = value;
 }
@@ -78,7 +73,7 @@ void ast::AstName::gc_enumerate_refs() {
 	gc_ref(m_info);
 }
 
-void ast::AstName::initialize(const gc::Local<ss::TextPos>& pos, const gc::Local<const ss::NameInfo>& info) {
+void ast::AstName::initialize(const ss::TextPos& pos, const gc::Local<const ss::NameInfo>& info) {
 	AstValue::initialize(pos);
 	m_info = info;
 }
@@ -104,7 +99,7 @@ void ast::AstString::gc_enumerate_refs() {
 	gc_ref(m_value);
 }
 
-void ast::AstString::initialize(const gc::Local<ss::TextPos>& pos, const ss::StringLoc& value) {
+void ast::AstString::initialize(const ss::TextPos& pos, const ss::StringLoc& value) {
 	AstValue::initialize(pos);
 	m_value = value;
 }
@@ -28,7 +28,7 @@
 namespace syn_script {
 	namespace ast {
 
-		typedef gc::Local<TextPos> SynPos;
+		typedef TextPos SynPos;
 
 		//
 		//AstValue
@@ -37,16 +37,15 @@ namespace syn_script {
 		class AstValue : public gc::Object {
 			NONCOPYABLE(AstValue);
 
-			gc::Ref<TextPos> m_pos;
+			TextPos m_pos;
 
 		protected:
 			AstValue(){}
-			void gc_enumerate_refs() override;
 
 		public:
-			void initialize(const gc::Local<TextPos>& pos);
+			void initialize(const TextPos& pos);
 
-			const gc::Ref<TextPos>& pos() const;
+			const TextPos& pos() const;
 		};
 
 		//
@@ -60,7 +59,7 @@ namespace syn_script {
 
 		public:
 			AstInteger(){}
-			void initialize(const gc::Local<TextPos>& pos, ScriptIntegerType value);
+			void initialize(const TextPos& pos, ScriptIntegerType value);
 
 			ScriptIntegerType value() const;
 		};
@@ -76,7 +75,7 @@ namespace syn_script {
 
 		public:
 			AstFloat(){}
-			void initialize(const gc::Local<TextPos>& pos, ScriptFloatType value);
+			void initialize(const TextPos& pos, ScriptFloatType value);
 
 			ScriptFloatType value() const;
 		};
@@ -93,7 +92,7 @@ namespace syn_script {
 		public:
 			AstName(){}
 			void gc_enumerate_refs() override;
-			void initialize(const gc::Local<TextPos>& pos, const gc::Local<const NameInfo>& info);
+			void initialize(const TextPos& pos, const gc::Local<const NameInfo>& info);
 
 			const gc::Ref<const NameInfo>& get_info() const;
 			const NameID& get_id() const;
@@ -112,7 +111,7 @@ namespace syn_script {
 		public:
 			AstString(){}
 			void gc_enumerate_refs() override;
-			void initialize(const gc::Local<TextPos>& pos, const StringLoc& value);
+			void initialize(const TextPos& pos, const StringLoc& value);
 
 			StringLoc value() const;
 		};
@@ -0,0 +1,1163 @@
+/*
+ * Copyright 2014 Anton Karmanov
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//Bytecode compiler and virtual machine.
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+#include "ast.h"
+#include "ast_combined.h"
+#include "bytecode.h"
+#include "common.h"
+#include "gc.h"
+#include "name.h"
+#include "op.h"
+#include "scope.h"
+#include "stacktrace.h"
+#include "value.h"
+#include "value_core.h"
+#include "value_stack.h"
+
+namespace ss = syn_script;
+namespace ast = ss::ast;
+namespace rt = ss::rt;
+namespace gc = ss::gc;
+
+//
+//Opcode
+//
+
+//Operands of each instruction are listed in the comments. A register operand is an index in the register window,
+//a label operand is an absolute pc. The order of the list defines the dispatch table, so the enumeration is
+//generated from it.
+#define SYNSAMPLE_BYTECODE_OPCODES(X) \
+	X(MOVE)           /*dst, src*/ \
+	X(LOAD_CONST)     /*dst, constant*/ \
+	X(LOAD_NAME)      /*dst, descriptor*/ \
+	X(LOAD_VAR)       /*dst, scope_ofs, name_ofs*/ \
+	X(LOAD_VAR_RAW)   /*dst, scope_ofs, name_ofs*/ \
+	X(STORE_VAR)      /*src, scope_ofs, name_ofs*/ \
+	X(INIT_VAR)       /*src, scope_ofs, name_ofs*/ \
+	X(LOAD_THIS)      /*dst, scope_ofs*/ \
+	X(PLUS)           /*dst, a*/ \
+	X(NEG)            /*dst, a*/ \
+	X(NOT)            /*dst, a*/ \
+	X(ADD)            /*dst, a, b*/ \
+	X(SUB)            /*dst, a, b*/ \
+	X(MUL)            /*dst, a, b*/ \
+	X(DIV)            /*dst, a, b*/ \
+	X(MOD)            /*dst, a, b*/ \
+	X(AND)            /*dst, a, b*/ \
+	X(OR)             /*dst, a, b*/ \
+	X(EQ)             /*dst, a, b*/ \
+	X(NE)             /*dst, a, b*/ \
+	X(LT)             /*dst, a, b*/ \
+	X(GT)             /*dst, a, b*/ \
+	X(LE)             /*dst, a, b*/ \
+	X(GE)             /*dst, a, b*/ \
+	X(SHORT_AND)      /*dst, a, label*/ \
+	X(SHORT_OR)       /*dst, a, label*/ \
+	X(INC)            /*old, new, result, postfix*/ \
+	X(DEC)            /*old, new, result, postfix*/ \
+	X(CHECK_ASSIGN)   /*src*/ \
+	X(CHECK_INIT)     /*src*/ \
+	X(GET_MEMBER)     /*dst, object, name, cache*/ \
+	X(SET_MEMBER)     /*object, name, src, cache*/ \
+	X(GET_ELEM)       /*dst, array, index*/ \
+	X(SET_ELEM)       /*array, index, src*/ \
+	X(CALL)           /*dst, function, arguments, count, position*/ \
+	X(CALL_MEMBER)    /*dst, object, name, arguments, count, cache, position*/ \
+	X(NEW)            /*dst, type, arguments, count, position*/ \
+	X(NEW_ARRAY)      /*dst, length*/ \
+	X(MAKE_ARRAY)     /*dst, elements, count*/ \
+	X(MAKE_FUNCTION)  /*dst, expression*/ \
+	X(MAKE_CLASS)     /*dst, expression*/ \
+	X(TYPEOF)         /*dst, src*/ \
+	X(JUMP)           /*label*/ \
+	X(LOOP)           /*label*/ \
+	X(JUMP_FALSE)     /*condition, label*/ \
+	X(ENTER_SCOPE)    /*descriptor*/ \
+	X(LEAVE_SCOPE)    /*count*/ \
+	X(RESET_FIELDS)   /*descriptor*/ \
+	X(EXIT_BREAK)     /**/ \
+	X(EXIT_CONTINUE)  /**/ \
+	X(RETURN)         /*src*/ \
+	X(RETURN_VOID)    /**/ \
+	X(THROW)          /*src*/ \
+	X(EVAL_AST)       /*dst, expression*/ \
+	X(EXEC_AST)       /*statement, break_label, break_leave, continue_label, continue_leave*/ \
+	X(END)            /**/
+
+#define SYNSAMPLE_BYTECODE_ENUM(op) op,
+
+namespace syn_script {
+	namespace rt {
+		enum class Opcode : CodeWord {
+			SYNSAMPLE_BYTECODE_OPCODES(SYNSAMPLE_BYTECODE_ENUM)
+		};
+	}
+}
+
+#undef SYNSAMPLE_BYTECODE_ENUM
+
+namespace {
+
+	//Label operand of EXEC_AST meaning "not in a loop": the result is returned from the code block.
+	const rt::CodeWord NO_TARGET = std::numeric_limits<rt::CodeWord>::max();
+
+	//GC synchronization is done once per this number of loop iterations, since it reads the clock.
+	const unsigned int LOOP_SYNC_PERIOD = 256;
+
+	std::size_t get_index_value(const rt::ValueLoc& index) {
+		ss::ScriptIntegerType idx = index->get_integer();
+		const std::size_t max_len = std::numeric_limits<std::size_t>::max();
+		if (idx < 0 || idx > max_len) throw ss::RuntimeError("Index out of range");
+		return static_cast<std::size_t>(idx);
+	}
+
+	void check_operand(const rt::ValueLoc& value) {
+		if (value->is_undefined()) throw ss::RuntimeError("The value of the operand is undefined");
+		if (value->is_void()) throw ss::RuntimeError("The value of the operand is void");
+	}
+
+	rt::ValueLoc increment_value(const gc::Local<rt::ExecContext>& context, const rt::ValueLoc& value, int delta) {
+		rt::OperandType type = value->get_operand_type();
+		if (rt::OperandType::INTEGER == type) {
+			ss::ScriptIntegerType x = value->get_integer();
+			x += static_cast<ss::ScriptIntegerType>(delta);
+			return context->get_value_factory()->get_integer_value(x);
+		} else if (rt::OperandType::FLOAT == type) {
+			ss::ScriptFloatType x = value->get_float();
+			x += delta;
+			return context->get_value_factory()->get_float_value(x);
+		} else {
+			return rt::ValueLoc();
+		}
+	}
+
+}
+
+//
+//CodeBlock
+//
+
+void rt::CodeBlock::gc_enumerate_refs() {
+	gc_ref(m_code);
+	gc_ref(m_constants);
+	gc_ref(m_objects);
+	gc_ref(m_pos_pcs);
+	gc_ref(m_positions);
+}
+
+void rt::CodeBlock::initialize(
+	const gc::Local<gc::PrimitiveArray<CodeWord>>& code,
+	const gc::Local<ValueArray>& constants,
+	const gc::Local<gc::Array<gc::Object>>& objects,
+	const gc::Local<gc::PrimitiveArray<CodeWord>>& pos_pcs,
+	const gc::Local<gc::PrimitiveArray<TextPos>>& positions,
+	std::size_t register_count)
+{
+	m_code = code;
+	m_constants = constants;
+	m_objects = objects;
+	m_pos_pcs = pos_pcs;
+	m_positions = positions;
+	m_register_count = register_count;
+}
+
+template<class T>
+gc::Local<T> rt::CodeBlock::get_object(CodeWord index) const {
+	return m_objects->get(index).stat_cast<T>();
+}
+
+ss::TextPos rt::CodeBlock::get_pc_pos(std::size_t pc) const {
+	const CodeWord* begin = m_pos_pcs->raw_array();
+	const CodeWord* end = begin + m_pos_pcs->length();
+	const CodeWord* it = std::upper_bound(begin, end, pc);
+	if (it == begin || it[-1] != pc) return TextPos();
+	return m_positions->get(it - 1 - begin);
+}
+
+rt::StatementResult rt::CodeBlock::execute(const gc::Local<ExecContext>& context, const gc::Local<ExecScope>& scope) {
+	ValueStackWindow window(m_register_count);
+	ValueRef* const regs = window.get_values();
+
+	const ValueFactory* const factory = context->get_value_factory();
+	const CodeWord* const code = m_code->raw_array();
+	const CodeWord* ip = code;
+	const CodeWord* op_ip = code;
+	gc::Local<ExecScope> cur_scope = scope;
+	unsigned int loop_count = 0;
+
+#ifdef __GNUC__
+#define SYNSAMPLE_BYTECODE_LABEL(op) &&L_##op,
+	static void* const s_dispatch_table[] = {
+		SYNSAMPLE_BYTECODE_OPCODES(SYNSAMPLE_BYTECODE_LABEL)
+	};
+#undef SYNSAMPLE_BYTECODE_LABEL
+#define VM_CASE(op) L_##op:
+//The dispatch is reached by a plain goto, since a computed goto does not destroy the locals of the block it leaves.
+#define VM_NEXT() goto vm_next
+#else
+#define VM_CASE(op) case Opcode::op:
+#define VM_NEXT() continue
+#endif
+
+	try {
+#ifdef __GNUC__
+	vm_next:
+		op_ip = ip;
+		goto *s_dispatch_table[*ip++];
+#else
+		for (;;) {
+			op_ip = ip;
+			switch (static_cast<Opcode>(*ip++)) {
+#endif
+
+		VM_CASE(MOVE) {
+			regs[ip[0]] = regs[ip[1]];
+			ip += 2;
+			VM_NEXT();
+		}
+
+		VM_CASE(LOAD_CONST) {
+			regs[ip[0]] = m_constants->get(ip[1]);
+			ip += 2;
+			VM_NEXT();
+		}
+
+		VM_CASE(LOAD_NAME) {
+			ValueLoc value = get_object<NameDescriptor>(ip[1])->get(cur_scope);
+			if (value->is_undefined()) throw RuntimeError("Undefined value");
+			regs[ip[0]] = value;
+			ip += 2;
+			VM_NEXT();
+		}
+
+		VM_CASE(LOAD_VAR) {
+			const ValueRef& ref = cur_scope->get_field(ip[1], ip[2]);
+			if (ValueWord::UNDEFINED_VALUE == ref.get_word()) throw RuntimeError("Undefined value");
+			regs[ip[0]] = ref;
+			ip += 3;
+			VM_NEXT();
+		}
+
+		VM_CASE(LOAD_VAR_RAW) {
+			regs[ip[0]] = cur_scope->get_field(ip[1], ip[2]);
+			ip += 3;
+			VM_NEXT();
+		}
+
+		VM_CASE(STORE_VAR) {
+			cur_scope->get_field(ip[1], ip[2]) = regs[ip[0]];
+			ip += 3;
+			VM_NEXT();
+		}
+
+		VM_CASE(INIT_VAR) {
+			ValueRef& ref = cur_scope->get_field(ip[1], ip[2]);
+			assert(ref->is_undefined());
+			ref = regs[ip[0]];
+			ip += 3;
+			VM_NEXT();
+		}
+
+		VM_CASE(LOAD_THIS) {
+			regs[ip[0]] = cur_scope->get_this(ip[1]);
+			ip += 2;
+			VM_NEXT();
+		}
+
+		VM_CASE(PLUS) {
+			regs[ip[0]] = PlusUnaryOperator::Instance.evaluate(context, ValueLoc(regs[ip[1]]));
+			ip += 2;
+			VM_NEXT();
+		}
+
+		VM_CASE(NEG) {
+			regs[ip[0]] = MinusUnaryOperator::Instance.evaluate(context, ValueLoc(regs[ip[1]]));
+			ip += 2;
+			VM_NEXT();
+		}
+
+		VM_CASE(NOT) {
+			std::uintptr_t a = regs[ip[1]].get_word();
+			if (ValueWord::TRUE_VALUE == a || ValueWord::FALSE_VALUE == a) {
+				regs[ip[0]].set_word(ValueWord::encode_boolean(ValueWord::FALSE_VALUE == a));
+			} else {
+				regs[ip[0]] = LogicalNotUnaryOperator::Instance.evaluate(context, ValueLoc(regs[ip[1]]));
+			}
+			ip += 2;
+			VM_NEXT();
+		}
+
+#define VM_BINARY_INT(op, INSTANCE, expr) \
+		VM_CASE(op) { \
+			std::uintptr_t a = regs[ip[1]].get_word(); \
+			std::uintptr_t b = regs[ip[2]].get_word(); \
+			if (ValueWord::is_integer(a) && ValueWord::is_integer(b)) { \
+				ScriptIntegerType x = ValueWord::decode_integer(a); \
+				ScriptIntegerType y = ValueWord::decode_integer(b); \
+				expr \
+			} \
+			regs[ip[0]] = INSTANCE.evaluate(context, ValueLoc(regs[ip[1]]), ValueLoc(regs[ip[2]])); \
+			ip += 3; \
+			VM_NEXT(); \
+		}
+
+#define VM_BINARY_ARITH(op, INSTANCE, oper) \
+		VM_BINARY_INT(op, INSTANCE, { \
+			ScriptIntegerType r = x oper y; \
+			if (ValueWord::fits_integer(r)) { \
+				regs[ip[0]].set_word(ValueWord::encode_integer(r)); \
+				ip += 3; \
+				VM_NEXT(); \
+			} \
+		})
+
+#define VM_BINARY_REL(op, INSTANCE, oper) \
+		VM_BINARY_INT(op, INSTANCE, { \
+			bool r = static_cast<std::int64_t>(x) oper static_cast<std::int64_t>(y); \
+			regs[ip[0]].set_word(ValueWord::encode_boolean(r)); \
+			ip += 3; \
+			VM_NEXT(); \
+		})
+
+#define VM_BINARY(op, INSTANCE) \
+		VM_CASE(op) { \
+			regs[ip[0]] = INSTANCE.evaluate(context, ValueLoc(regs[ip[1]]), ValueLoc(regs[ip[2]])); \
+			ip += 3; \
+			VM_NEXT(); \
+		}
+
+		VM_BINARY_ARITH(ADD, AddBinaryOperator::Instance, +)
+		VM_BINARY_ARITH(SUB, SubBinaryOperator::Instance, -)
+		VM_BINARY(MUL, MulBinaryOperator::Instance)
+		VM_BINARY(DIV, DivBinaryOperator::Instance)
+		VM_BINARY(MOD, ModBinaryOperator::Instance)
+		VM_BINARY(AND, LogicalAndBinaryOperator::Instance)
+		VM_BINARY(OR, LogicalOrBinaryOperator::Instance)
+		VM_BINARY_REL(EQ, EqBinaryOperator::Instance, ==)
+		VM_BINARY_REL(NE, NeBinaryOperator::Instance, !=)
+		VM_BINARY_REL(LT, LtBinaryOperator::Instance, <)
+		VM_BINARY_REL(GT, GtBinaryOperator::Instance, >)
+		VM_BINARY_REL(LE, LeBinaryOperator::Instance, <=)
+		VM_BINARY_REL(GE, GeBinaryOperator::Instance, >=)
+
+#undef VM_BINARY
+#undef VM_BINARY_REL
+#undef VM_BINARY_ARITH
+#undef VM_BINARY_INT
+
+#define VM_SHORT(op, INSTANCE, short_word, next_word) \
+		VM_CASE(op) { \
+			std::uintptr_t a = regs[ip[1]].get_word(); \
+			if (short_word == a) { \
+				regs[ip[0]].set_word(short_word); \
+				ip = code + ip[2]; \
+			} else if (next_word == a) { \
+				ip += 3; \
+			} else { \
+				ValueLoc result = INSTANCE.evaluate_short(context, ValueLoc(regs[ip[1]])); \
+				if (!!result) { \
+					regs[ip[0]] = result; \
+					ip = code + ip[2]; \
+				} else { \
+					ip += 3; \
+				} \
+			} \
+			VM_NEXT(); \
+		}
+
+		VM_SHORT(SHORT_AND, LogicalAndBinaryOperator::Instance, ValueWord::FALSE_VALUE, ValueWord::TRUE_VALUE)
+		VM_SHORT(SHORT_OR, LogicalOrBinaryOperator::Instance, ValueWord::TRUE_VALUE, ValueWord::FALSE_VALUE)
+
+#undef VM_SHORT
+
+#define VM_INCDEC(op, delta) \
+		VM_CASE(op) { \
+			std::uintptr_t word = regs[ip[0]].get_word(); \
+			if (ValueWord::is_integer(word)) { \
+				ScriptIntegerType x = ValueWord::decode_integer(word) + static_cast<ScriptIntegerType>(delta); \
+				if (ValueWord::fits_integer(x)) { \
+					regs[ip[1]].set_word(ValueWord::encode_integer(x)); \
+				} else { \
+					regs[ip[1]] = factory->get_integer_value(x); \
+				} \
+			} else { \
+				ValueLoc value(regs[ip[0]]); \
+				check_operand(value); \
+				regs[ip[1]] = increment_value(context, value, delta); \
+			} \
+			regs[ip[2]] = regs[ip[ip[3] ? 0 : 1]]; \
+			ip += 4; \
+			VM_NEXT(); \
+		}
+
+		VM_INCDEC(INC, 1)
+		VM_INCDEC(DEC, -1)
+
+#undef VM_INCDEC
+
+		VM_CASE(CHECK_ASSIGN) {
+			ValueLoc value(regs[ip[0]]);
+			if (value->is_undefined()) throw RuntimeError("The value is undefined");
+			if (value->is_void()) throw RuntimeError("Cannot assign a void value");
+			ip += 1;
+			VM_NEXT();
+		}
+
+		VM_CASE(CHECK_INIT) {
+			if (ValueWord::VOID_VALUE == regs[ip[0]].get_word()) {
+				throw RuntimeError("Cannot initialize a variable with void value");
+			}
+			ip += 1;
+			VM_NEXT();
+		}
+
+		VM_CASE(GET_MEMBER) {
+			ValueLoc object(regs[ip[1]]);
+			gc::Local<MemberCache> cache = get_object<MemberCache>(ip[3]);
+			regs[ip[0]] = object->get_member(context, cur_scope, get_object<const NameInfo>(ip[2]), *cache);
+			ip += 4;
+			VM_NEXT();
+		}
+
+		VM_CASE(SET_MEMBER) {
+			ValueLoc object(regs[ip[0]]);
+			gc::Local<MemberCache> cache = get_object<MemberCache>(ip[3]);
+			object->set_member(context, cur_scope, get_object<const NameInfo>(ip[1]), ValueLoc(regs[ip[2]]), *cache);
+			ip += 4;
+			VM_NEXT();
+		}
+
+		VM_CASE(GET_ELEM) {
+			ValueLoc array(regs[ip[1]]);
+			std::size_t index = get_index_value(ValueLoc(regs[ip[2]]));
+			regs[ip[0]] = array->get_array_element(context, index);
+			ip += 3;
+			VM_NEXT();
+		}
+
+		VM_CASE(SET_ELEM) {
+			ValueLoc array(regs[ip[0]]);
+			std::size_t index = get_index_value(ValueLoc(regs[ip[1]]));
+			array->set_array_element(context, index, ValueLoc(regs[ip[2]]));
+			ip += 3;
+			VM_NEXT();
+		}
+
+#define VM_CALL(op, method) \
+		VM_CASE(op) { \
+			ArgSpan arguments(regs + ip[2], ip[3]); \
+			ValueLoc exception; \
+			ValueLoc value; \
+			{ \
+				StackTraceMark stack_trace(m_positions->get(ip[4])); \
+				value = ValueLoc(regs[ip[1]])->method(context, arguments, exception); \
+			} \
+			if (!!exception) return StatementResult::exception(exception); \
+			regs[ip[0]] = value; \
+			ip += 5; \
+			VM_NEXT(); \
+		}
+
+		VM_CALL(CALL, invoke)
+		VM_CALL(NEW, instantiate)
+
+#undef VM_CALL
+
+		VM_CASE(CALL_MEMBER) {
+			ArgSpan arguments(regs + ip[3], ip[4]);
+			gc::Local<MemberCache> cache = get_object<MemberCache>(ip[5]);
+			ValueLoc exception;
+			ValueLoc value;
+			{
+				StackTraceMark stack_trace(m_positions->get(ip[6]));
+				ValueLoc object(regs[ip[1]]);
+				value = object->invoke_member(
+					context,
+					cur_scope,
+					get_object<const NameInfo>(ip[2]),
+					arguments,
+					*cache,
+					exception);
+			}
+			if (!!exception) return StatementResult::exception(exception);
+			regs[ip[0]] = value;
+			ip += 7;
+			VM_NEXT();
+		}
+
+		VM_CASE(NEW_ARRAY) {
+			ScriptIntegerType len = ValueLoc(regs[ip[1]])->get_integer();
+			const std::size_t max_len = std::numeric_limits<std::size_t>::max();
+			if (len > max_len) throw RuntimeError("Array length out of range");
+
+			const std::size_t array_len = scriptint_to_size(len);
+			regs[ip[0]] = gc::create<ArrayValue>(array_len);
+			ip += 2;
+			VM_NEXT();
+		}
+
+		VM_CASE(MAKE_ARRAY) {
+			std::size_t count = ip[2];
+			regs[ip[0]] = gc::create<ArrayValue>(regs + ip[1], count);
+			ip += 3;
+			VM_NEXT();
+		}
+
+		VM_CASE(MAKE_FUNCTION) {
+			regs[ip[0]] = gc::create<FunctionValue>(cur_scope, get_object<ast::FunctionExpression>(ip[1]));
+			ip += 2;
+			VM_NEXT();
+		}
+
+		VM_CASE(MAKE_CLASS) {
+			regs[ip[0]] = gc::create<ClassValue>(cur_scope, get_object<ast::ClassExpression>(ip[1]));
+			ip += 2;
+			VM_NEXT();
+		}
+
+		VM_CASE(TYPEOF) {
+			StringLoc str = ValueLoc(regs[ip[1]])->typeof(context);
+			regs[ip[0]] = factory->get_string_value(str);
+			ip += 2;
+			VM_NEXT();
+		}
+
+		VM_CASE(JUMP) {
+			ip = code + ip[0];
+			VM_NEXT();
+		}
+
+		VM_CASE(LOOP) {
+			//A loop may not allocate anything, so it has to let other threads perform garbage collection.
+			if (++loop_count == LOOP_SYNC_PERIOD) {
+				loop_count = 0;
+				gc::synchronize();
+			}
+			ip = code + ip[0];
+			VM_NEXT();
+		}
+
+		VM_CASE(JUMP_FALSE) {
+			std::uintptr_t word = regs[ip[0]].get_word();
+			if (ValueWord::FALSE_VALUE == word) {
+				ip = code + ip[1];
+			} else {
+				if (ValueWord::TRUE_VALUE != word) ValueLoc(regs[ip[0]]).get_boolean();
+				ip += 2;
+			}
+			VM_NEXT();
+		}
+
+		VM_CASE(ENTER_SCOPE) {
+			cur_scope = cur_scope->create_nested_scope(get_object<ScopeDescriptor>(ip[0]), nullptr);
+			ip += 1;
+			VM_NEXT();
+		}
+
+		VM_CASE(LEAVE_SCOPE) {
+			for (std::size_t i = ip[0]; i; --i) cur_scope = cur_scope->get_outer_scope();
+			ip += 1;
+			VM_NEXT();
+		}
+
+		VM_CASE(RESET_FIELDS) {
+			cur_scope->reset_fields(get_object<ScopeDescriptor>(ip[0]).get());
+			ip += 1;
+			VM_NEXT();
+		}
+
+		VM_CASE(EXIT_BREAK) {
+			return StatementResult(StatementResultType::BREAK);
+		}
+
+		VM_CASE(EXIT_CONTINUE) {
+			return StatementResult(StatementResultType::CONTINUE);
+		}
+
+		VM_CASE(RETURN) {
+			return StatementResult(StatementResultType::RETURN, ValueLoc(regs[ip[0]]));
+		}
+
+		VM_CASE(RETURN_VOID) {
+			return StatementResult(StatementResultType::RETURN, factory->get_void_value());
+		}
+
+		VM_CASE(THROW) {
+			ValueLoc value(regs[ip[0]]);
+			if (!dynamic_cast<ExceptionValue*>(value.get())) {
+				value = ast::ThrowStatement::create_exception_value(get_pc_pos(op_ip - code), value);
+			}
+			return StatementResult::exception(value);
+		}
+
+		VM_CASE(EVAL_AST) {
+			ValueLoc exception;
+			ValueLoc value = get_object<ast::Expression>(ip[1])->evaluate(context, cur_scope, exception);
+			if (!!exception) return StatementResult::exception(exception);
+			regs[ip[0]] = value;
+			ip += 2;
+			VM_NEXT();
+		}
+
+		VM_CASE(EXEC_AST) {
+			StatementResult result = get_object<ast::Statement>(ip[0])->execute(context, cur_scope);
+			StatementResultType type = result.get_type();
+			if (StatementResultType::NONE == type) {
+				ip += 5;
+			} else if (StatementResultType::BREAK == type || StatementResultType::CONTINUE == type) {
+				const CodeWord* target = StatementResultType::BREAK == type ? ip + 1 : ip + 3;
+				if (NO_TARGET == target[0]) return result;
+				for (std::size_t i = target[1]; i; --i) cur_scope = cur_scope->get_outer_scope();
+				ip = code + target[0];
+			} else {
+				return result;
+			}
+			VM_NEXT();
+		}
+
+		VM_CASE(END) {
+			return StatementResult::none();
+		}
+
+#ifndef __GNUC__
+			default:
+				throw SystemError("Invalid opcode");
+			}
+		}
+#endif
+	} catch (const RuntimeError& e) {
+		return StatementResult::exception(ast::ThrowStatement::create_exception_value(get_pc_pos(op_ip - code), e));
+	}
+
+#undef VM_NEXT
+#undef VM_CASE
+}
+
+//
+//CodeLabel
+//
+
+rt::CodeLabel::CodeLabel() : m_pc(SIZE_MAX){}
+
+//
+//CodeCompiler
+//
+
+rt::CodeCompiler::CodeCompiler()
+	: m_register_top(0),
+	m_register_count(0),
+	m_scope_depth(0)
+{}
+
+rt::CodeReg rt::CodeCompiler::allocate_register() {
+	return allocate_registers(1);
+}
+
+rt::CodeReg rt::CodeCompiler::allocate_registers(std::size_t count) {
+	std::size_t reg = m_register_top;
+	m_register_top += count;
+	m_register_count = std::max(m_register_count, m_register_top);
+	return static_cast<CodeReg>(reg);
+}
+
+void rt::CodeCompiler::bind_label(CodeLabel& label) {
+	assert(SIZE_MAX == label.m_pc);
+	label.m_pc = m_code.size();
+	for (std::size_t ref : label.m_references) m_code[ref] = static_cast<CodeWord>(label.m_pc);
+	label.m_references.clear();
+}
+
+void rt::CodeCompiler::begin_loop(CodeLabel& break_label, CodeLabel& continue_label) {
+	LoopInfo loop;
+	loop.m_break_label = &break_label;
+	loop.m_continue_label = &continue_label;
+	loop.m_scope_depth = m_scope_depth;
+	m_loops.push_back(loop);
+}
+
+void rt::CodeCompiler::end_loop() {
+	assert(!m_loops.empty());
+	m_loops.pop_back();
+}
+
+void rt::CodeCompiler::emit_move(CodeReg dst, CodeReg src) {
+	if (dst == src) return;
+	emit_op(Opcode::MOVE);
+	emit_word(dst);
+	emit_word(src);
+}
+
+void rt::CodeCompiler::emit_load_constant(CodeReg dst, const ValueLoc& value) {
+	emit_op(Opcode::LOAD_CONST);
+	emit_word(dst);
+	emit_word(add_constant(value));
+}
+
+void rt::CodeCompiler::emit_load_name(const TextPos& pos, CodeReg dst, const gc::Local<const NameDescriptor>& desc) {
+	std::size_t name_ofs = desc->get_field_ofs();
+	if (BAD_OFS == name_ofs) {
+		emit_op(pos, Opcode::LOAD_NAME);
+		emit_word(dst);
+		emit_word(add_object(desc));
+	} else {
+		emit_op(pos, Opcode::LOAD_VAR);
+		emit_word(dst);
+		emit_word(desc->get_scope_ofs());
+		emit_word(name_ofs);
+	}
+}
+
+void rt::CodeCompiler::emit_load_variable(CodeReg dst, const NameDescriptor* desc) {
+	assert(BAD_OFS != desc->get_field_ofs());
+	emit_op(Opcode::LOAD_VAR_RAW);
+	emit_word(dst);
+	emit_word(desc->get_scope_ofs());
+	emit_word(desc->get_field_ofs());
+}
+
+void rt::CodeCompiler::emit_store_variable(const NameDescriptor* desc, CodeReg src) {
+	assert(DeclarationType::VARIABLE == desc->get_declaration_type());
+	emit_op(Opcode::STORE_VAR);
+	emit_word(src);
+	emit_word(desc->get_scope_ofs());
+	emit_word(desc->get_field_ofs());
+}
+
+void rt::CodeCompiler::emit_initialize(const NameDescriptor* desc, CodeReg src) {
+	assert(BAD_OFS != desc->get_field_ofs());
+	emit_op(Opcode::INIT_VAR);
+	emit_word(src);
+	emit_word(desc->get_scope_ofs());
+	emit_word(desc->get_field_ofs());
+}
+
+void rt::CodeCompiler::emit_load_this(const TextPos& pos, CodeReg dst, std::size_t scope_ofs) {
+	emit_op(pos, Opcode::LOAD_THIS);
+	emit_word(dst);
+	emit_word(scope_ofs);
+}
+
+void rt::CodeCompiler::emit_unary(const TextPos& pos, const UnaryOperator* op, CodeReg dst, CodeReg a) {
+	Opcode opcode;
+	if (&PlusUnaryOperator::Instance == op) {
+		opcode = Opcode::PLUS;
+	} else if (&MinusUnaryOperator::Instance == op) {
+		opcode = Opcode::NEG;
+	} else if (&LogicalNotUnaryOperator::Instance == op) {
+		opcode = Opcode::NOT;
+	} else {
+		throw SystemError(pos, "Invalid unary operator");
+	}
+
+	emit_op(pos, opcode);
+	emit_word(dst);
+	emit_word(a);
+}
+
+void rt::CodeCompiler::emit_binary_short(
+	const TextPos& pos,
+	const BinaryOperator* op,
+	CodeReg dst,
+	CodeReg a,
+	CodeLabel& end)
+{
+	Opcode opcode;
+	if (&LogicalAndBinaryOperator::Instance == op) {
+		opcode = Opcode::SHORT_AND;
+	} else if (&LogicalOrBinaryOperator::Instance == op) {
+		opcode = Opcode::SHORT_OR;
+	} else {
+		//Not a short-circuit operator.
+		return;
+	}
+
+	emit_op(pos, opcode);
+	emit_word(dst);
+	emit_word(a);
+	emit_label(end);
+}
+
+void rt::CodeCompiler::emit_binary(const TextPos& pos, const BinaryOperator* op, CodeReg dst, CodeReg a, CodeReg b) {
+	static const struct {
+		const BinaryOperator* m_op;
+		Opcode m_opcode;
+	} opcodes[] = {
+		{ &AddBinaryOperator::Instance, Opcode::ADD },
+		{ &SubBinaryOperator::Instance, Opcode::SUB },
+		{ &MulBinaryOperator::Instance, Opcode::MUL },
+		{ &DivBinaryOperator::Instance, Opcode::DIV },
+		{ &ModBinaryOperator::Instance, Opcode::MOD },
+		{ &LogicalAndBinaryOperator::Instance, Opcode::AND },
+		{ &LogicalOrBinaryOperator::Instance, Opcode::OR },
+		{ &EqBinaryOperator::Instance, Opcode::EQ },
+		{ &NeBinaryOperator::Instance, Opcode::NE },
+		{ &LtBinaryOperator::Instance, Opcode::LT },
+		{ &GtBinaryOperator::Instance, Opcode::GT },
+		{ &LeBinaryOperator::Instance, Opcode::LE },
+		{ &GeBinaryOperator::Instance, Opcode::GE }
+	};
+
+	for (const auto& entry : opcodes) {
+		if (entry.m_op == op) {
+			emit_op(pos, entry.m_opcode);
+			emit_word(dst);
+			emit_word(a);
+			emit_word(b);
+			return;
+		}
+	}
+
+	throw SystemError(pos, "Invalid binary operator");
+}
+
+void rt::CodeCompiler::emit_increment(
+	const TextPos& pos,
+	bool increment,
+	bool postfix,
+	CodeReg old_value,
+	CodeReg new_value,
+	CodeReg result)
+{
+	emit_op(pos, increment ? Opcode::INC : Opcode::DEC);
+	emit_word(old_value);
+	emit_word(new_value);
+	emit_word(result);
+	emit_word(postfix);
+}
+
+void rt::CodeCompiler::emit_check_assign(const TextPos& pos, CodeReg src) {
+	emit_op(pos, Opcode::CHECK_ASSIGN);
+	emit_word(src);
+}
+
+void rt::CodeCompiler::emit_check_initialize(const TextPos& pos, CodeReg src) {
+	emit_op(pos, Opcode::CHECK_INIT);
+	emit_word(src);
+}
+
+void rt::CodeCompiler::emit_get_member(
+	const TextPos& pos,
+	CodeReg dst,
+	CodeReg object,
+	const gc::Local<const NameInfo>& name)
+{
+	emit_op(pos, Opcode::GET_MEMBER);
+	emit_word(dst);
+	emit_word(object);
+	emit_word(add_object(name));
+	emit_word(add_object(gc::create<MemberCache>()));
+}
+
+void rt::CodeCompiler::emit_set_member(
+	const TextPos& pos,
+	CodeReg object,
+	const gc::Local<const NameInfo>& name,
+	CodeReg src)
+{
+	emit_op(pos, Opcode::SET_MEMBER);
+	emit_word(object);
+	emit_word(add_object(name));
+	emit_word(src);
+	emit_word(add_object(gc::create<MemberCache>()));
+}
+
+void rt::CodeCompiler::emit_get_element(const TextPos& pos, CodeReg dst, CodeReg array, CodeReg index) {
+	emit_op(pos, Opcode::GET_ELEM);
+	emit_word(dst);
+	emit_word(array);
+	emit_word(index);
+}
+
+void rt::CodeCompiler::emit_set_element(const TextPos& pos, CodeReg array, CodeReg index, CodeReg src) {
+	emit_op(pos, Opcode::SET_ELEM);
+	emit_word(array);
+	emit_word(index);
+	emit_word(src);
+}
+
+void rt::CodeCompiler::emit_invoke(
+	const TextPos& pos,
+	CodeReg dst,
+	CodeReg function,
+	CodeReg arguments,
+	std::size_t count)
+{
+	emit_op(pos, Opcode::CALL);
+	emit_word(dst);
+	emit_word(function);
+	emit_word(arguments);
+	emit_word(count);
+	emit_word(m_positions.size() - 1);
+}
+
+void rt::CodeCompiler::emit_invoke_member(
+	const TextPos& pos,
+	CodeReg dst,
+	CodeReg object,
+	const gc::Local<const NameInfo>& name,
+	CodeReg arguments,
+	std::size_t count)
+{
+	emit_op(pos, Opcode::CALL_MEMBER);
+	emit_word(dst);
+	emit_word(object);
+	emit_word(add_object(name));
+	emit_word(arguments);
+	emit_word(count);
+	emit_word(add_object(gc::create<MemberCache>()));
+	emit_word(m_positions.size() - 1);
+}
+
+void rt::CodeCompiler::emit_instantiate(
+	const TextPos& pos,
+	CodeReg dst,
+	CodeReg type,
+	CodeReg arguments,
+	std::size_t count)
+{
+	emit_op(pos, Opcode::NEW);
+	emit_word(dst);
+	emit_word(type);
+	emit_word(arguments);
+	emit_word(count);
+	emit_word(m_positions.size() - 1);
+}
+
+void rt::CodeCompiler::emit_new_array(const TextPos& pos, CodeReg dst, CodeReg length) {
+	emit_op(pos, Opcode::NEW_ARRAY);
+	emit_word(dst);
+	emit_word(length);
+}
+
+void rt::CodeCompiler::emit_array(CodeReg dst, CodeReg elements, std::size_t count) {
+	emit_op(Opcode::MAKE_ARRAY);
+	emit_word(dst);
+	emit_word(elements);
+	emit_word(count);
+}
+
+void rt::CodeCompiler::emit_function(CodeReg dst, const gc::Local<ast::FunctionExpression>& expression) {
+	emit_op(Opcode::MAKE_FUNCTION);
+	emit_word(dst);
+	emit_word(add_object(expression));
+}
+
+void rt::CodeCompiler::emit_class(CodeReg dst, const gc::Local<ast::ClassExpression>& expression) {
+	emit_op(Opcode::MAKE_CLASS);
+	emit_word(dst);
+	emit_word(add_object(expression));
+}
+
+void rt::CodeCompiler::emit_typeof(const TextPos& pos, CodeReg dst, CodeReg src) {
+	emit_op(pos, Opcode::TYPEOF);
+	emit_word(dst);
+	emit_word(src);
+}
+
+void rt::CodeCompiler::emit_jump(CodeLabel& label) {
+	emit_op(Opcode::JUMP);
+	emit_label(label);
+}
+
+void rt::CodeCompiler::emit_loop(CodeLabel& label) {
+	emit_op(Opcode::LOOP);
+	emit_label(label);
+}
+
+void rt::CodeCompiler::emit_jump_if_false(const TextPos& pos, CodeReg condition, CodeLabel& label) {
+	emit_op(pos, Opcode::JUMP_FALSE);
+	emit_word(condition);
+	emit_label(label);
+}
+
+void rt::CodeCompiler::emit_enter_scope(const gc::Local<ScopeDescriptor>& desc) {
+	if (desc->is_flattened()) {
+		if (desc->get_size()) {
+			emit_op(Opcode::RESET_FIELDS);
+			emit_word(add_object(desc));
+		}
+		return;
+	}
+
+	emit_op(Opcode::ENTER_SCOPE);
+	emit_word(add_object(desc));
+	++m_scope_depth;
+}
+
+void rt::CodeCompiler::emit_leave_scope(const gc::Local<ScopeDescriptor>& desc) {
+	if (desc->is_flattened()) return;
+	assert(m_scope_depth > 0);
+	--m_scope_depth;
+	emit_leave_scopes(1);
+}
+
+void rt::CodeCompiler::emit_break() {
+	const LoopInfo* loop = m_loops.empty() ? nullptr : &m_loops.back();
+	emit_loop_jump(loop, loop ? loop->m_break_label : nullptr, Opcode::EXIT_BREAK);
+}
+
+void rt::CodeCompiler::emit_continue() {
+	const LoopInfo* loop = m_loops.empty() ? nullptr : &m_loops.back();
+	emit_loop_jump(loop, loop ? loop->m_continue_label : nullptr, Opcode::EXIT_CONTINUE);
+}
+
+void rt::CodeCompiler::emit_return(CodeReg src) {
+	emit_op(Opcode::RETURN);
+	emit_word(src);
+}
+
+void rt::CodeCompiler::emit_return_void() {
+	emit_op(Opcode::RETURN_VOID);
+}
+
+void rt::CodeCompiler::emit_throw(const TextPos& pos, CodeReg src) {
+	emit_op(pos, Opcode::THROW);
+	emit_word(src);
+}
+
+void rt::CodeCompiler::emit_evaluate(CodeReg dst, const gc::Local<ast::Expression>& expression) {
+	emit_op(Opcode::EVAL_AST);
+	emit_word(dst);
+	emit_word(add_object(expression));
+}
+
+void rt::CodeCompiler::emit_execute(const gc::Local<ast::Statement>& statement) {
+	emit_op(Opcode::EXEC_AST);
+	emit_word(add_object(statement));
+
+	if (m_loops.empty()) {
+		emit_word(NO_TARGET);
+		emit_word(0);
+		emit_word(NO_TARGET);
+		emit_word(0);
+	} else {
+		const LoopInfo& loop = m_loops.back();
+		std::size_t leave_count = m_scope_depth - loop.m_scope_depth;
+		emit_label(*loop.m_break_label);
+		emit_word(leave_count);
+		emit_label(*loop.m_continue_label);
+		emit_word(leave_count);
+	}
+}
+
+gc::Local<rt::CodeBlock> rt::CodeCompiler::create_code_block() {
+	assert(m_loops.empty());
+	assert(!m_scope_depth);
+	emit_op(Opcode::END);
+
+	gc::Local<gc::PrimitiveArray<CodeWord>> code = gc::PrimitiveArray<CodeWord>::create(m_code.size());
+	code->set(0, m_code.data(), 0, m_code.size());
+
+	gc::Local<ValueArray> constants = ValueArray::create(m_constants.size());
+	for (std::size_t i = 0, n = m_constants.size(); i < n; ++i) constants->get(i) = m_constants[i];
+
+	gc::Local<gc::Array<gc::Object>> objects = gc::Array<gc::Object>::create(m_objects.size());
+	for (std::size_t i = 0, n = m_objects.size(); i < n; ++i) (*objects)[i] = m_objects[i].stat_cast_ex<gc::Object>();
+
+	std::size_t pos_count = m_pos_pcs.size();
+	gc::Local<gc::PrimitiveArray<CodeWord>> pos_pcs = gc::PrimitiveArray<CodeWord>::create(pos_count);
+	gc::Local<gc::PrimitiveArray<TextPos>> positions = gc::PrimitiveArray<TextPos>::create(pos_count);
+	if (pos_count) {
+		pos_pcs->set(0, m_pos_pcs.data(), 0, pos_count);
+		positions->set(0, m_positions.data(), 0, pos_count);
+	}
+
+	//At least one register, so that the register window is never empty.
+	std::size_t register_count = std::max(m_register_count, std::size_t(1));
+	return gc::create<CodeBlock>(code, constants, objects, pos_pcs, positions, register_count);
+}
+
+void rt::CodeCompiler::emit_op(Opcode op) {
+	m_code.push_back(static_cast<CodeWord>(op));
+}
+
+void rt::CodeCompiler::emit_op(const TextPos& pos, Opcode op) {
+	add_position(pos);
+	emit_op(op);
+}
+
+void rt::CodeCompiler::emit_word(std::size_t word) {
+	assert(word <= std::numeric_limits<CodeWord>::max());
+	m_code.push_back(static_cast<CodeWord>(word));
+}
+
+void rt::CodeCompiler::emit_label(CodeLabel& label) {
+	if (SIZE_MAX == label.m_pc) {
+		label.m_references.push_back(m_code.size());
+		emit_word(NO_TARGET);
+	} else {
+		emit_word(label.m_pc);
+	}
+}
+
+void rt::CodeCompiler::emit_leave_scopes(std::size_t count) {
+	if (!count) return;
+	emit_op(Opcode::LEAVE_SCOPE);
+	emit_word(count);
+}
+
+void rt::CodeCompiler::emit_loop_jump(const LoopInfo* loop, CodeLabel* label, Opcode exit_op) {
+	if (!loop) {
+		//The loop is executed by the AST interpreter: exit the code block with the corresponding result.
+		emit_op(exit_op);
+	} else {
+		emit_leave_scopes(m_scope_depth - loop->m_scope_depth);
+		emit_jump(*label);
+	}
+}
+
+rt::CodeWord rt::CodeCompiler::add_constant(const ValueLoc& value) {
+	m_constants.push_back(value);
+	return static_cast<CodeWord>(m_constants.size() - 1);
+}
+
+rt::CodeWord rt::CodeCompiler::add_object(const gc::Local<const gc::Object>& object) {
+	m_objects.push_back(object);
+	return static_cast<CodeWord>(m_objects.size() - 1);
+}
+
+rt::CodeWord rt::CodeCompiler::add_position(const TextPos& pos) {
+	m_pos_pcs.push_back(static_cast<CodeWord>(m_code.size()));
+	m_positions.push_back(pos);
+	return static_cast<CodeWord>(m_positions.size() - 1);
+}
+
+//
+//CodeRegisterGuard
+//
+
+rt::CodeRegisterGuard::CodeRegisterGuard(CodeCompiler* compiler)
+	: m_compiler(compiler),
+	m_register_top(compiler->m_register_top)
+{}
+
+rt::CodeRegisterGuard::~CodeRegisterGuard() {
+	m_compiler->m_register_top = m_register_top;
+}
+
+//
+//CodeModifier
+//
+
+bool rt::CodeModifier::compile_short(CodeCompiler* compiler, CodeReg result, CodeReg* new_value) {
+	return false;
+}
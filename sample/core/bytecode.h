@@ -0,0 +1,252 @@
+/*
+ * Copyright 2014 Anton Karmanov
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//Bytecode compiler and virtual machine.
+
+#ifndef SYNSAMPLE_CORE_BYTECODE_H_INCLUDED
+#define SYNSAMPLE_CORE_BYTECODE_H_INCLUDED
+
+#include <vector>
+
+#include "ast__dec.h"
+#include "bytecode__dec.h"
+#include "common.h"
+#include "gc.h"
+#include "name__dec.h"
+#include "noncopyable.h"
+#include "op.h"
+#include "scope.h"
+#include "value__dec.h"
+#include "value_handle.h"
+
+/*
+A bound block is compiled into a CodeBlock: a script right after binding, a function body on its first execution.
+Temporary values live in registers, which are slots of a per-thread contiguous value stack (see value_stack.h);
+call arguments are evaluated into consecutive registers and passed to the callee as an ArgSpan over them. Variables
+stay in ExecScope objects, since they may be captured by closures. Blocks which are not captured are flattened into
+the enclosing scope by the binder, so entering them only resets their variables. Nodes which have no bytecode form
+(try and for-each statements, class member initializers) are executed by the AST interpreter, called from the
+bytecode; blocks nested in them are compiled as separate units.
+*/
+
+namespace syn_script {
+	namespace rt {
+
+		//
+		//CodeBlock
+		//
+
+		class CodeBlock : public gc::Object {
+			NONCOPYABLE(CodeBlock);
+
+			gc::Ref<gc::PrimitiveArray<CodeWord>> m_code;
+			gc::Ref<ValueArray> m_constants;
+			gc::Ref<gc::Array<gc::Object>> m_objects;
+			gc::Ref<gc::PrimitiveArray<CodeWord>> m_pos_pcs;
+			gc::Ref<gc::PrimitiveArray<TextPos>> m_positions;
+			std::size_t m_register_count;
+
+		public:
+			CodeBlock(){}
+			void gc_enumerate_refs() override;
+
+			void initialize(
+				const gc::Local<gc::PrimitiveArray<CodeWord>>& code,
+				const gc::Local<ValueArray>& constants,
+				const gc::Local<gc::Array<gc::Object>>& objects,
+				const gc::Local<gc::PrimitiveArray<CodeWord>>& pos_pcs,
+				const gc::Local<gc::PrimitiveArray<TextPos>>& positions,
+				std::size_t register_count);
+
+			StatementResult execute(const gc::Local<ExecContext>& context, const gc::Local<ExecScope>& scope);
+
+		private:
+			template<class T> gc::Local<T> get_object(CodeWord index) const;
+
+			//Returns the position of the instruction at the given pc.
+			TextPos get_pc_pos(std::size_t pc) const;
+		};
+
+		//
+		//CodeLabel
+		//
+
+		//Jump target. May be referenced before it is bound.
+		class CodeLabel {
+			NONCOPYABLE(CodeLabel);
+
+			friend class CodeCompiler;
+
+			std::size_t m_pc;
+			std::vector<std::size_t> m_references;
+
+		public:
+			CodeLabel();
+		};
+
+		//
+		//CodeCompiler
+		//
+
+		class CodeCompiler {
+			NONCOPYABLE(CodeCompiler);
+
+			friend class CodeRegisterGuard;
+
+			struct LoopInfo {
+				CodeLabel* m_break_label;
+				CodeLabel* m_continue_label;
+				std::size_t m_scope_depth;
+			};
+
+			std::vector<CodeWord> m_code;
+			std::vector<ValueLoc> m_constants;
+			std::vector<gc::Local<const gc::Object>> m_objects;
+			std::vector<CodeWord> m_pos_pcs;
+			std::vector<TextPos> m_positions;
+			std::vector<LoopInfo> m_loops;
+			std::size_t m_register_top;
+			std::size_t m_register_count;
+			std::size_t m_scope_depth;
+
+		public:
+			CodeCompiler();
+
+			CodeReg allocate_register();
+			CodeReg allocate_registers(std::size_t count);
+
+			void bind_label(CodeLabel& label);
+			void begin_loop(CodeLabel& break_label, CodeLabel& continue_label);
+			void end_loop();
+
+			void emit_move(CodeReg dst, CodeReg src);
+			void emit_load_constant(CodeReg dst, const ValueLoc& value);
+			void emit_load_name(const TextPos& pos, CodeReg dst, const gc::Local<const NameDescriptor>& desc);
+			void emit_load_variable(CodeReg dst, const NameDescriptor* desc);
+			void emit_store_variable(const NameDescriptor* desc, CodeReg src);
+			void emit_initialize(const NameDescriptor* desc, CodeReg src);
+			void emit_load_this(const TextPos& pos, CodeReg dst, std::size_t scope_ofs);
+
+			void emit_unary(const TextPos& pos, const UnaryOperator* op, CodeReg dst, CodeReg a);
+			void emit_binary_short(const TextPos& pos, const BinaryOperator* op, CodeReg dst, CodeReg a, CodeLabel& end);
+			void emit_binary(const TextPos& pos, const BinaryOperator* op, CodeReg dst, CodeReg a, CodeReg b);
+
+			void emit_increment(
+				const TextPos& pos,
+				bool increment,
+				bool postfix,
+				CodeReg old_value,
+				CodeReg new_value,
+				CodeReg result);
+
+			void emit_check_assign(const TextPos& pos, CodeReg src);
+			void emit_check_initialize(const TextPos& pos, CodeReg src);
+
+			void emit_get_member(const TextPos& pos, CodeReg dst, CodeReg object, const gc::Local<const NameInfo>& name);
+			void emit_set_member(const TextPos& pos, CodeReg object, const gc::Local<const NameInfo>& name, CodeReg src);
+			void emit_get_element(const TextPos& pos, CodeReg dst, CodeReg array, CodeReg index);
+			void emit_set_element(const TextPos& pos, CodeReg array, CodeReg index, CodeReg src);
+
+			void emit_invoke(const TextPos& pos, CodeReg dst, CodeReg function, CodeReg arguments, std::size_t count);
+
+			void emit_invoke_member(
+				const TextPos& pos,
+				CodeReg dst,
+				CodeReg object,
+				const gc::Local<const NameInfo>& name,
+				CodeReg arguments,
+				std::size_t count);
+
+			void emit_instantiate(const TextPos& pos, CodeReg dst, CodeReg type, CodeReg arguments, std::size_t count);
+			void emit_new_array(const TextPos& pos, CodeReg dst, CodeReg length);
+			void emit_array(CodeReg dst, CodeReg elements, std::size_t count);
+			void emit_function(CodeReg dst, const gc::Local<ast::FunctionExpression>& expression);
+			void emit_class(CodeReg dst, const gc::Local<ast::ClassExpression>& expression);
+			void emit_typeof(const TextPos& pos, CodeReg dst, CodeReg src);
+
+			void emit_jump(CodeLabel& label);
+			void emit_loop(CodeLabel& label);
+			void emit_jump_if_false(const TextPos& pos, CodeReg condition, CodeLabel& label);
+			void emit_enter_scope(const gc::Local<ScopeDescriptor>& desc);
+			void emit_leave_scope(const gc::Local<ScopeDescriptor>& desc);
+			void emit_break();
+			void emit_continue();
+			void emit_return(CodeReg src);
+			void emit_return_void();
+			void emit_throw(const TextPos& pos, CodeReg src);
+
+			//Evaluates an expression or executes a statement by the AST interpreter.
+			void emit_evaluate(CodeReg dst, const gc::Local<ast::Expression>& expression);
+			void emit_execute(const gc::Local<ast::Statement>& statement);
+
+			gc::Local<CodeBlock> create_code_block();
+
+		private:
+			void emit_op(Opcode op);
+			void emit_op(const TextPos& pos, Opcode op);
+			void emit_word(std::size_t word);
+			void emit_label(CodeLabel& label);
+			void emit_leave_scopes(std::size_t count);
+			void emit_loop_jump(const LoopInfo* loop, CodeLabel* label, Opcode exit_op);
+			CodeWord add_constant(const ValueLoc& value);
+			CodeWord add_object(const gc::Local<const gc::Object>& object);
+			CodeWord add_position(const TextPos& pos);
+		};
+
+		//
+		//CodeRegisterGuard
+		//
+
+		//Releases registers allocated within the guard's lifetime.
+		class CodeRegisterGuard {
+			NONCOPYABLE(CodeRegisterGuard);
+
+			CodeCompiler* const m_compiler;
+			const std::size_t m_register_top;
+
+		public:
+			explicit CodeRegisterGuard(CodeCompiler* compiler);
+			~CodeRegisterGuard();
+		};
+
+		//
+		//CodeModifier
+		//
+
+		//Compile-time counterpart of ValueModifier: emits code which calculates the new value of an lvalue.
+		class CodeModifier {
+			NONCOPYABLE(CodeModifier);
+
+		protected:
+			CodeModifier(){}
+
+		public:
+			//Emits code which does not need the old value and sets the register which holds the new value. Returns
+			//false (emitting nothing) if the old value is needed.
+			virtual bool compile_short(CodeCompiler* compiler, CodeReg result, CodeReg* new_value);
+
+			virtual void compile(
+				CodeCompiler* compiler,
+				const TextPos& pos,
+				CodeReg old_value,
+				CodeReg new_value,
+				CodeReg result) = 0;
+		};
+
+	}
+}
+
+#endif//SYNSAMPLE_CORE_BYTECODE_H_INCLUDED
@@ -0,0 +1,41 @@
+/*
+ * Copyright 2014 Anton Karmanov
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//Declarations of bytecode-related classes.
+
+#ifndef SYNSAMPLE_CORE_BYTECODE_DEC_H_INCLUDED
+#define SYNSAMPLE_CORE_BYTECODE_DEC_H_INCLUDED
+
+#include <cstdint>
+
+namespace syn_script {
+	namespace rt {
+
+		typedef std::uint32_t CodeWord;
+		typedef CodeWord CodeReg;
+
+		enum class Opcode : CodeWord;
+
+		class CodeBlock;
+		class CodeLabel;
+		class CodeCompiler;
+		class CodeModifier;
+		class CodeRegisterGuard;
+
+	}
+}
+
+#endif//SYNSAMPLE_CORE_BYTECODE_DEC_H_INCLUDED
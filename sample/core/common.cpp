@@ -16,8 +16,15 @@
 
 //Common classes.
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "common.h"
 #include "gc.h"
@@ -30,52 +37,191 @@ namespace gc = ss::gc;
 //TextPos
 //
 
-void ss::TextPos::gc_enumerate_refs() {
-	gc_ref(m_file_name);
+const std::string& ss::TextPos::file_name() const {
+	return SourceInfo::get_source(m_source)->file_name();
 }
 
-void ss::TextPos::initialize(const StringLoc& file_name, int line, int column) {
-	m_file_name = file_name;
-	m_line = line;
-	m_column = column;
+int ss::TextPos::line() const {
+	return SourceInfo::get_source(m_source)->get_line(m_offset);
+}
+
+int ss::TextPos::column() const {
+	return SourceInfo::get_source(m_source)->get_column(m_offset);
 }
 
-ss::StringLoc ss::TextPos::file_name() const {
+std::ostream& ss::operator<<(std::ostream& out, const TextPos& text_pos) {
+	if (!text_pos) {
+		out << "?";
+	} else {
+		out << text_pos.file_name() << "(" << (text_pos.line() + 1) << ")";
+	}
+	return out;
+}
+
+//
+//SourceInfo
+//
+
+namespace {
+	//Sources are stored in segments, which are allocated as needed and never moved, so a source can be looked
+	//up without locking. Indexes of deleted sources are reused, so only the number of sources referenced at
+	//the same time is limited.
+	const std::size_t SOURCE_SEGMENT_SIZE = (std::size_t)1 << 12;
+	const std::size_t MAX_SOURCE_SEGMENTS = (std::size_t)1 << 14;
+
+	typedef std::atomic<ss::SourceInfo*> SourceSlot;
+
+	std::atomic<SourceSlot*> g_source_segments[MAX_SOURCE_SEGMENTS];
+
+	//Number of used slots, free slots and indexes of sources by file name. Guarded by the mutex.
+	std::mutex g_sources_mutex;
+	std::size_t g_sources_count = 0;
+	std::vector<std::uint32_t> g_free_sources;
+	std::unordered_multimap<std::string, std::uint32_t> g_source_index_map;
+
+	SourceSlot& get_source_slot(std::uint32_t source) {
+		const std::size_t index = source - 1;
+		SourceSlot* segment = g_source_segments[index / SOURCE_SEGMENT_SIZE].load(std::memory_order_acquire);
+		return segment[index % SOURCE_SEGMENT_SIZE];
+	}
+
+	//Must be called with the mutex locked.
+	std::uint32_t allocate_source_slot() {
+		if (!g_free_sources.empty()) {
+			std::uint32_t source = g_free_sources.back();
+			g_free_sources.pop_back();
+			return source;
+		}
+
+		if (g_sources_count == SOURCE_SEGMENT_SIZE * MAX_SOURCE_SEGMENTS) {
+			throw ss::CompilationError("Too many source files");
+		}
+
+		if (!(g_sources_count % SOURCE_SEGMENT_SIZE)) {
+			SourceSlot* segment = new SourceSlot[SOURCE_SEGMENT_SIZE]();
+			g_source_segments[g_sources_count / SOURCE_SEGMENT_SIZE].store(segment, std::memory_order_release);
+		}
+
+		return static_cast<std::uint32_t>(++g_sources_count);
+	}
+
+	//Must be called with the mutex locked.
+	void delete_source(std::uint32_t source, ss::SourceInfo* info) {
+		auto range = g_source_index_map.equal_range(info->file_name());
+		for (auto iter = range.first; iter != range.second; ++iter) {
+			if (iter->second == source) {
+				g_source_index_map.erase(iter);
+				break;
+			}
+		}
+
+		get_source_slot(source).store(nullptr, std::memory_order_relaxed);
+		g_free_sources.push_back(source);
+		delete info;
+	}
+}
+
+ss::SourceInfo::SourceInfo(const std::string& file_name, std::vector<std::uint32_t>&& line_starts)
+: m_file_name(file_name),
+m_line_starts(std::move(line_starts)),
+m_ref_count(1)
+{}
+
+const std::string& ss::SourceInfo::file_name() const {
 	return m_file_name;
 }
 
-int ss::TextPos::line() const {
-	return m_line;
+int ss::SourceInfo::get_line(std::uint32_t offset) const {
+	auto iter = std::upper_bound(m_line_starts.begin(), m_line_starts.end(), offset);
+	return static_cast<int>(iter - m_line_starts.begin());
 }
 
-int ss::TextPos::column() const {
-	return m_column;
+int ss::SourceInfo::get_column(std::uint32_t offset) const {
+	int line = get_line(offset);
+	return static_cast<int>(offset - (line ? m_line_starts[line - 1] : 0));
 }
 
-ss::TextPos::operator bool() const {
-	return !!m_file_name;
+const ss::SourceInfo* ss::SourceInfo::get_source(std::uint32_t source) {
+	assert(source && source <= SOURCE_SEGMENT_SIZE * MAX_SOURCE_SEGMENTS);
+	const SourceInfo* info = get_source_slot(source).load(std::memory_order_acquire);
+	assert(info);
+	return info;
 }
 
-namespace {
-	void print_text_pos(std::ostream& out, const ss::TextPos* text_pos) {
-		if (!text_pos) {
-			out << "?";
-		} else {
-			out << text_pos->file_name();
-			int line = text_pos->line();
-			if (line != -1) out << "(" << (line + 1) << ")";
+//
+//SourceRef
+//
+
+ss::SourceRef::SourceRef(const TextPos& pos)
+: m_source(pos.m_source)
+{
+	add_ref();
+}
+
+ss::SourceRef::SourceRef(const SourceRef& ref)
+: m_source(ref.m_source)
+{
+	add_ref();
+}
+
+ss::SourceRef::~SourceRef() {
+	release();
+}
+
+ss::SourceRef& ss::SourceRef::operator=(const SourceRef& ref) {
+	ref.add_ref();
+	release();
+	m_source = ref.m_source;
+	return *this;
+}
+
+ss::TextPos ss::SourceRef::get_pos(std::uint32_t offset) const {
+	assert(m_source);
+	return TextPos(m_source, offset);
+}
+
+ss::SourceRef ss::SourceRef::register_source(
+	const std::string& file_name,
+	std::vector<std::uint32_t>&& line_starts)
+{
+	std::lock_guard<std::mutex> lock(g_sources_mutex);
+
+	//Positions depend only on the file name and the line starts, so an equal source can be shared.
+	auto range = g_source_index_map.equal_range(file_name);
+	for (auto iter = range.first; iter != range.second; ++iter) {
+		std::uint32_t source = iter->second;
+		SourceInfo* info = get_source_slot(source).load(std::memory_order_relaxed);
+		if (info->m_line_starts == line_starts) {
+			info->m_ref_count.fetch_add(1, std::memory_order_relaxed);
+			return SourceRef(source);
 		}
 	}
+
+	std::uint32_t source = allocate_source_slot();
+	SourceInfo* info = new SourceInfo(file_name, std::move(line_starts));
+	get_source_slot(source).store(info, std::memory_order_release);
+	g_source_index_map.emplace(file_name, source);
+	return SourceRef(source);
 }
 
-std::ostream& ss::operator<<(std::ostream& out, const gc::Local<TextPos>& text_pos) {
-	print_text_pos(out, text_pos.get());
-	return out;
+void ss::SourceRef::add_ref() const {
+	if (!m_source) return;
+	SourceInfo* info = get_source_slot(m_source).load(std::memory_order_relaxed);
+	info->m_ref_count.fetch_add(1, std::memory_order_relaxed);
 }
 
-std::ostream& ss::operator<<(std::ostream& out, const gc::Ref<TextPos>& text_pos) {
-	print_text_pos(out, text_pos.get());
-	return out;
+void ss::SourceRef::release() const {
+	if (!m_source) return;
+	SourceInfo* info = get_source_slot(m_source).load(std::memory_order_relaxed);
+
+	std::size_t count = info->m_ref_count.load(std::memory_order_relaxed);
+	while (count > 1) {
+		if (info->m_ref_count.compare_exchange_weak(count, count - 1, std::memory_order_release)) return;
+	}
+
+	//The last reference is released with the mutex locked, since an equal source may be registered concurrently.
+	std::lock_guard<std::mutex> lock(g_sources_mutex);
+	if (info->m_ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1) delete_source(m_source, info);
 }
 
 //
@@ -90,15 +236,15 @@ ss::BasicError::BasicError(const std::string& msg)
 : m_msg(msg)
 {}
 
-ss::BasicError::BasicError(const gc::Local<TextPos>& pos, const char* msg)
-: m_pos(pos), m_msg(msg)
+ss::BasicError::BasicError(const TextPos& pos, const char* msg)
+: m_pos(pos), m_source(pos), m_msg(msg)
 {}
 
-ss::BasicError::BasicError(const gc::Local<TextPos>& pos, const std::string& msg)
-: m_pos(pos), m_msg(msg)
+ss::BasicError::BasicError(const TextPos& pos, const std::string& msg)
+: m_pos(pos), m_source(pos), m_msg(msg)
 {}
 
-gc::Local<ss::TextPos> ss::BasicError::get_pos() const {
+const ss::TextPos& ss::BasicError::get_pos() const {
 	return m_pos;
 }
 
@@ -126,11 +272,11 @@ ss::CompilationError::CompilationError(const std::string& msg)
 : BasicError(msg)
 {}
 
-ss::CompilationError::CompilationError(const gc::Local<TextPos>& pos, const char* msg)
+ss::CompilationError::CompilationError(const TextPos& pos, const char* msg)
 : BasicError(pos, msg)
 {}
 
-ss::CompilationError::CompilationError(const gc::Local<TextPos>& pos, const std::string& msg)
+ss::CompilationError::CompilationError(const TextPos& pos, const std::string& msg)
 : BasicError(pos, msg)
 {}
 
@@ -150,11 +296,11 @@ ss::RuntimeError::RuntimeError(const std::string& msg)
 : BasicError(msg)
 {}
 
-ss::RuntimeError::RuntimeError(const gc::Local<TextPos>& pos, const char* msg)
+ss::RuntimeError::RuntimeError(const TextPos& pos, const char* msg)
 : BasicError(pos, msg)
 {}
 
-ss::RuntimeError::RuntimeError(const gc::Local<TextPos>& pos, const std::string& msg)
+ss::RuntimeError::RuntimeError(const TextPos& pos, const std::string& msg)
 : BasicError(pos, msg)
 {}
 
@@ -182,7 +328,7 @@ ss::SystemError::SystemError(const char* msg)
 : BasicError(msg)
 {}
 
-ss::SystemError::SystemError(const gc::Local<TextPos>& pos, const char* msg)
+ss::SystemError::SystemError(const TextPos& pos, const char* msg)
 : BasicError(pos, msg)
 {}
 
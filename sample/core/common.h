@@ -19,10 +19,13 @@
 #ifndef SYNSAMPLE_CORE_COMMON_H_INCLUDED
 #define SYNSAMPLE_CORE_COMMON_H_INCLUDED
 
+#include <atomic>
 #include <cassert>
+#include <cstdint>
 #include <memory>
 #include <ostream>
 #include <string>
+#include <vector>
 
 #include "gc.h"
 #include "noncopyable.h"
@@ -36,43 +39,103 @@ namespace syn_script {
 	//TextPos
 	//
 
-	class TextPos : public gc::Object {
-		NONCOPYABLE(TextPos);
+	//Position in a source file: an index of the source and a byte offset. The line and the column are
+	//calculated only when needed, from the line start table of the source.
+	class TextPos {
+		friend class SourceRef;
 
-		StringRef m_file_name;
-		int m_line;
-		int m_column;
+		std::uint32_t m_source;
+		std::uint32_t m_offset;
 
 	public:
-		TextPos(){}
-		void gc_enumerate_refs() override;
-		void initialize(const StringLoc& file_name = nullptr, int line = -1, int column = -1);
+		TextPos() : m_source(0), m_offset(0){}
+		TextPos(std::uint32_t source, std::uint32_t offset) : m_source(source), m_offset(offset){}
 
-		StringLoc file_name() const;
+		const std::string& file_name() const;
 		int line() const;
 		int column() const;
 
-		operator bool() const;
+		explicit operator bool() const { return !!m_source; }
 	};
 
-	std::ostream& operator<<(std::ostream& out, const gc::Local<TextPos>& text_pos);
-	std::ostream& operator<<(std::ostream& out, const gc::Ref<TextPos>& text_pos);
+	std::ostream& operator<<(std::ostream& out, const TextPos& text_pos);
+
+	//
+	//SourceInfo
+	//
+
+	//File name and line start offsets of a source file. Positions refer to a source by index. A source remains
+	//registered while there are SourceRef objects referring to it; then it is deleted and its index is reused.
+	//A source with the same file name and the same line starts is shared, so executing the same script
+	//repeatedly does not add sources.
+	class SourceInfo {
+		NONCOPYABLE(SourceInfo);
+
+		friend class SourceRef;
+
+		const std::string m_file_name;
+
+		//Offsets of all lines except the first one, which starts at 0, in ascending order.
+		const std::vector<std::uint32_t> m_line_starts;
+
+		//Number of SourceRef objects referring to the source. It becomes zero only with the sources mutex locked.
+		std::atomic<std::size_t> m_ref_count;
+
+	public:
+		SourceInfo(const std::string& file_name, std::vector<std::uint32_t>&& line_starts);
+
+		const std::string& file_name() const;
+
+		int get_line(std::uint32_t offset) const;
+		int get_column(std::uint32_t offset) const;
+
+		static const SourceInfo* get_source(std::uint32_t source);
+	};
+
+	//
+	//SourceRef
+	//
+
+	//Reference which keeps a source registered. Held by the scanner and by objects which may outlive it and
+	//whose positions are printed: the script AST, function and class expressions, stack trace elements and
+	//errors.
+	class SourceRef {
+		std::uint32_t m_source;
+
+	public:
+		SourceRef() : m_source(0){}
+		explicit SourceRef(const TextPos& pos); //The source must be referenced by another SourceRef.
+		SourceRef(const SourceRef& ref);
+		~SourceRef();
+		SourceRef& operator=(const SourceRef& ref);
+
+		TextPos get_pos(std::uint32_t offset) const;
+
+		static SourceRef register_source(const std::string& file_name, std::vector<std::uint32_t>&& line_starts);
+
+	private:
+		explicit SourceRef(std::uint32_t source) : m_source(source){}
+
+		void add_ref() const;
+		void release() const;
+	};
 
 	//
 	//BasicError
 	//
 
 	class BasicError {
-		const gc::Local<TextPos> m_pos;
+		const TextPos m_pos;
+		const SourceRef m_source;
 		const std::string m_msg;
 
 	public:
 		BasicError(const char* msg);
 		BasicError(const std::string& msg);
-		BasicError(const gc::Local<TextPos>& pos, const char* msg);
-		BasicError(const gc::Local<TextPos>& pos, const std::string& msg);
+		BasicError(const TextPos& pos, const char* msg);
+		BasicError(const TextPos& pos, const std::string& msg);
 
-		gc::Local<TextPos> get_pos() const;
+		const TextPos& get_pos() const;
 		const std::string& get_msg() const;
 		std::string to_string() const;
 
@@ -88,8 +151,8 @@ namespace syn_script {
 	class CompilationError : public BasicError {
 	public:
 		CompilationError(const std::string& msg);
-		CompilationError(const gc::Local<TextPos>& pos, const char* msg);
-		CompilationError(const gc::Local<TextPos>& pos, const std::string& msg);
+		CompilationError(const TextPos& pos, const char* msg);
+		CompilationError(const TextPos& pos, const std::string& msg);
 
 		const char* get_error_type() const override;
 	};
@@ -102,8 +165,8 @@ namespace syn_script {
 	public:
 		RuntimeError(const char* msg);
 		RuntimeError(const std::string& msg);
-		RuntimeError(const gc::Local<TextPos>& pos, const char* msg);
-		RuntimeError(const gc::Local<TextPos>& pos, const std::string& msg);
+		RuntimeError(const TextPos& pos, const char* msg);
+		RuntimeError(const TextPos& pos, const std::string& msg);
 
 		const char* get_error_type() const override;
 	};
@@ -126,7 +189,7 @@ namespace syn_script {
 	class SystemError : public BasicError {
 	public:
 		SystemError(const char* msg);
-		SystemError(const gc::Local<TextPos>& pos, const char* msg);
+		SystemError(const TextPos& pos, const char* msg);
 
 		const char* get_error_type() const override;
 	};
@@ -4,9 +4,9 @@
  * Licensed under the Apache License, Version 2.0 (the "License");
  * you may not use this file except in compliance with the License.
  * You may obtain a copy of the License at
- * 
+ *
  *     http://www.apache.org/licenses/LICENSE-2.0
- * 
+ *
  * Unless required by applicable law or agreed to in writing, software
  * distributed under the License is distributed on an "AS IS" BASIS,
  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
@@ -18,12 +18,20 @@
 
 #include <cassert>
 #include <climits>
+#include <cstddef>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <memory>
 #include <mutex>
+#include <new>
+#include <thread>
 #include <vector>
 
 #include "dbllist.h"
@@ -40,9 +48,73 @@ using ss::util::UnaryScopeGuard;
 
 namespace {
 	const int SIZE_BITS = sizeof(std::size_t) * CHAR_BIT;
-	const std::size_t REACHABLE_FLAG = (std::size_t)1 << (SIZE_BITS - 1);
+	const std::size_t MARK_FLAG = (std::size_t)1 << (SIZE_BITS - 1);
 	const std::size_t MOCK_FLAG = (std::size_t)1 << (SIZE_BITS - 2);
 	const std::size_t SIZE_MASK = MOCK_FLAG - 1;
+
+	//Small objects are allocated in chunks, which are divided into lines. A line is either free, or used by
+	//young objects, or used by old objects.
+	const std::size_t CHUNK_BITS = 16;
+	const std::size_t CHUNK_SIZE = (std::size_t)1 << CHUNK_BITS;
+	const std::size_t LINE_BITS = 6;
+	const std::size_t LINE_SIZE = (std::size_t)1 << LINE_BITS;
+	const std::size_t LINES_PER_CHUNK = CHUNK_SIZE / LINE_SIZE;
+
+	//Larger objects are allocated directly in the old generation.
+	const std::size_t MAX_YOUNG_OBJECT_SIZE = CHUNK_SIZE / 8;
+
+	//Maximum size of the memory area where chunks are allocated.
+	const std::size_t MAX_CHUNK_AREA_SIZE = (std::size_t)256 << 20;
+
+	//Maximum amount of memory which may be used by young objects before a minor collection is performed.
+	const std::size_t MAX_YOUNG_GENERATION_SIZE = (std::size_t)8 << 20;
+
+	//With a pause target, the young generation is sized so that a minor collection is expected to take
+	//1/YOUNG_PAUSE_DIVISOR of the target, but it is not made smaller than MIN_YOUNG_GENERATION_SIZE.
+	const long long YOUNG_PAUSE_DIVISOR = 2;
+	const std::size_t MIN_YOUNG_GENERATION_SIZE = CHUNK_SIZE * 4;
+
+	//The heap limit is never set below this size (unless the maximum heap size is smaller).
+	const std::size_t MIN_HEAP_SIZE = (std::size_t)8 << 20;
+
+	//After a full collection, the heap limit is set to the size of live objects multiplied by this factor.
+	const std::size_t HEAP_GROWTH_FACTOR = 2;
+
+	//A partially used chunk is reused for allocation if it has at least this number of free lines.
+	const std::size_t MIN_RECYCLABLE_LINES = 32;
+
+	const std::size_t OBJECT_ALIGNMENT = alignof(std::max_align_t);
+
+	//A collector thread shares a part of its mark stack with other threads when the stack grows larger
+	//than this number of objects.
+	const std::size_t MIN_SHARED_MARK_STACK_SIZE = 64;
+
+	//During an incremental marking slice, the time is checked after marking this number of objects. Arrays
+	//are marked by parts of MARK_SLICE_ARRAY_PART elements, every part is counted as an object.
+	const std::size_t MARK_SLICE_CHECK_INTERVAL = 64;
+	const std::size_t MARK_SLICE_ARRAY_PART = 64;
+
+	//Pause times statistics: a histogram with buckets of PAUSE_HISTOGRAM_STEP microseconds. Longer pauses
+	//are counted in the last bucket.
+	const long long PAUSE_HISTOGRAM_STEP = 100;
+	const std::size_t PAUSE_HISTOGRAM_SIZE = 1000;
+
+	typedef std::chrono::steady_clock PauseClock;
+
+	//Local references of a thread are stored in blocks of this number of slots (the handle stack).
+	const std::size_t HANDLE_BLOCK_SIZE = 1024;
+
+	//The address of this variable marks a handle stack slot released out of order. Such slots are skipped by
+	//the collector and reclaimed when all slots above them are released.
+	char g_free_handle_marker;
+
+	inline gc::Object* free_handle() {
+		return reinterpret_cast<gc::Object*>(&g_free_handle_marker);
+	}
+
+	std::size_t align_object_size(std::size_t size) {
+		return (size + OBJECT_ALIGNMENT - 1) & ~(OBJECT_ALIGNMENT - 1);
+	}
 }
 
 const std::size_t gc::internal::MAX_SIZE = SIZE_MASK;
@@ -77,14 +149,84 @@ namespace {
 namespace syn_script {
 	namespace gc {
 		struct ThreadStateLinks;
+
+		namespace internal {
+			enum class LineState : unsigned char;
+			struct YoungRun;
+			class CollectorWorker;
+		}
 	}
 }
 
+//
+//LineState
+//
+
+//FREE is zero, so the lines of newly reserved virtual memory are free.
+enum class gc::internal::LineState : unsigned char {
+	FREE,
+	YOUNG,
+	OLD
+};
+
+//
+//Chunk
+//
+
+//A chunk of the small objects area. At any time, a chunk is used as an allocation buffer by at most one thread.
+//Young objects are allocated in runs of free lines by bumping a pointer. Objects which survive a collection are
+//promoted to the old generation in place, and the lines they occupy are not reused until the objects are deleted.
+class gc::internal::Chunk {
+	NONCOPYABLE(Chunk);
+
+public:
+	char* m_begin;
+	LineState* m_lines;
+	std::size_t m_free_lines;
+	Chunk* m_next;
+
+	//true, if old objects of the chunk have not been swept since the last full collection. Such a chunk is
+	//swept when memory is needed, or before the next marking.
+	bool m_unswept;
+
+	//false, if the memory of the chunk has been returned to the OS and has not been used since then.
+	bool m_committed;
+
+	//Head of the list of old objects located in the chunk.
+	gc::Object m_objects_list;
+
+	//Total size of the old objects located in the chunk.
+	std::size_t m_old_size;
+
+	Chunk()
+	: m_begin(nullptr),
+	m_lines(nullptr),
+	m_free_lines(LINES_PER_CHUNK),
+	m_next(nullptr),
+	m_unswept(false),
+	m_committed(false),
+	m_objects_list(true),
+	m_old_size(0)
+	{}
+};
+
+//
+//YoungRun
+//
+
+//A run of lines where young objects have been allocated. Objects are located one after another
+//in the range [m_begin, m_top).
+struct gc::internal::YoungRun {
+	char* m_begin;
+	char* m_top;
+	char* m_end;
+};
+
 //
 //ThreadState
 //
 
-//GC state for a particular thread. 
+//GC state for a particular thread.
 class gc::internal::ThreadState {
 	friend struct gc::ThreadStateLinks;
 
@@ -99,12 +241,35 @@ class gc::internal::ThreadState {
 	//Non-null, if gc::create() is being executed for this thread.
 	void* m_object_being_created;
 
-	//Head of the list of GC roots for this thread (e. g. gc::Local).
-	gc::internal::ObjectListElement m_roots_list;
+	//Handle stack: slots of gc::Local references (GC roots) of this thread. Slots are allocated in blocks which
+	//are never moved. The slots below m_handle_top in the blocks up to m_handle_block are in use.
+	std::vector<std::unique_ptr<gc::Object*[]>> m_handle_blocks;
+	std::size_t m_handle_block;
+	gc::Object** m_handle_top;
+	gc::Object** m_handle_limit;
 
-	//Head of the list of objects created in this thread.
+	//Head of the list of old objects created in this thread.
 	gc::Object m_managed_objects_list;
 
+	//Thread-local allocation buffer: the chunk where young objects of this thread are allocated, the index of
+	//the line where the search of the next free run starts, and the current run.
+	Chunk* m_tlab_chunk;
+	std::size_t m_tlab_line;
+	char* m_tlab_begin;
+	char* m_tlab_top;
+	char* m_tlab_end;
+
+	//Runs of lines where young objects of this thread have been allocated since the last collection.
+	std::vector<YoungRun> m_young_runs;
+
+	//References of old objects which have been set to young objects since the last collection
+	//(the remembered set). Used as roots by a minor collection.
+	std::vector<const InternalRef*> m_remembered_refs;
+
+	//Old objects whose references have been overwritten during incremental marking (the snapshot-at-the-beginning
+	//barrier). They are marked by the next marking slice.
+	std::vector<Object*> m_snapshot_objects;
+
 	pf::Tick_t m_next_sync_tick;
 
 #ifndef NDEBUG
@@ -130,8 +295,18 @@ public:
 	bool is_enabled() const;
 	bool is_creating_new_object() const;
 	const void* get_object_being_created() const;
-	gc::internal::ObjectListElement* get_roots_list();
+	template<class Fn> void enumerate_handles(Fn fn) const;
 	gc::Object* get_managed_objects_list();
+	std::vector<YoungRun>& get_young_runs();
+	std::vector<const InternalRef*>& get_remembered_refs();
+	std::vector<Object*>& get_snapshot_objects();
+
+	Object** add_handle(Object* object);
+	void remove_handle(Object** slot);
+
+	void remember_reference(const InternalRef* ref);
+	void remember_snapshot_object(Object* object);
+	void release_tlab();
 
 	void enable();
 	void disable();
@@ -152,6 +327,11 @@ public:
 private:
 	void set_enabled(bool enabled);
 
+	void* new_allocate_young(std::size_t size);
+	bool take_tlab_run(std::size_t size);
+	void finish_tlab_run();
+	void add_handle_block();
+
 	typedef UnaryScopeGuard<ThreadState, bool, &ThreadState::set_enabled> SetEnabledGuard;
 };
 
@@ -166,6 +346,41 @@ struct gc::ThreadStateLinks {
 		&internal::ThreadState::m_next> ThreadDList0;
 };
 
+//
+//CollectorWorker
+//
+
+//State of a thread performing garbage collection.
+class gc::internal::CollectorWorker {
+	NONCOPYABLE(CollectorWorker);
+
+public:
+	//Worker threads do not execute managed code, but need a thread state, since references are
+	//enumerated via GC functions (which check the thread state in debug mode).
+	ThreadState m_thread_state;
+
+	//Objects which have been marked, but whose references have not been processed yet.
+	std::vector<Object*> m_mark_stack;
+
+	//A part of the mark stack which can be taken by other workers.
+	std::mutex m_shared_mutex;
+	std::vector<Object*> m_shared_mark_stack;
+	std::atomic<bool> m_has_shared_objects;
+
+	//Statistics of the sweep phase.
+	std::size_t m_deleted_cnt;
+	std::size_t m_deleted_size;
+	std::size_t m_released_size;
+
+	//Total size of objects marked by the worker since the beginning of the marking cycle.
+	std::size_t m_marked_size;
+
+	CollectorWorker(const GlobalState& global_state);
+
+	void share_objects();
+	bool take_shared_objects(CollectorWorker& worker);
+};
+
 //
 //GlobalState
 //
@@ -178,17 +393,21 @@ public:
 		&gc::Object::m_list_prev,
 		&gc::Object::m_list_next> ObjectDList0;
 
-	typedef ss::DoubleLinkedList<
-		gc::internal::ObjectListElement,
-		&gc::internal::ObjectListElement::m_prev,
-		&gc::internal::ObjectListElement::m_next> ElementDList0;
 
 private:
+	typedef void (GlobalState::*WorkerTask)(CollectorWorker& worker);
+
 	bool m_started_up;
 	AllocObserver* m_observer;
 
-	std::size_t m_heap_size;
-	std::atomic<std::size_t> m_free_heap;
+	//Heap limits. A full collection is performed when the used heap memory reaches the current limit. After
+	//the collection, the limit is set proportionally to the size of live objects, within the minimum and
+	//the maximum heap size.
+	std::size_t m_min_heap_size;
+	std::size_t m_max_heap_size;
+	std::atomic<std::size_t> m_heap_limit;
+	std::atomic<std::size_t> m_used_heap;
+	std::size_t m_live_size;
 
 	//true, if gc_enumerate_refs() is being called right now during GC.
 	bool m_enumerating_references;
@@ -197,45 +416,164 @@ private:
 	ThreadState m_threads_list;
 	std::size_t m_enabled_threads_count;
 
-	//Head of the list of managed objects. On GC, all thread managed objects are moved into this list.
-	//Then, reachable objects are moved to the list of reachable objects, and rest are deleted.
-	//After that, all reachable objects are moved back to this list.
+	//Head of the list of old objects allocated outside of the small objects area. On GC, all thread managed
+	//objects are moved into this list. Old objects located in chunks are kept in lists of chunks, and young
+	//objects are not included into any list - they are enumerated by walking through young runs.
 	gc::Object m_managed_objects_list;
 
-	//Head of the list of reachable objects. Used only during GC.
-	gc::Object m_reachable_objects_list;
-
-	//Current value of the reachable flag (the value changes from 0 to 1 and from 1 to 0 on GC, thus
-	//reachable objects are marked as unreachable implicitly).
-	std::size_t m_reachable_flag;
+	//Small objects area: a contiguous block of memory divided into chunks. Chunk descriptors and line states
+	//are located in virtual memory reserved for the whole area, but a descriptor is initialized only when its
+	//chunk is used for the first time, so only the metadata of used chunks occupies physical memory, and
+	//collections visit only the first m_chunks_count chunks.
+	char* m_chunk_area_memory;
+	char* m_chunk_area_begin;
+	std::size_t m_chunk_area_size;
+	Chunk* m_chunks;
+	std::size_t m_chunks_count;
+	std::size_t m_max_chunks_count;
+	LineState* m_lines;
+
+	//Chunks which can be given to threads as allocation buffers, and chunks waiting to be swept.
+	Chunk* m_free_chunks;
+	Chunk* m_recyclable_chunks;
+	Chunk* m_unswept_chunks;
+
+	//true, if a full collection may leave chunks without young objects unswept.
+	bool m_lazy_sweep;
+
+	//true, if there are no chunks available, so objects have to be allocated in the old generation until
+	//the next collection.
+	std::atomic<bool> m_chunks_exhausted;
+
+	//Number of lines given to threads for young objects since the last collection, and its limit.
+	std::size_t m_young_lines;
+	std::size_t m_young_lines_limit;
+
+	//Chunk memory counted as used heap memory: the sizes of old objects, and the runs of lines given to threads.
+	//Old objects are counted by their sizes, not by lines, so partially used lines do not reduce the heap.
+	std::atomic<std::size_t> m_used_chunk_size;
+
+	//Runs and remembered references of threads which do not exist anymore. During GC, runs of all threads
+	//are moved here and sorted by address.
+	std::vector<YoungRun> m_young_runs;
+	std::vector<const InternalRef*> m_remembered_refs;
+
+	//true, if only young objects are being collected.
+	bool m_minor_collection;
+
+	//Which objects are marked by collect_object().
+	enum class MarkMode {
+		ALL,
+		YOUNG,
+		OLD
+	};
+	MarkMode m_mark_mode;
+
+	//Incremental marking. If the pause target is not zero, old objects are marked in slices interleaved with
+	//execution of the program. A marking cycle starts when the free heap becomes less than the threshold.
+	PauseClock::duration m_pause_target;
+	bool m_incremental_marking;
+	std::size_t m_incremental_threshold;
+
+	//true, if all old objects have been marked and young objects have been collected by a separate minor
+	//collection, so the marking is finished by the next incremental step.
+	bool m_incremental_remark;
+
+	//Costs of minor collections measured with a pause target, as moving averages: the time of marking roots,
+	//nanoseconds per byte of the young generation swept and per byte of survivors marked, and the fraction of
+	//the young generation which survives. They determine the young generation size limit (in lines).
+	double m_young_roots_ns;
+	double m_young_sweep_ns_per_byte;
+	double m_young_mark_ns_per_byte;
+	double m_young_survival_rate;
+	std::size_t m_young_pause_lines_limit;
+
+	//Marked, but not yet processed old objects, and snapshot objects of threads which do not exist anymore.
+	std::vector<Object*> m_gray_objects;
+	std::vector<Object*> m_snapshot_objects;
+
+	//An array which is being marked by parts, and the index of its next element to be marked.
+	Object* m_partial_object;
+	std::size_t m_partial_index;
+
+	//Size of old objects created during the marking cycle. They are marked on creation, so they are counted
+	//as live, like the marked ones.
+	std::atomic<std::size_t> m_created_marked_size;
+
+	//Pause times statistics.
+	PauseClock::time_point m_pause_start;
+	PauseClock::time_point m_last_pause_end;
+	std::vector<std::size_t> m_pause_histogram;
+	std::size_t m_pauses_count;
+	std::size_t m_long_pauses_count;
+	PauseClock::duration m_max_pause;
+
+	//Collections statistics.
+	std::size_t m_full_collections;
+	std::size_t m_minor_collections;
 
 	bool m_garbage_collection_in_progress;
 
 	//Monitor used for threads synchronization.
 	std::condition_variable m_monitor;
 
+	//Collector workers. The first worker is used by the thread which performs GC, the others have
+	//their own threads.
+	std::vector<std::unique_ptr<CollectorWorker>> m_workers;
+	std::vector<std::thread> m_worker_threads;
+
+	//Synchronization of worker threads. A task is given to the workers by changing the generation number.
+	std::mutex m_workers_mutex;
+	std::condition_variable m_workers_start_monitor;
+	std::condition_variable m_workers_end_monitor;
+	WorkerTask m_workers_task;
+	std::size_t m_workers_generation;
+	std::size_t m_workers_running;
+	bool m_workers_stopping;
+
+	//State of the current task: the number of workers which have no objects to mark, and the index
+	//of the next chunk to sweep.
+	std::atomic<std::size_t> m_idle_workers;
+	std::atomic<std::size_t> m_next_sweep_chunk;
+
 public:
 	GlobalState();
 
 	bool is_started_up() const;
-	std::size_t get_reachable_flag() const;
 	AllocObserver* get_observer() const;
 
-	void startup(std::size_t heap_size, AllocObserver* observer);
+	inline bool is_chunk_address(const void* ptr) const;
+	inline bool is_young_address(const void* ptr) const;
+	inline bool is_young_object(const Object* object) const;
+	inline bool is_incremental_marking() const;
+	inline void mark_created_object(Object* object);
+	inline bool is_unmarked_old_object(const Object* object) const;
+
+	void startup(
+		std::size_t heap_size,
+		std::size_t collector_threads,
+		std::size_t pause_target_ms,
+		AllocObserver* observer);
 	void shutdown();
 	void collect();
 	void synchronize(ThreadState* thread);
 
+	void get_statistics(gc::Statistics& statistics) const;
+
 	void acquire_memory(ThreadState* thread, std::size_t size);
 	void release_memory(std::size_t size);
+	Chunk* acquire_chunk(ThreadState* thread);
+	bool acquire_lines(std::size_t count);
 
 	void wait_for_garbage_collection_end(GCLockEx& lock);
-	void collect_object(Object* object);
 	void collect_reference(Object* object);
 
 	void add_managed_thread(ThreadState* thread);
 	void remove_managed_thread(ThreadState* thread);
 	void add_managed_objects(gc::Object* list_head);
+	void add_young_runs(std::vector<YoungRun>& runs);
+	void add_remembered_refs(std::vector<const InternalRef*>& refs);
+	void add_snapshot_objects(std::vector<Object*>& objects);
 	void thread_enabled(bool enabled);
 
 private:
@@ -244,22 +582,98 @@ private:
 	void resume_suspended_threads();
 
 	void collect_synchronized();
+	void collect_minor_synchronized();
+	void collect_roots();
+	void collect_object(Object* object, CollectorWorker& worker);
 	void collect_references();
+	void collect_mark_task(CollectorWorker& worker);
+	bool collect_take_shared_objects(CollectorWorker& worker);
+	void collect_sweep(std::size_t& deleted_cnt, std::size_t& deleted_size);
+	void collect_sweep_task(CollectorWorker& worker);
+	void collect_sweep_chunk(Chunk& chunk, CollectorWorker& worker);
+	void collect_sweep_old_objects(Chunk& chunk, CollectorWorker& worker);
+	void collect_sweep_managed_objects(CollectorWorker& worker);
 	void collect_delete_managed_objects();
-	void collect_delete(Object* object, std::size_t size);
+	void collect_delete(Object* object, std::size_t size, CollectorWorker& worker);
+	void collect_young_run(const YoungRun& run, Chunk& chunk, CollectorWorker& worker);
+	void collect_chunks(std::size_t& released_size);
+	void collect_release_tlabs();
+	void collect_finish();
+	void collect_reset_marked_size();
+	void update_heap_limit();
+	bool grow_heap_limit();
+	void set_heap_limit(std::size_t limit);
+	void update_young_lines_limit();
+	void update_young_costs(long long roots_ns, long long mark_ns, long long sweep_ns,
+		std::size_t young_size, std::size_t survived_size);
+	std::size_t get_free_heap() const;
+
+	bool is_incremental_step_due() const;
+	void collect_incremental_step();
+	void collect_incremental_start();
+	void collect_incremental_slice();
+	PauseClock::time_point get_step_deadline() const;
+	void collect_snapshot_objects(CollectorWorker& worker);
+	void print_pause_statistics() const;
+
+	void startup_chunks(std::size_t heap_size);
+	std::size_t get_line_index(const void* ptr) const;
+	void set_object_lines(const Object* object, std::size_t size, LineState state);
+	Chunk* take_chunk();
+	Chunk* map_chunk();
+	bool sweep_unswept_chunk();
+	void sweep_unswept_chunks();
+	void sweep_unswept_chunks_until(PauseClock::time_point deadline);
+	void decommit_chunk(Chunk& chunk);
+
+	void startup_workers(std::size_t collector_threads);
+	void shutdown_workers();
+	void run_workers(WorkerTask task);
+	void worker_thread_main(CollectorWorker* worker);
 
 	bool acquire_memory_try(std::size_t size);
 
 	typedef ScopeGuard<GlobalState, &GlobalState::resume_suspended_threads> ResumeSuspendedThreadsGuard;
 };
 
+bool gc::internal::GlobalState::is_chunk_address(const void* ptr) const {
+	std::uintptr_t ofs = reinterpret_cast<std::uintptr_t>(ptr) - reinterpret_cast<std::uintptr_t>(m_chunk_area_begin);
+	return ofs < m_chunk_area_size;
+}
+
+//Returns true if the address belongs to a line used by young objects. The function is used both for objects
+//and for references (to determine whether the object containing the reference is young).
+bool gc::internal::GlobalState::is_young_address(const void* ptr) const {
+	std::uintptr_t ofs = reinterpret_cast<std::uintptr_t>(ptr) - reinterpret_cast<std::uintptr_t>(m_chunk_area_begin);
+	return ofs < m_chunk_area_size && LineState::YOUNG == m_lines[ofs >> LINE_BITS];
+}
+
+bool gc::internal::GlobalState::is_young_object(const Object* object) const {
+	return is_object_word(reinterpret_cast<std::uintptr_t>(object)) && is_young_address(object);
+}
+
+bool gc::internal::GlobalState::is_incremental_marking() const {
+	return m_incremental_marking;
+}
+
+void gc::internal::GlobalState::mark_created_object(Object* object) {
+	std::size_t flags = object->m_size_and_flags.fetch_or(MARK_FLAG, std::memory_order_relaxed);
+	m_created_marked_size += align_object_size(flags & SIZE_MASK);
+}
+
+bool gc::internal::GlobalState::is_unmarked_old_object(const Object* object) const {
+	return is_object_word(reinterpret_cast<std::uintptr_t>(object))
+		&& !is_young_address(object)
+		&& !(object->m_size_and_flags.load(std::memory_order_relaxed) & MARK_FLAG);
+}
+
 namespace {
 	typedef gc::internal::GlobalState::ObjectDList0 ObjectDList;
-	typedef gc::internal::GlobalState::ElementDList0 ElementDList;
 	typedef gc::ThreadStateLinks::ThreadDList0 ThreadDList;
 
 	gc::internal::GlobalState g_global_state;
 	PLATFORM__THREAD_LOCAL gc::internal::ThreadState* g_thread_state = nullptr;
+	PLATFORM__THREAD_LOCAL gc::internal::CollectorWorker* g_collector_worker = nullptr;
 
 	void* allocate_memory(std::size_t size) {
 		assert(g_global_state.is_started_up());
@@ -290,8 +704,15 @@ m_name(name),
 m_managed(managed),
 m_enabled(false),
 m_object_being_created(nullptr),
-m_roots_list(nullptr),
+m_handle_block(0),
+m_handle_top(nullptr),
+m_handle_limit(nullptr),
 m_managed_objects_list(true),
+m_tlab_chunk(nullptr),
+m_tlab_line(0),
+m_tlab_begin(nullptr),
+m_tlab_top(nullptr),
+m_tlab_end(nullptr),
 m_next_sync_tick(0)
 {
 #ifndef NDEBUG
@@ -317,7 +738,11 @@ gc::internal::ThreadState::~ThreadState() {
 
 	if (m_managed) {
 		GCLock lock;
+		release_tlab();
 		g_global_state.add_managed_objects(&m_managed_objects_list);
+		g_global_state.add_young_runs(m_young_runs);
+		g_global_state.add_remembered_refs(m_remembered_refs);
+		g_global_state.add_snapshot_objects(m_snapshot_objects);
 		g_global_state.remove_managed_thread(this);
 	}
 }
@@ -338,9 +763,16 @@ const void* gc::internal::ThreadState::get_object_being_created() const {
 	return m_object_being_created;
 }
 
-gc::internal::ObjectListElement* gc::internal::ThreadState::get_roots_list() {
+//Calls the function for every object pointer stored in the handle stack.
+template<class Fn> void gc::internal::ThreadState::enumerate_handles(Fn fn) const {
 	assert(m_managed);
-	return &m_roots_list;
+	for (std::size_t i = 0; i < m_handle_blocks.size() && i <= m_handle_block; ++i) {
+		Object** slot = m_handle_blocks[i].get();
+		Object** end = i < m_handle_block ? slot + HANDLE_BLOCK_SIZE : m_handle_top;
+		for (; slot < end; ++slot) {
+			if (*slot != free_handle()) fn(*slot);
+		}
+	}
 }
 
 gc::Object* gc::internal::ThreadState::get_managed_objects_list() {
@@ -348,6 +780,71 @@ gc::Object* gc::internal::ThreadState::get_managed_objects_list() {
 	return &m_managed_objects_list;
 }
 
+std::vector<gc::internal::YoungRun>& gc::internal::ThreadState::get_young_runs() {
+	assert(m_managed);
+	return m_young_runs;
+}
+
+std::vector<const gc::internal::InternalRef*>& gc::internal::ThreadState::get_remembered_refs() {
+	assert(m_managed);
+	return m_remembered_refs;
+}
+
+std::vector<gc::Object*>& gc::internal::ThreadState::get_snapshot_objects() {
+	assert(m_managed);
+	return m_snapshot_objects;
+}
+
+//Pushes a slot holding the object pointer (or an immediate word) to the handle stack.
+gc::Object** gc::internal::ThreadState::add_handle(Object* object) {
+	assert(m_managed);
+	if (m_handle_top == m_handle_limit) add_handle_block();
+	Object** slot = m_handle_top++;
+	*slot = object;
+	return slot;
+}
+
+//Releases a slot of the handle stack. A slot which is not on the top is only marked as free, and is reclaimed
+//together with the free slots below it when the top slot is released.
+void gc::internal::ThreadState::remove_handle(Object** slot) {
+	assert(m_managed);
+	if (slot + 1 != m_handle_top) {
+		*slot = free_handle();
+		return;
+	}
+
+	m_handle_top = slot;
+	for (;;) {
+		Object** block = m_handle_blocks[m_handle_block].get();
+		if (m_handle_top == block) {
+			if (!m_handle_block) break;
+			--m_handle_block;
+			m_handle_top = m_handle_blocks[m_handle_block].get() + HANDLE_BLOCK_SIZE;
+			m_handle_limit = m_handle_top;
+		}
+		if (m_handle_top[-1] != free_handle()) break;
+		--m_handle_top;
+	}
+}
+
+void gc::internal::ThreadState::remember_reference(const InternalRef* ref) {
+	assert(m_managed);
+	m_remembered_refs.push_back(ref);
+}
+
+void gc::internal::ThreadState::remember_snapshot_object(Object* object) {
+	assert(m_managed);
+	m_snapshot_objects.push_back(object);
+}
+
+//Stops using the current allocation buffer. The lines of the buffer remain used by young objects
+//until the next collection.
+void gc::internal::ThreadState::release_tlab() {
+	finish_tlab_run();
+	m_tlab_chunk = nullptr;
+	m_tlab_line = 0;
+}
+
 void gc::internal::ThreadState::list_add_to(ThreadState* list) {
 	ThreadDList::add(list, this);
 }
@@ -416,31 +913,128 @@ void* gc::internal::ThreadState::new_allocate(std::size_t size) {
 
 	if (size > MAX_SIZE) throw out_of_memory();
 
-	std::size_t physical_size = internal::calc_physical_block_size(size);
-
-	g_global_state.acquire_memory(this, physical_size);
-	try {
-		m_object_being_created = allocate_memory(size);
+	void* ptr = size <= MAX_YOUNG_OBJECT_SIZE ? new_allocate_young(size) : nullptr;
+	if (ptr) {
+		AllocObserver* observer = g_global_state.get_observer();
+		if (observer) observer->memory_allocated(ptr, size);
+		m_object_being_created = ptr;
+	} else {
+		std::size_t physical_size = internal::calc_physical_block_size(size);
+
+		g_global_state.acquire_memory(this, physical_size);
+		try {
+			m_object_being_created = allocate_memory(size);
+		} catch (...) {
+			g_global_state.release_memory(physical_size);
+			throw;
+		}
+	}
 
 #ifndef NDEBUG
-		m_refs_of_new_object.clear();
-		m_ref_of_new_object_ofs = 0;
+	m_refs_of_new_object.clear();
+	m_ref_of_new_object_ofs = 0;
 #endif
 
-		return m_object_being_created;
-	} catch (...) {
-		g_global_state.release_memory(physical_size);
-		throw;
+	return m_object_being_created;
+}
+
+//Allocates memory for a young object in the thread's allocation buffer. Returns null if no chunk is available,
+//so the object has to be allocated in the old generation.
+void* gc::internal::ThreadState::new_allocate_young(std::size_t size) {
+	const std::size_t aligned_size = align_object_size(size);
+
+	if (aligned_size > static_cast<std::size_t>(m_tlab_end - m_tlab_top)) {
+		finish_tlab_run();
+		if (!m_tlab_chunk || !take_tlab_run(aligned_size)) {
+			//The current chunk has no suitable free lines - take another one.
+			release_tlab();
+			m_tlab_chunk = g_global_state.acquire_chunk(this);
+			if (!m_tlab_chunk) return nullptr;
+
+			if (!take_tlab_run(aligned_size)) {
+				//A recycled chunk may have no free run long enough for the object. Taking more chunks could
+				//exhaust the young generation without allocating anything, so the object goes to the old
+				//generation, and the chunk is kept for smaller objects.
+				m_tlab_line = 0;
+				return nullptr;
+			}
+		}
+
+		//Lines are counted as used heap memory when they are given to the thread. If there is not enough
+		//free memory, the object is allocated in the old generation, which performs GC.
+		if (!g_global_state.acquire_lines((m_tlab_end - m_tlab_begin) / LINE_SIZE)) {
+			std::size_t begin_line = (m_tlab_begin - m_tlab_chunk->m_begin) / LINE_SIZE;
+			std::size_t end_line = (m_tlab_end - m_tlab_chunk->m_begin) / LINE_SIZE;
+			std::fill(m_tlab_chunk->m_lines + begin_line, m_tlab_chunk->m_lines + end_line, LineState::FREE);
+			m_tlab_begin = nullptr;
+			m_tlab_top = nullptr;
+			m_tlab_end = nullptr;
+			return nullptr;
+		}
+	}
+
+	void* ptr = m_tlab_top;
+	m_tlab_top += aligned_size;
+	return ptr;
+}
+
+//Finds the next run of free lines in the current chunk which is large enough for an object of the given size.
+bool gc::internal::ThreadState::take_tlab_run(std::size_t size) {
+	LineState* lines = m_tlab_chunk->m_lines;
+	std::size_t line = m_tlab_line;
+
+	while (line < LINES_PER_CHUNK) {
+		while (line < LINES_PER_CHUNK && LineState::FREE != lines[line]) ++line;
+		std::size_t end_line = line;
+		while (end_line < LINES_PER_CHUNK && LineState::FREE == lines[end_line]) ++end_line;
+
+		if ((end_line - line) * LINE_SIZE >= size) {
+			for (std::size_t i = line; i < end_line; ++i) lines[i] = LineState::YOUNG;
+			m_tlab_line = end_line;
+			m_tlab_begin = m_tlab_chunk->m_begin + line * LINE_SIZE;
+			m_tlab_top = m_tlab_begin;
+			m_tlab_end = m_tlab_chunk->m_begin + end_line * LINE_SIZE;
+			return true;
+		}
+
+		line = end_line;
+	}
+
+	m_tlab_line = LINES_PER_CHUNK;
+	return false;
+}
+
+void gc::internal::ThreadState::finish_tlab_run() {
+	if (m_tlab_begin) {
+		m_young_runs.push_back(YoungRun{ m_tlab_begin, m_tlab_top, m_tlab_end });
+		m_tlab_begin = nullptr;
+		m_tlab_top = nullptr;
+		m_tlab_end = nullptr;
 	}
 }
 
+//Moves the top of the handle stack to the next block. Blocks are kept when the stack shrinks.
+void gc::internal::ThreadState::add_handle_block() {
+	if (m_handle_top) ++m_handle_block;
+	if (m_handle_block == m_handle_blocks.size()) {
+		m_handle_blocks.emplace_back(new Object*[HANDLE_BLOCK_SIZE]);
+	}
+	m_handle_top = m_handle_blocks[m_handle_block].get();
+	m_handle_limit = m_handle_top + HANDLE_BLOCK_SIZE;
+}
+
 void gc::internal::ThreadState::new_finish(gc::Object* object, std::size_t size) {
 	assert(m_managed);
 	assert(m_object_being_created);
 
-	object->list_add_to(m_managed_objects_list);
+	//Young objects are not added to any list.
+	bool old = !g_global_state.is_chunk_address(object);
+	if (old) object->list_add_to(m_managed_objects_list);
 	object->manage(size);
 
+	//Old objects created during incremental marking are considered reachable.
+	if (old && g_global_state.is_incremental_marking()) g_global_state.mark_created_object(object);
+
 	m_object_being_created = nullptr;
 
 #ifndef NDEBUG
@@ -452,10 +1046,18 @@ void gc::internal::ThreadState::new_fail(void* ptr, std::size_t size) {
 	assert(m_managed);
 	assert(m_object_being_created);
 
-	delete_memory(ptr, size);
+	if (g_global_state.is_chunk_address(ptr)) {
+		//No other object could be allocated during the construction, so the memory can be reused.
+		assert(static_cast<char*>(ptr) + align_object_size(size) == m_tlab_top);
+		m_tlab_top = static_cast<char*>(ptr);
+		AllocObserver* observer = g_global_state.get_observer();
+		if (observer) observer->memory_deleted(ptr, size);
+	} else {
+		delete_memory(ptr, size);
 
-	std::size_t physical_size = internal::calc_physical_block_size(size);
-	g_global_state.release_memory(physical_size);
+		std::size_t physical_size = internal::calc_physical_block_size(size);
+		g_global_state.release_memory(physical_size);
+	}
 
 	m_object_being_created = nullptr;
 }
@@ -498,6 +1100,41 @@ void gc::internal::ThreadState::set_enabled(bool enabled) {
 	g_global_state.thread_enabled(enabled);
 }
 
+//
+//CollectorWorker
+//
+
+gc::internal::CollectorWorker::CollectorWorker(const GlobalState& global_state)
+: m_thread_state(global_state),
+m_has_shared_objects(false),
+m_deleted_cnt(0),
+m_deleted_size(0),
+m_released_size(0),
+m_marked_size(0)
+{}
+
+//Moves the bottom half of the mark stack to the shared stack, so other workers can take it.
+void gc::internal::CollectorWorker::share_objects() {
+	std::lock_guard<std::mutex> lock(m_shared_mutex);
+	std::size_t cnt = m_mark_stack.size() / 2;
+	m_shared_mark_stack.insert(m_shared_mark_stack.end(), m_mark_stack.begin(), m_mark_stack.begin() + cnt);
+	m_mark_stack.erase(m_mark_stack.begin(), m_mark_stack.begin() + cnt);
+	m_has_shared_objects = true;
+}
+
+//Moves shared objects of this worker to the mark stack of the specified worker.
+bool gc::internal::CollectorWorker::take_shared_objects(CollectorWorker& worker) {
+	if (!m_has_shared_objects) return false;
+
+	std::lock_guard<std::mutex> lock(m_shared_mutex);
+	if (m_shared_mark_stack.empty()) return false;
+
+	worker.m_mark_stack.insert(worker.m_mark_stack.end(), m_shared_mark_stack.begin(), m_shared_mark_stack.end());
+	m_shared_mark_stack.clear();
+	m_has_shared_objects = false;
+	return true;
+}
+
 //
 //GlobalState
 //
@@ -505,42 +1142,144 @@ void gc::internal::ThreadState::set_enabled(bool enabled) {
 gc::internal::GlobalState::GlobalState()
 : m_started_up(false),
 m_observer(nullptr),
-m_heap_size(0),
-m_free_heap(0),
+m_min_heap_size(0),
+m_max_heap_size(0),
+m_heap_limit(0),
+m_used_heap(0),
+m_live_size(0),
 m_enumerating_references(false),
 m_threads_count(0),
 m_threads_list(*this),
 m_enabled_threads_count(0),
 m_managed_objects_list(true),
-m_reachable_objects_list(true),
-m_reachable_flag(0),
-m_garbage_collection_in_progress(false)
+m_chunk_area_memory(nullptr),
+m_chunk_area_begin(nullptr),
+m_chunk_area_size(0),
+m_chunks(nullptr),
+m_chunks_count(0),
+m_max_chunks_count(0),
+m_lines(nullptr),
+m_free_chunks(nullptr),
+m_recyclable_chunks(nullptr),
+m_unswept_chunks(nullptr),
+m_lazy_sweep(false),
+m_chunks_exhausted(false),
+m_young_lines(0),
+m_young_lines_limit(0),
+m_used_chunk_size(0),
+m_minor_collection(false),
+m_mark_mode(MarkMode::ALL),
+m_pause_target(PauseClock::duration::zero()),
+m_incremental_marking(false),
+m_incremental_threshold(0),
+m_incremental_remark(false),
+m_young_roots_ns(0),
+m_young_sweep_ns_per_byte(0),
+m_young_mark_ns_per_byte(0),
+m_young_survival_rate(0),
+m_young_pause_lines_limit(0),
+m_partial_object(nullptr),
+m_partial_index(0),
+m_created_marked_size(0),
+m_pauses_count(0),
+m_long_pauses_count(0),
+m_max_pause(PauseClock::duration::zero()),
+m_full_collections(0),
+m_minor_collections(0),
+m_garbage_collection_in_progress(false),
+m_workers_task(nullptr),
+m_workers_generation(0),
+m_workers_running(0),
+m_workers_stopping(false),
+m_idle_workers(0),
+m_next_sweep_chunk(0)
 {}
 
 bool gc::internal::GlobalState::is_started_up() const {
 	return m_started_up;
 }
 
-std::size_t gc::internal::GlobalState::get_reachable_flag() const {
-	return m_reachable_flag;
-}
-
 gc::internal::AllocObserver* gc::internal::GlobalState::get_observer() const {
 	return m_observer;
 }
 
-void gc::internal::GlobalState::startup(std::size_t heap_size, AllocObserver* observer) {
+void gc::internal::GlobalState::startup(
+	std::size_t heap_size,
+	std::size_t collector_threads,
+	std::size_t pause_target_ms,
+	AllocObserver* observer)
+{
 	GCLock lock;
 
 	assert(!m_started_up);
 	assert(heap_size > 0);
 
-	m_heap_size = heap_size;
-	m_free_heap = heap_size;
+	m_min_heap_size = std::min(heap_size, MIN_HEAP_SIZE);
+	m_max_heap_size = heap_size;
+	m_used_heap = 0;
+	m_live_size = 0;
+	m_full_collections = 0;
+	m_minor_collections = 0;
 	m_observer = observer;
+	startup_chunks(heap_size);
+	startup_workers(collector_threads);
+	m_young_roots_ns = 0;
+	m_young_sweep_ns_per_byte = 0;
+	m_young_mark_ns_per_byte = 0;
+	m_young_survival_rate = 0;
+	m_young_pause_lines_limit = 0;
+	set_heap_limit(m_min_heap_size);
+
+	m_pause_target = std::chrono::milliseconds(pause_target_ms);
+	m_incremental_marking = false;
+	m_incremental_remark = false;
+	m_incremental_threshold = m_min_heap_size / 2;
+	m_pause_histogram = std::vector<std::size_t>(PAUSE_HISTOGRAM_SIZE, 0);
+	m_pauses_count = 0;
+	m_long_pauses_count = 0;
+	m_max_pause = PauseClock::duration::zero();
+	m_last_pause_end = PauseClock::now();
+
 	m_started_up = true;
 }
 
+//Private.
+void gc::internal::GlobalState::startup_chunks(std::size_t heap_size) {
+	std::size_t chunks_count = std::min(heap_size, MAX_CHUNK_AREA_SIZE) / CHUNK_SIZE;
+	if (!chunks_count) return;
+
+	//The memory is reserved, but lines are counted as used heap memory only when they are given to threads.
+	m_chunk_area_size = chunks_count * CHUNK_SIZE;
+	m_chunk_area_memory = static_cast<char*>(pf::allocate_virtual_memory(m_chunk_area_size + CHUNK_SIZE));
+	std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(m_chunk_area_memory) + CHUNK_SIZE - 1;
+	m_chunk_area_begin = reinterpret_cast<char*>(begin & ~(CHUNK_SIZE - 1));
+
+	m_chunks = static_cast<Chunk*>(pf::allocate_virtual_memory(chunks_count * sizeof(Chunk)));
+	m_lines = static_cast<LineState*>(pf::allocate_virtual_memory(chunks_count * LINES_PER_CHUNK));
+	m_chunks_count = 0;
+	m_max_chunks_count = chunks_count;
+
+	m_chunks_exhausted = false;
+	m_young_lines = 0;
+	m_used_chunk_size = 0;
+}
+
+//Private.
+void gc::internal::GlobalState::startup_workers(std::size_t collector_threads) {
+	if (!collector_threads) collector_threads = 1;
+
+	//Allocation observer is not required to be thread-safe, so collect in one thread if it is set.
+	if (m_observer) collector_threads = 1;
+
+	m_workers_stopping = false;
+	for (std::size_t i = 0; i < collector_threads; ++i) {
+		m_workers.push_back(std::unique_ptr<CollectorWorker>(new CollectorWorker(*this)));
+	}
+	for (std::size_t i = 1; i < collector_threads; ++i) {
+		m_worker_threads.push_back(std::thread(&GlobalState::worker_thread_main, this, m_workers[i].get()));
+	}
+}
+
 void gc::internal::GlobalState::shutdown() {
 	GCLock lock;
 
@@ -550,21 +1289,69 @@ void gc::internal::GlobalState::shutdown() {
 	assert(0 == m_enabled_threads_count);
 	assert(!m_garbage_collection_in_progress);
 
-	//Delete managed objects - for safety.
+	if (m_pause_target != PauseClock::duration::zero()) print_pause_statistics();
+
+	//Delete managed objects - for safety. If incremental marking is in progress, marked objects are unmarked
+	//by an additional sweep.
+	sweep_unswept_chunks();
+	if (m_incremental_marking) {
+		m_incremental_marking = false;
+		m_incremental_remark = false;
+		m_gray_objects.clear();
+		m_partial_object = nullptr;
+		m_snapshot_objects.clear();
+		std::size_t deleted_cnt = 0;
+		std::size_t deleted_size = 0;
+		collect_sweep(deleted_cnt, deleted_size);
+	}
 	collect_delete_managed_objects();
+	collect_finish();
 
 	assert(m_managed_objects_list.list_is_empty());
-	assert(m_heap_size == m_free_heap);
+	assert(0 == m_used_heap);
 
-	m_heap_size = 0;
-	m_free_heap = 0;
+	shutdown_workers();
+
+	if (m_chunk_area_memory) {
+		for (std::size_t i = 0; i < m_chunks_count; ++i) m_chunks[i].~Chunk();
+		pf::free_virtual_memory(m_chunks, m_max_chunks_count * sizeof(Chunk));
+		pf::free_virtual_memory(m_lines, m_max_chunks_count * LINES_PER_CHUNK);
+		pf::free_virtual_memory(m_chunk_area_memory, m_chunk_area_size + CHUNK_SIZE);
+	}
+	m_chunk_area_memory = nullptr;
+	m_chunk_area_begin = nullptr;
+	m_chunk_area_size = 0;
+	m_chunks = nullptr;
+	m_chunks_count = 0;
+	m_max_chunks_count = 0;
+	m_lines = nullptr;
+	m_free_chunks = nullptr;
+	m_recyclable_chunks = nullptr;
+	m_unswept_chunks = nullptr;
+	m_young_lines_limit = 0;
+
+	m_min_heap_size = 0;
+	m_max_heap_size = 0;
+	m_heap_limit = 0;
+	m_used_heap = 0;
 	m_observer = nullptr;
-	m_reachable_objects_list.list_clear();
-	m_reachable_flag = 0;
 
 	m_started_up = false;
 }
 
+//Private.
+void gc::internal::GlobalState::shutdown_workers() {
+	{
+		std::lock_guard<std::mutex> lock(m_workers_mutex);
+		m_workers_stopping = true;
+	}
+	m_workers_start_monitor.notify_all();
+
+	for (std::thread& thread : m_worker_threads) thread.join();
+	m_worker_threads.clear();
+	m_workers.clear();
+}
+
 void gc::internal::GlobalState::collect() {
 	GCLockEx lock;
 
@@ -583,95 +1370,698 @@ void gc::internal::GlobalState::collect() {
 	collect_synchronized();
 }
 
+//Full collection: both young and old objects are collected.
 void gc::internal::GlobalState::collect_synchronized() {
 	//Step 1. Move all managed objects from threads to the global list.
 	for (ThreadState* thread : ThreadDList(&m_threads_list)) {
 		//The size of objects in the global state must have already been incremented.
 		add_managed_objects(thread->get_managed_objects_list());
 	}
-
-	//Step 2. Process root references.
-	for (ThreadState* thread : ThreadDList(&m_threads_list)) {
-		for (ObjectListElement* element : ElementDList(thread->get_roots_list())) {
-			collect_object(element->m_object);
+	collect_release_tlabs();
+	sweep_unswept_chunks();
+
+	//Step 2. Mark all reachable objects. If incremental marking is in progress, it is completed: objects
+	//marked so far remain marked, and all young objects are marked from roots.
+	assert(!m_minor_collection);
+	if (m_incremental_marking) {
+		CollectorWorker& worker = *m_workers[0];
+		collect_snapshot_objects(worker);
+		worker.m_mark_stack.insert(worker.m_mark_stack.end(), m_gray_objects.begin(), m_gray_objects.end());
+		m_gray_objects.clear();
+		if (m_partial_object) worker.m_mark_stack.push_back(m_partial_object);
+		m_partial_object = nullptr;
+
+		//Young objects referenced by old objects which have been created during the marking.
+		for (ThreadState* thread : ThreadDList(&m_threads_list)) {
+			for (const InternalRef* ref : thread->get_remembered_refs()) collect_object(ref->m_object, worker);
 		}
-	}
+		for (const InternalRef* ref : m_remembered_refs) collect_object(ref->m_object, worker);
 
-	//Step 3. Process references of reachable objects.
+		m_incremental_marking = false;
+		m_incremental_remark = false;
+	} else {
+		collect_reset_marked_size();
+	}
+	collect_roots();
 	collect_references();
 
-	//Step 4. Delete non-referenced objects.
+	//Step 3. Delete non-marked objects and promote marked young objects to the old generation. Old objects
+	//of chunks without young objects are swept later.
+	m_lazy_sweep = true;
 	collect_delete_managed_objects();
+	m_lazy_sweep = false;
+
+	collect_finish();
+	update_heap_limit();
+
+	//The next marking cycle starts when a half of the memory not used by live objects is acquired. The free
+	//heap is not known yet, since garbage of unswept chunks is counted as used.
+	const std::size_t heap_limit = m_heap_limit;
+	m_incremental_threshold = (heap_limit - std::min<std::size_t>(m_live_size, heap_limit)) / 2;
+	++m_full_collections;
+}
+
+//Minor collection: only young objects are collected. Roots are local references and remembered references
+//of old objects. Survivors are promoted to the old generation.
+//With a pause target, the times of the phases are measured to size the young generation.
+void gc::internal::GlobalState::collect_minor_synchronized() {
+	collect_release_tlabs();
 
-	//Step 5. Move objects from the reachable list to the managed list.
-	ObjectDList::move_replace(&m_reachable_objects_list, &m_managed_objects_list);
+	const std::size_t young_size = m_young_lines * LINE_SIZE;
+	std::size_t marked_size = 0;
+	for (const std::unique_ptr<CollectorWorker>& worker : m_workers) marked_size -= worker->m_marked_size;
+	const PauseClock::time_point roots_start = PauseClock::now();
 
-	//Step 6. Invert the reachable flag.
-	m_reachable_flag ^= REACHABLE_FLAG;
+	m_minor_collection = true;
+	m_mark_mode = MarkMode::YOUNG;
+	collect_roots();
+	CollectorWorker& worker = *m_workers[0];
+	for (ThreadState* thread : ThreadDList(&m_threads_list)) {
+		for (const InternalRef* ref : thread->get_remembered_refs()) collect_object(ref->m_object, worker);
+	}
+	for (const InternalRef* ref : m_remembered_refs) collect_object(ref->m_object, worker);
+	const PauseClock::time_point mark_start = PauseClock::now();
+	collect_references();
+	const PauseClock::time_point sweep_start = PauseClock::now();
+
+	std::size_t deleted_cnt = 0;
+	std::size_t deleted_size = 0;
+	collect_sweep(deleted_cnt, deleted_size);
+	m_minor_collection = false;
+	m_mark_mode = MarkMode::ALL;
+
+	collect_finish();
+	++m_minor_collections;
+
+	if (m_pause_target != PauseClock::duration::zero()) {
+		for (const std::unique_ptr<CollectorWorker>& worker : m_workers) marked_size += worker->m_marked_size;
+		auto to_ns = [](PauseClock::duration duration) {
+			return static_cast<long long>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+		};
+		update_young_costs(to_ns(mark_start - roots_start), to_ns(sweep_start - mark_start),
+			to_ns(PauseClock::now() - sweep_start), young_size, marked_size);
+	}
 }
 
-//If the passed object is not marked as reachable, mark it as reachable and move to the reachable list.
-void gc::internal::GlobalState::collect_object(Object* object) {
-	if (object) {
-		if ((object->m_size_and_flags & REACHABLE_FLAG) == m_reachable_flag) {
-			object->m_size_and_flags ^= REACHABLE_FLAG;
-			object->list_remove_from();
-			object->list_add_to(m_reachable_objects_list);
+//Processes root references. Roots are pushed to the mark stack of the first worker.
+void gc::internal::GlobalState::collect_roots() {
+	CollectorWorker& worker = *m_workers[0];
+	for (ThreadState* thread : ThreadDList(&m_threads_list)) {
+		thread->enumerate_handles([this, &worker](Object* object){ collect_object(object, worker); });
+	}
+}
+
+//If the passed object is not marked as reachable, marks it and pushes to the mark stack of the worker.
+//During a minor collection, only young objects are marked, during an incremental marking slice - only old ones.
+void gc::internal::GlobalState::collect_object(Object* object, CollectorWorker& worker) {
+	if (is_object_word(reinterpret_cast<std::uintptr_t>(object))) {
+		if (MarkMode::ALL == m_mark_mode || (MarkMode::YOUNG == m_mark_mode) == is_young_address(object)) {
+			std::size_t flags = object->m_size_and_flags.load(std::memory_order_relaxed);
+			if (flags & MARK_FLAG) return;
+
+			if (m_worker_threads.empty()) {
+				object->m_size_and_flags.store(flags | MARK_FLAG, std::memory_order_relaxed);
+			} else {
+				//Another worker may be marking the same object.
+				flags = object->m_size_and_flags.fetch_or(MARK_FLAG, std::memory_order_relaxed);
+				if (flags & MARK_FLAG) return;
+			}
+
+			worker.m_marked_size += align_object_size(flags & SIZE_MASK);
+			worker.m_mark_stack.push_back(object);
 		}
 	}
 }
 
 void gc::internal::GlobalState::collect_reference(Object* object) {
 	assert(m_enumerating_references);
-	collect_object(object);
+	assert(g_collector_worker);
+	collect_object(object, *g_collector_worker);
 }
 
-//Iterates through all reachable objects and marks all the objects referenced from them as reachable.
+//Processes marked objects and marks all the objects referenced from them as reachable.
 void gc::internal::GlobalState::collect_references() {
+	//Distribute roots between workers.
+	std::vector<Object*>& roots = m_workers[0]->m_mark_stack;
+	for (std::size_t i = 1, n = m_workers.size(); i < n; ++i) {
+		std::vector<Object*>& stack = m_workers[i]->m_mark_stack;
+		std::size_t cnt = roots.size() / (n - i + 1);
+		stack.insert(stack.end(), roots.end() - cnt, roots.end());
+		roots.resize(roots.size() - cnt);
+	}
+
 	m_enumerating_references = true;
 	util::BoolGuard guard(&m_enumerating_references);
-	for (Object* object : ObjectDList(&m_reachable_objects_list)) {
-		object->gc_enumerate_refs();
+	m_idle_workers = 0;
+	run_workers(&GlobalState::collect_mark_task);
+}
+
+//Marks objects until all workers have empty mark stacks. When a worker has no objects, it takes objects
+//shared by other workers.
+void gc::internal::GlobalState::collect_mark_task(CollectorWorker& worker) {
+	const std::size_t workers_count = m_worker_threads.size() + 1;
+
+	for (;;) {
+		while (!worker.m_mark_stack.empty()) {
+			Object* object = worker.m_mark_stack.back();
+			worker.m_mark_stack.pop_back();
+			object->gc_enumerate_refs();
+
+			if (worker.m_mark_stack.size() >= MIN_SHARED_MARK_STACK_SIZE && !worker.m_has_shared_objects) {
+				if (workers_count > 1) worker.share_objects();
+			}
+		}
+
+		if (collect_take_shared_objects(worker)) continue;
+
+		//Nothing to mark. Wait until either some worker shares objects, or all workers become idle.
+		//Only a busy worker can share objects, so when all workers are idle, there are no objects to mark.
+		++m_idle_workers;
+		for (;;) {
+			if (m_idle_workers == workers_count) return;
+
+			bool shared = false;
+			for (const std::unique_ptr<CollectorWorker>& w : m_workers) shared = shared || w->m_has_shared_objects;
+			if (shared) break;
+
+			std::this_thread::yield();
+		}
+		--m_idle_workers;
+	}
+}
+
+bool gc::internal::GlobalState::collect_take_shared_objects(CollectorWorker& worker) {
+	if (worker.take_shared_objects(worker)) return true;
+	for (const std::unique_ptr<CollectorWorker>& w : m_workers) {
+		if (w->take_shared_objects(worker)) return true;
 	}
+	return false;
 }
 
-//Deletes unreachable objects.
+//Deletes unreachable objects, both old and young.
 void gc::internal::GlobalState::collect_delete_managed_objects() {
 	std::size_t deleted_size = 0;
 	std::size_t deleted_cnt = 0;
 
 	pf::TimeMs_t t = pf::get_current_time_millis();
+	collect_sweep(deleted_cnt, deleted_size);
+	t = pf::get_current_time_millis() - t;
+
+	std::cout << "GC: collected " << deleted_cnt << " objects " << deleted_size << " bytes "
+		<< t << " ms" << std::endl;
+}
+
+//Sweeps chunks and large objects in parallel. Every chunk is swept by a single worker, together with
+//the young runs located in the chunk.
+void gc::internal::GlobalState::collect_sweep(std::size_t& deleted_cnt, std::size_t& deleted_size) {
+	for (ThreadState* thread : ThreadDList(&m_threads_list)) add_young_runs(thread->get_young_runs());
+	std::sort(m_young_runs.begin(), m_young_runs.end(), [](const YoungRun& a, const YoungRun& b) {
+		return a.m_begin < b.m_begin;
+	});
+
+	for (const std::unique_ptr<CollectorWorker>& worker : m_workers) {
+		worker->m_deleted_cnt = 0;
+		worker->m_deleted_size = 0;
+		worker->m_released_size = 0;
+	}
+
+	m_next_sweep_chunk = 0;
+	run_workers(&GlobalState::collect_sweep_task);
+	m_young_runs.clear();
+
+	std::size_t released_size = 0;
+	for (const std::unique_ptr<CollectorWorker>& worker : m_workers) {
+		deleted_cnt += worker->m_deleted_cnt;
+		deleted_size += worker->m_deleted_size;
+		released_size += worker->m_released_size;
+	}
+
+	collect_chunks(released_size);
+	m_used_heap -= released_size;
+}
 
+void gc::internal::GlobalState::collect_sweep_task(CollectorWorker& worker) {
+	const std::size_t chunks_count = m_chunks_count;
+	for (;;) {
+		std::size_t index = m_next_sweep_chunk++;
+		if (index < chunks_count) {
+			collect_sweep_chunk(m_chunks[index], worker);
+		} else if (index == chunks_count) {
+			if (!m_minor_collection) collect_sweep_managed_objects(worker);
+		} else {
+			break;
+		}
+	}
+}
+
+void gc::internal::GlobalState::collect_sweep_chunk(Chunk& chunk, CollectorWorker& worker) {
+	auto runs_iter = std::lower_bound(m_young_runs.begin(), m_young_runs.end(), chunk.m_begin,
+		[](const YoungRun& run, const char* ptr) {
+			return run.m_begin < ptr;
+		});
+	auto runs_end = runs_iter;
+	while (runs_end != m_young_runs.end() && runs_end->m_begin < chunk.m_begin + CHUNK_SIZE) ++runs_end;
+
+	if (runs_iter == runs_end) {
+		//Nothing to do for a minor collection, if there are no young objects in the chunk. Lines of old
+		//objects remain used until the chunk is swept.
+		if (m_minor_collection) return;
+		if (m_lazy_sweep && !ObjectDList::is_empty(&chunk.m_objects_list)) {
+			chunk.m_unswept = true;
+			return;
+		}
+	} else if (m_lazy_sweep && !ObjectDList::is_empty(&chunk.m_objects_list)) {
+		//Only the young runs are swept now, so the pause does not depend on the number of old objects.
+		chunk.m_unswept = true;
+	}
+
+	//Must be done before the young runs, because promoted objects are added to the list.
+	if (!m_minor_collection && !chunk.m_unswept) collect_sweep_old_objects(chunk, worker);
+	for (; runs_iter != runs_end; ++runs_iter) collect_young_run(*runs_iter, chunk, worker);
+
+	chunk.m_free_lines = std::count(chunk.m_lines, chunk.m_lines + LINES_PER_CHUNK, LineState::FREE);
+}
+
+//Deletes unmarked old objects of a chunk and clears marks of the others.
+void gc::internal::GlobalState::collect_sweep_old_objects(Chunk& chunk, CollectorWorker& worker) {
+	//Lines used by old objects and their size are determined anew.
+	std::replace(chunk.m_lines, chunk.m_lines + LINES_PER_CHUNK, LineState::OLD, LineState::FREE);
+	chunk.m_old_size = 0;
+
+	auto iter = ObjectDList::begin(&chunk.m_objects_list);
+	auto end_iter = ObjectDList::end(&chunk.m_objects_list);
+	while (iter != end_iter) {
+		Object* object = *iter;
+		++iter;
+
+		std::size_t flags = object->m_size_and_flags.load(std::memory_order_relaxed);
+		std::size_t size = flags & SIZE_MASK;
+		if (flags & MARK_FLAG) {
+			object->m_size_and_flags.store(flags & ~MARK_FLAG, std::memory_order_relaxed);
+			set_object_lines(object, size, LineState::OLD);
+			chunk.m_old_size += align_object_size(size);
+		} else {
+			collect_delete(object, size, worker);
+		}
+	}
+}
+
+//Sweeps old objects located outside of the small objects area.
+void gc::internal::GlobalState::collect_sweep_managed_objects(CollectorWorker& worker) {
 	auto mng_iter = ObjectDList::begin(&m_managed_objects_list);
 	auto mng_end_iter = ObjectDList::end(&m_managed_objects_list);
 	while (mng_iter != mng_end_iter) {
 		Object* object = *mng_iter;
 		++mng_iter;
 
-		std::size_t size = object->get_size();
-		collect_delete(object, size);
+		std::size_t flags = object->m_size_and_flags.load(std::memory_order_relaxed);
+		if (flags & MARK_FLAG) {
+			object->m_size_and_flags.store(flags & ~MARK_FLAG, std::memory_order_relaxed);
+		} else {
+			collect_delete(object, flags & SIZE_MASK, worker);
+		}
+	}
+}
 
-		std::size_t physical_size = calc_physical_block_size(size);
-		deleted_size += physical_size;
-		++deleted_cnt;
+void gc::internal::GlobalState::collect_delete(Object* object, std::size_t size, CollectorWorker& worker) {
+	object->list_remove_from();
+	object->~Object();
+
+	std::size_t physical_size = calc_physical_block_size(size);
+	++worker.m_deleted_cnt;
+	worker.m_deleted_size += physical_size;
+
+	if (is_chunk_address(object)) {
+		//The memory is released together with the chunk.
+		if (m_observer) m_observer->memory_deleted(object, size);
+	} else {
+		delete_memory(object, size);
+		worker.m_released_size += physical_size;
 	}
+}
 
-	m_free_heap += deleted_size;
-	t = pf::get_current_time_millis() - t;
+//Deletes unmarked young objects and promotes marked ones to the old generation.
+void gc::internal::GlobalState::collect_young_run(const YoungRun& run, Chunk& chunk, CollectorWorker& worker) {
+	std::size_t begin_line = get_line_index(run.m_begin);
+	std::size_t end_line = get_line_index(run.m_end);
+	std::fill(m_lines + begin_line, m_lines + end_line, LineState::FREE);
+
+	char* ptr = run.m_begin;
+	while (ptr < run.m_top) {
+		Object* object = reinterpret_cast<Object*>(ptr);
+		std::size_t flags = object->m_size_and_flags.load(std::memory_order_relaxed);
+		std::size_t size = flags & SIZE_MASK;
+		ptr += align_object_size(size);
+
+		if (flags & MARK_FLAG) {
+			//Objects promoted during incremental marking are considered reachable. Marks of objects promoted
+			//into an unswept chunk are cleared when the chunk is swept.
+			if (!m_incremental_marking && !chunk.m_unswept) {
+				object->m_size_and_flags.store(flags & ~MARK_FLAG, std::memory_order_relaxed);
+			}
+			object->list_add_to(chunk.m_objects_list);
+			set_object_lines(object, size, LineState::OLD);
+			chunk.m_old_size += align_object_size(size);
+		} else {
+			object->~Object();
+			if (m_observer) m_observer->memory_deleted(object, size);
+			++worker.m_deleted_cnt;
+			worker.m_deleted_size += align_object_size(size);
+		}
+	}
+}
 
-	std::cout << "GC: collected " << deleted_cnt << " objects " << deleted_size << " bytes "
-		<< t << " ms" << std::endl;
+//Determines which chunks can be reused, and releases the memory which is not used by old objects anymore.
+//The memory of free chunks beyond the size of the young generation is returned to the OS.
+void gc::internal::GlobalState::collect_chunks(std::size_t& released_size) {
+	m_free_chunks = nullptr;
+	m_recyclable_chunks = nullptr;
+	m_unswept_chunks = nullptr;
+
+	//All young objects have been either deleted or promoted, so only old objects use chunk memory.
+	std::size_t used_size = 0;
+
+	std::size_t committed_chunks = 0;
+	const std::size_t max_committed_chunks = m_young_lines_limit / LINES_PER_CHUNK + 1;
+
+	for (std::size_t i = m_chunks_count; i > 0; --i) {
+		Chunk& chunk = m_chunks[i - 1];
+		used_size += chunk.m_old_size;
+
+		if (chunk.m_unswept) {
+			chunk.m_next = m_unswept_chunks;
+			m_unswept_chunks = &chunk;
+		} else if (LINES_PER_CHUNK == chunk.m_free_lines) {
+			if (chunk.m_committed && ++committed_chunks > max_committed_chunks) decommit_chunk(chunk);
+			chunk.m_next = m_free_chunks;
+			m_free_chunks = &chunk;
+		} else if (chunk.m_free_lines >= MIN_RECYCLABLE_LINES) {
+			chunk.m_next = m_recyclable_chunks;
+			m_recyclable_chunks = &chunk;
+		} else {
+			chunk.m_next = nullptr;
+		}
+	}
+
+	assert(used_size <= m_used_chunk_size);
+	released_size += m_used_chunk_size - used_size;
+	m_used_chunk_size = used_size;
 }
 
-void gc::internal::GlobalState::collect_delete(Object* object, std::size_t size) {
-	object->list_remove_from();
-	object->~Object();
-	delete_memory(object, size);
+//Takes allocation buffers from all threads, so all young objects can be enumerated.
+void gc::internal::GlobalState::collect_release_tlabs() {
+	for (ThreadState* thread : ThreadDList(&m_threads_list)) thread->release_tlab();
+}
+
+//Resets the state of the young generation after a collection: all young objects have been either deleted
+//or promoted, so there are no references from old objects to young ones.
+void gc::internal::GlobalState::collect_finish() {
+	for (ThreadState* thread : ThreadDList(&m_threads_list)) thread->get_remembered_refs().clear();
+	m_remembered_refs.clear();
+	m_young_lines = 0;
+	m_chunks_exhausted = false;
+}
+
+//Private. Starts counting the size of live objects for a new marking cycle.
+void gc::internal::GlobalState::collect_reset_marked_size() {
+	for (const std::unique_ptr<CollectorWorker>& worker : m_workers) worker->m_marked_size = 0;
+	m_created_marked_size = 0;
+}
+
+//Private. Sets the heap limit after a full collection: the next one is performed when the used heap memory
+//reaches HEAP_GROWTH_FACTOR times the size of live objects. So the heap both grows and shrinks with the program.
+void gc::internal::GlobalState::update_heap_limit() {
+	std::size_t live_size = m_created_marked_size;
+	for (const std::unique_ptr<CollectorWorker>& worker : m_workers) live_size += worker->m_marked_size;
+	m_live_size = live_size;
+
+	std::size_t limit = m_max_heap_size;
+	if (live_size < m_max_heap_size / HEAP_GROWTH_FACTOR) limit = live_size * HEAP_GROWTH_FACTOR;
+	set_heap_limit(std::max(limit, m_min_heap_size));
+}
+
+//Private. Increases the heap limit by half. Returns false if the limit has already reached the maximum.
+bool gc::internal::GlobalState::grow_heap_limit() {
+	const std::size_t limit = m_heap_limit;
+	if (limit >= m_max_heap_size) return false;
+	set_heap_limit(limit + std::min(limit / 2 + 1, m_max_heap_size - limit));
+	return true;
+}
+
+//Private.
+void gc::internal::GlobalState::set_heap_limit(std::size_t limit) {
+	m_heap_limit = limit;
+	update_young_lines_limit();
+}
+
+//Private. The young generation is limited to a quarter of the heap limit, so minor collections are more
+//frequent in a small heap. With a pause target, it is also limited by the size which can be collected within
+//the target, as estimated from the previous minor collections.
+void gc::internal::GlobalState::update_young_lines_limit() {
+	const std::size_t max_lines = m_max_chunks_count * LINES_PER_CHUNK;
+	const std::size_t heap_limit = m_heap_limit;
+	std::size_t limit = std::min(max_lines, std::min(heap_limit, MAX_YOUNG_GENERATION_SIZE * 4) / LINE_SIZE) / 4;
+	if (m_young_pause_lines_limit) limit = std::min(limit, m_young_pause_lines_limit);
+	m_young_lines_limit = limit;
+}
+
+//Private. Updates the estimated costs of minor collections with the times measured by the last one, and
+//calculates the young generation size which can be collected within a part of the pause target: the roots
+//take a constant time, every young byte has to be swept, and surviving bytes have to be marked as well.
+void gc::internal::GlobalState::update_young_costs(
+	long long roots_ns,
+	long long mark_ns,
+	long long sweep_ns,
+	std::size_t young_size,
+	std::size_t survived_size)
+{
+	//A small young generation gives too imprecise times.
+	if (young_size < MIN_YOUNG_GENERATION_SIZE) return;
+
+	auto average = [](double& value, double sample) {
+		value = value > 0 ? (value * 3 + sample) / 4 : sample;
+	};
+	average(m_young_roots_ns, static_cast<double>(roots_ns));
+	average(m_young_survival_rate, static_cast<double>(survived_size) / young_size);
+	if (survived_size >= MIN_YOUNG_GENERATION_SIZE / 4) {
+		average(m_young_mark_ns_per_byte, static_cast<double>(mark_ns) / survived_size);
+	}
+	average(m_young_sweep_ns_per_byte, std::max(static_cast<double>(sweep_ns) / young_size, 1e-3));
+
+	const double target_ns = static_cast<double>(
+		std::chrono::duration_cast<std::chrono::nanoseconds>(m_pause_target).count()) / YOUNG_PAUSE_DIVISOR;
+	const double byte_ns = m_young_sweep_ns_per_byte + m_young_survival_rate * m_young_mark_ns_per_byte;
+	const double size = std::max(target_ns - m_young_roots_ns, 0.0) / byte_ns;
+	const double min_lines = static_cast<double>(MIN_YOUNG_GENERATION_SIZE / LINE_SIZE);
+	const double max_lines = static_cast<double>(MAX_YOUNG_GENERATION_SIZE / LINE_SIZE);
+	m_young_pause_lines_limit = static_cast<std::size_t>(std::min(std::max(size / LINE_SIZE, min_lines), max_lines));
+	update_young_lines_limit();
+}
+
+//Private. Returns the amount of memory which can be acquired before the heap limit is reached.
+std::size_t gc::internal::GlobalState::get_free_heap() const {
+	const std::size_t heap_limit = m_heap_limit;
+	const std::size_t used_heap = m_used_heap;
+	return used_heap < heap_limit ? heap_limit - used_heap : 0;
+}
+
+//Returns true if an incremental marking step has to be performed: either a marking cycle has to be started,
+//or the next slice has to be performed.
+bool gc::internal::GlobalState::is_incremental_step_due() const {
+	if (m_pause_target == PauseClock::duration::zero()) return false;
+	if (!m_incremental_marking) return get_free_heap() < m_incremental_threshold;
+	return PauseClock::now() - m_last_pause_end >= m_pause_target;
+}
+
+//Every step is a separate pause.
+void gc::internal::GlobalState::collect_incremental_step() {
+	if (!m_incremental_marking) {
+		//Chunks left unswept by the last full collection must be swept before marking, which may take long,
+		//so they are swept by separate pauses first.
+		if (m_unswept_chunks) {
+			sweep_unswept_chunks_until(get_step_deadline());
+		} else {
+			collect_incremental_start();
+		}
+	} else {
+		CollectorWorker& worker = *m_workers[0];
+		m_mark_mode = MarkMode::OLD;
+		collect_snapshot_objects(worker);
+		m_mark_mode = MarkMode::ALL;
+		m_gray_objects.insert(m_gray_objects.end(), worker.m_mark_stack.begin(), worker.m_mark_stack.end());
+		worker.m_mark_stack.clear();
+
+		if (!m_gray_objects.empty() || m_partial_object) {
+			collect_incremental_slice();
+		} else if (!m_incremental_remark && m_young_lines) {
+			//All old objects have been marked. Young objects are collected by a separate pause, so the final
+			//pause has to mark only the objects allocated after it.
+			collect_minor_synchronized();
+			m_incremental_remark = true;
+		} else {
+			//Finish marking and delete unreachable objects.
+			collect_synchronized();
+		}
+	}
+}
+
+//Starts a marking cycle. Young objects are collected first, so the snapshot consists of old objects only.
+//Then, old objects referenced by roots are marked.
+void gc::internal::GlobalState::collect_incremental_start() {
+	assert(!m_unswept_chunks);
+	collect_minor_synchronized();
+
+	for (ThreadState* thread : ThreadDList(&m_threads_list)) {
+		add_managed_objects(thread->get_managed_objects_list());
+	}
+
+	m_incremental_marking = true;
+	collect_reset_marked_size();
+	m_mark_mode = MarkMode::OLD;
+	collect_roots();
+	m_mark_mode = MarkMode::ALL;
+
+	m_gray_objects.swap(m_workers[0]->m_mark_stack);
+}
+
+//Marks old objects until either all of them are marked, or the step deadline is reached.
+void gc::internal::GlobalState::collect_incremental_slice() {
+	const PauseClock::time_point deadline = get_step_deadline();
+
+	CollectorWorker& worker = *m_workers[0];
+	std::vector<Object*>& stack = worker.m_mark_stack;
+	stack.swap(m_gray_objects);
+
+	m_mark_mode = MarkMode::OLD;
+	m_enumerating_references = true;
+	g_collector_worker = &worker;
+
+	//An array may be left partially marked, its remaining elements are marked by the next slice. References
+	//overwritten in the meantime are recorded by the snapshot barrier, so no reachable object is missed.
+	std::size_t cnt = 0;
+	while (m_partial_object || !stack.empty()) {
+		if (!m_partial_object) {
+			m_partial_object = stack.back();
+			m_partial_index = 0;
+			stack.pop_back();
+		}
+		if (m_partial_object->gc_enumerate_refs_part(m_partial_index, MARK_SLICE_ARRAY_PART)) {
+			m_partial_object = nullptr;
+		}
+
+		if (++cnt % MARK_SLICE_CHECK_INTERVAL == 0 && PauseClock::now() >= deadline) break;
+	}
+
+	g_collector_worker = nullptr;
+	m_enumerating_references = false;
+	m_mark_mode = MarkMode::ALL;
+
+	stack.swap(m_gray_objects);
+}
+
+//Private. Returns the time when a step which can be interrupted has to end. A part of the pause target is
+//left for finishing the step and resuming threads.
+PauseClock::time_point gc::internal::GlobalState::get_step_deadline() const {
+	return m_pause_start + m_pause_target * 9 / 10;
+}
+
+//Marks old objects recorded by the snapshot-at-the-beginning barrier.
+void gc::internal::GlobalState::collect_snapshot_objects(CollectorWorker& worker) {
+	for (ThreadState* thread : ThreadDList(&m_threads_list)) {
+		for (Object* object : thread->get_snapshot_objects()) collect_object(object, worker);
+		thread->get_snapshot_objects().clear();
+	}
+	for (Object* object : m_snapshot_objects) collect_object(object, worker);
+	m_snapshot_objects.clear();
+}
+
+void gc::internal::GlobalState::print_pause_statistics() const {
+	if (!m_pauses_count) return;
+
+	auto to_ms = [](PauseClock::duration duration) {
+		return std::chrono::duration_cast<std::chrono::microseconds>(duration).count() / 1000.0;
+	};
+	auto percentile = [this, &to_ms](std::size_t percent) {
+		std::size_t limit = (m_pauses_count * percent + 99) / 100;
+		std::size_t cnt = 0;
+		std::size_t i = 0;
+		while (i + 1 < PAUSE_HISTOGRAM_SIZE && (cnt += m_pause_histogram[i]) < limit) ++i;
+		PauseClock::duration bound = std::chrono::microseconds((i + 1) * PAUSE_HISTOGRAM_STEP);
+		return to_ms(std::min(bound, m_max_pause));
+	};
+
+	std::cout << "GC: pauses " << m_pauses_count
+		<< ", 50% " << percentile(50) << " ms"
+		<< ", 90% " << percentile(90) << " ms"
+		<< ", 99% " << percentile(99) << " ms"
+		<< ", max " << to_ms(m_max_pause) << " ms" << std::endl;
+}
+
+//Private. Executes the task by all workers. The first worker uses the current thread.
+void gc::internal::GlobalState::run_workers(WorkerTask task) {
+	CollectorWorker& worker = *m_workers[0];
+	if (m_worker_threads.empty()) {
+		g_collector_worker = &worker;
+		(this->*task)(worker);
+		g_collector_worker = nullptr;
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_workers_mutex);
+		m_workers_task = task;
+		m_workers_running = m_worker_threads.size();
+		++m_workers_generation;
+	}
+	m_workers_start_monitor.notify_all();
+
+	g_collector_worker = &worker;
+	(this->*task)(worker);
+	g_collector_worker = nullptr;
+
+	std::unique_lock<std::mutex> lock(m_workers_mutex);
+	m_workers_end_monitor.wait(lock, [this]{
+		return !m_workers_running;
+	});
+}
+
+//Private.
+void gc::internal::GlobalState::worker_thread_main(CollectorWorker* worker) {
+	g_thread_state = &worker->m_thread_state;
+	g_collector_worker = worker;
+
+	std::size_t generation = 0;
+	for (;;) {
+		WorkerTask task;
+		{
+			std::unique_lock<std::mutex> lock(m_workers_mutex);
+			m_workers_start_monitor.wait(lock, [this, generation]{
+				return m_workers_stopping || m_workers_generation != generation;
+			});
+			if (m_workers_stopping) break;
+			generation = m_workers_generation;
+			task = m_workers_task;
+		}
+
+		(this->*task)(*worker);
+
+		std::lock_guard<std::mutex> lock(m_workers_mutex);
+		if (!--m_workers_running) m_workers_end_monitor.notify_all();
+	}
+
+	g_collector_worker = nullptr;
+	g_thread_state = nullptr;
 }
 
 void gc::internal::GlobalState::synchronize(ThreadState* thread) {
 	GCLockEx lock;
-	if (m_garbage_collection_in_progress) thread->suspend_during_garbage_collection(lock);
+	if (m_garbage_collection_in_progress) {
+		thread->suspend_during_garbage_collection(lock);
+	} else if (is_incremental_step_due()) {
+		suspend_enabled_threads(lock);
+		ResumeSuspendedThreadsGuard resume(this);
+		collect_incremental_step();
+	}
 }
 
 //Acquires a block of memory of the specified size by decreasing the free memory counter.
@@ -690,25 +2080,203 @@ void gc::internal::GlobalState::acquire_memory(ThreadState* thread, std::size_t
 		if (acquire_memory_try(size)) return;
 	}
 
+	//Sweeping may release enough memory.
+	sweep_unswept_chunks();
+	if (acquire_memory_try(size)) return;
+
+	//During incremental marking, the heap limit is increased rather than the marking is finished by a long
+	//pause. The limit is set again when the marking cycle ends.
+	if (m_incremental_marking) {
+		while (grow_heap_limit()) {
+			if (acquire_memory_try(size)) return;
+		}
+	}
+
 	//Start GC in the current thread.
 	suspend_enabled_threads(lock);
 	ResumeSuspendedThreadsGuard resume(this);
 	if (!acquire_memory_try(size)) {
 		collect_synchronized();
-		if (!acquire_memory_try(size)) throw gc::out_of_memory();
+		if (acquire_memory_try(size)) return;
+		sweep_unswept_chunks();
+
+		//Live objects do not leave enough free memory - increase the heap limit.
+		while (!acquire_memory_try(size)) {
+			if (!grow_heap_limit()) throw gc::out_of_memory();
+		}
 	}
 }
 
+void gc::internal::GlobalState::get_statistics(gc::Statistics& statistics) const {
+	statistics.m_max_heap_size = m_max_heap_size;
+	statistics.m_heap_limit = m_heap_limit;
+	statistics.m_used_heap = m_used_heap;
+	statistics.m_live_size = m_live_size;
+	statistics.m_full_collections = m_full_collections;
+	statistics.m_minor_collections = m_minor_collections;
+	statistics.m_max_pause_ms = std::chrono::duration_cast<std::chrono::milliseconds>(m_max_pause).count();
+	statistics.m_pause_target_ms = std::chrono::duration_cast<std::chrono::milliseconds>(m_pause_target).count();
+	statistics.m_pauses = m_pauses_count;
+	statistics.m_long_pauses = m_long_pauses_count;
+}
+
 void gc::internal::GlobalState::release_memory(std::size_t size) {
-	m_free_heap += size;
+	m_used_heap -= size;
+}
+
+//Returns a chunk to be used as an allocation buffer. Performs a minor collection when the young generation
+//is full. Returns null if there are no chunks available, so objects have to be allocated in the old generation.
+gc::internal::Chunk* gc::internal::GlobalState::acquire_chunk(ThreadState* thread) {
+	if (m_chunks_exhausted) return nullptr;
+
+	GCLockEx lock;
+
+	if (m_garbage_collection_in_progress) {
+		//GC is already in progress in another thread. Suspend this thread and allow GC to complete.
+		thread->suspend_during_garbage_collection(lock);
+	} else if (is_incremental_step_due()) {
+		suspend_enabled_threads(lock);
+		ResumeSuspendedThreadsGuard resume(this);
+		collect_incremental_step();
+	}
+
+	Chunk* chunk = nullptr;
+	if (m_young_lines < m_young_lines_limit) {
+		chunk = take_chunk();
+	} else {
+		suspend_enabled_threads(lock);
+		ResumeSuspendedThreadsGuard resume(this);
+		collect_minor_synchronized();
+		chunk = take_chunk();
+	}
+
+	if (!chunk) m_chunks_exhausted = true;
+	return chunk;
+}
+
+//Counts the specified number of lines as used heap memory. Returns false if there is not enough free memory.
+bool gc::internal::GlobalState::acquire_lines(std::size_t count) {
+	if (!acquire_memory_try(count * LINE_SIZE)) {
+		//Sweeping may release enough memory.
+		GCLock lock;
+		sweep_unswept_chunks();
+		if (!acquire_memory_try(count * LINE_SIZE)) return false;
+	}
+	m_used_chunk_size += count * LINE_SIZE;
+	return true;
+}
+
+//Private.
+std::size_t gc::internal::GlobalState::get_line_index(const void* ptr) const {
+	assert(is_chunk_address(ptr) || ptr == m_chunk_area_begin + m_chunk_area_size);
+	std::uintptr_t ofs = reinterpret_cast<std::uintptr_t>(ptr) - reinterpret_cast<std::uintptr_t>(m_chunk_area_begin);
+	return ofs >> LINE_BITS;
+}
+
+//Private.
+void gc::internal::GlobalState::set_object_lines(const Object* object, std::size_t size, LineState state) {
+	std::size_t begin_line = get_line_index(object);
+	std::size_t end_line = get_line_index(reinterpret_cast<const char*>(object) + align_object_size(size) - 1) + 1;
+	std::fill(m_lines + begin_line, m_lines + end_line, state);
+}
+
+//Private. Partially used chunks are reused first, and a new chunk is mapped only if no chunk can be reused.
+//Every time a chunk is taken, one unswept chunk is swept, so the sweeping is spread over allocations.
+gc::internal::Chunk* gc::internal::GlobalState::take_chunk() {
+	sweep_unswept_chunk();
+
+	Chunk* chunk;
+	for (;;) {
+		chunk = m_recyclable_chunks;
+		if (chunk) {
+			m_recyclable_chunks = chunk->m_next;
+			break;
+		}
+		chunk = m_free_chunks;
+		if (chunk) {
+			m_free_chunks = chunk->m_next;
+			break;
+		}
+		if (!sweep_unswept_chunk()) {
+			chunk = map_chunk();
+			if (!chunk) return nullptr;
+			break;
+		}
+	}
+
+	chunk->m_next = nullptr;
+	chunk->m_committed = true;
+	m_young_lines += chunk->m_free_lines;
+	return chunk;
+}
+
+//Private. Initializes the descriptor of the next chunk of the area. Returns null if all chunks are in use.
+gc::internal::Chunk* gc::internal::GlobalState::map_chunk() {
+	if (m_chunks_count == m_max_chunks_count) return nullptr;
+
+	const std::size_t index = m_chunks_count++;
+	Chunk* chunk = new (&m_chunks[index]) Chunk();
+	chunk->m_begin = m_chunk_area_begin + index * CHUNK_SIZE;
+	chunk->m_lines = m_lines + index * LINES_PER_CHUNK;
+	return chunk;
+}
+
+//Private. Sweeps the next unswept chunk and makes it available for allocation. The memory of deleted
+//objects is released. Returns false if there are no unswept chunks.
+bool gc::internal::GlobalState::sweep_unswept_chunk() {
+	Chunk* chunk = m_unswept_chunks;
+	if (!chunk) return false;
+	m_unswept_chunks = chunk->m_next;
+	chunk->m_next = nullptr;
+	chunk->m_unswept = false;
+
+	//Workers are idle when no collection is in progress, so the counters of the first one can be used.
+	CollectorWorker& worker = *m_workers[0];
+	const std::size_t old_size = chunk->m_old_size;
+	collect_sweep_old_objects(*chunk, worker);
+	chunk->m_free_lines = std::count(chunk->m_lines, chunk->m_lines + LINES_PER_CHUNK, LineState::FREE);
+
+	const std::size_t released_size = old_size - chunk->m_old_size;
+	m_used_chunk_size -= released_size;
+	m_used_heap -= released_size;
+
+	if (LINES_PER_CHUNK == chunk->m_free_lines) {
+		chunk->m_next = m_free_chunks;
+		m_free_chunks = chunk;
+	} else if (chunk->m_free_lines >= MIN_RECYCLABLE_LINES) {
+		chunk->m_next = m_recyclable_chunks;
+		m_recyclable_chunks = chunk;
+	}
+	return true;
+}
+
+//Private. Sweeps all unswept chunks. Must be done before marking, since marks of old objects are cleared
+//by the sweeping.
+void gc::internal::GlobalState::sweep_unswept_chunks() {
+	while (sweep_unswept_chunk()){}
+	m_chunks_exhausted = false;
+}
+
+//Private. Sweeps unswept chunks until either all of them are swept, or the deadline is reached.
+void gc::internal::GlobalState::sweep_unswept_chunks_until(PauseClock::time_point deadline) {
+	while (sweep_unswept_chunk() && PauseClock::now() < deadline){}
+	m_chunks_exhausted = false;
+}
+
+//Private. Returns the memory of a free chunk to the OS. The chunk remains usable.
+void gc::internal::GlobalState::decommit_chunk(Chunk& chunk) {
+	assert(LINES_PER_CHUNK == chunk.m_free_lines);
+	pf::discard_virtual_memory(chunk.m_begin, CHUNK_SIZE);
+	chunk.m_committed = false;
 }
 
 bool gc::internal::GlobalState::acquire_memory_try(std::size_t size) {
-	std::size_t free_heap = m_free_heap;
+	const std::size_t heap_limit = m_heap_limit;
+	std::size_t used_heap = m_used_heap;
 	for (;;) {
-		if (free_heap < size) return false;
-		std::size_t new_free_heap = free_heap - size;
-		if (m_free_heap.compare_exchange_strong(free_heap, new_free_heap)) return true;
+		if (used_heap > heap_limit || heap_limit - used_heap < size) return false;
+		std::size_t new_used_heap = used_heap + size;
+		if (m_used_heap.compare_exchange_strong(used_heap, new_used_heap)) return true;
 	}
 }
 
@@ -741,6 +2309,7 @@ void gc::internal::GlobalState::wait_for_garbage_collection_end(GCLockEx& lock)
 void gc::internal::GlobalState::suspend_enabled_threads(GCLockEx& lock) {
 	assert(!m_garbage_collection_in_progress);
 	m_garbage_collection_in_progress = true;
+	m_pause_start = PauseClock::now();
 
 	wait_for(lock, [this] {
 		//The caller thread must be the only enabled thread.
@@ -752,6 +2321,15 @@ void gc::internal::GlobalState::resume_suspended_threads() {
 	assert(m_garbage_collection_in_progress);
 	m_garbage_collection_in_progress = false;
 	m_monitor.notify_all();
+
+	m_last_pause_end = PauseClock::now();
+	PauseClock::duration pause = m_last_pause_end - m_pause_start;
+	long long pause_us = std::chrono::duration_cast<std::chrono::microseconds>(pause).count();
+	std::size_t bucket = static_cast<std::size_t>(pause_us / PAUSE_HISTOGRAM_STEP);
+	++m_pause_histogram[std::min(bucket, PAUSE_HISTOGRAM_SIZE - 1)];
+	++m_pauses_count;
+	if (m_pause_target != PauseClock::duration::zero() && pause > m_pause_target) ++m_long_pauses_count;
+	m_max_pause = std::max(m_max_pause, pause);
 }
 
 void gc::internal::GlobalState::add_managed_thread(ThreadState* thread) {
@@ -768,6 +2346,21 @@ void gc::internal::GlobalState::add_managed_objects(gc::Object* list_head) {
 	ObjectDList::move_add(list_head, &m_managed_objects_list);
 }
 
+void gc::internal::GlobalState::add_young_runs(std::vector<YoungRun>& runs) {
+	m_young_runs.insert(m_young_runs.end(), runs.begin(), runs.end());
+	runs.clear();
+}
+
+void gc::internal::GlobalState::add_remembered_refs(std::vector<const InternalRef*>& refs) {
+	m_remembered_refs.insert(m_remembered_refs.end(), refs.begin(), refs.end());
+	refs.clear();
+}
+
+void gc::internal::GlobalState::add_snapshot_objects(std::vector<Object*>& objects) {
+	m_snapshot_objects.insert(m_snapshot_objects.end(), objects.begin(), objects.end());
+	objects.clear();
+}
+
 void gc::internal::GlobalState::thread_enabled(bool enabled) {
 	if (enabled) {
 		++m_enabled_threads_count;
@@ -800,6 +2393,14 @@ gc::Object::~Object() {
 
 void gc::Object::gc_enumerate_refs(){}
 
+//Enumerates the references of at most count elements starting from the index, and advances the index.
+//Returns true when all references have been enumerated. Arrays override this, so that a large array can be
+//marked by several incremental marking slices; other objects enumerate all their references at once.
+bool gc::Object::gc_enumerate_refs_part(std::size_t& index, std::size_t count) {
+	gc_enumerate_refs();
+	return true;
+}
+
 void gc::Object::gc_ref_internal(gc::internal::InternalRef& ref) {
 #ifdef NDEBUG
 	g_global_state.collect_reference(ref.m_object);
@@ -841,90 +2442,47 @@ void gc::Object::manage(std::size_t size) {
 	assert(!is_mock());
 
 	//It is the caller's duty to check that GC is enabled for the thread.
-	m_size_and_flags = g_global_state.get_reachable_flag() | (size & SIZE_MASK);
+	m_size_and_flags.store(size & SIZE_MASK, std::memory_order_relaxed);
 }
 
 std::size_t gc::Object::get_size() const {
-	return m_size_and_flags & SIZE_MASK;
+	return m_size_and_flags.load(std::memory_order_relaxed) & SIZE_MASK;
 }
 
 bool gc::Object::is_mock() const {
-	return !!(m_size_and_flags & MOCK_FLAG);
-}
-
-//
-//ObjectListElement
-//
-
-gc::internal::ObjectListElement::ObjectListElement(Object* object) {
-	m_object = object;
-	ElementDList::init(this);
-}
-
-gc::internal::ObjectListElement::ObjectListElement(Object* object, ObjectListElement* list_head) {
-	m_object = object;
-	list_add_to(list_head);
-}
-
-void gc::internal::ObjectListElement::list_add_to(ObjectListElement* list_head) {
-	//The object is not removed from the old list - the caller must take care about that.
-	ElementDList::add(list_head, this);
-}
-
-void gc::internal::ObjectListElement::list_remove_from() {
-	//The links of this object are not modified - only the links of the nearby objects.
-	ElementDList::remove(this);
-}
-
-void gc::internal::ObjectListElement::list_clear() {
-	ElementDList::clear(this);
-}
-
-gc::Object* gc::internal::ObjectListElement::get_object() const {
-	return m_object;
-}
-
-void gc::internal::ObjectListElement::set_object(Object* object) {
-	m_object = object;
+	return !!(m_size_and_flags.load(std::memory_order_relaxed) & MOCK_FLAG);
 }
 
 //
 //InternalLocal
 //
 
-namespace {
-	gc::internal::ObjectListElement* get_thread_roots_list() {
-		assert(g_thread_state);
-		assert(g_thread_state->is_enabled());
-		assert(!g_thread_state->is_creating_new_object());
-		return g_thread_state->get_roots_list();
-	}
+gc::internal::InternalLocal::InternalLocal(const Object* object) {
+	assert(g_thread_state);
+	assert(g_thread_state->is_enabled());
+	m_slot = g_thread_state->add_handle(const_cast<Object*>(object));
 }
 
-gc::internal::InternalLocal::InternalLocal(const Object* object)
-: m_list_element(const_cast<Object*>(object), get_thread_roots_list())
-{}
-
 gc::internal::InternalLocal::~InternalLocal() {
 	assert(g_thread_state);
 	assert(g_thread_state->is_enabled());
 	assert(!g_thread_state->is_creating_new_object());
-	m_list_element.list_remove_from();
+	g_thread_state->remove_handle(m_slot);
 }
 
 gc::Object* gc::internal::InternalLocal::internal_get_object() const {
 	assert(g_thread_state);
 	assert(g_thread_state->is_enabled());
 	assert(!g_thread_state->is_creating_new_object());
-	return m_list_element.get_object();
+	return *m_slot;
 }
 
 void gc::internal::InternalLocal::internal_set_object(const Object* object) {
 	assert(g_thread_state);
 	assert(g_thread_state->is_enabled());
 	assert(!g_thread_state->is_creating_new_object());
-	assert(!object || !object->is_mock());
-	m_list_element.set_object(const_cast<Object*>(object));
+	assert(!is_object_word(reinterpret_cast<std::uintptr_t>(object)) || !object->is_mock());
+	*m_slot = const_cast<Object*>(object);
 }
 
 //
@@ -954,7 +2512,25 @@ void gc::internal::InternalRef::internal_set_object(const Object* object) {
 	assert(g_thread_state);
 	assert(g_thread_state->is_enabled());
 	assert(!g_thread_state->is_creating_new_object());
-	assert(!object || !object->is_mock());
+	assert(!is_object_word(reinterpret_cast<std::uintptr_t>(object)) || !object->is_mock());
+
+	//Snapshot-at-the-beginning barrier: during incremental marking, an old object which is not marked yet
+	//is recorded when a reference to it is overwritten, so all objects reachable at the beginning of marking
+	//are marked.
+	if (g_global_state.is_incremental_marking() && g_global_state.is_unmarked_old_object(m_object)) {
+		g_thread_state->remember_snapshot_object(m_object);
+	}
+
+	//Write barrier: a reference from an old object to a young object is remembered, so that the young
+	//object is not deleted by a minor collection. If the reference already pointed to a young object,
+	//it has already been remembered.
+	if (g_global_state.is_young_object(object)
+		&& !g_global_state.is_young_object(m_object)
+		&& !g_global_state.is_young_address(this))
+	{
+		g_thread_state->remember_reference(this);
+	}
+
 	m_object = const_cast<Object*>(object);
 }
 
@@ -979,8 +2555,13 @@ gc::manage_thread_guard::~manage_thread_guard() {
 //(Functions)
 //
 
-void gc::startup(std::size_t heap_size, gc::internal::AllocObserver* observer) {
-	g_global_state.startup(heap_size, observer);
+void gc::startup(
+	std::size_t heap_size,
+	std::size_t collector_threads,
+	std::size_t pause_target_ms,
+	gc::internal::AllocObserver* observer)
+{
+	g_global_state.startup(heap_size, collector_threads, pause_target_ms, observer);
 }
 
 void gc::shutdown() {
@@ -1006,6 +2587,13 @@ void gc::synchronize() {
 	g_thread_state->synchronize();
 }
 
+gc::Statistics gc::get_statistics() {
+	GCLock lock;
+	gc::Statistics statistics;
+	g_global_state.get_statistics(statistics);
+	return statistics;
+}
+
 void* gc::internal::new_allocate(std::size_t size) {
 	assert(g_thread_state);
 	return g_thread_state->new_allocate(size);
@@ -19,11 +19,14 @@
 #ifndef SYNSAMPLE_CORE_GC_H_INCLUDED
 #define SYNSAMPLE_CORE_GC_H_INCLUDED
 
+#include <atomic>
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
 #include <iostream>
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
 
@@ -52,6 +55,10 @@ GUIDELINE
 15. Every thread with enabled GC functionality MUST call gc:synchronize() periodically.
 16. Arrays of GC objects may be implemented by gc::Array.
 17. Primitive arrays may be implemented by gc::PrimitiveArray.
+18. A reference may hold an immediate word instead of an object pointer (see gc::is_object_word()).
+	Such references MUST be implemented by gc::WordLocal and gc::WordRef.
+19. A mutex which is held while using GC functionality MUST be locked by gc::lock_guard, if other threads
+	with enabled GC functionality may wait for it.
 */
 
 namespace syn_script {
@@ -63,8 +70,11 @@ namespace syn_script {
 		class Object;
 		template<class T> class Local;
 		template<class T> class Ref;
+		class WordLocal;
+		class WordRef;
 		template<class T> class BasicArray;
 		template<class T> class Array;
+		template<class T> class WordArray;
 		template<class T> class PrimitiveArray;
 
 		namespace internal {
@@ -72,7 +82,7 @@ namespace syn_script {
 
 			class GlobalState;
 			class ThreadState;
-			class ObjectListElement;
+			class Chunk;
 			class InternalLocal;
 			class InternalRef;
 			class AllocObserver;
@@ -88,9 +98,31 @@ namespace syn_script {
 		}
 
 		class out_of_memory;
+		struct Statistics;
+
+		//Bits which are zero in every object pointer. A reference word with any of these bits set is an
+		//immediate value - a value encoded in the reference itself, which is ignored by the collector.
+#if UINTPTR_MAX > 0xFFFFFFFFu
+		const std::uintptr_t IMMEDIATE_MASK = static_cast<std::uintptr_t>(0xFFFF000000000003ull);
+#else
+		const std::uintptr_t IMMEDIATE_MASK = 0x3;
+#endif
+
+		//Returns true if the reference word is a pointer to an object (not null and not an immediate value).
+		inline bool is_object_word(std::uintptr_t word) {
+			return word && !(word & IMMEDIATE_MASK);
+		}
 
-		//Starts GC functionality for the entire process.
-		void startup(std::size_t heap_size, internal::AllocObserver* observer = nullptr);
+		//Starts GC functionality for the entire process. The heap starts small and grows with the size of live
+		//objects, up to heap_size bytes. Garbage collection is performed by the specified number of threads
+		//(the thread which has started the collection, plus collector_threads - 1 worker threads).
+		//If pause_target_ms is not zero, old objects are marked incrementally, in pauses not longer than
+		//the target (if possible).
+		void startup(
+			std::size_t heap_size,
+			std::size_t collector_threads = 1,
+			std::size_t pause_target_ms = 0,
+			internal::AllocObserver* observer = nullptr);
 
 		//Stops GC functionality.
 		void shutdown();
@@ -106,10 +138,15 @@ namespace syn_script {
 		void collect();
 
 		//If garbage collection request is pending, this thread is suspended, allowing GC to proceed.
+		//If incremental marking is in progress, the next marking slice may be performed.
 		void synchronize();
 
+		//Returns the current heap size and collections statistics.
+		Statistics get_statistics();
+
 		template<class T, class... Args> Local<T> create(Args...);
 		template<class T> void swap(gc::Ref<T>& a, gc::Ref<T>& b);
+		inline void swap(gc::WordRef& a, gc::WordRef& b);
 
 		/////////////////////////////////////////////////////////////////////////////////////////////////
 		// Definitions
@@ -123,16 +160,19 @@ namespace syn_script {
 
 			friend class internal::GlobalState;
 			friend class internal::ThreadState;
+			friend class internal::Chunk;
 			friend class internal::InternalLocal;
 			friend class internal::InternalRef;
 			template<class T> friend class Ref;
 			template<class T> friend class BasicArray;
+			template<class T> friend class WordArray;
 
 			template<class P, class Fn, class... Args>
 			friend Local<P> internal::create_internal(std::size_t, Fn, Args...);
 
 		private:
-			std::size_t m_size_and_flags;
+			//Atomic, because objects are marked by several collector threads concurrently.
+			std::atomic<std::size_t> m_size_and_flags;
 			Object* m_list_prev;
 			Object* m_list_next;
 
@@ -147,7 +187,9 @@ namespace syn_script {
 			virtual ~Object();
 
 			virtual void gc_enumerate_refs();
+			virtual bool gc_enumerate_refs_part(std::size_t& index, std::size_t count);
 			template<class T> inline void gc_ref(Ref<T>& ref);
+			inline void gc_ref(WordRef& ref);
 			template<class T> inline Local<T> self(T* this_ptr);
 			template<class T> inline Local<const T> self(const T* this_ptr) const;
 
@@ -174,9 +216,11 @@ namespace syn_script {
 		public:
 			startup_guard(
 				std::size_t heap_size,
+				std::size_t collector_threads = 1,
+				std::size_t pause_target_ms = 0,
 				internal::AllocObserver* observer = nullptr)
 			{
-				gc::startup(heap_size, observer);
+				gc::startup(heap_size, collector_threads, pause_target_ms, observer);
 			}
 
 			~startup_guard() { gc::shutdown(); }
@@ -220,6 +264,29 @@ namespace syn_script {
 			~disable_guard() { gc::enable(); }
 		};
 
+		//
+		//lock_guard
+		//
+
+		//Locks a mutex shared by threads with enabled GC functionality. If the mutex is held by another thread,
+		//GC is disabled while waiting, so that the owner can perform garbage collection (otherwise the owner
+		//would wait for this thread, and this thread - for the owner).
+		class lock_guard {
+			NONCOPYABLE(lock_guard);
+
+			std::mutex& m_mutex;
+
+		public:
+			explicit lock_guard(std::mutex& mutex) : m_mutex(mutex) {
+				if (!m_mutex.try_lock()) {
+					disable_guard disable;
+					m_mutex.lock();
+				}
+			}
+
+			~lock_guard() { m_mutex.unlock(); }
+		};
+
 		//
 		//out_of_memory
 		//
@@ -230,43 +297,36 @@ namespace syn_script {
 		};
 
 		//
-		//ObjectListElement
+		//Statistics
 		//
 
-		class internal::ObjectListElement {
-			NONCOPYABLE(ObjectListElement);
-
-			friend class GlobalState;
-			friend class ThreadState;
-			friend class InternalLocal;
-
-		private:
-			ObjectListElement* m_prev;
-			ObjectListElement* m_next;
-			Object* m_object;
-
-			ObjectListElement(Object* object);
-			ObjectListElement(Object* object, ObjectListElement* list_head);
-
-			void list_add_to(ObjectListElement* list_head);
-			void list_remove_from();
-			void list_clear();
-
-			Object* get_object() const;
-			void set_object(Object* object);
+		struct Statistics {
+			std::size_t m_max_heap_size;
+			std::size_t m_heap_limit;        //A full collection is performed when the used heap reaches the limit.
+			std::size_t m_used_heap;
+			std::size_t m_live_size;         //The size of objects which survived the last full collection.
+			std::size_t m_full_collections;
+			std::size_t m_minor_collections;
+			long long m_max_pause_ms;
+			long long m_pause_target_ms;     //Zero if incremental collection is not enabled.
+			std::size_t m_pauses;
+			std::size_t m_long_pauses;       //The number of pauses longer than the target.
 		};
 
 		//
 		//InternalLocal
 		//
 
+		//A local reference occupies a slot in the handle stack of its thread. The slot is released when the
+		//reference is destroyed; slots of references destroyed out of order are reclaimed in bulk later.
 		class internal::InternalLocal {
 			NONCOPYABLE(InternalLocal);
 
 			template<class T> friend class gc::Local;
+			friend class gc::WordLocal;
 
 		private:
-			ObjectListElement m_list_element;
+			Object** m_slot;
 
 			InternalLocal(const Object* object);
 
@@ -285,6 +345,7 @@ namespace syn_script {
 			NONCOPYABLE(InternalRef);
 
 			template<class T> friend class gc::Ref;
+			friend class gc::WordRef;
 			friend class GlobalState;
 			friend class ThreadState;
 			friend class gc::Object;
@@ -306,6 +367,7 @@ namespace syn_script {
 			friend class gc::Object;
 			template<class P> friend class Local;
 			template<class P> friend class Ref;
+			friend class WordLocal;
 
 			template<class P, class Fn, class... Args>
 			friend Local<P> internal::create_internal(std::size_t, Fn, Args...);
@@ -468,6 +530,66 @@ namespace syn_script {
 			Local<T> local() const { return *this; }
 		};
 
+		//
+		//WordLocal
+		//
+
+		//Local reference holding a word, which is either an object pointer or an immediate value.
+		//Base class for handles which encode values in the reference itself.
+		class WordLocal : internal::InternalLocal {
+		public:
+			explicit WordLocal(std::uintptr_t word = 0) : InternalLocal(reinterpret_cast<const Object*>(word)){}
+			WordLocal(const WordLocal& local) : InternalLocal(local.internal_get_object()){}
+
+			WordLocal& operator=(const WordLocal& local) {
+				internal_set_object(local.internal_get_object());
+				return *this;
+			}
+
+			std::uintptr_t get_word() const { return reinterpret_cast<std::uintptr_t>(internal_get_object()); }
+			void set_word(std::uintptr_t word) { internal_set_object(reinterpret_cast<const Object*>(word)); }
+			bool is_object() const { return is_object_word(get_word()); }
+
+			//Casts the object pointer to the specified class. Throws an exception if the word is an immediate
+			//value or the object is not of the specified class.
+			template<class P> Local<P> cast() const {
+				std::uintptr_t word = get_word();
+				if (!word) return Local<P>(nullptr);
+				P* p = is_object_word(word) ? dynamic_cast<P*>(internal_get_object()) : nullptr;
+				if (!p) throw std::runtime_error("Class cast error");
+				return Local<P>(p);
+			}
+
+			//Like cast(), but returns null instead of throwing an exception.
+			template<class P> Local<P> cast_opt() const {
+				std::uintptr_t word = get_word();
+				if (!is_object_word(word)) return Local<P>(nullptr);
+				return Local<P>(dynamic_cast<P*>(internal_get_object()));
+			}
+		};
+
+		//
+		//WordRef
+		//
+
+		//Reference from one GC object to another which can hold an immediate value instead of an object pointer.
+		class WordRef : public internal::InternalRef {
+			WordRef(const WordRef&) = delete;
+			WordRef(WordRef&&) = delete;
+
+		public:
+			WordRef(){}
+
+			WordRef& operator=(const WordRef& ref) {
+				internal_set_object(ref.internal_get_object());
+				return *this;
+			}
+
+			std::uintptr_t get_word() const { return reinterpret_cast<std::uintptr_t>(internal_get_object()); }
+			void set_word(std::uintptr_t word) { internal_set_object(reinterpret_cast<const Object*>(word)); }
+			bool is_object() const { return is_object_word(get_word()); }
+		};
+
 		//
 		//BasicArray
 		//
@@ -477,6 +599,7 @@ namespace syn_script {
 
 			friend class PrimitiveArray<T>;
 			template<class P> friend class Array;
+			template<class P> friend class WordArray;
 
 			static const std::size_t ELEMENT_SIZE = sizeof(T);
 			static const std::size_t PTR_SIZE = sizeof(void*);
@@ -537,11 +660,28 @@ namespace syn_script {
 
 			Array(std::size_t size) : BasicArray<Ref<T>>(size){}
 			void gc_enumerate_refs() override;
+			bool gc_enumerate_refs_part(std::size_t& index, std::size_t count) override;
 
 		public:
 			static Local<Array<T>> create(std::size_t size);
 		};
 
+		//
+		//WordArray
+		//
+
+		//Array of word references. R must be WordRef or a class derived from it.
+		template<class R> class WordArray : public BasicArray<R> {
+			NONCOPYABLE(WordArray);
+
+			WordArray(std::size_t size) : BasicArray<R>(size){}
+			void gc_enumerate_refs() override;
+			bool gc_enumerate_refs_part(std::size_t& index, std::size_t count) override;
+
+		public:
+			static Local<WordArray<R>> create(std::size_t size);
+		};
+
 		//
 		//PrimitiveArray
 		//
@@ -586,6 +726,10 @@ namespace syn_script {
 			gc_ref_internal(ref);
 		}
 
+		void Object::gc_ref(WordRef& ref) {
+			gc_ref_internal(ref);
+		}
+
 		template<class T> Local<T> Object::self(T* this_ptr) {
 			assert(this == this_ptr);
 			return Local<T>(static_cast<T*>(this));
@@ -630,6 +774,12 @@ namespace syn_script {
 			b = t;
 		}
 
+		void swap(gc::WordRef& a, gc::WordRef& b) {
+			std::uintptr_t t = a.get_word();
+			a.set_word(b.get_word());
+			b.set_word(t);
+		}
+
 		/////////////////////////////////////////////////////////////////////////////////////////////////
 		// Implementation of arrays.
 
@@ -793,6 +943,47 @@ namespace syn_script {
 			}
 		}
 
+		template<class T> bool Array<T>::gc_enumerate_refs_part(std::size_t& index, std::size_t count) {
+			const std::size_t n = this->length();
+			const std::size_t end = count < n - index ? index + count : n;
+			char* ptr = this->get_array_ptr() + index * sizeof(Ref<T>);
+			for (std::size_t i = index; i < end; ++i) {
+				Ref<T>* ref_ptr = static_cast<Ref<T>*>(static_cast<void*>(ptr));
+				this->gc_ref(*ref_ptr);
+				ptr += sizeof(Ref<T>);
+			}
+			index = end;
+			return end == n;
+		}
+
+		//
+		//WordArray
+		//
+
+		template<class R> Local<WordArray<R>> WordArray<R>::create(std::size_t length) {
+			std::size_t size = WordArray<R>::calc_size(length);
+			return internal::create_internal<WordArray<R>>(size, [length](void* ptr){
+				return new(ptr)WordArray<R>(length); });
+		}
+
+		template<class R> void WordArray<R>::gc_enumerate_refs() {
+			for (std::size_t i = 0, n = this->length(); i < n; ++i) {
+				WordRef& ref = this->get(i);
+				this->gc_ref(ref);
+			}
+		}
+
+		template<class R> bool WordArray<R>::gc_enumerate_refs_part(std::size_t& index, std::size_t count) {
+			const std::size_t n = this->length();
+			const std::size_t end = count < n - index ? index + count : n;
+			for (std::size_t i = index; i < end; ++i) {
+				WordRef& ref = this->get(i);
+				this->gc_ref(ref);
+			}
+			index = end;
+			return end == n;
+		}
+
 		//
 		//PrimitiveArray
 		//
@@ -814,7 +1005,7 @@ namespace syn_script {
 			assert(array_len <= this->length());
 			assert(pos <= this->length() - array_len);
 
-			T* dest = static_cast<T*>(this->get_array_ptr());
+			T* dest = this->raw_array();
 			for (std::size_t i = 0; i < array_len; ++i) dest[pos + i] = array[array_start + i];
 		}
 
@@ -17,6 +17,7 @@
 //GC Hashmap implementation.
 
 #include <cassert>
+#include <cstdint>
 
 #include "gc.h"
 #include "gc_hashmap.h"
@@ -24,45 +25,13 @@
 namespace ss = syn_script;
 namespace gc = ss::gc;
 
-//
-//BasicHashMap::Entry
-//
-
-void gc::BasicHashMap::Entry::gc_enumerate_refs() {
-	Object::gc_enumerate_refs();
-	gc_ref(m_next);
-	gc_ref(m_key);
-	gc_ref(m_value);
-}
-
-void gc::BasicHashMap::Entry::initialize(
-	const gc::Local<Entry>& next,
-	const gc::Local<Object>& key,
-	const gc::Local<Object>& value)
-{
-	m_next = next;
-	m_key = key;
-	m_value = value;
-}
-
-const gc::Ref<gc::BasicHashMap::Entry>& gc::BasicHashMap::Entry::get_next() const {
-	return m_next;
-}
-
-const gc::Ref<gc::Object>& gc::BasicHashMap::Entry::get_key() const {
-	return m_key;
-}
-
-const gc::Ref<gc::Object>& gc::BasicHashMap::Entry::get_value() const {
-	return m_value;
-}
-
-void gc::BasicHashMap::Entry::set_next(const gc::Local<Entry>& next) {
-	m_next = next;
-}
-
-void gc::BasicHashMap::Entry::set_value(const gc::Local<Object>& value) {
-	m_value = value;
+namespace {
+	//Spreads the bits of a hash code, since the index table uses the lowest bits only (identity hash codes of
+	//objects, for instance, have zero low bits).
+	std::size_t spread_hash(std::size_t hash) {
+		std::uint64_t h = static_cast<std::uint64_t>(hash) * 0x9E3779B97F4A7C15ull;
+		return static_cast<std::size_t>(h ^ (h >> 32));
+	}
 }
 
 //
@@ -72,57 +41,51 @@ void gc::BasicHashMap::Entry::set_value(const gc::Local<Object>& value) {
 gc::BasicHashMap::BasicIterator::BasicIterator(const gc::Local<const BasicHashMap>& map)
 : m_map(map)
 {
-	m_index = 0;
-	next_index();
+	m_pos = 0;
+	skip_removed();
 }
 
 bool gc::BasicHashMap::BasicIterator::end() const {
-	return !m_entry;
+	return m_pos >= m_map->m_used;
 }
 
 void gc::BasicHashMap::BasicIterator::next() {
-	assert(!!m_entry);
-	m_entry = m_entry->get_next();
-	if (!m_entry) {
-		++m_index;
-		next_index();
-	}
+	assert(!end());
+	++m_pos;
+	skip_removed();
 }
 
-gc::Local<gc::Object> gc::BasicHashMap::BasicIterator::key() const {
-	assert(!!m_entry);
-	return m_entry->get_key();
+gc::WordLocal gc::BasicHashMap::BasicIterator::key() const {
+	assert(!end());
+	return gc::WordLocal((*m_map->m_entries)[m_pos * 2].get_word());
 }
 
-gc::Local<gc::Object> gc::BasicHashMap::BasicIterator::value() const {
-	assert(!!m_entry);
-	return m_entry->get_value();
+gc::WordLocal gc::BasicHashMap::BasicIterator::value() const {
+	assert(!end());
+	return gc::WordLocal((*m_map->m_entries)[m_pos * 2 + 1].get_word());
 }
 
-void gc::BasicHashMap::BasicIterator::next_index() {
-	std::size_t capacity = m_map->m_table->length();
-	while (m_index < capacity) {
-		m_entry = (*m_map->m_table)[m_index];
-		if (!!m_entry) break;
-		++m_index;
-	}
+void gc::BasicHashMap::BasicIterator::skip_removed() {
+	const EntryArray& entries = *m_map->m_entries;
+	std::size_t used = m_map->m_used;
+	while (m_pos < used && !entries[m_pos * 2].get_word()) ++m_pos;
 }
 
 //
 //BasicHashMap
 //
 
-const float gc::BasicHashMap::LOAD_FACTOR = 0.75f;
-
 void gc::BasicHashMap::gc_enumerate_refs() {
 	Object::gc_enumerate_refs();
-	gc_ref(m_table);
+	gc_ref(m_index);
+	gc_ref(m_hashes);
+	gc_ref(m_entries);
 }
 
 void gc::BasicHashMap::initialize() {
-	m_threshold = 16;
-	m_table = gc::Array<Entry>::create(m_threshold);
 	m_size = 0;
+	m_used = 0;
+	rebuild(INITIAL_CAPACITY);
 }
 
 bool gc::BasicHashMap::is_empty() const {
@@ -134,113 +97,144 @@ std::size_t gc::BasicHashMap::size() const {
 }
 
 void gc::BasicHashMap::clear() {
-	for (std::size_t i = 0, len = m_table->length(); i < len; ++i) (*m_table)[i] = nullptr;
+	SizeArray& index = *m_index;
+	for (std::size_t i = 0, len = index.length(); i < len; ++i) index[i] = EMPTY_SLOT;
+
+	EntryArray& entries = *m_entries;
+	for (std::size_t i = 0, len = m_used * 2; i < len; ++i) entries[i].set_word(0);
+
 	m_size = 0;
+	m_used = 0;
 }
 
 gc::BasicHashMap::BasicIterator gc::BasicHashMap::basic_iterator() const {
 	return BasicIterator(self(this));
 }
 
-bool gc::BasicHashMap::contains_0(const gc::Local<Object>& key) const {
-	gc::Local<Entry> prev;
-	std::size_t index;
-	gc::Local<Entry> entry = find_entry(key, prev, index);
-	return !!entry;
+bool gc::BasicHashMap::contains_0(const gc::WordLocal& key) const {
+	std::size_t free_slot;
+	return find_slot(key, key_hash_code(key), free_slot) != NOT_FOUND;
 }
 
-gc::Local<gc::Object> gc::BasicHashMap::get_0(const gc::Local<Object>& key) const {
-	gc::Local<Entry> prev;
-	std::size_t index;
-	gc::Local<Entry> entry = find_entry(key, prev, index);
-	if (!entry) return nullptr;
-	return entry->get_value();
+gc::WordLocal gc::BasicHashMap::get_0(const gc::WordLocal& key) const {
+	std::size_t free_slot;
+	std::size_t slot = find_slot(key, key_hash_code(key), free_slot);
+	if (slot == NOT_FOUND) return gc::WordLocal();
+
+	std::size_t entry_idx = (*m_index)[slot] - SLOT_BASE;
+	return gc::WordLocal((*m_entries)[entry_idx * 2 + 1].get_word());
 }
 
-gc::Local<gc::Object> gc::BasicHashMap::put_0(const gc::Local<Object>& key, const gc::Local<Object>& value) {
-	gc::Local<Entry> prev;
-	std::size_t index;
-	gc::Local<Entry> entry = find_entry(key, prev, index);
-	if (!!entry) {
-		gc::Local<Object> old_value = entry->get_value();
-		entry->set_value(value);
-		return old_value;
-	} else {
-		gc::Ref<Entry>& table_entry_ref = (*m_table)[index];
-		gc::Local<Entry> table_entry = table_entry_ref;
-		table_entry_ref = gc::create<Entry>(table_entry, key, value);
+gc::WordLocal gc::BasicHashMap::put_0(const gc::WordLocal& key, const gc::WordLocal& value) {
+	assert(key.get_word());
+	assert(value.get_word());
 
-		++m_size;
-		if (m_size >= m_threshold) expand();
+	std::size_t hash = key_hash_code(key);
+	std::size_t free_slot;
+	std::size_t slot = find_slot(key, hash, free_slot);
+	if (slot != NOT_FOUND) {
+		gc::WordRef& value_ref = (*m_entries)[((*m_index)[slot] - SLOT_BASE) * 2 + 1];
+		gc::WordLocal old_value(value_ref.get_word());
+		value_ref.set_word(value.get_word());
+		return old_value;
+	}
 
-		return nullptr;
+	if (m_used == m_hashes->length()) {
+		//Removed entries are dropped; the capacity is doubled only if the map is more than half full.
+		std::size_t capacity = INITIAL_CAPACITY;
+		while (capacity < m_size * 2) capacity <<= 1;
+		rebuild(capacity);
+		find_slot(key, hash, free_slot);
 	}
+
+	std::size_t entry_idx = m_used++;
+	(*m_hashes)[entry_idx] = hash;
+	(*m_entries)[entry_idx * 2].set_word(key.get_word());
+	(*m_entries)[entry_idx * 2 + 1].set_word(value.get_word());
+	(*m_index)[free_slot] = entry_idx + SLOT_BASE;
+	++m_size;
+
+	return gc::WordLocal();
 }
 
-gc::Local<gc::Object> gc::BasicHashMap::remove_0(const gc::Local<Object>& key) {
-	gc::Local<Entry> prev;
-	std::size_t index;
-	gc::Local<Entry> entry = find_entry(key, prev, index);
-	if (!entry) return nullptr;
+gc::WordLocal gc::BasicHashMap::remove_0(const gc::WordLocal& key) {
+	std::size_t free_slot;
+	std::size_t slot = find_slot(key, key_hash_code(key), free_slot);
+	if (slot == NOT_FOUND) return gc::WordLocal();
 
-	if (!!prev) {
-		prev->set_next(entry->get_next());
-	} else {
-		(*m_table)[index] = entry->get_next();
-	}
+	std::size_t entry_idx = (*m_index)[slot] - SLOT_BASE;
+	(*m_index)[slot] = REMOVED_SLOT;
+
+	gc::WordRef& key_ref = (*m_entries)[entry_idx * 2];
+	gc::WordRef& value_ref = (*m_entries)[entry_idx * 2 + 1];
+	gc::WordLocal old_value(value_ref.get_word());
+	key_ref.set_word(0);
+	value_ref.set_word(0);
 	--m_size;
 
-	return entry->get_value();
+	return old_value;
 }
 
-void gc::BasicHashMap::expand() {
-	std::size_t capacity = m_table->length();
-	std::size_t new_capacity = capacity << 1;
-	if (new_capacity <= capacity || new_capacity >= SIZE_MAX) return;
+//Compacts the entries into new arrays of the given capacity and rebuilds the index table, which is kept at
+//most half full.
+void gc::BasicHashMap::rebuild(std::size_t capacity) {
+	assert(capacity > m_size);
 
-	gc::Local<gc::Array<Entry>> new_table = gc::Array<Entry>::create(new_capacity);
-	for (std::size_t i = 0; i < capacity; ++i) {
-		gc::Local<Entry> entry = (*m_table)[i];
-		while (!!entry) {
-			std::size_t hash = key_hash_code(entry->get_key());
-			std::size_t new_index = hash & (new_capacity - 1);
+	gc::Local<SizeArray> new_index = SizeArray::create(capacity * 2);
+	gc::Local<SizeArray> new_hashes = SizeArray::create(capacity);
+	gc::Local<EntryArray> new_entries = EntryArray::create(capacity * 2);
 
-			gc::Local<Entry> next = entry->get_next();
-			gc::Ref<Entry>& new_table_entry = (*new_table)[new_index];
-			entry->set_next(new_table_entry);
-			new_table_entry = entry;
-			entry = next;
-		}
-	}
+	SizeArray& index = *new_index;
+	for (std::size_t i = 0, len = index.length(); i < len; ++i) index[i] = EMPTY_SLOT;
 
-	m_table = new_table;
+	const std::size_t mask = index.length() - 1;
+	std::size_t new_used = 0;
+	for (std::size_t i = 0; i < m_used; ++i) {
+		std::uintptr_t key_word = (*m_entries)[i * 2].get_word();
+		if (!key_word) continue;
 
-	std::size_t new_threshold = (std::size_t)(LOAD_FACTOR * new_capacity);
-	//Overflow check.
-	if (new_threshold > m_threshold) m_threshold = new_threshold;
-}
+		std::size_t hash = (*m_hashes)[i];
+		(*new_hashes)[new_used] = hash;
+		(*new_entries)[new_used * 2].set_word(key_word);
+		(*new_entries)[new_used * 2 + 1].set_word((*m_entries)[i * 2 + 1].get_word());
 
-gc::Local<gc::BasicHashMap::Entry> gc::BasicHashMap::find_entry(
-	const gc::Local<Object>& key,
-	gc::Local<Entry>& prev_ref,
-	std::size_t& index_ref) const
-{
-	std::size_t hash = key_hash_code(key);
-	std::size_t capacity = m_table->length();
-	std::size_t index = hash & (capacity - 1);
-	index_ref = index;
+		std::size_t slot = spread_hash(hash) & mask;
+		while (index[slot] != EMPTY_SLOT) slot = (slot + 1) & mask;
+		index[slot] = new_used + SLOT_BASE;
+		++new_used;
+	}
 
-	gc::Local<Entry> prev;
-	gc::Local<Entry> entry = (*m_table)[index];
+	assert(new_used == m_size);
+	m_index = new_index;
+	m_hashes = new_hashes;
+	m_entries = new_entries;
+	m_used = new_used;
+}
 
-	while (!!entry) {
-		if (key_equals(key, entry->get_key())) {
-			prev_ref = prev;
-			return entry;
+//Returns the slot of the key, or NOT_FOUND; in the latter case, free_slot is set to the slot where the key
+//should be inserted.
+std::size_t gc::BasicHashMap::find_slot(
+	const gc::WordLocal& key,
+	std::size_t hash,
+	std::size_t& free_slot) const
+{
+	const SizeArray& index = *m_index;
+	const std::size_t mask = index.length() - 1;
+
+	free_slot = NOT_FOUND;
+	for (std::size_t slot = spread_hash(hash) & mask;; slot = (slot + 1) & mask) {
+		std::size_t value = index[slot];
+		if (value == EMPTY_SLOT) {
+			if (free_slot == NOT_FOUND) free_slot = slot;
+			return NOT_FOUND;
+		} else if (value == REMOVED_SLOT) {
+			if (free_slot == NOT_FOUND) free_slot = slot;
+		} else {
+			std::size_t entry_idx = value - SLOT_BASE;
+			if ((*m_hashes)[entry_idx] == hash) {
+				gc::WordLocal entry_key((*m_entries)[entry_idx * 2].get_word());
+				if (key_equals(key, entry_key)) return slot;
+			}
 		}
-		prev = entry;
-		entry = entry->get_next();
 	}
-
-	return nullptr;
 }
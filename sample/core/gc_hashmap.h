@@ -27,12 +27,12 @@
 namespace syn_script {
 	namespace gc {
 
-		template<class K> using HashCodeFn = std::size_t(const gc::Local<K>&);
-		template<class K> using EqualsFn = bool(const gc::Local<K>&, const gc::Local<K>&);
+		template<class L> using HashCodeFn = std::size_t(const L&);
+		template<class L> using EqualsFn = bool(const L&, const L&);
 
 		class BasicHashMap;
 
-		template<class K, class V, HashCodeFn<K> HashFn, EqualsFn<K> EqFn>
+		template<class L, class A, HashCodeFn<L> HashFn, EqualsFn<L> EqFn>
 		class BasicGenericHashMap;
 
 	}
@@ -42,38 +42,29 @@ namespace syn_script {
 //BasicHashMap
 //
 
+//Keys and values are word references, so they may be either objects or immediate values; zero words are not
+//allowed. Entries are stored in insertion order in contiguous arrays (cached hashes, and keys interleaved with
+//values); an open addressing index table with linear probing maps hashes to entries. A removed entry is cleared
+//and left in place until the arrays are rebuilt.
 class syn_script::gc::BasicHashMap : public gc::Object {
 	NONCOPYABLE(BasicHashMap);
 
-	static const float LOAD_FACTOR;
+	typedef gc::PrimitiveArray<std::size_t> SizeArray;
+	typedef gc::WordArray<gc::WordRef> EntryArray;
 
-	class Entry : public gc::Object {
-		NONCOPYABLE(Entry);
+	static const std::size_t INITIAL_CAPACITY = 8;
+	static const std::size_t NOT_FOUND = SIZE_MAX;
 
-		gc::Ref<Entry> m_next;
-		gc::Ref<Object> m_key;
-		gc::Ref<Object> m_value;
-
-	public:
-		Entry(){}
-		void gc_enumerate_refs() override;
-
-		void initialize(
-			const gc::Local<Entry>& next,
-			const gc::Local<Object>& key,
-			const gc::Local<Object>& value);
-
-		const gc::Ref<Entry>& get_next() const;
-		const gc::Ref<Object>& get_key() const;
-		const gc::Ref<Object>& get_value() const;
-
-		void set_next(const gc::Local<Entry>& next);
-		void set_value(const gc::Local<Object>& value);
-	};
+	//Index slots: empty, removed entry, or the index of an entry plus SLOT_BASE.
+	static const std::size_t EMPTY_SLOT = 0;
+	static const std::size_t REMOVED_SLOT = 1;
+	static const std::size_t SLOT_BASE = 2;
 
 	std::size_t m_size;
-	std::size_t m_threshold;
-	gc::Ref<gc::Array<Entry>> m_table;
+	std::size_t m_used;
+	gc::Ref<SizeArray> m_index;
+	gc::Ref<SizeArray> m_hashes;
+	gc::Ref<EntryArray> m_entries;
 
 protected:
 	BasicHashMap(){}
@@ -91,8 +82,7 @@ protected:
 		friend class BasicHashMap;
 
 		const gc::Local<const BasicHashMap> m_map;
-		std::size_t m_index;
-		gc::Local<Entry> m_entry;
+		std::size_t m_pos;
 
 	private:
 		BasicIterator(const gc::Local<const BasicHashMap>& map);
@@ -100,39 +90,41 @@ protected:
 	public:
 		bool end() const;
 		void next();
-		gc::Local<Object> key() const;
-		gc::Local<Object> value() const;
+		gc::WordLocal key() const;
+		gc::WordLocal value() const;
 
 	private:
-		void next_index();
+		void skip_removed();
 	};
 
 	BasicIterator basic_iterator() const;
 
-	bool contains_0(const gc::Local<Object>& key) const;
-	gc::Local<Object> get_0(const gc::Local<Object>& key) const;
-	gc::Local<Object> put_0(const gc::Local<Object>& key, const gc::Local<Object>& value);
-	gc::Local<Object> remove_0(const gc::Local<Object>& key);
+	bool contains_0(const gc::WordLocal& key) const;
+	gc::WordLocal get_0(const gc::WordLocal& key) const;
+	gc::WordLocal put_0(const gc::WordLocal& key, const gc::WordLocal& value);
+	gc::WordLocal remove_0(const gc::WordLocal& key);
 
-	virtual std::size_t key_hash_code(const gc::Local<Object>& key) const = 0;
-	virtual bool key_equals(const gc::Local<Object>& key1, const gc::Local<Object>& key2) const = 0;
+	virtual std::size_t key_hash_code(const gc::WordLocal& key) const = 0;
+	virtual bool key_equals(const gc::WordLocal& key1, const gc::WordLocal& key2) const = 0;
 
 private:
-	void expand();
-	gc::Local<Entry> find_entry(const gc::Local<Object>& key, gc::Local<Entry>& prev, std::size_t& index) const;
+	void rebuild(std::size_t capacity);
+	std::size_t find_slot(const gc::WordLocal& key, std::size_t hash, std::size_t& free_slot) const;
 };
 
 //
 //BasicGenericHashMap
 //
 
-template<class K, class V, syn_script::gc::HashCodeFn<K> HashFn, syn_script::gc::EqualsFn<K> EqFn>
+//L is the class of local references to keys and values (derived from gc::WordLocal), A - the class of arrays
+//returned by keys() and values().
+template<class L, class A, syn_script::gc::HashCodeFn<L> HashFn, syn_script::gc::EqualsFn<L> EqFn>
 class syn_script::gc::BasicGenericHashMap : public BasicHashMap {
 	NONCOPYABLE(BasicGenericHashMap);
 
 public:
 	class Iterator {
-		friend class BasicGenericHashMap<K, V, HashFn, EqFn>;
+		friend class BasicGenericHashMap<L, A, HashFn, EqFn>;
 
 		BasicIterator m_iter;
 
@@ -148,35 +140,32 @@ public:
 			m_iter.next();
 		}
 
-		gc::Local<K> key() const {
-			return m_iter.key().stat_cast<K>();
+		L key() const {
+			return L(m_iter.key());
 		}
 
-		gc::Local<V> value() const {
-			return m_iter.value().stat_cast<V>();
+		L value() const {
+			return L(m_iter.value());
 		}
 	};
 
 public:
 	BasicGenericHashMap(){}
 
-	bool contains(const gc::Local<K>& key) const {
+	bool contains(const L& key) const {
 		return contains_0(key);
 	}
 
-	gc::Local<V> get(const gc::Local<K>& key) const {
-		gc::Local<Object> value0 = get_0(key);
-		return value0.stat_cast<V>();
+	L get(const L& key) const {
+		return L(get_0(key));
 	}
 
-	gc::Local<V> put(const gc::Local<K>& key, const gc::Local<V>& value) {
-		gc::Local<Object> old_value0 = put_0(key, value);
-		return old_value0.stat_cast<V>();
+	L put(const L& key, const L& value) {
+		return L(put_0(key, value));
 	}
 
-	gc::Local<V> remove(const gc::Local<K>& key) {
-		gc::Local<Object> value0 = remove_0(key);
-		return value0.stat_cast<V>();
+	L remove(const L& key) {
+		return L(remove_0(key));
 	}
 
 	Iterator iterator() const {
@@ -184,40 +173,40 @@ public:
 	}
 
 private:
-	template<class T, gc::Local<Object> (BasicIterator::*Fn)() const>
-	gc::Local<gc::Array<T>> elements() const {
+	template<gc::WordLocal (BasicIterator::*Fn)() const>
+	gc::Local<A> elements() const {
 		std::size_t cnt = size();
-		gc::Local<gc::Array<T>> array = gc::Array<T>::create(cnt);
+		gc::Local<A> array = A::create(cnt);
 
+		std::size_t idx = 0;
 		BasicIterator iter = basic_iterator();
-		while (cnt && !iter.end()) {
-			--cnt;
-			(*array)[cnt] = (iter.*Fn)().stat_cast<T>();
+		while (idx < cnt && !iter.end()) {
+			(*array)[idx++] = L((iter.*Fn)());
 			iter.next();
 		}
 
-		assert(!cnt);
+		assert(idx == cnt);
 		assert(iter.end());
 
 		return array;
 	}
 
 public:
-	gc::Local<gc::Array<K>> keys() const {
-		return elements<K, &BasicIterator::key>();
+	gc::Local<A> keys() const {
+		return elements<&BasicIterator::key>();
 	}
 
-	gc::Local<gc::Array<V>> values() const {
-		return elements<V, &BasicIterator::value>();
+	gc::Local<A> values() const {
+		return elements<&BasicIterator::value>();
 	}
 
 protected:
-	std::size_t key_hash_code(const gc::Local<Object>& key) const override {
-		return HashFn(key.stat_cast<K>());
+	std::size_t key_hash_code(const gc::WordLocal& key) const override {
+		return HashFn(L(key));
 	}
 
-	bool key_equals(const gc::Local<Object>& key1, const gc::Local<Object>& key2) const override {
-		return EqFn(key1.stat_cast<K>(), key2.stat_cast<K>());
+	bool key_equals(const gc::WordLocal& key1, const gc::WordLocal& key2) const override {
+		return EqFn(L(key1), L(key2));
 	}
 };
 
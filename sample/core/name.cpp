@@ -16,10 +16,9 @@
 
 //Names handling.
 
-#include <list>
-#include <map>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include "common.h"
 #include "gc.h"
@@ -53,6 +52,10 @@ bool ss::NameID::operator<(const NameID& b) const {
 	return m_name_id < b.m_name_id;
 }
 
+std::size_t ss::NameID::hash_code() const {
+	return m_name_id;
+}
+
 //
 //NameInfo
 //
@@ -79,70 +82,129 @@ const ss::StringRef& ss::NameInfo::get_str() const {
 //NameTable::Internal
 //
 
+namespace {
+	template<class Key>
+	std::size_t calc_name_hash(const Key& key) {
+		std::size_t hash = 0;
+		for (std::size_t i = 0, n = key.length(); i < n; ++i) hash = ss::update_name_hash(hash, key.char_at(i));
+		return hash;
+	}
+}
+
+//Names are interned in an open addressing hash table with linear probing. A slot contains the ID of a name plus
+//one, or zero if the slot is empty.
 class ss::NameTable::Internal {
 	NONCOPYABLE(Internal);
 
+	static const std::size_t INITIAL_CAPACITY = 1024;
+
+	//Held by a NameRegistry for its whole lifetime. Names are allocated while it is held, so it is locked by
+	//gc::lock_guard.
 	std::mutex m_mutex;
 	gc::Local<gc::Vector<const NameInfo>> m_id_to_info;
-	std::map<StringKeyValue, std::size_t> m_name_to_id;
-	std::list<GCPtrStringKey> m_owned_keys;
-	gc::Local<gc::Vector<const String>> m_owned_names;
+	std::vector<std::size_t> m_id_to_hash;
+	std::vector<std::size_t> m_slots;
 
 public:
 	Internal()
 		: m_id_to_info(gc::create<gc::Vector<const NameInfo>>()),
-		m_owned_names(gc::create<gc::Vector<const String>>())
+		m_slots(INITIAL_CAPACITY, 0)
 	{}
 
 private:
-	gc::Local<const NameInfo> lookup_name(const StringKey& key) const {
-		auto iter = m_name_to_id.find(StringKeyValue(key));
-		if (iter != m_name_to_id.end()) {
-			std::size_t id = iter->second;
-			return m_id_to_info->get(id);
+	template<class Key>
+	static bool name_equals(const gc::Local<const NameInfo>& info, const Key& key) {
+		const StringRef& str = info->get_str();
+		const std::size_t len = key.length();
+		if (str->length() != len) return false;
+
+		const char* data = str->get_raw_data();
+		for (std::size_t i = 0; i < len; ++i) {
+			if (data[i] != key.char_at(i)) return false;
+		}
+		return true;
+	}
+
+	//Returns the name, or null and the index of the empty slot where the name has to be inserted.
+	template<class Key>
+	gc::Local<const NameInfo> lookup_name(const Key& key, std::size_t hash, std::size_t& slot_idx) const {
+		const std::size_t mask = m_slots.size() - 1;
+		for (std::size_t idx = hash & mask;; idx = (idx + 1) & mask) {
+			const std::size_t slot = m_slots[idx];
+			if (!slot) {
+				slot_idx = idx;
+				return nullptr;
+			}
+
+			const std::size_t id = slot - 1;
+			if (m_id_to_hash[id] == hash) {
+				gc::Local<const NameInfo> info = m_id_to_info->get(id);
+				if (name_equals(info, key)) return info;
+			}
 		}
-		return nullptr;
 	}
 
-	gc::Local<const NameInfo> do_register_name(const StringLoc& name) {
+	gc::Local<const NameInfo> do_register_name(const StringLoc& name, std::size_t hash, std::size_t slot_idx) {
 		std::size_t name_id = m_id_to_info->size();
 		gc::Local<const NameInfo> info = gc::create<NameInfo>(NameID(name_id), name);
 
-		m_owned_names->add(name);
-		m_owned_keys.push_back(GCPtrStringKey(name.get()));
-		m_name_to_id[StringKeyValue(m_owned_keys.back())] = name_id;
 		m_id_to_info->add(info);
+		m_id_to_hash.push_back(hash);
+		m_slots[slot_idx] = name_id + 1;
+
+		//The load factor is kept below 1/2.
+		if (m_id_to_hash.size() * 2 > m_slots.size()) rehash(m_slots.size() * 2);
 
 		return info;
 	}
 
+	void rehash(std::size_t capacity) {
+		m_slots.assign(capacity, 0);
+		const std::size_t mask = capacity - 1;
+		for (std::size_t id = 0, n = m_id_to_hash.size(); id < n; ++id) {
+			std::size_t idx = m_id_to_hash[id] & mask;
+			while (m_slots[idx]) idx = (idx + 1) & mask;
+			m_slots[idx] = id + 1;
+		}
+	}
+
 public:
 	gc::Local<const NameInfo> register_name(
 		const StringIterator& start_pos,
-		const StringIterator& end_pos)
+		const StringIterator& end_pos,
+		std::size_t hash)
 	{
 		GCPtrStringKey key = start_pos.get_string_key(end_pos);
-		gc::Local<const NameInfo> info = lookup_name(key);
+		assert(calc_name_hash(key) == hash);
+
+		std::size_t slot_idx = 0;
+		gc::Local<const NameInfo> info = lookup_name(key, hash, slot_idx);
 		if (!!info) return info;
 
 		StringLoc name = start_pos.get_string(end_pos);
-		return do_register_name(name);
+		return do_register_name(name, hash, slot_idx);
 	}
 
 	gc::Local<const NameInfo> register_name(const StringLoc& name) {
 		GCStringKey key(name);
-		gc::Local<const NameInfo> info = lookup_name(key);
+		std::size_t hash = calc_name_hash(key);
+
+		std::size_t slot_idx = 0;
+		gc::Local<const NameInfo> info = lookup_name(key, hash, slot_idx);
 		if (!!info) return info;
-		return do_register_name(name);
+		return do_register_name(name, hash, slot_idx);
 	}
 
 	gc::Local<const NameInfo> register_name(const std::string& str) {
 		StdStringKey key(str);
-		gc::Local<const NameInfo> info = lookup_name(key);
+		std::size_t hash = calc_name_hash(key);
+
+		std::size_t slot_idx = 0;
+		gc::Local<const NameInfo> info = lookup_name(key, hash, slot_idx);
 		if (!!info) return info;
 
 		StringLoc name = gc::create<String>(str);
-		return do_register_name(name);
+		return do_register_name(name, hash, slot_idx);
 	}
 
 	std::mutex& get_mutex() {
@@ -170,7 +232,7 @@ class ss::NameRegistry::Internal {
 	NONCOPYABLE(Internal);
 
 	NameTable& m_name_table;
-	std::lock_guard<std::mutex> m_name_table_lock;
+	gc::lock_guard m_name_table_lock;
 
 public:
 	Internal(NameTable& name_table)
@@ -188,9 +250,10 @@ public:
 
 	gc::Local<const NameInfo> register_name(
 		const StringIterator& start_pos,
-		const StringIterator& end_pos)
+		const StringIterator& end_pos,
+		std::size_t hash)
 	{
-		return m_name_table.m_internal->register_name(start_pos, end_pos);
+		return m_name_table.m_internal->register_name(start_pos, end_pos, hash);
 	}
 };
 
@@ -216,7 +279,8 @@ gc::Local<const ss::NameInfo> ss::NameRegistry::register_name(const std::string&
 
 gc::Local<const ss::NameInfo> ss::NameRegistry::register_name(
 	const StringIterator& start_pos,
-	const StringIterator& end_pos)
+	const StringIterator& end_pos,
+	std::size_t hash)
 {
-	return m_internal->register_name(start_pos, end_pos);
+	return m_internal->register_name(start_pos, end_pos, hash);
 }
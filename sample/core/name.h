@@ -45,8 +45,22 @@ namespace syn_script {
 		bool operator!() const;
 		bool operator==(const NameID& b) const;
 		bool operator<(const NameID& b) const;
+
+		std::size_t hash_code() const;
+	};
+
+	//Hash function object for NameID, used by unordered containers.
+	struct NameIDHash {
+		std::size_t operator()(const NameID& id) const {
+			return id.hash_code();
+		}
 	};
 
+	//Adds a character to the hash of a name. The scanner calculates the hash while scanning an identifier.
+	inline std::size_t update_name_hash(std::size_t hash, char c) {
+		return hash * 31 + static_cast<unsigned char>(c);
+	}
+
 	//
 	//NameInfo
 	//
@@ -101,9 +115,11 @@ namespace syn_script {
 
 		gc::Local<const NameInfo> register_name(const std::string& str);
 
+		//The hash must be calculated by update_name_hash().
 		gc::Local<const NameInfo> register_name(
 			const StringIterator& start_pos,
-			const StringIterator& end_pos);
+			const StringIterator& end_pos,
+			std::size_t hash);
 	};
 
 }
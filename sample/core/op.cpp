@@ -37,9 +37,9 @@ ss::RuntimeError rt::Operator::type_missmatch_error() const {
 //UnaryOperator
 //
 
-gc::Local<rt::Value> rt::UnaryOperator::evaluate(
+rt::ValueLoc rt::UnaryOperator::evaluate(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<Value>& a) const
+	const ValueLoc& a) const
 {
 	OperandType type = a->get_operand_type();
 	return evaluate_0(context, type, a);
@@ -51,10 +51,10 @@ gc::Local<rt::Value> rt::UnaryOperator::evaluate(
 
 const rt::PlusUnaryOperator rt::PlusUnaryOperator::Instance;
 
-gc::Local<rt::Value> rt::PlusUnaryOperator::evaluate_0(
+rt::ValueLoc rt::PlusUnaryOperator::evaluate_0(
 	const gc::Local<ExecContext>& context,
 	OperandType type,
-	const gc::Local<Value>& a) const
+	const ValueLoc& a) const
 {
 	if (OperandType::INTEGER != type && OperandType::FLOAT != type) throw type_missmatch_error();
 	return a;
@@ -66,10 +66,10 @@ gc::Local<rt::Value> rt::PlusUnaryOperator::evaluate_0(
 
 const rt::MinusUnaryOperator rt::MinusUnaryOperator::Instance;
 
-gc::Local<rt::Value> rt::MinusUnaryOperator::evaluate_0(
+rt::ValueLoc rt::MinusUnaryOperator::evaluate_0(
 	const gc::Local<ExecContext>& context,
 	OperandType type,
-	const gc::Local<Value>& a) const
+	const ValueLoc& a) const
 {
 	if (OperandType::INTEGER == type) {
 		ScriptIntegerType v = a->get_integer();
@@ -89,10 +89,10 @@ gc::Local<rt::Value> rt::MinusUnaryOperator::evaluate_0(
 
 const rt::LogicalNotUnaryOperator rt::LogicalNotUnaryOperator::Instance;
 
-gc::Local<rt::Value> rt::LogicalNotUnaryOperator::evaluate_0(
+rt::ValueLoc rt::LogicalNotUnaryOperator::evaluate_0(
 	const gc::Local<ExecContext>& context,
 	OperandType type,
-	const gc::Local<Value>& a) const
+	const ValueLoc& a) const
 {
 	if (OperandType::BOOLEAN != type) throw type_missmatch_error();
 	bool v = a->get_boolean();
@@ -103,27 +103,34 @@ gc::Local<rt::Value> rt::LogicalNotUnaryOperator::evaluate_0(
 //BinaryOperator
 //
 
-gc::Local<rt::Value> rt::BinaryOperator::evaluate_short(
+rt::ValueLoc rt::BinaryOperator::evaluate_short(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<Value>& a) const
+	const ValueLoc& a) const
 {
 	return nullptr;
 }
 
-gc::Local<rt::Value> rt::BinaryOperator::evaluate(
+rt::ValueLoc rt::BinaryOperator::evaluate(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<Value>& a,
-	const gc::Local<Value>& b) const
-{
+	const ValueLoc& a,
+	const ValueLoc& b) const
+{
+	std::uintptr_t word_a = a.get_word();
+	std::uintptr_t word_b = b.get_word();
+	if (ValueWord::is_integer(word_a) && ValueWord::is_integer(word_b)) {
+		//Both operands are immediate integers: no need to determine the types.
+		return evaluate_integer(context, a, b, ValueWord::decode_integer(word_a), ValueWord::decode_integer(word_b));
+	}
+
 	OperandType type_a = a->get_operand_type();
 	OperandType type_b = b->get_operand_type();
 	return evaluate_by_type(context, a, b, type_a, type_b);
 }
 
-gc::Local<rt::Value> rt::BinaryOperator::evaluate_by_type(
+rt::ValueLoc rt::BinaryOperator::evaluate_by_type(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<Value>& a,
-	const gc::Local<Value>& b,
+	const ValueLoc& a,
+	const ValueLoc& b,
 	OperandType type_a,
 	OperandType type_b) const
 {
@@ -152,40 +159,40 @@ gc::Local<rt::Value> rt::BinaryOperator::evaluate_by_type(
 	}
 }
 
-gc::Local<rt::Value> rt::BinaryOperator::evaluate_integer(
+rt::ValueLoc rt::BinaryOperator::evaluate_integer(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<Value>& a,
-	const gc::Local<Value>& b,
+	const ValueLoc& a,
+	const ValueLoc& b,
 	ss::ScriptIntegerType value_a,
 	ss::ScriptIntegerType value_b) const
 {
 	throw type_missmatch_error();
 }
 
-gc::Local<rt::Value> rt::BinaryOperator::evaluate_float(
+rt::ValueLoc rt::BinaryOperator::evaluate_float(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<Value>& a,
-	const gc::Local<Value>& b,
+	const ValueLoc& a,
+	const ValueLoc& b,
 	ss::ScriptFloatType value_a,
 	ss::ScriptFloatType value_b) const
 {
 	throw type_missmatch_error();
 }
 
-gc::Local<rt::Value> rt::BinaryOperator::evaluate_boolean(
+rt::ValueLoc rt::BinaryOperator::evaluate_boolean(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<Value>& a,
-	const gc::Local<Value>& b,
+	const ValueLoc& a,
+	const ValueLoc& b,
 	bool value_a,
 	bool value_b) const
 {
 	throw type_missmatch_error();
 }
 
-gc::Local<rt::Value> rt::BinaryOperator::evaluate_string(
+rt::ValueLoc rt::BinaryOperator::evaluate_string(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<Value>& a,
-	const gc::Local<Value>& b,
+	const ValueLoc& a,
+	const ValueLoc& b,
 	const ss::StringLoc& value_a,
 	const ss::StringLoc& value_b) const
 {
@@ -193,7 +200,7 @@ gc::Local<rt::Value> rt::BinaryOperator::evaluate_string(
 }
 
 ss::ScriptFloatType rt::BinaryOperator::float_promotion(
-	const gc::Local<Value>& value,
+	const ValueLoc& value,
 	OperandType type) const
 {
 	if (OperandType::INTEGER == type) {
@@ -209,9 +216,9 @@ ss::ScriptFloatType rt::BinaryOperator::float_promotion(
 //LogicalBinaryOperator
 //
 
-gc::Local<rt::Value> rt::LogicalBinaryOperator::evaluate_short(
+rt::ValueLoc rt::LogicalBinaryOperator::evaluate_short(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<Value>& a) const
+	const ValueLoc& a) const
 {
 	if (OperandType::BOOLEAN == a->get_operand_type()) {
 		bool value = a->get_boolean();
@@ -226,10 +233,10 @@ gc::Local<rt::Value> rt::LogicalBinaryOperator::evaluate_short(
 	}
 }
 
-gc::Local<rt::Value> rt::LogicalBinaryOperator::evaluate_boolean(
+rt::ValueLoc rt::LogicalBinaryOperator::evaluate_boolean(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<Value>& a,
-	const gc::Local<Value>& b,
+	const ValueLoc& a,
+	const ValueLoc& b,
 	bool value_a,
 	bool value_b) const
 {
@@ -287,10 +294,10 @@ namespace {
 	}
 }
 
-gc::Local<rt::Value> rt::EqNeBinaryOperator::evaluate_by_type(
+rt::ValueLoc rt::EqNeBinaryOperator::evaluate_by_type(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<Value>& a,
-	const gc::Local<Value>& b,
+	const ValueLoc& a,
+	const ValueLoc& b,
 	OperandType type_a,
 	OperandType type_b) const
 {
@@ -307,47 +314,47 @@ gc::Local<rt::Value> rt::EqNeBinaryOperator::evaluate_by_type(
 	return BinaryOperator::evaluate_by_type(context, a, b, type_a, type_b);
 }
 
-gc::Local<rt::Value> rt::EqNeBinaryOperator::evaluate_integer(
+rt::ValueLoc rt::EqNeBinaryOperator::evaluate_integer(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<Value>& a,
-	const gc::Local<Value>& b,
+	const ValueLoc& a,
+	const ValueLoc& b,
 	ss::ScriptIntegerType value_a,
 	ss::ScriptIntegerType value_b) const
 {
 	return get_result_value(context, value_a == value_b);
 }
 
-gc::Local<rt::Value> rt::EqNeBinaryOperator::evaluate_float(
+rt::ValueLoc rt::EqNeBinaryOperator::evaluate_float(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<Value>& a,
-	const gc::Local<Value>& b,
+	const ValueLoc& a,
+	const ValueLoc& b,
 	ss::ScriptFloatType value_a,
 	ss::ScriptFloatType value_b) const
 {
 	return get_result_value(context, value_a == value_b);
 }
 
-gc::Local<rt::Value> rt::EqNeBinaryOperator::evaluate_boolean(
+rt::ValueLoc rt::EqNeBinaryOperator::evaluate_boolean(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<Value>& a,
-	const gc::Local<Value>& b,
+	const ValueLoc& a,
+	const ValueLoc& b,
 	bool value_a,
 	bool value_b) const
 {
 	return get_result_value(context, value_a == value_b);
 }
 
-gc::Local<rt::Value> rt::EqNeBinaryOperator::evaluate_string(
+rt::ValueLoc rt::EqNeBinaryOperator::evaluate_string(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<Value>& a,
-	const gc::Local<Value>& b,
+	const ValueLoc& a,
+	const ValueLoc& b,
 	const ss::StringLoc& value_a,
 	const ss::StringLoc& value_b) const
 {
 	return get_result_value(context, value_a->equals(value_b));
 }
 
-gc::Local<rt::Value> rt::EqNeBinaryOperator::get_result_value(
+rt::ValueLoc rt::EqNeBinaryOperator::get_result_value(
 	const gc::Local<ExecContext>& context,
 	bool eq) const
 {
@@ -379,10 +386,10 @@ bool rt::NeBinaryOperator::get_result(bool eq) const {
 //RelBinaryOperator
 //
 
-gc::Local<rt::Value> rt::RelBinaryOperator::evaluate_integer(
+rt::ValueLoc rt::RelBinaryOperator::evaluate_integer(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<Value>& a,
-	const gc::Local<Value>& b,
+	const ValueLoc& a,
+	const ValueLoc& b,
 	ss::ScriptIntegerType value_a,
 	ss::ScriptIntegerType value_b) const
 {
@@ -400,10 +407,10 @@ gc::Local<rt::Value> rt::RelBinaryOperator::evaluate_integer(
 	return context->get_value_factory()->get_boolean_value(result);
 }
 
-gc::Local<rt::Value> rt::RelBinaryOperator::evaluate_float(
+rt::ValueLoc rt::RelBinaryOperator::evaluate_float(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<Value>& a,
-	const gc::Local<Value>& b,
+	const ValueLoc& a,
+	const ValueLoc& b,
 	ss::ScriptFloatType value_a,
 	ss::ScriptFloatType value_b) const
 {
@@ -412,10 +419,10 @@ gc::Local<rt::Value> rt::RelBinaryOperator::evaluate_float(
 	return context->get_value_factory()->get_boolean_value(result);
 }
 
-gc::Local<rt::Value> rt::RelBinaryOperator::evaluate_string(
+rt::ValueLoc rt::RelBinaryOperator::evaluate_string(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<Value>& a,
-	const gc::Local<Value>& b,
+	const ValueLoc& a,
+	const ValueLoc& b,
 	const ss::StringLoc& value_a,
 	const ss::StringLoc& value_b) const
 {
@@ -468,10 +475,10 @@ bool rt::GeBinaryOperator::get_result(int rel) const {
 //ArithmeticalBinaryOperator
 //
 
-gc::Local<rt::Value> rt::ArithmeticalBinaryOperator::evaluate_integer(
+rt::ValueLoc rt::ArithmeticalBinaryOperator::evaluate_integer(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<Value>& a,
-	const gc::Local<Value>& b,
+	const ValueLoc& a,
+	const ValueLoc& b,
 	ss::ScriptIntegerType value_a,
 	ss::ScriptIntegerType value_b) const
 {
@@ -479,10 +486,10 @@ gc::Local<rt::Value> rt::ArithmeticalBinaryOperator::evaluate_integer(
 	return context->get_value_factory()->get_integer_value(result);
 }
 
-gc::Local<rt::Value> rt::ArithmeticalBinaryOperator::evaluate_float(
+rt::ValueLoc rt::ArithmeticalBinaryOperator::evaluate_float(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<Value>& a,
-	const gc::Local<Value>& b,
+	const ValueLoc& a,
+	const ValueLoc& b,
 	ss::ScriptFloatType value_a,
 	ss::ScriptFloatType value_b) const
 {
@@ -496,10 +503,10 @@ gc::Local<rt::Value> rt::ArithmeticalBinaryOperator::evaluate_float(
 
 const rt::AddBinaryOperator rt::AddBinaryOperator::Instance;
 
-gc::Local<rt::Value> rt::AddBinaryOperator::evaluate_by_type(
+rt::ValueLoc rt::AddBinaryOperator::evaluate_by_type(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<Value>& a,
-	const gc::Local<Value>& b,
+	const ValueLoc& a,
+	const ValueLoc& b,
 	OperandType type_a,
 	OperandType type_b) const
 {
@@ -51,15 +51,15 @@ namespace syn_script {
 			UnaryOperator(){}
 
 		public:
-			gc::Local<Value> evaluate(
+			ValueLoc evaluate(
 				const gc::Local<ExecContext>& context,
-				const gc::Local<Value>& a) const;
+				const ValueLoc& a) const;
 
 		protected:
-			virtual gc::Local<Value> evaluate_0(
+			virtual ValueLoc evaluate_0(
 				const gc::Local<ExecContext>& context,
 				OperandType type,
-				const gc::Local<Value>& a) const = 0;
+				const ValueLoc& a) const = 0;
 		};
 
 		//
@@ -75,10 +75,10 @@ namespace syn_script {
 			static const PlusUnaryOperator Instance;
 
 		protected:
-			gc::Local<Value> evaluate_0(
+			ValueLoc evaluate_0(
 				const gc::Local<ExecContext>& context,
 				OperandType type,
-				const gc::Local<Value>& a) const override;
+				const ValueLoc& a) const override;
 		};
 
 		//
@@ -94,10 +94,10 @@ namespace syn_script {
 			static const MinusUnaryOperator Instance;
 
 		protected:
-			gc::Local<Value> evaluate_0(
+			ValueLoc evaluate_0(
 				const gc::Local<ExecContext>& context,
 				OperandType type,
-				const gc::Local<Value>& a) const override;
+				const ValueLoc& a) const override;
 		};
 
 		//
@@ -113,10 +113,10 @@ namespace syn_script {
 			static const LogicalNotUnaryOperator Instance;
 
 		protected:
-			gc::Local<Value> evaluate_0(
+			ValueLoc evaluate_0(
 				const gc::Local<ExecContext>& context,
 				OperandType type,
-				const gc::Local<Value>& a) const override;
+				const ValueLoc& a) const override;
 		};
 
 		//
@@ -130,53 +130,53 @@ namespace syn_script {
 			BinaryOperator(){}
 
 		public:
-			virtual gc::Local<Value> evaluate_short(
+			virtual ValueLoc evaluate_short(
 				const gc::Local<ExecContext>& context,
-				const gc::Local<Value>& a) const;
+				const ValueLoc& a) const;
 
-			gc::Local<Value> evaluate(
+			ValueLoc evaluate(
 				const gc::Local<ExecContext>& context,
-				const gc::Local<Value>& a,
-				const gc::Local<Value>& b) const;
+				const ValueLoc& a,
+				const ValueLoc& b) const;
 
 		protected:
-			virtual gc::Local<Value> evaluate_by_type(
+			virtual ValueLoc evaluate_by_type(
 				const gc::Local<ExecContext>& context,
-				const gc::Local<Value>& a,
-				const gc::Local<Value>& b,
+				const ValueLoc& a,
+				const ValueLoc& b,
 				OperandType type_a,
 				OperandType type_b) const;
 
-			virtual gc::Local<Value> evaluate_integer(
+			virtual ValueLoc evaluate_integer(
 				const gc::Local<ExecContext>& context,
-				const gc::Local<Value>& a,
-				const gc::Local<Value>& b,
+				const ValueLoc& a,
+				const ValueLoc& b,
 				ScriptIntegerType value_a,
 				ScriptIntegerType value_b) const;
 
-			virtual gc::Local<Value> evaluate_float(
+			virtual ValueLoc evaluate_float(
 				const gc::Local<ExecContext>& context,
-				const gc::Local<Value>& a,
-				const gc::Local<Value>& b,
+				const ValueLoc& a,
+				const ValueLoc& b,
 				ScriptFloatType value_a,
 				ScriptFloatType value_b) const;
 
-			virtual gc::Local<Value> evaluate_boolean(
+			virtual ValueLoc evaluate_boolean(
 				const gc::Local<ExecContext>& context,
-				const gc::Local<Value>& a,
-				const gc::Local<Value>& b,
+				const ValueLoc& a,
+				const ValueLoc& b,
 				bool value_a,
 				bool value_b) const;
 
-			virtual gc::Local<Value> evaluate_string(
+			virtual ValueLoc evaluate_string(
 				const gc::Local<ExecContext>& context,
-				const gc::Local<Value>& a,
-				const gc::Local<Value>& b,
+				const ValueLoc& a,
+				const ValueLoc& b,
 				const StringLoc& value_a,
 				const StringLoc& value_b) const;
 
 		private:
-			ScriptFloatType float_promotion(const gc::Local<Value>& value, OperandType type) const;
+			ScriptFloatType float_promotion(const ValueLoc& value, OperandType type) const;
 		};
 
 		//
@@ -190,15 +190,15 @@ namespace syn_script {
 			LogicalBinaryOperator(){}
 
 		public:
-			gc::Local<Value> evaluate_short(
+			ValueLoc evaluate_short(
 				const gc::Local<ExecContext>& context,
-				const gc::Local<Value>& a) const override final;
+				const ValueLoc& a) const override final;
 
 		protected:
-			gc::Local<Value> evaluate_boolean(
+			ValueLoc evaluate_boolean(
 				const gc::Local<ExecContext>& context,
-				const gc::Local<Value>& a,
-				const gc::Local<Value>& b,
+				const ValueLoc& a,
+				const ValueLoc& b,
 				bool value_a,
 				bool value_b) const override;
 
@@ -250,45 +250,45 @@ namespace syn_script {
 		protected:
 			EqNeBinaryOperator(){}
 
-			gc::Local<Value> evaluate_by_type(
+			ValueLoc evaluate_by_type(
 				const gc::Local<ExecContext>& context,
-				const gc::Local<Value>& a,
-				const gc::Local<Value>& b,
+				const ValueLoc& a,
+				const ValueLoc& b,
 				OperandType type_a,
 				OperandType type_b) const override final;
 
-			gc::Local<Value> evaluate_integer(
+			ValueLoc evaluate_integer(
 				const gc::Local<ExecContext>& context,
-				const gc::Local<Value>& a,
-				const gc::Local<Value>& b,
+				const ValueLoc& a,
+				const ValueLoc& b,
 				ScriptIntegerType value_a,
 				ScriptIntegerType value_b) const override final;
 
-			gc::Local<Value> evaluate_float(
+			ValueLoc evaluate_float(
 				const gc::Local<ExecContext>& context,
-				const gc::Local<Value>& a,
-				const gc::Local<Value>& b,
+				const ValueLoc& a,
+				const ValueLoc& b,
 				ScriptFloatType value_a,
 				ScriptFloatType value_b) const override final;
 
-			gc::Local<Value> evaluate_boolean(
+			ValueLoc evaluate_boolean(
 				const gc::Local<ExecContext>& context,
-				const gc::Local<Value>& a,
-				const gc::Local<Value>& b,
+				const ValueLoc& a,
+				const ValueLoc& b,
 				bool value_a,
 				bool value_b) const override final;
 
-			gc::Local<Value> evaluate_string(
+			ValueLoc evaluate_string(
 				const gc::Local<ExecContext>& context,
-				const gc::Local<Value>& a,
-				const gc::Local<Value>& b,
+				const ValueLoc& a,
+				const ValueLoc& b,
 				const StringLoc& value_a,
 				const StringLoc& value_b) const override final;
 
 			virtual bool get_result(bool eq) const = 0;
 
 		private:
-			gc::Local<Value> get_result_value(const gc::Local<ExecContext>& context, bool eq) const;
+			ValueLoc get_result_value(const gc::Local<ExecContext>& context, bool eq) const;
 		};
 
 		//
@@ -333,24 +333,24 @@ namespace syn_script {
 		protected:
 			RelBinaryOperator(){}
 
-			gc::Local<Value> evaluate_integer(
+			ValueLoc evaluate_integer(
 				const gc::Local<ExecContext>& context,
-				const gc::Local<Value>& a,
-				const gc::Local<Value>& b,
+				const ValueLoc& a,
+				const ValueLoc& b,
 				ScriptIntegerType value_a,
 				ScriptIntegerType value_b) const override final;
 
-			gc::Local<Value> evaluate_float(
+			ValueLoc evaluate_float(
 				const gc::Local<ExecContext>& context,
-				const gc::Local<Value>& a,
-				const gc::Local<Value>& b,
+				const ValueLoc& a,
+				const ValueLoc& b,
 				ScriptFloatType value_a,
 				ScriptFloatType value_b) const override final;
 
-			gc::Local<Value> evaluate_string(
+			ValueLoc evaluate_string(
 				const gc::Local<ExecContext>& context,
-				const gc::Local<Value>& a,
-				const gc::Local<Value>& b,
+				const ValueLoc& a,
+				const ValueLoc& b,
 				const StringLoc& value_a,
 				const StringLoc& value_b) const override final;
 
@@ -431,17 +431,17 @@ namespace syn_script {
 		protected:
 			ArithmeticalBinaryOperator(){}
 
-			gc::Local<Value> evaluate_integer(
+			ValueLoc evaluate_integer(
 				const gc::Local<ExecContext>& context,
-				const gc::Local<Value>& a,
-				const gc::Local<Value>& b,
+				const ValueLoc& a,
+				const ValueLoc& b,
 				ScriptIntegerType value_a,
 				ScriptIntegerType value_b) const override final;
 
-			gc::Local<Value> evaluate_float(
+			ValueLoc evaluate_float(
 				const gc::Local<ExecContext>& context,
-				const gc::Local<Value>& a,
-				const gc::Local<Value>& b,
+				const ValueLoc& a,
+				const ValueLoc& b,
 				ScriptFloatType value_a,
 				ScriptFloatType value_b) const override final;
 
@@ -467,10 +467,10 @@ namespace syn_script {
 			static const AddBinaryOperator Instance;
 
 		protected:
-			gc::Local<Value> evaluate_by_type(
+			ValueLoc evaluate_by_type(
 				const gc::Local<ExecContext>& context,
-				const gc::Local<Value>& a,
-				const gc::Local<Value>& b,
+				const ValueLoc& a,
+				const ValueLoc& b,
 				OperandType type_a,
 				OperandType type_b) const override;
 
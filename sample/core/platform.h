@@ -19,6 +19,8 @@
 #ifndef SYNSAMPLE_CORE_PLATFORM_H_INCLUDED
 #define SYNSAMPLE_CORE_PLATFORM_H_INCLUDED
 
+#include <cstddef>
+
 #ifdef _MSC_VER 
 #include <Windows.h>
 #endif
@@ -69,6 +71,16 @@ namespace syn_script {
 
 		void get_current_time(DateTime& time);
 
+		//Allocates a block of virtual memory. Physical memory is used only for the pages which have been accessed.
+		//Throws std::bad_alloc on failure.
+		void* allocate_virtual_memory(std::size_t size);
+
+		void free_virtual_memory(void* ptr, std::size_t size);
+
+		//Returns the physical memory of the pages to the OS. The pages remain accessible, but their contents
+		//is undefined.
+		void discard_virtual_memory(void* ptr, std::size_t size);
+
 	}
 
 }
@@ -18,7 +18,11 @@
 
 #include <chrono>
 #include <ctime>
+#include <new>
 
+#include <sys/mman.h>
+
+#include "common.h"
 #include "platform.h"
 
 namespace ss = syn_script;
@@ -37,13 +41,27 @@ pf::TimeMs_t pf::get_current_time_millis() {
 void pf::get_current_time(DateTime& date_time) {
 	std::time_t time = std::time(nullptr);
 
-	//TODO This function is not thread-safe. Add synchronization.
-	struct std::tm* tm = localtime(&time);
+	struct std::tm tm;
+	if (!localtime_r(&time, &tm)) throw RuntimeError("localtime_r() failed");
+
+	date_time.m_year = tm.tm_year + 1900;
+	date_time.m_month = tm.tm_mon;
+	date_time.m_day = tm.tm_mday;
+	date_time.m_hour = tm.tm_hour;
+	date_time.m_minute = tm.tm_min;
+	date_time.m_second = tm.tm_sec;
+}
+
+void* pf::allocate_virtual_memory(std::size_t size) {
+	void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if (MAP_FAILED == ptr) throw std::bad_alloc();
+	return ptr;
+}
+
+void pf::free_virtual_memory(void* ptr, std::size_t size) {
+	munmap(ptr, size);
+}
 
-	date_time.m_year = tm->tm_year + 1900;
-	date_time.m_month = tm->tm_mon;
-	date_time.m_day = tm->tm_mday;
-	date_time.m_hour = tm->tm_hour;
-	date_time.m_minute = tm->tm_min;
-	date_time.m_second = tm->tm_sec;
+void pf::discard_virtual_memory(void* ptr, std::size_t size) {
+	madvise(ptr, size, MADV_DONTNEED);
 }
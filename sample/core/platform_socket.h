@@ -19,12 +19,21 @@
 #ifndef SYNSAMPLE_CORE_PLATFORM_SOCKET_H_INCLUDED
 #define SYNSAMPLE_CORE_PLATFORM_SOCKET_H_INCLUDED
 
+#include <cstdint>
+#include <memory>
+
 #include "gc.h"
 #include "stringex.h"
 
 namespace syn_script {
 	namespace platform {
 
+		//Opaque socket handle, used to register a socket in a SocketPoller.
+		typedef std::uintptr_t SocketHandle;
+
+		//Returned by Socket::try_read() when no data is available.
+		const std::size_t SOCKET_WOULD_BLOCK = static_cast<std::size_t>(-1);
+
 		//
 		//Socket
 		//
@@ -38,8 +47,20 @@ namespace syn_script {
 		public:
 			virtual StringLoc get_remote_host() const = 0;
 			virtual int get_remote_port() const = 0;
+			virtual SocketHandle get_handle() const = 0;
+
+			//In non-blocking mode, write() and read() still wait (with the usual timeout) when the operation
+			//cannot be completed immediately; only try_read() returns without waiting.
+			virtual void set_non_blocking(bool non_blocking) = 0;
+
 			virtual void write(const char* buffer, std::size_t count) = 0;
+
+			//Returns 0 at the end of the input.
 			virtual std::size_t read(char* buffer, std::size_t count) = 0;
+
+			//Non-blocking mode only. Returns SOCKET_WOULD_BLOCK if no data is available.
+			virtual std::size_t try_read(char* buffer, std::size_t count) = 0;
+
 			virtual void close() = 0;
 		};
 
@@ -54,12 +75,44 @@ namespace syn_script {
 			ServerSocket(){}
 
 		public:
+			virtual SocketHandle get_handle() const = 0;
+			virtual void set_non_blocking(bool non_blocking) = 0;
 			virtual gc::Local<Socket> accept() = 0;
+
+			//Non-blocking mode only. Returns null if there is no pending connection.
+			virtual gc::Local<Socket> try_accept() = 0;
+
 			virtual void close() = 0;
 		};
 
+		//
+		//SocketPoller
+		//
+
+		//Waits until one of the registered sockets has input (data, end of input or a pending connection).
+		//Implemented with epoll on Linux and WSAPoll() on Windows. Not a GC object, so it can be used while
+		//GC is disabled.
+		class SocketPoller {
+			NONCOPYABLE(SocketPoller);
+
+		protected:
+			SocketPoller(){}
+
+		public:
+			virtual ~SocketPoller(){}
+
+			//The token is returned by wait() when the socket is ready.
+			virtual void add(SocketHandle handle, std::size_t token) = 0;
+			virtual void remove(SocketHandle handle) = 0;
+
+			//Stores the tokens of ready sockets into the array and returns their number. The timeout is in
+			//milliseconds, -1 means no timeout. Returns 0 on timeout.
+			virtual std::size_t wait(std::size_t* tokens, std::size_t max_count, int timeout_ms) = 0;
+		};
+
 		gc::Local<Socket> create_socket(const StringLoc& host, int port);
 		gc::Local<ServerSocket> create_server_socket(int port);
+		std::unique_ptr<SocketPoller> create_socket_poller();
 
 	}
 }
@@ -44,6 +44,9 @@ namespace syn_script {
 }
 
 namespace {
+	//Send and receive timeout. Also used when waiting for a non-blocking socket.
+	const int SOCKET_TIMEOUT_MS = 3000;
+
 	ss::RuntimeError socket_error(const std::string& msg) {
 		std::string full_msg = std::string("Socket error (")
 			+ std::to_string(pf::pf_socket_error_code()) + "): " + msg;
@@ -95,6 +98,7 @@ class pf::ConcreteSocket : public Socket {
 	PF_SOCKET_HANDLE m_socket;
 	StringRef m_remote_host;
 	int m_remote_port;
+	bool m_non_blocking;
 
 public:
 	ConcreteSocket();
@@ -104,12 +108,17 @@ public:
 
 private:
 	void init_timeouts();
+	int recv_block(char* buffer, std::size_t count);
+	void wait(bool write, const char* operation);
 
 public:
 	StringLoc get_remote_host() const override;
 	int get_remote_port() const override;
+	SocketHandle get_handle() const override;
+	void set_non_blocking(bool non_blocking) override;
 	void write(const char* buffer, std::size_t count) override;
 	std::size_t read(char* buffer, std::size_t count) override;
+	std::size_t try_read(char* buffer, std::size_t count) override;
 	void close() override;
 };
 
@@ -117,7 +126,7 @@ public:
 //ConcreteSocket : implementation
 //
 
-pf::ConcreteSocket::ConcreteSocket() : m_socket(PF_INVALID_SOCKET){}
+pf::ConcreteSocket::ConcreteSocket() : m_socket(PF_INVALID_SOCKET), m_non_blocking(false){}
 
 void pf::ConcreteSocket::gc_enumerate_refs() {
 	Socket::gc_enumerate_refs();
@@ -161,7 +170,7 @@ void pf::ConcreteSocket::initialize(const ss::StringLoc& host, int port) {
 }
 
 void pf::ConcreteSocket::init_timeouts() {
-	const int timeout = 3000;
+	const int timeout = SOCKET_TIMEOUT_MS;
 
 	if (PF_SOCKET_ERROR == pf_socket_timeout(m_socket, SO_RCVTIMEO, timeout)) {
 		pf_socket_close(m_socket);
@@ -182,15 +191,34 @@ int pf::ConcreteSocket::get_remote_port() const {
 	return m_remote_port;
 }
 
+pf::SocketHandle pf::ConcreteSocket::get_handle() const {
+	return static_cast<SocketHandle>(m_socket);
+}
+
+void pf::ConcreteSocket::set_non_blocking(bool non_blocking) {
+	if (non_blocking == m_non_blocking) return;
+	if (PF_SOCKET_ERROR == pf_socket_non_blocking(m_socket, non_blocking)) {
+		throw socket_error("Cannot change the blocking mode");
+	}
+	m_non_blocking = non_blocking;
+}
+
+//Blocking operations are performed with GC disabled, so that other threads can collect garbage meanwhile. Buffers
+//are not moved by the GC.
 void pf::ConcreteSocket::write(const char* buffer, std::size_t count) {
 	if (!count) return;
 
+	gc::disable_guard disable_guard;
 	const unsigned int max_int = std::numeric_limits<int>::max();
 	const unsigned int block_size = count < max_int ? static_cast<unsigned int>(count) : max_int;
 	while (count) {
 		int len = count < block_size ? static_cast<int>(count) : block_size;
-		int iResult = send(m_socket, buffer, len, 0);
-		if (PF_SOCKET_ERROR == iResult) throw socket_error("send() failed");
+		int iResult = send(m_socket, buffer, len, PF_SOCKET_SEND_FLAGS);
+		if (PF_SOCKET_ERROR == iResult) {
+			if (!m_non_blocking || !pf_socket_would_block()) throw socket_error("send() failed");
+			wait(true, "send()");
+			continue;
+		}
 		count -= iResult;
 		buffer += iResult;
 	}
@@ -199,12 +227,36 @@ void pf::ConcreteSocket::write(const char* buffer, std::size_t count) {
 std::size_t pf::ConcreteSocket::read(char* buffer, std::size_t count) {
 	if (!count) return 0;
 
+	gc::disable_guard disable_guard;
+	for (;;) {
+		int iResult = recv_block(buffer, count);
+		if (PF_SOCKET_ERROR != iResult) return iResult;
+		if (!m_non_blocking || !pf_socket_would_block()) throw socket_error("recv() failed");
+		wait(false, "recv()");
+	}
+}
+
+std::size_t pf::ConcreteSocket::try_read(char* buffer, std::size_t count) {
+	assert(m_non_blocking);
+	if (!count) return 0;
+
+	int iResult = recv_block(buffer, count);
+	if (PF_SOCKET_ERROR != iResult) return iResult;
+	if (pf_socket_would_block()) return SOCKET_WOULD_BLOCK;
+	throw socket_error("recv() failed");
+}
+
+int pf::ConcreteSocket::recv_block(char* buffer, std::size_t count) {
 	const unsigned int max_int = std::numeric_limits<int>::max();
 	int len = count < max_int ? static_cast<int>(count) : max_int;
-	int iResult = recv(m_socket, buffer, len, 0);
-	if (PF_SOCKET_ERROR == iResult) throw socket_error("recv() failed");
+	return recv(m_socket, buffer, len, 0);
+}
 
-	return iResult;
+//Waits for a non-blocking socket, applying the same timeout as to a blocking one.
+void pf::ConcreteSocket::wait(bool write, const char* operation) {
+	int iResult = pf_socket_wait(m_socket, write, SOCKET_TIMEOUT_MS);
+	if (PF_SOCKET_ERROR == iResult) throw socket_error(std::string(operation) + " failed");
+	if (!iResult) throw RuntimeError(std::string("Socket error: ") + operation + " timed out");
 }
 
 void pf::ConcreteSocket::close() {
@@ -220,20 +272,27 @@ class pf::ConcreteServerSocket : public ServerSocket {
 	NONCOPYABLE(ConcreteServerSocket);
 
 	PF_SOCKET_HANDLE m_server_socket;
+	bool m_non_blocking;
 
 public:
 	ConcreteServerSocket();
 	void initialize(int port);
 
+	SocketHandle get_handle() const override;
+	void set_non_blocking(bool non_blocking) override;
 	gc::Local<Socket> accept() override;
+	gc::Local<Socket> try_accept() override;
 	void close() override;
+
+private:
+	gc::Local<Socket> create_accepted_socket(PF_SOCKET_HANDLE socket);
 };
 
 //
 //ConcreteServerSocket : implementation
 //
 
-pf::ConcreteServerSocket::ConcreteServerSocket() : m_server_socket(PF_INVALID_SOCKET){}
+pf::ConcreteServerSocket::ConcreteServerSocket() : m_server_socket(PF_INVALID_SOCKET), m_non_blocking(false){}
 
 void pf::ConcreteServerSocket::initialize(int port) {
 	pf::pf_socket_startup();
@@ -261,9 +320,47 @@ void pf::ConcreteServerSocket::initialize(int port) {
 	}
 }
 
+pf::SocketHandle pf::ConcreteServerSocket::get_handle() const {
+	return static_cast<SocketHandle>(m_server_socket);
+}
+
+void pf::ConcreteServerSocket::set_non_blocking(bool non_blocking) {
+	if (non_blocking == m_non_blocking) return;
+	if (PF_SOCKET_ERROR == pf_socket_non_blocking(m_server_socket, non_blocking)) {
+		throw socket_error("Cannot change the blocking mode");
+	}
+	m_non_blocking = non_blocking;
+}
+
 gc::Local<pf::Socket> pf::ConcreteServerSocket::accept() {
+	PF_SOCKET_HANDLE socket;
+	{
+		gc::disable_guard disable_guard;
+		for (;;) {
+			socket = ::accept(m_server_socket, NULL, NULL);
+			if (PF_INVALID_SOCKET != socket) break;
+			if (!m_non_blocking || !pf_socket_would_block()) throw socket_error("accept() failed");
+			if (PF_SOCKET_ERROR == pf_socket_wait(m_server_socket, false, -1)) throw socket_error("accept() failed");
+		}
+	}
+	return create_accepted_socket(socket);
+}
+
+gc::Local<pf::Socket> pf::ConcreteServerSocket::try_accept() {
+	assert(m_non_blocking);
+
 	PF_SOCKET_HANDLE socket = ::accept(m_server_socket, NULL, NULL);
-	if (PF_INVALID_SOCKET == socket) throw socket_error("accept() failed");
+	if (PF_INVALID_SOCKET != socket) return create_accepted_socket(socket);
+	if (pf_socket_would_block()) return nullptr;
+	throw socket_error("accept() failed");
+}
+
+//Accepted sockets are blocking, regardless of the mode of the server socket.
+gc::Local<pf::Socket> pf::ConcreteServerSocket::create_accepted_socket(PF_SOCKET_HANDLE socket) {
+	if (m_non_blocking && PF_SOCKET_ERROR == pf_socket_non_blocking(socket, false)) {
+		pf_socket_close(socket);
+		throw socket_error("Cannot change the blocking mode");
+	}
 
 	sockaddr_in addr;
 	socklen_t size = sizeof(addr);
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2014 Anton Karmanov
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//Linux platform-dependent socket functions.
+
+#include "platform_socket_linux.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sys/epoll.h>
+
+#include "common.h"
+#include "platform_socket.h"
+
+namespace ss = syn_script;
+namespace pf = ss::platform;
+
+namespace syn_script {
+	namespace platform {
+		class EpollSocketPoller;
+	}
+}
+
+namespace {
+	ss::RuntimeError poller_error(const std::string& msg) {
+		return ss::RuntimeError(std::string("Socket error (") + std::to_string(errno) + "): " + msg);
+	}
+}
+
+//
+//EpollSocketPoller
+//
+
+//Level-triggered, so a socket which has unread input is reported again by the next wait().
+class pf::EpollSocketPoller : public SocketPoller {
+	NONCOPYABLE(EpollSocketPoller);
+
+	int m_epoll;
+	std::vector<struct epoll_event> m_events;
+
+public:
+	EpollSocketPoller() : m_epoll(-1) {
+		m_epoll = epoll_create1(EPOLL_CLOEXEC);
+		if (-1 == m_epoll) throw poller_error("epoll_create1() failed");
+	}
+
+	~EpollSocketPoller() {
+		::close(m_epoll);
+	}
+
+	void add(SocketHandle handle, std::size_t token) override {
+		struct epoll_event event;
+		event.events = EPOLLIN;
+		event.data.u64 = token;
+		if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, static_cast<int>(handle), &event)) {
+			throw poller_error("epoll_ctl() failed");
+		}
+	}
+
+	void remove(SocketHandle handle) override {
+		//A non-null event pointer is required by old kernels.
+		struct epoll_event event;
+		if (epoll_ctl(m_epoll, EPOLL_CTL_DEL, static_cast<int>(handle), &event)) {
+			throw poller_error("epoll_ctl() failed");
+		}
+	}
+
+	std::size_t wait(std::size_t* tokens, std::size_t max_count, int timeout_ms) override {
+		if (m_events.size() < max_count) m_events.resize(max_count);
+
+		int count = epoll_wait(m_epoll, m_events.data(), static_cast<int>(max_count), timeout_ms);
+		if (-1 == count) {
+			if (EINTR == errno) return 0;
+			throw poller_error("epoll_wait() failed");
+		}
+
+		for (int i = 0; i < count; ++i) tokens[i] = static_cast<std::size_t>(m_events[i].data.u64);
+		return count;
+	}
+};
+
+//
+//(Functions)
+//
+
+std::unique_ptr<pf::SocketPoller> pf::create_socket_poller() {
+	return std::unique_ptr<SocketPoller>(new EpollSocketPoller());
+}
@@ -20,6 +20,8 @@
 #define SYNSAMPLE_CORE_PLATFORM_SOCKET_LINUX_H_INCLUDED
 
 #include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <netdb.h>
@@ -34,6 +36,9 @@ namespace syn_script {
 		const int PF_INVALID_SOCKET = -1;
 		const int PF_SOCKET_ERROR = -1;
 
+		//A peer which has closed the connection must cause an error, not SIGPIPE.
+		const int PF_SOCKET_SEND_FLAGS = MSG_NOSIGNAL;
+
 		inline void pf_socket_startup(){}
 		inline void pf_socket_shutdown(int sock) { shutdown(sock, SHUT_RDWR); };
 		inline void pf_socket_close(int sock) { close(sock); }
@@ -46,6 +51,31 @@ namespace syn_script {
 			return setsockopt(socket, SOL_SOCKET, option, &tv, sizeof(tv));
 		}
 
+		inline int pf_socket_non_blocking(PF_SOCKET_HANDLE socket, bool non_blocking) {
+			int flags = fcntl(socket, F_GETFL, 0);
+			if (-1 == flags) return PF_SOCKET_ERROR;
+			flags = non_blocking ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
+			return fcntl(socket, F_SETFL, flags);
+		}
+
+		inline bool pf_socket_would_block() {
+			return EAGAIN == errno || EWOULDBLOCK == errno;
+		}
+
+		//Waits until the socket is ready for reading or writing. Returns 0 on timeout.
+		inline int pf_socket_wait(PF_SOCKET_HANDLE socket, bool write, int timeout_ms) {
+			struct pollfd fd;
+			fd.fd = socket;
+			fd.events = write ? POLLOUT : POLLIN;
+			fd.revents = 0;
+
+			int result;
+			do {
+				result = poll(&fd, 1, timeout_ms);
+			} while (-1 == result && EINTR == errno);
+			return result;
+		}
+
 	}
 }
 
@@ -25,6 +25,9 @@
 
 #include <cstring>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
 
 #include "gc.h"
 #include "platform.h"
@@ -35,6 +38,12 @@ namespace ss = syn_script;
 namespace gc = ss::gc;
 namespace pf = ss::platform;
 
+namespace syn_script {
+	namespace platform {
+		class WSAPollSocketPoller;
+	}
+}
+
 namespace {
 	class WinsockStartup {
 		NONCOPYABLE(WinsockStartup);
@@ -55,8 +64,74 @@ namespace {
 			if (!startup.m_ok) throw ss::RuntimeError("WSAStartup() failed");
 		}
 	};
+
+	ss::RuntimeError poller_error(const std::string& msg) {
+		return ss::RuntimeError(std::string("Socket error (") + std::to_string(WSAGetLastError()) + "): " + msg);
+	}
 }
 
+//
+//WSAPollSocketPoller
+//
+
+//Windows has no epoll; WSAPoll() is given the whole set of sockets on every call.
+class pf::WSAPollSocketPoller : public SocketPoller {
+	NONCOPYABLE(WSAPollSocketPoller);
+
+	std::vector<WSAPOLLFD> m_fds;
+	std::vector<std::size_t> m_tokens;
+
+public:
+	WSAPollSocketPoller(){}
+
+	void add(SocketHandle handle, std::size_t token) override {
+		WSAPOLLFD fd;
+		fd.fd = static_cast<SOCKET>(handle);
+		fd.events = POLLRDNORM;
+		fd.revents = 0;
+		m_fds.push_back(fd);
+		m_tokens.push_back(token);
+	}
+
+	void remove(SocketHandle handle) override {
+		for (std::size_t i = 0, n = m_fds.size(); i < n; ++i) {
+			if (m_fds[i].fd == static_cast<SOCKET>(handle)) {
+				m_fds[i] = m_fds.back();
+				m_tokens[i] = m_tokens.back();
+				m_fds.pop_back();
+				m_tokens.pop_back();
+				return;
+			}
+		}
+	}
+
+	std::size_t wait(std::size_t* tokens, std::size_t max_count, int timeout_ms) override {
+		if (m_fds.empty()) {
+			//WSAPoll() fails when there are no sockets.
+			if (timeout_ms > 0) Sleep(timeout_ms);
+			return 0;
+		}
+
+		int result = WSAPoll(m_fds.data(), static_cast<ULONG>(m_fds.size()), timeout_ms);
+		if (SOCKET_ERROR == result) throw poller_error("WSAPoll() failed");
+
+		std::size_t count = 0;
+		for (std::size_t i = 0, n = m_fds.size(); i < n && count < max_count; ++i) {
+			if (m_fds[i].revents) tokens[count++] = m_tokens[i];
+		}
+		return count;
+	}
+};
+
+//
+//(Functions)
+//
+
 void pf::pf_socket_startup() {
 	WinsockStartup::startup();
 }
+
+std::unique_ptr<pf::SocketPoller> pf::create_socket_poller() {
+	pf_socket_startup();
+	return std::unique_ptr<SocketPoller>(new WSAPollSocketPoller());
+}
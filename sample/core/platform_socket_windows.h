@@ -36,6 +36,7 @@ namespace syn_script {
 		typedef SOCKET PF_SOCKET_HANDLE;
 		const PF_SOCKET_HANDLE PF_INVALID_SOCKET = INVALID_SOCKET;
 		const int PF_SOCKET_ERROR = SOCKET_ERROR;
+		const int PF_SOCKET_SEND_FLAGS = 0;
 
 		void pf_socket_startup();
 		inline void pf_socket_shutdown(SOCKET sock) { shutdown(sock, SD_BOTH); }
@@ -48,6 +49,24 @@ namespace syn_script {
 			return setsockopt(socket, SOL_SOCKET, option, ptr, sizeof(timeout));
 		}
 
+		inline int pf_socket_non_blocking(PF_SOCKET_HANDLE socket, bool non_blocking) {
+			u_long mode = non_blocking ? 1 : 0;
+			return ioctlsocket(socket, FIONBIO, &mode);
+		}
+
+		inline bool pf_socket_would_block() {
+			return WSAEWOULDBLOCK == WSAGetLastError();
+		}
+
+		//Waits until the socket is ready for reading or writing. Returns 0 on timeout.
+		inline int pf_socket_wait(PF_SOCKET_HANDLE socket, bool write, int timeout_ms) {
+			WSAPOLLFD fd;
+			fd.fd = socket;
+			fd.events = write ? POLLWRNORM : POLLRDNORM;
+			fd.revents = 0;
+			return WSAPoll(&fd, 1, timeout_ms);
+		}
+
 	}
 }
 
@@ -20,6 +20,7 @@
 #include <ctime>
 #include <iomanip>
 #include <limits>
+#include <new>
 #include <sstream>
 
 #include <Windows.h>
@@ -51,3 +52,17 @@ void pf::get_current_time(DateTime& date_time) {
 	date_time.m_minute = tm.tm_min;
 	date_time.m_second = tm.tm_sec;
 }
+
+void* pf::allocate_virtual_memory(std::size_t size) {
+	void* ptr = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+	if (!ptr) throw std::bad_alloc();
+	return ptr;
+}
+
+void pf::free_virtual_memory(void* ptr, std::size_t size) {
+	VirtualFree(ptr, 0, MEM_RELEASE);
+}
+
+void pf::discard_virtual_memory(void* ptr, std::size_t size) {
+	VirtualAlloc(ptr, size, MEM_RESET, PAGE_READWRITE);
+}
@@ -21,6 +21,7 @@
 #include <memory>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "gc.h"
@@ -64,19 +65,22 @@ namespace {
 		return array;
 	}
 
+	//The limit is the maximum heap size: the heap grows dynamically, so the memory is not allocated up front.
 	std::size_t get_effective_memory_limit(std::size_t limit_mb) {
-		if (limit_mb == 0) limit_mb = 8;
+		const std::size_t DEFAULT_MEMORY_LIMIT_MB = 1024;
+		if (limit_mb == 0) limit_mb = DEFAULT_MEMORY_LIMIT_MB;
 		if (limit_mb > 2048) limit_mb = 2048;
+		return limit_mb << 20;
+	}
 
-		std::size_t limit = limit_mb << 20;
-		try {
-			char* test_data = new char[limit];
-			free(test_data);
-		} catch (std::bad_alloc) {
-			throw ss::FatalError("Not enough memory");
+	std::size_t get_effective_gc_threads(std::size_t gc_threads) {
+		const std::size_t MAX_DEFAULT_GC_THREADS = 4;
+		if (gc_threads == 0) {
+			gc_threads = std::thread::hardware_concurrency();
+			if (gc_threads == 0) gc_threads = 1;
+			if (gc_threads > MAX_DEFAULT_GC_THREADS) gc_threads = MAX_DEFAULT_GC_THREADS;
 		}
-
-		return limit;
+		return gc_threads;
 	}
 }//namespace
 
@@ -85,12 +89,18 @@ void link__api();
 int sample_main(
 	const std::string& file_name_std,
 	const std::vector<std::string>& arguments_std,
-	std::size_t mem_limit_mb)
+	std::size_t mem_limit_mb,
+	std::size_t gc_threads,
+	std::size_t gc_pause_ms,
+	bool ast_mode)
 {
 	link__api();
 
 	try {
-		gc::startup_guard gc_startup(get_effective_memory_limit(mem_limit_mb));
+		gc::startup_guard gc_startup(
+			get_effective_memory_limit(mem_limit_mb),
+			get_effective_gc_threads(gc_threads),
+			gc_pause_ms);
 		gc::manage_thread_guard gc_thread;
 		gc::enable_guard gc_enable;
 
@@ -99,7 +109,8 @@ int sample_main(
 			ss::StringLoc code = load_file(file_name_std);
 			gc::Local<ss::StringArray> arguments = create_arguments_array(arguments_std);
 			gc::Local<gc::Array<rt::ScriptSource>> sources = rt::get_single_script_source(file_name, code);
-			bool ok = rt::execute_top_script(sources, arguments);
+			rt::ExecutionMode execution_mode = ast_mode ? rt::ExecutionMode::AST : rt::ExecutionMode::BYTECODE;
+			bool ok = rt::execute_top_script(sources, arguments, execution_mode);
 			return ok ? 0 : 1;
 		} catch (const ss::BasicError& e) {
 			std::cerr << e << std::endl;
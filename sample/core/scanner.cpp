@@ -16,11 +16,14 @@
 
 //Scanner implementation.
 
+#include <cstdint>
 #include <iostream>
 #include <map>
 #include <set>
 #include <sstream>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "common.h"
 #include "syn.h"
@@ -38,11 +41,6 @@ using ss::syngen::TokenValue;
 
 namespace {
 
-	struct RowCol {
-		int m_row;
-		int m_col;
-	};
-
 	typedef ss::StringIterator str_iter;
 
 	ss::StringIterator str_begin(const ss::StringLoc& str) {
@@ -79,6 +77,17 @@ namespace {
 		unsigned char c = c0;
 		return c != '\n' && c != '\r' && c >= 0x20 && c < 0x80 && c != '\\';
 	}
+
+	ss::SourceRef register_source(const ss::StringLoc& file_name, const ss::StringLoc& str) {
+		if (str->length() > UINT32_MAX) throw ss::CompilationError("Source file is too large");
+
+		std::vector<std::uint32_t> line_starts;
+		for (str_iter iter = str_begin(str), end = str_end(str); iter != end; ++iter) {
+			if (*iter == '\n') line_starts.push_back(static_cast<std::uint32_t>(iter.pos() + 1));
+		}
+
+		return ss::SourceRef::register_source(file_name->get_std_string(), std::move(line_starts));
+	}
 }
 
 //
@@ -88,21 +97,18 @@ namespace {
 class ss::InternalScanner {
 	NONCOPYABLE(InternalScanner);
 
-	std::list<StdStringKey> m_keyword_keys;
-	std::map<StringKeyValue, Token> m_keyword_map;
+	//Keywords are registered as names, so an identifier is looked up only once.
+	std::unordered_map<NameID, Token, NameIDHash> m_keyword_map;
 
 	NameRegistry& m_name_registry;
-	const StringLoc m_file_name;
+	const SourceRef m_source;
 	const StringLoc m_str;
 	const str_iter m_end;
 	str_iter m_cur;
 	char m_curch;
 	bool m_eof;
 
-	RowCol m_pos;
-
 	str_iter m_start;
-	RowCol m_start_pos;
 
 	std::string m_buffer;
 	std::set<StringKeyValue> m_string_literal_table;
@@ -114,7 +120,8 @@ public:
 		const StringLoc& file_name,
 		const StringLoc &str);
 
-	gc::Local<TextPos> get_text_pos() const;
+	const SourceRef& get_source() const;
+	TextPos get_text_pos() const;
 	syngen::Token scan(syngen::TokenValue& token_value);
 
 private:
@@ -134,10 +141,9 @@ private:
 	void scan_string_char();
 	char lookup_char() const;
 	void nextch();
-	void update_pos(char c);
 	void update_curch();
 	void copy_to_buffer(const str_iter& start, const str_iter& end);
-	gc::Local<TextPos> text_pos(const RowCol& row_col) const;
+	TextPos text_pos(const str_iter& iter) const;
 };
 
 //
@@ -149,30 +155,30 @@ ss::InternalScanner::InternalScanner(
 	const StringLoc& file_name,
 	const StringLoc& str)
 	: m_name_registry(name_registry),
-	m_file_name(file_name),
+	m_source(register_source(file_name, str)),
 	m_str(str),
 	m_end(str_end(str)),
 	m_cur(str_begin(str))
 {
 	init_keyword_map();
 
-	m_pos.m_row = 0;
-	m_pos.m_col = 0;
-
 	m_eof = false;
 	update_curch();
 }
 
 void ss::InternalScanner::init_keyword_map() {
 	for (const syngen::Keyword* kw = syngen::g_keyword_table; !kw->keyword.empty(); ++kw) {
-		const std::string* str = &kw->keyword;
-		m_keyword_keys.push_back(StdStringKey(*str));
-		m_keyword_map[StringKeyValue(m_keyword_keys.back())] = kw->token;
+		gc::Local<const NameInfo> name_info = m_name_registry.register_name(kw->keyword);
+		m_keyword_map[name_info->get_id()] = kw->token;
 	}
 }
 
-gc::Local<ss::TextPos> ss::InternalScanner::get_text_pos() const {
-	return text_pos(m_pos);
+const ss::SourceRef& ss::InternalScanner::get_source() const {
+	return m_source;
+}
+
+ss::TextPos ss::InternalScanner::get_text_pos() const {
+	return text_pos(m_cur);
 }
 
 ss::syngen::Token ss::InternalScanner::scan(TokenValue& token_value) {
@@ -188,7 +194,6 @@ ss::syngen::Token ss::InternalScanner::scan_0(TokenValue& token_value) {
 	if (m_eof) return Tokens::SYS_EOF;
 
 	m_start = m_cur;
-	m_start_pos = m_pos;
 
 	Token token;
 	char c = m_curch;
@@ -202,14 +207,13 @@ ss::syngen::Token ss::InternalScanner::scan_0(TokenValue& token_value) {
 		token = scan_char(token_value);
 	} else {
 		token = syngen::scan_concrete_token_basic(&m_cur, m_end);
-		for (str_iter i = m_start; i != m_cur; ++i) update_pos(*i);
 		update_curch();
-		token_value.v_SynPos = gc::create<ss::TextPos>(m_file_name, m_start_pos.m_row, m_start_pos.m_col);
+		token_value.v_SynPos = text_pos(m_start);
 	}
 
 	//std::string token_str;
 	//m_start.get_std_string(m_cur, token_str);
-	//std::cout << (m_start_pos.m_row + 1) << ":" << (m_start_pos.m_col + 1) << " "
+	//std::cout << (text_pos(m_start).line() + 1) << ":" << (text_pos(m_start).column() + 1) << " "
 	//	<< syngen::g_token_descriptors[token].name
 	//	<< " '" << token_str << "'\n";
 
@@ -290,19 +294,19 @@ ss::syngen::Token ss::InternalScanner::scan_number_dec(TokenValue& token_value)
 	}
 
 	copy_to_buffer(m_start, m_cur);
-	gc::Local<ss::TextPos> text_pos = gc::create<ss::TextPos>(m_file_name, m_start_pos.m_row, m_start_pos.m_col);
+	ss::TextPos pos = text_pos(m_start);
 
 	syngen::Token token;
 	if (floating_point) {
 		token = Tokens::T_FLOAT;
 		ScriptFloatType v;
 		if (!str_to_float(m_buffer, v)) throw syn::SynLexicalError();
-		token_value.v_SynFloat = gc::create<ast::AstFloat>(text_pos, v);
+		token_value.v_SynFloat = gc::create<ast::AstFloat>(pos, v);
 	} else {
 		token = Tokens::T_INTEGER;
 		ScriptIntegerType v;
 		if (!str_to_int(m_buffer, v)) throw syn::SynLexicalError();
-		token_value.v_SynInteger = gc::create<ast::AstInteger>(text_pos, v);
+		token_value.v_SynInteger = gc::create<ast::AstInteger>(pos, v);
 	}
 
 	return token;
@@ -316,34 +320,33 @@ ss::syngen::Token ss::InternalScanner::scan_number_hex(TokenValue& token_value)
 	while (!m_eof && is_hex_digit(m_curch)) nextch();
 
 	copy_to_buffer(start, m_cur);
-	gc::Local<ss::TextPos> text_pos = gc::create<ss::TextPos>(m_file_name, m_start_pos.m_row, m_start_pos.m_col);
+	ss::TextPos pos = text_pos(m_start);
 	ScriptIntegerType v;
 	if (!str_to_int(m_buffer, v, 16)) throw syn::SynLexicalError();
-	token_value.v_SynInteger = gc::create<ast::AstInteger>(text_pos, v);
+	token_value.v_SynInteger = gc::create<ast::AstInteger>(pos, v);
 
 	return syngen::Token::T_INTEGER;
 }
 
 ss::syngen::Token ss::InternalScanner::scan_name(TokenValue& token_value) {
+	std::size_t hash = update_name_hash(0, m_curch);
 	nextch();
-	while (!m_eof && is_identifier_part(m_curch)) nextch();
+	while (!m_eof && is_identifier_part(m_curch)) {
+		hash = update_name_hash(hash, m_curch);
+		nextch();
+	}
 
-	gc::Local<ss::TextPos> text_pos = gc::create<ss::TextPos>(m_file_name, m_start_pos.m_row, m_start_pos.m_col);
-	syngen::Token token = Tokens::T_ID;
+	ss::TextPos pos = text_pos(m_start);
+	gc::Local<const NameInfo> name_info = m_name_registry.register_name(m_start, m_cur, hash);
 
-	GCPtrStringKey str_key = m_start.get_string_key(m_cur);
-	auto iter = m_keyword_map.find(StringKeyValue(str_key));
+	auto iter = m_keyword_map.find(name_info->get_id());
 	if (iter != m_keyword_map.end()) {
-		token = iter->second;
-		token_value.v_SynPos = text_pos;
-	}
-
-	if (token == Tokens::T_ID) {
-		gc::Local<const NameInfo> name_info = m_name_registry.register_name(m_start, m_cur);
-		token_value.v_SynName = gc::create<ast::AstName>(text_pos, name_info);
+		token_value.v_SynPos = pos;
+		return iter->second;
 	}
 
-	return token;
+	token_value.v_SynName = gc::create<ast::AstName>(pos, name_info);
+	return Tokens::T_ID;
 }
 
 ss::syngen::Token ss::InternalScanner::scan_string(TokenValue& token_value) {
@@ -371,8 +374,8 @@ ss::syngen::Token ss::InternalScanner::scan_string(TokenValue& token_value) {
 		v = iter->get_key().get_gc_string();
 	}
 
-	gc::Local<ss::TextPos> text_pos = gc::create<ss::TextPos>(m_file_name, m_start_pos.m_row, m_start_pos.m_col);
-	token_value.v_SynString = gc::create<ast::AstString>(text_pos, v);
+	ss::TextPos pos = text_pos(m_start);
+	token_value.v_SynString = gc::create<ast::AstString>(pos, v);
 	return Tokens::T_STRING;
 }
 
@@ -387,8 +390,8 @@ ss::syngen::Token ss::InternalScanner::scan_char(TokenValue& token_value) {
 	nextch();
 
 	ScriptIntegerType v = m_buffer[0];
-	gc::Local<ss::TextPos> text_pos = gc::create<ss::TextPos>(m_file_name, m_start_pos.m_row, m_start_pos.m_col);
-	token_value.v_SynInteger = gc::create<ast::AstInteger>(text_pos, v);
+	ss::TextPos pos = text_pos(m_start);
+	token_value.v_SynInteger = gc::create<ast::AstInteger>(pos, v);
 	return Tokens::T_INTEGER;
 }
 
@@ -428,21 +431,11 @@ char ss::InternalScanner::lookup_char() const {
 
 void ss::InternalScanner::nextch() {
 	if (!m_eof) {
-		update_pos(m_curch);
 		++m_cur;
 		update_curch();
 	}
 }
 
-void ss::InternalScanner::update_pos(char c) {
-	if (c == '\n') {
-		++m_pos.m_row;
-		m_pos.m_col = 0;
-	} else {
-		++m_pos.m_col;
-	}
-}
-
 void ss::InternalScanner::update_curch() {
 	if (m_cur == m_end) {
 		m_eof = true;
@@ -456,8 +449,8 @@ void ss::InternalScanner::copy_to_buffer(const str_iter& start, const str_iter&
 	start.get_std_string(end, m_buffer);
 }
 
-gc::Local<ss::TextPos> ss::InternalScanner::text_pos(const RowCol& row_col) const {
-	return gc::create<TextPos>(m_file_name, row_col.m_row, row_col.m_col);
+ss::TextPos ss::InternalScanner::text_pos(const str_iter& iter) const {
+	return m_source.get_pos(static_cast<std::uint32_t>(iter.pos()));
 }
 
 //
@@ -474,7 +467,11 @@ ss::syngen::Token ss::Scanner::scan(TokenValue& token_value) {
 	return m_internal_scanner->scan(token_value);
 }
 
-gc::Local<ss::TextPos> ss::Scanner::get_text_pos() const {
+const ss::SourceRef& ss::Scanner::get_source() const {
+	return m_internal_scanner->get_source();
+}
+
+ss::TextPos ss::Scanner::get_text_pos() const {
 	return m_internal_scanner->get_text_pos();
 }
 
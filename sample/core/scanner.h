@@ -45,7 +45,8 @@ namespace syn_script {
 		~Scanner(); //For std::unique_ptr<InternalScanner>.
 
 		syngen::Token scan(syngen::TokenValue& token_value);
-		gc::Local<TextPos> get_text_pos() const;
+		const SourceRef& get_source() const;
+		TextPos get_text_pos() const;
 	};
 
 }
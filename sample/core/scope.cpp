@@ -72,6 +72,7 @@ bool rt::ScopeID::operator!() const {
 void rt::ScopeDescriptor::gc_enumerate_refs() {
 	Object::gc_enumerate_refs();
 	gc_ref(m_accessible_scopes);
+	gc_ref(m_flattened_scopes);
 }
 
 void rt::ScopeDescriptor::initialize(
@@ -79,13 +80,17 @@ void rt::ScopeDescriptor::initialize(
 	const ScopeID& outer_id,
 	std::size_t scope_idx,
 	std::size_t size,
-	const gc::Local<ScopeIDArray>& accessible_scopes)
+	const gc::Local<ScopeIDArray>& accessible_scopes,
+	const gc::Local<ScopeIDArray>& flattened_scopes)
 {
 	m_id = id;
 	m_outer_id = outer_id;
 	m_scope_idx = scope_idx;
 	m_size = size;
 	m_accessible_scopes = accessible_scopes;
+	m_flattened_scopes = flattened_scopes;
+	m_flattened = false;
+	m_field_ofs = 0;
 }
 
 const rt::ScopeID& rt::ScopeDescriptor::get_id() const {
@@ -111,6 +116,29 @@ bool rt::ScopeDescriptor::is_scope_accessible(const ScopeID& id) const {
 	return false;
 }
 
+//Returns true if the block with the given ID has been flattened into this scope, so its code is executed
+//with this scope.
+bool rt::ScopeDescriptor::is_scope_flattened(const ScopeID& id) const {
+	for (const ScopeID& flat_id : *m_flattened_scopes) {
+		if (flat_id == id) return true;
+	}
+	return false;
+}
+
+bool rt::ScopeDescriptor::is_flattened() const {
+	return m_flattened;
+}
+
+std::size_t rt::ScopeDescriptor::get_field_ofs() const {
+	return m_field_ofs;
+}
+
+void rt::ScopeDescriptor::flatten(std::size_t scope_idx, std::size_t field_ofs) {
+	m_flattened = true;
+	m_scope_idx = scope_idx;
+	m_field_ofs = field_ofs;
+}
+
 //
 //StatementResult
 //
@@ -122,7 +150,7 @@ rt::StatementResult::StatementResult(StatementResultType type) {
 	m_type = type;
 }
 
-rt::StatementResult::StatementResult(StatementResultType type, const gc::Local<Value>& value) {
+rt::StatementResult::StatementResult(StatementResultType type, const ValueLoc& value) {
 	assert(rt::StatementResultType::RETURN == type
 		|| rt::StatementResultType::THROW == type);
 	assert(!!value);
@@ -134,7 +162,7 @@ rt::StatementResultType rt::StatementResult::get_type() const {
 	return m_type;
 }
 
-gc::Local<rt::Value> rt::StatementResult::get_value() const {
+rt::ValueLoc rt::StatementResult::get_value() const {
 	return m_value;
 }
 
@@ -142,7 +170,7 @@ rt::StatementResult rt::StatementResult::none() {
 	return StatementResult(StatementResultType::NONE);
 }
 
-rt::StatementResult rt::StatementResult::exception(const gc::Local<Value>& exception) {
+rt::StatementResult rt::StatementResult::exception(const ValueLoc& exception) {
 	return StatementResult(StatementResultType::THROW, exception);
 }
 
@@ -164,8 +192,10 @@ protected:
 	void initialize(const ScopeID& scope_id, std::size_t scope_ofs, std::size_t name_ofs);
 
 public:
-	gc::Local<Value> get(const gc::Local<ExecScope>& scope) const override final;
-	void set_initialize(const gc::Local<ExecScope>& scope, const gc::Local<Value>& value) const override final;
+	ValueLoc get(const gc::Local<ExecScope>& scope) const override final;
+	void set_initialize(const gc::Local<ExecScope>& scope, const ValueLoc& value) const override final;
+	std::size_t get_field_ofs() const override final;
+	void relocate(const ScopeID& scope_id, std::size_t scope_ofs, std::size_t field_ofs_shift) override final;
 
 protected:
 	std::size_t get_name_ofs() const;
@@ -183,7 +213,7 @@ public:
 	void initialize(const ScopeID& scope_id, std::size_t scope_ofs, std::size_t name_ofs);
 
 	DeclarationType get_declaration_type() const override;
-	void set_modify(const gc::Local<ExecScope>& scope, const gc::Local<Value>& value) const override final;
+	void set_modify(const gc::Local<ExecScope>& scope, const ValueLoc& value) const override final;
 };
 
 //
@@ -200,11 +230,34 @@ public:
 	DeclarationType get_declaration_type() const override;
 };
 
+//
+//DeclarationNameDescriptor : definition
+//
+
+//Descriptor of a function or a class declaration. The value is created on the first access and cached in a field
+//of the scope, so all reads within one scope instance return the same object.
+class rt::DeclarationNameDescriptor : public NameDescriptor {
+	NONCOPYABLE(DeclarationNameDescriptor);
+
+	std::size_t m_value_ofs;
+
+protected:
+	DeclarationNameDescriptor(){}
+	void initialize(const ScopeID& scope_id, std::size_t scope_ofs, std::size_t value_ofs);
+
+public:
+	ValueLoc get(const gc::Local<ExecScope>& scope) const override final;
+	void relocate(const ScopeID& scope_id, std::size_t scope_ofs, std::size_t field_ofs_shift) override final;
+
+protected:
+	virtual ValueLoc create_value(const gc::Local<ExecScope>& target_scope) const = 0;
+};
+
 //
 //FunctionNameDescriptor : definition
 //
 
-class rt::FunctionNameDescriptor : public NameDescriptor {
+class rt::FunctionNameDescriptor : public DeclarationNameDescriptor {
 	NONCOPYABLE(FunctionNameDescriptor);
 
 	gc::Ref<ast::FunctionDeclaration> m_declaration;
@@ -212,17 +265,23 @@ class rt::FunctionNameDescriptor : public NameDescriptor {
 public:
 	FunctionNameDescriptor(){}
 	void gc_enumerate_refs() override;
-	void initialize(const ScopeID& scope_id, std::size_t scope_ofs, const gc::Local<ast::FunctionDeclaration>& declaration);
+	void initialize(
+		const ScopeID& scope_id,
+		std::size_t scope_ofs,
+		std::size_t value_ofs,
+		const gc::Local<ast::FunctionDeclaration>& declaration);
 
 	DeclarationType get_declaration_type() const override;
-	gc::Local<Value> get(const gc::Local<ExecScope>& scope) const override;
+
+protected:
+	ValueLoc create_value(const gc::Local<ExecScope>& target_scope) const override;
 };
 
 //
 //ClassNameDescriptor : definition
 //
 
-class rt::ClassNameDescriptor : public NameDescriptor {
+class rt::ClassNameDescriptor : public DeclarationNameDescriptor {
 	NONCOPYABLE(ClassNameDescriptor);
 
 	gc::Ref<ast::ClassDeclaration> m_declaration;
@@ -230,10 +289,16 @@ class rt::ClassNameDescriptor : public NameDescriptor {
 public:
 	ClassNameDescriptor(){}
 	void gc_enumerate_refs() override;
-	void initialize(const ScopeID& scope_id, std::size_t scope_ofs, const gc::Local<ast::ClassDeclaration>& declaration);
+	void initialize(
+		const ScopeID& scope_id,
+		std::size_t scope_ofs,
+		std::size_t value_ofs,
+		const gc::Local<ast::ClassDeclaration>& declaration);
 
 	DeclarationType get_declaration_type() const override;
-	gc::Local<Value> get(const gc::Local<ExecScope>& scope) const override;
+
+protected:
+	ValueLoc create_value(const gc::Local<ExecScope>& target_scope) const override;
 };
 
 //
@@ -258,10 +323,14 @@ public:
 //BindContext
 //
 
-rt::BindContext::BindContext(ss::NameTable& name_table, const ValueFactory& value_factory)
+rt::BindContext::BindContext(
+	ss::NameTable& name_table,
+	const ValueFactory& value_factory,
+	ExecutionMode execution_mode)
 : m_internal(new Internal()),
 m_name_table(name_table),
-m_value_factory(value_factory)
+m_value_factory(value_factory),
+m_execution_mode(execution_mode)
 {}
 
 rt::BindContext::~BindContext() {
@@ -276,6 +345,10 @@ const rt::ValueFactory* rt::BindContext::get_value_factory() const {
 	return &m_value_factory;
 }
 
+rt::ExecutionMode rt::BindContext::get_execution_mode() const {
+	return m_execution_mode;
+}
+
 std::unique_ptr<rt::BindScope> rt::BindContext::create_root_scope() {
 	//Cannot use make_unique() because of GCC.
 	return std::unique_ptr<BindScope>(new BindScope(this, nullptr, 0, BAD_OFS));
@@ -294,13 +367,16 @@ rt::BindScope::BindScope(
 	BindScope* outer_scope,
 	std::size_t scope_ofs,
 	std::size_t this_scope_ofs,
+	bool block,
 	bool loop)
 	: m_context(context),
 	m_outer_scope(outer_scope),
 	m_scope_ofs(scope_ofs),
 	m_id(context->allocate_scope_id()),
 	m_this_scope_ofs(this_scope_ofs),
+	m_block(block),
 	m_loop(loop),
+	m_captured(false),
 	m_closed(false)
 {}
 
@@ -309,7 +385,7 @@ rt::BindScope::BindScope(
 	BindScope* outer_scope,
 	std::size_t scope_ofs,
 	std::size_t this_scope_ofs)
-	: BindScope(context, outer_scope, scope_ofs, this_scope_ofs, false)
+	: BindScope(context, outer_scope, scope_ofs, this_scope_ofs, false, false)
 {}
 
 rt::BindScope* rt::BindScope::get_outer_scope() const {
@@ -361,6 +437,7 @@ gc::Local<rt::NameDescriptor> rt::BindScope::declare_variable(const gc::Local<as
 
 	m_idx_to_name.push_back(name->get_info());
 	m_name_to_desc[name->get_id()] = desc;
+	m_field_descs.push_back(desc);
 	return desc;
 }
 
@@ -369,8 +446,13 @@ gc::Local<rt::NameDescriptor> rt::BindScope::declare_function(
 	const gc::Local<ast::FunctionDeclaration>& declaration)
 {
 	check_name_conflict(name);
-	gc::Local<NameDescriptor> desc = gc::create<FunctionNameDescriptor>(m_id, m_scope_ofs, declaration);
+
+	std::size_t idx = m_idx_to_name.size();
+	gc::Local<NameDescriptor> desc = gc::create<FunctionNameDescriptor>(m_id, m_scope_ofs, idx, declaration);
+
+	m_idx_to_name.push_back(name->get_info());
 	m_name_to_desc[name->get_id()] = desc;
+	m_field_descs.push_back(desc);
 	return desc;
 }
 
@@ -379,26 +461,33 @@ gc::Local<rt::NameDescriptor> rt::BindScope::declare_class(
 	const gc::Local<ast::ClassDeclaration>& declaration)
 {
 	check_name_conflict(name);
-	gc::Local<NameDescriptor> desc = gc::create<ClassNameDescriptor>(m_id, m_scope_ofs, declaration);
+
+	std::size_t idx = m_idx_to_name.size();
+	gc::Local<NameDescriptor> desc = gc::create<ClassNameDescriptor>(m_id, m_scope_ofs, idx, declaration);
+
+	m_idx_to_name.push_back(name->get_info());
 	m_name_to_desc[name->get_id()] = desc;
+	m_field_descs.push_back(desc);
 	return desc;
 }
 
 gc::Local<rt::NameDescriptor> rt::BindScope::declare_sys_constant(
 	const gc::Local<const ss::NameInfo>& name_info)
 {
-	check_name_conflict(name_info, nullptr);
+	check_name_conflict(name_info, TextPos());
 
 	std::size_t idx = m_idx_to_name.size();
 	gc::Local<NameDescriptor> desc = gc::create<ConstantNameDescriptor>(m_id, m_scope_ofs, idx);
 	m_idx_to_name.push_back(name_info);
 	m_name_to_desc[name_info->get_id()] = desc;
+	m_field_descs.push_back(desc);
 
 	return desc;
 }
 
 std::unique_ptr<rt::BindScope> rt::BindScope::create_nested_scope(bool nested_this_allowed) {
 	check_not_closed();
+	mark_captured();
 	std::size_t sub_scope_ofs = m_scope_ofs + 1;
 	std::size_t sub_this_scope_ofs = nested_this_allowed ? sub_scope_ofs : m_this_scope_ofs;
 	return std::unique_ptr<BindScope>(new BindScope(m_context, this, sub_scope_ofs, sub_this_scope_ofs));
@@ -408,7 +497,7 @@ std::unique_ptr<rt::BindScope> rt::BindScope::create_nested_block(bool nested_lo
 	check_not_closed();
 	std::size_t sub_scope_ofs = m_scope_ofs + 1;
 	bool sub_loop = m_loop | nested_loop;
-	return std::unique_ptr<BindScope>(new BindScope(m_context, this, sub_scope_ofs, m_this_scope_ofs, sub_loop));
+	return std::unique_ptr<BindScope>(new BindScope(m_context, this, sub_scope_ofs, m_this_scope_ofs, true, sub_loop));
 }
 
 gc::Local<rt::ScopeDescriptor> rt::BindScope::create_scope_descriptor() {
@@ -416,8 +505,16 @@ gc::Local<rt::ScopeDescriptor> rt::BindScope::create_scope_descriptor() {
 	std::size_t size = m_idx_to_name.size();
 	ScopeID outer_id = m_outer_scope ? m_outer_scope->get_id() : ScopeID();
 	gc::Local<ScopeIDArray> accessible_scopes = get_accessible_scopes();
-	gc::Local<ScopeDescriptor> desc = gc::create<ScopeDescriptor>(m_id, outer_id, m_scope_ofs, size, accessible_scopes);
+	gc::Local<ScopeIDArray> flattened_scopes = get_flattened_scopes();
+	gc::Local<ScopeDescriptor> desc = gc::create<ScopeDescriptor>(
+		m_id,
+		outer_id,
+		m_scope_ofs,
+		size,
+		accessible_scopes,
+		flattened_scopes);
 	m_closed = true;
+	if (m_block && !m_captured) flatten(desc);
 	return desc;
 }
 
@@ -440,7 +537,7 @@ void rt::BindScope::check_name_conflict(const gc::Local<ast::AstName>& name) con
 
 void rt::BindScope::check_name_conflict(
 	const gc::Local<const ss::NameInfo>& name_info,
-	const gc::Local<ss::TextPos>& text_pos) const
+	const ss::TextPos& text_pos) const
 {
 	check_not_closed();
 
@@ -471,6 +568,41 @@ gc::Local<rt::ScopeIDArray> rt::BindScope::get_accessible_scopes() const {
 	return scopes;
 }
 
+gc::Local<rt::ScopeIDArray> rt::BindScope::get_flattened_scopes() const {
+	gc::Local<ScopeIDArray> scopes = ScopeIDArray::create(m_flattened_scopes.size());
+	for (std::size_t i = 0, n = m_flattened_scopes.size(); i < n; ++i) (*scopes)[i] = m_flattened_scopes[i]->get_id();
+	return scopes;
+}
+
+//Private. Called when a function or a class scope is created within this scope: the closure references the whole
+//chain of scopes, so the enclosing blocks cannot be flattened.
+void rt::BindScope::mark_captured() {
+	for (BindScope* scope = this; scope && scope->m_block; scope = scope->m_outer_scope) scope->m_captured = true;
+}
+
+//Private. Moves the variables of the block to the outer scope. Blocks nested in this one have already been
+//flattened into it, since a block is not captured only if none of its nested blocks is.
+void rt::BindScope::flatten(const gc::Local<ScopeDescriptor>& desc) {
+	BindScope* outer_scope = m_outer_scope;
+	assert(outer_scope);
+	outer_scope->check_not_closed();
+
+	const std::size_t field_ofs = outer_scope->m_idx_to_name.size();
+	outer_scope->m_idx_to_name.insert(outer_scope->m_idx_to_name.end(), m_idx_to_name.begin(), m_idx_to_name.end());
+
+	for (const gc::Local<NameDescriptor>& name_desc : m_field_descs) {
+		name_desc->relocate(outer_scope->m_id, outer_scope->m_scope_ofs, field_ofs);
+		outer_scope->m_field_descs.push_back(name_desc);
+	}
+	for (const gc::Local<ScopeDescriptor>& scope_desc : m_flattened_scopes) {
+		scope_desc->flatten(outer_scope->m_scope_ofs, field_ofs + scope_desc->get_field_ofs());
+		outer_scope->m_flattened_scopes.push_back(scope_desc);
+	}
+
+	desc->flatten(outer_scope->m_scope_ofs, field_ofs);
+	outer_scope->m_flattened_scopes.push_back(desc);
+}
+
 //
 //NameDescriptor
 //
@@ -480,14 +612,18 @@ void rt::NameDescriptor::initialize(const ScopeID& scope_id, std::size_t scope_o
 	m_scope_ofs = scope_ofs;
 }
 
-void rt::NameDescriptor::set_initialize(const gc::Local<ExecScope>& scope, const gc::Local<Value>& value) const {
+void rt::NameDescriptor::set_initialize(const gc::Local<ExecScope>& scope, const ValueLoc& value) const {
 	throw SystemError("Cannot modify value");
 }
 
-void rt::NameDescriptor::set_modify(const gc::Local<ExecScope>& scope, const gc::Local<Value>& value) const {
+void rt::NameDescriptor::set_modify(const gc::Local<ExecScope>& scope, const ValueLoc& value) const {
 	throw SystemError("Cannot modify value");
 }
 
+std::size_t rt::NameDescriptor::get_field_ofs() const {
+	return BAD_OFS;
+}
+
 const rt::ScopeID& rt::NameDescriptor::get_scope_id() const {
 	return m_scope_id;
 }
@@ -496,6 +632,11 @@ std::size_t rt::NameDescriptor::get_scope_ofs() const {
 	return m_scope_ofs;
 }
 
+void rt::NameDescriptor::relocate(const ScopeID& scope_id, std::size_t scope_ofs, std::size_t field_ofs_shift) {
+	m_scope_id = scope_id;
+	m_scope_ofs = scope_ofs;
+}
+
 //
 //FieldNameDescriptor : implementation
 //
@@ -505,19 +646,28 @@ void rt::FieldNameDescriptor::initialize(const ScopeID& scope_id, std::size_t sc
 	m_name_ofs = name_ofs;
 }
 
-void rt::FieldNameDescriptor::set_initialize(const gc::Local<ExecScope>& scope, const gc::Local<Value>& value) const {
+void rt::FieldNameDescriptor::set_initialize(const gc::Local<ExecScope>& scope, const ValueLoc& value) const {
 	assert(!!value);
 	assert(!value->is_void());
-	gc::Ref<Value>& ref = scope->get(get_scope_id(), get_scope_ofs(), get_name_ofs());
+	ValueRef& ref = scope->get(get_scope_id(), get_scope_ofs(), get_name_ofs());
 	assert(!!ref);
 	assert(ref->is_undefined());
 	ref = value;
 }
 
-gc::Local<rt::Value> rt::FieldNameDescriptor::get(const gc::Local<ExecScope>& scope) const {
+rt::ValueLoc rt::FieldNameDescriptor::get(const gc::Local<ExecScope>& scope) const {
 	return scope->get(get_scope_id(), get_scope_ofs(), m_name_ofs);
 }
 
+std::size_t rt::FieldNameDescriptor::get_field_ofs() const {
+	return m_name_ofs;
+}
+
+void rt::FieldNameDescriptor::relocate(const ScopeID& scope_id, std::size_t scope_ofs, std::size_t field_ofs_shift) {
+	NameDescriptor::relocate(scope_id, scope_ofs, field_ofs_shift);
+	m_name_ofs += field_ofs_shift;
+}
+
 std::size_t rt::FieldNameDescriptor::get_name_ofs() const {
 	return m_name_ofs;
 }
@@ -534,9 +684,9 @@ rt::DeclarationType rt::VariableNameDescriptor::get_declaration_type() const {
 	return DeclarationType::VARIABLE;
 }
 
-void rt::VariableNameDescriptor::set_modify(const gc::Local<ExecScope>& scope, const gc::Local<Value>& value) const {
+void rt::VariableNameDescriptor::set_modify(const gc::Local<ExecScope>& scope, const ValueLoc& value) const {
 	assert(!value->is_void());
-	gc::Ref<Value>& ref = scope->get(get_scope_id(), get_scope_ofs(), get_name_ofs());
+	ValueRef& ref = scope->get(get_scope_id(), get_scope_ofs(), get_name_ofs());
 	ref = value;
 }
 
@@ -552,6 +702,31 @@ rt::DeclarationType rt::ConstantNameDescriptor::get_declaration_type() const {
 	return DeclarationType::CONSTANT;
 }
 
+//
+//DeclarationNameDescriptor : implementation
+//
+
+void rt::DeclarationNameDescriptor::initialize(const ScopeID& scope_id, std::size_t scope_ofs, std::size_t value_ofs) {
+	NameDescriptor::initialize(scope_id, scope_ofs);
+	m_value_ofs = value_ofs;
+}
+
+rt::ValueLoc rt::DeclarationNameDescriptor::get(const gc::Local<ExecScope>& scope) const {
+	gc::Local<ExecScope> target_scope = scope->get_target_scope(get_scope_id(), get_scope_ofs());
+	ValueRef& ref = target_scope->get_field(get_scope_ofs(), m_value_ofs);
+	if (ref->is_undefined()) ref = create_value(target_scope);
+	return ref;
+}
+
+void rt::DeclarationNameDescriptor::relocate(
+	const ScopeID& scope_id,
+	std::size_t scope_ofs,
+	std::size_t field_ofs_shift)
+{
+	NameDescriptor::relocate(scope_id, scope_ofs, field_ofs_shift);
+	m_value_ofs += field_ofs_shift;
+}
+
 //
 //FunctionNameDescriptor
 //
@@ -564,9 +739,10 @@ void rt::FunctionNameDescriptor::gc_enumerate_refs() {
 void rt::FunctionNameDescriptor::initialize(
 	const ScopeID& scope_id,
 	std::size_t scope_ofs,
+	std::size_t value_ofs,
 	const gc::Local<ast::FunctionDeclaration>& declaration)
 {
-	NameDescriptor::initialize(scope_id, scope_ofs);
+	DeclarationNameDescriptor::initialize(scope_id, scope_ofs, value_ofs);
 	m_declaration = declaration;
 }
 
@@ -574,8 +750,7 @@ rt::DeclarationType rt::FunctionNameDescriptor::get_declaration_type() const {
 	return DeclarationType::FUNCTION;
 }
 
-gc::Local<rt::Value> rt::FunctionNameDescriptor::get(const gc::Local<ExecScope>& scope) const {
-	gc::Local<ExecScope> target_scope = scope->get_target_scope(get_scope_id(), get_scope_ofs());
+rt::ValueLoc rt::FunctionNameDescriptor::create_value(const gc::Local<ExecScope>& target_scope) const {
 	return gc::create<rt::FunctionValue>(target_scope, m_declaration->get_expression().local());
 }
 
@@ -591,9 +766,10 @@ void rt::ClassNameDescriptor::gc_enumerate_refs() {
 void rt::ClassNameDescriptor::initialize(
 	const ScopeID& scope_id,
 	std::size_t scope_ofs,
+	std::size_t value_ofs,
 	const gc::Local<ast::ClassDeclaration>& declaration)
 {
-	NameDescriptor::initialize(scope_id, scope_ofs),
+	DeclarationNameDescriptor::initialize(scope_id, scope_ofs, value_ofs);
 	m_declaration = declaration;
 }
 
@@ -601,8 +777,7 @@ rt::DeclarationType rt::ClassNameDescriptor::get_declaration_type() const {
 	return DeclarationType::CLASS;
 }
 
-gc::Local<rt::Value> rt::ClassNameDescriptor::get(const gc::Local<ExecScope>& scope) const {
-	gc::Local<ExecScope> target_scope = scope->get_target_scope(get_scope_id(), get_scope_ofs());
+rt::ValueLoc rt::ClassNameDescriptor::create_value(const gc::Local<ExecScope>& target_scope) const {
 	return gc::create<rt::ClassValue>(target_scope, m_declaration->get_expression().local());
 }
 
@@ -630,7 +805,7 @@ const rt::ValueFactory* rt::ExecContext::get_value_factory() const {
 	return m_bind_context->get_value_factory();
 }
 
-gc::Local<rt::Value> rt::ExecContext::get_undefined_value() const {
+rt::ValueLoc rt::ExecContext::get_undefined_value() const {
 	return get_value_factory()->get_undefined_value();
 }
 
@@ -652,7 +827,7 @@ void rt::ExecScope::initialize(
 	const gc::Local<ExecContext>& context,
 	const gc::Local<ScopeDescriptor>& descriptor,
 	const gc::Local<ExecScope>& outer_scope,
-	const gc::Local<Value>& this_value)
+	const ValueLoc& this_value)
 {
 	m_context = context;
 	m_descriptor = descriptor;
@@ -669,8 +844,8 @@ void rt::ExecScope::initialize(
 	m_scope_idx = !!outer_scope ? outer_scope->m_scope_idx + 1 : 0;
 	m_this_value = this_value;
 
-	m_values = gc::Array<Value>::create(descriptor->get_size());
-	gc::Local<Value> undefined = context->get_value_factory()->get_undefined_value();
+	m_values = ValueArray::create(descriptor->get_size());
+	ValueLoc undefined = context->get_value_factory()->get_undefined_value();
 	for (std::size_t i = 0, n = m_values->length(); i < n; ++i) m_values->get(i) = undefined;
 }
 
@@ -682,32 +857,45 @@ const gc::Ref<rt::ScopeDescriptor>& rt::ExecScope::get_scope_descriptor() const
 	return m_descriptor;
 }
 
+const gc::Ref<rt::ExecScope>& rt::ExecScope::get_outer_scope() const {
+	return m_outer_scope;
+}
+
 void rt::ExecScope::check_id(const ScopeID& expected_id) {
-	if (get_id() != expected_id) throw SystemError("Scope ID missmatch");
+	if (get_id() != expected_id && !m_descriptor->is_scope_flattened(expected_id)) {
+		throw SystemError("Scope ID missmatch");
+	}
 }
 
 void rt::ExecScope::check_idx(std::size_t expected_idx) {
 	if (m_scope_idx != expected_idx) throw SystemError("Scope index missmatch");
 }
 
-gc::Ref<rt::Value>& rt::ExecScope::get(
+rt::ValueRef& rt::ExecScope::get(
 	const ScopeID& scope_id,
 	std::size_t scope_ofs,
 	std::size_t name_ofs)
 {
 	gc::Local<ExecScope> scope = get_target_scope(scope_id, scope_ofs);
-	gc::Ref<Value>& ref = scope->m_values->get(name_ofs);
+	ValueRef& ref = scope->m_values->get(name_ofs);
 	return ref;
 }
 
-gc::Local<rt::Value> rt::ExecScope::get_this(std::size_t scope_ofs) {
+rt::ValueRef& rt::ExecScope::get_field(std::size_t scope_ofs, std::size_t name_ofs) {
+	ExecScope* scope = this;
+	while (scope->m_scope_idx > scope_ofs) scope = scope->m_outer_scope.get();
+	assert(scope->m_scope_idx == scope_ofs);
+	return scope->m_values->get(name_ofs);
+}
+
+rt::ValueLoc rt::ExecScope::get_this(std::size_t scope_ofs) {
 	if (!m_this_value) throw SystemError("No 'this' in current scope");
 	return m_this_value;
 }
 
 gc::Local<rt::ExecScope> rt::ExecScope::create_nested_scope(
 	const gc::Local<ScopeDescriptor>& scope_descriptor,
-	const gc::Local<Value>& sub_this_value)
+	const ValueLoc& sub_this_value)
 {
 	return gc::create<ExecScope>(
 		gc::Local<ExecContext>(m_context),
@@ -716,6 +904,27 @@ gc::Local<rt::ExecScope> rt::ExecScope::create_nested_scope(
 		!!sub_this_value ? sub_this_value : m_this_value);
 }
 
+gc::Local<rt::ExecScope> rt::ExecScope::enter_block(const gc::Local<ScopeDescriptor>& scope_descriptor) {
+	if (!scope_descriptor->is_flattened()) return create_nested_scope(scope_descriptor, nullptr);
+	reset_fields(scope_descriptor.get());
+	return self(this);
+}
+
+//Sets the variables of a flattened block to undefined, as if a new scope was created for the block.
+void rt::ExecScope::reset_fields(const ScopeDescriptor* scope_descriptor) {
+	assert(scope_descriptor->is_flattened());
+	const std::size_t size = scope_descriptor->get_size();
+	if (!size) return;
+
+	ExecScope* scope = this;
+	while (scope->m_scope_idx > scope_descriptor->get_scope_idx()) scope = scope->m_outer_scope.get();
+	assert(scope->m_scope_idx == scope_descriptor->get_scope_idx());
+
+	ValueLoc undefined = m_context->get_undefined_value();
+	const std::size_t field_ofs = scope_descriptor->get_field_ofs();
+	for (std::size_t i = 0; i < size; ++i) scope->m_values->get(field_ofs + i) = undefined;
+}
+
 gc::Local<rt::ExecScope> rt::ExecScope::get_target_scope(const ScopeID& scope_id, std::size_t scope_ofs) {
 	gc::Local<ExecScope> scope = self(this);
 	while (!!scope && scope->m_scope_idx > scope_ofs) scope = scope->m_outer_scope;
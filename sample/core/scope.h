@@ -20,8 +20,8 @@
 #define SYNSAMPLE_CORE_SCOPE_H_INCLUDED
 
 #include <list>
-#include <map>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include "ast__dec.h"
@@ -31,6 +31,7 @@
 #include "name.h"
 #include "scope__dec.h"
 #include "value__dec.h"
+#include "value_handle.h"
 
 namespace syn_script {
 	namespace rt {
@@ -42,6 +43,11 @@ namespace syn_script {
 			CLASS
 		};
 
+		enum class ExecutionMode {
+			BYTECODE,
+			AST
+		};
+
 		enum class StatementResultType {
 			NONE,
 			BREAK,
@@ -84,6 +90,8 @@ namespace syn_script {
 
 		typedef gc::PrimitiveArray<ScopeID> ScopeIDArray;
 
+		//A flattened scope is a block not captured by closures. No scope object is created for it: its variables
+		//occupy the fields [field_ofs, field_ofs + size) of the enclosing scope with the index scope_idx.
 		class ScopeDescriptor : public gc::Object {
 			NONCOPYABLE(ScopeDescriptor);
 
@@ -92,6 +100,9 @@ namespace syn_script {
 			std::size_t m_scope_idx;
 			std::size_t m_size;
 			gc::Ref<ScopeIDArray> m_accessible_scopes;
+			gc::Ref<ScopeIDArray> m_flattened_scopes;
+			bool m_flattened;
+			std::size_t m_field_ofs;
 
 		public:
 			ScopeDescriptor(){}
@@ -101,13 +112,19 @@ namespace syn_script {
 				const ScopeID& outer_id,
 				std::size_t scope_idx,
 				std::size_t size,
-				const gc::Local<ScopeIDArray>& accessible_scopes);
+				const gc::Local<ScopeIDArray>& accessible_scopes,
+				const gc::Local<ScopeIDArray>& flattened_scopes);
 
 			const ScopeID& get_id() const;
 			const ScopeID& get_outer_id() const;
 			std::size_t get_scope_idx() const;
 			std::size_t get_size() const;
 			bool is_scope_accessible(const ScopeID& id) const;
+			bool is_scope_flattened(const ScopeID& id) const;
+
+			bool is_flattened() const;
+			std::size_t get_field_ofs() const;
+			void flatten(std::size_t scope_idx, std::size_t field_ofs);
 		};
 
 		//
@@ -116,17 +133,17 @@ namespace syn_script {
 
 		class StatementResult {
 			StatementResultType m_type;
-			gc::Local<Value> m_value;
+			ValueLoc m_value;
 
 		public:
 			explicit StatementResult(StatementResultType type);
-			StatementResult(StatementResultType type, const gc::Local<Value>& value);
+			StatementResult(StatementResultType type, const ValueLoc& value);
 
 			StatementResultType get_type() const;
-			gc::Local<Value> get_value() const;
+			ValueLoc get_value() const;
 
 			static StatementResult none();
-			static StatementResult exception(const gc::Local<Value>& exception);
+			static StatementResult exception(const ValueLoc& exception);
 		};
 
 		//-----------------------------------------------------------
@@ -145,13 +162,15 @@ namespace syn_script {
 
 			NameTable& m_name_table;
 			const ValueFactory& m_value_factory;
+			const ExecutionMode m_execution_mode;
 
 		public:
-			BindContext(NameTable& name_table, const ValueFactory& value_factory);
+			BindContext(NameTable& name_table, const ValueFactory& value_factory, ExecutionMode execution_mode);
 			~BindContext();
 
 			NameTable& get_name_table() const;
 			const ValueFactory* get_value_factory() const;
+			ExecutionMode get_execution_mode() const;
 			std::unique_ptr<BindScope> create_root_scope();
 			ScopeID allocate_scope_id();
 		};
@@ -169,11 +188,20 @@ namespace syn_script {
 			ScopeID const m_id;
 
 			std::size_t const m_this_scope_ofs;
+			bool const m_block;
 			bool const m_loop;
 
-			std::map<NameID, gc::Local<NameDescriptor>> m_name_to_desc;
+			std::unordered_map<NameID, gc::Local<NameDescriptor>, NameIDHash> m_name_to_desc;
 			std::vector<gc::Local<const NameInfo>> m_idx_to_name;
 
+			//Names stored in the fields of this scope (including names of flattened nested blocks), and
+			//descriptors of the flattened nested blocks. Updated when this scope is flattened itself.
+			std::vector<gc::Local<NameDescriptor>> m_field_descs;
+			std::vector<gc::Local<ScopeDescriptor>> m_flattened_scopes;
+
+			//true, if a closure is created within the block, so the block needs its own scope object.
+			bool m_captured;
+
 			bool m_closed;
 
 		private:
@@ -182,6 +210,7 @@ namespace syn_script {
 				BindScope* outer_scope,
 				std::size_t scope_ofs,
 				std::size_t this_scope_ofs,
+				bool block,
 				bool loop);
 
 		public:
@@ -223,9 +252,12 @@ namespace syn_script {
 
 			void check_name_conflict(
 				const gc::Local<const NameInfo>& name_info,
-				const gc::Local<TextPos>& text_pos) const;
+				const TextPos& text_pos) const;
 
 			gc::Local<ScopeIDArray> get_accessible_scopes() const;
+			gc::Local<ScopeIDArray> get_flattened_scopes() const;
+			void mark_captured();
+			void flatten(const gc::Local<ScopeDescriptor>& desc);
 		};
 
 		//
@@ -244,14 +276,20 @@ namespace syn_script {
 
 		public:
 			virtual DeclarationType get_declaration_type() const = 0;
-			virtual gc::Local<Value> get(const gc::Local<ExecScope>& scope) const = 0;
+			virtual ValueLoc get(const gc::Local<ExecScope>& scope) const = 0;
 
-			virtual void set_initialize(const gc::Local<ExecScope>& scope, const gc::Local<Value>& value) const;
-			virtual void set_modify(const gc::Local<ExecScope>& scope, const gc::Local<Value>& value) const;
+			virtual void set_initialize(const gc::Local<ExecScope>& scope, const ValueLoc& value) const;
+			virtual void set_modify(const gc::Local<ExecScope>& scope, const ValueLoc& value) const;
+
+			//Returns the offset of the value in the target scope, or BAD_OFS if the value is not stored in a field.
+			virtual std::size_t get_field_ofs() const;
+			std::size_t get_scope_ofs() const;
+
+			//Moves the value to another scope, when the scope where it is declared is flattened.
+			virtual void relocate(const ScopeID& scope_id, std::size_t scope_ofs, std::size_t field_ofs_shift);
 
 		protected:
 			const ScopeID& get_scope_id() const;
-			std::size_t get_scope_ofs() const;
 		};
 
 		//-----------------------------------------------------------
@@ -275,7 +313,7 @@ namespace syn_script {
 			BindContext* get_bind_context();
 			const ValueFactory* get_value_factory() const;
 
-			gc::Local<Value> get_undefined_value() const;
+			ValueLoc get_undefined_value() const;
 		};
 
 		//
@@ -289,8 +327,8 @@ namespace syn_script {
 			gc::Ref<ScopeDescriptor> m_descriptor;
 			gc::Ref<ExecScope> m_outer_scope;
 			std::size_t m_scope_idx;
-			gc::Ref<gc::Array<Value>> m_values;
-			gc::Ref<Value> m_this_value;
+			gc::Ref<ValueArray> m_values;
+			ValueRef m_this_value;
 
 		public:
 			ExecScope();
@@ -300,19 +338,27 @@ namespace syn_script {
 				const gc::Local<ExecContext>& context,
 				const gc::Local<ScopeDescriptor>& descriptor,
 				const gc::Local<ExecScope>& outer_scope,
-				const gc::Local<Value>& this_value);
+				const ValueLoc& this_value);
 
 			const ScopeID& get_id() const;
 			const gc::Ref<ScopeDescriptor>& get_scope_descriptor() const;
+			const gc::Ref<ExecScope>& get_outer_scope() const;
 			void check_id(const ScopeID& expected_id);
 			void check_idx(std::size_t expected_idx);
 
-			gc::Ref<Value>& get(const ScopeID& scope_id, std::size_t scope_ofs, std::size_t name_ofs);
-			gc::Local<Value> get_this(std::size_t scope_ofs);
+			ValueRef& get(const ScopeID& scope_id, std::size_t scope_ofs, std::size_t name_ofs);
+
+			//Unchecked version of get(), used by the bytecode, which is compiled from a bound AST.
+			ValueRef& get_field(std::size_t scope_ofs, std::size_t name_ofs);
+			ValueLoc get_this(std::size_t scope_ofs);
 
 			gc::Local<ExecScope> create_nested_scope(
 				const gc::Local<ScopeDescriptor>& scope_descriptor,
-				const gc::Local<Value>& sub_this_value);
+				const ValueLoc& sub_this_value);
+
+			//Returns the scope for executing a block: a new nested scope, or this scope if the block is flattened.
+			gc::Local<ExecScope> enter_block(const gc::Local<ScopeDescriptor>& scope_descriptor);
+			void reset_fields(const ScopeDescriptor* scope_descriptor);
 
 			gc::Local<ExecScope> get_target_scope(const ScopeID& scope_id, std::size_t scope_ofs);
 		};
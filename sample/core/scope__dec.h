@@ -30,6 +30,7 @@ namespace syn_script {
 		class FieldNameDescriptor;
 		class VariableNameDescriptor;
 		class ConstantNameDescriptor;
+		class DeclarationNameDescriptor;
 		class ClassNameDescriptor;
 		class FunctionNameDescriptor;
 
@@ -27,6 +27,7 @@
 #include "script.h"
 #include "value.h"
 #include "value_core.h"
+#include "value_stack.h"
 
 namespace ss = syn_script;
 namespace ast = ss::ast;
@@ -85,6 +86,44 @@ namespace {
 		}
 	};
 
+	//
+	//ThreadScriptScopeInitializer
+	//
+
+	class ThreadScriptScopeInitializer : public TopScriptScopeInitializer {
+		NONCOPYABLE(ThreadScriptScopeInitializer);
+
+		rt::ScriptScopeInitializer& m_initializer;
+
+	public:
+		ThreadScriptScopeInitializer(rt::ScriptScopeInitializer& initializer)
+			: m_initializer(initializer)
+		{}
+
+		void bind(ss::NameRegistry& name_registry, rt::BindScope& scope) override {
+			TopScriptScopeInitializer::bind(name_registry, scope);
+			m_initializer.bind(name_registry, scope);
+		}
+
+		void exec(const gc::Local<rt::ExecContext>& context, const gc::Local<rt::ExecScope>& scope) override {
+			TopScriptScopeInitializer::exec(context, scope);
+			m_initializer.exec(context, scope);
+		}
+	};
+
+	//
+	//ScriptThreadsGuard
+	//
+
+	//Threads started by the script use the GC, so they must finish before the top script returns.
+	class ScriptThreadsGuard {
+		NONCOPYABLE(ScriptThreadsGuard);
+
+	public:
+		ScriptThreadsGuard(){}
+		~ScriptThreadsGuard() { rt::wait_for_script_threads(); }
+	};
+
 	ast::ast_ptr<ast::Script> parse_script(ss::NameTable& name_table, const gc::Local<rt::ScriptSource>& source) {
 		ss::NameRegistry name_registry(name_table);
 		ss::Scanner scanner(name_registry, source->get_file_name(), source->get_code());
@@ -92,6 +131,7 @@ namespace {
 		try {
 			ast::ast_ptr<ast::Script> script = ss::syngen::SynParser::parse_Script(scanner);
 			assert(!!script);
+			script->set_source(scanner.get_source());
 			return script;
 		} catch (syn::SynSyntaxError&) {
 			throw ss::CompilationError(scanner.get_text_pos(), "Syntax error");
@@ -154,12 +194,23 @@ namespace {
 		return bind_scope->create_scope_descriptor();
 	}
 
+	void compile_scripts(const rt::BindContext& bind_context, const gc::Local<ScriptArray>& scripts) {
+		if (rt::ExecutionMode::BYTECODE != bind_context.get_execution_mode()) return;
+
+		//Only the top-level blocks are compiled here; function bodies are compiled on their first execution.
+		for (const gc::Ref<ast::Script>& script : *scripts) script->get_block()->compile();
+	}
+
 	rt::StatementResult exec_scripts(
 		const gc::Local<rt::ExecContext>& context,
 		const gc::Local<rt::ScopeDescriptor>& scope_descriptor,
 		rt::ScriptScopeInitializer& initializer,
 		const gc::Local<ScriptArray>& scripts)
 	{
+		//Holds the first value stack segment during the execution, so that each top-level invocation does not
+		//allocate a new one.
+		rt::ValueStackWindow stack_base(0);
+
 		gc::Local<rt::ExecScope> scope = context->create_root_scope(scope_descriptor);
 		initializer.exec(context, scope);
 
@@ -171,6 +222,28 @@ namespace {
 
 		return result;
 	}
+
+	rt::StatementResult execute_scripts(
+		const gc::Local<gc::Array<rt::ScriptSource>>& sources,
+		const gc::Local<ss::StringArray>& arguments,
+		rt::ExecutionMode execution_mode,
+		rt::ScriptScopeInitializer& initializer,
+		bool& ok)
+	{
+		ss::NameTable name_table;
+		gc::Local<ScriptArray> scripts = parse_scripts(name_table, sources);
+
+		std::unique_ptr<rt::ValueFactory> value_factory = create_value_factory(name_table, arguments);
+		rt::BindContext bind_context(name_table, *value_factory, execution_mode);
+		gc::Local<rt::ScopeDescriptor> scope_descriptor = bind_scripts(name_table, bind_context, initializer, scripts);
+		compile_scripts(bind_context, scripts);
+
+		gc::Local<rt::ExecContext> exec_context = gc::create<rt::ExecContext>(&bind_context);
+		rt::StatementResult result = exec_scripts(exec_context, scope_descriptor, initializer, scripts);
+
+		ok = get_return_value(exec_context, result);
+		return result;
+	}
 }
 
 //
@@ -192,22 +265,38 @@ gc::Local<gc::Array<rt::ScriptSource>> rt::get_single_script_source(
 
 bool rt::execute_top_script(
 	const gc::Local<gc::Array<ScriptSource>>& sources,
-	const gc::Local<ss::StringArray>& arguments)
+	const gc::Local<ss::StringArray>& arguments,
+	ExecutionMode execution_mode)
 {
+	ScriptThreadsGuard threads_guard;
 	TopScriptScopeInitializer initializer;
 
-	ss::NameTable name_table;
-	gc::Local<ScriptArray> scripts = parse_scripts(name_table, sources);
+	bool ok;
+	execute_scripts(sources, arguments, execution_mode, initializer, ok);
+	return ok;
+}
+
+//
+//execute_thread_script()
+//
 
-	std::unique_ptr<ValueFactory> value_factory = create_value_factory(name_table, arguments);
-	rt::BindContext bind_context(name_table, *value_factory);
-	gc::Local<rt::ScopeDescriptor> scope_descriptor = bind_scripts(name_table, bind_context, initializer, scripts);
+bool rt::execute_thread_script(
+	const gc::Local<gc::Array<ScriptSource>>& sources,
+	const gc::Local<ss::StringArray>& arguments,
+	ExecutionMode execution_mode,
+	ScriptScopeInitializer& initializer,
+	ValueLoc& result)
+{
+	ThreadScriptScopeInitializer thread_initializer(initializer);
 
-	gc::Local<rt::ExecContext> exec_context = gc::create<rt::ExecContext>(&bind_context);
-	rt::StatementResult result = exec_scripts(exec_context, scope_descriptor, initializer, scripts);
+	bool ok;
+	StatementResult statement_result = execute_scripts(sources, arguments, execution_mode, thread_initializer, ok);
 
-	bool ret = get_return_value(exec_context, result);
-	return ret;
+	result = ValueFactory::get_null_value();
+	if (StatementResultType::RETURN == statement_result.get_type() && !statement_result.get_value()->is_void()) {
+		result = statement_result.get_value();
+	}
+	return ok;
 }
 
 //
@@ -224,6 +313,7 @@ rt::StatementResult rt::execute_sub_script(
 
 	gc::Local<ScriptArray> scripts = parse_scripts(name_table, sources);
 	gc::Local<rt::ScopeDescriptor> scope_descriptor = bind_scripts(name_table, *bind_context, initializer, scripts);
+	compile_scripts(*bind_context, scripts);
 	rt::StatementResult result = exec_scripts(context, scope_descriptor, initializer, scripts);
 	return result;
 }
@@ -71,7 +71,19 @@ namespace syn_script {
 
 		bool execute_top_script(
 			const gc::Local<gc::Array<ScriptSource>>& sources,
-			const gc::Local<StringArray>& arguments);
+			const gc::Local<StringArray>& arguments,
+			ExecutionMode execution_mode);
+
+		//Executes the script of a thread started by another script. The thread has its own name table, value
+		//factory and execution context, so no interpreter state is shared between threads. The initializer
+		//declares names in addition to the system namespace. Returns false if the script has thrown an exception;
+		//otherwise, the result is the value returned by the script, or null.
+		bool execute_thread_script(
+			const gc::Local<gc::Array<ScriptSource>>& sources,
+			const gc::Local<StringArray>& arguments,
+			ExecutionMode execution_mode,
+			ScriptScopeInitializer& initializer,
+			ValueLoc& result);
 
 		StatementResult execute_sub_script(
 			const gc::Local<ExecContext>& context,
@@ -34,15 +34,12 @@ namespace {
 //StackTraceElement
 //
 
-void rt::StackTraceElement::gc_enumerate_refs() {
-	gc_ref(m_text_pos);
-}
-
-void rt::StackTraceElement::initialize(const gc::Local<ss::TextPos>& text_pos) {
+void rt::StackTraceElement::initialize(const ss::TextPos& text_pos) {
 	m_text_pos = text_pos;
+	m_source = SourceRef(text_pos);
 }
 
-gc::Local<ss::TextPos> rt::StackTraceElement::get_text_pos() const {
+const ss::TextPos& rt::StackTraceElement::get_text_pos() const {
 	return m_text_pos;
 }
 
@@ -55,7 +52,7 @@ std::ostream& rt::operator<<(std::ostream& out, const gc::Local<rt::StackTraceEl
 //StackTraceMark
 //
 
-rt::StackTraceMark::StackTraceMark(const gc::Local<ss::TextPos>& text_pos)
+rt::StackTraceMark::StackTraceMark(const ss::TextPos& text_pos)
 : m_next(gt_stack_top),
 m_text_pos(text_pos)
 {
@@ -68,7 +65,7 @@ rt::StackTraceMark::~StackTraceMark() {
 }
 
 gc::Local<rt::StackTraceMark::ElementArray> rt::StackTraceMark::get_stack_trace(
-	const gc::Local<ss::TextPos>& cur_text_pos)
+	const ss::TextPos& cur_text_pos)
 {
 	std::size_t cnt = 0;
 	StackTraceMark* mark = gt_stack_top;
@@ -36,14 +36,14 @@ namespace syn_script {
 		class StackTraceElement : public gc::Object {
 			NONCOPYABLE(StackTraceElement);
 
-			gc::Ref<TextPos> m_text_pos;
+			TextPos m_text_pos;
+			SourceRef m_source;
 
 		public:
 			StackTraceElement(){}
-			void gc_enumerate_refs() override;
-			void initialize(const gc::Local<TextPos>& text_pos);
+			void initialize(const TextPos& text_pos);
 
-			gc::Local<TextPos> get_text_pos() const;
+			const TextPos& get_text_pos() const;
 		};
 
 		std::ostream& operator<<(std::ostream& out, const gc::Local<StackTraceElement>& element);
@@ -58,13 +58,13 @@ namespace syn_script {
 			typedef gc::Array<StackTraceElement> ElementArray;
 
 			StackTraceMark* const m_next;
-			const gc::Local<TextPos> m_text_pos;
+			const TextPos m_text_pos;
 
 		public:
-			explicit StackTraceMark(const gc::Local<TextPos>& text_pos);
+			explicit StackTraceMark(const TextPos& text_pos);
 			~StackTraceMark();
 
-			static gc::Local<ElementArray> get_stack_trace(const gc::Local<TextPos>& cur_text_pos);
+			static gc::Local<ElementArray> get_stack_trace(const TextPos& cur_text_pos);
 		};
 
 	}
@@ -18,6 +18,7 @@
 
 #include <cstring>
 #include <string>
+#include <vector>
 
 #include "common.h"
 #include "stringex.h"
@@ -62,10 +63,12 @@ const std::string ss::StringIterator::EMPTY;
 //String
 //
 
-ss::String::String() : m_hash(0){}
+ss::String::String() : m_length(0), m_hash(0){}
 
 void ss::String::gc_enumerate_refs() {
 	gc_ref(m_value);
+	gc_ref(m_left);
+	gc_ref(m_right);
 }
 
 void ss::String::initialize(const char* str) {
@@ -75,6 +78,7 @@ void ss::String::initialize(const char* str) {
 void ss::String::initialize(const char* str, std::size_t len) {
 	//TODO Do not create an array if the len is 0.
 	m_value = CharArray::create(len);
+	m_length = len;
 	if (len) m_value->set(0, str, 0, len);
 }
 
@@ -85,6 +89,7 @@ void ss::String::initialize(const std::string& str) {
 void ss::String::initialize(const std::string& str, std::size_t start_pos, std::size_t end_pos) {
 	std::size_t len = end_pos - start_pos;
 	m_value = CharArray::create(len);
+	m_length = len;
 	for (std::size_t i = 0; i < len; ++i) m_value->get(i) = str[start_pos + i];
 }
 
@@ -92,29 +97,91 @@ void ss::String::initialize(const StringLoc& str, std::size_t start_pos, std::si
 	assert(start_pos <= end_pos);
 	std::size_t len = end_pos - start_pos;
 	m_value = CharArray::create(len);
-	if (start_pos < end_pos) m_value->set(0, str->m_value, start_pos, end_pos);
+	m_length = len;
+	if (start_pos < end_pos) m_value->set(0, str->get_value()->raw_array(), start_pos, end_pos);
 }
 
 void ss::String::initialize(const StringLoc& a, const StringLoc& b) {
 	std::size_t len1 = a->length();
 	std::size_t len2 = b->length();
+	m_length = len1 + len2;
+
+	if (m_length < MIN_CONCAT_LENGTH) {
+		m_value = CharArray::create(m_length);
+		char* data = m_value->raw_array();
+		a->copy_to(data);
+		b->copy_to(data + len1);
+		return;
+	}
+
+	//When short strings are appended one by one, they are merged into the short right part of the concatenation,
+	//so that the number of nodes is proportional to the length of the string, not to the number of appends.
+	gc::Local<const String> left = a->m_left;
+	gc::Local<const String> right = a->m_right;
+	if (!!left && !!right && right->length() + len2 < MIN_CONCAT_LENGTH) {
+		m_left = left;
+		m_right = gc::create<String>(right, b);
+	} else {
+		m_left = a;
+		m_right = b;
+	}
+}
+
+const gc::PrimitiveArray<char>* ss::String::get_value() const {
+	const CharArray* value = m_value.get();
+	if (value) return value;
+	return flatten();
+}
+
+const gc::PrimitiveArray<char>* ss::String::flatten() const {
+	gc::Local<CharArray> value = CharArray::create(m_length);
+	copy_to(value->raw_array());
 
-	m_value = CharArray::create(len1 + len2);
-	m_value->set(0, a->m_value, 0, len1);
-	m_value->set(len1, b->m_value, 0, len2);
+	//The value is set before the children are released, so a concurrent reader finds one of them.
+	m_value = value;
+	m_left = nullptr;
+	m_right = nullptr;
+	return value.get();
+}
+
+//Calls the function for each flat part of the string, in order. Concatenations built by appending in a loop
+//are deep, so an explicit stack is used instead of recursion.
+template<class Fn>
+void ss::String::for_each_chunk(Fn fn) const {
+	std::vector<const String*> stack;
+	const String* str = this;
+	for (;;) {
+		const CharArray* value = str->m_value.get();
+		if (!value) {
+			const String* left = str->m_left.get();
+			const String* right = str->m_right.get();
+			if (left && right) {
+				stack.push_back(right);
+				str = left;
+				continue;
+			}
+			value = str->m_value.get();
+			assert(value);
+		}
+
+		if (str->m_length) fn(value->raw_array(), str->m_length);
+		if (stack.empty()) break;
+		str = stack.back();
+		stack.pop_back();
+	}
 }
 
 bool ss::String::is_empty() const {
-	return !m_value->length();
+	return !m_length;
 }
 
 std::size_t ss::String::length() const {
-	return m_value->length();
+	return m_length;
 }
 
 char ss::String::char_at(std::size_t index) const {
 	assert(index < length());
-	return m_value->get(index);
+	return get_value()->get(index);
 }
 
 ss::StringLoc ss::String::substring(std::size_t start) const {
@@ -127,44 +194,49 @@ ss::StringLoc ss::String::substring(std::size_t start, std::size_t end) const {
 	return gc::create<String>(self(this), start, end);
 }
 
+void ss::String::copy_to(char* dst) const {
+	for_each_chunk([&dst](const char* data, std::size_t len) {
+		std::memcpy(dst, data, len);
+		dst += len;
+	});
+}
+
 std::unique_ptr<char[]> ss::String::get_c_string() const {
 	std::size_t len = length();
-	const char* raw_array = m_value->raw_array();
-
 	std::unique_ptr<char[]> data(new char[len + 1]);
 	char* raw_data = data.get();
-	for (std::size_t i = 0; i < len; ++i) raw_data[i] = raw_array[i];
+	copy_to(raw_data);
 	raw_data[len] = 0;
 
 	return data;
 }
 
 std::string ss::String::get_std_string() const {
-	std::size_t len = length();
-	const char* raw_array = m_value->raw_array();
-	return std::string(raw_array, len);
+	std::string str;
+	str.reserve(length());
+	for_each_chunk([&str](const char* data, std::size_t len) {
+		str.append(data, len);
+	});
+	return str;
 }
 
 void ss::String::get_std_string(std::size_t start_ofs, std::size_t end_ofs, std::string& str) const {
 	assert(start_ofs <= end_ofs);
 	assert(end_ofs <= length());
 
-	const char* raw_array = m_value->raw_array();
+	const char* raw_array = get_value()->raw_array();
 	str.assign(raw_array + start_ofs, end_ofs - start_ofs);
 }
 
 gc::Local<ss::ByteArray> ss::String::get_bytes() const {
-	std::size_t len = length();
 	//TODO Do not create an empty array.
-	gc::Local<ByteArray> array = ByteArray::create(len);
-	const char* src = m_value->raw_array();
-	char* dst = array->raw_array();
-	while (len--) *dst++ = *src++;
+	gc::Local<ByteArray> array = ByteArray::create(length());
+	copy_to(array->raw_array());
 	return array;
 }
 
 const char* ss::String::get_raw_data() const {
-	return m_value->raw_array();
+	return get_value()->raw_array();
 }
 
 int ss::String::compare_to(const StringLoc& str) const {
@@ -178,11 +250,11 @@ bool ss::String::equals(const gc::Local<const ObjectEx>& obj) const {
 	const String* const str = dynamic_cast<const String*>(ptr);
 	if (!str) return false;
 
-	const CharArray* const value1 = m_value.get();
-	const CharArray* const value2 = str->m_value.get();
+	const std::size_t len = m_length;
+	if (len != str->m_length) return false;
 
-	const std::size_t len = value1->length();
-	if (len != value2->length()) return false;
+	const CharArray* const value1 = get_value();
+	const CharArray* const value2 = str->get_value();
 
 	const char* array1 = value1->raw_array();
 	const char* array2 = value2->raw_array();
@@ -197,9 +269,9 @@ std::size_t ss::String::hash_code() const {
 	std::size_t hash = m_hash.load(std::memory_order_relaxed);
 
 	if (!hash) {
-		const CharArray* const value = m_value.get();
-		const std::size_t len = value->length();
+		const std::size_t len = m_length;
 		if (len) {
+			const CharArray* const value = get_value();
 			for (std::size_t i = 0; i < len; ++i) {
 				hash = hash * 31 + static_cast<std::size_t>(value->get(i));
 			}
@@ -215,8 +287,8 @@ int ss::String::compare(const gc::Local<const String>& str1, const gc::Local<con
 	std::size_t len2 = str2->length();
 	std::size_t ofs = 0;
 
-	const char* array1 = str1->m_value->raw_array();
-	const char* array2 = str2->m_value->raw_array();
+	const char* array1 = str1->get_value()->raw_array();
+	const char* array2 = str2->get_value()->raw_array();
 
 	for (;;) {
 		if (ofs >= len1) return ofs >= len2 ? 0 : -1;
@@ -246,10 +318,10 @@ ss::StringLoc ss::operator+(const StringLoc& a, const StringLoc& b) {
 
 std::ostream& ss::operator<<(std::ostream& out, const ss::StringLoc& str) {
 	std::ostream::sentry s(out);
-	const CharArray* value = str->m_value.get();
-	const std::size_t len = value->length();
-	const char* data = value->raw_array();
-	out.rdbuf()->sputn(data, len);
+	std::streambuf* buf = out.rdbuf();
+	str->for_each_chunk([buf](const char* data, std::size_t len) {
+		buf->sputn(data, len);
+	});
 	return out;
 }
 
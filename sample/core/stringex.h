@@ -44,7 +44,15 @@ namespace syn_script {
 		friend StringLoc operator+(const StringLoc& a, const StringLoc& b);
 		friend std::ostream& operator<<(std::ostream& out, const StringLoc& str);
 
-		gc::Ref<gc::PrimitiveArray<char>> m_value;
+		//Concatenations shorter than this are copied immediately.
+		static const std::size_t MIN_CONCAT_LENGTH = 64;
+
+		//A string is either flat (the value is set), or a concatenation of two strings (the children are set).
+		//A concatenation is flattened on the first random access; sequential operations read the children.
+		mutable gc::Ref<gc::PrimitiveArray<char>> m_value;
+		mutable gc::Ref<const String> m_left;
+		mutable gc::Ref<const String> m_right;
+		std::size_t m_length;
 		mutable std::atomic<std::size_t> m_hash;
 
 	public:
@@ -58,6 +66,11 @@ namespace syn_script {
 		void initialize(const StringLoc& str, std::size_t start_pos, std::size_t end_pos);
 		void initialize(const StringLoc& a, const StringLoc& b);
 
+	private:
+		const gc::PrimitiveArray<char>* get_value() const;
+		const gc::PrimitiveArray<char>* flatten() const;
+		template<class Fn> void for_each_chunk(Fn fn) const;
+
 	public:
 		bool is_empty() const;
 		std::size_t length() const;
@@ -65,6 +78,9 @@ namespace syn_script {
 		StringLoc substring(std::size_t start) const;
 		StringLoc substring(std::size_t start, std::size_t end) const;
 
+		//Copies all characters to the buffer, without flattening the string.
+		void copy_to(char* dst) const;
+
 		std::unique_ptr<char[]> get_c_string() const;
 		std::string get_std_string() const;
 		void get_std_string(std::size_t start_ofs, std::size_t end_ofs, std::string& str) const;
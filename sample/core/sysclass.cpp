@@ -50,30 +50,53 @@ void rt::SysClass::initialize(const gc::Local<InternalClass>& internal) {
 	m_class_value = gc::create<SysClassValue>(self(this));
 }
 
-gc::Local<rt::Value> rt::SysClass::get_class_value() const {
+rt::ValueLoc rt::SysClass::get_class_value() const {
 	return m_class_value;
 }
 
-gc::Local<rt::Value> rt::SysClass::instantiate(
+rt::ValueLoc rt::SysClass::instantiate(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<gc::Array<Value>>& arguments)
+	const ArgSpan& arguments)
 {
 	return m_internal->instantiate(context, arguments);
 }
 
-gc::Local<rt::Value> rt::SysClass::get_member(
+rt::ValueLoc rt::SysClass::get_member(
 	const gc::Local<ExecContext>& context,
 	const gc::Local<const ss::NameInfo>& name_info,
-	const gc::Local<Value>& object) const
+	const ValueLoc& object,
+	MemberCache& cache) const
 {
-	return m_internal->get_member(context, name_info, object);
+	return m_internal->get_member(context, name_info, object, cache);
 }
 
-gc::Local<rt::Value> rt::SysClass::get_member_static(
+rt::ValueLoc rt::SysClass::get_member_static(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<const ss::NameInfo>& name_info) const
+	const gc::Local<const ss::NameInfo>& name_info,
+	MemberCache& cache) const
+{
+	return m_internal->get_member_static(context, name_info, cache);
+}
+
+rt::ValueLoc rt::SysClass::invoke_member(
+	const gc::Local<ExecContext>& context,
+	const gc::Local<const ss::NameInfo>& name_info,
+	const ValueLoc& object,
+	const ArgSpan& arguments,
+	MemberCache& cache,
+	ValueLoc& exception) const
 {
-	return m_internal->get_member_static(context, name_info);
+	return m_internal->invoke_member(context, name_info, object, arguments, cache, exception);
+}
+
+rt::ValueLoc rt::SysClass::invoke_member_static(
+	const gc::Local<ExecContext>& context,
+	const gc::Local<const ss::NameInfo>& name_info,
+	const ArgSpan& arguments,
+	MemberCache& cache,
+	ValueLoc& exception) const
+{
+	return m_internal->invoke_member_static(context, name_info, arguments, cache, exception);
 }
 
 //
@@ -95,38 +118,79 @@ void rt::SysClass::InternalClass::initialize(
 	m_members = members;
 }
 
-gc::Local<rt::Value> rt::SysClass::InternalClass::instantiate(
+rt::ValueLoc rt::SysClass::InternalClass::instantiate(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<gc::Array<Value>>& arguments)
+	const ArgSpan& arguments)
 {
 	if (!m_constructor) throw RuntimeError("Constructor is not defined");
 	return m_constructor->instantiate(context, arguments);
 }
 
-gc::Local<rt::Value> rt::SysClass::InternalClass::get_member(
+rt::ValueLoc rt::SysClass::InternalClass::get_member(
 	const gc::Local<ExecContext>& context,
 	const gc::Local<const ss::NameInfo>& name_info,
-	const gc::Local<Value>& object) const
+	const ValueLoc& object,
+	MemberCache& cache) const
 {
-	gc::Local<SysMember> member = find_member(name_info);
+	const SysMember* member = find_member(name_info, cache);
 	return member->get(context, object);
 }
 
-gc::Local<rt::Value> rt::SysClass::InternalClass::get_member_static(
+rt::ValueLoc rt::SysClass::InternalClass::get_member_static(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<const ss::NameInfo>& name_info) const
+	const gc::Local<const ss::NameInfo>& name_info,
+	MemberCache& cache) const
 {
-	gc::Local<SysMember> member = find_member(name_info);
+	const SysMember* member = find_member(name_info, cache);
 	return member->get_static(context);
 }
 
-gc::Local<rt::SysMember> rt::SysClass::InternalClass::find_member(
-	const gc::Local<const ss::NameInfo>& name_info) const
+rt::ValueLoc rt::SysClass::InternalClass::invoke_member(
+	const gc::Local<ExecContext>& context,
+	const gc::Local<const ss::NameInfo>& name_info,
+	const ValueLoc& object,
+	const ArgSpan& arguments,
+	MemberCache& cache,
+	ValueLoc& exception) const
+{
+	const SysMember* member = find_member(name_info, cache);
+	return member->invoke(context, object, arguments, exception);
+}
+
+rt::ValueLoc rt::SysClass::InternalClass::invoke_member_static(
+	const gc::Local<ExecContext>& context,
+	const gc::Local<const ss::NameInfo>& name_info,
+	const ArgSpan& arguments,
+	MemberCache& cache,
+	ValueLoc& exception) const
+{
+	const SysMember* member = find_member(name_info, cache);
+	return member->invoke_static(context, arguments, exception);
+}
+
+const rt::SysMember* rt::SysClass::InternalClass::find_member(
+	const gc::Local<const ss::NameInfo>& name_info,
+	MemberCache& cache) const
 {
+	const gc::Object* cached = cache.get(this);
+	if (cached) return static_cast<const SysMember*>(cached);
+
+	//Members are sorted by name.
 	const NameID name_id = name_info->get_id();
-	for (std::size_t i = 0, n = m_members->length(); i < n; ++i) {
-		const gc::Ref<SysMember>& member = m_members->get(i);
-		if (name_id == member->get_name_info()->get_id()) return member;
+	std::size_t low = 0;
+	std::size_t high = m_members->length();
+	while (low < high) {
+		std::size_t mid = (low + high) / 2;
+		const gc::Ref<SysMember>& member = m_members->get(mid);
+		const NameID member_id = member->get_name_info()->get_id();
+		if (name_id == member_id) {
+			cache.put(self(this), member.local());
+			return member.get();
+		} else if (member_id < name_id) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
 	}
 
 	throw RuntimeError(std::string("Member not found: ") + name_info->get_str()->get_std_string());
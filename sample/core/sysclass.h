@@ -38,27 +38,44 @@ public:
 
 private:
 	gc::Ref<InternalClass> m_internal;
-	gc::Ref<Value> m_class_value;
+	ValueRef m_class_value;
 
 public:
 	SysClass();
 	void gc_enumerate_refs() override;
 	void initialize(const gc::Local<InternalClass>& internal);
 
-	gc::Local<Value> get_class_value() const;
+	ValueLoc get_class_value() const;
 
-	gc::Local<Value> instantiate(
+	ValueLoc instantiate(
 		const gc::Local<ExecContext>& context,
-		const gc::Local<gc::Array<Value>>& arguments);
+		const ArgSpan& arguments);
 
-	gc::Local<Value> get_member(
+	ValueLoc get_member(
 		const gc::Local<ExecContext>& context,
 		const gc::Local<const NameInfo>& name_info,
-		const gc::Local<Value>& object) const;
+		const ValueLoc& object,
+		MemberCache& cache) const;
 
-	gc::Local<Value> get_member_static(
+	ValueLoc get_member_static(
 		const gc::Local<ExecContext>& context,
-		const gc::Local<const NameInfo>& name_info) const;
+		const gc::Local<const NameInfo>& name_info,
+		MemberCache& cache) const;
+
+	ValueLoc invoke_member(
+		const gc::Local<ExecContext>& context,
+		const gc::Local<const NameInfo>& name_info,
+		const ValueLoc& object,
+		const ArgSpan& arguments,
+		MemberCache& cache,
+		ValueLoc& exception) const;
+
+	ValueLoc invoke_member_static(
+		const gc::Local<ExecContext>& context,
+		const gc::Local<const NameInfo>& name_info,
+		const ArgSpan& arguments,
+		MemberCache& cache,
+		ValueLoc& exception) const;
 };
 
 #endif//SYNSAMPLE_CORE_SYSCLASS_H_INCLUDED
@@ -43,9 +43,9 @@ protected:
 	SysConstructor(){}
 
 public:
-	virtual gc::Local<Value> instantiate(
+	virtual ValueLoc instantiate(
 		const gc::Local<ExecContext>& context,
-		const gc::Local<gc::Array<Value>>& arguments) const = 0;
+		const ArgSpan& arguments) const = 0;
 };
 
 //
@@ -65,8 +65,25 @@ protected:
 public:
 	const gc::Ref<const NameInfo>& get_name_info() const { return m_name_info; }
 
-	virtual gc::Local<Value> get(const gc::Local<ExecContext>& context, const gc::Local<Value>& object) const = 0;
-	virtual gc::Local<Value> get_static(const gc::Local<ExecContext>& context) const = 0;
+	virtual ValueLoc get(const gc::Local<ExecContext>& context, const ValueLoc& object) const = 0;
+	virtual ValueLoc get_static(const gc::Local<ExecContext>& context) const = 0;
+
+	virtual ValueLoc invoke(
+		const gc::Local<ExecContext>& context,
+		const ValueLoc& object,
+		const ArgSpan& arguments,
+		ValueLoc& exception) const
+	{
+		return get(context, object)->invoke(context, arguments, exception);
+	}
+
+	virtual ValueLoc invoke_static(
+		const gc::Local<ExecContext>& context,
+		const ArgSpan& arguments,
+		ValueLoc& exception) const
+	{
+		return get_static(context)->invoke(context, arguments, exception);
+	}
 };
 
 //
@@ -84,21 +101,38 @@ public:
 	void gc_enumerate_refs() override;
 	void initialize(const gc::Local<SysConstructor>& constructor, const gc::Local<gc::Array<SysMember>>& members);
 
-	gc::Local<Value> instantiate(
+	ValueLoc instantiate(
 		const gc::Local<ExecContext>& context,
-		const gc::Local<gc::Array<Value>>& arguments);
+		const ArgSpan& arguments);
 
-	gc::Local<Value> get_member(
+	ValueLoc get_member(
 		const gc::Local<ExecContext>& context,
 		const gc::Local<const NameInfo>& name_info,
-		const gc::Local<Value>& object) const;
+		const ValueLoc& object,
+		MemberCache& cache) const;
 
-	gc::Local<Value> get_member_static(
+	ValueLoc get_member_static(
 		const gc::Local<ExecContext>& context,
-		const gc::Local<const NameInfo>& name_info) const;
+		const gc::Local<const NameInfo>& name_info,
+		MemberCache& cache) const;
+
+	ValueLoc invoke_member(
+		const gc::Local<ExecContext>& context,
+		const gc::Local<const NameInfo>& name_info,
+		const ValueLoc& object,
+		const ArgSpan& arguments,
+		MemberCache& cache,
+		ValueLoc& exception) const;
+
+	ValueLoc invoke_member_static(
+		const gc::Local<ExecContext>& context,
+		const gc::Local<const NameInfo>& name_info,
+		const ArgSpan& arguments,
+		MemberCache& cache,
+		ValueLoc& exception) const;
 
 private:
-	gc::Local<SysMember> find_member(const gc::Local<const NameInfo>& name_info) const;
+	const SysMember* find_member(const gc::Local<const NameInfo>& name_info, MemberCache& cache) const;
 };
 
 #endif//SYNSAMPLE_CORE_SYSCLASS_INT_H_INCLUDED
@@ -16,6 +16,7 @@
 
 //SysClass builder implementation.
 
+#include <algorithm>
 #include <list>
 #include <map>
 #include <memory>
@@ -60,9 +61,10 @@ namespace syn_script {
 
 		gc::Local<rt::MethodAccess> find_appropriate_method(
 			const gc::Local<MethodAccessArray>& methods,
-			const gc::Local<gc::Array<rt::Value>>& arguments);
+			const rt::ArgSpan& arguments);
 
 		gc::Local<MethodAccessArray> create_methods_array(const MethodAccessVector& vec);
+		gc::Local<MethodAccess> find_method_by_arity(const MethodAccessVector& vec, std::size_t arity);
 	}
 }
 
@@ -129,8 +131,8 @@ protected:
 	FieldAccess();
 
 public:
-	virtual gc::Local<Value> get_static(const gc::Local<ExecContext>& context) const;
-	virtual gc::Local<Value> get(const gc::Local<ExecContext>& context, const gc::Local<Value>& object) const;
+	virtual ValueLoc get_static(const gc::Local<ExecContext>& context) const;
+	virtual ValueLoc get(const gc::Local<ExecContext>& context, const ValueLoc& object) const;
 };
 
 //
@@ -145,16 +147,16 @@ protected:
 
 public:
 	virtual bool is_static() const = 0;
-	virtual bool accepts_arguments(const gc::Local<gc::Array<Value>>& arguments) const = 0;
+	virtual std::size_t get_arity() const = 0;
 
-	virtual gc::Local<Value> invoke_static(
+	virtual ValueLoc invoke_static(
 		const gc::Local<ExecContext>& context,
-		const gc::Local<gc::Array<Value>>& arguments) const;
+		const ArgSpan& arguments) const;
 
-	virtual gc::Local<Value> invoke(
+	virtual ValueLoc invoke(
 		const gc::Local<ExecContext>& context,
-		const gc::Local<gc::Array<Value>>& arguments,
-		const gc::Local<Value>& object) const;
+		const ArgSpan& arguments,
+		const ValueLoc& object) const;
 };
 
 //
@@ -171,7 +173,7 @@ public:
 	void gc_enumerate_refs() override;
 	void initialize(const gc::Local<StaticFieldAdapter>& adapter);
 
-	gc::Local<Value> get_static(const gc::Local<ExecContext>& context) const override;
+	ValueLoc get_static(const gc::Local<ExecContext>& context) const override;
 };
 
 //
@@ -188,7 +190,7 @@ public:
 	void gc_enumerate_refs() override;
 	void initialize(const gc::Local<DynamicFieldAdapter>& adapter);
 
-	gc::Local<Value> get(const gc::Local<ExecContext>& context, const gc::Local<Value>& object) const override;
+	ValueLoc get(const gc::Local<ExecContext>& context, const ValueLoc& object) const override;
 };
 
 //
@@ -206,11 +208,11 @@ public:
 	void initialize(const gc::Local<StaticMethodAdapter>& adapter);
 
 	bool is_static() const override;
-	bool accepts_arguments(const gc::Local<gc::Array<Value>>& arguments) const override;
+	std::size_t get_arity() const override;
 
-	gc::Local<Value> invoke_static(
+	ValueLoc invoke_static(
 		const gc::Local<ExecContext>& context,
-		const gc::Local<gc::Array<Value>>& arguments) const override;
+		const ArgSpan& arguments) const override;
 };
 
 //
@@ -228,12 +230,12 @@ public:
 	void initialize(const gc::Local<DynamicMethodAdapter>& adapter);
 
 	bool is_static() const override;
-	bool accepts_arguments(const gc::Local<gc::Array<Value>>& arguments) const override;
+	std::size_t get_arity() const override;
 
-	gc::Local<Value> invoke(
+	ValueLoc invoke(
 		const gc::Local<ExecContext>& context,
-		const gc::Local<gc::Array<Value>>& arguments,
-		const gc::Local<Value>& object) const override;
+		const ArgSpan& arguments,
+		const ValueLoc& object) const override;
 };
 
 //
@@ -252,15 +254,15 @@ public:
 	void gc_enumerate_refs() override;
 	void initialize(const gc::Local<MethodAccessArray>& methods);
 
-	gc::Local<Value> invoke(
+	ValueLoc invoke(
 		const gc::Local<ExecContext>& context,
-		const gc::Local<gc::Array<Value>>& arguments,
-		gc::Local<Value>& exception) override final;
+		const ArgSpan& arguments,
+		ValueLoc& exception) override final;
 
 protected:
-	virtual gc::Local<Value> do_invoke(
+	virtual ValueLoc do_invoke(
 		const gc::Local<ExecContext>& context,
-		const gc::Local<gc::Array<Value>>& arguments,
+		const ArgSpan& arguments,
 		const gc::Local<MethodAccess>& method) const = 0;
 };
 
@@ -275,9 +277,9 @@ public:
 	StaticMethodValue();
 
 protected:
-	gc::Local<Value> do_invoke(
+	ValueLoc do_invoke(
 		const gc::Local<ExecContext>& context,
-		const gc::Local<gc::Array<Value>>& arguments,
+		const ArgSpan& arguments,
 		const gc::Local<MethodAccess>& method) const override;
 };
 
@@ -288,17 +290,17 @@ protected:
 class rt::DynamicMethodValue : public MethodValue {
 	NONCOPYABLE(DynamicMethodValue);
 
-	gc::Ref<Value> m_object;
+	ValueRef m_object;
 
 public:
 	DynamicMethodValue();
 	void gc_enumerate_refs() override;
-	void initialize(const gc::Local<MethodAccessArray>& methods, const gc::Local<Value>& object);
+	void initialize(const gc::Local<MethodAccessArray>& methods, const ValueLoc& object);
 
 protected:
-	gc::Local<Value> do_invoke(
+	ValueLoc do_invoke(
 		const gc::Local<ExecContext>& context,
-		const gc::Local<gc::Array<Value>>& arguments,
+		const ArgSpan& arguments,
 		const gc::Local<MethodAccess>& method) const override;
 };
 
@@ -344,9 +346,9 @@ public:
 	void gc_enumerate_refs() override;
 	void initialize(const gc::Local<MethodAccessArray>& methods);
 
-	gc::Local<Value> instantiate(
+	ValueLoc instantiate(
 		const gc::Local<ExecContext>& context,
-		const gc::Local<gc::Array<Value>>& arguments) const override;
+		const ArgSpan& arguments) const override;
 };
 
 //
@@ -363,8 +365,8 @@ public:
 	void gc_enumerate_refs() override;
 	void initialize(const gc::Local<const NameInfo>& name_info, const gc::Local<FieldAccess> field_access);
 
-	gc::Local<Value> get(const gc::Local<ExecContext>& context, const gc::Local<Value>& object) const override;
-	gc::Local<Value> get_static(const gc::Local<ExecContext>& context) const override;
+	ValueLoc get(const gc::Local<ExecContext>& context, const ValueLoc& object) const override;
+	ValueLoc get_static(const gc::Local<ExecContext>& context) const override;
 };
 
 //
@@ -374,7 +376,8 @@ public:
 class rt::SysMethod : public SysMember {
 	NONCOPYABLE(SysMethod);
 
-	gc::Ref<Value> m_static_value;
+	ValueRef m_static_value;
+	gc::Ref<MethodAccessArray> m_static_accesses;
 	gc::Ref<MethodAccessArray> m_method_accesses;
 
 public:
@@ -383,11 +386,23 @@ public:
 
 	void initialize(
 		const gc::Local<const NameInfo>& name_info,
-		const gc::Local<Value>& static_value,
+		const ValueLoc& static_value,
+		const gc::Local<MethodAccessArray>& static_accesses,
 		const gc::Local<MethodAccessArray>& method_accesses);
 
-	gc::Local<Value> get(const gc::Local<ExecContext>& context, const gc::Local<Value>& object) const override;
-	gc::Local<Value> get_static(const gc::Local<ExecContext>& context) const override;
+	ValueLoc get(const gc::Local<ExecContext>& context, const ValueLoc& object) const override;
+	ValueLoc get_static(const gc::Local<ExecContext>& context) const override;
+
+	ValueLoc invoke(
+		const gc::Local<ExecContext>& context,
+		const ValueLoc& object,
+		const ArgSpan& arguments,
+		ValueLoc& exception) const override;
+
+	ValueLoc invoke_static(
+		const gc::Local<ExecContext>& context,
+		const ArgSpan& arguments,
+		ValueLoc& exception) const override;
 };
 
 //
@@ -459,13 +474,13 @@ gc::Local<rt::SysClass> rt::SysClassInitializer::create_sys_class(ss::NameRegist
 
 rt::FieldAccess::FieldAccess(){}
 
-gc::Local<rt::Value> rt::FieldAccess::get_static(const gc::Local<ExecContext>& context) const {
+rt::ValueLoc rt::FieldAccess::get_static(const gc::Local<ExecContext>& context) const {
 	throw RuntimeError("Not a static field");
 }
 
-gc::Local<rt::Value> rt::FieldAccess::get(
+rt::ValueLoc rt::FieldAccess::get(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<Value>& object) const
+	const ValueLoc& object) const
 {
 	return get_static(context);
 }
@@ -476,18 +491,18 @@ gc::Local<rt::Value> rt::FieldAccess::get(
 
 rt::MethodAccess::MethodAccess(){}
 
-gc::Local<rt::Value> rt::MethodAccess::invoke_static(
+rt::ValueLoc rt::MethodAccess::invoke_static(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<gc::Array<Value>>& arguments) const
+	const ArgSpan& arguments) const
 {
 	assert(false);
 	throw SystemError("Not a static method");
 }
 
-gc::Local<rt::Value> rt::MethodAccess::invoke(
+rt::ValueLoc rt::MethodAccess::invoke(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<gc::Array<Value>>& arguments,
-	const gc::Local<Value>& object) const
+	const ArgSpan& arguments,
+	const ValueLoc& object) const
 {
 	return invoke_static(context, arguments);
 }
@@ -506,7 +521,7 @@ void rt::FunctionStaticFieldAccess::initialize(const gc::Local<StaticFieldAdapte
 	m_adapter = adapter;
 }
 
-gc::Local<rt::Value> rt::FunctionStaticFieldAccess::get_static(const gc::Local<ExecContext>& context) const {
+rt::ValueLoc rt::FunctionStaticFieldAccess::get_static(const gc::Local<ExecContext>& context) const {
 	return m_adapter->get(context);
 }
 
@@ -524,9 +539,9 @@ void rt::FunctionDynamicFieldAccess::initialize(const gc::Local<DynamicFieldAdap
 	m_adapter = adapter;
 }
 
-gc::Local<rt::Value> rt::FunctionDynamicFieldAccess::get(
+rt::ValueLoc rt::FunctionDynamicFieldAccess::get(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<Value>& object) const
+	const ValueLoc& object) const
 {
 	return m_adapter->get(context, object);
 }
@@ -549,13 +564,13 @@ bool rt::FunctionStaticMethodAccess::is_static() const {
 	return true;
 }
 
-bool rt::FunctionStaticMethodAccess::accepts_arguments(const gc::Local<gc::Array<Value>>& arguments) const {
-	return m_adapter->accepts_arguments(arguments);
+std::size_t rt::FunctionStaticMethodAccess::get_arity() const {
+	return m_adapter->get_arity();
 }
 
-gc::Local<rt::Value> rt::FunctionStaticMethodAccess::invoke_static(
+rt::ValueLoc rt::FunctionStaticMethodAccess::invoke_static(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<gc::Array<Value>>& arguments) const
+	const ArgSpan& arguments) const
 {
 	return m_adapter->invoke(context, arguments);
 }
@@ -578,14 +593,14 @@ bool rt::FunctionDynamicMethodAccess::is_static() const {
 	return false;
 }
 
-bool rt::FunctionDynamicMethodAccess::accepts_arguments(const gc::Local<gc::Array<Value>>& arguments) const {
-	return m_adapter->accepts_arguments(arguments);
+std::size_t rt::FunctionDynamicMethodAccess::get_arity() const {
+	return m_adapter->get_arity();
 }
 
-gc::Local<rt::Value> rt::FunctionDynamicMethodAccess::invoke(
+rt::ValueLoc rt::FunctionDynamicMethodAccess::invoke(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<gc::Array<Value>>& arguments,
-	const gc::Local<Value>& object) const
+	const ArgSpan& arguments,
+	const ValueLoc& object) const
 {
 	return m_adapter->invoke(context, object, arguments);
 }
@@ -604,10 +619,10 @@ void rt::MethodValue::initialize(const gc::Local<MethodAccessArray>& methods) {
 	m_methods = methods;
 }
 
-gc::Local<rt::Value> rt::MethodValue::invoke(
+rt::ValueLoc rt::MethodValue::invoke(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<gc::Array<Value>>& arguments,
-	gc::Local<Value>& exception)
+	const ArgSpan& arguments,
+	ValueLoc& exception)
 {
 	gc::Local<MethodAccess> method = find_appropriate_method(m_methods, arguments);
 	return do_invoke(context, arguments, method);
@@ -619,9 +634,9 @@ gc::Local<rt::Value> rt::MethodValue::invoke(
 
 rt::StaticMethodValue::StaticMethodValue(){}
 
-gc::Local<rt::Value> rt::StaticMethodValue::do_invoke(
+rt::ValueLoc rt::StaticMethodValue::do_invoke(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<gc::Array<Value>>& arguments,
+	const ArgSpan& arguments,
 	const gc::Local<MethodAccess>& method) const
 {
 	return method->invoke_static(context, arguments);
@@ -640,15 +655,15 @@ void rt::DynamicMethodValue::gc_enumerate_refs() {
 
 void rt::DynamicMethodValue::initialize(
 	const gc::Local<MethodAccessArray>& methods,
-	const gc::Local<Value>& object)
+	const ValueLoc& object)
 {
 	MethodValue::initialize(methods);
 	m_object = object;
 }
 
-gc::Local<rt::Value> rt::DynamicMethodValue::do_invoke(
+rt::ValueLoc rt::DynamicMethodValue::do_invoke(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<gc::Array<Value>>& arguments,
+	const ArgSpan& arguments,
 	const gc::Local<MethodAccess>& method) const
 {
 	return method->invoke(context, arguments, m_object);
@@ -690,25 +705,36 @@ void rt::BasicSysClassBuilder::InternalBuilder::add_method(
 		throw RuntimeError(std::string("Method-field conflict: ") + name);
 	}
 
-	m_methods[name_key].push_back(method);
+	MethodAccessVector& methods = m_methods[name_key];
+	if (!!find_method_by_arity(methods, method->get_arity())) {
+		throw RuntimeError(std::string("Duplicated method overload: ") + name);
+	}
+
+	methods.push_back(method);
 }
 
 void rt::BasicSysClassBuilder::InternalBuilder::add_constructor(const gc::Local<MethodAccess>& method) {
+	if (!!find_method_by_arity(m_constructors, method->get_arity())) {
+		throw RuntimeError("Duplicated constructor overload");
+	}
+
 	m_constructors.push_back(method);
 }
 
 gc::Local<rt::SysClass> rt::BasicSysClassBuilder::InternalBuilder::create_sys_class() const {
-	std::size_t member_cnt = m_fields.size() + m_methods.size();
-	gc::Local<gc::Array<SysMember>> members = gc::Array<SysMember>::create(member_cnt);
-
-	std::size_t member_idx = 0;
+	//Members are sorted by name, so that the class can use binary search.
+	std::map<NameKey, gc::Local<SysMember>> member_map;
 	for (auto iter : m_fields) {
-		members->get(member_idx++) = gc::create<SysField>(iter.first.m_name_info, iter.second);
+		member_map[iter.first] = gc::create<SysField>(iter.first.m_name_info, iter.second);
 	}
 	for (auto iter : m_methods) {
-		members->get(member_idx++) = create_sys_method(iter.first.m_name_info, iter.second);
+		member_map[iter.first] = create_sys_method(iter.first.m_name_info, iter.second);
 	}
 
+	gc::Local<gc::Array<SysMember>> members = gc::Array<SysMember>::create(member_map.size());
+	std::size_t member_idx = 0;
+	for (auto iter : member_map) members->get(member_idx++) = iter.second;
+
 	gc::Local<SysConstructor> constructor;
 	if (!m_constructors.empty()) {
 		gc::Local<MethodAccessArray> constructor_methods = create_methods_array(m_constructors);
@@ -723,23 +749,20 @@ gc::Local<rt::SysMethod> rt::BasicSysClassBuilder::InternalBuilder::create_sys_m
 	const gc::Local<const ss::NameInfo>& name_info,
 	const MethodAccessVector& methods) const
 {
-	gc::Local<Value> static_value;
+	ValueLoc static_value;
+	gc::Local<MethodAccessArray> static_methods;
 
-	std::size_t static_cnt = 0;
+	MethodAccessVector static_vec;
 	for (const gc::Local<MethodAccess>& method : methods) {
-		if (method->is_static()) ++static_cnt;
+		if (method->is_static()) static_vec.push_back(method);
 	}
-	if (static_cnt) {
-		gc::Local<MethodAccessArray> static_methods = MethodAccessArray::create(static_cnt);
-		std::size_t static_idx = 0;
-		for (const gc::Local<MethodAccess>& method : methods) {
-			if (method->is_static()) static_methods->get(static_idx++) = method;
-		}
+	if (!static_vec.empty()) {
+		static_methods = create_methods_array(static_vec);
 		static_value = gc::create<StaticMethodValue>(static_methods);
 	}
 
 	gc::Local<MethodAccessArray> all_methods = create_methods_array(methods);
-	return gc::create<SysMethod>(name_info, static_value, all_methods);
+	return gc::create<SysMethod>(name_info, static_value, static_methods, all_methods);
 }
 
 //
@@ -756,9 +779,9 @@ void rt::ConcreteSysConstructor::initialize(const gc::Local<MethodAccessArray>&
 	m_methods = methods;
 }
 
-gc::Local<rt::Value> rt::ConcreteSysConstructor::instantiate(
+rt::ValueLoc rt::ConcreteSysConstructor::instantiate(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<gc::Array<Value>>& arguments) const
+	const ArgSpan& arguments) const
 {
 	gc::Local<MethodAccess> method = find_appropriate_method(m_methods, arguments);
 	return method->invoke_static(context, arguments);
@@ -783,11 +806,11 @@ void rt::SysField::initialize(
 	m_field_access = field_access;
 }
 
-gc::Local<rt::Value> rt::SysField::get(const gc::Local<ExecContext>& context, const gc::Local<Value>& object) const {
+rt::ValueLoc rt::SysField::get(const gc::Local<ExecContext>& context, const ValueLoc& object) const {
 	return m_field_access->get(context, object);
 }
 
-gc::Local<rt::Value> rt::SysField::get_static(const gc::Local<ExecContext>& context) const {
+rt::ValueLoc rt::SysField::get_static(const gc::Local<ExecContext>& context) const {
 	return m_field_access->get_static(context);
 }
 
@@ -800,96 +823,113 @@ rt::SysMethod::SysMethod(){}
 void rt::SysMethod::gc_enumerate_refs() {
 	SysMember::gc_enumerate_refs();
 	gc_ref(m_static_value);
+	gc_ref(m_static_accesses);
 	gc_ref(m_method_accesses);
 }
 
 void rt::SysMethod::initialize(
 	const gc::Local<const ss::NameInfo>& name_info,
-	const gc::Local<Value>& static_value,
+	const ValueLoc& static_value,
+	const gc::Local<MethodAccessArray>& static_accesses,
 	const gc::Local<MethodAccessArray>& method_accesses)
 {
 	SysMember::initialize(name_info);
 	m_static_value = static_value;
+	m_static_accesses = static_accesses;
 	m_method_accesses = method_accesses;
 }
 
-gc::Local<rt::Value> rt::SysMethod::get(const gc::Local<ExecContext>& context, const gc::Local<Value>& object) const {
+rt::ValueLoc rt::SysMethod::get(const gc::Local<ExecContext>& context, const ValueLoc& object) const {
 	const gc::Local<MethodAccessArray>& methods = m_method_accesses;
 	return gc::create<DynamicMethodValue>(methods, object);
 }
 
-gc::Local<rt::Value> rt::SysMethod::get_static(const gc::Local<ExecContext>& context) const {
+rt::ValueLoc rt::SysMethod::get_static(const gc::Local<ExecContext>& context) const {
 	if (!m_static_value) throw RuntimeError("Not a static method");
 	return m_static_value;
 }
 
+//Invokes the method directly, without creating a method value.
+rt::ValueLoc rt::SysMethod::invoke(
+	const gc::Local<ExecContext>& context,
+	const ValueLoc& object,
+	const ArgSpan& arguments,
+	ValueLoc& exception) const
+{
+	gc::Local<MethodAccess> method = find_appropriate_method(m_method_accesses, arguments);
+	return method->invoke(context, arguments, object);
+}
+
+rt::ValueLoc rt::SysMethod::invoke_static(
+	const gc::Local<ExecContext>& context,
+	const ArgSpan& arguments,
+	ValueLoc& exception) const
+{
+	if (!m_static_accesses) throw RuntimeError("Not a static method");
+	gc::Local<MethodAccess> method = find_appropriate_method(m_static_accesses, arguments);
+	return method->invoke_static(context, arguments);
+}
+
 //
 //(Functions)
 //
 
 gc::Local<rt::MethodAccess> rt::find_appropriate_method(
 	const gc::Local<MethodAccessArray>& methods,
-	const gc::Local<gc::Array<Value>>& arguments)
+	const ArgSpan& arguments)
 {
-	for (std::size_t i = 0, n = methods->length(); i < n; ++i) {
-		const gc::Ref<MethodAccess>& method = methods->get(i);
-		if (method->accepts_arguments(arguments)) return method;
+	std::size_t arity = arguments.length();
+	if (arity < methods->length()) {
+		const gc::Ref<MethodAccess>& method = methods->get(arity);
+		if (!!method) return method;
 	}
 
 	throw ss::RuntimeError("Wrong method arguments");
 }
 
+//Creates a table of method overloads indexed by the arity.
 gc::Local<rt::MethodAccessArray> rt::create_methods_array(const MethodAccessVector& vec) {
-	std::size_t cnt = vec.size();
+	std::size_t cnt = 0;
+	for (const gc::Local<MethodAccess>& method : vec) cnt = std::max(cnt, method->get_arity() + 1);
+
 	gc::Local<MethodAccessArray> methods = MethodAccessArray::create(cnt);
-	for (std::size_t i = 0; i < cnt; ++i) methods->get(i) = vec[i];
+	for (const gc::Local<MethodAccess>& method : vec) {
+		gc::Ref<MethodAccess>& ref = methods->get(method->get_arity());
+		assert(!ref);
+		ref = method;
+	}
 	return methods;
 }
 
-gc::Local<rt::Value> rt::adapter__result(const gc::Local<ExecContext>& context,	bool v) {
-	return context->get_value_factory()->get_boolean_value(v);
-}
-
-gc::Local<rt::Value> rt::adapter__result(const gc::Local<ExecContext>& context,	ss::ScriptIntegerType v) {
-	return context->get_value_factory()->get_integer_value(v);
+gc::Local<rt::MethodAccess> rt::find_method_by_arity(const MethodAccessVector& vec, std::size_t arity) {
+	for (const gc::Local<MethodAccess>& method : vec) {
+		if (method->get_arity() == arity) return method;
+	}
+	return nullptr;
 }
 
-gc::Local<rt::Value> rt::adapter__result(const gc::Local<ExecContext>& context, const ss::StringLoc& v) {
+rt::ValueLoc rt::adapter__result(const gc::Local<ExecContext>& context, const ss::StringLoc& v) {
 	if (!v) return context->get_value_factory()->get_null_value();
 	return context->get_value_factory()->get_string_value(v);
 }
 
-gc::Local<rt::Value> rt::adapter__result(
+rt::ValueLoc rt::adapter__result(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<gc::Array<Value>>& v)
+	const gc::Local<ValueArray>& v)
 {
 	if (!v) return context->get_value_factory()->get_null_value();
 	return gc::create<ArrayValue>(v);
 }
 
-bool rt::adapter__convert_argument(
-	const gc::Local<Value>& v,
-	AdapterTag<bool>)
-{
-	return v->get_boolean();
-}
-
-ss::ScriptIntegerType rt::adapter__convert_argument(
-	const gc::Local<Value>& v,
-	AdapterTag<ss::ScriptIntegerType>)
-{
-	return v->get_integer();
-}
-
 ss::StringLoc rt::adapter__convert_argument(
-	const gc::Local<Value>& v,
+	const ValueLoc& v,
 	AdapterTag<const ss::StringLoc&>)
 {
 	return v->get_string();
 }
 
 gc::Local<ss::ByteArray> rt::adapter__convert_argument(
-	const gc::Local<Value>& v,
+	const ValueLoc& v,
 	AdapterTag<const gc::Local<ss::ByteArray>&>)
 {
 	gc::Local<ByteArrayValue> array_value = v.cast_opt<ByteArrayValue>();
@@ -897,16 +937,16 @@ gc::Local<ss::ByteArray> rt::adapter__convert_argument(
 	return array_value->get_array();
 }
 
-const gc::Local<rt::Value>& rt::adapter__convert_argument(
-	const gc::Local<Value>& v,
-	AdapterTag<const gc::Local<Value>&>)
+const rt::ValueLoc& rt::adapter__convert_argument(
+	const ValueLoc& v,
+	AdapterTag<const ValueLoc&>)
 {
 	return v;
 }
 
-gc::Local<gc::Array<rt::Value>> rt::adapter__convert_argument(
-	const gc::Local<Value>& v,
-	AdapterTag<const gc::Local<gc::Array<Value>>&>)
+gc::Local<rt::ValueArray> rt::adapter__convert_argument(
+	const ValueLoc& v,
+	AdapterTag<const gc::Local<ValueArray>&>)
 {
 	gc::Local<ArrayValue> array_value = v.cast<ArrayValue>();
 	return array_value->get_array();
@@ -90,7 +90,7 @@ public:
 	template<class... Args>
 	void add_constructor(gc::Local<T> (*fn)(const gc::Local<ExecContext>&, Args...));
 
-	void add_static_field(const char* name, const gc::Local<Value>& value);
+	void add_static_field(const char* name, const ValueLoc& value);
 
 	template<class R>
 	void add_static_field(const char* name, R (*fn)(const gc::Local<ExecContext>&));
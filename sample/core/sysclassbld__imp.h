@@ -37,7 +37,9 @@ protected:
 	MethodAdapter(){}
 
 public:
-	virtual bool accepts_arguments(const gc::Local<gc::Array<Value>>& arguments) const = 0;
+	//Overloads of a method are distinguished by the number of arguments, so the method to invoke is chosen by
+	//indexing a table with the arity.
+	virtual std::size_t get_arity() const = 0;
 };
 
 //
@@ -51,7 +53,7 @@ protected:
 	StaticFieldAdapter(){}
 
 public:
-	virtual gc::Local<Value> get(const gc::Local<ExecContext>& context) const = 0;
+	virtual ValueLoc get(const gc::Local<ExecContext>& context) const = 0;
 };
 
 //
@@ -65,9 +67,9 @@ protected:
 	StaticMethodAdapter(){}
 
 public:
-	virtual gc::Local<Value> invoke(
+	virtual ValueLoc invoke(
 		const gc::Local<ExecContext>& context,
-		const gc::Local<gc::Array<Value>>& arguments) const = 0;
+		const ArgSpan& arguments) const = 0;
 };
 
 //
@@ -81,9 +83,9 @@ protected:
 	DynamicFieldAdapter(){}
 
 public:
-	virtual gc::Local<Value> get(
+	virtual ValueLoc get(
 		const gc::Local<ExecContext>& context,
-		const gc::Local<Value>& object) const = 0;
+		const ValueLoc& object) const = 0;
 };
 
 //
@@ -97,10 +99,10 @@ protected:
 	DynamicMethodAdapter(){}
 
 public:
-	virtual gc::Local<Value> invoke(
+	virtual ValueLoc invoke(
 		const gc::Local<ExecContext>& context,
-		const gc::Local<Value>& object,
-		const gc::Local<gc::Array<Value>>& arguments) const = 0;
+		const ValueLoc& object,
+		const ArgSpan& arguments) const = 0;
 };
 
 namespace syn_script {
@@ -112,16 +114,25 @@ namespace syn_script {
 		template<class T, class R> class GenericDynamicFieldAdapter;
 		template<class T, class R, class... Args> class GenericDynamicMethodAdapter;
 
-		gc::Local<Value> adapter__result(const gc::Local<ExecContext>& context, bool v);
-		gc::Local<Value> adapter__result(const gc::Local<ExecContext>& context, ScriptIntegerType v);
-		gc::Local<Value> adapter__result(const gc::Local<ExecContext>& context, const StringLoc& v);
+		//Primitive results and arguments are converted inline: booleans and most integers are immediate values.
 
-		gc::Local<Value> adapter__result(
+		inline ValueLoc adapter__result(const gc::Local<ExecContext>& context, bool v) {
+			return ValueLoc::from_word(ValueWord::encode_boolean(v));
+		}
+
+		inline ValueLoc adapter__result(const gc::Local<ExecContext>& context, ScriptIntegerType v) {
+			if (ValueWord::fits_integer(v)) return ValueLoc::from_word(ValueWord::encode_integer(v));
+			return context->get_value_factory()->get_integer_value(v);
+		}
+
+		ValueLoc adapter__result(const gc::Local<ExecContext>& context, const StringLoc& v);
+
+		ValueLoc adapter__result(
 			const gc::Local<ExecContext>& context,
-			const gc::Local<gc::Array<Value>>& v);
+			const gc::Local<ValueArray>& v);
 
 		template<class T>
-		gc::Local<Value> adapter__result(const gc::Local<ExecContext>& context,	const gc::Local<T>& v) {
+		ValueLoc adapter__result(const gc::Local<ExecContext>& context,	const gc::Local<T>& v) {
 			if (!!v) return v;
 			return context->get_value_factory()->get_null_value();
 		}
@@ -129,7 +140,7 @@ namespace syn_script {
 		template<class R>
 		struct AdapterGenericResult {
 			template<class Fn>
-			static gc::Local<Value> adapt(const gc::Local<ExecContext>& context, Fn fn) {
+			static ValueLoc adapt(const gc::Local<ExecContext>& context, Fn fn) {
 				return adapter__result(context, fn());
 			}
 		};
@@ -137,66 +148,61 @@ namespace syn_script {
 		template<>
 		struct AdapterGenericResult<void> {
 			template<class Fn>
-			static gc::Local<Value> adapt(const gc::Local<ExecContext>& context, Fn fn) {
+			static ValueLoc adapt(const gc::Local<ExecContext>& context, Fn fn) {
 				fn();
 				return context->get_value_factory()->get_void_value();
 			}
 		};
 
 		template<>
-		struct AdapterGenericResult<gc::Local<Value>> {
+		struct AdapterGenericResult<ValueLoc> {
 			template<class Fn>
-			static gc::Local<Value> adapt(const gc::Local<ExecContext>& context, Fn fn) {
+			static ValueLoc adapt(const gc::Local<ExecContext>& context, Fn fn) {
 				return fn();
 			}
 		};
 
 		template<class R, class ADAPTER>
-		gc::Local<Value> adapter__get_field(
+		ValueLoc adapter__get_field(
 			const ADAPTER* adapter,
 			const gc::Local<ExecContext>& context,
-			const gc::Local<Value>& object)
+			const ValueLoc& object)
 		{
 			return AdapterGenericResult<R>::adapt(context, [=]() -> R {
 				return adapter->get_0(context, object);
 			});
 		}
 
-		template<class... Args>
-		bool adapter__check_arguments(const gc::Local<gc::Array<Value>>& arguments) {
-			return sizeof...(Args) == arguments->length();
-		}
-
 		template<class T> class AdapterTag {};
 
 		template<class... T> class AdapterTags {};
 
-		bool adapter__convert_argument(
-			const gc::Local<Value>& v,
-			AdapterTag<bool>);
+		inline bool adapter__convert_argument(const ValueLoc& v, AdapterTag<bool>) {
+			return v.get_boolean();
+		}
 
-		ScriptIntegerType adapter__convert_argument(
-			const gc::Local<Value>& v,
-			AdapterTag<ScriptIntegerType>);
+		inline ScriptIntegerType adapter__convert_argument(const ValueLoc& v, AdapterTag<ScriptIntegerType>) {
+			return v.get_integer();
+		}
 
 		StringLoc adapter__convert_argument(
-			const gc::Local<Value>& v,
+			const ValueLoc& v,
 			AdapterTag<const StringLoc&>);
 
 		gc::Local<ByteArray> adapter__convert_argument(
-			const gc::Local<Value>& v,
+			const ValueLoc& v,
 			AdapterTag<const gc::Local<ByteArray>&>);
 
-		const gc::Local<Value>& adapter__convert_argument(
-			const gc::Local<Value>& v,
-			AdapterTag<const gc::Local<Value>&>);
+		const ValueLoc& adapter__convert_argument(
+			const ValueLoc& v,
+			AdapterTag<const ValueLoc&>);
 
-		gc::Local<gc::Array<Value>> adapter__convert_argument(
-			const gc::Local<Value>& v,
-			AdapterTag<const gc::Local<gc::Array<Value>>&>);
+		gc::Local<ValueArray> adapter__convert_argument(
+			const ValueLoc& v,
+			AdapterTag<const gc::Local<ValueArray>&>);
 
 		template<class T>
-		gc::Local<T> adapter__convert_argument_gclocal(const gc::Local<Value>& v, AdapterTag<T>, const Value*) {
+		gc::Local<T> adapter__convert_argument_gclocal(const ValueLoc& v, AdapterTag<T>, const Value*) {
 			if (!v) return nullptr;
 			gc::Local<T> result = v.cast_opt<T>();
 			if (!result) throw RuntimeError("Wrong argument type");
@@ -204,7 +210,7 @@ namespace syn_script {
 		}
 
 		template<class T>
-		gc::Local<T> adapter__convert_argument(const gc::Local<Value>& v, AdapterTag<const gc::Local<T>&>) {
+		gc::Local<T> adapter__convert_argument(const ValueLoc& v, AdapterTag<const gc::Local<T>&>) {
 			return adapter__convert_argument_gclocal(v, AdapterTag<T>(), static_cast<const T*>(nullptr));
 		}
 
@@ -212,8 +218,8 @@ namespace syn_script {
 		R adapter__convert_arguments_recursively(
 			const ADAPTER* adapter,
 			const gc::Local<ExecContext>& context,
-			const gc::Local<Value>& object,
-			const gc::Local<gc::Array<Value>>& arguments,
+			const ValueLoc& object,
+			const ArgSpan& arguments,
 			AdapterTags<>,
 			LArgs... values)
 		{
@@ -224,13 +230,13 @@ namespace syn_script {
 		R adapter__convert_arguments_recursively(
 			const ADAPTER* adapter,
 			const gc::Local<ExecContext>& context,
-			const gc::Local<Value>& object,
-			const gc::Local<gc::Array<Value>>& arguments,
+			const ValueLoc& object,
+			const ArgSpan& arguments,
 			AdapterTags<MArg, RArgs...>,
 			LArgs... values)
 		{
 			std::size_t idx = sizeof...(LArgs);
-			gc::Local<Value> argument = arguments->get(idx);
+			ValueLoc argument = arguments.get(idx);
 			assert(!!argument);
 
 			return adapter__convert_arguments_recursively<R>(
@@ -244,11 +250,11 @@ namespace syn_script {
 		}
 
 		template<class R, class... Args, class ADAPTER>
-		gc::Local<Value> adapter__invoke_method(
+		ValueLoc adapter__invoke_method(
 			const ADAPTER* adapter,
 			const gc::Local<ExecContext>& context,
-			const gc::Local<Value>& object,
-			const gc::Local<gc::Array<Value>>& arguments)
+			const ValueLoc& object,
+			const ArgSpan& arguments)
 		{
 			return AdapterGenericResult<R>::adapt(context, [=]() -> R {
 				return adapter__convert_arguments_recursively<R>(
@@ -278,7 +284,7 @@ public:
 		m_class_initializer = class_initializer;
 	}
 
-	gc::Local<Value> get(const gc::Local<ExecContext>& context) const override {
+	ValueLoc get(const gc::Local<ExecContext>& context) const override {
 		std::size_t class_id = m_class_initializer->get_class_id();
 		gc::Local<SysClass> cls = context->get_value_factory()->get_sys_class(class_id);
 		return cls->get_class_value();
@@ -292,7 +298,7 @@ public:
 class syn_script::rt::ValueStaticFieldAdapter : public StaticFieldAdapter {
 	NONCOPYABLE(ValueStaticFieldAdapter);
 
-	gc::Ref<Value> m_value;
+	ValueRef m_value;
 
 public:
 	ValueStaticFieldAdapter(){}
@@ -301,11 +307,11 @@ public:
 		gc_ref(m_value);
 	}
 
-	void initialize(const gc::Local<Value>& value) {
+	void initialize(const ValueLoc& value) {
 		m_value = value;
 	}
 
-	gc::Local<Value> get(const gc::Local<ExecContext>& context) const override {
+	ValueLoc get(const gc::Local<ExecContext>& context) const override {
 		return m_value;
 	}
 };
@@ -331,12 +337,12 @@ public:
 
 	inline R get_0(
 		const gc::Local<ExecContext>& context,
-		const gc::Local<Value>& object) const
+		const ValueLoc& object) const
 	{
 		return m_fn(context);
 	}
 
-	gc::Local<Value> get(const gc::Local<ExecContext>& context) const override {
+	ValueLoc get(const gc::Local<ExecContext>& context) const override {
 		return adapter__get_field<R>(this, context, nullptr);
 	}
 };
@@ -360,17 +366,17 @@ public:
 		m_fn = fn;
 	}
 
-	inline R invoke_0(const gc::Local<ExecContext>& context, const gc::Local<Value>& object, Args... args) const {
+	inline R invoke_0(const gc::Local<ExecContext>& context, const ValueLoc& object, Args... args) const {
 		return m_fn(context, args...);
 	}
 
-	bool accepts_arguments(const gc::Local<gc::Array<Value>>& arguments) const override {
-		return adapter__check_arguments<Args...>(arguments);
+	std::size_t get_arity() const override {
+		return sizeof...(Args);
 	}
 
-	gc::Local<Value> invoke(
+	ValueLoc invoke(
 		const gc::Local<ExecContext>& context,
-		const gc::Local<gc::Array<Value>>& arguments) const override
+		const ArgSpan& arguments) const override
 	{
 		return adapter__invoke_method<R, Args...>(this, context, nullptr, arguments);
 	}
@@ -397,15 +403,15 @@ public:
 
 	inline R get_0(
 		const gc::Local<ExecContext>& context,
-		const gc::Local<Value>& object) const
+		const ValueLoc& object) const
 	{
 		T* concrete_object = object.cast<T>().get();
 		return (concrete_object->*m_fn)(context);
 	}
 
-	gc::Local<Value> get(
+	ValueLoc get(
 		const gc::Local<ExecContext>& context,
-		const gc::Local<Value>& object) const override
+		const ValueLoc& object) const override
 	{
 		return adapter__get_field<R>(this, context, object);
 	}
@@ -430,19 +436,19 @@ public:
 		m_fn = fn;
 	}
 
-	inline R invoke_0(const gc::Local<ExecContext>& context, const gc::Local<Value>& object, Args... args) const {
+	inline R invoke_0(const gc::Local<ExecContext>& context, const ValueLoc& object, Args... args) const {
 		T* concrete_object = object.cast<T>().get();
 		return (concrete_object->*m_fn)(context, args...);
 	}
 
-	bool accepts_arguments(const gc::Local<gc::Array<Value>>& arguments) const override {
-		return adapter__check_arguments<Args...>(arguments);
+	std::size_t get_arity() const override {
+		return sizeof...(Args);
 	}
 
-	gc::Local<Value> invoke(
+	ValueLoc invoke(
 		const gc::Local<ExecContext>& context,
-		const gc::Local<Value>& object,
-		const gc::Local<gc::Array<Value>>& arguments) const override
+		const ValueLoc& object,
+		const ArgSpan& arguments) const override
 	{
 		return adapter__invoke_method<R, Args...>(this, context, object, arguments);
 	}
@@ -467,7 +473,7 @@ void syn_script::rt::SysClassBuilder<T>::add_constructor(
 }
 
 template<class T>
-void syn_script::rt::SysClassBuilder<T>::add_static_field(const char* name, const gc::Local<Value>& value) {
+void syn_script::rt::SysClassBuilder<T>::add_static_field(const char* name, const ValueLoc& value) {
 	add_static_field_0(name, gc::create<ValueStaticFieldAdapter>(value));
 }
 
@@ -521,16 +527,19 @@ protected:
 	rt::SysClassBuilder<T>* bld;
 
 protected:
-	SysAPI(){}
+	SysAPI() : bld(nullptr){}
 
 	virtual void init() = 0;
 
 public:
 	gc::Local<SysClass> create_sys_class(NameRegistry& name_registry) override {
+		//This adapter is shared by all script threads, which create their classes concurrently, so the builder
+		//is given to a separate API object.
+		typename T::API api;
+		SysAPI<T>& local_api = api;
 		SysClassBuilder<T> local_bld(name_registry);
-		bld = &local_bld;
-		init();
-		bld = nullptr;
+		local_api.bld = &local_bld;
+		local_api.init();
 		return local_bld.create_sys_class();
 	}
 
@@ -35,21 +35,34 @@ namespace rt = ss::rt;
 
 rt::SysObjectValue::SysObjectValue(){}
 
-gc::Local<rt::Value> rt::SysObjectValue::get_member(
+rt::ValueLoc rt::SysObjectValue::get_member(
 	const gc::Local<ExecContext>& context,
 	const gc::Local<ExecScope>& scope,
-	const gc::Local<const ss::NameInfo>& name_info)
+	const gc::Local<const ss::NameInfo>& name_info,
+	MemberCache& cache)
 {
 	gc::Local<SysClass> cls = get_sys_class(context);
-	return cls->get_member(context, name_info, self(this));
+	return cls->get_member(context, name_info, self(this), cache);
+}
+
+rt::ValueLoc rt::SysObjectValue::invoke_member(
+	const gc::Local<ExecContext>& context,
+	const gc::Local<ExecScope>& scope,
+	const gc::Local<const ss::NameInfo>& name_info,
+	const ArgSpan& arguments,
+	MemberCache& cache,
+	ValueLoc& exception)
+{
+	gc::Local<SysClass> cls = get_sys_class(context);
+	return cls->invoke_member(context, name_info, self(this), arguments, cache, exception);
 }
 
 void rt::SysObjectValue::check_arguments(
-	const gc::Local<gc::Array<rt::Value>>& arguments,
+	const rt::ArgSpan& arguments,
 	std::size_t min_count,
 	std::size_t max_count)
 {
-	std::size_t cnt = arguments->length();
+	std::size_t cnt = arguments.length();
 	if (cnt >= min_count && cnt <= max_count) return;
 
 	std::ostringstream sout;
@@ -61,7 +74,7 @@ void rt::SysObjectValue::check_arguments(
 }
 
 void rt::SysObjectValue::check_arguments(
-	const gc::Local<gc::Array<rt::Value>>& arguments,
+	const rt::ArgSpan& arguments,
 	std::size_t min_count)
 {
 	check_arguments(arguments, min_count, min_count);
@@ -89,18 +102,30 @@ void rt::SysClassValue::initialize(const gc::Local<SysClass>& sys_class) {
 	m_sys_class = sys_class;
 }
 
-gc::Local<rt::Value> rt::SysClassValue::get_member(
+rt::ValueLoc rt::SysClassValue::get_member(
+	const gc::Local<ExecContext>& context,
+	const gc::Local<ExecScope>& scope,
+	const gc::Local<const ss::NameInfo>& name_info,
+	MemberCache& cache)
+{
+	return m_sys_class->get_member_static(context, name_info, cache);
+}
+
+rt::ValueLoc rt::SysClassValue::invoke_member(
 	const gc::Local<ExecContext>& context,
 	const gc::Local<ExecScope>& scope,
-	const gc::Local<const ss::NameInfo>& name_info)
+	const gc::Local<const ss::NameInfo>& name_info,
+	const ArgSpan& arguments,
+	MemberCache& cache,
+	ValueLoc& exception)
 {
-	return m_sys_class->get_member_static(context, name_info);
+	return m_sys_class->invoke_member_static(context, name_info, arguments, cache, exception);
 }
 
-gc::Local<rt::Value> rt::SysClassValue::instantiate(
+rt::ValueLoc rt::SysClassValue::instantiate(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<gc::Array<Value>>& arguments,
-	gc::Local<Value>& exception)
+	const ArgSpan& arguments,
+	ValueLoc& exception)
 {
 	return m_sys_class->instantiate(context, arguments);
 }
@@ -119,10 +144,22 @@ void rt::SysNamespaceValue::initialize(const gc::Local<SysClass>& sys_class) {
 	m_sys_class = sys_class;
 }
 
-gc::Local<rt::Value> rt::SysNamespaceValue::get_member(
+rt::ValueLoc rt::SysNamespaceValue::get_member(
+	const gc::Local<ExecContext>& context,
+	const gc::Local<ExecScope>& scope,
+	const gc::Local<const ss::NameInfo>& name_info,
+	MemberCache& cache)
+{
+	return m_sys_class->get_member_static(context, name_info, cache);
+}
+
+rt::ValueLoc rt::SysNamespaceValue::invoke_member(
 	const gc::Local<ExecContext>& context,
 	const gc::Local<ExecScope>& scope,
-	const gc::Local<const ss::NameInfo>& name_info)
+	const gc::Local<const ss::NameInfo>& name_info,
+	const ArgSpan& arguments,
+	MemberCache& cache,
+	ValueLoc& exception)
 {
-	return m_sys_class->get_member_static(context, name_info);
+	return m_sys_class->invoke_member_static(context, name_info, arguments, cache, exception);
 }
@@ -45,18 +45,27 @@ protected:
 	SysObjectValue();
 
 public:
-	gc::Local<Value> get_member(
+	ValueLoc get_member(
 		const gc::Local<ExecContext>& context,
 		const gc::Local<ExecScope>& scope,
-		const gc::Local<const NameInfo>& name_info) override final;
+		const gc::Local<const NameInfo>& name_info,
+		MemberCache& cache) override final;
+
+	ValueLoc invoke_member(
+		const gc::Local<ExecContext>& context,
+		const gc::Local<ExecScope>& scope,
+		const gc::Local<const NameInfo>& name_info,
+		const ArgSpan& arguments,
+		MemberCache& cache,
+		ValueLoc& exception) override final;
 
 	static void check_arguments(
-		const gc::Local<gc::Array<rt::Value>>& arguments,
+		const rt::ArgSpan& arguments,
 		std::size_t min_count,
 		std::size_t max_count);
 
 	static void check_arguments(
-		const gc::Local<gc::Array<rt::Value>>& arguments,
+		const rt::ArgSpan& arguments,
 		std::size_t min_count);
 
 protected:
@@ -81,15 +90,24 @@ public:
 	void gc_enumerate_refs() override;
 	void initialize(const gc::Local<SysClass>& sys_class);
 
-	gc::Local<Value> get_member(
+	ValueLoc get_member(
 		const gc::Local<ExecContext>& context,
 		const gc::Local<ExecScope>& scope,
-		const gc::Local<const NameInfo>& name_info) override;
+		const gc::Local<const NameInfo>& name_info,
+		MemberCache& cache) override;
 
-	gc::Local<Value> instantiate(
+	ValueLoc invoke_member(
 		const gc::Local<ExecContext>& context,
-		const gc::Local<gc::Array<Value>>& arguments,
-		gc::Local<Value>& exception) override;
+		const gc::Local<ExecScope>& scope,
+		const gc::Local<const NameInfo>& name_info,
+		const ArgSpan& arguments,
+		MemberCache& cache,
+		ValueLoc& exception) override;
+
+	ValueLoc instantiate(
+		const gc::Local<ExecContext>& context,
+		const ArgSpan& arguments,
+		ValueLoc& exception) override;
 };
 
 //
@@ -110,10 +128,19 @@ public:
 	void gc_enumerate_refs() override;
 	void initialize(const gc::Local<SysClass>& sys_class);
 
-	gc::Local<Value> get_member(
+	ValueLoc get_member(
+		const gc::Local<ExecContext>& context,
+		const gc::Local<ExecScope>& scope,
+		const gc::Local<const NameInfo>& name_info,
+		MemberCache& cache) override;
+
+	ValueLoc invoke_member(
 		const gc::Local<ExecContext>& context,
 		const gc::Local<ExecScope>& scope,
-		const gc::Local<const NameInfo>& name_info) override;
+		const gc::Local<const NameInfo>& name_info,
+		const ArgSpan& arguments,
+		MemberCache& cache,
+		ValueLoc& exception) override;
 };
 
 #endif//SYNSAMPLE_CORE_SYSVALUE_H_INCLUDED
@@ -30,6 +30,7 @@
 #include "sysclassbld.h"
 #include "value.h"
 #include "value_core.h"
+#include "value_util.h"
 
 namespace ss = syn_script;
 namespace rt = ss::rt;
@@ -37,7 +38,7 @@ namespace gc = ss::gc;
 namespace ast = ss::ast;
 
 namespace {
-	gc::Local<rt::Value> create_char_string(char c) {
+	rt::ValueLoc create_char_string(char c) {
 		ss::StringLoc str = gc::create<ss::String>(&c, 1);
 		return gc::create<rt::StringValue>(str);
 	}
@@ -47,22 +48,6 @@ namespace {
 //Value
 //
 
-bool rt::Value::is_undefined() const {
-	return false;
-}
-
-bool rt::Value::is_void() const {
-	return false;
-}
-
-bool rt::Value::is_null() const {
-	return false;
-}
-
-bool rt::Value::get_boolean() const {
-	throw RuntimeError("Not a boolean value");
-}
-
 ss::ScriptIntegerType rt::Value::get_integer() const {
 	throw RuntimeError("Not an integer number");
 }
@@ -87,15 +72,16 @@ bool rt::Value::iterate(rt::InternalValueIterator& iterator) {
 	throw RuntimeError("Not a collection");
 }
 
-gc::Local<rt::Value> rt::Value::get_member(
+rt::ValueLoc rt::Value::get_member(
 	const gc::Local<ExecContext>& context,
 	const gc::Local<ExecScope>& scope,
-	const gc::Local<const ss::NameInfo>& name_info)
+	const gc::Local<const ss::NameInfo>& name_info,
+	MemberCache& cache)
 {
 	throw RuntimeError("Not an object");
 }
 
-gc::Local<rt::Value> rt::Value::get_array_element(const gc::Local<ExecContext>& context, std::size_t index) {
+rt::ValueLoc rt::Value::get_array_element(const gc::Local<ExecContext>& context, std::size_t index) {
 	throw RuntimeError("Not an array");
 }
 
@@ -103,33 +89,46 @@ void rt::Value::set_member(
 	const gc::Local<ExecContext>& context,
 	const gc::Local<ExecScope>& scope,
 	const gc::Local<const ss::NameInfo>& name_info,
-	const gc::Local<Value>& value)
+	const ValueLoc& value,
+	MemberCache& cache)
 {
-	get_member(context, scope, name_info);
+	get_member(context, scope, name_info, cache);
 	throw RuntimeError("Cannot modify a member");
 }
 
 void rt::Value::set_array_element(
 	const gc::Local<ExecContext>& context,
 	std::size_t index,
-	const gc::Local<Value>& value)
+	const ValueLoc& value)
 {
 	get_array_element(context, index);
 	throw RuntimeError("Cannot modify an element");
 }
 
-gc::Local<rt::Value> rt::Value::invoke(
+rt::ValueLoc rt::Value::invoke(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<gc::Array<Value>>& arguments,
-	gc::Local<rt::Value>& exception)
+	const ArgSpan& arguments,
+	rt::ValueLoc& exception)
 {
 	throw RuntimeError("Not a function");
 }
 
-gc::Local<rt::Value> rt::Value::instantiate(
+rt::ValueLoc rt::Value::invoke_member(
+	const gc::Local<ExecContext>& context,
+	const gc::Local<ExecScope>& scope,
+	const gc::Local<const ss::NameInfo>& name_info,
+	const ArgSpan& arguments,
+	MemberCache& cache,
+	rt::ValueLoc& exception)
+{
+	ValueLoc function = get_member(context, scope, name_info, cache);
+	return function->invoke(context, arguments, exception);
+}
+
+rt::ValueLoc rt::Value::instantiate(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<gc::Array<Value>>& arguments,
-	gc::Local<rt::Value>& exception)
+	const ArgSpan& arguments,
+	rt::ValueLoc& exception)
 {
 	throw RuntimeError("Not a class");
 }
@@ -138,7 +137,7 @@ ss::StringLoc rt::Value::typeof(const gc::Local<ExecContext>& context) const {
 	return gc::create<String>("unknown");
 }
 
-bool rt::Value::value_equals(const gc::Local<const Value>& value) const {
+bool rt::Value::value_equals(const ValueLoc& value) const {
 	throw RuntimeError("equals() is not supported");
 }
 
@@ -146,10 +145,14 @@ std::size_t rt::Value::value_hash_code() const {
 	throw RuntimeError("hash_code() is not supported");
 }
 
-int rt::Value::value_compare_to(const gc::Local<Value>& value) const {
+int rt::Value::value_compare_to(const ValueLoc& value) const {
 	throw RuntimeError("compare_to() is not supported");
 }
 
+rt::ValueLoc rt::Value::copy_value(ValueCopier& copier) {
+	throw RuntimeError("The value cannot be sent to another thread");
+}
+
 //
 //ReferenceValue
 //
@@ -158,59 +161,249 @@ rt::OperandType rt::ReferenceValue::get_operand_type() const {
 	return rt::OperandType::REFERENCE;
 }
 
+//
+//MemberCache
+//
+
+rt::MemberCache::MemberCache() : m_next(0){}
+
+void rt::MemberCache::gc_enumerate_refs() {
+	for (std::size_t i = 0; i < SIZE; ++i) gc_ref(m_classes[i]);
+	for (std::size_t i = 0; i < SIZE; ++i) gc_ref(m_members[i]);
+}
+
+void rt::MemberCache::put(const gc::Local<const gc::Object>& cls, const gc::Local<const gc::Object>& member) {
+	//When all the entries are used, the oldest one is replaced.
+	m_classes[m_next] = cls;
+	m_members[m_next] = member;
+	m_next = (m_next + 1) % SIZE;
+}
+
+//
+//ValueLoc
+//
+
+namespace {
+	ss::RuntimeError null_pointer_error() {
+		return ss::RuntimeError("Null pointer access");
+	}
+}
+
+ss::StringLoc rt::ValueLoc::get_string() const {
+	if (is_object()) return get()->get_string();
+	throw RuntimeError("Not a string");
+}
+
+ss::StringLoc rt::ValueLoc::to_string(const gc::Local<ExecContext>& context) const {
+	std::uintptr_t word = get_word();
+	if (gc::is_object_word(word)) return get()->to_string(context);
+
+	const ValueFactory* value_factory = context->get_value_factory();
+	if (ValueWord::is_integer(word)) return integer_to_string(context, ValueWord::decode_integer(word));
+	if (ValueWord::is_float(word)) return float_to_string(context, ValueWord::decode_float(word));
+	if (ValueWord::TRUE_VALUE == word) return value_factory->get_true_str();
+	if (ValueWord::FALSE_VALUE == word) return value_factory->get_false_str();
+	if (ValueWord::NULL_VALUE == word) return value_factory->get_null_str();
+	throw RuntimeError("Not supported");
+}
+
+rt::OperandType rt::ValueLoc::get_operand_type() const {
+	std::uintptr_t word = get_word();
+	if (gc::is_object_word(word)) return get()->get_operand_type();
+	if (ValueWord::is_integer(word)) return OperandType::INTEGER;
+	if (ValueWord::is_float(word)) return OperandType::FLOAT;
+	if (is_boolean()) return OperandType::BOOLEAN;
+	if (ValueWord::NULL_VALUE == word) return OperandType::REFERENCE;
+	throw RuntimeError("Invalid operand type");
+}
+
+bool rt::ValueLoc::iterate(InternalValueIterator& iterator) const {
+	if (is_object()) return get()->iterate(iterator);
+	if (is_null()) throw null_pointer_error();
+	throw RuntimeError("Not a collection");
+}
+
+rt::ValueLoc rt::ValueLoc::get_member(
+	const gc::Local<ExecContext>& context,
+	const gc::Local<ExecScope>& scope,
+	const gc::Local<const ss::NameInfo>& name_info,
+	MemberCache& cache) const
+{
+	if (is_object()) return get()->get_member(context, scope, name_info, cache);
+	if (is_null()) throw null_pointer_error();
+	throw RuntimeError("Not an object");
+}
+
+rt::ValueLoc rt::ValueLoc::get_array_element(const gc::Local<ExecContext>& context, std::size_t index) const {
+	if (is_object()) return get()->get_array_element(context, index);
+	if (is_null()) throw null_pointer_error();
+	throw RuntimeError("Not an array");
+}
+
+void rt::ValueLoc::set_member(
+	const gc::Local<ExecContext>& context,
+	const gc::Local<ExecScope>& scope,
+	const gc::Local<const ss::NameInfo>& name_info,
+	const ValueLoc& value,
+	MemberCache& cache) const
+{
+	if (is_object()) {
+		get()->set_member(context, scope, name_info, value, cache);
+	} else {
+		get_member(context, scope, name_info, cache);
+		throw RuntimeError("Cannot modify a member");
+	}
+}
+
+void rt::ValueLoc::set_array_element(
+	const gc::Local<ExecContext>& context,
+	std::size_t index,
+	const ValueLoc& value) const
+{
+	if (is_object()) {
+		get()->set_array_element(context, index, value);
+	} else {
+		get_array_element(context, index);
+		throw RuntimeError("Cannot modify an element");
+	}
+}
+
+rt::ValueLoc rt::ValueLoc::invoke(
+	const gc::Local<ExecContext>& context,
+	const ArgSpan& arguments,
+	ValueLoc& exception) const
+{
+	if (is_object()) return get()->invoke(context, arguments, exception);
+	if (is_null()) throw null_pointer_error();
+	throw RuntimeError("Not a function");
+}
+
+rt::ValueLoc rt::ValueLoc::invoke_member(
+	const gc::Local<ExecContext>& context,
+	const gc::Local<ExecScope>& scope,
+	const gc::Local<const ss::NameInfo>& name_info,
+	const ArgSpan& arguments,
+	MemberCache& cache,
+	ValueLoc& exception) const
+{
+	if (is_object()) return get()->invoke_member(context, scope, name_info, arguments, cache, exception);
+	if (is_null()) throw null_pointer_error();
+	throw RuntimeError("Not an object");
+}
+
+rt::ValueLoc rt::ValueLoc::instantiate(
+	const gc::Local<ExecContext>& context,
+	const ArgSpan& arguments,
+	ValueLoc& exception) const
+{
+	if (is_object()) return get()->instantiate(context, arguments, exception);
+	if (is_null()) throw null_pointer_error();
+	throw RuntimeError("Not a class");
+}
+
+ss::StringLoc rt::ValueLoc::typeof(const gc::Local<ExecContext>& context) const {
+	std::uintptr_t word = get_word();
+	if (gc::is_object_word(word)) return get()->typeof(context);
+	if (ValueWord::is_integer(word)) return gc::create<String>("integer");
+	if (ValueWord::is_float(word)) return gc::create<String>("float");
+	if (is_boolean()) return gc::create<String>("boolean");
+	if (ValueWord::NULL_VALUE == word) return gc::create<String>("null");
+	return gc::create<String>("unknown");
+}
+
+bool rt::ValueLoc::value_equals(const ValueLoc& value) const {
+	std::uintptr_t word = get_word();
+	if (gc::is_object_word(word)) return get()->value_equals(value);
+
+	//Integers are immediate whenever they fit, so an immediate integer is never equal to an IntegerValue.
+	if (ValueWord::is_integer(word) || is_boolean()) return word == value.get_word();
+	if (is_null()) throw null_pointer_error();
+	throw RuntimeError("equals() is not supported");
+}
+
+std::size_t rt::ValueLoc::value_hash_code() const {
+	std::uintptr_t word = get_word();
+	if (gc::is_object_word(word)) return get()->value_hash_code();
+	if (ValueWord::is_integer(word)) return scriptint_to_hashcode(ValueWord::decode_integer(word));
+	if (is_boolean()) return get_boolean();
+	if (is_null()) throw null_pointer_error();
+	throw RuntimeError("hash_code() is not supported");
+}
+
+int rt::ValueLoc::value_compare_to(const ValueLoc& value) const {
+	std::uintptr_t word = get_word();
+	if (gc::is_object_word(word)) return get()->value_compare_to(value);
+
+	if (ValueWord::is_integer(word)) {
+		if (!value.is_integer()) throw RuntimeError("wrong type");
+		return scriptint_sign(ValueWord::decode_integer(word) - value.get_integer());
+	} else if (ValueWord::is_float(word)) {
+		if (!value.is_float()) throw RuntimeError("wrong type");
+		ScriptFloatType a = ValueWord::decode_float(word);
+		ScriptFloatType b = value.get_float();
+		return a < b ? -1 : (a > b ? 1 : 0);
+	} else if (is_boolean()) {
+		if (!value.is_boolean()) throw RuntimeError("wrong type");
+		bool a = get_boolean();
+		bool b = value.get_boolean();
+		return a < b ? -1 : (a > b ? 1 : 0);
+	} else if (is_null()) {
+		throw null_pointer_error();
+	}
+	throw RuntimeError("compare_to() is not supported");
+}
+
+rt::ValueLoc rt::ValueLoc::copy_value(ValueCopier& copier) const {
+	//Immediate values are not shared.
+	if (is_object()) return get()->copy_value(copier);
+	return *this;
+}
+
+rt::OperandType rt::ValueLoc::object_operand_type() const {
+	return get()->get_operand_type();
+}
+
+ss::ScriptIntegerType rt::ValueLoc::get_integer_slow() const {
+	if (is_object()) return get()->get_integer();
+	throw RuntimeError("Not an integer number");
+}
+
+ss::ScriptFloatType rt::ValueLoc::get_float_slow() const {
+	if (is_object()) return get()->get_float();
+	throw RuntimeError("Not a floating-point number");
+}
+
+void rt::ValueLoc::throw_not_boolean() {
+	throw RuntimeError("Not a boolean value");
+}
+
 //
 //ValueFactory
 //
 
 rt::ValueFactory::ValueFactory(ss::NameRegistry& name_registry, const gc::Local<ss::StringArray>& arguments) {
-	m_undefined_value = gc::create<UndefinedValue>();
-	m_void_value = gc::create<VoidValue>();
-	m_null_value = gc::create<NullValue>();
-	m_false_value = gc::create<BooleanValue>(false);
-	m_true_value = gc::create<BooleanValue>(true);
-
 	m_empty_str = gc::create<String>("");
 	m_null_str = gc::create<String>("null");
 	m_false_str = gc::create<String>("false");
 	m_true_str = gc::create<String>("true");
 
 	m_arguments_value = create_arguments_value(arguments);
-	m_int_cache = create_int_cache();
-	m_float_cache = create_float_cache();;
 	m_char_str_cache = create_char_str_cache();
 
 	init_sys_classes(name_registry);
 }
 
-gc::Local<rt::Value> rt::ValueFactory::create_arguments_value(const gc::Local<ss::StringArray>& arguments) {
+rt::ValueLoc rt::ValueFactory::create_arguments_value(const gc::Local<ss::StringArray>& arguments) {
 	const std::size_t n = arguments->length();
 	gc::Local<ValueArray> array = ValueArray::create(n);
 	for (std::size_t i = 0; i < n; ++i) {
 		StringLoc arg = (*arguments)[i];
-		gc::Local<Value> arg_value = gc::create<StringValue>(arg);
+		ValueLoc arg_value = gc::create<StringValue>(arg);
 		(*array)[i] = arg_value;
 	}
 	return gc::create<ArrayValue>(array);
 }
 
-gc::Local<rt::ValueArray> rt::ValueFactory::create_int_cache() {
-	gc::Local<ValueArray> cache = gc::Array<Value>::create(INT_CACHE_MAX - INT_CACHE_MIN + 1);
-	for (int v = INT_CACHE_MIN; v <= INT_CACHE_MAX; ++v) {
-		ScriptIntegerType sv = int_to_scriptint_ex(v);
-		(*cache)[v - INT_CACHE_MIN] = gc::create<IntegerValue>(sv);
-	}
-	return cache;
-}
-
-gc::Local<rt::ValueArray> rt::ValueFactory::create_float_cache() {
-	gc::Local<ValueArray> cache = ValueArray::create(FLOAT_CACHE_MAX - FLOAT_CACHE_MIN + 1);
-	for (int v = FLOAT_CACHE_MIN; v <= FLOAT_CACHE_MAX; ++v) {
-		ScriptFloatType sv = v;
-		(*cache)[v - FLOAT_CACHE_MIN] = gc::create<FloatValue>(sv);
-	}
-	return cache;
-}
-
 gc::Local<rt::ValueArray> rt::ValueFactory::create_char_str_cache() {
 	gc::Local<ValueArray> cache = ValueArray::create(CHAR_CACHE_SIZE);
 	for (std::size_t v = 0; v < CHAR_CACHE_SIZE; ++v) {
@@ -240,51 +433,41 @@ void rt::ValueFactory::init_sys_classes(ss::NameRegistry& name_registry) {
 	}
 }
 
-gc::Local<rt::Value> rt::ValueFactory::get_arguments_value() const {
+rt::ValueLoc rt::ValueFactory::get_arguments_value() const {
 	return m_arguments_value;
 }
 
-gc::Local<rt::Value> rt::ValueFactory::get_undefined_value() const {
-	return m_undefined_value;
+rt::ValueLoc rt::ValueFactory::get_undefined_value() {
+	return ValueLoc::from_word(ValueWord::UNDEFINED_VALUE);
 }
 
-gc::Local<rt::Value> rt::ValueFactory::get_void_value() const {
-	return m_void_value;
+rt::ValueLoc rt::ValueFactory::get_void_value() {
+	return ValueLoc::from_word(ValueWord::VOID_VALUE);
 }
 
-gc::Local<rt::Value> rt::ValueFactory::get_null_value() const {
-	return m_null_value;
+rt::ValueLoc rt::ValueFactory::get_null_value() {
+	return ValueLoc::from_word(ValueWord::NULL_VALUE);
 }
 
-gc::Local<rt::Value> rt::ValueFactory::get_boolean_value(bool value) const {
-	return value ? m_true_value : m_false_value;
+rt::ValueLoc rt::ValueFactory::get_boolean_value(bool value) {
+	return ValueLoc::from_word(ValueWord::encode_boolean(value));
 }
 
-gc::Local<rt::Value> rt::ValueFactory::get_integer_value(ss::ScriptIntegerType value) const {
-	if (cmp_scriptint_int(value, INT_CACHE_MIN) >= 0 && cmp_scriptint_int(value, INT_CACHE_MAX) <= 0) {
-		int ivalue = scriptint_to_int(value);
-		int idx = ivalue - INT_CACHE_MIN;
-		return (*m_int_cache)[idx];
-	}
+rt::ValueLoc rt::ValueFactory::get_integer_value(ss::ScriptIntegerType value) {
+	if (ValueWord::fits_integer(value)) return ValueLoc::from_word(ValueWord::encode_integer(value));
 	return gc::create<IntegerValue>(value);
 }
 
-gc::Local<rt::Value> rt::ValueFactory::get_float_value(ss::ScriptFloatType value) const {
-	if (value >= FLOAT_CACHE_MIN && value <= FLOAT_CACHE_MAX) {
-		int ivalue = scriptfloat_to_int(value);
-		if (ivalue == value) {
-			int i = ivalue - FLOAT_CACHE_MIN;
-			return (*m_float_cache)[i];
-		}
-	}
+rt::ValueLoc rt::ValueFactory::get_float_value(ss::ScriptFloatType value) {
+	if (ValueWord::IMMEDIATE_FLOAT) return ValueLoc::from_word(ValueWord::encode_float(value));
 	return gc::create<FloatValue>(value);
 }
 
-gc::Local<rt::Value> rt::ValueFactory::get_string_value(const ss::StringLoc& value) const {
+rt::ValueLoc rt::ValueFactory::get_string_value(const ss::StringLoc& value) const {
 	return gc::create<StringValue>(value);
 }
 
-gc::Local<rt::Value> rt::ValueFactory::get_char_string_value(char c) const {
+rt::ValueLoc rt::ValueFactory::get_char_string_value(char c) const {
 	unsigned char uc = reinterpret_cast<unsigned char&>(c);
 	std::size_t v = uc;
 	if (v < CHAR_CACHE_SIZE) return (*m_char_str_cache)[v];
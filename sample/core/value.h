@@ -24,6 +24,7 @@
 #include "gc.h"
 #include "name__dec.h"
 #include "value__dec.h"
+#include "value_handle.h"
 #include "scope__dec.h"
 #include "stringex.h"
 #include "sysclass__dec.h"
@@ -35,7 +36,8 @@ namespace syn_script {
 		//Value
 		//
 
-		//Base class for a Script Language value.
+		//Base class for a Script Language value allocated on the heap. Immediate values (see ValueWord) have no
+		//object; ValueLoc implements their behavior and forwards the calls to the object otherwise.
 		class Value : public ObjectEx {
 			NONCOPYABLE(Value);
 
@@ -43,11 +45,6 @@ namespace syn_script {
 			Value(){}
 
 		public:
-			virtual bool is_undefined() const;
-			virtual bool is_void() const;
-			virtual bool is_null() const;
-
-			virtual bool get_boolean() const;
 			virtual ScriptIntegerType get_integer() const;
 			virtual ScriptFloatType get_float() const;
 			virtual StringLoc get_string() const;
@@ -57,39 +54,53 @@ namespace syn_script {
 
 			virtual bool iterate(InternalValueIterator& iterator);
 
-			virtual gc::Local<Value> get_member(
+			virtual ValueLoc get_member(
 				const gc::Local<ExecContext>& context,
 				const gc::Local<ExecScope>& scope,
-				const gc::Local<const NameInfo>& name_info);
+				const gc::Local<const NameInfo>& name_info,
+				MemberCache& cache);
 
-			virtual gc::Local<Value> get_array_element(const gc::Local<ExecContext>& context, std::size_t index);
+			virtual ValueLoc get_array_element(const gc::Local<ExecContext>& context, std::size_t index);
 
 			virtual void set_member(
 				const gc::Local<ExecContext>& context,
 				const gc::Local<ExecScope>& scope,
 				const gc::Local<const NameInfo>& name_info,
-				const gc::Local<Value>& value);
+				const ValueLoc& value,
+				MemberCache& cache);
 
 			virtual void set_array_element(
 				const gc::Local<ExecContext>& context,
 				std::size_t index,
-				const gc::Local<Value>& value);
+				const ValueLoc& value);
 
-			virtual gc::Local<Value> invoke(
+			virtual ValueLoc invoke(
 				const gc::Local<ExecContext>& context,
-				const gc::Local<gc::Array<Value>>& arguments,
-				gc::Local<Value>& exception);
+				const ArgSpan& arguments,
+				ValueLoc& exception);
 
-			virtual gc::Local<Value> instantiate(
+			virtual ValueLoc invoke_member(
 				const gc::Local<ExecContext>& context,
-				const gc::Local<gc::Array<Value>>& arguments,
-				gc::Local<Value>& exception);
+				const gc::Local<ExecScope>& scope,
+				const gc::Local<const NameInfo>& name_info,
+				const ArgSpan& arguments,
+				MemberCache& cache,
+				ValueLoc& exception);
+
+			virtual ValueLoc instantiate(
+				const gc::Local<ExecContext>& context,
+				const ArgSpan& arguments,
+				ValueLoc& exception);
 
 			virtual StringLoc typeof(const gc::Local<ExecContext>& context) const;
 
-			virtual bool value_equals(const gc::Local<const Value>& value) const;
+			virtual bool value_equals(const ValueLoc& value) const;
 			virtual std::size_t value_hash_code() const;
-			virtual int value_compare_to(const gc::Local<Value>& value) const;
+			virtual int value_compare_to(const ValueLoc& value) const;
+
+			//Returns a value which can be passed to another thread: a deep copy of a mutable value (nested values
+			//are copied by the copier), or this value, if it can be shared safely.
+			virtual ValueLoc copy_value(ValueCopier& copier);
 		};
 
 		//
@@ -116,8 +127,53 @@ namespace syn_script {
 			ValueModifier(){}
 
 		public:
-			virtual gc::Local<Value> modify_short(gc::Local<Value>& result) { return nullptr; }
-			virtual gc::Local<Value> modify(const gc::Local<Value>& value, gc::Local<Value>& result) = 0;
+			virtual ValueLoc modify_short(ValueLoc& result) { return nullptr; }
+			virtual ValueLoc modify(const ValueLoc& value, ValueLoc& result) = 0;
+		};
+
+		//
+		//ValueCopier
+		//
+
+		//Copies values sent to another thread (see Value::copy_value()).
+		class ValueCopier {
+			NONCOPYABLE(ValueCopier);
+
+		protected:
+			ValueCopier(){}
+
+		public:
+			virtual ValueLoc copy(const ValueLoc& value) = 0;
+		};
+
+		//
+		//MemberCache
+		//
+
+		//Inline cache of a member access site. Remembers how the member was resolved for the last few classes of
+		//receivers; both the class and the resolved member are defined by the value class which uses the cache.
+		class MemberCache : public gc::Object {
+			NONCOPYABLE(MemberCache);
+
+			static const std::size_t SIZE = 4;
+
+			gc::Ref<const gc::Object> m_classes[SIZE];
+			gc::Ref<const gc::Object> m_members[SIZE];
+			std::size_t m_next;
+
+		public:
+			MemberCache();
+			void gc_enumerate_refs() override;
+
+			//Returns the member cached for the class, or null.
+			const gc::Object* get(const gc::Object* cls) const {
+				for (std::size_t i = 0; i < SIZE; ++i) {
+					if (m_classes[i].get() == cls) return m_members[i].get();
+				}
+				return nullptr;
+			}
+
+			void put(const gc::Local<const gc::Object>& cls, const gc::Local<const gc::Object>& member);
 		};
 
 		//
@@ -130,7 +186,7 @@ namespace syn_script {
 		public:
 			InternalValueIterator(){}
 
-			virtual bool iterate(const gc::Local<Value>& value) = 0;
+			virtual bool iterate(const ValueLoc& value) = 0;
 		};
 
 		//
@@ -140,22 +196,10 @@ namespace syn_script {
 		class ValueFactory {
 			NONCOPYABLE(ValueFactory);
 
-			static const int INT_CACHE_MIN = -1024;
-			static const int INT_CACHE_MAX = 1024;
-			static const int FLOAT_CACHE_MIN = INT_CACHE_MIN;
-			static const int FLOAT_CACHE_MAX = INT_CACHE_MAX;
 			static const std::size_t CHAR_CACHE_SIZE = 256;
 
-			gc::Local<Value> m_undefined_value;
-			gc::Local<Value> m_void_value;
-			gc::Local<Value> m_null_value;
-			gc::Local<Value> m_false_value;
-			gc::Local<Value> m_true_value;
-
-			gc::Local<Value> m_arguments_value;
+			ValueLoc m_arguments_value;
 
-			gc::Local<ValueArray> m_int_cache;
-			gc::Local<ValueArray> m_float_cache;
 			gc::Local<ValueArray> m_char_str_cache;
 
 			StringLoc m_empty_str;
@@ -169,23 +213,21 @@ namespace syn_script {
 			ValueFactory(NameRegistry& name_registry, const gc::Local<StringArray>& arguments);
 
 		private:
-			static gc::Local<Value> create_arguments_value(const gc::Local<StringArray>& arguments);
-			static gc::Local<ValueArray> create_int_cache();
-			static gc::Local<ValueArray> create_float_cache();
+			static ValueLoc create_arguments_value(const gc::Local<StringArray>& arguments);
 			static gc::Local<ValueArray> create_char_str_cache();
 			void init_sys_classes(NameRegistry& name_registry);
 
 		public:
-			gc::Local<Value> get_arguments_value() const;
+			ValueLoc get_arguments_value() const;
 
-			gc::Local<Value> get_undefined_value() const;
-			gc::Local<Value> get_void_value() const;
-			gc::Local<Value> get_null_value() const;
-			gc::Local<Value> get_boolean_value(bool value) const;
-			gc::Local<Value> get_integer_value(ScriptIntegerType value) const;
-			gc::Local<Value> get_float_value(ScriptFloatType value) const;
-			gc::Local<Value> get_string_value(const StringLoc& value) const;
-			gc::Local<Value> get_char_string_value(char c) const;
+			static ValueLoc get_undefined_value();
+			static ValueLoc get_void_value();
+			static ValueLoc get_null_value();
+			static ValueLoc get_boolean_value(bool value);
+			static ValueLoc get_integer_value(ScriptIntegerType value);
+			static ValueLoc get_float_value(ScriptFloatType value);
+			ValueLoc get_string_value(const StringLoc& value) const;
+			ValueLoc get_char_string_value(char c) const;
 
 			StringLoc get_empty_str() const;
 			StringLoc get_null_str() const;
@@ -195,6 +237,26 @@ namespace syn_script {
 			gc::Local<SysClass> get_sys_class(std::size_t class_id) const;
 		};
 
+		//
+		//ValueLoc
+		//
+
+		Value* ValueLoc::get() const {
+			std::uintptr_t word = get_word();
+			if (!gc::is_object_word(word)) return nullptr;
+			return static_cast<Value*>(reinterpret_cast<gc::Object*>(word));
+		}
+
+		//
+		//ValueRef
+		//
+
+		Value* ValueRef::get() const {
+			std::uintptr_t word = get_word();
+			if (!gc::is_object_word(word)) return nullptr;
+			return static_cast<Value*>(reinterpret_cast<gc::Object*>(word));
+		}
+
 	}
 }
 
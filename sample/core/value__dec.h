@@ -25,11 +25,16 @@ namespace syn_script {
 	namespace rt {
 
 		class Value;
-		typedef gc::Array<Value> ValueArray;
+		class ValueLoc;
+		class ValueRef;
+		typedef gc::WordArray<ValueRef> ValueArray;
+		class ArgSpan;
 
 		class SystemFunctionValue;
 
 		class ValueModifier;
+		class ValueCopier;
+		class MemberCache;
 		class InternalValueIterator;
 		class ValueFactory;
 
@@ -16,8 +16,13 @@
 
 //Core value classes implementation.
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 #include <memory>
+#include <sstream>
 
 #include "api_basic.h"
 #include "api_io.h"
@@ -39,44 +44,6 @@ namespace rt = ss::rt;
 namespace gc = ss::gc;
 namespace ast = ss::ast;
 
-//
-//BooleanValue
-//
-
-rt::OperandType rt::BooleanValue::get_operand_type() const {
-	return OperandType::BOOLEAN;
-}
-
-bool rt::BooleanValue::get_boolean() const {
-	return get_value();
-}
-
-ss::StringLoc rt::BooleanValue::to_string(const gc::Local<ExecContext>& context) const {
-	const ValueFactory* value_factory = context->get_value_factory();
-	return get_value() ? value_factory->get_true_str() : value_factory->get_false_str();
-}
-
-ss::StringLoc rt::BooleanValue::typeof(const gc::Local<ExecContext>& context) const {
-	return gc::create<String>("boolean");
-}
-
-bool rt::BooleanValue::value_equals(const gc::Local<const Value>& value) const {
-	const BooleanValue* v = dynamic_cast<const BooleanValue*>(value.get());
-	return v && get_value() == v->get_value();
-}
-
-std::size_t rt::BooleanValue::value_hash_code() const {
-	return get_value();
-}
-
-int rt::BooleanValue::value_compare_to(const gc::Local<Value>& value) const {
-	const BooleanValue* v = dynamic_cast<const BooleanValue*>(value.get());
-	if (!v) throw RuntimeError("wrong type");
-	bool a = get_value();
-	bool b = v->get_value();
-	return a < b ? -1 : (a > b ? 1 : 0);
-}
-
 //
 //IntegerValue
 //
@@ -97,7 +64,7 @@ ss::StringLoc rt::IntegerValue::typeof(const gc::Local<ExecContext>& context) co
 	return gc::create<String>("integer");
 }
 
-bool rt::IntegerValue::value_equals(const gc::Local<const Value>& value) const {
+bool rt::IntegerValue::value_equals(const ValueLoc& value) const {
 	const IntegerValue* v = dynamic_cast<const IntegerValue*>(value.get());
 	return v && get_value() == v->get_value();
 }
@@ -107,14 +74,17 @@ std::size_t rt::IntegerValue::value_hash_code() const {
 	return hash;
 }
 
-int rt::IntegerValue::value_compare_to(const gc::Local<Value>& value) const {
-	const IntegerValue* v = dynamic_cast<const IntegerValue*>(value.get());
-	if (!v) throw RuntimeError("wrong type");
+int rt::IntegerValue::value_compare_to(const ValueLoc& value) const {
+	if (!value.is_integer()) throw RuntimeError("wrong type");
 	ScriptIntegerType a = get_value();
-	ScriptIntegerType b = v->get_value();
+	ScriptIntegerType b = value.get_integer();
 	return scriptint_sign(a - b);
 }
 
+rt::ValueLoc rt::IntegerValue::copy_value(ValueCopier& copier) {
+	return self(this);
+}
+
 //
 //FloatValue
 //
@@ -135,159 +105,278 @@ ss::StringLoc rt::FloatValue::typeof(const gc::Local<ExecContext>& context) cons
 	return gc::create<String>("float");
 }
 
-int rt::FloatValue::value_compare_to(const gc::Local<Value>& value) const {
-	const FloatValue* v = dynamic_cast<const FloatValue*>(value.get());
-	if (!v) throw RuntimeError("wrong type");
+int rt::FloatValue::value_compare_to(const ValueLoc& value) const {
+	if (!value.is_float()) throw RuntimeError("wrong type");
 	ScriptFloatType a = get_value();
-	ScriptFloatType b = v->get_value();
+	ScriptFloatType b = value.get_float();
 	return a < b ? -1 : (a > b ? 1 : 0);
 }
 
-//
-//UndefinedValue
-//
-
-bool rt::UndefinedValue::is_undefined() const {
-	return true;
+rt::ValueLoc rt::FloatValue::copy_value(ValueCopier& copier) {
+	return self(this);
 }
 
 //
-//VoidValue
+//ArrayValue::API
 //
 
-bool rt::VoidValue::is_void() const {
-	return true;
-}
+class rt::ArrayValue::API : public SysAPI<ArrayValue> {
+	void init() override {
+		bld->add_field("length", &ArrayValue::api_length);
+		bld->add_method("sort", &ArrayValue::api_sort);
+	}
+};
 
 //
-//NullValue
+//ArrayValue
 //
 
-bool rt::NullValue::is_null() const {
-	return true;
-}
+namespace {
+	//Null elements of packed arrays. The integer is the most negative one, which is stored in a generic
+	//array instead; the float is a signaling NaN, while stored NaNs are made quiet.
+	const ss::ScriptIntegerType NULL_INTEGER = static_cast<ss::ScriptIntegerType>(1) << 63;
+	const std::uint64_t NULL_FLOAT_BITS = 0x7FF4000000000001ull;
+
+	static_assert(sizeof(ss::ScriptFloatType) == sizeof(std::uint64_t), "Wrong sizeof");
+
+	//Floats are compared bitwise, since the null value is a NaN.
+	bool is_null_float(const ss::ScriptFloatType& v) {
+		std::uint64_t bits;
+		std::memcpy(&bits, &v, sizeof(bits));
+		return NULL_FLOAT_BITS == bits;
+	}
+
+	void set_null_float(ss::ScriptFloatType& v) {
+		std::memcpy(&v, &NULL_FLOAT_BITS, sizeof(v));
+	}
 
-ss::StringLoc rt::NullValue::to_string(const gc::Local<ExecContext>& context) const {
-	return context->get_value_factory()->get_null_str();
+	ss::ScriptFloatType quiet_float(ss::ScriptFloatType v) {
+		return v == v ? v : std::numeric_limits<ss::ScriptFloatType>::quiet_NaN();
+	}
 }
 
-bool rt::NullValue::iterate(InternalValueIterator& iterator) {
-	throw null_pointer_error();
+void rt::ArrayValue::gc_enumerate_refs() {
+	gc_ref(m_integers);
+	gc_ref(m_floats);
+	gc_ref(m_values);
 }
 
-gc::Local<rt::Value> rt::NullValue::get_member(
-	const gc::Local<ExecContext>& context,
-	const gc::Local<ExecScope>& scope,
-	const gc::Local<const ss::NameInfo>& name_info)
-{
-	throw null_pointer_error();
+void rt::ArrayValue::initialize(const gc::Local<ValueArray>& array) {
+	m_kind = ElementKind::GENERIC;
+	m_length = array->length();
+	m_values = array;
+
+#ifndef NDEBUG
+	for (std::size_t i = 0, n = array->length(); i < n; ++i) assert(!!(*array)[i]);
+#endif
 }
 
-gc::Local<rt::Value> rt::NullValue::get_array_element(const gc::Local<ExecContext>& context, std::size_t index) {
-	throw null_pointer_error();
+void rt::ArrayValue::initialize(std::size_t length) {
+	//A new array is filled with nulls; it remains packed if only numbers of one type are stored.
+	m_kind = ElementKind::INTEGER;
+	m_length = length;
+	m_integers = IntegerArray::create(length);
+	std::fill(m_integers->raw_array(), m_integers->raw_array(length), NULL_INTEGER);
 }
 
-gc::Local<rt::Value> rt::NullValue::invoke(
-	const gc::Local<ExecContext>& context,
-	const gc::Local<gc::Array<Value>>& arguments,
-	gc::Local<rt::Value>& exception)
-{
-	throw null_pointer_error();
+void rt::ArrayValue::initialize(const ValueRef* values, std::size_t length) {
+	m_kind = get_packed_kind(values, length);
+	m_length = length;
+
+	if (ElementKind::INTEGER == m_kind) {
+		m_integers = IntegerArray::create(length);
+		for (std::size_t i = 0; i < length; ++i) {
+			ValueLoc value(values[i]);
+			(*m_integers)[i] = value.is_null() ? NULL_INTEGER : value.get_integer();
+		}
+	} else if (ElementKind::FLOAT == m_kind) {
+		m_floats = FloatArray::create(length);
+		for (std::size_t i = 0; i < length; ++i) {
+			ValueLoc value(values[i]);
+			if (value.is_null()) {
+				set_null_float((*m_floats)[i]);
+			} else {
+				(*m_floats)[i] = quiet_float(value.get_float());
+			}
+		}
+	} else {
+		m_values = ValueArray::create(length);
+		for (std::size_t i = 0; i < length; ++i) (*m_values)[i] = values[i];
+	}
 }
 
-gc::Local<rt::Value> rt::NullValue::instantiate(
-	const gc::Local<ExecContext>& context,
-	const gc::Local<gc::Array<Value>>& arguments,
-	gc::Local<rt::Value>& exception)
-{
-	throw null_pointer_error();
+ss::StringLoc rt::ArrayValue::to_string(const gc::Local<ExecContext>& context) const {
+	if (ElementKind::GENERIC == m_kind) return array_to_string(context, m_values, 0, m_length);
+
+	std::ostringstream out;
+	out << "[";
+	const char* sep = "";
+	for (std::size_t i = 0; i < m_length; ++i) {
+		out << sep << get_element(i)->to_string(context);
+		sep = ", ";
+	}
+	out << "]";
+	return gc::create<String>(out.str());
 }
 
-ss::StringLoc rt::NullValue::typeof(const gc::Local<ExecContext>& context) const {
-	return gc::create<String>("null");
+bool rt::ArrayValue::iterate(InternalValueIterator& iterator) {
+	//The length does not change, but the element kind may be changed by the loop body.
+	for (std::size_t i = 0; i < m_length; ++i) {
+		if (!iterator.iterate(get_element(i))) return false;
+	}
+	return true;
 }
 
-bool rt::NullValue::value_equals(const gc::Local<const Value>& value) const {
-	throw null_pointer_error();
+rt::ValueLoc rt::ArrayValue::get_array_element(const gc::Local<ExecContext>& context, std::size_t index) {
+	check_index(index);
+	return get_element(index);
 }
 
-std::size_t rt::NullValue::value_hash_code() const {
-	throw null_pointer_error();
+void rt::ArrayValue::set_array_element(
+	const gc::Local<ExecContext>& context,
+	std::size_t index,
+	const ValueLoc& value)
+{
+	check_index(index);
+	if (ElementKind::GENERIC != m_kind && !set_packed_element(index, value)) convert_to_generic();
+	if (ElementKind::GENERIC == m_kind) (*m_values)[index] = value;
 }
 
-int rt::NullValue::value_compare_to(const gc::Local<Value>& value) const {
-	throw null_pointer_error();
+ss::StringLoc rt::ArrayValue::typeof(const gc::Local<ExecContext>& context) const {
+	return gc::create<String>("array");
 }
 
-ss::RuntimeError rt::NullValue::null_pointer_error() const {
-	return RuntimeError("Null pointer access");
+gc::Local<rt::ValueArray> rt::ArrayValue::get_array() {
+	convert_to_generic();
+	return m_values;
 }
 
-//
-//ArrayValue::API
-//
+rt::ValueLoc rt::ArrayValue::copy_value(ValueCopier& copier) {
+	if (ElementKind::GENERIC == m_kind) {
+		gc::Local<ValueArray> values = ValueArray::create(m_length);
+		for (std::size_t i = 0; i < m_length; ++i) (*values)[i] = copier.copy((*m_values)[i]);
+		return gc::create<ArrayValue>(values);
+	}
 
-class rt::ArrayValue::API : public SysAPI<ArrayValue> {
-	void init() override {
-		bld->add_field("length", &ArrayValue::api_length);
-		bld->add_method("sort", &ArrayValue::api_sort);
+	//Packed numbers are copied as they are.
+	gc::Local<ArrayValue> array = gc::create<ArrayValue>(m_length);
+	if (ElementKind::INTEGER == m_kind) {
+		std::copy(m_integers->raw_array(), m_integers->raw_array(m_length), array->m_integers->raw_array());
+	} else {
+		array->convert_to_float();
+		std::copy(m_floats->raw_array(), m_floats->raw_array(m_length), array->m_floats->raw_array());
+	}
+	return array;
+}
+
+rt::ArrayValue::ElementKind rt::ArrayValue::get_packed_kind(const ValueRef* values, std::size_t length) {
+	bool integers = false;
+	bool floats = false;
+	for (std::size_t i = 0; i < length; ++i) {
+		ValueLoc value(values[i]);
+		if (value.is_null()) continue;
+		if (value.is_integer() && NULL_INTEGER != value.get_integer()) {
+			integers = true;
+		} else if (value.is_float()) {
+			floats = true;
+		} else {
+			return ElementKind::GENERIC;
+		}
 	}
-};
 
-//
-//ArrayValue
-//
+	//Integers and floats are different types, so mixing them needs a generic array.
+	if (integers && floats) return ElementKind::GENERIC;
+	return floats ? ElementKind::FLOAT : ElementKind::INTEGER;
+}
 
-void rt::ArrayValue::gc_enumerate_refs() {
-	gc_ref(m_array);
+void rt::ArrayValue::check_index(std::size_t index) const {
+	if (index >= m_length) {
+		throw RuntimeError(std::string("Array index out of bounds: ") + std::to_string(index)
+			+ " >= " + std::to_string(m_length));
+	}
 }
 
-void rt::ArrayValue::initialize(const gc::Local<gc::Array<Value>>& array) {
-	m_array = array;
+rt::ValueLoc rt::ArrayValue::get_element(std::size_t index) const {
+	if (ElementKind::INTEGER == m_kind) {
+		ScriptIntegerType v = (*m_integers)[index];
+		if (NULL_INTEGER == v) return ValueFactory::get_null_value();
+		return ValueFactory::get_integer_value(v);
+	} else if (ElementKind::FLOAT == m_kind) {
+		const ScriptFloatType& v = (*m_floats)[index];
+		if (is_null_float(v)) return ValueFactory::get_null_value();
+		return ValueFactory::get_float_value(v);
+	}
+	return (*m_values)[index];
+}
+
+//Stores the value into a packed array. Returns false if the array has to be converted to a generic one.
+bool rt::ArrayValue::set_packed_element(std::size_t index, const ValueLoc& value) {
+	if (ElementKind::INTEGER == m_kind) {
+		if (value.is_null()) {
+			(*m_integers)[index] = NULL_INTEGER;
+			return true;
+		} else if (value.is_integer()) {
+			ScriptIntegerType v = value.get_integer();
+			if (NULL_INTEGER == v) return false;
+			(*m_integers)[index] = v;
+			return true;
+		} else if (!value.is_float() || has_non_null_elements()) {
+			return false;
+		}
 
-#ifndef NDEBUG
-	for (std::size_t i = 0, n = array->length(); i < n; ++i) assert(!!(*array)[i]);
-#endif
+		//An array of nulls becomes a float array when the first float is stored.
+		convert_to_float();
+	}
+
+	assert(ElementKind::FLOAT == m_kind);
+	if (value.is_null()) {
+		set_null_float((*m_floats)[index]);
+		return true;
+	} else if (value.is_float()) {
+		(*m_floats)[index] = quiet_float(value.get_float());
+		return true;
+	}
+	return false;
 }
 
-ss::StringLoc rt::ArrayValue::to_string(const gc::Local<ExecContext>& context) const {
-	return array_to_string(context, m_array, 0, m_array->length());
+bool rt::ArrayValue::has_non_null_elements() const {
+	assert(ElementKind::INTEGER == m_kind);
+	const ScriptIntegerType* values = m_integers->raw_array();
+	return std::find_if(values, values + m_length, [](ScriptIntegerType v){ return NULL_INTEGER != v; })
+		!= values + m_length;
 }
 
-bool rt::ArrayValue::iterate(InternalValueIterator& iterator) {
-	for (std::size_t i = 0, n = m_array->length(); i < n; ++i) {
-		if (!iterator.iterate(m_array->get(i))) return false;
+bool rt::ArrayValue::has_null_elements() const {
+	if (ElementKind::INTEGER == m_kind) {
+		const ScriptIntegerType* values = m_integers->raw_array();
+		return std::find(values, values + m_length, NULL_INTEGER) != values + m_length;
+	} else if (ElementKind::FLOAT == m_kind) {
+		const ScriptFloatType* values = m_floats->raw_array();
+		return std::find_if(values, values + m_length, is_null_float) != values + m_length;
 	}
-	return true;
+	return false;
 }
 
-gc::Local<rt::Value> rt::ArrayValue::get_array_element(const gc::Local<ExecContext>& context, std::size_t index) {
-	return get_element_ref(index);
-}
+void rt::ArrayValue::convert_to_float() {
+	assert(ElementKind::INTEGER == m_kind);
+	gc::Local<FloatArray> floats = FloatArray::create(m_length);
+	for (std::size_t i = 0; i < m_length; ++i) set_null_float((*floats)[i]);
 
-void rt::ArrayValue::set_array_element(
-	const gc::Local<ExecContext>& context,
-	std::size_t index,
-	const gc::Local<Value>& value)
-{
-	get_element_ref(index) = value;
+	m_floats = floats;
+	m_integers = nullptr;
+	m_kind = ElementKind::FLOAT;
 }
 
-ss::StringLoc rt::ArrayValue::typeof(const gc::Local<ExecContext>& context) const {
-	return gc::create<String>("array");
-}
+void rt::ArrayValue::convert_to_generic() {
+	if (ElementKind::GENERIC == m_kind) return;
 
-const gc::Ref<gc::Array<rt::Value>>& rt::ArrayValue::get_array() const {
-	return m_array;
-}
+	gc::Local<ValueArray> values = ValueArray::create(m_length);
+	for (std::size_t i = 0; i < m_length; ++i) (*values)[i] = get_element(i);
 
-gc::Ref<rt::Value>& rt::ArrayValue::get_element_ref(std::size_t index) {
-	std::size_t length = m_array->length();
-	if (index >= length) {
-		throw RuntimeError(std::string("Array index out of bounds: ") + std::to_string(index)
-			+ " >= " + std::to_string(length));
-	}
-	return m_array->get(index);
+	m_values = values;
+	m_integers = nullptr;
+	m_floats = nullptr;
+	m_kind = ElementKind::GENERIC;
 }
 
 std::size_t rt::ArrayValue::get_sys_class_id() const {
@@ -295,11 +384,23 @@ std::size_t rt::ArrayValue::get_sys_class_id() const {
 }
 
 ss::ScriptIntegerType rt::ArrayValue::api_length(const gc::Local<ExecContext>& context) {
-	return size_to_scriptint_ex(m_array->length());
+	return size_to_scriptint_ex(m_length);
 }
 
 void rt::ArrayValue::api_sort(const gc::Local<ExecContext>& context) {
-	array_sort(context, m_array, 0, m_array->length());
+	//Packed arrays without nulls are sorted directly; comparing a null throws an exception, so such arrays
+	//are sorted as generic ones.
+	if (ElementKind::INTEGER == m_kind && !has_null_elements()) {
+		ScriptIntegerType* values = m_integers->raw_array();
+		std::sort(values, values + m_length, [](ScriptIntegerType a, ScriptIntegerType b){
+			return scriptint_sign(a - b) < 0; });
+	} else if (ElementKind::FLOAT == m_kind && !has_null_elements()) {
+		ScriptFloatType* values = m_floats->raw_array();
+		std::sort(values, values + m_length);
+	} else {
+		convert_to_generic();
+		array_sort(context, m_values, 0, m_length);
+	}
 }
 
 //
@@ -319,10 +420,10 @@ void rt::FunctionValue::initialize(
 	m_expr = expr;
 }
 
-gc::Local<rt::Value> rt::FunctionValue::invoke(
+rt::ValueLoc rt::FunctionValue::invoke(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<gc::Array<Value>>& arguments,
-	gc::Local<rt::Value>& exception)
+	const ArgSpan& arguments,
+	rt::ValueLoc& exception)
 {
 	return m_expr->invoke(context, m_scope, arguments, exception);
 }
@@ -345,10 +446,10 @@ void rt::ClassValue::initialize(const gc::Local<ExecScope>& scope, const gc::Loc
 	m_expr = expr;
 }
 
-gc::Local<rt::Value> rt::ClassValue::instantiate(
+rt::ValueLoc rt::ClassValue::instantiate(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<gc::Array<Value>>& arguments,
-	gc::Local<rt::Value>& exception)
+	const ArgSpan& arguments,
+	rt::ValueLoc& exception)
 {
 	return m_expr->instantiate(context, m_scope, arguments, exception);
 }
@@ -375,21 +476,23 @@ void rt::ObjectValue::initialize(
 	m_scope = outer_scope->create_nested_scope(scope_descriptor, self(this));
 }
 
-gc::Local<rt::Value> rt::ObjectValue::get_member(
+rt::ValueLoc rt::ObjectValue::get_member(
 	const gc::Local<ExecContext>& context,
 	const gc::Local<ExecScope>& scope,
-	const gc::Local<const ss::NameInfo>& name_info)
+	const gc::Local<const ss::NameInfo>& name_info,
+	MemberCache& cache)
 {
-	return m_expr->get_object_member(m_scope, scope, name_info);
+	return m_expr->get_object_member(m_scope, scope, name_info, cache);
 }
 
 void rt::ObjectValue::set_member(
 	const gc::Local<ExecContext>& context,
 	const gc::Local<ExecScope>& scope,
 	const gc::Local<const ss::NameInfo>& name_info,
-	const gc::Local<Value>& value)
+	const ValueLoc& value,
+	MemberCache& cache)
 {
-	m_expr->set_object_member(m_scope, scope, name_info, value);
+	m_expr->set_object_member(m_scope, scope, name_info, value, cache);
 }
 
 ss::StringLoc rt::ObjectValue::typeof(const gc::Local<ExecContext>& context) const {
@@ -421,7 +524,7 @@ void rt::ExceptionValue::gc_enumerate_refs() {
 }
 
 void rt::ExceptionValue::initialize(
-	const gc::Local<Value>& value,
+	const ValueLoc& value,
 	const gc::Local<gc::Array<rt::StackTraceElement>>& stack_trace)
 {
 	m_value = value;
@@ -52,30 +52,11 @@ namespace syn_script {
 			const T& get_value() const { return m_value; }
 		};
 
-		//
-		//BooleanValue
-		//
-
-		class BooleanValue : public LiteralValue<bool> {
-			NONCOPYABLE(BooleanValue);
-
-		public:
-			BooleanValue(){}
-
-			OperandType get_operand_type() const override;
-			bool get_boolean() const override;
-			StringLoc to_string(const gc::Local<ExecContext>& context) const override;
-			StringLoc typeof(const gc::Local<ExecContext>& context) const override;
-
-			bool value_equals(const gc::Local<const Value>& value) const override;
-			std::size_t value_hash_code() const override;
-			int value_compare_to(const gc::Local<Value>& value) const override;
-		};
-
 		//
 		//IntegerValue
 		//
 
+		//Integer number which does not fit into an immediate value.
 		class IntegerValue : public LiteralValue<ScriptIntegerType> {
 			NONCOPYABLE(IntegerValue);
 
@@ -87,15 +68,17 @@ namespace syn_script {
 			StringLoc to_string(const gc::Local<ExecContext>& context) const override;
 			StringLoc typeof(const gc::Local<ExecContext>& context) const override;
 
-			bool value_equals(const gc::Local<const Value>& value) const override;
+			bool value_equals(const ValueLoc& value) const override;
 			std::size_t value_hash_code() const override;
-			int value_compare_to(const gc::Local<Value>& value) const override;
+			int value_compare_to(const ValueLoc& value) const override;
+			ValueLoc copy_value(ValueCopier& copier) override;
 		};
 
 		//
 		//FloatValue
 		//
 
+		//Floating-point number on platforms where it cannot be an immediate value.
 		class FloatValue : public LiteralValue<ScriptFloatType> {
 			NONCOPYABLE(FloatValue);
 
@@ -106,75 +89,8 @@ namespace syn_script {
 			ScriptFloatType get_float() const override;
 			StringLoc to_string(const gc::Local<ExecContext>& context) const override;
 			StringLoc typeof(const gc::Local<ExecContext>& context) const override;
-			int value_compare_to(const gc::Local<Value>& value) const override;
-		};
-
-		//
-		//UndefinedValue
-		//
-
-		class UndefinedValue : public Value {
-			NONCOPYABLE(UndefinedValue);
-
-		public:
-			UndefinedValue(){}
-
-			bool is_undefined() const override;
-		};
-
-		//
-		//VoidValue
-		//
-
-		class VoidValue : public Value {
-			NONCOPYABLE(VoidValue);
-
-		public:
-			VoidValue(){}
-
-			bool is_void() const override;
-		};
-
-		//
-		//NullValue
-		//
-
-		class NullValue : public ReferenceValue {
-			NONCOPYABLE(NullValue);
-
-		public:
-			NullValue(){}
-
-			bool is_null() const override;
-			StringLoc to_string(const gc::Local<ExecContext>& context) const override;
-
-			bool iterate(InternalValueIterator& iterator) override;
-
-			gc::Local<Value> get_member(
-				const gc::Local<ExecContext>& context,
-				const gc::Local<ExecScope>& scope,
-				const gc::Local<const NameInfo>& name_info) override;
-
-			gc::Local<Value> get_array_element(const gc::Local<ExecContext>& context, std::size_t index) override;
-
-			gc::Local<Value> invoke(
-				const gc::Local<ExecContext>& context,
-				const gc::Local<gc::Array<Value>>& arguments,
-				gc::Local<rt::Value>& exception) override;
-
-			gc::Local<Value> instantiate(
-				const gc::Local<ExecContext>& context,
-				const gc::Local<gc::Array<Value>>& arguments,
-				gc::Local<rt::Value>& exception) override;
-
-			StringLoc typeof(const gc::Local<ExecContext>& context) const override;
-
-			bool value_equals(const gc::Local<const Value>& value) const override;
-			std::size_t value_hash_code() const override;
-			int value_compare_to(const gc::Local<Value>& value) const override;
-
-		private:
-			RuntimeError null_pointer_error() const;
+			int value_compare_to(const ValueLoc& value) const override;
+			ValueLoc copy_value(ValueCopier& copier) override;
 		};
 
 		//
@@ -187,32 +103,61 @@ namespace syn_script {
 			friend class SysAPI<ArrayValue>;
 			class API;
 
-			gc::Ref<gc::Array<Value>> m_array;
+			typedef gc::PrimitiveArray<ScriptIntegerType> IntegerArray;
+			typedef gc::PrimitiveArray<ScriptFloatType> FloatArray;
+
+			//Representation of the elements. Packed arrays keep numbers unboxed, so the GC does not scan them;
+			//null is encoded by a reserved value. Storing any other value converts the array to a generic one.
+			enum class ElementKind {
+				INTEGER,
+				FLOAT,
+				GENERIC
+			};
+
+			ElementKind m_kind;
+			std::size_t m_length;
+			gc::Ref<IntegerArray> m_integers;
+			gc::Ref<FloatArray> m_floats;
+			gc::Ref<ValueArray> m_values;
 
 		public:
 			ArrayValue(){}
 			void gc_enumerate_refs() override;
-			void initialize(const gc::Local<gc::Array<Value>>& array);
+			void initialize(const gc::Local<ValueArray>& array);
+			void initialize(std::size_t length);
+			void initialize(const ValueRef* values, std::size_t length);
 
 			StringLoc to_string(const gc::Local<ExecContext>& context) const override;
 			bool iterate(InternalValueIterator& iterator) override;
 
-			gc::Local<Value> get_array_element(const gc::Local<ExecContext>& context, std::size_t index) override;
+			ValueLoc get_array_element(const gc::Local<ExecContext>& context, std::size_t index) override;
 
 			void set_array_element(
 				const gc::Local<ExecContext>& context,
 				std::size_t index,
-				const gc::Local<Value>& value) override;
+				const ValueLoc& value) override;
 
 			StringLoc typeof(const gc::Local<ExecContext>& context) const override;
 
-			const gc::Ref<gc::Array<Value>>& get_array() const;
+			//Returns the elements as a generic array. A packed array is converted, so the returned array remains
+			//shared with this value.
+			gc::Local<ValueArray> get_array();
+
+			ValueLoc copy_value(ValueCopier& copier) override;
 
 		protected:
 			std::size_t get_sys_class_id() const override;
 
 		private:
-			gc::Ref<Value>& get_element_ref(std::size_t index);
+			static ElementKind get_packed_kind(const ValueRef* values, std::size_t length);
+
+			void check_index(std::size_t index) const;
+			ValueLoc get_element(std::size_t index) const;
+			bool set_packed_element(std::size_t index, const ValueLoc& value);
+			bool has_non_null_elements() const;
+			bool has_null_elements() const;
+			void convert_to_float();
+			void convert_to_generic();
 
 			ScriptIntegerType api_length(const gc::Local<ExecContext>& context);
 			void api_sort(const gc::Local<ExecContext>& context);
@@ -235,10 +180,10 @@ namespace syn_script {
 
 			StringLoc typeof(const gc::Local<ExecContext>& context) const override;
 
-			gc::Local<Value> invoke(
+			ValueLoc invoke(
 				const gc::Local<ExecContext>& context,
-				const gc::Local<gc::Array<Value>>& arguments,
-				gc::Local<rt::Value>& exception) override;
+				const ArgSpan& arguments,
+				rt::ValueLoc& exception) override;
 		};
 
 		//
@@ -256,10 +201,10 @@ namespace syn_script {
 			void gc_enumerate_refs() override;
 			void initialize(const gc::Local<ExecScope>& scope, const gc::Local<ast::ClassExpression>& expr);
 
-			gc::Local<Value> instantiate(
+			ValueLoc instantiate(
 				const gc::Local<ExecContext>& context,
-				const gc::Local<gc::Array<Value>>& arguments,
-				gc::Local<rt::Value>& exception) override;
+				const ArgSpan& arguments,
+				rt::ValueLoc& exception) override;
 
 			StringLoc typeof(const gc::Local<ExecContext>& context) const override;
 		};
@@ -283,16 +228,18 @@ namespace syn_script {
 				const gc::Local<ExecScope>& outer_scope,
 				const gc::Local<ScopeDescriptor>& scope_descriptor);
 
-			gc::Local<Value> get_member(
+			ValueLoc get_member(
 				const gc::Local<ExecContext>& context,
 				const gc::Local<ExecScope>& scope,
-				const gc::Local<const NameInfo>& name_info) override;
+				const gc::Local<const NameInfo>& name_info,
+				MemberCache& cache) override;
 
 			void set_member(
 				const gc::Local<ExecContext>& context,
 				const gc::Local<ExecScope>& scope,
 				const gc::Local<const NameInfo>& name_info,
-				const gc::Local<Value>& value) override;
+				const ValueLoc& value,
+				MemberCache& cache) override;
 
 			StringLoc typeof(const gc::Local<ExecContext>& context) const override;
 
@@ -309,7 +256,7 @@ namespace syn_script {
 			friend class SysAPI<ExceptionValue>;
 			class API;
 
-			gc::Ref<Value> m_value;
+			ValueRef m_value;
 			gc::Ref<gc::Array<StackTraceElement>> m_stack_trace;
 
 		public:
@@ -317,7 +264,7 @@ namespace syn_script {
 			void gc_enumerate_refs() override;
 
 			void initialize(
-				const gc::Local<Value>& value,
+				const ValueLoc& value,
 				const gc::Local<gc::Array<StackTraceElement>>& stack_trace);
 
 			StringLoc to_string(const gc::Local<ExecContext>& context) const override;
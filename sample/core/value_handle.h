@@ -0,0 +1,380 @@
+/*
+ * Copyright 2014 Anton Karmanov
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//Value handles: references to Script Language values which encode primitive values in the reference word.
+
+#ifndef SYNSAMPLE_CORE_VALUE_HANDLE_H_INCLUDED
+#define SYNSAMPLE_CORE_VALUE_HANDLE_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "basetype.h"
+#include "gc.h"
+#include "name__dec.h"
+#include "scope__dec.h"
+#include "stringex__dec.h"
+#include "value__dec.h"
+
+namespace syn_script {
+	namespace rt {
+
+		//
+		//ValueWord
+		//
+
+		//Encoding of immediate values. An immediate value is stored in the reference word itself, so creating it
+		//does not allocate memory.
+		//
+		//64-bit: the top 16 bits of an object pointer are zero. Words with the top 16 bits set are integers with
+		//a 48-bit payload. Other words with a non-zero top part are floating-point numbers, biased by 2^48 (NaN is
+		//canonicalized, so a biased number never has all the top 16 bits set).
+		//
+		//32-bit: words with the lowest bit set are 31-bit integers. Floating-point numbers are not immediate.
+		//
+		//On both platforms undefined, void, null, false and true are small words with the lowest bits equal to 10.
+		//Integers out of the immediate range are allocated as IntegerValue, floating-point numbers on 32-bit
+		//platforms - as FloatValue.
+		class ValueWord {
+			ValueWord() = delete;
+
+		public:
+			static const std::uintptr_t EMPTY = 0x00;
+			static const std::uintptr_t UNDEFINED_VALUE = 0x02;
+			static const std::uintptr_t VOID_VALUE = 0x06;
+			static const std::uintptr_t NULL_VALUE = 0x0A;
+			static const std::uintptr_t FALSE_VALUE = 0x0E;
+			static const std::uintptr_t TRUE_VALUE = 0x12;
+
+#if UINTPTR_MAX > 0xFFFFFFFFu
+			static const bool IMMEDIATE_FLOAT = true;
+
+		private:
+			static const int INT_BITS = 48;
+			static const std::uintptr_t INT_TAG = static_cast<std::uintptr_t>(0xFFFF000000000000ull);
+			static const std::uintptr_t FLOAT_BIAS = static_cast<std::uintptr_t>(1ull << INT_BITS);
+			static const std::uint64_t CANONICAL_NAN = 0x7FF8000000000000ull;
+
+		public:
+			static bool is_integer(std::uintptr_t word) {
+				return (word & INT_TAG) == INT_TAG;
+			}
+
+			static bool is_float(std::uintptr_t word) {
+				std::uintptr_t tag = word & INT_TAG;
+				return tag && tag != INT_TAG;
+			}
+
+			static bool fits_integer(ScriptIntegerType v) {
+				return ((v + (1ull << (INT_BITS - 1))) >> INT_BITS) == 0;
+			}
+
+			static std::uintptr_t encode_integer(ScriptIntegerType v) {
+				return INT_TAG | static_cast<std::uintptr_t>(v & ~static_cast<ScriptIntegerType>(INT_TAG));
+			}
+
+			static ScriptIntegerType decode_integer(std::uintptr_t word) {
+				//Sign extension of the 48-bit payload.
+				return static_cast<ScriptIntegerType>(static_cast<std::int64_t>(word << 16) >> 16);
+			}
+
+			static std::uintptr_t encode_float(ScriptFloatType v) {
+				std::uint64_t bits;
+				std::memcpy(&bits, &v, sizeof(bits));
+				if (v != v) bits = CANONICAL_NAN;
+				return static_cast<std::uintptr_t>(bits) + FLOAT_BIAS;
+			}
+
+			static ScriptFloatType decode_float(std::uintptr_t word) {
+				std::uint64_t bits = word - FLOAT_BIAS;
+				ScriptFloatType v;
+				std::memcpy(&v, &bits, sizeof(v));
+				return v;
+			}
+#else
+			static const bool IMMEDIATE_FLOAT = false;
+
+			static bool is_integer(std::uintptr_t word) {
+				return !!(word & 1);
+			}
+
+			static bool is_float(std::uintptr_t word) {
+				return false;
+			}
+
+			static bool fits_integer(ScriptIntegerType v) {
+				return ((v + (1ull << 30)) >> 31) == 0;
+			}
+
+			static std::uintptr_t encode_integer(ScriptIntegerType v) {
+				return (static_cast<std::uintptr_t>(v) << 1) | 1;
+			}
+
+			static ScriptIntegerType decode_integer(std::uintptr_t word) {
+				return static_cast<ScriptIntegerType>(static_cast<std::int64_t>(static_cast<std::int32_t>(word) >> 1));
+			}
+
+			static std::uintptr_t encode_float(ScriptFloatType v) {
+				return EMPTY;
+			}
+
+			static ScriptFloatType decode_float(std::uintptr_t word) {
+				return 0;
+			}
+#endif
+
+			static std::uintptr_t encode_boolean(bool v) {
+				return v ? TRUE_VALUE : FALSE_VALUE;
+			}
+		};
+
+		//
+		//ValueLoc
+		//
+
+		//Local reference to a value. Value operations are invoked on the handle itself (the arrow operator returns
+		//the handle), since an immediate value has no object.
+		class ValueLoc : public gc::WordLocal {
+		public:
+			ValueLoc(){}
+			ValueLoc(std::nullptr_t){}
+			ValueLoc(const ValueLoc& value) : WordLocal(value){}
+			inline ValueLoc(const ValueRef& ref);
+			explicit ValueLoc(const gc::WordLocal& word) : WordLocal(word){}
+
+			template<class T> ValueLoc(const gc::Local<T>& local) : WordLocal(object_word(local.get())){}
+			template<class T> ValueLoc(const gc::Ref<T>& ref) : WordLocal(object_word(ref.get())){}
+
+			static ValueLoc from_word(std::uintptr_t word) {
+				ValueLoc value;
+				value.set_word(word);
+				return value;
+			}
+
+			template<class T> static std::uintptr_t object_word(T* object) {
+				static_assert(std::is_base_of<Value, typename std::remove_const<T>::type>::value, "Not a value");
+				const gc::Object* obj = object;
+				return reinterpret_cast<std::uintptr_t>(obj);
+			}
+
+			ValueLoc& operator=(std::nullptr_t) {
+				set_word(ValueWord::EMPTY);
+				return *this;
+			}
+
+			ValueLoc& operator=(const ValueLoc& value) {
+				set_word(value.get_word());
+				return *this;
+			}
+
+			inline ValueLoc& operator=(const ValueRef& ref);
+
+			template<class T> ValueLoc& operator=(const gc::Local<T>& local) {
+				set_word(object_word(local.get()));
+				return *this;
+			}
+
+			template<class T> ValueLoc& operator=(const gc::Ref<T>& ref) {
+				set_word(object_word(ref.get()));
+				return *this;
+			}
+
+			const ValueLoc* operator->() const { return this; }
+			bool operator!() const { return !get_word(); }
+			bool operator==(const ValueLoc& value) const { return get_word() == value.get_word(); }
+			bool operator!=(const ValueLoc& value) const { return get_word() != value.get_word(); }
+
+			//Returns the object, or null if the value is immediate.
+			inline Value* get() const;
+
+			bool is_undefined() const { return ValueWord::UNDEFINED_VALUE == get_word(); }
+			bool is_void() const { return ValueWord::VOID_VALUE == get_word(); }
+			bool is_null() const { return ValueWord::NULL_VALUE == get_word(); }
+
+			bool is_boolean() const {
+				std::uintptr_t word = get_word();
+				return ValueWord::TRUE_VALUE == word || ValueWord::FALSE_VALUE == word;
+			}
+
+			bool is_integer() const {
+				std::uintptr_t word = get_word();
+				return ValueWord::is_integer(word) || (is_object() && OperandType::INTEGER == object_operand_type());
+			}
+
+			bool is_float() const {
+				std::uintptr_t word = get_word();
+				return ValueWord::is_float(word) || (is_object() && OperandType::FLOAT == object_operand_type());
+			}
+
+			bool get_boolean() const {
+				std::uintptr_t word = get_word();
+				if (ValueWord::TRUE_VALUE == word) return true;
+				if (ValueWord::FALSE_VALUE != word) throw_not_boolean();
+				return false;
+			}
+
+			ScriptIntegerType get_integer() const {
+				std::uintptr_t word = get_word();
+				return ValueWord::is_integer(word) ? ValueWord::decode_integer(word) : get_integer_slow();
+			}
+
+			ScriptFloatType get_float() const {
+				std::uintptr_t word = get_word();
+				return ValueWord::is_float(word) ? ValueWord::decode_float(word) : get_float_slow();
+			}
+
+			StringLoc get_string() const;
+			StringLoc to_string(const gc::Local<ExecContext>& context) const;
+
+			OperandType get_operand_type() const;
+
+			bool iterate(InternalValueIterator& iterator) const;
+
+			ValueLoc get_member(
+				const gc::Local<ExecContext>& context,
+				const gc::Local<ExecScope>& scope,
+				const gc::Local<const NameInfo>& name_info,
+				MemberCache& cache) const;
+
+			ValueLoc get_array_element(const gc::Local<ExecContext>& context, std::size_t index) const;
+
+			void set_member(
+				const gc::Local<ExecContext>& context,
+				const gc::Local<ExecScope>& scope,
+				const gc::Local<const NameInfo>& name_info,
+				const ValueLoc& value,
+				MemberCache& cache) const;
+
+			void set_array_element(
+				const gc::Local<ExecContext>& context,
+				std::size_t index,
+				const ValueLoc& value) const;
+
+			ValueLoc invoke(
+				const gc::Local<ExecContext>& context,
+				const ArgSpan& arguments,
+				ValueLoc& exception) const;
+
+			ValueLoc invoke_member(
+				const gc::Local<ExecContext>& context,
+				const gc::Local<ExecScope>& scope,
+				const gc::Local<const NameInfo>& name_info,
+				const ArgSpan& arguments,
+				MemberCache& cache,
+				ValueLoc& exception) const;
+
+			ValueLoc instantiate(
+				const gc::Local<ExecContext>& context,
+				const ArgSpan& arguments,
+				ValueLoc& exception) const;
+
+			StringLoc typeof(const gc::Local<ExecContext>& context) const;
+
+			bool value_equals(const ValueLoc& value) const;
+			std::size_t value_hash_code() const;
+			int value_compare_to(const ValueLoc& value) const;
+
+			ValueLoc copy_value(ValueCopier& copier) const;
+
+		private:
+			OperandType object_operand_type() const;
+			ScriptIntegerType get_integer_slow() const;
+			ScriptFloatType get_float_slow() const;
+			[[noreturn]] static void throw_not_boolean();
+		};
+
+		//
+		//ValueRef
+		//
+
+		//Reference to a value from a GC object.
+		class ValueRef : public gc::WordRef {
+		public:
+			ValueRef(){}
+
+			ValueRef& operator=(std::nullptr_t) {
+				set_word(ValueWord::EMPTY);
+				return *this;
+			}
+
+			ValueRef& operator=(const ValueRef& ref) {
+				set_word(ref.get_word());
+				return *this;
+			}
+
+			ValueRef& operator=(const ValueLoc& value) {
+				set_word(value.get_word());
+				return *this;
+			}
+
+			template<class T> ValueRef& operator=(const gc::Local<T>& local) {
+				set_word(ValueLoc::object_word(local.get()));
+				return *this;
+			}
+
+			ValueLoc operator->() const { return ValueLoc(*this); }
+			bool operator!() const { return !get_word(); }
+
+			inline Value* get() const;
+
+			template<class P> gc::Local<P> cast() const { return ValueLoc(*this).cast<P>(); }
+			template<class P> gc::Local<P> cast_opt() const { return ValueLoc(*this).cast_opt<P>(); }
+		};
+
+		//
+		//ArgSpan
+		//
+
+		//Arguments of an invocation: a view of consecutive values owned by the caller, usually located on the value
+		//stack of the current thread. Must not be used after the invocation returns.
+		class ArgSpan {
+			const ValueRef* m_values;
+			std::size_t m_length;
+
+		public:
+			ArgSpan() : m_values(nullptr), m_length(0){}
+			ArgSpan(const ValueRef* values, std::size_t length) : m_values(values), m_length(length){}
+
+			std::size_t length() const { return m_length; }
+
+			ValueLoc get(std::size_t index) const {
+				assert(index < m_length);
+				return ValueLoc(m_values[index]);
+			}
+
+			const ValueRef* begin() const { return m_values; }
+			const ValueRef* end() const { return m_values + m_length; }
+		};
+
+		//
+		//ValueLoc
+		//
+
+		ValueLoc::ValueLoc(const ValueRef& ref) {
+			set_word(ref.get_word());
+		}
+
+		ValueLoc& ValueLoc::operator=(const ValueRef& ref) {
+			set_word(ref.get_word());
+			return *this;
+		}
+
+	}
+}
+
+#endif//SYNSAMPLE_CORE_VALUE_HANDLE_H_INCLUDED
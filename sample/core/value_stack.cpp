@@ -0,0 +1,111 @@
+/*
+ * Copyright 2014 Anton Karmanov
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//Value stack implementation.
+
+#include <algorithm>
+
+#include "common.h"
+#include "gc.h"
+#include "platform.h"
+#include "value_stack.h"
+
+namespace ss = syn_script;
+namespace gc = ss::gc;
+namespace rt = ss::rt;
+
+namespace {
+
+	//Minimum size of a value stack segment.
+	const std::size_t SEGMENT_SIZE = 4096;
+
+	PLATFORM__THREAD_LOCAL rt::ValueStackSegment* gt_segment = nullptr;
+	PLATFORM__THREAD_LOCAL std::size_t gt_top = 0;
+
+}
+
+//
+//ValueStackSegment
+//
+
+void rt::ValueStackSegment::gc_enumerate_refs() {
+	gc_ref(m_values);
+	gc_ref(m_next);
+}
+
+void rt::ValueStackSegment::initialize(std::size_t size) {
+	m_values = ValueArray::create(size);
+}
+
+std::size_t rt::ValueStackSegment::length() const {
+	return m_values->length();
+}
+
+rt::ValueRef* rt::ValueStackSegment::get_values(std::size_t ofs) const {
+	return m_values->raw_array(ofs);
+}
+
+rt::ValueStackSegment* rt::ValueStackSegment::get_next() const {
+	return m_next.get();
+}
+
+void rt::ValueStackSegment::set_next(const gc::Local<ValueStackSegment>& next) {
+	m_next = next;
+}
+
+//
+//ValueStackWindow
+//
+
+rt::ValueStackWindow::ValueStackWindow(std::size_t count)
+: m_saved_segment(gt_segment),
+m_saved_top(gt_top),
+m_count(count)
+{
+	ValueStackSegment* segment = m_saved_segment;
+	if (segment && m_saved_top + count <= segment->length()) {
+		m_values = segment->get_values(m_saved_top);
+		gt_top = m_saved_top + count;
+		return;
+	}
+
+	segment = !!segment ? segment->get_next() : nullptr;
+	if (!segment || segment->length() < count) {
+		//The first segment is kept alive by this window, the others - by the previous segment.
+		m_segment = gc::create<ValueStackSegment>(std::max(count, SEGMENT_SIZE));
+		if (m_saved_segment) m_saved_segment->set_next(m_segment);
+		segment = m_segment.get();
+	}
+
+	m_values = segment->get_values(0);
+	gt_segment = segment;
+	gt_top = count;
+}
+
+rt::ValueStackWindow::~ValueStackWindow() {
+	//Clear the values, so that they do not keep garbage reachable.
+	for (std::size_t i = 0; i < m_count; ++i) m_values[i] = nullptr;
+	gt_segment = m_saved_segment;
+	gt_top = m_saved_top;
+}
+
+rt::ValueRef* rt::ValueStackWindow::get_values() const {
+	return m_values;
+}
+
+rt::ArgSpan rt::ValueStackWindow::get_span() const {
+	return ArgSpan(m_values, m_count);
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2014 Anton Karmanov
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//Value stack: per-thread storage for bytecode registers and invocation arguments.
+
+#ifndef SYNSAMPLE_CORE_VALUE_STACK_H_INCLUDED
+#define SYNSAMPLE_CORE_VALUE_STACK_H_INCLUDED
+
+#include "common.h"
+#include "gc.h"
+#include "value__dec.h"
+#include "value_handle.h"
+
+namespace syn_script {
+	namespace rt {
+
+		//
+		//ValueStackSegment
+		//
+
+		class ValueStackSegment : public gc::Object {
+			NONCOPYABLE(ValueStackSegment);
+
+			gc::Ref<ValueArray> m_values;
+			gc::Ref<ValueStackSegment> m_next;
+
+		public:
+			ValueStackSegment(){}
+			void gc_enumerate_refs() override;
+			void initialize(std::size_t size);
+
+			std::size_t length() const;
+			ValueRef* get_values(std::size_t ofs) const;
+			ValueStackSegment* get_next() const;
+			void set_next(const gc::Local<ValueStackSegment>& next);
+		};
+
+		//
+		//ValueStackWindow
+		//
+
+		//A range of consecutive values allocated on the value stack of the current thread. Windows of nested
+		//executions are allocated contiguously in a segment (a GC array, so the values are roots); when a segment is
+		//full, the next one is used. Segments are linked to the first one and reused, so execution which repeatedly
+		//crosses a segment boundary does not allocate. Windows must be released in the reverse order of allocation.
+		class ValueStackWindow {
+			NONCOPYABLE(ValueStackWindow);
+
+			ValueStackSegment* const m_saved_segment;
+			const std::size_t m_saved_top;
+			const std::size_t m_count;
+			gc::Local<ValueStackSegment> m_segment;
+			ValueRef* m_values;
+
+		public:
+			explicit ValueStackWindow(std::size_t count);
+			~ValueStackWindow();
+
+			ValueRef* get_values() const;
+			ArgSpan get_span() const;
+		};
+
+	}
+}
+
+#endif//SYNSAMPLE_CORE_VALUE_STACK_H_INCLUDED
@@ -70,7 +70,7 @@ ss::StringLoc rt::float_to_string(
 
 ss::StringLoc rt::array_to_string(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<gc::Array<Value>>& array,
+	const gc::Local<ValueArray>& array,
 	std::size_t start,
 	std::size_t end)
 {
@@ -99,16 +99,16 @@ namespace {
 
 	class ArrayIterator : public std::iterator<
 		std::random_access_iterator_tag,
-		gc::Local<rt::Value>,
+		rt::ValueLoc,
 		std::ptrdiff_t,
-		gc::Ref<rt::Value>*,
-		gc::Ref<rt::Value>&>
+		rt::ValueRef*,
+		rt::ValueRef&>
 	{
-		gc::Array<rt::Value>* m_array;
+		rt::ValueArray* m_array;
 		std::size_t m_offset;
 
 	public:
-		ArrayIterator(gc::Array<rt::Value>* array, std::size_t offset)
+		ArrayIterator(rt::ValueArray* array, std::size_t offset)
 			: m_array(array), m_offset(offset)
 		{}
 
@@ -141,12 +141,12 @@ namespace {
 			return m_offset >= iter.m_offset;
 		}
 
-		gc::Ref<rt::Value>& operator*() const {
+		rt::ValueRef& operator*() const {
 			assert(m_offset < m_array->length());
 			return (*m_array)[m_offset];
 		}
 
-		gc::Ref<rt::Value>& operator[](std::size_t index) const {
+		rt::ValueRef& operator[](std::size_t index) const {
 			assert(index < m_array->length() - m_offset);
 			return (*m_array)[m_offset + index];
 		}
@@ -210,7 +210,7 @@ namespace {
 		return iter + n;
 	}
 
-	bool compare_values(const gc::Local<rt::Value>& a, const gc::Local<rt::Value>& b) {
+	bool compare_values(const rt::ValueLoc& a, const rt::ValueLoc& b) {
 		int d = a->value_compare_to(b);
 		return d < 0;
 	}
@@ -218,7 +218,7 @@ namespace {
 
 void rt::array_sort(
 	const gc::Local<ExecContext>& context,
-	const gc::Local<gc::Array<Value>>& array,
+	const gc::Local<ValueArray>& array,
 	std::size_t start,
 	std::size_t end)
 {
@@ -35,13 +35,13 @@ namespace syn_script {
 
 		StringLoc array_to_string(
 			const gc::Local<ExecContext>& context,
-			const gc::Local<gc::Array<Value>>& array,
+			const gc::Local<ValueArray>& array,
 			std::size_t start,
 			std::size_t end);
 
 		void array_sort(
 			const gc::Local<ExecContext>& context,
-			const gc::Local<gc::Array<Value>>& array,
+			const gc::Local<ValueArray>& array,
 			std::size_t start,
 			std::size_t end);
 
@@ -21,6 +21,9 @@
 // Requests sent by Firefox, IE, Opera and Safari seem to be 300-400 bytes long.
 const REQUEST_SIZE_LIMIT = 5000;
 
+// Time limit for receiving an HTTP request header, in milliseconds.
+const REQUEST_TIMEOUT = 10000;
+
 // Command line.
 const COMMAND_LINE = parse_command_line();
 
@@ -536,9 +539,9 @@ function parse_cookies(headers) {
     return cookies;
 }
 
-// Reads HTTP request from a socket and returns an HttpRequest object.
-function read_request(socket) {
-    var lines = read_request_lines(socket);
+// Parses HTTP request received from a socket and returns an HttpRequest object.
+function read_request(socket, text) {
+    var lines = read_request_lines(socket, text);
     var line_cnt = lines.length;
     if (line_cnt == 0) throw "Empty HTTP request";
 
@@ -585,12 +588,12 @@ function handle_error(socket, e) {
 }
 
 // Handles a single request.
-function process_connection(socket) {
-    // Read and parse the request. If an error occurs, the connection will be closed.
+function process_connection(socket, text) {
+    // Parse the request. If an error occurs, the connection will be closed.
     var req;
     var resp;
     try {
-        req = read_request(socket);
+        req = read_request(socket, text);
         log_request(socket, req);
         resp = req.get_response();
     } catch (e) {
@@ -610,22 +613,62 @@ function process_connection(socket) {
 
 var g_server_stopping = false;
 
+// Receives the request header of a connection in the event loop and processes the request when the header is
+// complete, so a client which sends its request slowly does not delay other clients.
+function receive_request(loop, socket) {
+    var buf = new sys.StringBuffer();
+    var line_empty = true;
+    var timeout = loop.set_timeout(REQUEST_TIMEOUT, () { socket.close(); });
+
+    loop.on_data(socket, (data) {
+        // The header ends with an empty line. If the connection is closed, the data received so far is used.
+        if (data != null) {
+            var text = data.to_string();
+            buf.append(text);
+
+            var complete = false;
+            var start = 0;
+            for (var pos = text.index_of('\n'); pos >= 0 && !complete; pos = text.index_of('\n', start)) {
+                complete = line_empty && is_blank_line(text, start, pos);
+                line_empty = true;
+                start = pos + 1;
+            }
+            line_empty = line_empty && is_blank_line(text, start, text.length());
+
+            if (!complete && buf.length() <= REQUEST_SIZE_LIMIT) return;
+        }
+
+        loop.cancel_timeout(timeout);
+        try {
+            if (buf.length() > REQUEST_SIZE_LIMIT) throw "Request header is too long";
+            process_connection(socket, buf.to_string());
+        } catch (e) {
+            log_error(e);
+        } finally {
+            socket.close();
+        }
+
+        if (g_server_stopping) loop.stop();
+    });
+}
+
+// Checks if the part of a line consists of CR characters only.
+function is_blank_line(text, start, end) {
+    for (var i = start; i < end; ++i) {
+        if (text.char_at(i) != '\r') return false;
+    }
+    return true;
+}
+
 // Accepts connections and processes requests.
 function listen() {
     const port = COMMAND_LINE.port;
     var ss = new sys.ServerSocket(port);
     try {
         log("Listening on port " + port);
-        while (!g_server_stopping) {
-            var s = ss.accept();
-            try {
-                process_connection(s);
-            } catch (e) {
-                log_error(e);
-            } finally {
-                s.close();
-            }
-        }
+        var loop = new sys.EventLoop();
+        loop.on_accept(ss, (s) { receive_request(loop, s); });
+        loop.run();
     } finally {
         ss.close();
     }
@@ -658,31 +701,21 @@ function parse_command_line() {
     })();
 }
 
-// Reads HTTP request header lines.
-function read_request_lines(socket) {
+// Splits the received HTTP request header into lines.
+function read_request_lines(socket, text) {
     var list = new sys.ArrayList();
-    var buf = new sys.StringBuffer();
     var size = 0;
     
-    for (;;) {
-        var k = socket.read_byte();
-        if (k == -1 || k == '\n') {
-            if (buf.length() == 0) break;
-            
-            var str = buf.to_string();
-            var len = str.length();
-            if (len > REQUEST_SIZE_LIMIT || REQUEST_SIZE_LIMIT - len < size) {
-                throw "Request header is too long";
-            }
-            
-            list.add(str);
-            size += len;
-            
-            if (k == -1) break;
-            buf.clear();
-        } else if (k != '\r') {
-            buf.append_char(k);
+    for (var str : text.get_lines()) {
+        if (str.length() == 0) break;
+        
+        var len = str.length();
+        if (len > REQUEST_SIZE_LIMIT || REQUEST_SIZE_LIMIT - len < size) {
+            throw "Request header is too long";
         }
+        
+        list.add(str);
+        size += len;
     }
     
     log_request_lines(socket, list);
@@ -25,40 +25,97 @@
 int sample_main(
 	const std::string& file_name,
 	const std::vector<std::string>& arguments,
-	std::size_t mem_limit_mb);
+	std::size_t mem_limit_mb,
+	std::size_t gc_threads,
+	std::size_t gc_pause_ms,
+	bool ast_mode);
 
 namespace {
 	int command_line_error() {
-		std::cerr << "Usage: script [-m MEMORY_LIMIT_MB] FILE (ARGUMENT)*\n";
+		std::cerr << "Usage: script [-m MEMORY_LIMIT_MB] [-gc GC_THREADS] [-p GC_PAUSE_MS] [-ast] FILE (ARGUMENT)*\n";
 		return 1;
 	}
 }
 
 int main(int argc, const char** argv) {
 	std::size_t mem_limit = 0;
+	std::size_t gc_threads = 0;
+	std::size_t gc_pause = 0;
+	bool ast_mode = false;
 
 	int argpos = 1;
 
-	if (argpos < argc && 0 == strcmp("-m", argv[argpos])) {
-		++argpos;
-		if (argpos == argc) return command_line_error();
+	for (;;) {
+		if (argpos < argc && 0 == strcmp("-m", argv[argpos])) {
+			//Maximum heap size in megabytes. The heap grows up to this size when needed.
+			++argpos;
+			if (argpos == argc) return command_line_error();
 
-		std::string limit_str = argv[argpos++];
+			std::string limit_str = argv[argpos++];
 
-		int v;
-		try {
-			v = std::stoi(limit_str);
-		} catch (std::logic_error&) {
-			std::cerr << "Invalid memory limit\n";
-			return 1;
-		}
-		
-		if (v < 1 || v > 2048) {
-			std::cerr << "Memory limit is out of range\n";
-			return 1;
-		}
+			int v;
+			try {
+				v = std::stoi(limit_str);
+			} catch (std::logic_error&) {
+				std::cerr << "Invalid memory limit\n";
+				return 1;
+			}
+			
+			if (v < 1 || v > 2048) {
+				std::cerr << "Memory limit is out of range\n";
+				return 1;
+			}
+
+			mem_limit = v;
+		} else if (argpos < argc && 0 == strcmp("-gc", argv[argpos])) {
+			//Number of threads performing garbage collection (0 - choose automatically).
+			++argpos;
+			if (argpos == argc) return command_line_error();
+
+			std::string threads_str = argv[argpos++];
+
+			int v;
+			try {
+				v = std::stoi(threads_str);
+			} catch (std::logic_error&) {
+				std::cerr << "Invalid number of GC threads\n";
+				return 1;
+			}
+
+			if (v < 0 || v > 64) {
+				std::cerr << "Number of GC threads is out of range\n";
+				return 1;
+			}
 
-		mem_limit = v;
+			gc_threads = v;
+		} else if (argpos < argc && 0 == strcmp("-p", argv[argpos])) {
+			//GC pause time target: enables incremental marking.
+			++argpos;
+			if (argpos == argc) return command_line_error();
+
+			std::string pause_str = argv[argpos++];
+
+			int v;
+			try {
+				v = std::stoi(pause_str);
+			} catch (std::logic_error&) {
+				std::cerr << "Invalid GC pause time\n";
+				return 1;
+			}
+
+			if (v < 1 || v > 1000) {
+				std::cerr << "GC pause time is out of range\n";
+				return 1;
+			}
+
+			gc_pause = v;
+		} else if (argpos < argc && 0 == strcmp("-ast", argv[argpos])) {
+			//Execute the AST directly, without compiling it to bytecode (reference mode).
+			++argpos;
+			ast_mode = true;
+		} else {
+			break;
+		}
 	}
 
 	if (argpos == argc) return command_line_error();
@@ -67,5 +124,5 @@ int main(int argc, const char** argv) {
 	std::vector<std::string> arguments;
 	while (argpos < argc) arguments.push_back(argv[argpos++]);
 
-	sample_main(file_name, arguments, mem_limit);
+	sample_main(file_name, arguments, mem_limit, gc_threads, gc_pause, ast_mode);
 }
@@ -804,6 +804,108 @@ var tests = [
 
 		file.delete();
 	},
+	{//BinaryInput.read_line(): CRLF, empty lines, no final LF, null at the end.
+		var file = new sys.File("testfile.txt");
+		if (file.exists()) file.delete();
+		assert(!file.exists());
+
+		file.write_text("first\r\nsecond\n\n\r\nthird\rx\nlast");
+
+		var in = file.binary_in();
+		try {
+			assertEq("first", in.read_line());
+			assertEq("second", in.read_line());
+			assertEq("", in.read_line());
+			assertEq("", in.read_line());
+			assertEq("third\rx", in.read_line());
+			assertEq("last", in.read_line());
+			assertEq(null, in.read_line());
+			assertEq(null, in.read_line());
+			assertEq(-1, in.read_byte());
+		} finally { in.close(); }
+
+		file.write_text("a\n");
+		in = file.binary_in();
+		try {
+			assertEq("a", in.read_line());
+			assertEq(null, in.read_line());
+		} finally { in.close(); }
+
+		file.write_text("");
+		in = file.binary_in();
+		try {
+			assertEq(null, in.read_line());
+		} finally { in.close(); }
+
+		file.delete();
+	},
+	{//BinaryInput.read_line(): lines longer than the buffer.
+		var file = new sys.File("testfile.txt");
+		if (file.exists()) file.delete();
+		assert(!file.exists());
+
+		var line = "";
+		for (var i = 0; i < 100; ++i) line += "" + (i % 10);
+		file.write_text(line + "\r\n" + line);
+
+		var in = file.binary_in();
+		try {
+			in.set_buffer_size(7);
+			assertEq(line, in.read_line());
+			assertEq(line, in.read_line());
+			assertEq(null, in.read_line());
+		} finally { in.close(); }
+
+		file.delete();
+	},
+	{//BinaryInput.set_buffer_size() keeps the bytes which have not been read yet.
+		var file = new sys.File("testfile.txt");
+		if (file.exists()) file.delete();
+		assert(!file.exists());
+
+		file.write_text("0123456789abcdef\nXYZ");
+
+		var in = file.binary_in();
+		try {
+			assertEq('0', in.read_byte());
+			in.set_buffer_size(2);
+			assertEq('1', in.read_byte());
+			assertEq('2', in.read_byte());
+			in.set_buffer_size(100);
+			var buffer = new sys.Bytes(5);
+			assertEq(5, in.read(buffer));
+			assertEq("34567", buffer.to_string());
+			in.set_buffer_size(1);
+			assertEq("89abcdef", in.read_line());
+			assertEq("XYZ", in.read_line());
+			assertEq(null, in.read_line());
+		} finally { in.close(); }
+
+		file.delete();
+	},
+	{//BinaryOutput.flush() writes the buffered bytes before the output is closed.
+		var file = new sys.File("testfile.txt");
+		if (file.exists()) file.delete();
+		assert(!file.exists());
+
+		var out = file.binary_out();
+		try {
+			out.write_byte('A');
+			out.write_byte('B');
+			out.flush();
+			assertEq("AB", file.read_text());
+
+			out.set_buffer_size(4);
+			var str = "CDEFGH";
+			for (var i = 0; i < str.length(); ++i) out.write_byte(str[i]);
+			out.flush();
+			assertEq("ABCDEFGH", file.read_text());
+			out.write_byte('I');
+		} finally { out.close(); }
+
+		assertEq("ABCDEFGHI", file.read_text());
+		file.delete();
+	},
 	{
 		var g_x = 5;
 
@@ -916,6 +1018,73 @@ var tests = [
 		values.sort();
 		assertEq("[1, 8, 13, 29, 91]", "" + values);
 	},
+	{//HashMap: keys and values are returned in insertion order.
+		var map = new sys.HashMap();
+		map.put("d", 29);
+		map.put("b", 13);
+		map.put(5, "five");
+		map.put("a", 1);
+		map.put("c", 8);
+		map.put("b", 14);
+		assertEq("[d, b, 5, a, c]", "" + map.keys());
+		assertEq("[29, 14, five, 1, 8]", "" + map.values());
+	},
+	{//HashMap: a removed key put again goes to the end.
+		var map = new sys.HashMap();
+		map.put("a", 1);
+		map.put("b", 2);
+		map.put("c", 3);
+		map.put("d", 4);
+		assertEq(2, map.remove("b"));
+		assertEq(null, map.remove("x"));
+		assertEq("[a, c, d]", "" + map.keys());
+		map.put("b", 20);
+		assertEq("[a, c, d, b]", "" + map.keys());
+		assertEq("[1, 3, 4, 20]", "" + map.values());
+		map.remove("a");
+		map.put("e", 5);
+		map.put("a", 10);
+		assertEq("[c, d, b, e, a]", "" + map.keys());
+		assertEq(10, map.get("a"));
+		assertEq(5, map.size());
+	},
+	{//HashMap: the order survives removals and rebuilding of the table.
+		var map = new sys.HashMap();
+		for (var i = 0; i < 1000; ++i) map.put(i, i);
+		for (var i = 0; i < 1000; ++i) {
+			if (i % 3 != 0) map.remove(i);
+		}
+		for (var i = 999; i >= 0; --i) {
+			if (i % 3 == 1) map.put(i, -i);
+		}
+		assertEq(334 + 333, map.size());
+
+		var keys = map.keys();
+		var values = map.values();
+		var k = 0;
+		for (var i = 0; i < 1000; i += 3) {
+			assertEq(i, keys[k]);
+			assertEq(i, values[k]);
+			++k;
+		}
+		for (var i = 999; i >= 0; --i) {
+			if (i % 3 == 1) {
+				assertEq(i, keys[k]);
+				assertEq(-i, values[k]);
+				++k;
+			}
+		}
+	},
+	{//HashSet: elements are returned in insertion order.
+		var set = new sys.HashSet();
+		set.add("x");
+		set.add("a");
+		set.add("m");
+		set.add("a");
+		set.remove("x");
+		set.add("x");
+		assertEq("[a, m, x]", "" + set.to_array());
+	},
 	{//sys.execute()
 		var scope = new sys.HashMap();
 		scope.put("x", 5);
@@ -989,6 +1158,74 @@ var tests = [
 			assertEq(i % 128, s[i]);
 		}
 	},
+	{//Ropes: += chain longer than 64 characters, random access.
+		function make_rope() {
+			var s = "";
+			for (var i = 0; i < 100; ++i) s += "0123456789".substring(i % 10, i % 10 + 1);
+			return s;
+		}
+
+		var flat = new sys.StringBuffer();
+		for (var i = 0; i < 100; ++i) flat.append_char('0' + i % 10);
+		var expected = flat.to_string();
+
+		var s = make_rope();
+		assertEq(100, s.length());
+		for (var i = 0; i < 100; ++i) assertEq('0' + i % 10, s.char_at(i));
+
+		assertEq("56789", make_rope().substring(95));
+		assertEq("8901234567", make_rope().substring(58, 68));
+		assertEq(expected, make_rope());
+		assertEq(true, make_rope() == expected);
+		assertEq(true, expected == make_rope());
+		assertEq(true, make_rope().equals(make_rope()));
+		assertEq(false, make_rope() == expected.substring(1));
+		assertEq(0, make_rope().compare_to(expected));
+	},
+	{//Ropes: nested concatenations of long strings.
+		var a = "abcdefghijklmnopqrstuvwxyz0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+		var b = a + a;
+		var c = b + "!" + b;
+		assertEq(4 * a.length() + 1, c.length());
+		assertEq("XYZ!abc", c.substring(2 * a.length() - 3, 2 * a.length() + 4));
+		assertEq('!', (b + "!" + b).char_at(2 * a.length()));
+		assertEq(c, a + a + "!" + a + a);
+		assertEq(true, c != a + a + "?" + a + a);
+	},
+	{//Ropes: hashing.
+		var key = "";
+		for (var i = 0; i < 30; ++i) key += "k" + i;
+
+		var map = new sys.HashMap();
+		map.put(key, 1);
+		var flat = new sys.StringBuffer();
+		for (var i = 0; i < 30; ++i) flat.append("k" + i);
+		assertEq(1, map.get(flat.to_string()));
+
+		var rope = "";
+		for (var i = 0; i < 30; ++i) rope += "k" + i;
+		assertEq(1, map.get(rope));
+		assertEq(null, map.get(rope + "x"));
+
+		var set = new sys.HashSet();
+		set.add(flat.to_string());
+		rope = "";
+		for (var i = 0; i < 30; ++i) rope += "k" + i;
+		assertEq(true, set.contains(rope));
+	},
+	{//Ropes: StringBuffer.append() of a rope.
+		var s = "";
+		for (var i = 0; i < 40; ++i) s += "<" + i + ">";
+		var buf = new sys.StringBuffer();
+		buf.append("[");
+		buf.append(s);
+		buf.append("]");
+		var t = buf.to_string();
+		assertEq(s.length() + 2, t.length());
+		assertEq("[<0><1><2>", t.substring(0, 10));
+		assertEq("<38><39>]", t.substring(t.length() - 9));
+		assertEq("[" + s + "]", t);
+	},
 	{
 		var list = new sys.ArrayList();
 		assertEq(true, list.is_empty());
@@ -1141,6 +1378,103 @@ var tests = [
 		array.sort();
 		assertEq("[0, 1, 2, 3, 4, 5, 6, 7, 8]", "" + array);
 	},
+	{//Packed arrays: an array of nulls takes floats, then anything else.
+		var array = new [3];
+		assertEq("[null, null, null]", "" + array);
+		array[0] = 1.5;
+		array[2] = 2.5;
+		assertEq("[1.5, null, 2.5]", "" + array);
+		array[1] = 7;
+		assertEq("[1.5, 7, 2.5]", "" + array);
+		array[2] = "x";
+		array[0] = null;
+		assertEq("[null, 7, x]", "" + array);
+	},
+	{//Packed arrays: storing a float or a string into an array of integers.
+		var array = [ 1, 2, 3 ];
+		array[1] = 2.5;
+		assertEq("[1, 2.5, 3]", "" + array);
+		assertEq(1, array[0]);
+		array[0] = 4;
+		assertEq("[4, 2.5, 3]", "" + array);
+
+		array = [ 1, null, 3 ];
+		array[1] = "y";
+		assertEq("[1, y, 3]", "" + array);
+
+		array = [ 1.5, 2.5 ];
+		array[0] = 1;
+		assertEq("[1, 2.5]", "" + array);
+	},
+	{//Packed arrays: the most negative integer is not null.
+		var min = -0x7FFFFFFFFFFFFFFF - 1;
+		var max = 0x7FFFFFFFFFFFFFFF;
+		var array = new [3];
+		array[0] = max;
+		array[1] = min;
+		assertEq(max, array[0]);
+		assertEq(min, array[1]);
+		assertEq(null, array[2]);
+		assertEq(true, array[1] != null);
+
+		array = [ min, 1 ];
+		assertEq(min, array[0]);
+		assertEq(true, array[0] != null);
+		array[1] = null;
+		assertEq(null, array[1]);
+	},
+	{//Packed arrays: null elements of float arrays.
+		var array = [ 1.5, null, -2.5 ];
+		assertEq(null, array[1]);
+		array[0] = null;
+		array[1] = 0.0;
+		assertEq(null, array[0]);
+		assertEq(0.0, array[1]);
+		assertEq("[null, 0, -2.5]", "" + array);
+	},
+	{//Packed arrays: sort().
+		var array = new [100];
+		for (var i = 0; i < 100; ++i) array[i] = (i * 37) % 100 - 50;
+		array.sort();
+		for (var i = 0; i < 100; ++i) assertEq(i - 50, array[i]);
+
+		array = [ 2.5, -1.5, 0.5, 10.0, -7.25 ];
+		array.sort();
+		assertEq("[-7.25, -1.5, 0.5, 2.5, 10]", "" + array);
+
+		array = [ 3, 1, 2 ];
+		array[1] = "a";
+		array[0] = "c";
+		array[2] = "b";
+		array.sort();
+		assertEq("[a, b, c]", "" + array);
+
+		var err = false;
+		try {
+			[ 3, null, 1 ].sort();
+		} catch (e) { err = true; }
+		assert(err);
+	},
+	{//Packed arrays: for-each.
+		function join(array) {
+			var s = "";
+			for (var v : array) s = s + "<" + v + ">";
+			return s;
+		}
+
+		assertEq("<1><2><3>", join([ 1, 2, 3 ]));
+		assertEq("<1.5><null><2.5>", join([ 1.5, null, 2.5 ]));
+		assertEq("<null><null>", join(new [2]));
+		assertEq("<1><a><2.5>", join([ 1, "a", 2.5 ]));
+
+		var array = [ 1, 2, 3 ];
+		var sum = 0;
+		for (var v : array) {
+			sum += v;
+			array[2] = 0.5;
+		}
+		assertEq(3.5, sum);
+	},
 	{//ArrayList.sort()
 		function array_to_list(a) {
 			var lst = new sys.ArrayList();
@@ -1410,6 +1744,263 @@ var tests = [
 	{//Bug: fails on too big hexadecimal integer literal.
 		var s = sys.execute("foo.s", "var x = 0x1000000000; return \"\" + x;");
 		assertEq("68719476736", s);
+	},
+	{//sys.execute(): sources of executed scripts are released, while functions defined by them remain usable.
+		var functions = new sys.ArrayList();
+		for (var i = 0; i < 3000; ++i) {
+			var f = sys.execute("source" + i + ".s", "var k = " + i + "; return (){ return k; };");
+			if (i % 1000 == 0) functions.add(f);
+			assertEq(i, f());
+		}
+		for (var i = 0; i < functions.size(); ++i) assertEq(i * 1000, functions.get(i)());
+	},
+	{//EventLoop: timers run in the order of their times, then in the order they were set.
+		var loop = new sys.EventLoop();
+		var list = new sys.ArrayList();
+		loop.set_timeout(30, (){ list.add("c"); });
+		loop.set_timeout(10, (){ list.add("a"); });
+		loop.set_timeout(20, (){ list.add("b"); });
+		loop.set_timeout(10, (){ list.add("a2"); });
+		loop.set_timeout(0, (){ list.add("z"); });
+		loop.run();
+		assertEq("[z, a, a2, b, c]", "" + list);
+	},
+	{//EventLoop: a timer set by a callback runs after the callback.
+		var loop = new sys.EventLoop();
+		var list = new sys.ArrayList();
+		loop.set_timeout(0, (){
+			list.add("a");
+			loop.set_timeout(0, (){ list.add("c"); });
+		});
+		loop.set_timeout(0, (){ list.add("b"); });
+		loop.run();
+		assertEq("[a, b, c]", "" + list);
+	},
+	{//EventLoop.cancel_timeout()
+		var loop = new sys.EventLoop();
+		var list = new sys.ArrayList();
+		var id1 = loop.set_timeout(10, (){ list.add("a"); });
+		var id2 = loop.set_timeout(20, (){ list.add("b"); });
+		var id3 = loop.set_timeout(30, (){ list.add("c"); });
+		assert(id1 != id2 && id2 != id3 && id1 != id3);
+		loop.set_timeout(0, (){ loop.cancel_timeout(id3); });
+		loop.cancel_timeout(id1);
+		loop.cancel_timeout(id1);
+		loop.cancel_timeout(12345);
+		loop.run();
+		assertEq("[b]", "" + list);
+	},
+	{//EventLoop.stop()
+		var loop = new sys.EventLoop();
+		var list = new sys.ArrayList();
+		loop.set_timeout(0, (){
+			list.add("a");
+			loop.stop();
+		});
+		loop.set_timeout(0, (){ list.add("b"); });
+		loop.set_timeout(20, (){ list.add("c"); });
+		loop.run();
+		assertEq("[a]", "" + list);
+
+		loop.run();
+		assertEq("[a, b, c]", "" + list);
+	},
+	{//EventLoop: errors.
+		var loop = new sys.EventLoop();
+		var err = false;
+		try {
+			loop.set_timeout(-1, (){});
+		} catch (e) { err = true; }
+		assert(err);
+
+		err = false;
+		try {
+			loop.set_timeout(0, null);
+		} catch (e) { err = true; }
+		assert(err);
+
+		err = false;
+		loop.set_timeout(0, (){ loop.run(); });
+		try {
+			loop.run();
+		} catch (e) { err = true; }
+		assert(err);
+
+		loop.run();
+	},
+	{//sys.Thread: the result of the script, the scope, exceptions.
+		var list = [ 1, 2, 3 ];
+		var scope = new sys.HashMap();
+		scope.put("x", 20);
+		scope.put("list", list);
+		var thread = new sys.Thread("thread.s", "list[0] = 100; return x + list[0] + list.length;", scope);
+		assertEq(123, thread.join());
+		assertEq("[1, 2, 3]", "" + list);
+
+		thread = new sys.Thread("thread.s", "var a = 1;");
+		assertEq(null, thread.join());
+
+		thread = new sys.Thread("thread.s", "throw \"Thread error\";");
+		var err = false;
+		try {
+			thread.join();
+		} catch (e) { err = true; }
+		assert(err);
+
+		err = false;
+		try {
+			scope.put("f", (){});
+			new sys.Thread("thread.s", "return 0;", scope);
+		} catch (e) { err = true; }
+		assert(err);
+	},
+	{//sys.Channel: values are received in the order they were sent.
+		var channel = new sys.Channel();
+		assertEq(null, channel.poll());
+		for (var i = 0; i < 100; ++i) channel.send(i);
+		channel.send("a");
+		channel.send([ 1, 2.5, "b", null ]);
+		for (var i = 0; i < 100; ++i) assertEq(i, channel.receive());
+		assertEq("a", channel.poll());
+		assertEq("[1, 2.5, b, null]", "" + channel.receive());
+		assertEq(null, channel.poll());
+
+		var err = false;
+		try {
+			channel.send((){});
+		} catch (e) { err = true; }
+		assert(err);
+	},
+	{//sys.Channel.close(): remaining values are received, then null.
+		var channel = new sys.Channel();
+		channel.send(1);
+		channel.send(2);
+		channel.close();
+		assertEq(1, channel.receive());
+		assertEq(2, channel.poll());
+		assertEq(null, channel.receive());
+		assertEq(null, channel.poll());
+
+		var err = false;
+		try {
+			channel.send(3);
+		} catch (e) { err = true; }
+		assert(err);
+	},
+	{//sys.Channel: communication between threads.
+		var requests = new sys.Channel();
+		var responses = new sys.Channel();
+		var scope = new sys.HashMap();
+		scope.put("requests", requests);
+		scope.put("responses", responses);
+		var thread = new sys.Thread("thread.s",
+			"var n = 0;"
+			+ "while (true) {"
+			+ "  var v = requests.receive();"
+			+ "  if (v == null) break;"
+			+ "  responses.send([ v, \"v\" + v ]);"
+			+ "  ++n;"
+			+ "}"
+			+ "responses.close();"
+			+ "return n;",
+			scope);
+
+		for (var i = 0; i < 1000; ++i) requests.send(i);
+		requests.close();
+		for (var i = 0; i < 1000; ++i) {
+			var response = responses.receive();
+			assertEq(i, response[0]);
+			assertEq("v" + i, response[1]);
+		}
+		assertEq(null, responses.receive());
+		assertEq(1000, thread.join());
+	},
+	{//sys.WorkerPool
+		var pool = new sys.WorkerPool(3, "worker.s",
+			"var sum = 0;"
+			+ "while (true) {"
+			+ "  var job = jobs.receive();"
+			+ "  if (job == null) break;"
+			+ "  sum += job * k;"
+			+ "}"
+			+ "return sum;",
+			(){ var scope = new sys.HashMap(); scope.put("k", 2); return scope; }());
+		assertEq(3, pool.size());
+		for (var i = 1; i <= 1000; ++i) pool.submit(i);
+		var results = pool.join();
+		assertEq(3, results.length);
+		var total = 0;
+		for (var r : results) total += r;
+		assertEq(1001000, total);
+
+		var err = false;
+		try {
+			new sys.WorkerPool(0, "worker.s", "return 0;");
+		} catch (e) { err = true; }
+		assert(err);
+	},
+	{//Threads: concurrent allocation. Run the tests with -gc N -p M to stress parallel and incremental GC.
+		var code = "var keep = new sys.ArrayList();"
+			+ "for (var i = 0; i < 20000; ++i) {"
+			+ "  var s = \"s\" + i + \"-\" + id;"
+			+ "  var list = new sys.ArrayList();"
+			+ "  list.add(s);"
+			+ "  list.add(i);"
+			+ "  var map = new sys.HashMap();"
+			+ "  map.put(s, list);"
+			+ "  map.put(i, [ i, 1.5, s, null, [ true ] ]);"
+			+ "  if (i % 100 == 0) keep.add(map);"
+			+ "}"
+			+ "var sum = 0;"
+			+ "for (var k = 0; k < keep.size(); ++k) {"
+			+ "  var i = k * 100;"
+			+ "  var map = keep.get(k);"
+			+ "  if (map.get(\"s\" + i + \"-\" + id).get(1) != i) throw \"Wrong list\";"
+			+ "  var array = map.get(i);"
+			+ "  if (array[0] != i || array[2] != \"s\" + i + \"-\" + id || array[3] != null) throw \"Wrong array\";"
+			+ "  sum += i;"
+			+ "}"
+			+ "return sum;";
+
+		var threads = new sys.ArrayList();
+		for (var t = 0; t < 6; ++t) {
+			var scope = new sys.HashMap();
+			scope.put("id", t);
+			threads.add(new sys.Thread("thread" + t + ".s", code, scope));
+		}
+
+		for (var t = 0; t < threads.size(); ++t) assertEq(1990000, threads.get(t).join());
+	},
+	{//GC: after a full collection, the used heap is the size of live objects, even if they are scattered among garbage.
+		var stats = sys.gc_stats();
+		var full_collections = stats.full_collections;
+		var list = new sys.ArrayList();
+		//Chunks without young objects are swept lazily, by the next collection, so garbage left by preceding tests
+		//may still be counted after the first one. With a pause target, objects which die during a marking cycle
+		//are collected only by the next cycle, so one more collection is needed.
+		var collections = stats.pause_target_ms != 0 ? 3 : 2;
+		for (var i = 0; i < 1000000 && stats.full_collections < full_collections + collections; ++i) {
+			var garbage = [ i, i, i, i, i, i, i, i ];
+			list.add([ i ]);
+			stats = sys.gc_stats();
+		}
+		assert(stats.full_collections == full_collections + collections);
+		assert(stats.used_heap < stats.live_size + stats.live_size / 10);
+	},
+	{//GC: with a pause target (option -p), pauses rarely exceed it, though there are both live objects and garbage.
+		var stats = sys.gc_stats();
+		if (stats.pause_target_ms != 0) {
+			var pauses = stats.pauses;
+			var long_pauses = stats.long_pauses;
+			var live = new sys.HashMap();
+			for (var i = 0; i < 200000; ++i) {
+				live.put(i % 5000, [ i, "v" + i ]);
+				var garbage = [ i, i, i, i, i, i, i, i ];
+			}
+			stats = sys.gc_stats();
+			assert(stats.pauses - pauses >= 10);
+			assert(stats.long_pauses - long_pauses <= (stats.pauses - pauses) / 10);
+		}
 	}
 ];
 
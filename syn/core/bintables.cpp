@@ -0,0 +1,356 @@
+/*
+ * Copyright 2014 Anton Karmanov
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//Binary LR tables generation and in-process grammar compilation.
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bintables.h"
+#include "commons.h"
+#include "concrete_lr.h"
+#include "converter__dec.h"
+#include "converter_res.h"
+#include "descriptor.h"
+#include "ebnf_builder.h"
+#include "grm_parser.h"
+#include "lrtables.h"
+#include "syn.h"
+
+namespace ns = synbin;
+namespace prs = ns::grm_parser;
+namespace util = ns::util;
+namespace bin = syn::bin;
+
+using std::unique_ptr;
+
+namespace {
+
+	//
+	//BinaryTablesWriter
+	//
+
+	class BinaryTablesWriter {
+		NONCOPYABLE(BinaryTablesWriter);
+
+		const ns::ConcreteLRResult& m_lr_result;
+
+		std::map<const ns::TrDescriptor*, bin::U32> m_token_ids;
+		std::string m_strings;
+
+		std::vector<bin::StateRec> m_states;
+		std::vector<bin::ShiftRec> m_shifts;
+		std::vector<bin::GotoRec> m_gotos;
+		std::vector<bin::ReduceRec> m_reduces;
+		std::vector<bin::StartRec> m_starts;
+		std::vector<bin::TokenRec> m_tokens;
+		std::vector<bin::NtRec> m_nts;
+		std::vector<bin::PrRec> m_prs;
+		std::vector<bin::U32> m_nofollow;
+
+		bin::U32 add_string(const std::string& str);
+		void add_token(const ns::TrDescriptor* tr, const std::string& name, const std::string& str);
+		bin::U32 get_token_id(const ns::ConcreteBNF::Tr* tr) const;
+		bin::U32 add_nofollow(const ns::UserNtDescriptor* user_nt);
+		static bin::U32 get_filter(const ns::PrDescriptor* pr);
+
+		void build_tokens();
+		void build_nts();
+		void build_states();
+
+		template<class T>
+		static void write_section(std::ostream& out, const std::vector<T>& section);
+
+	public:
+		explicit BinaryTablesWriter(const ns::ConcreteLRResult& lr_result) : m_lr_result(lr_result){}
+
+		void write(std::ostream& out, std::uint64_t source_hash);
+	};
+
+	//System tokens, in the same order as in the generated code.
+	const char* const g_system_tokens[] = { "SYS_ERROR", "SYS_EOF" };
+	const bin::U32 EOF_TOKEN = 1;
+
+}
+
+bin::U32 BinaryTablesWriter::add_string(const std::string& str) {
+	bin::U32 ofs = static_cast<bin::U32>(m_strings.size());
+	m_strings += str;
+	m_strings += '\0';
+	return ofs;
+}
+
+void BinaryTablesWriter::add_token(const ns::TrDescriptor* tr, const std::string& name, const std::string& str) {
+	m_token_ids[tr] = static_cast<bin::U32>(m_tokens.size());
+
+	bin::TokenRec rec;
+	rec.m_name = add_string(name);
+	rec.m_str = add_string(str);
+	m_tokens.push_back(rec);
+}
+
+bin::U32 BinaryTablesWriter::get_token_id(const ns::ConcreteBNF::Tr* tr) const {
+	auto iter = m_token_ids.find(tr->get_tr_obj().get());
+	assert(iter != m_token_ids.end());
+	return iter->second;
+}
+
+bin::U32 BinaryTablesWriter::add_nofollow(const ns::UserNtDescriptor* user_nt) {
+	if (!user_nt || user_nt->get_nofollow().empty()) return bin::NONE;
+
+	bin::U32 ofs = static_cast<bin::U32>(m_nofollow.size());
+	for (const util::MPtr<const ns::TrDescriptor>& tr : user_nt->get_nofollow()) {
+		auto iter = m_token_ids.find(tr.get());
+		assert(iter != m_token_ids.end());
+		m_nofollow.push_back(iter->second);
+	}
+	m_nofollow.push_back(bin::NONE);
+	return ofs;
+}
+
+bin::U32 BinaryTablesWriter::get_filter(const ns::PrDescriptor* pr) {
+	ns::PrFilter filter = pr->get_filter();
+	if (ns::PRFILTER_PREFER == filter) return syn::REDUCE_PREFER;
+	if (ns::PRFILTER_AVOID == filter) return syn::REDUCE_AVOID;
+	if (ns::PRFILTER_REJECT == filter) return syn::REDUCE_REJECT;
+	return 0;
+}
+
+void BinaryTablesWriter::build_tokens() {
+	//Token IDs are the same as in the generated code: system tokens, name tokens, string tokens.
+	for (const char* name : g_system_tokens) {
+		bin::TokenRec rec;
+		rec.m_name = add_string(name);
+		rec.m_str = 0;
+		m_tokens.push_back(rec);
+	}
+
+	//Name tokens are named as in the grammar, literal tokens as in the generated code.
+	for (const ns::NameTrDescriptor* tr : m_lr_result.get_name_tokens()) {
+		add_token(tr, tr->get_name().str(), std::string());
+	}
+	for (const ns::StrTrDescriptor* tr : m_lr_result.get_str_tokens()) {
+		std::ostringstream name;
+		tr->generate_constant_name(name);
+		add_token(tr, name.str(), tr->get_str().str());
+	}
+}
+
+void BinaryTablesWriter::build_nts() {
+	const ns::ConcreteBNF* bnf = m_lr_result.get_bnf_grammar();
+
+	m_nts.resize(bnf->get_nonterminals().size());
+	std::vector<bin::U32> nt_nofollow(m_nts.size());
+	for (const ns::ConcreteBNF::Nt* nt : bnf->get_nonterminals()) {
+		//User nonterminals are named as in the grammar, so that they can be found by name.
+		const ns::UserNtDescriptor* user_nt = nt->get_nt_obj()->as_user_nt();
+		const util::String& name = user_nt ? user_nt->get_name() : nt->get_name();
+		m_nts[nt->get_nt_index()].m_name = add_string(name.str());
+		nt_nofollow[nt->get_nt_index()] = add_nofollow(user_nt);
+	}
+
+	m_prs.resize(bnf->get_productions().size());
+	for (const ns::ConcreteBNF::Pr* pr : bnf->get_productions()) {
+		bin::PrRec& rec = m_prs[pr->get_pr_index()];
+		rec.m_nt = pr->get_nt()->get_nt_index();
+		rec.m_length = static_cast<bin::U32>(pr->get_elements().size());
+		rec.m_filter = get_filter(pr->get_pr_obj().get());
+		rec.m_nofollow = nt_nofollow[rec.m_nt];
+	}
+}
+
+void BinaryTablesWriter::build_states() {
+	const ns::ConcreteLRTables* lr_tables = m_lr_result.get_lr_tables();
+
+	for (const ns::ConcreteLRState* state : lr_tables->get_states()) {
+		assert(static_cast<std::size_t>(state->get_index()) == m_states.size());
+
+		bin::StateRec rec;
+		rec.m_sym = bin::NONE;
+		rec.m_sym_type = bin::SYM_NONE;
+		if (const ns::ConcreteBNF::Sym* sym = state->get_sym()) {
+			if (const ns::ConcreteBNF::Nt* nt = sym->as_nt()) {
+				rec.m_sym = nt->get_nt_index();
+				rec.m_sym_type = bin::SYM_NT;
+			} else {
+				rec.m_sym = get_token_id(sym->as_tr());
+				rec.m_sym_type = bin::SYM_TOKEN;
+			}
+		}
+
+		rec.m_shift_ofs = static_cast<bin::U32>(m_shifts.size());
+		rec.m_shift_count = static_cast<bin::U32>(state->get_shifts().size());
+		for (const ns::ConcreteLRShift& shift : state->get_shifts()) {
+			bin::ShiftRec shift_rec;
+			shift_rec.m_state = shift.get_state()->get_index();
+			shift_rec.m_token = get_token_id(shift.get_tr());
+			m_shifts.push_back(shift_rec);
+		}
+
+		rec.m_goto_ofs = static_cast<bin::U32>(m_gotos.size());
+		rec.m_goto_count = static_cast<bin::U32>(state->get_gotos().size());
+		for (const ns::ConcreteLRGoto& got : state->get_gotos()) {
+			bin::GotoRec goto_rec;
+			goto_rec.m_state = got.get_state()->get_index();
+			goto_rec.m_nt = got.get_nt()->get_nt_index();
+			m_gotos.push_back(goto_rec);
+		}
+
+		rec.m_reduce_ofs = static_cast<bin::U32>(m_reduces.size());
+		rec.m_reduce_count = static_cast<bin::U32>(state->get_reduces().size());
+		for (const ns::ConcreteLRPr* pr : state->get_reduces()) {
+			bin::ReduceRec reduce_rec;
+			reduce_rec.m_pr = pr ? pr->get_pr_index() : bin::NONE;
+			m_reduces.push_back(reduce_rec);
+		}
+
+		m_states.push_back(rec);
+	}
+
+	for (const auto& pair : lr_tables->get_start_states()) {
+		bin::StartRec rec;
+		rec.m_nt = pair.first->get_nt_index();
+		rec.m_state = pair.second->get_index();
+		m_starts.push_back(rec);
+	}
+}
+
+template<class T>
+void BinaryTablesWriter::write_section(std::ostream& out, const std::vector<T>& section) {
+	if (!section.empty()) out.write(reinterpret_cast<const char*>(section.data()), section.size() * sizeof(T));
+}
+
+void BinaryTablesWriter::write(std::ostream& out, std::uint64_t source_hash) {
+	//Empty string must have offset 0.
+	add_string(std::string());
+
+	build_tokens();
+	build_nts();
+	build_states();
+
+	//Pad the strings, so that the size of the data is a multiple of 4.
+	while (m_strings.size() % sizeof(bin::U32)) m_strings += '\0';
+
+	bin::Header header;
+	header.m_magic = bin::MAGIC;
+	header.m_version = bin::VERSION;
+	header.m_source_hash_lo = static_cast<bin::U32>(source_hash);
+	header.m_source_hash_hi = static_cast<bin::U32>(source_hash >> 32);
+	header.m_eof_token = EOF_TOKEN;
+	header.m_state_count = static_cast<bin::U32>(m_states.size());
+	header.m_shift_count = static_cast<bin::U32>(m_shifts.size());
+	header.m_goto_count = static_cast<bin::U32>(m_gotos.size());
+	header.m_reduce_count = static_cast<bin::U32>(m_reduces.size());
+	header.m_start_count = static_cast<bin::U32>(m_starts.size());
+	header.m_token_count = static_cast<bin::U32>(m_tokens.size());
+	header.m_nt_count = static_cast<bin::U32>(m_nts.size());
+	header.m_pr_count = static_cast<bin::U32>(m_prs.size());
+	header.m_nofollow_size = static_cast<bin::U32>(m_nofollow.size());
+	header.m_string_size = static_cast<bin::U32>(m_strings.size());
+
+	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	write_section(out, m_states);
+	write_section(out, m_shifts);
+	write_section(out, m_gotos);
+	write_section(out, m_reduces);
+	write_section(out, m_starts);
+	write_section(out, m_tokens);
+	write_section(out, m_nts);
+	write_section(out, m_prs);
+	write_section(out, m_nofollow);
+	out.write(m_strings.data(), m_strings.size());
+}
+
+//
+//(Functions)
+//
+
+void ns::write_binary_tables(std::ostream& out, const ConcreteLRResult& lr_result, std::uint64_t source_hash) {
+	BinaryTablesWriter writer(lr_result);
+	writer.write(out, source_hash);
+}
+
+std::uint64_t ns::get_grammar_source_hash(const std::string& text) {
+	//FNV-1a.
+	std::uint64_t hash = 14695981039346656037ULL;
+	for (char c : text) {
+		hash ^= static_cast<unsigned char>(c);
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+std::string ns::compile_grammar_to_binary(const std::string& text, const util::String& file_name) {
+	std::istringstream in(text);
+	unique_ptr<GrammarParsingResult> parsing_result = prs::parse_grammar(in, file_name);
+	unique_ptr<GrammarBuildingResult> building_result = EBNF_Builder::build(false, std::move(parsing_result));
+	unique_ptr<ConversionResult> conversion_result = convert_EBNF_to_BNF(false, std::move(building_result));
+
+	unique_ptr<const ConcreteLRTables> lr_tables(LRGenerator<ConcreteBNFTraits>::create_LR_tables(
+		*conversion_result->get_bnf_grammar(),
+		conversion_result->get_start_nts(),
+		false));
+	ConcreteLRResult lr_result(conversion_result.get(), std::move(lr_tables));
+
+	std::ostringstream out;
+	write_binary_tables(out, lr_result, get_grammar_source_hash(text));
+	return out.str();
+}
+
+namespace {
+	bool is_cache_valid(const std::string& cache_file, std::uint64_t source_hash) {
+		std::ifstream in(cache_file.c_str(), std::ios_base::in | std::ios_base::binary);
+		if (!in) return false;
+
+		bin::Header header;
+		if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+
+		return bin::MAGIC == header.m_magic
+			&& bin::VERSION == header.m_version
+			&& static_cast<bin::U32>(source_hash) == header.m_source_hash_lo
+			&& static_cast<bin::U32>(source_hash >> 32) == header.m_source_hash_hi;
+	}
+}
+
+unique_ptr<syn::MappedFile> ns::load_binary_grammar(const std::string& grammar_file, const std::string& cache_file) {
+	std::ifstream in(grammar_file.c_str(), std::ios_base::in | std::ios_base::binary);
+	if (!in) throw Exception("Cannot open file: " + grammar_file);
+	std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+	in.close();
+
+	if (!is_cache_valid(cache_file, get_grammar_source_hash(text))) {
+		std::string data = compile_grammar_to_binary(text, util::String(grammar_file));
+
+		//Write to a temporary file and rename it, so that a concurrent reader never sees a partial file.
+		const std::string temp_file = cache_file + ".tmp";
+		std::ofstream out(temp_file.c_str(), std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+		out.write(data.data(), data.size());
+		out.close();
+		if (!out || std::rename(temp_file.c_str(), cache_file.c_str())) {
+			std::remove(temp_file.c_str());
+			throw Exception("Cannot write file: " + cache_file);
+		}
+	}
+
+	return unique_ptr<syn::MappedFile>(new syn::MappedFile(cache_file));
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright 2014 Anton Karmanov
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//Binary LR tables generation and in-process grammar compilation.
+
+#ifndef SYN_CORE_BINTABLES_H_INCLUDED
+#define SYN_CORE_BINTABLES_H_INCLUDED
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+
+#include "concretelrgen_res.h"
+#include "util_string.h"
+
+namespace syn {
+	class MappedFile;
+}
+
+namespace synbin {
+
+	//Writes LR tables in the binary format defined by syn::bin.
+	void write_binary_tables(std::ostream& out, const ConcreteLRResult& lr_result, std::uint64_t source_hash);
+
+	//Returns the hash of a grammar text, stored in binary tables to detect stale cache files.
+	std::uint64_t get_grammar_source_hash(const std::string& text);
+
+	//Compiles a grammar text into binary LR tables. Throws synbin::Exception on grammar errors.
+	std::string compile_grammar_to_binary(const std::string& text, const util::String& file_name);
+
+	//Maps binary LR tables of a grammar file from a cache file. If the cache file does not exist or has been
+	//produced from a different grammar text, the grammar is compiled and the cache file is (re)written.
+	std::unique_ptr<syn::MappedFile> load_binary_grammar(const std::string& grammar_file, const std::string& cache_file);
+
+}
+
+#endif//SYN_CORE_BINTABLES_H_INCLUDED
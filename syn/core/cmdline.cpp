@@ -60,6 +60,8 @@ namespace synbin {
 		bool m_allocator_set;
 		bool m_use_attr_setters_set;
 		bool m_verbose_set;
+		bool m_binary_tables_set;
+		bool m_grammar_tables_set;
 
 		void check_already_set(bool OptionsParser::*set_var);
 
@@ -72,6 +74,8 @@ namespace synbin {
 		void parse_option_s();
 		void parse_option_v();
 		void parse_option_a();
+		void parse_option_b();
+		void parse_option_G();
 		void parse_option();
 		const Str* parse_options();
 	};
@@ -80,7 +84,9 @@ namespace synbin {
 
 namespace {
 
-	const char* const g_usage_short = "Usage: syn <options> <source file> [<destination file>]\n";
+	const char* const g_usage_short =
+		"Usage: syn <options> <source file> [<destination file>]\n"
+		"       syn -G <destination file>\n";
 
 	const char* const g_usage_options =
 		"\n"
@@ -96,6 +102,9 @@ namespace {
 		"  -s               Use member functions to set attributes (instead of member\n"
 		"                   variables)\n"
 		"  -a <typename>    Use the specified allocator in the generated code\n"
+		"  -b               Write binary LR tables instead of C++ code\n"
+		"  -G <file>        Write LR tables of the grammar file parser (grm_tables.cpp)\n"
+		"                   to the file; no source file is given\n"
 		"  -v               Verbose output\n";
 
 	//
@@ -154,6 +163,8 @@ ns::OptionsParser::OptionsParser(CommandLine* command_line, const Str* start_ptr
 	m_use_attr_setters_set = false;
 	m_verbose_set = false;
 	m_allocator_set = false;
+	m_binary_tables_set = false;
+	m_grammar_tables_set = false;
 }
 
 //Throws an exception if the specified flag is already set, otherwise sets the flag.
@@ -270,6 +281,27 @@ void ns::OptionsParser::parse_option_a() {
 	++m_cur_ptr;
 }
 
+//-b
+void ns::OptionsParser::parse_option_b() {
+	check_already_set(&OptionsParser::m_binary_tables_set);
+	m_command_line->m_binary_tables = true;
+	++m_cur_ptr;
+}
+
+//-G FILE
+void ns::OptionsParser::parse_option_G() {
+	check_already_set(&OptionsParser::m_grammar_tables_set);
+
+	const Str* start_ptr = m_cur_ptr++;
+	if (m_end_ptr == m_cur_ptr || !std::strlen(*m_cur_ptr)) {
+		std::cerr << "Option '" << *start_ptr << "' requires file name\n";
+		throw parse_error(false);
+	}
+
+	m_command_line->m_grammar_tables_file = std::string(*m_cur_ptr);
+	++m_cur_ptr;
+}
+
 //Parse one option.
 void ns::OptionsParser::parse_option()
 {
@@ -294,6 +326,10 @@ void ns::OptionsParser::parse_option()
 		parse_option_v();
 	} else if (!std::strcmp("-a", option)) {
 		parse_option_a();
+	} else if (!std::strcmp("-b", option)) {
+		parse_option_b();
+	} else if (!std::strcmp("-G", option)) {
+		parse_option_G();
 	} else {
 		std::cerr << "Unknown option: '" << option << "'\n";
 		throw parse_error(false);
@@ -336,6 +372,12 @@ std::unique_ptr<const ns::CommandLine> ns::CommandLine::parse_command_line(const
 		OptionsParser options_parser(&*command_line, start_ptr, end_ptr);
 		const Str* cur_ptr = options_parser.parse_options();
 
+		//Grammar tables are written to the file specified by the option, no other files are expected.
+		if (command_line->is_grammar_tables()) {
+			if (cur_ptr != end_ptr) throw parse_error();
+			return std::unique_ptr<const CommandLine>(std::move(command_line));
+		}
+
 		//Parse input file name.
 
 		//End of command line, but file name is expected.
@@ -57,7 +57,7 @@ namespace synbin {
 	class CommandLine {
 		NONCOPYABLE(CommandLine);
 
-		//Input file. Cannot be an empty string.
+		//Input file. An empty string only if grammar tables are written.
 		std::string m_in_file;
 
 		//Output file. An empty string if not specified.
@@ -94,9 +94,16 @@ namespace synbin {
 		//Verbose output.
 		bool m_verbose;
 
+		//Write binary LR tables instead of C++ code.
+		bool m_binary_tables;
+
+		//File to write LR tables of the grammar file parser to, instead of processing a grammar. An empty string
+		//if not specified.
+		std::string m_grammar_tables_file;
+
 		friend class OptionsParser;
 
-		CommandLine() : m_use_attr_setters(false), m_verbose(false){}
+		CommandLine() : m_use_attr_setters(false), m_verbose(false), m_binary_tables(false){}
 
 	public:
 		const std::string& get_in_file() const { return m_in_file; }
@@ -111,6 +118,9 @@ namespace synbin {
 		const std::string& get_allocator() const { return m_allocator; }
 		bool is_use_attr_setters() const { return m_use_attr_setters; }
 		bool is_verbose() const { return m_verbose; }
+		bool is_binary_tables() const { return m_binary_tables; }
+		bool is_grammar_tables() const { return !m_grammar_tables_file.empty(); }
+		const std::string& get_grammar_tables_file() const { return m_grammar_tables_file; }
 
 		//Parses the command line. Returns nullptr on error.
 		static std::unique_ptr<const CommandLine> parse_command_line(const char* const* arguments);
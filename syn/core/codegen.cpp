@@ -20,6 +20,7 @@
 #include <cstddef>
 #include <fstream>
 #include <iostream>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -162,6 +163,9 @@ namespace {
 		std::size_t m_total_goto_count;
 		std::size_t m_total_reduce_count;
 
+		//Offsets of follow restrictions of nonterminals in the 'nofollow' table.
+		std::map<const ns::NtDescriptor*, std::size_t> m_nofollow_offsets;
+
 		ns::ActionCodeGenerator m_action_generator;
 
 	public:
@@ -199,6 +203,7 @@ namespace {
 		void generate_value_pool_h(std::ostream& out);
 		void generate_syn_parser_h(std::ostream& out);
 		void generate_parse_function(std::ostream& out, const ns::ConcreteLRNt* nt);
+		void generate_parse_chunks_function(std::ostream& out, const ns::ConcreteLRNt* nt);
 
 		void generate_cpp_file(std::ostream& out);
 
@@ -211,6 +216,8 @@ namespace {
 		void generate_nonterminals_enum_cpp(std::ostream& out);
 		void generate_tables_declaration_cpp(std::ostream& out);
 		
+		void collect_nofollow_offsets();
+		void generate_nofollow_cpp(std::ostream& out);
 		void collect_state_infos(std::vector<StateInfo>& vector);
 		void generate_shifts_cpp(std::ostream& out, const std::vector<StateInfo>& states);
 		void generate_gotos_cpp(std::ostream& out, const std::vector<StateInfo>& states);
@@ -563,6 +570,12 @@ void CodeGenerator::generate_syn_parser_h(std::ostream& out) {
 		if (i) out << '\n';
 		const ns::ConcreteLRNt* nt = start_states[i].first;
 		generate_parse_function(out, nt);
+
+		const ns::UserNtDescriptor* nt_desc = nt->get_nt_obj().get()->as_user_nt();
+		if (!nt_desc->get_type()->is_void()) {
+			out << '\n';
+			generate_parse_chunks_function(out, nt);
+		}
 	}
 	
 	out << "\t};\n";
@@ -602,7 +615,41 @@ void CodeGenerator::generate_parse_function(std::ostream& out, const ns::Concret
 	out << "\t\t}\n";
 }
 
+void CodeGenerator::generate_parse_chunks_function(std::ostream& out, const ns::ConcreteLRNt* nt) {
+	const ns::UserNtDescriptor* nt_desc = nt->get_nt_obj().get()->as_user_nt();
+	assert(nt_desc);
+
+	MPtr<const ns::TypeDescriptor> type = nt_desc->get_type();
+	assert(!type->is_void());
+
+	out << "\t\ttemplate<class Scanner>\n";
+	out << "\t\tstatic void parse_" << nt_desc->get_name() << "_chunks(\n";
+	out << "\t\t\tScanner& scanner,\n";
+	out << "\t\t\tconst syn::ResyncTokens& resync,\n";
+	out << "\t\t\tstd::size_t thread_count,\n";
+	out << "\t\t\tstd::vector<";
+	m_action_generator.generate_type_external(out, type);
+	out << ">& results)\n";
+	out << "\t\t{\n";
+
+	out << "\t\t\tsyn::BasicSynParser<Scanner, ValuePool, TokenValue, Tokens::SYS_EOF> "
+		<< "basic_parser(scanner);\n";
+
+	out << "\t\t\tstd::vector<StackNt*> root_nts;\n";
+	out << "\t\t\tbasic_parser.parse_chunks(";
+	generate_start_state_constant_name(out, nt);
+	out << ", resync, thread_count, root_nts);\n";
+
+	out << "\t\t\tfor (StackNt* root_nt : root_nts) results.push_back(";
+	m_action_generator.generate_nonterminal_function_name(out, nt);
+	out << "(root_nt));\n";
+
+	out << "\t\t}\n";
+}
+
 void CodeGenerator::generate_cpp_file(std::ostream& out) {
+	collect_nofollow_offsets();
+
 	generate_includes_cpp(out);
 	
 	out << "namespace {\n";
@@ -625,6 +672,7 @@ void CodeGenerator::generate_cpp_file(std::ostream& out) {
 
 	generate_shifts_cpp(out, state_infos);
 	generate_gotos_cpp(out, state_infos);
+	generate_nofollow_cpp(out);
 	generate_reduces_cpp(out, state_infos);
 	generate_states_cpp(out, state_infos);
 	generate_start_states_cpp(out);
@@ -633,6 +681,35 @@ void CodeGenerator::generate_cpp_file(std::ostream& out) {
 	m_action_generator.generate_actions(out);
 }
 
+void CodeGenerator::collect_nofollow_offsets() {
+	std::size_t ofs = 0;
+	for (const ns::NtDescriptor* nt : *m_nts) {
+		const ns::UserNtDescriptor* user_nt = nt->as_user_nt();
+		if (user_nt && !user_nt->get_nofollow().empty()) {
+			m_nofollow_offsets[nt] = ofs;
+			ofs += user_nt->get_nofollow().size() + 1;
+		}
+	}
+}
+
+void CodeGenerator::generate_nofollow_cpp(std::ostream& out) {
+	if (m_nofollow_offsets.empty()) return;
+
+	out << "const syn::InternalTk " << m_code_namespace << "::Tables::nofollow[] = {\n";
+	for (const ns::NtDescriptor* nt : *m_nts) {
+		if (!m_nofollow_offsets.count(nt)) continue;
+		out << "\t//" << nt->get_bnf_name() << '\n';
+		for (MPtr<const ns::TrDescriptor> token : nt->as_user_nt()->get_nofollow()) {
+			out << "\tTokens::";
+			token->generate_constant_name(out);
+			out << ",\n";
+		}
+		out << "\tsyn::NULL_TOKEN,\n";
+	}
+	out << "};\n";
+	out << '\n';
+}
+
 void CodeGenerator::collect_state_infos(std::vector<StateInfo>& vector) {
 	const std::vector<const ns::ConcreteLRState*>& states = m_lr_tables->get_states();
 	std::size_t shift_ofs = 0;
@@ -850,6 +927,7 @@ void CodeGenerator::generate_tables_declaration_cpp(std::ostream& out) {
 	out << "\t\tstatic const Goto gotos[];\n";
 	out << "\t\tstatic const Reduce reduces[];\n";
 	out << "\t\tstatic const State states[];\n";
+	if (!m_nofollow_offsets.empty()) out << "\t\tstatic const syn::InternalTk nofollow[];\n";
 	out << "\t};\n";
 	out << '\n';
 }
@@ -987,11 +1065,36 @@ void CodeGenerator::generate_reduces_cpp(std::ostream& out, const std::vector<St
 				
 				out << length << ", Nts::" << nt->get_name() << ", " << "Actions::";
 				m_generator->m_action_generator.generate_production_constant_name(out, action_info);
+				generate_filter(out, reduce);
 			} else {
 				out << "0, Nt(), syn::ACCEPT_ACTION";
 			}
 		}
 
+		//Filter fields are generated only when needed, so they are zero-initialized in most cases.
+		void generate_filter(std::ostream& out, const ns::ConcreteLRPr* reduce) const {
+			const char* filter_str = nullptr;
+			ns::PrFilter filter = reduce->get_pr_obj()->get_filter();
+			if (ns::PRFILTER_PREFER == filter) {
+				filter_str = "syn::REDUCE_PREFER";
+			} else if (ns::PRFILTER_AVOID == filter) {
+				filter_str = "syn::REDUCE_AVOID";
+			} else if (ns::PRFILTER_REJECT == filter) {
+				filter_str = "syn::REDUCE_REJECT";
+			}
+
+			auto nofollow_iter = m_generator->m_nofollow_offsets.find(reduce->get_nt()->get_nt_obj().get());
+			bool nofollow = nofollow_iter != m_generator->m_nofollow_offsets.end();
+			if (!filter_str && !nofollow) return;
+
+			out << ", " << (filter_str ? filter_str : "0") << ", ";
+			if (nofollow) {
+				out << "&nofollow[" << nofollow_iter->second << "]";
+			} else {
+				out << "nullptr";
+			}
+		}
+
 		void generate_comment(std::ostream& out, const ns::ConcreteLRPr* reduce) const {}
 
 		void generate_terminator(std::ostream& out) const {
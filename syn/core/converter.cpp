@@ -284,6 +284,10 @@ class ns::Converter : public ConverterFacade {
 	util::IndexedMap<const ebnf::TerminalDeclaration*, MPtr<conv::ConvTr>, TrDeclIndexFn> m_tr_to_bnf_map;
 	util::IndexedMap<const ebnf::NonterminalDeclaration*, MPtr<conv::ConvNt>, NtDeclIndexFn> m_nt_to_conv_map;
 
+	//Nonterminals having follow restrictions. Restrictions are converted after all the nonterminals, since
+	//they may refer to string literals used anywhere in the grammar.
+	std::vector<std::pair<ebnf::NonterminalDeclaration*, UserNtDescriptor*>> m_nofollow_nts;
+
 	std::map<String, MPtr<const ClassTypeDescriptor>> m_class_type_map;
 
 	const types::Type* const m_string_literal_type;
@@ -332,6 +336,7 @@ public:
 
 	MPtr<conv::ConvSym> convert_expression_to_nonterminal(ebnf::SyntaxExpression* expr, MPtr<const TypeDescriptor> type) override;
 	MPtr<conv::ConvNt> convert_nonterminal(ebnf::NonterminalDeclaration* nt);
+	void convert_nofollow(ebnf::NonterminalDeclaration* nt, UserNtDescriptor* descriptor);
 	void convert_terminal_init(ebnf::TerminalDeclaration* tr);
 	MPtr<conv::ConvTr> convert_terminal(ebnf::TerminalDeclaration* tr);
 	void convert_expression_to_production(MPtr<conv::ConvNt> conv_nt, const ebnf::SyntaxExpression* expr) override;
@@ -373,14 +378,16 @@ private:
 	void create_production0(
 		MPtr<conv::ConvNt> conv_nt,
 		const std::vector<const BnfSym*>& elements,
-		MPtr<const Action> action);
+		MPtr<const Action> action,
+		PrFilter pr_filter = PRFILTER_NONE);
 
 	void create_implicitly_casted_production(
 		MPtr<conv::ConvNt> conv_nt,
 		const std::vector<const BnfSym*>& elements,
 		MPtr<const Action> action,
 		MPtr<const TypeDescriptor> nt_type,
-		MPtr<const TypeDescriptor> pr_type);
+		MPtr<const TypeDescriptor> pr_type,
+		PrFilter pr_filter);
 
 	MPtr<const Action> create_implicit_cast_action(
 		MPtr<const TypeDescriptor> cast_type,
@@ -464,7 +471,7 @@ void ns::Converter::convert_expression_to_production(MPtr<conv::ConvNt> conv_nt,
 
 	ActionMPtr action = pr_builder.get_action();
 	const std::vector<const BnfSym*>& elements = pr_builder.get_elements();
-	create_production0(conv_nt, elements, action);
+	create_production0(conv_nt, elements, action, expr->get_pr_filter());
 }
 
 MPtr<conv::ConvSym> ns::Converter::convert_symbol_to_symbol(ebnf::SymbolDeclaration* sym) {
@@ -553,8 +560,10 @@ MPtr<conv::ConvNt> ns::Converter::convert_nonterminal(ebnf::NonterminalDeclarati
 		//Create BNF nonterminal.
 		const String& original_name = nt->get_name().get_string();
 		String name = String(g_user_nt_name_prefix + original_name.str());
-		MPtr<const NtDescriptor> descriptor = manage_nt(new UserNtDescriptor(type, name, original_name));
+		UserNtDescriptor* user_descriptor = new UserNtDescriptor(type, name, original_name);
+		MPtr<const NtDescriptor> descriptor = manage_nt(user_descriptor);
 		conv_nt = create_nonterminal(name, descriptor);
+		if (!nt->get_nofollow().empty()) m_nofollow_nts.push_back(std::make_pair(nt, user_descriptor));
 
 		//The new nonterminal must be put into the map before the conversion of the expression, to
 		//avoid infinite recursion.
@@ -563,13 +572,55 @@ MPtr<conv::ConvNt> ns::Converter::convert_nonterminal(ebnf::NonterminalDeclarati
 		//Convert the expression.
 		ebnf::SyntaxExpression* expr = nt->get_expression();
 		ns::SyntaxExpressionExtension* expr_ext = expr->get_extension();
-		expr_ext->get_conversion()->convert_nt(this, conv_nt);
+		if (nt->get_nofollow().empty()) {
+			expr_ext->get_conversion()->convert_nt(this, conv_nt);
+		} else {
+			//A loop converted directly into the nonterminal would make it left-recursive, and the follow
+			//restriction would then apply to the intermediate results of the loop too.
+			convert_expression_to_production(conv_nt, expr);
+		}
 
 		if (nt->is_start()) m_start_bnf_nts->push_back(conv_nt->get_nt());
 	}
 	return conv_nt;
 }
 
+void ns::Converter::convert_nofollow(ebnf::NonterminalDeclaration* nt, UserNtDescriptor* descriptor) {
+	class NoFollowConvertingVisitor : public SyntaxExpressionVisitor<MPtr<conv::ConvSym>> {
+		Converter* const m_converter;
+	public:
+		NoFollowConvertingVisitor(Converter* converter) : m_converter(converter){}
+
+		MPtr<conv::ConvSym> visit_SyntaxExpression(ebnf::SyntaxExpression* expr) override {
+			throw err_illegal_state();
+		}
+
+		MPtr<conv::ConvSym> visit_NameSyntaxExpression(ebnf::NameSyntaxExpression* expr) override {
+			return m_converter->convert_symbol_to_symbol(expr->get_sym());
+		}
+
+		MPtr<conv::ConvSym> visit_StringSyntaxExpression(ebnf::StringSyntaxExpression* expr) override {
+			//A literal which is not used in productions is not a token, so it cannot follow anything.
+			const syntax_string& str = expr->get_string();
+			auto iter = m_converter->m_str_tr_to_bnf_map.find(str.get_string());
+			if (iter == m_converter->m_str_tr_to_bnf_map.end()) {
+				throw raise_error(str, "String literal \"" + str.str() + "\" is not used in the grammar");
+			}
+			return iter->second;
+		}
+	};
+
+	NoFollowConvertingVisitor visitor(this);
+	std::vector<MPtr<const TrDescriptor>> nofollow;
+	for (MPtr<ebnf::SyntaxExpression> expr : nt->get_nofollow()) {
+		MPtr<conv::ConvSym> conv_sym = expr->visit(&visitor);
+		const BnfTr* bnf_tr = conv_sym->get_sym()->as_tr();
+		assert(bnf_tr);
+		nofollow.push_back(bnf_tr->get_tr_obj());
+	}
+	descriptor->set_nofollow(nofollow);
+}
+
 void ns::Converter::convert_terminal_init(ebnf::TerminalDeclaration* tr) {
 	MPtr<conv::ConvTr> conv_tr = m_tr_to_bnf_map.get(tr);
 	assert(!conv_tr);
@@ -790,7 +841,8 @@ MPtr<const ns::Action> ns::Converter::create_action(
 void ns::Converter::create_production0(
 	MPtr<conv::ConvNt> conv_nt,
 	const std::vector<const BnfSym*>& elements,
-	MPtr<const Action> action)
+	MPtr<const Action> action,
+	PrFilter pr_filter)
 {
 	MPtr<const TypeDescriptor> pr_type = action->get_result_type();
 	assert(!!pr_type);
@@ -801,10 +853,10 @@ void ns::Converter::create_production0(
 		//Result type of the production differs from the type of the nonterminal.
 		//Create a helper nonterminal which and a production which will adapt the original production's result
 		//to the target nonterminal's type.
-		create_implicitly_casted_production(conv_nt, elements, action, nt_type, pr_type);
+		create_implicitly_casted_production(conv_nt, elements, action, nt_type, pr_type, pr_filter);
 	} else {
 		//Result type of the production is the same as the type of the nonterminal (or compatible).
-		MPtr<const PrDescriptor> pr_descriptor = m_managed_pr_descriptors->add(new PrDescriptor(action));
+		MPtr<const PrDescriptor> pr_descriptor = m_managed_pr_descriptors->add(new PrDescriptor(action, pr_filter));
 		m_bnf_builder.add_production(conv_nt->get_nt(), pr_descriptor, elements);
 	}
 }
@@ -814,7 +866,8 @@ void ns::Converter::create_implicitly_casted_production(
 	const std::vector<const BnfSym*>& elements,
 	MPtr<const Action> action,
 	MPtr<const TypeDescriptor> nt_type,
-	MPtr<const TypeDescriptor> pr_type)
+	MPtr<const TypeDescriptor> pr_type,
+	PrFilter pr_filter)
 {
 	MPtr<const PrDescriptor> pr_descriptor = m_managed_pr_descriptors->add(new PrDescriptor(action));
 
@@ -827,7 +880,9 @@ void ns::Converter::create_implicitly_casted_production(
 
 	std::vector<const BnfSym*> cast_elements;
 	cast_elements.push_back(temp_bnf_nt);
-	MPtr<const PrDescriptor> cast_pr_descriptor = m_managed_pr_descriptors->add(new PrDescriptor(cast_action));
+	//The filter is attached to the production of the target nonterminal, since it competes with the other
+	//productions of that nonterminal.
+	MPtr<const PrDescriptor> cast_pr_descriptor = m_managed_pr_descriptors->add(new PrDescriptor(cast_action, pr_filter));
 	m_bnf_builder.add_production(conv_nt->get_nt(), cast_pr_descriptor, cast_elements);
 }
 
@@ -969,6 +1024,7 @@ unique_ptr<ns::ConversionResult> ns::Converter::convert_EBNF(
 	//Convert every nonterminal.
 	const std::vector<ebnf::NonterminalDeclaration*>& ebnf_nts = ebnf_grammar->get_nonterminals();
 	for (ebnf::NonterminalDeclaration* nt : ebnf_nts) convert_nonterminal(nt);
+	for (const auto& entry : m_nofollow_nts) convert_nofollow(entry.first, entry.second);
 
 	//Create BNF Grammar.
 	std::unique_ptr<const BnfGrm> bnf_grammar(m_bnf_builder.create_grammar());
@@ -145,6 +145,14 @@ const ns::UserNtDescriptor* ns::UserNtDescriptor::as_user_nt() const {
 	return this;
 }
 
+const std::vector<MPtr<const ns::TrDescriptor>>& ns::UserNtDescriptor::get_nofollow() const {
+	return m_nofollow;
+}
+
+void ns::UserNtDescriptor::set_nofollow(const std::vector<MPtr<const TrDescriptor>>& nofollow) {
+	m_nofollow = nofollow;
+}
+
 void ns::UserNtDescriptor::print(std::ostream& out) const {
 	out << m_name;
 }
@@ -169,8 +177,9 @@ void ns::AutoNtDescriptor::print(std::ostream& out) const {
 //PrDescriptor
 //
 
-ns::PrDescriptor::PrDescriptor(MPtr<const Action> action)
-	: m_action(action)
+ns::PrDescriptor::PrDescriptor(MPtr<const Action> action, PrFilter filter)
+	: m_action(action),
+	m_filter(filter)
 {}
 
 MPtr<const ns::TypeDescriptor> ns::PrDescriptor::get_type() const {
@@ -180,3 +189,7 @@ MPtr<const ns::TypeDescriptor> ns::PrDescriptor::get_type() const {
 MPtr<const ns::Action> ns::PrDescriptor::get_action() const {
 	return m_action;
 }
+
+ns::PrFilter ns::PrDescriptor::get_filter() const {
+	return m_filter;
+}
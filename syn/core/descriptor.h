@@ -20,10 +20,12 @@
 #define SYN_CORE_DESCRIPTOR_H_INCLUDED
 
 #include <ostream>
+#include <vector>
 
 #include "action__dec.h"
 #include "descriptor_type.h"
 #include "noncopyable.h"
+#include "primitives.h"
 #include "util_string.h"
 
 namespace synbin {
@@ -169,6 +171,7 @@ class synbin::UserNtDescriptor : public NtDescriptor {
 	NONCOPYABLE(UserNtDescriptor);
 
 	const util::String m_name;
+	std::vector<util::MPtr<const TrDescriptor>> m_nofollow;
 
 public:
 	UserNtDescriptor(util::MPtr<const TypeDescriptor> type, const util::String& bnf_name, const util::String& name);
@@ -176,6 +179,10 @@ public:
 	const util::String& get_name() const;
 	const UserNtDescriptor* as_user_nt() const override;
 
+	//Terminals which must not follow the nonterminal (follow restriction).
+	const std::vector<util::MPtr<const TrDescriptor>>& get_nofollow() const;
+	void set_nofollow(const std::vector<util::MPtr<const TrDescriptor>>& nofollow);
+
 	void print(std::ostream& out) const override;
 };
 
@@ -204,12 +211,14 @@ class synbin::PrDescriptor : public AbstractDescriptor {
 	NONCOPYABLE(PrDescriptor);
 
 	const util::MPtr<const Action> m_action;
+	const PrFilter m_filter;
 
 public:
-	PrDescriptor(util::MPtr<const Action> action);
+	PrDescriptor(util::MPtr<const Action> action, PrFilter filter = PRFILTER_NONE);
 
 	util::MPtr<const TypeDescriptor> get_type() const override;
 	util::MPtr<const Action> get_action() const;
+	PrFilter get_filter() const;
 };
 
 #endif//SYN_CORE_DESCRIPTOR_H_INCLUDED
@@ -111,6 +111,16 @@ namespace {
 			}
 		}
 	}
+
+	void print_pr_filter(std::ostream& out, ns::PrFilter pr_filter) {
+		if (ns::PRFILTER_PREFER == pr_filter) {
+			out << " prefer";
+		} else if (ns::PRFILTER_AVOID == pr_filter) {
+			out << " avoid";
+		} else if (ns::PRFILTER_REJECT == pr_filter) {
+			out << " reject";
+		}
+	}
 }
 
 /////////////////////////////////////////////////////////////////////
@@ -207,11 +217,13 @@ ebnf::NonterminalDeclaration::NonterminalDeclaration(
 	bool start,
 	const ns::syntax_string& name,
 	MPtr<SyntaxExpression> expression,
-	MPtr<const RawType> explicit_raw_type)
+	MPtr<const RawType> explicit_raw_type,
+	MPtr<const std::vector<MPtr<SyntaxExpression>>> nofollow)
 	: SymbolDeclaration(name),
 	m_syn_start(start),
 	m_syn_expression(expression),
 	m_syn_explicit_raw_type(explicit_raw_type),
+	m_syn_nofollow(nofollow),
 	m_explicit_type(),
 	m_nt_index(std::numeric_limits<std::size_t>::max())
 {}
@@ -247,8 +259,18 @@ void ebnf::NonterminalDeclaration::print(std::ostream& out) const {
 		out << " ";
 		m_syn_explicit_raw_type->print(out);
 	}
+	if (!m_syn_nofollow->empty()) {
+		out << " nofollow(";
+		ListPrinter list_printer(out, " ", false);
+		for (MPtr<SyntaxExpression> expr : *m_syn_nofollow) {
+			list_printer.print_prefix();
+			expr->print(out, PRIOR_TERM);
+		}
+		out << ")";
+	}
 	out << "\n\t: ";
 	m_syn_expression->print(out, ebnf::PRIOR_NT);
+	print_pr_filter(out, m_syn_expression->get_pr_filter());
 	out << "\n\t;\n\n";
 }
 
@@ -343,6 +365,7 @@ void ebnf::SyntaxOrExpression::print(std::ostream& out, SyntaxPriority priority)
 	for (MPtr<ebnf::SyntaxExpression> expr : get_sub_expressions()) {
 		list_printer.print_prefix();
 		expr->print(out, PRIOR_OR);
+		print_pr_filter(out, expr->get_pr_filter());
 	}
 }
 
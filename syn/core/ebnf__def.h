@@ -213,6 +213,7 @@ namespace synbin {
 			const bool m_syn_start;
 			const util::MPtr<SyntaxExpression> m_syn_expression;
 			const util::MPtr<const RawType> m_syn_explicit_raw_type;
+			const util::MPtr<const std::vector<util::MPtr<SyntaxExpression>>> m_syn_nofollow;
 			
 			util::MPtr<const types::Type> m_explicit_type;
 			std::size_t m_nt_index;
@@ -225,10 +226,14 @@ namespace synbin {
 				bool start,
 				const syntax_string& name,
 				util::MPtr<SyntaxExpression> expression,
-				util::MPtr<const RawType> explicit_raw_type);
+				util::MPtr<const RawType> explicit_raw_type,
+				util::MPtr<const std::vector<util::MPtr<SyntaxExpression>>> nofollow);
 			
 			bool is_start() const { return m_syn_start; }
 			const RawType* get_explicit_raw_type() const { return m_syn_explicit_raw_type.get(); }
+
+			//Terminals (name or string expressions) which must not follow the nonterminal.
+			const std::vector<util::MPtr<SyntaxExpression>>& get_nofollow() const { return *m_syn_nofollow; }
 			util::MPtr<const types::Type> get_explicit_type() const { return m_explicit_type; }
 			void set_explicit_type(util::MPtr<const types::Type> explicit_type) { m_explicit_type = explicit_type; }
 			const SyntaxExpression* get_expression() const { return m_syn_expression.get(); }
@@ -296,9 +301,10 @@ namespace synbin {
 			NONCOPYABLE(SyntaxExpression);
 
 			std::unique_ptr<SyntaxExpressionExtension> m_extension;
+			PrFilter m_syn_pr_filter;
 
 		public:
-			SyntaxExpression(){}
+			SyntaxExpression() : m_syn_pr_filter(PRFILTER_NONE){}
 
 		private:
 			virtual void visit0(SyntaxExpressionVisitor<void>* visitor) = 0;
@@ -307,6 +313,10 @@ namespace synbin {
 			void install_extension(std::unique_ptr<SyntaxExpressionExtension> extension);
 			SyntaxExpressionExtension* get_extension() const;
 
+			//The filter applies to the production created for the expression, when the expression is an alternative.
+			PrFilter get_pr_filter() const { return m_syn_pr_filter; }
+			void set_pr_filter(PrFilter pr_filter) { m_syn_pr_filter = pr_filter; }
+
 			virtual void print(std::ostream& out, SyntaxPriority priority) const = 0;
 
 			template<class T>
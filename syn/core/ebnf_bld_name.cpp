@@ -114,6 +114,36 @@ namespace {
 		}
 	};
 
+	//
+	//NoFollowResolvingSyntaxExpressionVisitor
+	//
+
+	class NoFollowResolvingSyntaxExpressionVisitor : public ns::SyntaxExpressionVisitor<void> {
+		NONCOPYABLE(NoFollowResolvingSyntaxExpressionVisitor);
+
+		ns::EBNF_Builder* const m_builder;
+
+	public:
+		NoFollowResolvingSyntaxExpressionVisitor(ns::EBNF_Builder* builder)
+			: m_builder(builder)
+		{}
+
+		void visit_SyntaxExpression(ebnf::SyntaxExpression* expr) override {
+			throw ns::err_illegal_state();
+		}
+
+		void visit_NameSyntaxExpression(ebnf::NameSyntaxExpression* expr) override {
+			const ns::syntax_string& name = expr->get_name();
+			ebnf::SymbolDeclaration* sym = m_builder->resolve_symbol_name(name);
+			if (sym->as_nt()) {
+				throw ns::raise_error(name, "'" + name.str() + "' is not a terminal, it cannot be used in %nofollow");
+			}
+			expr->set_sym(sym);
+		}
+
+		void visit_StringSyntaxExpression(ebnf::StringSyntaxExpression* expr) override {}
+	};
+
 	void resolve_nonterminal_declaration_names(ns::EBNF_Builder* builder, ebnf::NonterminalDeclaration* nt) {
 		const ebnf::RawType* raw_type = nt->get_explicit_raw_type();
 		if (raw_type) {
@@ -126,6 +156,9 @@ namespace {
 		ns::RecursiveSyntaxExpressionVisitor recursive_visitor(&effective_visitor);
 		ebnf::SyntaxExpression* expression = nt->get_expression();
 		expression->visit(&recursive_visitor);
+
+		NoFollowResolvingSyntaxExpressionVisitor nofollow_visitor(builder);
+		for (MPtr<ebnf::SyntaxExpression> nofollow_expr : nt->get_nofollow()) nofollow_expr->visit(&nofollow_visitor);
 	}
 
 }
@@ -85,8 +85,7 @@ namespace {
 
 	class ActionContext;
 
-	//typedef ActionResult (ActionContext::*SyntaxAction)(ProductionResult& pr);
-	enum class SyntaxRule;
+	using prs::SyntaxRule;
 
 	//A derived class is used instead of typedef to avoid "decorated name length exceeded..." warning.
 	class RawTraits : public ns::BnfTraits<raw::NullType, prs::Tokens::E, SyntaxRule>{};
@@ -102,92 +101,6 @@ namespace {
 
 	typedef ns::BnfGrammar<RawTraits> BnfGrm;
 
-	//
-	//SyntaxRule
-	//
-
-	enum class SyntaxRule {
-		NONE,
-		Grammar__DeclarationList,
-		DeclarationList__Declaration,
-		DeclarationList__DeclarationList_Declaration,
-		Declaration__TypeDeclaration,
-		Declaration__TerminalDeclaration,
-		Declaration__NonterminalDeclaration,
-		Declaration__CustomTerminalTypeDeclaration,
-		TypeDeclaration__KWTYPE_NAME_CHSEMICOLON,
-		TerminalDeclaration__KWTOKEN_NAME_TypeOpt_CHSEMICOLON,
-		NonterminalDeclaration__AtOpt_NAME_TypeOpt_CHCOLON_SyntaxOrExpression_CHSEMICOLON,
-		CustomTerminalTypeDeclaration__KWTOKEN_STRING_Type_CHSEMICOLON,
-		AtOpt__CHAT,
-		AtOpt__,
-		TypeOpt__Type,
-		TypeOpt__,
-		Type__CHOBRACE_NAME_CHCBRACE,
-		SyntaxOrExpression__SyntaxAndExpressionList,
-		SyntaxAndExpressionList__SyntaxAndExpression,
-		SyntaxAndExpressionList__SyntaxAndExpressionList_CHOR_SyntaxAndExpression,
-		SyntaxAndExpression__SyntaxElementListOpt_TypeOpt,
-		SyntaxElementListOpt__SyntaxElementList,
-		SyntaxElementListOpt__,
-		SyntaxElementList__SyntaxElement,
-		SyntaxElementList__SyntaxElementList_SyntaxElement,
-		SyntaxElement__NameSyntaxElement,
-		SyntaxElement__ThisSyntaxElement,
-		NameSyntaxElement__NAME_CHEQ_SyntaxTerm,
-		NameSyntaxElement__SyntaxTerm,
-		ThisSyntaxElement__KWTHIS_CHEQ_SyntaxTerm,
-		SyntaxTerm__PrimarySyntaxTerm,
-		SyntaxTerm__AdvanvedSyntaxTerm,
-		PrimarySyntaxTerm__NameSyntaxTerm,
-		PrimarySyntaxTerm__StringSyntaxTerm,
-		PrimarySyntaxTerm__NestedSyntaxTerm,
-		NameSyntaxTerm__NAME,
-		StringSyntaxTerm__STRING,
-		NestedSyntaxTerm__TypeOpt_CHOPAREN_SyntaxOrExpression_CHCPAREN,
-		AdvanvedSyntaxTerm__ZeroOneSyntaxTerm,
-		AdvanvedSyntaxTerm__ZeroManySyntaxTerm,
-		AdvanvedSyntaxTerm__OneManySyntaxTerm,
-		AdvanvedSyntaxTerm__ConstSyntaxTerm,
-		ZeroOneSyntaxTerm__PrimarySyntaxTerm_CHQUESTION,
-		ZeroManySyntaxTerm__LoopBody_CHASTERISK,
-		OneManySyntaxTerm__LoopBody_CHPLUS,
-		LoopBody__SimpleLoopBody,
-		LoopBody__AdvancedLoopBody,
-		SimpleLoopBody__PrimarySyntaxTerm,
-		AdvancedLoopBody__CHOPAREN_SyntaxOrExpression_CHCOLON_SyntaxOrExpression_CHCPAREN,
-		AdvancedLoopBody__CHOPAREN_SyntaxOrExpression_CHCPAREN,
-		ConstSyntaxTerm__CHLT_ConstExpression_CHGT,
-		ConstExpression__IntegerConstExpression,
-		ConstExpression__StringConstExpression,
-		ConstExpression__BooleanConstExpression,
-		ConstExpression__NativeConstExpression,
-		IntegerConstExpression__NUMBER,
-		StringConstExpression__STRING,
-		BooleanConstExpression__KWFALSE,
-		BooleanConstExpression__KWTRUE,
-		NativeConstExpression__NativeQualificationOpt_NativeName_NativeReferencesOpt,
-		NativeQualificationOpt__NativeQualification,
-		NativeQualificationOpt__,
-		NativeQualification__NAME_CHCOLONCOLON,
-		NativeQualification__NativeQualification_NAME_CHCOLONCOLON,
-		NativeReferencesOpt__NativeReferences,
-		NativeReferencesOpt__,
-		NativeReferences__NativeReference,
-		NativeReferences__NativeReferences_NativeReference,
-		NativeName__NativeVariableName,
-		NativeName__NativeFunctionName,
-		NativeVariableName__NAME,
-		NativeFunctionName__NAME_CHOPAREN_ConstExpressionListOpt_CHCPAREN,
-		ConstExpressionListOpt__ConstExpressionList,
-		ConstExpressionListOpt__,
-		ConstExpressionList__ConstExpression,
-		ConstExpressionList__ConstExpressionList_CHCOMMA_ConstExpression,
-		NativeReference__CHDOT_NativeName,
-		NativeReference__CHMINUSGT_NativeName,
-		LAST
-	};
-
 	const syn::InternalAction ACTION_FIRST = static_cast<syn::InternalAction>(SyntaxRule::NONE);
 	const syn::InternalAction ACTION_LAST = static_cast<syn::InternalAction>(SyntaxRule::LAST);
 
@@ -753,12 +666,35 @@ namespace {
 			return lst;
 		}
 
+		ns::PrFilter nt_PrFilterOpt(const syn::StackElement* node) {
+			const syn::StackElement_Nt* nt = node->as_nt();
+			ProductionStack stack(m_stack_vector, nt);
+
+			const SyntaxRule rule = syntax_rule(nt);
+			if (SyntaxRule::PrFilterOpt__KWPREFER == rule) {
+				assert(1 == stack.size());
+				return ns::PRFILTER_PREFER;
+			} else if (SyntaxRule::PrFilterOpt__KWAVOID == rule) {
+				assert(1 == stack.size());
+				return ns::PRFILTER_AVOID;
+			} else if (SyntaxRule::PrFilterOpt__KWREJECT == rule) {
+				assert(1 == stack.size());
+				return ns::PRFILTER_REJECT;
+			} else if (SyntaxRule::PrFilterOpt__ == rule) {
+				assert(0 == stack.size());
+				return ns::PRFILTER_NONE;
+			} else {
+				throw illegal_state();
+			}
+		}
+
 		MPtr<ebnf::SyntaxExpression> nt_SyntaxAndExpression(const syn::StackElement* node) {
 			ProductionStack stack(m_stack_vector, node);
-			check_rule(stack, SyntaxRule::SyntaxAndExpression__SyntaxElementListOpt_TypeOpt, 2);
+			check_rule(stack, SyntaxRule::SyntaxAndExpression__SyntaxElementListOpt_TypeOpt_PrFilterOpt, 3);
 
 			MPtr<SyntaxExprVector> expressions = nt_SyntaxElementListOpt(stack[0]);
 			MPtr<const ebnf::RawType> type = nt_TypeOpt(stack[1]);
+			ns::PrFilter pr_filter = nt_PrFilterOpt(stack[2]);
 
 			MPtr<ebnf::SyntaxExpression> expression;
 			if (expressions->empty() && !type.get()) {
@@ -772,6 +708,7 @@ namespace {
 				expression = manage(new ebnf::SyntaxAndExpression(expressions, type));
 			}
 
+			expression->set_pr_filter(pr_filter);
 			return expression;
 		}
 
@@ -845,15 +782,70 @@ namespace {
 			}
 		}
 
+		MPtr<ebnf::SyntaxExpression> nt_NoFollowTerm(const syn::StackElement* node) {
+			const syn::StackElement_Nt* nt = node->as_nt();
+			ProductionStack stack(m_stack_vector, nt);
+			assert(1 == stack.size());
+
+			const SyntaxRule rule = syntax_rule(nt);
+			if (SyntaxRule::NoFollowTerm__NameSyntaxTerm == rule) {
+				return nt_NameSyntaxTerm(stack[0]);
+			} else if (SyntaxRule::NoFollowTerm__StringSyntaxTerm == rule) {
+				return nt_StringSyntaxTerm(stack[0]);
+			} else {
+				throw illegal_state();
+			}
+		}
+
+		void nt_NoFollowList(const syn::StackElement* node, MPtr<SyntaxExprVector> lst) {
+			const syn::StackElement_Nt* nt = node->as_nt();
+			ProductionStack stack(m_stack_vector, nt);
+
+			const SyntaxRule rule = syntax_rule(nt);
+			if (SyntaxRule::NoFollowList__NoFollowTerm == rule) {
+				assert(1 == stack.size());
+				lst->push_back(nt_NoFollowTerm(stack[0]));
+			} else if (SyntaxRule::NoFollowList__NoFollowList_NoFollowTerm == rule) {
+				assert(2 == stack.size());
+				nt_NoFollowList(stack[0], lst);
+				lst->push_back(nt_NoFollowTerm(stack[1]));
+			} else {
+				throw illegal_state();
+			}
+		}
+
+		MPtr<const SyntaxExprVector> nt_NoFollowOpt(const syn::StackElement* node) {
+			const syn::StackElement_Nt* nt = node->as_nt();
+			ProductionStack stack(m_stack_vector, nt);
+
+			MPtr<SyntaxExprVector> lst = manage_const_spec(new SyntaxExprVector());
+
+			const SyntaxRule rule = syntax_rule(nt);
+			if (SyntaxRule::NoFollowOpt__KWNOFOLLOW_CHOPAREN_NoFollowList_CHCPAREN == rule) {
+				assert(4 == stack.size());
+				nt_NoFollowList(stack[2], lst);
+			} else if (SyntaxRule::NoFollowOpt__ == rule) {
+				assert(0 == stack.size());
+			} else {
+				throw illegal_state();
+			}
+
+			return lst;
+		}
+
 		MPtr<ebnf::NonterminalDeclaration> nt_NonterminalDeclaration(const syn::StackElement* node) {
 			ProductionStack stack(m_stack_vector, node);
-			check_rule(stack, SyntaxRule::NonterminalDeclaration__AtOpt_NAME_TypeOpt_CHCOLON_SyntaxOrExpression_CHSEMICOLON, 6);
+			check_rule(
+				stack,
+				SyntaxRule::NonterminalDeclaration__AtOpt_NAME_TypeOpt_NoFollowOpt_CHCOLON_SyntaxOrExpression_CHSEMICOLON,
+				7);
 
 			bool start = nt_AtOpt(stack[0]);
 			const ns::syntax_string name = tk_string(stack[1]);
 			MPtr<const ebnf::RawType> type = nt_TypeOpt(stack[2]);
-			MPtr<ebnf::SyntaxExpression> expression = nt_SyntaxOrExpression(stack[4]);
-			return manage(new ebnf::NonterminalDeclaration(start, name, expression, type));
+			MPtr<const SyntaxExprVector> nofollow = nt_NoFollowOpt(stack[3]);
+			MPtr<ebnf::SyntaxExpression> expression = nt_SyntaxOrExpression(stack[5]);
+			return manage(new ebnf::NonterminalDeclaration(start, name, expression, type, nofollow));
 		}
 
 		MPtr<ebnf::Declaration> nt_CustomTerminalTypeDeclaration(const syn::StackElement* node) {
@@ -927,6 +919,10 @@ namespace {
 		{ "KW_TYPE", prs::Tokens::KW_TYPE },
 		{ "KW_FALSE", prs::Tokens::KW_FALSE },
 		{ "KW_TRUE", prs::Tokens::KW_TRUE },
+		{ "KW_PREFER", prs::Tokens::KW_PREFER },
+		{ "KW_AVOID", prs::Tokens::KW_AVOID },
+		{ "KW_REJECT", prs::Tokens::KW_REJECT },
+		{ "KW_NOFOLLOW", prs::Tokens::KW_NOFOLLOW },
 		{ "CH_SEMICOLON", prs::Tokens::CH_SEMICOLON },
 		{ "CH_AT", prs::Tokens::CH_AT },
 		{ "CH_COLON", prs::Tokens::CH_COLON },
@@ -970,8 +966,8 @@ namespace {
 		{ "KW_TOKEN NAME TypeOpt CH_SEMICOLON", SyntaxRule::TerminalDeclaration__KWTOKEN_NAME_TypeOpt_CHSEMICOLON },
 		
 		{ "NonterminalDeclaration", SyntaxRule::NONE },
-		{ "AtOpt NAME TypeOpt CH_COLON SyntaxOrExpression CH_SEMICOLON",
-			SyntaxRule::NonterminalDeclaration__AtOpt_NAME_TypeOpt_CHCOLON_SyntaxOrExpression_CHSEMICOLON },
+		{ "AtOpt NAME TypeOpt NoFollowOpt CH_COLON SyntaxOrExpression CH_SEMICOLON",
+			SyntaxRule::NonterminalDeclaration__AtOpt_NAME_TypeOpt_NoFollowOpt_CHCOLON_SyntaxOrExpression_CHSEMICOLON },
 
 		{ "CustomTerminalTypeDeclaration", SyntaxRule::NONE },
 		{ "KW_TOKEN STRING Type CH_SEMICOLON", SyntaxRule::CustomTerminalTypeDeclaration__KWTOKEN_STRING_Type_CHSEMICOLON },
@@ -979,6 +975,18 @@ namespace {
 		{ "AtOpt", SyntaxRule::NONE },
 		{ "CH_AT", SyntaxRule::AtOpt__CHAT },
 		{ "", SyntaxRule::AtOpt__ },
+
+		{ "NoFollowOpt", SyntaxRule::NONE },
+		{ "KW_NOFOLLOW CH_OPAREN NoFollowList CH_CPAREN", SyntaxRule::NoFollowOpt__KWNOFOLLOW_CHOPAREN_NoFollowList_CHCPAREN },
+		{ "", SyntaxRule::NoFollowOpt__ },
+
+		{ "NoFollowList", SyntaxRule::NONE },
+		{ "NoFollowTerm", SyntaxRule::NoFollowList__NoFollowTerm },
+		{ "NoFollowList NoFollowTerm", SyntaxRule::NoFollowList__NoFollowList_NoFollowTerm },
+
+		{ "NoFollowTerm", SyntaxRule::NONE },
+		{ "NameSyntaxTerm", SyntaxRule::NoFollowTerm__NameSyntaxTerm },
+		{ "StringSyntaxTerm", SyntaxRule::NoFollowTerm__StringSyntaxTerm },
 		
 		{ "TypeOpt", SyntaxRule::NONE },
 		{ "Type", SyntaxRule::TypeOpt__Type },
@@ -996,7 +1004,13 @@ namespace {
 			SyntaxRule::SyntaxAndExpressionList__SyntaxAndExpressionList_CHOR_SyntaxAndExpression },
 		
 		{ "SyntaxAndExpression", SyntaxRule::NONE },
-		{ "SyntaxElementListOpt TypeOpt", SyntaxRule::SyntaxAndExpression__SyntaxElementListOpt_TypeOpt },
+		{ "SyntaxElementListOpt TypeOpt PrFilterOpt", SyntaxRule::SyntaxAndExpression__SyntaxElementListOpt_TypeOpt_PrFilterOpt },
+
+		{ "PrFilterOpt", SyntaxRule::NONE },
+		{ "KW_PREFER", SyntaxRule::PrFilterOpt__KWPREFER },
+		{ "KW_AVOID", SyntaxRule::PrFilterOpt__KWAVOID },
+		{ "KW_REJECT", SyntaxRule::PrFilterOpt__KWREJECT },
+		{ "", SyntaxRule::PrFilterOpt__ },
 		
 		{ "SyntaxElementListOpt", SyntaxRule::NONE },
 		{ "SyntaxElementList", SyntaxRule::SyntaxElementListOpt__SyntaxElementList },
@@ -1180,6 +1194,14 @@ namespace {
 			return m_states;
 		}
 
+		const std::vector<Shift>& get_shifts() const {
+			return m_shifts;
+		}
+
+		const std::vector<Goto>& get_gotos() const {
+			return m_gotos;
+		}
+
 		const std::vector<Reduce>& get_reduces() const {
 			return m_reduces;
 		}
@@ -1413,27 +1435,258 @@ namespace {
 
 }
 
+namespace {
+
+	unique_ptr<const BnfGrm> create_raw_grammar() {
+		return RawPrs::raw_grammar_to_bnf(g_raw_tokens, g_raw_rules, SyntaxRule::NONE);
+	}
+
+	unique_ptr<CoreTables> create_raw_core_tables(const BnfGrm* bnf_grammar) {
+		std::vector<const BnfGrm::Nt*> start_nts;
+		start_nts.push_back(bnf_grammar->get_nonterminals()[0]);
+		unique_ptr<const LRTbl> lrtables = ns::create_LR_tables(*bnf_grammar, start_nts, false);
+		return create_core_tables(bnf_grammar, lrtables.get());
+	}
+
+	const char g_tables_file_header[] =
+		"/*\n"
+		" * Copyright 2014 Anton Karmanov\n"
+		" *\n"
+		" * Licensed under the Apache License, Version 2.0 (the \"License\");\n"
+		" * you may not use this file except in compliance with the License.\n"
+		" * You may obtain a copy of the License at\n"
+		" * \n"
+		" *     http://www.apache.org/licenses/LICENSE-2.0\n"
+		" * \n"
+		" * Unless required by applicable law or agreed to in writing, software\n"
+		" * distributed under the License is distributed on an \"AS IS\" BASIS,\n"
+		" * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.\n"
+		" * See the License for the specific language governing permissions and\n"
+		" * limitations under the License.\n"
+		" */\n"
+		"\n"
+		"//LR tables of the grammar file syntax.\n"
+		"//Generated by \"syn -G grm_tables.cpp\" from the rules in grm_parser.cpp - do not edit.\n"
+		"\n"
+		"#include \"grm_parser_impl.h\"\n"
+		"#include \"syn.h\"\n"
+		"\n"
+		"namespace prs = synbin::grm_parser;\n"
+		"\n"
+		"using syn::State;\n"
+		"using syn::Shift;\n"
+		"using syn::Goto;\n"
+		"using syn::Reduce;\n"
+		"using prs::Tokens;\n"
+		"\n";
+
+	const char* get_sym_type_name(State::SymType sym_type) {
+		if (State::sym_tk_value == sym_type) return "State::sym_tk_value";
+		if (State::sym_nt == sym_type) return "State::sym_nt";
+		return "State::sym_none";
+	}
+
+	//
+	//TablesWriter
+	//
+
+	//Writes core tables as C++ code, in the form similar to the one of the generated parsers.
+	class TablesWriter {
+		NONCOPYABLE(TablesWriter);
+
+		const BnfGrm* const m_bnf_grammar;
+		const CoreTables* const m_core_tables;
+		std::ostream& m_out;
+
+		std::map<prs::Tokens::E, const char*> m_token_names;
+		std::map<syn::InternalAction, const BnfGrm::Pr*> m_productions;
+
+		std::size_t state_index(const State* state) const {
+			return state - m_core_tables->get_states().data();
+		}
+
+		void write_states() {
+			const std::vector<State>& states = m_core_tables->get_states();
+			m_out << "const State prs::Tables::states[] = {\n";
+			for (const State& state : states) {
+				m_out << "\t{ " << state.m_index;
+				m_out << ", &shifts[" << (state.m_shifts - m_core_tables->get_shifts().data()) << "]";
+				m_out << ", &gotos[" << (state.m_gotos - m_core_tables->get_gotos().data()) << "]";
+				m_out << ", &reduces[" << (state.m_reduces - m_core_tables->get_reduces().data()) << "]";
+				m_out << ", " << get_sym_type_name(state.m_sym_type) << " },\n";
+			}
+			m_out << "};\n\n";
+		}
+
+		void write_shifts() {
+			m_out << "const Shift prs::Tables::shifts[] = {\n";
+			for (const Shift& shift : m_core_tables->get_shifts()) {
+				if (shift.m_state) {
+					const char* name = m_token_names[static_cast<prs::Tokens::E>(shift.m_token)];
+					m_out << "\t{ &states[" << state_index(shift.m_state) << "], Tokens::" << name << " },\n";
+				} else {
+					m_out << "\t{ nullptr, 0 },\n";
+				}
+			}
+			m_out << "};\n\n";
+		}
+
+		void write_gotos() {
+			const std::vector<const BnfGrm::Nt*>& nts = m_bnf_grammar->get_nonterminals();
+			m_out << "const Goto prs::Tables::gotos[] = {\n";
+			for (const Goto& got : m_core_tables->get_gotos()) {
+				if (got.m_state) {
+					m_out << "\t{ &states[" << state_index(got.m_state) << "], " << got.m_nt << " }, //";
+					m_out << nts[got.m_nt]->get_name() << "\n";
+				} else {
+					m_out << "\t{ nullptr, 0 },\n";
+				}
+			}
+			m_out << "};\n\n";
+		}
+
+		void write_reduces() {
+			m_out << "const Reduce prs::Tables::reduces[] = {\n";
+			for (const Reduce& reduce : m_core_tables->get_reduces()) {
+				if (syn::NULL_ACTION == reduce.m_action) {
+					m_out << "\t{ 0, 0, syn::NULL_ACTION },\n";
+				} else if (syn::ACCEPT_ACTION == reduce.m_action) {
+					m_out << "\t{ 0, 0, syn::ACCEPT_ACTION },\n";
+				} else {
+					const BnfGrm::Pr* pr = m_productions[reduce.m_action];
+					m_out << "\t{ " << reduce.m_length << ", " << reduce.m_nt << ", " << reduce.m_action << " }, //";
+					m_out << pr->get_nt()->get_name() << " :";
+					for (const BnfGrm::Sym* sym : pr->get_elements()) m_out << " " << sym->get_name();
+					m_out << "\n";
+				}
+			}
+			m_out << "};\n\n";
+		}
+
+		void write_count(const char* name) {
+			m_out << "const std::size_t prs::Tables::" << name << "_count = ";
+			m_out << "sizeof(" << name << ") / sizeof(" << name << "[0]);\n";
+		}
+
+	public:
+		TablesWriter(const BnfGrm* bnf_grammar, const CoreTables* core_tables, std::ostream& out)
+			: m_bnf_grammar(bnf_grammar),
+			m_core_tables(core_tables),
+			m_out(out)
+		{
+			for (const RawTr* raw_token = g_raw_tokens; raw_token->m_name; ++raw_token) {
+				m_token_names[raw_token->m_tr_obj] = raw_token->m_name;
+			}
+			m_token_names[prs::Tokens::END_OF_FILE] = "END_OF_FILE";
+
+			for (const BnfGrm::Pr* pr : bnf_grammar->get_productions()) {
+				m_productions[static_cast<syn::InternalAction>(pr->get_pr_obj())] = pr;
+			}
+		}
+
+		void write() {
+			m_out << g_tables_file_header;
+			write_states();
+			write_shifts();
+			write_gotos();
+			write_reduces();
+			m_out << "const State* const prs::Tables::start_state = &states[";
+			m_out << state_index(m_core_tables->get_start_state()) << "];\n\n";
+			write_count("states");
+			write_count("shifts");
+			write_count("gotos");
+			write_count("reduces");
+		}
+	};
+
+	//Checks that a list of a static state and a list of a built state start at the same position.
+	template<class T>
+	bool equal_offsets(const T* a, const T* static_table, const T* b, const std::vector<T>& table) {
+		return a - static_table == b - table.data();
+	}
+
+	bool equal_states(const State* a, const State* b, const CoreTables* core_tables) {
+		if (!a || !b) return a == b;
+		return a - prs::Tables::states == b - core_tables->get_states().data();
+	}
+
+	template<class T, class P>
+	bool equal_lists(const T* a, const T* b, P pred) {
+		for (;;) {
+			if (!pred(*a, *b)) return false;
+			if (!a->m_state) return true;
+			++a;
+			++b;
+		}
+	}
+
+}
+
 //
-//parse_grammar()
+//generate_tables(), check_tables()
 //
 
-unique_ptr<ns::GrammarParsingResult> prs::parse_grammar(std::istream& in, const util::String& file_name) {
+void prs::generate_tables(std::ostream& out) {
+	unique_ptr<const BnfGrm> bnf_grammar = create_raw_grammar();
+	unique_ptr<const CoreTables> core_tables = create_raw_core_tables(bnf_grammar.get());
+	TablesWriter writer(bnf_grammar.get(), core_tables.get(), out);
+	writer.write();
+}
+
+bool prs::check_tables() {
+	unique_ptr<const BnfGrm> bnf_grammar = create_raw_grammar();
+	unique_ptr<const CoreTables> core_tables = create_raw_core_tables(bnf_grammar.get());
+	const CoreTables* tables = core_tables.get();
 
-	//Create BNF grammar.
-	unique_ptr<const BnfGrm> bnf_grammar = RawPrs::raw_grammar_to_bnf(g_raw_tokens, g_raw_rules, SyntaxRule::NONE);
+	//The sizes and the positions of the lists are compared first, so the static tables are never read out of
+	//bounds when the grammar has changed.
+	if (tables->get_states().size() != Tables::states_count) return false;
+	if (tables->get_shifts().size() != Tables::shifts_count) return false;
+	if (tables->get_gotos().size() != Tables::gotos_count) return false;
+	if (tables->get_reduces().size() != Tables::reduces_count) return false;
 
-	//Create LR tables.
-	std::vector<const BnfGrm::Nt*> start_nts;
-	start_nts.push_back(bnf_grammar->get_nonterminals()[0]);
-	unique_ptr<const LRTbl> lrtables = ns::create_LR_tables(*bnf_grammar.get(), start_nts, false);
+	if (!equal_states(Tables::start_state, tables->get_start_state(), tables)) return false;
+
+	for (const State& state : tables->get_states()) {
+		if (state.m_index >= Tables::states_count) return false;
+		const State& static_state = Tables::states[state.m_index];
+		if (static_state.m_index != state.m_index || static_state.m_sym_type != state.m_sym_type) return false;
+
+		if (!equal_offsets(static_state.m_shifts, Tables::shifts, state.m_shifts, tables->get_shifts())) return false;
+		if (!equal_offsets(static_state.m_gotos, Tables::gotos, state.m_gotos, tables->get_gotos())) return false;
+		if (!equal_offsets(static_state.m_reduces, Tables::reduces, state.m_reduces, tables->get_reduces())) {
+			return false;
+		}
+
+		auto shift_pred = [tables](const Shift& a, const Shift& b) {
+			return a.m_token == b.m_token && equal_states(a.m_state, b.m_state, tables);
+		};
+		if (!equal_lists(static_state.m_shifts, state.m_shifts, shift_pred)) return false;
+
+		auto goto_pred = [tables](const Goto& a, const Goto& b) {
+			return a.m_nt == b.m_nt && equal_states(a.m_state, b.m_state, tables);
+		};
+		if (!equal_lists(static_state.m_gotos, state.m_gotos, goto_pred)) return false;
+
+		for (const Reduce* a = static_state.m_reduces, *b = state.m_reduces; ; ++a, ++b) {
+			if (a->m_length != b->m_length || a->m_nt != b->m_nt || a->m_action != b->m_action) return false;
+			if (syn::NULL_ACTION == a->m_action) break;
+		}
+	}
+
+	return true;
+}
+
+//
+//parse_grammar()
+//
+
+unique_ptr<ns::GrammarParsingResult> prs::parse_grammar(std::istream& in, const util::String& file_name) {
 
 	//Create managed heap.
 	unique_ptr<MHeap> managed_heap(new MHeap());
 	unique_ptr<MHeap> const_managed_heap(new MHeap());
 
-	//Create core tables.
-	unique_ptr<const CoreTables> core_tables(create_core_tables(bnf_grammar.get(), lrtables.get()));
-
 	//Parse.
 	prs::Scanner scanner(in, file_name);
 	InternalScanner internal_scanner(scanner);
@@ -1442,7 +1695,7 @@ unique_ptr<ns::GrammarParsingResult> prs::parse_grammar(std::istream& in, const
 	try {
 		std::unique_ptr<syn::ParserInterface> parser = syn::ParserInterface::create();
 		syn::StackElement_Nt* root_element = parser->parse(
-			core_tables->get_start_state(),
+			Tables::start_state,
 			internal_scanner,
 			static_cast<syn::InternalTk>(Tokens::END_OF_FILE)
 		);
@@ -20,6 +20,7 @@
 #define SYN_CORE_GRM_PARSER_H_INCLUDED
 
 #include <memory>
+#include <ostream>
 #include <string>
 
 #include "commons.h"
@@ -52,6 +53,9 @@ namespace synbin {
 
 		//Parse EBNF grammar.
 		std::unique_ptr<GrammarParsingResult> parse_grammar(std::istream& in, const util::String& file_name);
+
+		//Builds LR tables of the grammar file syntax and writes them as C++ code (the contents of grm_tables.cpp).
+		void generate_tables(std::ostream& out);
 	
 	}
 }
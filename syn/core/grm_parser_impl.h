@@ -19,6 +19,7 @@
 #ifndef SYN_CORE_GRM_PARSER_IMPL_H_INCLUDED
 #define SYN_CORE_GRM_PARSER_IMPL_H_INCLUDED
 
+#include <cstddef>
 #include <istream>
 #include <vector>
 
@@ -28,6 +29,15 @@
 #include "primitives.h"
 #include "util_string.h"
 
+namespace syn {
+
+	struct Shift;
+	struct Goto;
+	struct Reduce;
+	struct State;
+
+}
+
 namespace synbin {
 	namespace grm_parser {
 
@@ -51,6 +61,10 @@ namespace synbin {
 				KW_THIS,
 				KW_FALSE,
 				KW_TRUE,
+				KW_PREFER,
+				KW_AVOID,
+				KW_REJECT,
+				KW_NOFOLLOW,
 
 				CH_SEMICOLON,
 				CH_AT,
@@ -73,6 +87,124 @@ namespace synbin {
 			};
 		};
 
+		//
+		//SyntaxRule
+		//
+
+		//Productions of the grammar file syntax. Values are used as actions in the LR tables.
+		enum class SyntaxRule {
+			NONE,
+			Grammar__DeclarationList,
+			DeclarationList__Declaration,
+			DeclarationList__DeclarationList_Declaration,
+			Declaration__TypeDeclaration,
+			Declaration__TerminalDeclaration,
+			Declaration__NonterminalDeclaration,
+			Declaration__CustomTerminalTypeDeclaration,
+			TypeDeclaration__KWTYPE_NAME_CHSEMICOLON,
+			TerminalDeclaration__KWTOKEN_NAME_TypeOpt_CHSEMICOLON,
+			NonterminalDeclaration__AtOpt_NAME_TypeOpt_NoFollowOpt_CHCOLON_SyntaxOrExpression_CHSEMICOLON,
+			CustomTerminalTypeDeclaration__KWTOKEN_STRING_Type_CHSEMICOLON,
+			AtOpt__CHAT,
+			AtOpt__,
+			NoFollowOpt__KWNOFOLLOW_CHOPAREN_NoFollowList_CHCPAREN,
+			NoFollowOpt__,
+			NoFollowList__NoFollowTerm,
+			NoFollowList__NoFollowList_NoFollowTerm,
+			NoFollowTerm__NameSyntaxTerm,
+			NoFollowTerm__StringSyntaxTerm,
+			TypeOpt__Type,
+			TypeOpt__,
+			Type__CHOBRACE_NAME_CHCBRACE,
+			SyntaxOrExpression__SyntaxAndExpressionList,
+			SyntaxAndExpressionList__SyntaxAndExpression,
+			SyntaxAndExpressionList__SyntaxAndExpressionList_CHOR_SyntaxAndExpression,
+			SyntaxAndExpression__SyntaxElementListOpt_TypeOpt_PrFilterOpt,
+			PrFilterOpt__KWPREFER,
+			PrFilterOpt__KWAVOID,
+			PrFilterOpt__KWREJECT,
+			PrFilterOpt__,
+			SyntaxElementListOpt__SyntaxElementList,
+			SyntaxElementListOpt__,
+			SyntaxElementList__SyntaxElement,
+			SyntaxElementList__SyntaxElementList_SyntaxElement,
+			SyntaxElement__NameSyntaxElement,
+			SyntaxElement__ThisSyntaxElement,
+			NameSyntaxElement__NAME_CHEQ_SyntaxTerm,
+			NameSyntaxElement__SyntaxTerm,
+			ThisSyntaxElement__KWTHIS_CHEQ_SyntaxTerm,
+			SyntaxTerm__PrimarySyntaxTerm,
+			SyntaxTerm__AdvanvedSyntaxTerm,
+			PrimarySyntaxTerm__NameSyntaxTerm,
+			PrimarySyntaxTerm__StringSyntaxTerm,
+			PrimarySyntaxTerm__NestedSyntaxTerm,
+			NameSyntaxTerm__NAME,
+			StringSyntaxTerm__STRING,
+			NestedSyntaxTerm__TypeOpt_CHOPAREN_SyntaxOrExpression_CHCPAREN,
+			AdvanvedSyntaxTerm__ZeroOneSyntaxTerm,
+			AdvanvedSyntaxTerm__ZeroManySyntaxTerm,
+			AdvanvedSyntaxTerm__OneManySyntaxTerm,
+			AdvanvedSyntaxTerm__ConstSyntaxTerm,
+			ZeroOneSyntaxTerm__PrimarySyntaxTerm_CHQUESTION,
+			ZeroManySyntaxTerm__LoopBody_CHASTERISK,
+			OneManySyntaxTerm__LoopBody_CHPLUS,
+			LoopBody__SimpleLoopBody,
+			LoopBody__AdvancedLoopBody,
+			SimpleLoopBody__PrimarySyntaxTerm,
+			AdvancedLoopBody__CHOPAREN_SyntaxOrExpression_CHCOLON_SyntaxOrExpression_CHCPAREN,
+			AdvancedLoopBody__CHOPAREN_SyntaxOrExpression_CHCPAREN,
+			ConstSyntaxTerm__CHLT_ConstExpression_CHGT,
+			ConstExpression__IntegerConstExpression,
+			ConstExpression__StringConstExpression,
+			ConstExpression__BooleanConstExpression,
+			ConstExpression__NativeConstExpression,
+			IntegerConstExpression__NUMBER,
+			StringConstExpression__STRING,
+			BooleanConstExpression__KWFALSE,
+			BooleanConstExpression__KWTRUE,
+			NativeConstExpression__NativeQualificationOpt_NativeName_NativeReferencesOpt,
+			NativeQualificationOpt__NativeQualification,
+			NativeQualificationOpt__,
+			NativeQualification__NAME_CHCOLONCOLON,
+			NativeQualification__NativeQualification_NAME_CHCOLONCOLON,
+			NativeReferencesOpt__NativeReferences,
+			NativeReferencesOpt__,
+			NativeReferences__NativeReference,
+			NativeReferences__NativeReferences_NativeReference,
+			NativeName__NativeVariableName,
+			NativeName__NativeFunctionName,
+			NativeVariableName__NAME,
+			NativeFunctionName__NAME_CHOPAREN_ConstExpressionListOpt_CHCPAREN,
+			ConstExpressionListOpt__ConstExpressionList,
+			ConstExpressionListOpt__,
+			ConstExpressionList__ConstExpression,
+			ConstExpressionList__ConstExpressionList_CHCOMMA_ConstExpression,
+			NativeReference__CHDOT_NativeName,
+			NativeReference__CHMINUSGT_NativeName,
+			LAST
+		};
+
+		//
+		//Tables
+		//
+
+		//LR tables of the grammar file syntax, generated by generate_tables() into grm_tables.cpp.
+		struct Tables {
+			static const syn::State states[];
+			static const syn::Shift shifts[];
+			static const syn::Goto gotos[];
+			static const syn::Reduce reduces[];
+			static const syn::State* const start_state;
+
+			static const std::size_t states_count;
+			static const std::size_t shifts_count;
+			static const std::size_t gotos_count;
+			static const std::size_t reduces_count;
+		};
+
+		//Checks that Tables match the tables built from the grammar file syntax rules.
+		bool check_tables();
+
 		typedef int token_number;
 
 		//
@@ -41,6 +41,10 @@ namespace {
 	const std::string g_keyword_this = "this";
 	const std::string g_keyword_true = "true";
 	const std::string g_keyword_false = "false";
+	const std::string g_keyword_prefer = "prefer";
+	const std::string g_keyword_avoid = "avoid";
+	const std::string g_keyword_reject = "reject";
+	const std::string g_keyword_nofollow = "nofollow";
 
 	const prs::token_number g_max_number = std::numeric_limits<prs::token_number>::max();
 	const prs::token_number g_max_number_div_10 = g_max_number / 10;
@@ -203,6 +207,14 @@ void prs::Scanner::scan_keyword(TokenRecord* token_record) {
 		token_record->token = Tokens::KW_TYPE;
 	} else if (g_keyword_class == m_string_buffer) {
 		token_record->token = Tokens::KW_CLASS;
+	} else if (g_keyword_prefer == m_string_buffer) {
+		token_record->token = Tokens::KW_PREFER;
+	} else if (g_keyword_avoid == m_string_buffer) {
+		token_record->token = Tokens::KW_AVOID;
+	} else if (g_keyword_reject == m_string_buffer) {
+		token_record->token = Tokens::KW_REJECT;
+	} else if (g_keyword_nofollow == m_string_buffer) {
+		token_record->token = Tokens::KW_NOFOLLOW;
 	} else {
 		token_record->token = Tokens::NAME;
 		FilePos file_pos(m_file_name, token_record->pos);
@@ -0,0 +1,1004 @@
+/*
+ * Copyright 2014 Anton Karmanov
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//LR tables of the grammar file syntax.
+//Generated by "syn -G grm_tables.cpp" from the rules in grm_parser.cpp - do not edit.
+
+#include "grm_parser_impl.h"
+#include "syn.h"
+
+namespace prs = synbin::grm_parser;
+
+using syn::State;
+using syn::Shift;
+using syn::Goto;
+using syn::Reduce;
+using prs::Tokens;
+
+const State prs::Tables::states[] = {
+	{ 0, &shifts[0], &gotos[0], &reduces[0], State::sym_none },
+	{ 1, &shifts[4], &gotos[9], &reduces[2], State::sym_none },
+	{ 2, &shifts[7], &gotos[10], &reduces[3], State::sym_none },
+	{ 3, &shifts[9], &gotos[11], &reduces[4], State::sym_none },
+	{ 4, &shifts[10], &gotos[12], &reduces[6], State::sym_nt },
+	{ 5, &shifts[11], &gotos[13], &reduces[8], State::sym_nt },
+	{ 6, &shifts[15], &gotos[20], &reduces[11], State::sym_nt },
+	{ 7, &shifts[16], &gotos[21], &reduces[13], State::sym_nt },
+	{ 8, &shifts[17], &gotos[22], &reduces[15], State::sym_nt },
+	{ 9, &shifts[18], &gotos[23], &reduces[17], State::sym_nt },
+	{ 10, &shifts[19], &gotos[24], &reduces[19], State::sym_nt },
+	{ 11, &shifts[20], &gotos[25], &reduces[21], State::sym_nt },
+	{ 12, &shifts[22], &gotos[26], &reduces[22], State::sym_tk_value },
+	{ 13, &shifts[24], &gotos[29], &reduces[24], State::sym_tk_value },
+	{ 14, &shifts[26], &gotos[31], &reduces[25], State::sym_tk_value },
+	{ 15, &shifts[28], &gotos[32], &reduces[26], State::sym_nt },
+	{ 16, &shifts[29], &gotos[33], &reduces[28], State::sym_tk_value },
+	{ 17, &shifts[31], &gotos[36], &reduces[30], State::sym_none },
+	{ 18, &shifts[33], &gotos[37], &reduces[31], State::sym_nt },
+	{ 19, &shifts[35], &gotos[38], &reduces[32], State::sym_nt },
+	{ 20, &shifts[36], &gotos[39], &reduces[34], State::sym_nt },
+	{ 21, &shifts[38], &gotos[40], &reduces[35], State::sym_none },
+	{ 22, &shifts[39], &gotos[41], &reduces[37], State::sym_nt },
+	{ 23, &shifts[41], &gotos[43], &reduces[39], State::sym_tk_value },
+	{ 24, &shifts[43], &gotos[44], &reduces[40], State::sym_none },
+	{ 25, &shifts[44], &gotos[45], &reduces[42], State::sym_none },
+	{ 26, &shifts[45], &gotos[46], &reduces[44], State::sym_none },
+	{ 27, &shifts[47], &gotos[47], &reduces[45], State::sym_nt },
+	{ 28, &shifts[49], &gotos[48], &reduces[46], State::sym_none },
+	{ 29, &shifts[50], &gotos[49], &reduces[48], State::sym_none },
+	{ 30, &shifts[53], &gotos[54], &reduces[49], State::sym_none },
+	{ 31, &shifts[61], &gotos[78], &reduces[52], State::sym_tk_value },
+	{ 32, &shifts[62], &gotos[79], &reduces[54], State::sym_tk_value },
+	{ 33, &shifts[63], &gotos[80], &reduces[56], State::sym_nt },
+	{ 34, &shifts[67], &gotos[84], &reduces[57], State::sym_nt },
+	{ 35, &shifts[68], &gotos[85], &reduces[59], State::sym_nt },
+	{ 36, &shifts[69], &gotos[86], &reduces[61], State::sym_nt },
+	{ 37, &shifts[70], &gotos[87], &reduces[63], State::sym_tk_value },
+	{ 38, &shifts[72], &gotos[88], &reduces[64], State::sym_none },
+	{ 39, &shifts[74], &gotos[89], &reduces[65], State::sym_none },
+	{ 40, &shifts[82], &gotos[113], &reduces[68], State::sym_none },
+	{ 41, &shifts[88], &gotos[121], &reduces[70], State::sym_nt },
+	{ 42, &shifts[90], &gotos[122], &reduces[71], State::sym_nt },
+	{ 43, &shifts[92], &gotos[123], &reduces[72], State::sym_nt },
+	{ 44, &shifts[94], &gotos[124], &reduces[74], State::sym_nt },
+	{ 45, &shifts[95], &gotos[125], &reduces[76], State::sym_nt },
+	{ 46, &shifts[97], &gotos[128], &reduces[78], State::sym_nt },
+	{ 47, &shifts[104], &gotos[147], &reduces[81], State::sym_nt },
+	{ 48, &shifts[105], &gotos[148], &reduces[83], State::sym_nt },
+	{ 49, &shifts[106], &gotos[149], &reduces[85], State::sym_nt },
+	{ 50, &shifts[107], &gotos[150], &reduces[87], State::sym_nt },
+	{ 51, &shifts[108], &gotos[151], &reduces[89], State::sym_nt },
+	{ 52, &shifts[110], &gotos[152], &reduces[92], State::sym_nt },
+	{ 53, &shifts[111], &gotos[153], &reduces[94], State::sym_nt },
+	{ 54, &shifts[112], &gotos[154], &reduces[96], State::sym_nt },
+	{ 55, &shifts[113], &gotos[155], &reduces[98], State::sym_nt },
+	{ 56, &shifts[114], &gotos[156], &reduces[100], State::sym_nt },
+	{ 57, &shifts[115], &gotos[157], &reduces[102], State::sym_nt },
+	{ 58, &shifts[116], &gotos[158], &reduces[104], State::sym_nt },
+	{ 59, &shifts[117], &gotos[159], &reduces[106], State::sym_nt },
+	{ 60, &shifts[120], &gotos[160], &reduces[107], State::sym_nt },
+	{ 61, &shifts[121], &gotos[161], &reduces[109], State::sym_nt },
+	{ 62, &shifts[122], &gotos[162], &reduces[111], State::sym_nt },
+	{ 63, &shifts[123], &gotos[163], &reduces[113], State::sym_none },
+	{ 64, &shifts[124], &gotos[164], &reduces[115], State::sym_nt },
+	{ 65, &shifts[125], &gotos[165], &reduces[117], State::sym_none },
+	{ 66, &shifts[131], &gotos[181], &reduces[119], State::sym_none },
+	{ 67, &shifts[137], &gotos[197], &reduces[121], State::sym_nt },
+	{ 68, &shifts[140], &gotos[198], &reduces[122], State::sym_tk_value },
+	{ 69, &shifts[142], &gotos[199], &reduces[123], State::sym_tk_value },
+	{ 70, &shifts[143], &gotos[200], &reduces[125], State::sym_tk_value },
+	{ 71, &shifts[144], &gotos[201], &reduces[127], State::sym_none },
+	{ 72, &shifts[145], &gotos[202], &reduces[129], State::sym_none },
+	{ 73, &shifts[146], &gotos[203], &reduces[131], State::sym_nt },
+	{ 74, &shifts[148], &gotos[204], &reduces[132], State::sym_nt },
+	{ 75, &shifts[149], &gotos[205], &reduces[134], State::sym_nt },
+	{ 76, &shifts[150], &gotos[206], &reduces[136], State::sym_nt },
+	{ 77, &shifts[151], &gotos[207], &reduces[138], State::sym_nt },
+	{ 78, &shifts[152], &gotos[208], &reduces[140], State::sym_nt },
+	{ 79, &shifts[154], &gotos[212], &reduces[141], State::sym_nt },
+	{ 80, &shifts[156], &gotos[213], &reduces[143], State::sym_none },
+	{ 81, &shifts[164], &gotos[237], &reduces[146], State::sym_none },
+	{ 82, &shifts[165], &gotos[238], &reduces[148], State::sym_none },
+	{ 83, &shifts[173], &gotos[260], &reduces[151], State::sym_nt },
+	{ 84, &shifts[177], &gotos[262], &reduces[153], State::sym_tk_value },
+	{ 85, &shifts[179], &gotos[263], &reduces[155], State::sym_nt },
+	{ 86, &shifts[180], &gotos[264], &reduces[157], State::sym_none },
+	{ 87, &shifts[181], &gotos[265], &reduces[159], State::sym_none },
+	{ 88, &shifts[182], &gotos[266], &reduces[161], State::sym_none },
+	{ 89, &shifts[183], &gotos[267], &reduces[163], State::sym_nt },
+	{ 90, &shifts[184], &gotos[268], &reduces[165], State::sym_nt },
+	{ 91, &shifts[185], &gotos[269], &reduces[167], State::sym_none },
+	{ 92, &shifts[193], &gotos[293], &reduces[170], State::sym_none },
+	{ 93, &shifts[194], &gotos[294], &reduces[172], State::sym_none },
+	{ 94, &shifts[195], &gotos[295], &reduces[174], State::sym_none },
+	{ 95, &shifts[196], &gotos[296], &reduces[176], State::sym_tk_value },
+	{ 96, &shifts[198], &gotos[297], &reduces[178], State::sym_nt },
+	{ 97, &shifts[201], &gotos[301], &reduces[180], State::sym_nt },
+	{ 98, &shifts[202], &gotos[302], &reduces[182], State::sym_nt },
+	{ 99, &shifts[203], &gotos[303], &reduces[184], State::sym_tk_value },
+	{ 100, &shifts[205], &gotos[304], &reduces[185], State::sym_nt },
+	{ 101, &shifts[207], &gotos[305], &reduces[186], State::sym_nt },
+	{ 102, &shifts[208], &gotos[306], &reduces[188], State::sym_none },
+	{ 103, &shifts[209], &gotos[307], &reduces[190], State::sym_none },
+	{ 104, &shifts[210], &gotos[308], &reduces[192], State::sym_none },
+	{ 105, &shifts[211], &gotos[309], &reduces[194], State::sym_nt },
+	{ 106, &shifts[212], &gotos[310], &reduces[196], State::sym_nt },
+	{ 107, &shifts[214], &gotos[311], &reduces[197], State::sym_none },
+	{ 108, &shifts[220], &gotos[321], &reduces[200], State::sym_none },
+	{ 109, &shifts[222], &gotos[325], &reduces[201], State::sym_none },
+	{ 110, &shifts[224], &gotos[329], &reduces[202], State::sym_nt },
+	{ 111, &shifts[225], &gotos[330], &reduces[204], State::sym_nt },
+	{ 112, &shifts[228], &gotos[332], &reduces[206], State::sym_nt },
+	{ 113, &shifts[229], &gotos[333], &reduces[208], State::sym_none },
+	{ 114, &shifts[230], &gotos[334], &reduces[210], State::sym_none },
+	{ 115, &shifts[231], &gotos[335], &reduces[212], State::sym_none },
+	{ 116, &shifts[232], &gotos[336], &reduces[214], State::sym_nt },
+	{ 117, &shifts[233], &gotos[337], &reduces[216], State::sym_nt },
+	{ 118, &shifts[235], &gotos[338], &reduces[217], State::sym_nt },
+	{ 119, &shifts[237], &gotos[339], &reduces[219], State::sym_nt },
+	{ 120, &shifts[238], &gotos[340], &reduces[221], State::sym_nt },
+	{ 121, &shifts[239], &gotos[341], &reduces[223], State::sym_nt },
+	{ 122, &shifts[240], &gotos[342], &reduces[225], State::sym_none },
+	{ 123, &shifts[241], &gotos[343], &reduces[227], State::sym_none },
+	{ 124, &shifts[247], &gotos[351], &reduces[229], State::sym_nt },
+};
+
+const Shift prs::Tables::shifts[] = {
+	{ &states[1], Tokens::KW_TOKEN },
+	{ &states[2], Tokens::KW_TYPE },
+	{ &states[3], Tokens::CH_AT },
+	{ nullptr, 0 },
+	{ &states[12], Tokens::NAME },
+	{ &states[13], Tokens::STRING },
+	{ nullptr, 0 },
+	{ &states[14], Tokens::NAME },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ &states[1], Tokens::KW_TOKEN },
+	{ &states[2], Tokens::KW_TYPE },
+	{ &states[3], Tokens::CH_AT },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ &states[16], Tokens::NAME },
+	{ nullptr, 0 },
+	{ &states[17], Tokens::CH_OBRACE },
+	{ nullptr, 0 },
+	{ &states[17], Tokens::CH_OBRACE },
+	{ nullptr, 0 },
+	{ &states[21], Tokens::CH_SEMICOLON },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ &states[17], Tokens::CH_OBRACE },
+	{ nullptr, 0 },
+	{ &states[23], Tokens::NAME },
+	{ nullptr, 0 },
+	{ &states[24], Tokens::CH_SEMICOLON },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ &states[25], Tokens::CH_SEMICOLON },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ &states[26], Tokens::KW_NOFOLLOW },
+	{ nullptr, 0 },
+	{ &states[28], Tokens::CH_CBRACE },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ &states[29], Tokens::CH_OPAREN },
+	{ nullptr, 0 },
+	{ &states[30], Tokens::CH_COLON },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ &states[31], Tokens::NAME },
+	{ &states[32], Tokens::STRING },
+	{ nullptr, 0 },
+	{ &states[37], Tokens::NAME },
+	{ &states[31], Tokens::NAME },
+	{ &states[32], Tokens::STRING },
+	{ &states[38], Tokens::KW_THIS },
+	{ &states[17], Tokens::CH_OBRACE },
+	{ &states[39], Tokens::CH_OPAREN },
+	{ &states[40], Tokens::CH_LT },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ &states[31], Tokens::NAME },
+	{ &states[32], Tokens::STRING },
+	{ &states[63], Tokens::CH_CPAREN },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ &states[65], Tokens::CH_EQ },
+	{ nullptr, 0 },
+	{ &states[66], Tokens::CH_EQ },
+	{ nullptr, 0 },
+	{ &states[37], Tokens::NAME },
+	{ &states[31], Tokens::NAME },
+	{ &states[32], Tokens::STRING },
+	{ &states[38], Tokens::KW_THIS },
+	{ &states[17], Tokens::CH_OBRACE },
+	{ &states[39], Tokens::CH_OPAREN },
+	{ &states[40], Tokens::CH_LT },
+	{ nullptr, 0 },
+	{ &states[68], Tokens::NAME },
+	{ &states[69], Tokens::NUMBER },
+	{ &states[70], Tokens::STRING },
+	{ &states[71], Tokens::KW_FALSE },
+	{ &states[72], Tokens::KW_TRUE },
+	{ nullptr, 0 },
+	{ &states[80], Tokens::CH_OPAREN },
+	{ nullptr, 0 },
+	{ &states[81], Tokens::CH_SEMICOLON },
+	{ nullptr, 0 },
+	{ &states[82], Tokens::CH_OR },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ &states[17], Tokens::CH_OBRACE },
+	{ nullptr, 0 },
+	{ &states[84], Tokens::NAME },
+	{ &states[32], Tokens::STRING },
+	{ &states[38], Tokens::KW_THIS },
+	{ &states[17], Tokens::CH_OBRACE },
+	{ &states[39], Tokens::CH_OPAREN },
+	{ &states[40], Tokens::CH_LT },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ &states[86], Tokens::CH_QUESTION },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ &states[87], Tokens::CH_ASTERISK },
+	{ &states[88], Tokens::CH_PLUS },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ &states[31], Tokens::NAME },
+	{ &states[32], Tokens::STRING },
+	{ &states[17], Tokens::CH_OBRACE },
+	{ &states[39], Tokens::CH_OPAREN },
+	{ &states[40], Tokens::CH_LT },
+	{ nullptr, 0 },
+	{ &states[31], Tokens::NAME },
+	{ &states[32], Tokens::STRING },
+	{ &states[17], Tokens::CH_OBRACE },
+	{ &states[39], Tokens::CH_OPAREN },
+	{ &states[40], Tokens::CH_LT },
+	{ nullptr, 0 },
+	{ &states[91], Tokens::CH_COLON },
+	{ &states[92], Tokens::CH_CPAREN },
+	{ nullptr, 0 },
+	{ &states[93], Tokens::CH_COLON_COLON },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ &states[94], Tokens::CH_GT },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ &states[95], Tokens::NAME },
+	{ nullptr, 0 },
+	{ &states[99], Tokens::NAME },
+	{ nullptr, 0 },
+	{ &states[37], Tokens::NAME },
+	{ &states[31], Tokens::NAME },
+	{ &states[32], Tokens::STRING },
+	{ &states[38], Tokens::KW_THIS },
+	{ &states[17], Tokens::CH_OBRACE },
+	{ &states[39], Tokens::CH_OPAREN },
+	{ &states[40], Tokens::CH_LT },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ &states[37], Tokens::NAME },
+	{ &states[31], Tokens::NAME },
+	{ &states[32], Tokens::STRING },
+	{ &states[38], Tokens::KW_THIS },
+	{ &states[17], Tokens::CH_OBRACE },
+	{ &states[39], Tokens::CH_OPAREN },
+	{ &states[40], Tokens::CH_LT },
+	{ nullptr, 0 },
+	{ &states[102], Tokens::KW_PREFER },
+	{ &states[103], Tokens::KW_AVOID },
+	{ &states[104], Tokens::KW_REJECT },
+	{ nullptr, 0 },
+	{ &states[65], Tokens::CH_EQ },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ &states[37], Tokens::NAME },
+	{ &states[31], Tokens::NAME },
+	{ &states[32], Tokens::STRING },
+	{ &states[38], Tokens::KW_THIS },
+	{ &states[17], Tokens::CH_OBRACE },
+	{ &states[39], Tokens::CH_OPAREN },
+	{ &states[40], Tokens::CH_LT },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ &states[107], Tokens::CH_OPAREN },
+	{ nullptr, 0 },
+	{ &states[108], Tokens::CH_DOT },
+	{ &states[109], Tokens::CH_MINUS_GT },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ &states[113], Tokens::CH_COLON_COLON },
+	{ nullptr, 0 },
+	{ &states[114], Tokens::CH_CPAREN },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ &states[115], Tokens::CH_CPAREN },
+	{ nullptr, 0 },
+	{ &states[68], Tokens::NAME },
+	{ &states[69], Tokens::NUMBER },
+	{ &states[70], Tokens::STRING },
+	{ &states[71], Tokens::KW_FALSE },
+	{ &states[72], Tokens::KW_TRUE },
+	{ nullptr, 0 },
+	{ &states[95], Tokens::NAME },
+	{ nullptr, 0 },
+	{ &states[95], Tokens::NAME },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ &states[108], Tokens::CH_DOT },
+	{ &states[109], Tokens::CH_MINUS_GT },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ &states[122], Tokens::CH_CPAREN },
+	{ nullptr, 0 },
+	{ &states[123], Tokens::CH_COMMA },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ &states[68], Tokens::NAME },
+	{ &states[69], Tokens::NUMBER },
+	{ &states[70], Tokens::STRING },
+	{ &states[71], Tokens::KW_FALSE },
+	{ &states[72], Tokens::KW_TRUE },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+};
+
+const Goto prs::Tables::gotos[] = {
+	{ &states[4], 0 }, //Grammar
+	{ &states[5], 1 }, //DeclarationList
+	{ &states[6], 2 }, //Declaration
+	{ &states[7], 3 }, //TypeDeclaration
+	{ &states[8], 4 }, //TerminalDeclaration
+	{ &states[9], 5 }, //NonterminalDeclaration
+	{ &states[10], 6 }, //CustomTerminalTypeDeclaration
+	{ &states[11], 7 }, //AtOpt
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ &states[15], 2 }, //Declaration
+	{ &states[7], 3 }, //TypeDeclaration
+	{ &states[8], 4 }, //TerminalDeclaration
+	{ &states[9], 5 }, //NonterminalDeclaration
+	{ &states[10], 6 }, //CustomTerminalTypeDeclaration
+	{ &states[11], 7 }, //AtOpt
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ &states[18], 11 }, //TypeOpt
+	{ &states[19], 12 }, //Type
+	{ nullptr, 0 },
+	{ &states[20], 12 }, //Type
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ &states[22], 11 }, //TypeOpt
+	{ &states[19], 12 }, //Type
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ &states[27], 8 }, //NoFollowOpt
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ &states[33], 9 }, //NoFollowList
+	{ &states[34], 10 }, //NoFollowTerm
+	{ &states[35], 24 }, //NameSyntaxTerm
+	{ &states[36], 25 }, //StringSyntaxTerm
+	{ nullptr, 0 },
+	{ &states[41], 11 }, //TypeOpt
+	{ &states[19], 12 }, //Type
+	{ &states[42], 13 }, //SyntaxOrExpression
+	{ &states[43], 14 }, //SyntaxAndExpressionList
+	{ &states[44], 15 }, //SyntaxAndExpression
+	{ &states[45], 17 }, //SyntaxElementListOpt
+	{ &states[46], 18 }, //SyntaxElementList
+	{ &states[47], 19 }, //SyntaxElement
+	{ &states[48], 20 }, //NameSyntaxElement
+	{ &states[49], 21 }, //ThisSyntaxElement
+	{ &states[50], 22 }, //SyntaxTerm
+	{ &states[51], 23 }, //PrimarySyntaxTerm
+	{ &states[52], 24 }, //NameSyntaxTerm
+	{ &states[53], 25 }, //StringSyntaxTerm
+	{ &states[54], 26 }, //NestedSyntaxTerm
+	{ &states[55], 27 }, //AdvanvedSyntaxTerm
+	{ &states[56], 28 }, //ZeroOneSyntaxTerm
+	{ &states[57], 29 }, //ZeroManySyntaxTerm
+	{ &states[58], 30 }, //OneManySyntaxTerm
+	{ &states[59], 31 }, //LoopBody
+	{ &states[60], 32 }, //SimpleLoopBody
+	{ &states[61], 33 }, //AdvancedLoopBody
+	{ &states[62], 34 }, //ConstSyntaxTerm
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ &states[64], 10 }, //NoFollowTerm
+	{ &states[35], 24 }, //NameSyntaxTerm
+	{ &states[36], 25 }, //StringSyntaxTerm
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ &states[41], 11 }, //TypeOpt
+	{ &states[19], 12 }, //Type
+	{ &states[67], 13 }, //SyntaxOrExpression
+	{ &states[43], 14 }, //SyntaxAndExpressionList
+	{ &states[44], 15 }, //SyntaxAndExpression
+	{ &states[45], 17 }, //SyntaxElementListOpt
+	{ &states[46], 18 }, //SyntaxElementList
+	{ &states[47], 19 }, //SyntaxElement
+	{ &states[48], 20 }, //NameSyntaxElement
+	{ &states[49], 21 }, //ThisSyntaxElement
+	{ &states[50], 22 }, //SyntaxTerm
+	{ &states[51], 23 }, //PrimarySyntaxTerm
+	{ &states[52], 24 }, //NameSyntaxTerm
+	{ &states[53], 25 }, //StringSyntaxTerm
+	{ &states[54], 26 }, //NestedSyntaxTerm
+	{ &states[55], 27 }, //AdvanvedSyntaxTerm
+	{ &states[56], 28 }, //ZeroOneSyntaxTerm
+	{ &states[57], 29 }, //ZeroManySyntaxTerm
+	{ &states[58], 30 }, //OneManySyntaxTerm
+	{ &states[59], 31 }, //LoopBody
+	{ &states[60], 32 }, //SimpleLoopBody
+	{ &states[61], 33 }, //AdvancedLoopBody
+	{ &states[62], 34 }, //ConstSyntaxTerm
+	{ nullptr, 0 },
+	{ &states[73], 35 }, //ConstExpression
+	{ &states[74], 36 }, //IntegerConstExpression
+	{ &states[75], 37 }, //StringConstExpression
+	{ &states[76], 38 }, //BooleanConstExpression
+	{ &states[77], 39 }, //NativeConstExpression
+	{ &states[78], 40 }, //NativeQualificationOpt
+	{ &states[79], 41 }, //NativeQualification
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ &states[83], 11 }, //TypeOpt
+	{ &states[19], 12 }, //Type
+	{ nullptr, 0 },
+	{ &states[41], 11 }, //TypeOpt
+	{ &states[19], 12 }, //Type
+	{ &states[85], 19 }, //SyntaxElement
+	{ &states[48], 20 }, //NameSyntaxElement
+	{ &states[49], 21 }, //ThisSyntaxElement
+	{ &states[50], 22 }, //SyntaxTerm
+	{ &states[51], 23 }, //PrimarySyntaxTerm
+	{ &states[52], 24 }, //NameSyntaxTerm
+	{ &states[53], 25 }, //StringSyntaxTerm
+	{ &states[54], 26 }, //NestedSyntaxTerm
+	{ &states[55], 27 }, //AdvanvedSyntaxTerm
+	{ &states[56], 28 }, //ZeroOneSyntaxTerm
+	{ &states[57], 29 }, //ZeroManySyntaxTerm
+	{ &states[58], 30 }, //OneManySyntaxTerm
+	{ &states[59], 31 }, //LoopBody
+	{ &states[60], 32 }, //SimpleLoopBody
+	{ &states[61], 33 }, //AdvancedLoopBody
+	{ &states[62], 34 }, //ConstSyntaxTerm
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ &states[41], 11 }, //TypeOpt
+	{ &states[19], 12 }, //Type
+	{ &states[89], 22 }, //SyntaxTerm
+	{ &states[51], 23 }, //PrimarySyntaxTerm
+	{ &states[52], 24 }, //NameSyntaxTerm
+	{ &states[53], 25 }, //StringSyntaxTerm
+	{ &states[54], 26 }, //NestedSyntaxTerm
+	{ &states[55], 27 }, //AdvanvedSyntaxTerm
+	{ &states[56], 28 }, //ZeroOneSyntaxTerm
+	{ &states[57], 29 }, //ZeroManySyntaxTerm
+	{ &states[58], 30 }, //OneManySyntaxTerm
+	{ &states[59], 31 }, //LoopBody
+	{ &states[60], 32 }, //SimpleLoopBody
+	{ &states[61], 33 }, //AdvancedLoopBody
+	{ &states[62], 34 }, //ConstSyntaxTerm
+	{ nullptr, 0 },
+	{ &states[41], 11 }, //TypeOpt
+	{ &states[19], 12 }, //Type
+	{ &states[90], 22 }, //SyntaxTerm
+	{ &states[51], 23 }, //PrimarySyntaxTerm
+	{ &states[52], 24 }, //NameSyntaxTerm
+	{ &states[53], 25 }, //StringSyntaxTerm
+	{ &states[54], 26 }, //NestedSyntaxTerm
+	{ &states[55], 27 }, //AdvanvedSyntaxTerm
+	{ &states[56], 28 }, //ZeroOneSyntaxTerm
+	{ &states[57], 29 }, //ZeroManySyntaxTerm
+	{ &states[58], 30 }, //OneManySyntaxTerm
+	{ &states[59], 31 }, //LoopBody
+	{ &states[60], 32 }, //SimpleLoopBody
+	{ &states[61], 33 }, //AdvancedLoopBody
+	{ &states[62], 34 }, //ConstSyntaxTerm
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ &states[96], 44 }, //NativeName
+	{ &states[97], 45 }, //NativeVariableName
+	{ &states[98], 46 }, //NativeFunctionName
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ &states[41], 11 }, //TypeOpt
+	{ &states[19], 12 }, //Type
+	{ &states[100], 13 }, //SyntaxOrExpression
+	{ &states[43], 14 }, //SyntaxAndExpressionList
+	{ &states[44], 15 }, //SyntaxAndExpression
+	{ &states[45], 17 }, //SyntaxElementListOpt
+	{ &states[46], 18 }, //SyntaxElementList
+	{ &states[47], 19 }, //SyntaxElement
+	{ &states[48], 20 }, //NameSyntaxElement
+	{ &states[49], 21 }, //ThisSyntaxElement
+	{ &states[50], 22 }, //SyntaxTerm
+	{ &states[51], 23 }, //PrimarySyntaxTerm
+	{ &states[52], 24 }, //NameSyntaxTerm
+	{ &states[53], 25 }, //StringSyntaxTerm
+	{ &states[54], 26 }, //NestedSyntaxTerm
+	{ &states[55], 27 }, //AdvanvedSyntaxTerm
+	{ &states[56], 28 }, //ZeroOneSyntaxTerm
+	{ &states[57], 29 }, //ZeroManySyntaxTerm
+	{ &states[58], 30 }, //OneManySyntaxTerm
+	{ &states[59], 31 }, //LoopBody
+	{ &states[60], 32 }, //SimpleLoopBody
+	{ &states[61], 33 }, //AdvancedLoopBody
+	{ &states[62], 34 }, //ConstSyntaxTerm
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ &states[41], 11 }, //TypeOpt
+	{ &states[19], 12 }, //Type
+	{ &states[101], 15 }, //SyntaxAndExpression
+	{ &states[45], 17 }, //SyntaxElementListOpt
+	{ &states[46], 18 }, //SyntaxElementList
+	{ &states[47], 19 }, //SyntaxElement
+	{ &states[48], 20 }, //NameSyntaxElement
+	{ &states[49], 21 }, //ThisSyntaxElement
+	{ &states[50], 22 }, //SyntaxTerm
+	{ &states[51], 23 }, //PrimarySyntaxTerm
+	{ &states[52], 24 }, //NameSyntaxTerm
+	{ &states[53], 25 }, //StringSyntaxTerm
+	{ &states[54], 26 }, //NestedSyntaxTerm
+	{ &states[55], 27 }, //AdvanvedSyntaxTerm
+	{ &states[56], 28 }, //ZeroOneSyntaxTerm
+	{ &states[57], 29 }, //ZeroManySyntaxTerm
+	{ &states[58], 30 }, //OneManySyntaxTerm
+	{ &states[59], 31 }, //LoopBody
+	{ &states[60], 32 }, //SimpleLoopBody
+	{ &states[61], 33 }, //AdvancedLoopBody
+	{ &states[62], 34 }, //ConstSyntaxTerm
+	{ nullptr, 0 },
+	{ &states[105], 16 }, //PrFilterOpt
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ &states[41], 11 }, //TypeOpt
+	{ &states[19], 12 }, //Type
+	{ &states[106], 13 }, //SyntaxOrExpression
+	{ &states[43], 14 }, //SyntaxAndExpressionList
+	{ &states[44], 15 }, //SyntaxAndExpression
+	{ &states[45], 17 }, //SyntaxElementListOpt
+	{ &states[46], 18 }, //SyntaxElementList
+	{ &states[47], 19 }, //SyntaxElement
+	{ &states[48], 20 }, //NameSyntaxElement
+	{ &states[49], 21 }, //ThisSyntaxElement
+	{ &states[50], 22 }, //SyntaxTerm
+	{ &states[51], 23 }, //PrimarySyntaxTerm
+	{ &states[52], 24 }, //NameSyntaxTerm
+	{ &states[53], 25 }, //StringSyntaxTerm
+	{ &states[54], 26 }, //NestedSyntaxTerm
+	{ &states[55], 27 }, //AdvanvedSyntaxTerm
+	{ &states[56], 28 }, //ZeroOneSyntaxTerm
+	{ &states[57], 29 }, //ZeroManySyntaxTerm
+	{ &states[58], 30 }, //OneManySyntaxTerm
+	{ &states[59], 31 }, //LoopBody
+	{ &states[60], 32 }, //SimpleLoopBody
+	{ &states[61], 33 }, //AdvancedLoopBody
+	{ &states[62], 34 }, //ConstSyntaxTerm
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ &states[110], 42 }, //NativeReferencesOpt
+	{ &states[111], 43 }, //NativeReferences
+	{ &states[112], 49 }, //NativeReference
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ &states[116], 35 }, //ConstExpression
+	{ &states[74], 36 }, //IntegerConstExpression
+	{ &states[75], 37 }, //StringConstExpression
+	{ &states[76], 38 }, //BooleanConstExpression
+	{ &states[77], 39 }, //NativeConstExpression
+	{ &states[78], 40 }, //NativeQualificationOpt
+	{ &states[79], 41 }, //NativeQualification
+	{ &states[117], 47 }, //ConstExpressionListOpt
+	{ &states[118], 48 }, //ConstExpressionList
+	{ nullptr, 0 },
+	{ &states[119], 44 }, //NativeName
+	{ &states[97], 45 }, //NativeVariableName
+	{ &states[98], 46 }, //NativeFunctionName
+	{ nullptr, 0 },
+	{ &states[120], 44 }, //NativeName
+	{ &states[97], 45 }, //NativeVariableName
+	{ &states[98], 46 }, //NativeFunctionName
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ &states[121], 49 }, //NativeReference
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+	{ &states[124], 35 }, //ConstExpression
+	{ &states[74], 36 }, //IntegerConstExpression
+	{ &states[75], 37 }, //StringConstExpression
+	{ &states[76], 38 }, //BooleanConstExpression
+	{ &states[77], 39 }, //NativeConstExpression
+	{ &states[78], 40 }, //NativeQualificationOpt
+	{ &states[79], 41 }, //NativeQualification
+	{ nullptr, 0 },
+	{ nullptr, 0 },
+};
+
+const Reduce prs::Tables::reduces[] = {
+	{ 0, 7, 13 }, //AtOpt :
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 7, 12 }, //AtOpt : CH_AT
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 0, syn::ACCEPT_ACTION },
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 7, 13 }, //AtOpt :
+	{ 1, 0, 1 }, //Grammar : DeclarationList
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 1, 2 }, //DeclarationList : Declaration
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 2, 4 }, //Declaration : TypeDeclaration
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 2, 5 }, //Declaration : TerminalDeclaration
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 2, 6 }, //Declaration : NonterminalDeclaration
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 2, 7 }, //Declaration : CustomTerminalTypeDeclaration
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 11, 21 }, //TypeOpt :
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 0, syn::NULL_ACTION },
+	{ 2, 1, 3 }, //DeclarationList : DeclarationList Declaration
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 11, 21 }, //TypeOpt :
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 11, 20 }, //TypeOpt : Type
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 0, syn::NULL_ACTION },
+	{ 3, 3, 8 }, //TypeDeclaration : KW_TYPE NAME CH_SEMICOLON
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 8, 15 }, //NoFollowOpt :
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 0, syn::NULL_ACTION },
+	{ 4, 4, 9 }, //TerminalDeclaration : KW_TOKEN NAME TypeOpt CH_SEMICOLON
+	{ 0, 0, syn::NULL_ACTION },
+	{ 4, 6, 11 }, //CustomTerminalTypeDeclaration : KW_TOKEN STRING Type CH_SEMICOLON
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 0, syn::NULL_ACTION },
+	{ 3, 12, 22 }, //Type : CH_OBRACE NAME CH_CBRACE
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 17, 32 }, //SyntaxElementListOpt :
+	{ 0, 11, 21 }, //TypeOpt :
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 24, 45 }, //NameSyntaxTerm : NAME
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 25, 46 }, //StringSyntaxTerm : STRING
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 9, 16 }, //NoFollowList : NoFollowTerm
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 10, 18 }, //NoFollowTerm : NameSyntaxTerm
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 10, 19 }, //NoFollowTerm : StringSyntaxTerm
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 17, 32 }, //SyntaxElementListOpt :
+	{ 0, 11, 21 }, //TypeOpt :
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 40, 71 }, //NativeQualificationOpt :
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 13, 23 }, //SyntaxOrExpression : SyntaxAndExpressionList
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 14, 24 }, //SyntaxAndExpressionList : SyntaxAndExpression
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 11, 21 }, //TypeOpt :
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 17, 31 }, //SyntaxElementListOpt : SyntaxElementList
+	{ 0, 11, 21 }, //TypeOpt :
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 18, 33 }, //SyntaxElementList : SyntaxElement
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 19, 35 }, //SyntaxElement : NameSyntaxElement
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 19, 36 }, //SyntaxElement : ThisSyntaxElement
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 20, 38 }, //NameSyntaxElement : SyntaxTerm
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 32, 57 }, //SimpleLoopBody : PrimarySyntaxTerm
+	{ 1, 22, 40 }, //SyntaxTerm : PrimarySyntaxTerm
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 23, 42 }, //PrimarySyntaxTerm : NameSyntaxTerm
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 23, 43 }, //PrimarySyntaxTerm : StringSyntaxTerm
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 23, 44 }, //PrimarySyntaxTerm : NestedSyntaxTerm
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 22, 41 }, //SyntaxTerm : AdvanvedSyntaxTerm
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 27, 48 }, //AdvanvedSyntaxTerm : ZeroOneSyntaxTerm
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 27, 49 }, //AdvanvedSyntaxTerm : ZeroManySyntaxTerm
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 27, 50 }, //AdvanvedSyntaxTerm : OneManySyntaxTerm
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 31, 55 }, //LoopBody : SimpleLoopBody
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 31, 56 }, //LoopBody : AdvancedLoopBody
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 27, 51 }, //AdvanvedSyntaxTerm : ConstSyntaxTerm
+	{ 0, 0, syn::NULL_ACTION },
+	{ 4, 8, 14 }, //NoFollowOpt : KW_NOFOLLOW CH_OPAREN NoFollowList CH_CPAREN
+	{ 0, 0, syn::NULL_ACTION },
+	{ 2, 9, 17 }, //NoFollowList : NoFollowList NoFollowTerm
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 11, 21 }, //TypeOpt :
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 11, 21 }, //TypeOpt :
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 36, 65 }, //IntegerConstExpression : NUMBER
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 37, 66 }, //StringConstExpression : STRING
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 38, 67 }, //BooleanConstExpression : KW_FALSE
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 38, 68 }, //BooleanConstExpression : KW_TRUE
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 35, 61 }, //ConstExpression : IntegerConstExpression
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 35, 62 }, //ConstExpression : StringConstExpression
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 35, 63 }, //ConstExpression : BooleanConstExpression
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 35, 64 }, //ConstExpression : NativeConstExpression
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 40, 70 }, //NativeQualificationOpt : NativeQualification
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 17, 32 }, //SyntaxElementListOpt :
+	{ 0, 11, 21 }, //TypeOpt :
+	{ 0, 0, syn::NULL_ACTION },
+	{ 7, 5, 10 }, //NonterminalDeclaration : AtOpt NAME TypeOpt NoFollowOpt CH_COLON SyntaxOrExpression CH_SEMICOLON
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 17, 32 }, //SyntaxElementListOpt :
+	{ 0, 11, 21 }, //TypeOpt :
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 16, 30 }, //PrFilterOpt :
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 24, 45 }, //NameSyntaxTerm : NAME
+	{ 0, 0, syn::NULL_ACTION },
+	{ 2, 18, 34 }, //SyntaxElementList : SyntaxElementList SyntaxElement
+	{ 0, 0, syn::NULL_ACTION },
+	{ 2, 28, 52 }, //ZeroOneSyntaxTerm : PrimarySyntaxTerm CH_QUESTION
+	{ 0, 0, syn::NULL_ACTION },
+	{ 2, 29, 53 }, //ZeroManySyntaxTerm : LoopBody CH_ASTERISK
+	{ 0, 0, syn::NULL_ACTION },
+	{ 2, 30, 54 }, //OneManySyntaxTerm : LoopBody CH_PLUS
+	{ 0, 0, syn::NULL_ACTION },
+	{ 3, 20, 37 }, //NameSyntaxElement : NAME CH_EQ SyntaxTerm
+	{ 0, 0, syn::NULL_ACTION },
+	{ 3, 21, 39 }, //ThisSyntaxElement : KW_THIS CH_EQ SyntaxTerm
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 17, 32 }, //SyntaxElementListOpt :
+	{ 0, 11, 21 }, //TypeOpt :
+	{ 0, 0, syn::NULL_ACTION },
+	{ 3, 33, 59 }, //AdvancedLoopBody : CH_OPAREN SyntaxOrExpression CH_CPAREN
+	{ 0, 0, syn::NULL_ACTION },
+	{ 2, 41, 72 }, //NativeQualification : NAME CH_COLON_COLON
+	{ 0, 0, syn::NULL_ACTION },
+	{ 3, 34, 60 }, //ConstSyntaxTerm : CH_LT ConstExpression CH_GT
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 45, 80 }, //NativeVariableName : NAME
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 42, 75 }, //NativeReferencesOpt :
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 44, 78 }, //NativeName : NativeVariableName
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 44, 79 }, //NativeName : NativeFunctionName
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 0, syn::NULL_ACTION },
+	{ 3, 14, 25 }, //SyntaxAndExpressionList : SyntaxAndExpressionList CH_OR SyntaxAndExpression
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 16, 27 }, //PrFilterOpt : KW_PREFER
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 16, 28 }, //PrFilterOpt : KW_AVOID
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 16, 29 }, //PrFilterOpt : KW_REJECT
+	{ 0, 0, syn::NULL_ACTION },
+	{ 3, 15, 26 }, //SyntaxAndExpression : SyntaxElementListOpt TypeOpt PrFilterOpt
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 40, 71 }, //NativeQualificationOpt :
+	{ 0, 47, 83 }, //ConstExpressionListOpt :
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 0, syn::NULL_ACTION },
+	{ 3, 39, 69 }, //NativeConstExpression : NativeQualificationOpt NativeName NativeReferencesOpt
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 42, 74 }, //NativeReferencesOpt : NativeReferences
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 43, 76 }, //NativeReferences : NativeReference
+	{ 0, 0, syn::NULL_ACTION },
+	{ 3, 41, 73 }, //NativeQualification : NativeQualification NAME CH_COLON_COLON
+	{ 0, 0, syn::NULL_ACTION },
+	{ 4, 26, 47 }, //NestedSyntaxTerm : TypeOpt CH_OPAREN SyntaxOrExpression CH_CPAREN
+	{ 0, 0, syn::NULL_ACTION },
+	{ 5, 33, 58 }, //AdvancedLoopBody : CH_OPAREN SyntaxOrExpression CH_COLON SyntaxOrExpression CH_CPAREN
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 48, 84 }, //ConstExpressionList : ConstExpression
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 0, syn::NULL_ACTION },
+	{ 1, 47, 82 }, //ConstExpressionListOpt : ConstExpressionList
+	{ 0, 0, syn::NULL_ACTION },
+	{ 2, 49, 86 }, //NativeReference : CH_DOT NativeName
+	{ 0, 0, syn::NULL_ACTION },
+	{ 2, 49, 87 }, //NativeReference : CH_MINUS_GT NativeName
+	{ 0, 0, syn::NULL_ACTION },
+	{ 2, 43, 77 }, //NativeReferences : NativeReferences NativeReference
+	{ 0, 0, syn::NULL_ACTION },
+	{ 4, 46, 81 }, //NativeFunctionName : NAME CH_OPAREN ConstExpressionListOpt CH_CPAREN
+	{ 0, 0, syn::NULL_ACTION },
+	{ 0, 40, 71 }, //NativeQualificationOpt :
+	{ 0, 0, syn::NULL_ACTION },
+	{ 3, 48, 85 }, //ConstExpressionList : ConstExpressionList CH_COMMA ConstExpression
+	{ 0, 0, syn::NULL_ACTION },
+};
+
+const State* const prs::Tables::start_state = &states[0];
+
+const std::size_t prs::Tables::states_count = sizeof(states) / sizeof(states[0]);
+const std::size_t prs::Tables::shifts_count = sizeof(shifts) / sizeof(shifts[0]);
+const std::size_t prs::Tables::gotos_count = sizeof(gotos) / sizeof(gotos[0]);
+const std::size_t prs::Tables::reduces_count = sizeof(reduces) / sizeof(reduces[0]);
@@ -20,10 +20,13 @@
 
 #include <fstream>
 #include <iostream>
+#include <iterator>
 #include <memory>
 #include <new>
+#include <string>
 #include <utility>
 
+#include "bintables.h"
 #include "cmdline.h"
 #include "codegen.h"
 #include "commons.h"
@@ -72,6 +75,30 @@ namespace {
 		return result;
 	}
 
+	void generate_binary_tables(const ns::CommandLine* command_line) {
+		const std::string& in_file_name = command_line->get_in_file();
+		std::ifstream in(in_file_name.c_str(), std::ios_base::in | std::ios_base::binary);
+		if (!in) throw ns::Exception("Cannot open file: " + in_file_name);
+		std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+		std::string data = ns::compile_grammar_to_binary(text, String(in_file_name));
+
+		const std::string& out_file_name0 = command_line->get_out_file();
+		const std::string out_file_name = out_file_name0.empty() ? std::string("syngen.synt") : out_file_name0;
+		std::ofstream out(out_file_name.c_str(), std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+		out.exceptions(std::ios_base::badbit | std::ios_base::failbit | std::ios_base::eofbit);
+		out.write(data.data(), data.size());
+		out.close();
+	}
+
+	void generate_grammar_tables(const ns::CommandLine* command_line) {
+		const std::string& out_file_name = command_line->get_grammar_tables_file();
+		std::ofstream out(out_file_name.c_str(), std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+		if (!out) throw ns::Exception("Cannot open file: " + out_file_name);
+		prs::generate_tables(out);
+		out.close();
+	}
+
 }
 
 int ns::main(int argc, const char* const argv[]) {
@@ -84,6 +111,22 @@ int ns::main(int argc, const char* const argv[]) {
 		return 1;
 	}
 
+	//* Binary Tables *
+
+	if (command_line->is_binary_tables()) {
+		generate_binary_tables(command_line.get());
+		if (command_line->is_verbose()) std::cout << "OK\n";
+		return 0;
+	}
+
+	//* Grammar File Parser Tables *
+
+	if (command_line->is_grammar_tables()) {
+		generate_grammar_tables(command_line.get());
+		if (command_line->is_verbose()) std::cout << "OK\n";
+		return 0;
+	}
+
 	//* Parse Source Grammar File *
 	
 	unique_ptr<ns::GrammarParsingResult> parsing_result = parse_grammar(command_line.get());
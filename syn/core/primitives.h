@@ -28,6 +28,14 @@
 namespace synbin {
 
 		typedef unsigned long syntax_number;
+
+		//Disambiguation filter of a production, declared in the grammar by %prefer, %avoid or %reject.
+		enum PrFilter {
+			PRFILTER_NONE,
+			PRFILTER_PREFER,
+			PRFILTER_AVOID,
+			PRFILTER_REJECT
+		};
 		
 		//
 		//syntax_string
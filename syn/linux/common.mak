@@ -14,7 +14,7 @@ else
 DEBUG_FLAGS=-DNDEBUG
 endif
 
-CFLAGS=-std=c++11 -static-libgcc -static-libstdc++ $(DEBUG_FLAGS)
+CFLAGS=-std=c++11 -pthread -static-libgcc -static-libstdc++ $(DEBUG_FLAGS)
 CC=g++
 
 syn: mkdirs $(SYN_EXE)
@@ -46,9 +46,9 @@ $(ODIR)/rt/%.o: $(BASEDIR)/rt/%.cpp $(DEPS)
 $(ODIR)/start/%.o: $(BASEDIR)/start/%.cpp $(DEPS)
 	$(CC) -c -o $@ $< $(CFLAGS) -I$(BASEDIR)/rt
 
-_OBJ = action.o action_factory.o cmdline.o codegen.o codegen_action.o commons.o concretelrgen.o concretescan.o conversion.o \
+_OBJ = action.o action_factory.o bintables.o cmdline.o codegen.o codegen_action.o commons.o concretelrgen.o concretescan.o conversion.o \
 conversion_builder.o converter.o descriptor.o descriptor_type.o ebnf.o ebnf_bld_attrs.o ebnf_bld_gentype.o ebnf_bld_name.o ebnf_bld_recursion.o \
-ebnf_bld_type.o ebnf_bld_void.o ebnf_builder.o ebnf_extension.o grm_parser.o grm_scanner.o main.o types.o util_string.o
+ebnf_bld_type.o ebnf_bld_void.o ebnf_builder.o ebnf_extension.o grm_parser.o grm_scanner.o grm_tables.o main.o types.o util_string.o
 
 OBJ = $(patsubst %,$(ODIR)/core/%,$(_OBJ)) $(ODIR)/rt/syn.o $(ODIR)/start/start.o
 
@@ -62,14 +62,22 @@ $(SYN_EXE): $(OBJ)
 $(ODIR)/test/%.o: $(BASEDIR)/test/%.cpp
 	$(CC) -c -o $@ $< $(CFLAGS) -I$(BASEDIR)
 
-_TEST_OBJ = cmdline_test.o converter_test.o ebnf_bld_attrs_test.o ebnf_bld_gentype_test.o ebnf_bld_recursion_test.o \
-ebnf_bld_type_test.o ebnf_bld_void_test.o ebnf_builder_test.o grm_parser_test.o raw_bnf_test.o tests.o unittest.o \
+_TEST_OBJ = bintables_test.o cmdline_test.o converter_test.o ebnf_bld_attrs_test.o ebnf_bld_gentype_test.o ebnf_bld_recursion_test.o \
+ebnf_bld_type_test.o ebnf_bld_void_test.o ebnf_builder_test.o grm_parser_test.o raw_bnf_test.o rt_syn_test.o tests.o unittest.o \
 util_string_test.o
 TEST_OBJ = $(patsubst %,$(ODIR)/core/%,$(_OBJ)) $(patsubst %,$(ODIR)/test/%,$(_TEST_OBJ)) $(ODIR)/rt/syn.o 
 
 $(TEST_EXE): $(TEST_OBJ)
 	$(CC) -o $@ $^ -lm
 
+#
+#grm_tables
+#
+
+#Regenerates the LR tables of the grammar file parser. Needed after changing the grammar file syntax rules.
+grm_tables: syn
+	$(SYN_EXE) -G $(BASEDIR)/core/grm_tables.cpp
+
 #
 #clean
 #
@@ -17,9 +17,26 @@
 //SYN run-time library implementation.
 
 #include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
 #include <stdexcept>
+#include <thread>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include "syn.h"
 
 using syn::InternalTk;
@@ -30,55 +47,6 @@ using syn::Goto;
 using syn::Reduce;
 using syn::State;
 
-//
-//StackElement
-//
-
-void syn::StackElement::init(StackElement* prev, const State* state) {
-	m_prev = prev;
-	m_state = state;
-	m_list = 0;
-	m_ref_count = 0;
-}
-
-//
-//StackElement_Value
-//
-
-void syn::StackElement_Value::init(StackElement* prev, const State* state, const void* value_ptr) {
-	StackElement::init(prev, state);
-	m_value_ptr = value_ptr;
-}
-
-//
-//StackElement_Nt
-//
-
-void syn::StackElement_Nt::init(
-	StackElement* prev,
-	const State* state,
-	const Reduce* reduce,
-	StackElement* sub_elements)
-{
-	StackElement::init(prev, state);
-	m_reduce = reduce;
-	m_sub_elements = sub_elements;
-}
-
-void syn::StackElement_Nt::get_sub_elements(std::vector<const StackElement*>& v) const {
-	std::size_t ofs = v.size();
-	std::size_t len = m_reduce->m_length;
-	v.resize(ofs + len);
-
-	StackElement* element = m_sub_elements;
-	while (len) {
-		assert(element);
-		--len;
-		v[ofs + len] = element;
-		element = element->prev();
-	}
-}
-
 //
 //Shift
 //
@@ -101,10 +69,12 @@ void Goto::assign(const State* state, InternalNt nt) {
 //Reduce
 //
 
-void Reduce::assign(int length, InternalNt nt, InternalAction action) {
+void Reduce::assign(int length, InternalNt nt, InternalAction action, unsigned filter, const InternalTk* nofollow) {
 	m_length = length;
 	m_nt = nt;
 	m_action = action;
+	m_filter = filter;
+	m_nofollow = nofollow;
 }
 
 //
@@ -165,28 +135,98 @@ void syn::check_production(const ProductionStack& stack, InternalAction pr, std:
 	if (!is_production(stack, pr, len)) throw illegal_state();
 }
 
+//
+//LinkedTables
+//
+
+namespace syn {
+	//Access to linked tables, made of State objects, like the generated ones. Lists of actions of a state are
+	//terminated by a null state or by NULL_ACTION.
+	class LinkedTables {
+	public:
+		typedef State StateType;
+		typedef Reduce ReduceType;
+
+		bool is_nt_state(const State* state) const {
+			return State::sym_nt == state->m_sym_type;
+		}
+
+		bool is_value_state(const State* state) const {
+			return State::sym_tk_value == state->m_sym_type;
+		}
+
+		std::size_t get_state_index(const State* state) const {
+			return state->m_index;
+		}
+
+		template<class F>
+		void for_each_shift(const State* state, InternalTk token, F f) const {
+			if (const Shift* shift = state->m_shifts) {
+				for (; shift->m_state; ++shift) {
+					if (token == shift->m_token) f(shift->m_state);
+				}
+			}
+		}
+
+		const State* find_goto(const State* state, InternalNt nt) const {
+			if (const Goto* pgoto = state->m_gotos) {
+				for (; pgoto->m_state; ++pgoto) {
+					if (nt == pgoto->m_nt) return pgoto->m_state;
+				}
+			}
+			return nullptr;
+		}
+
+		//Calls the function for every reduce of the state, passing null for the accept action.
+		template<class F>
+		void for_each_reduce(const State* state, F f) const {
+			if (const Reduce* reduce = state->m_reduces) {
+				for (; reduce->m_action != NULL_ACTION; ++reduce) f(ACCEPT_ACTION == reduce->m_action ? nullptr : reduce);
+			}
+		}
+
+		bool is_follow_allowed(const Reduce* reduce, InternalTk lookahead) const {
+			if (!reduce->m_nofollow) return true;
+			for (const InternalTk* tk = reduce->m_nofollow; *tk != NULL_TOKEN; ++tk) {
+				if (lookahead == *tk) return false;
+			}
+			return true;
+		}
+	};
+}
+
 //
 //StacksList : definition
 //
 
 namespace syn {
+	//List of the tops of the parser's stacks. T provides access to the tables (see LinkedTables).
+	template<class T>
 	class StacksList {
 		StacksList(const StacksList&) = delete;
 		StacksList(StacksList&&) = delete;
 		StacksList& operator=(const StacksList&) = delete;
 		StacksList& operator=(StacksList&&) = delete;
 
-		StackElementPool& m_element_pool;
-		StackElement* m_begin;
+		typedef typename T::StateType StateType;
+		typedef typename T::ReduceType ReduceType;
+		typedef BasicStackElement<StateType, ReduceType> StackEl;
+		typedef BasicStackElement_Value<StateType, ReduceType> StackEl_Value;
+		typedef BasicStackElement_Nt<StateType, ReduceType> StackEl_Nt;
+
+		const T& m_tables;
+		StackElementPool<T>& m_element_pool;
+		StackEl* m_begin;
 
-		StackElement* delete_unreferenced_element(StackElement* element, StackElement* to_delete_queue);
-		void delete_reference(StackElement* element);
+		StackEl* delete_unreferenced_element(StackEl* element, StackEl* to_delete_queue);
+		void delete_reference(StackEl* element);
 		void clear();
-			
+
 	public:
-		explicit StacksList(StackElementPool& element_pool)
-			: m_begin(0),
-			m_element_pool(element_pool)
+		StacksList(const T& tables, StackElementPool<T>& element_pool)
+			: m_tables(tables),
+			m_element_pool(element_pool),
+			m_begin(0)
 		{}
 
 		~StacksList() {
@@ -196,15 +236,15 @@ namespace syn {
 		class iterator {
 			friend class StacksList;
 
-			StackElement* m_element;
+			StackEl* m_element;
 
 		public:
-			explicit iterator(StackElement* stack_el) : m_element(stack_el){}
+			explicit iterator(StackEl* stack_el) : m_element(stack_el){}
 
 			bool operator==(iterator iter) const { return m_element == iter.m_element; }
 			bool operator!=(iterator iter) const { return m_element != iter.m_element; }
-			StackElement* operator*() const { return m_element; }
-			StackElement* element() const { return m_element; }
+			StackEl* operator*() const { return m_element; }
+			StackEl* element() const { return m_element; }
 
 			iterator& operator++() {
 				//WARN the iterator must not point to the end of list (i. e. m_element != 0).
@@ -217,14 +257,28 @@ namespace syn {
 		iterator end() const { return iterator(nullptr); }
 		bool empty() const { return !m_begin; }
 
-		void push_front_start_state(const State* start_state);
-		void push_front_tk(StackElement* prev, const State* state, const void* value_ptr);
+		void push_front_start_state(const StateType* start_state);
+		void push_front_tk(StackEl* prev, const StateType* state, const void* value_ptr);
 
 		void push_front_nt(
-			StackElement* prev,
-			const State* state,
-			const Reduce* reduce,
-			StackElement* sub_elements);
+			StackEl* prev,
+			const StateType* state,
+			const ReduceType* reduce,
+			StackEl* sub_elements);
+
+		//Removes the stacks whose top elements satisfy the predicate.
+		template<class P>
+		void remove_if(P pred) {
+			StackEl** link = &m_begin;
+			while (StackEl* element = *link) {
+				if (pred(element)) {
+					*link = element->m_list;
+					delete_reference(element);
+				} else {
+					link = &element->m_list;
+				}
+			}
+		}
 
 		void move(StacksList& source_list);
 		void print(std::ostream& out);
@@ -236,50 +290,55 @@ namespace syn {
 //
 
 namespace syn {
+	template<class T>
 	class StackElementPool {
 		StackElementPool(const StackElementPool&) = delete;
 		StackElementPool(StackElementPool&&) = delete;
 		StackElementPool& operator=(const StackElementPool&) = delete;
 		StackElementPool& operator=(StackElementPool&&) = delete;
 
-		template<class T>
+		typedef typename T::StateType StateType;
+		typedef typename T::ReduceType ReduceType;
+		typedef BasicStackElement<StateType, ReduceType> StackEl;
+		typedef BasicStackElement_Value<StateType, ReduceType> StackEl_Value;
+		typedef BasicStackElement_Nt<StateType, ReduceType> StackEl_Nt;
+
+		template<class E>
 		class SimplePool {
 			SimplePool(const SimplePool&) = delete;
 			SimplePool(SimplePool&&) = delete;
 			SimplePool& operator=(const SimplePool&) = delete;
 			SimplePool& operator=(SimplePool&&) = delete;
 
-			T* m_list;
+			E* m_list;
 			std::size_t m_size;
 			std::size_t m_allocations_count;
 
+			//Blocks of elements, deleted together with the pool. Elements of the trees returned by a parser are
+			//never released, so they cannot be deleted one by one.
+			std::vector<std::unique_ptr<E[]>> m_blocks;
+			std::size_t m_block_used;
+
 		public:
+			static const std::size_t BLOCK_SIZE = 256;
+
 			SimplePool() : m_list(nullptr) {
 				m_size = 0;
 				m_allocations_count = 0;
+				m_block_used = BLOCK_SIZE;
 			}
 
-			~SimplePool() {
-				T* el = m_list;
-				while (el) {
-					T* next = static_cast<T*>(el->m_list);
-					delete el;
-					el = next;
-				}
-				m_list = nullptr;
-			}
-
-			T* allocate() {
-				T* result = m_list;
+			E* allocate() {
+				E* result = m_list;
 				if (result) {
-					m_list = static_cast<T*>(result->m_list);
+					m_list = static_cast<E*>(result->m_list);
 					--m_size;
 				}
 				++m_allocations_count;
 				return result;
 			}
 
-			void release(T* element) {
+			void release(E* element) {
 				element->m_list = m_list;
 				m_list = element;
 				++m_size;
@@ -292,41 +351,57 @@ namespace syn {
 			std::size_t allocations_count() const {
 				return m_allocations_count;
 			}
+
+			bool block_available() const {
+				return m_block_used < BLOCK_SIZE;
+			}
+
+			void add_block(E* block) {
+				m_blocks.emplace_back(block);
+				m_block_used = 0;
+			}
+
+			E* allocate_in_block() {
+				assert(block_available());
+				++m_allocations_count;
+				return &m_blocks.back()[m_block_used++];
+			}
 		};
 
-		SimplePool<StackElement> m_element_pool;
-		SimplePool<StackElement_Value> m_element_value_pool;
-		SimplePool<StackElement_Nt> m_element_nt_pool;
+		SimplePool<StackEl> m_element_pool;
+		SimplePool<StackEl_Value> m_element_value_pool;
+		SimplePool<StackEl_Nt> m_element_nt_pool;
 
-		template<class T>
-		T* allocate_el(SimplePool<T>& pool) {
-			T* el = pool.allocate();
+		template<class E>
+		E* allocate_el(SimplePool<E>& pool) {
+			E* el = pool.allocate();
 			if (!el) {
-				el = new T();
+				if (!pool.block_available()) pool.add_block(new E[SimplePool<E>::BLOCK_SIZE]);
+				el = pool.allocate_in_block();
 			}
 			return el;
 		}
 
-		template<class T>
-		void release_el(SimplePool<T>& pool, T* el) {
+		template<class E>
+		void release_el(SimplePool<E>& pool, E* el) {
 			pool.release(el);
 		}
 
 	public:
 		StackElementPool(){}
 
-		StackElement* allocate_element(StackElement* prev, const State* state);
-		StackElement* allocate_element_value(StackElement* prev, const State* state, const void* value_ptr);
-			
-		StackElement* allocate_element_nt(
-			StackElement* prev,
-			const State* state,
-			const Reduce* reduce,
-			StackElement* sub_elements);
-
-		void release_element(StackElement* element);
-		void release_element_value(StackElement_Value* element_value);
-		void release_element_nt(StackElement_Nt* element_nt);
+		StackEl* allocate_element(StackEl* prev, const StateType* state);
+		StackEl* allocate_element_value(StackEl* prev, const StateType* state, const void* value_ptr);
+
+		StackEl* allocate_element_nt(
+			StackEl* prev,
+			const StateType* state,
+			const ReduceType* reduce,
+			StackEl* sub_elements);
+
+		void release_element(StackEl* element);
+		void release_element_value(StackEl_Value* element_value);
+		void release_element_nt(StackEl_Nt* element_nt);
 	};
 }
 
@@ -334,39 +409,40 @@ namespace syn {
 //StacksList : implementation
 //
 
-syn::StackElement* syn::StacksList::delete_unreferenced_element(
-	syn::StackElement* element,
-	syn::StackElement* to_delete_queue)
+template<class T>
+typename syn::StacksList<T>::StackEl* syn::StacksList<T>::delete_unreferenced_element(
+	StackEl* element,
+	StackEl* to_delete_queue)
 {
-	StackElement* prev = element->prev();
+	StackEl* prev = element->prev();
 	if (prev && !--prev->m_ref_count) {
 		prev->m_list = to_delete_queue;
 		to_delete_queue = prev;
 	}
 
 	//Determine the type of the element and release it.
-	const State* state = element->state();
-	State::SymType sym_type = state->m_sym_type;
-	if (State::sym_nt == sym_type) {
+	const StateType* state = element->state();
+	if (m_tables.is_nt_state(state)) {
 		//Check for NT is first, because NT is the most frequent type of nodes.
-		StackElement_Nt* element_nt = static_cast<StackElement_Nt*>(element);
-		StackElement* sub = element_nt->m_sub_elements;
+		StackEl_Nt* element_nt = static_cast<StackEl_Nt*>(element);
+		StackEl* sub = element_nt->m_sub_elements;
 		if (sub && !--sub->m_ref_count) {
 			sub->m_list = to_delete_queue;
 			to_delete_queue = sub;
 		}
 		m_element_pool.release_element_nt(element_nt);
-	} else if (State::sym_tk_value == sym_type) {
-		m_element_pool.release_element_value(static_cast<StackElement_Value*>(element));
+	} else if (m_tables.is_value_state(state)) {
+		m_element_pool.release_element_value(static_cast<StackEl_Value*>(element));
 	} else {
-		//Assuming sym_none.
+		//Assuming a state without a value.
 		m_element_pool.release_element(element);
 	}
 
 	return to_delete_queue;
 }
 
-void syn::StacksList::delete_reference(syn::StackElement* element) {
+template<class T>
+void syn::StacksList<T>::delete_reference(StackEl* element) {
 	if (!--element->m_ref_count){
 		//Since the element cannot be used after having been passed to this function,
 		//we can use the element's link field to make the linked list of elements to be
@@ -374,30 +450,33 @@ void syn::StacksList::delete_reference(syn::StackElement* element) {
 		//chains of elements (previous and sub-elements).
 
 		element->m_list = nullptr;
-		StackElement* to_delete = element;
+		StackEl* to_delete = element;
 		while (to_delete) to_delete = delete_unreferenced_element(to_delete, to_delete->m_list);
 	}
 }
 
-void syn::StacksList::clear() {
-	StackElement* element = m_begin;
+template<class T>
+void syn::StacksList<T>::clear() {
+	StackEl* element = m_begin;
 	while (element) {
-		StackElement* next = element->m_list;
+		StackEl* next = element->m_list;
 		delete_reference(element);
 		element = next;
 	}
 	m_begin = nullptr;
 }
 
-void syn::StacksList::push_front_start_state(const State* start_state) {
-	StackElement* element = m_element_pool.allocate_element(nullptr, start_state);
+template<class T>
+void syn::StacksList<T>::push_front_start_state(const StateType* start_state) {
+	StackEl* element = m_element_pool.allocate_element(nullptr, start_state);
 	element->m_list = m_begin;
 	element->m_ref_count = 1;
 	m_begin = element;
 }
 
-void syn::StacksList::push_front_tk(syn::StackElement* prev, const State* state, const void* value_ptr) {
-	StackElement* element;
+template<class T>
+void syn::StacksList<T>::push_front_tk(StackEl* prev, const StateType* state, const void* value_ptr) {
+	StackEl* element;
 	if (value_ptr) {
 		element = m_element_pool.allocate_element_value(prev, state, value_ptr);
 	} else {
@@ -411,13 +490,14 @@ void syn::StacksList::push_front_tk(syn::StackElement* prev, const State* state,
 	m_begin = element;
 }
 
-void syn::StacksList::push_front_nt(
-	syn::StackElement* prev,
-	const State* state,
-	const Reduce* reduce,
-	syn::StackElement* sub_elements)
+template<class T>
+void syn::StacksList<T>::push_front_nt(
+	StackEl* prev,
+	const StateType* state,
+	const ReduceType* reduce,
+	StackEl* sub_elements)
 {
-	StackElement* element = m_element_pool.allocate_element_nt(prev, state, reduce, sub_elements);
+	StackEl* element = m_element_pool.allocate_element_nt(prev, state, reduce, sub_elements);
 	element->m_list = m_begin;
 	element->m_ref_count = 1;
 	if (prev) {
@@ -431,16 +511,18 @@ void syn::StacksList::push_front_nt(
 	m_begin = element;
 }
 
-void syn::StacksList::move(StacksList& source_list) {
+template<class T>
+void syn::StacksList<T>::move(StacksList& source_list) {
 	clear();
 	m_begin = source_list.m_begin;
 	source_list.m_begin = nullptr;
 }
 
-void syn::StacksList::print(std::ostream& out) {
+template<class T>
+void syn::StacksList<T>::print(std::ostream& out) {
 	const char* sep = "";
-	for (StackElement* element : *this) {
-		out << sep << element->m_state->m_index;
+	for (StackEl* element : *this) {
+		out << sep << m_tables.get_state_index(element->m_state);
 		sep = " ";
 	}
 }
@@ -449,42 +531,51 @@ void syn::StacksList::print(std::ostream& out) {
 //StackElementPool : implementation
 //
 
-syn::StackElement* syn::StackElementPool::allocate_element(syn::StackElement* prev, const State* state) {
-	StackElement* element = allocate_el(m_element_pool);
+template<class T>
+typename syn::StackElementPool<T>::StackEl* syn::StackElementPool<T>::allocate_element(
+	StackEl* prev,
+	const StateType* state)
+{
+	StackEl* element = allocate_el(m_element_pool);
 	element->init(prev, state);
 	return element;
 }
 
-syn::StackElement* syn::StackElementPool::allocate_element_value(
-	syn::StackElement* prev,
-	const State* state,
+template<class T>
+typename syn::StackElementPool<T>::StackEl* syn::StackElementPool<T>::allocate_element_value(
+	StackEl* prev,
+	const StateType* state,
 	const void* value_ptr)
 {
-	StackElement_Value* element_value = allocate_el(m_element_value_pool);
+	StackEl_Value* element_value = allocate_el(m_element_value_pool);
 	element_value->init(prev, state, value_ptr);
 	return element_value;
 }
 
-syn::StackElement* syn::StackElementPool::allocate_element_nt(
-	syn::StackElement* prev,
-	const State* state,
-	const Reduce* reduce,
-	syn::StackElement* sub_elements)
+template<class T>
+typename syn::StackElementPool<T>::StackEl* syn::StackElementPool<T>::allocate_element_nt(
+	StackEl* prev,
+	const StateType* state,
+	const ReduceType* reduce,
+	StackEl* sub_elements)
 {
-	StackElement_Nt* element_nt = allocate_el(m_element_nt_pool);
+	StackEl_Nt* element_nt = allocate_el(m_element_nt_pool);
 	element_nt->init(prev, state, reduce, sub_elements);
 	return element_nt;
 }
 
-void syn::StackElementPool::release_element(syn::StackElement* element) {
+template<class T>
+void syn::StackElementPool<T>::release_element(StackEl* element) {
 	release_el(m_element_pool, element);
 }
 
-void syn::StackElementPool::release_element_value(syn::StackElement_Value* element_value) {
+template<class T>
+void syn::StackElementPool<T>::release_element_value(StackEl_Value* element_value) {
 	release_el(m_element_value_pool, element_value);
 }
 
-void syn::StackElementPool::release_element_nt(syn::StackElement_Nt* element_nt) {
+template<class T>
+void syn::StackElementPool<T>::release_element_nt(StackEl_Nt* element_nt) {
 	release_el(m_element_nt_pool, element_nt);
 }
 
@@ -493,31 +584,73 @@ void syn::StackElementPool::release_element_nt(syn::StackElement_Nt* element_nt)
 //
 
 namespace syn {
-	class CoreParser : public ParserInterface {
+	//GLR parser working on the tables accessed through T: LinkedTables or BinaryTables.
+	template<class T>
+	class CoreParser {
 		CoreParser(const CoreParser&) = delete;
 		CoreParser(CoreParser&&) = delete;
 		CoreParser& operator=(const CoreParser&) = delete;
 		CoreParser& operator=(CoreParser&&) = delete;
 
-		StackElementPool m_element_pool;
-		StacksList m_stacks_list;
+	public:
+		typedef typename T::StateType StateType;
+		typedef typename T::ReduceType ReduceType;
+		typedef BasicStackElement<StateType, ReduceType> StackEl;
+		typedef BasicStackElement_Nt<StateType, ReduceType> StackEl_Nt;
+
+	private:
+		typedef typename StacksList<T>::iterator StackIterator;
+
+		const T& m_tables;
+		StackElementPool<T> m_element_pool;
+		StacksList<T> m_stacks_list;
+
+		//Parsers used by parse_chunks(). They own the stack elements of the returned trees.
+		std::vector<std::unique_ptr<CoreParser>> m_chunk_parsers;
 
-		void reduce_and_goto(StacksList::iterator stack, const Reduce* reduce);
-		void reduce_one_stack(StacksList::iterator stack, StackElement_Nt** result_element, bool* accept);
-		void reduce_stacks(StackElement_Nt** result_element, bool* accept);
+		//Disambiguation filters state. Set when a reduce having a filter is done at the current position.
+		bool m_filter_pending;
+		std::vector<std::pair<const StackEl*, InternalNt>> m_rejected;
+		std::vector<StackEl*> m_filter_elements;
+
+		void reduce_and_goto(StackIterator stack, const ReduceType* reduce);
+
+		void reduce_one_stack(
+			StackIterator stack,
+			InternalTk lookahead,
+			StackEl_Nt** result_element,
+			bool* accept);
+
+		void reduce_stacks(InternalTk lookahead, StackEl_Nt** result_element, bool* accept);
+		void filter_stacks();
+		void find_accept(StackEl_Nt** result_element, bool* accept);
 		void shift_stacks(InternalTk token, const void* value_ptr);
 
 	public:
-		CoreParser();
-		StackElement_Nt* parse(const State* start_state, ScannerInterface& scanner, InternalTk tk_eof) override;
+		explicit CoreParser(const T& tables);
+		StackEl_Nt* parse(const StateType* start_state, ScannerInterface& scanner, InternalTk tk_eof);
+
+		void parse_chunks(
+			const StateType* start_state,
+			ScannerInterface& scanner,
+			InternalTk tk_eof,
+			const ResyncTokens& resync,
+			std::size_t thread_count,
+			std::vector<StackEl_Nt*>& results);
 	};
 }
 
-syn::CoreParser::CoreParser() : m_stacks_list(m_element_pool){}
-
-void syn::CoreParser::reduce_and_goto(syn::StacksList::iterator stack, const Reduce* reduce) {
-	StackElement* stack_el = stack.element();
-	StackElement* origin = stack_el;
+template<class T>
+syn::CoreParser<T>::CoreParser(const T& tables)
+	: m_tables(tables),
+	m_stacks_list(tables, m_element_pool),
+	m_filter_pending(false)
+{}
+
+template<class T>
+void syn::CoreParser<T>::reduce_and_goto(StackIterator stack, const ReduceType* reduce) {
+	StackEl* stack_el = stack.element();
+	StackEl* origin = stack_el;
 	for (int i = reduce->m_length; i; --i) {
 		assert(origin);
 		origin = origin->prev();
@@ -525,101 +658,445 @@ void syn::CoreParser::reduce_and_goto(syn::StacksList::iterator stack, const Red
 
 	const InternalNt nt = reduce->m_nt;
 
-	const Goto* pgoto = origin->state()->m_gotos;
-	if (!pgoto) return;
-
-	while (pgoto->m_state) {
-		if (nt == pgoto->m_nt) {
-			m_stacks_list.push_front_nt(origin, pgoto->m_state, reduce, stack_el);
-			break;
+	if (reduce->m_filter) {
+		m_filter_pending = true;
+		if (reduce->m_filter & REDUCE_REJECT) {
+			//A rejecting production does not produce a stack, it only kills the competing ones.
+			m_rejected.push_back(std::make_pair(origin, nt));
+			return;
 		}
-		++pgoto;
+	}
+
+	if (const StateType* state = m_tables.find_goto(origin->state(), nt)) {
+		m_stacks_list.push_front_nt(origin, state, reduce, stack_el);
 	}
 }
 
-void syn::CoreParser::reduce_one_stack(
-	syn::StacksList::iterator stack,
-	syn::StackElement_Nt** result_element,
+namespace {
+	template<class R>
+	int get_filter_priority(const R* reduce) {
+		if (reduce->m_filter & syn::REDUCE_PREFER) return 2;
+		if (reduce->m_filter & syn::REDUCE_AVOID) return 0;
+		return 1;
+	}
+}
+
+template<class T>
+void syn::CoreParser<T>::reduce_one_stack(
+	StackIterator stack,
+	InternalTk lookahead,
+	StackEl_Nt** result_element,
 	bool* accept)
 {
-	StackElement* stack_el = stack.element();
-	const Reduce* reduce = stack_el->state()->m_reduces;
-	if (!reduce) return;
-
-	while (reduce->m_action != NULL_ACTION) {
-		if (reduce->m_action == ACCEPT_ACTION) {
-			StackElement_Nt* element_nt = static_cast<StackElement_Nt*>(stack_el);
+	StackEl* stack_el = stack.element();
+	m_tables.for_each_reduce(stack_el->state(), [&](const ReduceType* reduce) {
+		if (!reduce) {
+			StackEl_Nt* element_nt = static_cast<StackEl_Nt*>(stack_el);
 			*result_element = element_nt;
 			*accept = true;
-		} else {
+		} else if (m_tables.is_follow_allowed(reduce, lookahead)) {
 			reduce_and_goto(stack, reduce);
 		}
-		++reduce;
-	}
+	});
 }
 
-void syn::CoreParser::reduce_stacks(syn::StackElement_Nt** result_element, bool* accept) {
-	StacksList::iterator end = m_stacks_list.end();
-	StacksList::iterator start = m_stacks_list.begin();
+template<class T>
+void syn::CoreParser<T>::reduce_stacks(InternalTk lookahead, StackEl_Nt** result_element, bool* accept) {
+	StackIterator end = m_stacks_list.end();
+	StackIterator start = m_stacks_list.begin();
 	while (start != end) {
-		for (StacksList::iterator cur = start; cur != end; ++cur) {
-			reduce_one_stack(cur, result_element, accept);
-			//TODO Check for stack duplication, i. e. ambiguity.
+		for (StackIterator cur = start; cur != end; ++cur) {
+			reduce_one_stack(cur, lookahead, result_element, accept);
 		}
 
 		end = start;
 		start = m_stacks_list.begin();
 	}
+
+	if (m_filter_pending) {
+		filter_stacks();
+		//The accepting stack might have been removed.
+		find_accept(result_element, accept);
+	}
 }
 
-void syn::CoreParser::shift_stacks(InternalTk token, const void* value_ptr) {
-	StacksList next_stacks_list(m_element_pool);
-	for (StackElement* stack_el : m_stacks_list) {
-		if (const Shift* shift = stack_el->state()->m_shifts) {
-			while (shift->m_state) {
-				if (token == shift->m_token) {
-					next_stacks_list.push_front_tk(stack_el, shift->m_state, value_ptr);
-				}
-				++shift;
-			}
+template<class T>
+void syn::CoreParser<T>::filter_stacks() {
+	m_filter_pending = false;
+
+	//All the stack elements created at the current position are in the stacks list, and every element
+	//follows the elements created after it.
+	std::vector<StackEl*>& elements = m_filter_elements;
+	elements.clear();
+	for (StackEl* element : m_stacks_list) elements.push_back(element);
+
+	std::unordered_set<const StackEl*> dead;
+
+	//Stacks having the same state and the same origin recognize the same nonterminal over the same input.
+	//Only the ones whose top production has the highest priority survive.
+	typedef std::pair<const StackEl*, const StateType*> StackKey;
+	std::map<StackKey, int> best_priorities;
+	for (const StackEl* element : elements) {
+		if (!m_tables.is_nt_state(element->state())) continue;
+		int priority = get_filter_priority(element->as_nt()->reduce());
+		StackKey key(element->prev(), element->state());
+		auto ins = best_priorities.insert(std::make_pair(key, priority));
+		if (!ins.second && ins.first->second < priority) ins.first->second = priority;
+	}
+	for (const StackEl* element : elements) {
+		if (!m_tables.is_nt_state(element->state())) continue;
+		int priority = get_filter_priority(element->as_nt()->reduce());
+		if (priority < best_priorities[StackKey(element->prev(), element->state())]) dead.insert(element);
+	}
+
+	//Rejected nonterminals.
+	for (const StackEl* element : elements) {
+		if (!m_tables.is_nt_state(element->state())) continue;
+		const InternalNt nt = element->as_nt()->reduce()->m_nt;
+		std::pair<const StackEl*, InternalNt> key(element->prev(), nt);
+		if (std::find(m_rejected.begin(), m_rejected.end(), key) != m_rejected.end()) dead.insert(element);
+	}
+	m_rejected.clear();
+
+	if (dead.empty()) return;
+
+	//Everything built on a dead element is dead. Elements are checked in the order of creation.
+	for (auto iter = elements.rbegin(); iter != elements.rend(); ++iter) {
+		const StackEl* element = *iter;
+		if (!m_tables.is_nt_state(element->state()) || dead.count(element)) continue;
+
+		const StackEl_Nt* element_nt = element->as_nt();
+		bool is_dead = dead.count(element->prev()) != 0;
+		const StackEl* sub = element_nt->sub_elements();
+		for (int i = element_nt->reduce()->m_length; i && !is_dead; --i) {
+			is_dead = dead.count(sub) != 0;
+			sub = sub->prev();
 		}
+		if (is_dead) dead.insert(element);
+	}
+
+	m_stacks_list.remove_if([&dead](const StackEl* element){ return dead.count(element) != 0; });
+}
+
+template<class T>
+void syn::CoreParser<T>::find_accept(StackEl_Nt** result_element, bool* accept) {
+	*result_element = nullptr;
+	*accept = false;
+	for (StackEl* stack_el : m_stacks_list) {
+		m_tables.for_each_reduce(stack_el->state(), [&](const ReduceType* reduce) {
+			if (!reduce) {
+				*result_element = static_cast<StackEl_Nt*>(stack_el);
+				*accept = true;
+			}
+		});
+	}
+}
+
+template<class T>
+void syn::CoreParser<T>::shift_stacks(InternalTk token, const void* value_ptr) {
+	StacksList<T> next_stacks_list(m_tables, m_element_pool);
+	for (StackEl* stack_el : m_stacks_list) {
+		m_tables.for_each_shift(stack_el->state(), token, [&](const StateType* state) {
+			next_stacks_list.push_front_tk(stack_el, state, value_ptr);
+		});
 	}
 	m_stacks_list.move(next_stacks_list);
 }
 
-syn::StackElement_Nt* syn::CoreParser::parse(
-	const State* start_state,
+template<class T>
+typename syn::CoreParser<T>::StackEl_Nt* syn::CoreParser<T>::parse(
+	const StateType* start_state,
 	syn::ScannerInterface& scanner,
 	const InternalTk tk_eof)
 {
 	m_stacks_list.push_front_start_state(start_state);
-	StackElement_Nt* result_element;
+	StackEl_Nt* result_element;
 	bool accept;
 
 	for (;;) {
-		//1. Reduce.
-		result_element = nullptr;
-		accept = false;
-		reduce_stacks(&result_element, &accept);
-
-		//2. Shift.
+		//1. Scan. The token is scanned before reduce, since it is the lookahead for follow restrictions.
 		std::pair<InternalTk, const void*> scan_result = scanner.scan();
 		InternalTk token = scan_result.first;
 		const void* value_ptr = scan_result.second;
+
+		//2. Reduce.
+		result_element = nullptr;
+		accept = false;
+		reduce_stacks(token, &result_element, &accept);
+
+		//3. Shift.
 		shift_stacks(token, value_ptr);
-				
-		//3. Check.
+
+		//4. Check.
 		if (m_stacks_list.empty()) {
 			//Optimization trick: since there cannot be a shift with token=EOF, on EOF we will get here.
 			//No additional check for EOF is needed in the main loop of shift_stack() in this case.
 			if (tk_eof == token) {
-				if (!accept) throw SynSyntaxError();
+				if (!accept) throw SynSyntaxError(scanner.get_token_pos());
 				return result_element;
 			}
 			//Syntax error.
-			throw SynSyntaxError();
+			throw SynSyntaxError(scanner.get_token_pos());
+		}
+	}
+}
+
+//
+//CoreParser : chunked parsing
+//
+
+namespace {
+	typedef std::pair<InternalTk, const void*> TokenRecord;
+	typedef std::vector<TokenRecord> TokenVector;
+	typedef std::vector<syn::TokenPos> PosVector;
+
+	//Minimal number of tokens in a chunk. Smaller chunks are not worth a separate parser.
+	const std::size_t MIN_CHUNK_TOKENS = 4096;
+
+	//Number of chunks per thread. More chunks than threads gives a better load balance.
+	const std::size_t CHUNKS_PER_THREAD = 4;
+
+	//
+	//BufferScanner
+	//
+
+	//Returns tokens from a range of a pre-scanned token buffer, followed by EOF. The position of the EOF
+	//is the position of the token following the range.
+	class BufferScanner : public syn::ScannerInterface {
+		BufferScanner(const BufferScanner&) = delete;
+		BufferScanner(BufferScanner&&) = delete;
+		BufferScanner& operator=(const BufferScanner&) = delete;
+		BufferScanner& operator=(BufferScanner&&) = delete;
+
+		TokenVector::const_iterator m_cur;
+		const TokenVector::const_iterator m_end;
+		PosVector::const_iterator m_pos;
+		const TokenRecord m_eof_record;
+		bool m_eof;
+
+	public:
+		BufferScanner(
+			TokenVector::const_iterator begin,
+			TokenVector::const_iterator end,
+			PosVector::const_iterator pos,
+			const TokenRecord& eof_record)
+			: m_cur(begin),
+			m_end(end),
+			m_pos(pos),
+			m_eof_record(eof_record),
+			m_eof(false)
+		{}
+
+		TokenRecord scan() override {
+			if (m_eof) return m_eof_record;
+			if (m_cur == m_end) {
+				m_eof = true;
+				return m_eof_record;
+			}
+			++m_pos;
+			return *m_cur++;
+		}
+
+		syn::TokenPos get_token_pos() const override {
+			return m_eof ? *m_pos : *(m_pos - 1);
+		}
+
+		bool is_eof() const {
+			return m_eof;
+		}
+	};
+
+	bool contains_token(const std::vector<InternalTk>& tokens, InternalTk token) {
+		return std::find(tokens.begin(), tokens.end(), token) != tokens.end();
+	}
+
+	//Calculates chunk bounds: the first bound is 0, the last one is the number of tokens.
+	void split_chunks(
+		const TokenVector& tokens,
+		const syn::ResyncTokens& resync,
+		std::size_t thread_count,
+		std::vector<std::size_t>& bounds)
+	{
+		const std::size_t n = tokens.size();
+		const std::size_t target_size = std::max(MIN_CHUNK_TOKENS, n / (thread_count * CHUNKS_PER_THREAD));
+
+		bounds.push_back(0);
+		std::size_t depth = 0;
+		for (std::size_t i = 0; i < n; ++i) {
+			InternalTk token = tokens[i].first;
+			if (contains_token(resync.m_open, token)) {
+				++depth;
+			} else if (contains_token(resync.m_close, token)) {
+				//Unbalanced input is not an error here; the parser will detect it.
+				if (depth) --depth;
+			}
+
+			if (!depth && contains_token(resync.m_boundaries, token)) {
+				std::size_t bound = i + 1;
+				if (bound - bounds.back() >= target_size && n - bound >= target_size) bounds.push_back(bound);
+			}
+		}
+		bounds.push_back(n);
+	}
+
+	//Parses a range of tokens from the start state. Returns null if the range cannot be parsed. The error is
+	//returned as well, unless the parser has failed at the end of a range which does not end the input: then
+	//the range may be a part of a longer sentence.
+	template<class T>
+	typename syn::CoreParser<T>::StackEl_Nt* parse_chunk(
+		syn::CoreParser<T>& parser,
+		const typename syn::CoreParser<T>::StateType* start_state,
+		const TokenVector& tokens,
+		const PosVector& positions,
+		std::size_t begin,
+		std::size_t end,
+		const TokenRecord& eof_record,
+		std::exception_ptr& error)
+	{
+		BufferScanner scanner(tokens.begin() + begin, tokens.begin() + end, positions.begin() + begin, eof_record);
+		try {
+			return parser.parse(start_state, scanner, eof_record.first);
+		} catch (const syn::SynSyntaxError&) {
+			if (!scanner.is_eof() || tokens.size() == end) error = std::current_exception();
+			return nullptr;
+		}
+	}
+}
+
+template<class T>
+void syn::CoreParser<T>::parse_chunks(
+	const StateType* start_state,
+	syn::ScannerInterface& scanner,
+	const InternalTk tk_eof,
+	const syn::ResyncTokens& resync,
+	std::size_t thread_count,
+	std::vector<StackEl_Nt*>& results)
+{
+	if (thread_count <= 1) {
+		results.push_back(parse(start_state, scanner, tk_eof));
+		return;
+	}
+
+	//1. Scan. Scanning is sequential, and all values remain in the scanner's value pool. Positions of tokens
+	//are kept for reporting syntax errors; the last one is the position of the EOF.
+	TokenVector tokens;
+	PosVector positions;
+	TokenRecord eof_record;
+	for (;;) {
+		TokenRecord record = scanner.scan();
+		positions.push_back(scanner.get_token_pos());
+		if (tk_eof == record.first) {
+			eof_record = record;
+			break;
+		}
+		tokens.push_back(record);
+	}
+
+	//2. Split.
+	std::vector<std::size_t> bounds;
+	split_chunks(tokens, resync, thread_count, bounds);
+	const std::size_t chunk_count = bounds.size() - 1;
+
+	//3. Parse the chunks in parallel. Every chunk gets its own parser, since a parser owns the elements
+	//of the tree it returns.
+	std::vector<std::unique_ptr<CoreParser>> parsers(chunk_count);
+	std::vector<StackEl_Nt*> chunk_results(chunk_count, nullptr);
+	std::vector<std::exception_ptr> chunk_errors(chunk_count);
+	std::atomic<std::size_t> next_chunk(0);
+
+	const std::size_t worker_count = std::min(thread_count, chunk_count);
+	std::vector<std::exception_ptr> errors(worker_count);
+
+	auto worker = [&](std::size_t worker_index) {
+		try {
+			for (;;) {
+				std::size_t i = next_chunk++;
+				if (i >= chunk_count) break;
+				parsers[i].reset(new CoreParser(m_tables));
+				chunk_results[i] = parse_chunk(*parsers[i], start_state, tokens, positions, bounds[i], bounds[i + 1],
+					eof_record, chunk_errors[i]);
+			}
+		} catch (...) {
+			errors[worker_index] = std::current_exception();
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (std::size_t i = 1; i < worker_count; ++i) threads.push_back(std::thread(worker, i));
+	worker(0);
+	for (std::thread& thread : threads) thread.join();
+
+	for (std::exception_ptr& error : errors) {
+		if (error) std::rethrow_exception(error);
+	}
+
+	for (std::unique_ptr<CoreParser>& parser : parsers) m_chunk_parsers.push_back(std::move(parser));
+
+	//4. Stitch. A chunk which has failed at its end must have been split at a false boundary; it is parsed
+	//together with the next chunk, and if that does not help, together with the rest of the input. Only the
+	//tokens from the beginning of the failed chunk are parsed again, since the preceding chunks have been
+	//parsed successfully. A chunk which has failed before its end contains a syntax error.
+	std::vector<StackEl_Nt*> stitched;
+	for (std::size_t i = 0; i < chunk_count; ) {
+		StackEl_Nt* result = chunk_results[i];
+		std::exception_ptr error = chunk_errors[i];
+		std::size_t next = i + 1;
+
+		if (!result && !error && next < chunk_count) {
+			++next;
+			m_chunk_parsers.emplace_back(new CoreParser(m_tables));
+			result = parse_chunk(*m_chunk_parsers.back(), start_state, tokens, positions, bounds[i], bounds[next],
+				eof_record, error);
 		}
+
+		if (!result && !error) {
+			next = chunk_count;
+			m_chunk_parsers.emplace_back(new CoreParser(m_tables));
+			result = parse_chunk(*m_chunk_parsers.back(), start_state, tokens, positions, bounds[i], bounds[next],
+				eof_record, error);
+		}
+
+		if (!result) std::rethrow_exception(error);
+		stitched.push_back(result);
+		i = next;
 	}
+
+	results.insert(results.end(), stitched.begin(), stitched.end());
+}
+
+//
+//LinkedParser
+//
+
+namespace syn {
+	//Parser working on linked tables. The tables do not hold any data, the states are passed to the parser.
+	class LinkedParser : public ParserInterface {
+		LinkedParser(const LinkedParser&) = delete;
+		LinkedParser(LinkedParser&&) = delete;
+		LinkedParser& operator=(const LinkedParser&) = delete;
+		LinkedParser& operator=(LinkedParser&&) = delete;
+
+		LinkedTables m_tables;
+		CoreParser<LinkedTables> m_parser;
+
+	public:
+		LinkedParser() : m_parser(m_tables){}
+
+		StackElement_Nt* parse(const State* start_state, ScannerInterface& scanner, InternalTk tk_eof) override {
+			return m_parser.parse(start_state, scanner, tk_eof);
+		}
+
+		void parse_chunks(
+			const State* start_state,
+			ScannerInterface& scanner,
+			InternalTk tk_eof,
+			const ResyncTokens& resync,
+			std::size_t thread_count,
+			std::vector<StackElement_Nt*>& results) override
+		{
+			m_parser.parse_chunks(start_state, scanner, tk_eof, resync, thread_count, results);
+		}
+	};
 }
 
 //
@@ -627,5 +1104,350 @@ syn::StackElement_Nt* syn::CoreParser::parse(
 //
 
 std::unique_ptr<syn::ParserInterface> syn::ParserInterface::create() {
-	return std::unique_ptr<ParserInterface>(new CoreParser());
+	return std::unique_ptr<ParserInterface>(new LinkedParser());
 }
+
+//
+//BinaryTables
+//
+
+namespace {
+	namespace bin = syn::bin;
+
+	//Returns a pointer to the section and moves the offset past it.
+	template<class T>
+	const T* get_section(const char* data, std::size_t size, std::size_t* ofs, bin::U32 count) {
+		std::size_t section_size = count * sizeof(T);
+		if (section_size / sizeof(T) != count || size - *ofs < section_size) throw syn::SynBinaryError();
+		const T* section = reinterpret_cast<const T*>(data + *ofs);
+		*ofs += section_size;
+		return section;
+	}
+
+	void check_index(bin::U32 index, bin::U32 count) {
+		if (index >= count) throw syn::SynBinaryError();
+	}
+
+	void check_range(bin::U32 ofs, bin::U32 count, bin::U32 total) {
+		if (ofs > total || total - ofs < count) throw syn::SynBinaryError();
+	}
+
+	//Value passed to the parser for tokens which have no value. The parser needs a non-null value,
+	//because binary tables do not tell which tokens have values.
+	const char g_no_value = 0;
+
+	//
+	//CstScanner
+	//
+
+	class CstScanner : public syn::ScannerInterface {
+		CstScanner(const CstScanner&) = delete;
+		CstScanner(CstScanner&&) = delete;
+		CstScanner& operator=(const CstScanner&) = delete;
+		CstScanner& operator=(CstScanner&&) = delete;
+
+		syn::ScannerInterface& m_scanner;
+
+	public:
+		explicit CstScanner(syn::ScannerInterface& scanner) : m_scanner(scanner){}
+
+		std::pair<InternalTk, const void*> scan() override {
+			std::pair<InternalTk, const void*> result = m_scanner.scan();
+			if (!result.second) result.second = &g_no_value;
+			return result;
+		}
+	};
+}
+
+syn::BinaryTables::BinaryTables(const void* data, std::size_t size) {
+	const char* const bytes = static_cast<const char*>(data);
+	std::size_t ofs = 0;
+
+	m_header = get_section<bin::Header>(bytes, size, &ofs, 1);
+	if (bin::MAGIC != m_header->m_magic || bin::VERSION != m_header->m_version) throw SynBinaryError();
+
+	m_state_recs = get_section<bin::StateRec>(bytes, size, &ofs, m_header->m_state_count);
+	m_shift_recs = get_section<bin::ShiftRec>(bytes, size, &ofs, m_header->m_shift_count);
+	m_goto_recs = get_section<bin::GotoRec>(bytes, size, &ofs, m_header->m_goto_count);
+	m_reduce_recs = get_section<bin::ReduceRec>(bytes, size, &ofs, m_header->m_reduce_count);
+	m_start_recs = get_section<bin::StartRec>(bytes, size, &ofs, m_header->m_start_count);
+	m_token_recs = get_section<bin::TokenRec>(bytes, size, &ofs, m_header->m_token_count);
+	m_nt_recs = get_section<bin::NtRec>(bytes, size, &ofs, m_header->m_nt_count);
+	m_pr_recs = get_section<bin::PrRec>(bytes, size, &ofs, m_header->m_pr_count);
+	m_nofollow_recs = get_section<bin::U32>(bytes, size, &ofs, m_header->m_nofollow_size);
+	m_strings = get_section<char>(bytes, size, &ofs, m_header->m_string_size);
+
+	//Validate everything once, so that the parser can follow the indexes without checks.
+	const bin::U32 string_size = m_header->m_string_size;
+	if (!string_size || m_strings[string_size - 1]) throw SynBinaryError();
+	check_index(m_header->m_eof_token, m_header->m_token_count);
+
+	for (bin::U32 i = 0; i < m_header->m_token_count; ++i) {
+		check_index(m_token_recs[i].m_name, string_size);
+		check_index(m_token_recs[i].m_str, string_size);
+	}
+	for (bin::U32 i = 0; i < m_header->m_nt_count; ++i) check_index(m_nt_recs[i].m_name, string_size);
+	const bin::U32 nofollow_size = m_header->m_nofollow_size;
+	if (nofollow_size && bin::NONE != m_nofollow_recs[nofollow_size - 1]) throw SynBinaryError();
+	for (bin::U32 i = 0; i < nofollow_size; ++i) {
+		if (bin::NONE != m_nofollow_recs[i]) check_index(m_nofollow_recs[i], m_header->m_token_count);
+	}
+	for (bin::U32 i = 0; i < m_header->m_pr_count; ++i) {
+		const bin::PrRec& rec = m_pr_recs[i];
+		check_index(rec.m_nt, m_header->m_nt_count);
+		if (rec.m_filter & ~static_cast<bin::U32>(REDUCE_PREFER | REDUCE_AVOID | REDUCE_REJECT)) throw SynBinaryError();
+		if (bin::NONE != rec.m_nofollow) check_index(rec.m_nofollow, nofollow_size);
+	}
+	for (bin::U32 i = 0; i < m_header->m_start_count; ++i) {
+		check_index(m_start_recs[i].m_nt, m_header->m_nt_count);
+		check_index(m_start_recs[i].m_state, m_header->m_state_count);
+	}
+	for (bin::U32 i = 0; i < m_header->m_shift_count; ++i) {
+		check_index(m_shift_recs[i].m_state, m_header->m_state_count);
+		check_index(m_shift_recs[i].m_token, m_header->m_token_count);
+	}
+	for (bin::U32 i = 0; i < m_header->m_goto_count; ++i) {
+		check_index(m_goto_recs[i].m_state, m_header->m_state_count);
+		check_index(m_goto_recs[i].m_nt, m_header->m_nt_count);
+	}
+	for (bin::U32 i = 0; i < m_header->m_reduce_count; ++i) {
+		if (bin::NONE != m_reduce_recs[i].m_pr) check_index(m_reduce_recs[i].m_pr, m_header->m_pr_count);
+	}
+	for (bin::U32 i = 0; i < m_header->m_state_count; ++i) {
+		const bin::StateRec& rec = m_state_recs[i];
+		check_range(rec.m_shift_ofs, rec.m_shift_count, m_header->m_shift_count);
+		check_range(rec.m_goto_ofs, rec.m_goto_count, m_header->m_goto_count);
+		check_range(rec.m_reduce_ofs, rec.m_reduce_count, m_header->m_reduce_count);
+		if (bin::SYM_TOKEN == rec.m_sym_type) {
+			check_index(rec.m_sym, m_header->m_token_count);
+		} else if (bin::SYM_NT == rec.m_sym_type) {
+			check_index(rec.m_sym, m_header->m_nt_count);
+		} else if (bin::SYM_NONE != rec.m_sym_type) {
+			throw SynBinaryError();
+		}
+	}
+}
+
+bool syn::BinaryTables::is_nt_state(const bin::StateRec* state) const {
+	return bin::SYM_NT == state->m_sym_type;
+}
+
+//All tokens have values (see CstScanner), so every state entered by a token is a value state.
+bool syn::BinaryTables::is_value_state(const bin::StateRec* state) const {
+	return bin::SYM_TOKEN == state->m_sym_type;
+}
+
+std::size_t syn::BinaryTables::get_state_index(const bin::StateRec* state) const {
+	return state - m_state_recs;
+}
+
+template<class F>
+void syn::BinaryTables::for_each_shift(const bin::StateRec* state, InternalTk token, F f) const {
+	const bin::ShiftRec* shift = m_shift_recs + state->m_shift_ofs;
+	const bin::ShiftRec* const end = shift + state->m_shift_count;
+	for (; shift != end; ++shift) {
+		if (static_cast<bin::U32>(token) == shift->m_token) f(m_state_recs + shift->m_state);
+	}
+}
+
+const bin::StateRec* syn::BinaryTables::find_goto(const bin::StateRec* state, InternalNt nt) const {
+	const bin::GotoRec* pgoto = m_goto_recs + state->m_goto_ofs;
+	const bin::GotoRec* const end = pgoto + state->m_goto_count;
+	for (; pgoto != end; ++pgoto) {
+		if (static_cast<bin::U32>(nt) == pgoto->m_nt) return m_state_recs + pgoto->m_state;
+	}
+	return nullptr;
+}
+
+//Calls the function for every reduce of the state, passing null for the accept action.
+template<class F>
+void syn::BinaryTables::for_each_reduce(const bin::StateRec* state, F f) const {
+	const bin::ReduceRec* reduce = m_reduce_recs + state->m_reduce_ofs;
+	const bin::ReduceRec* const end = reduce + state->m_reduce_count;
+	for (; reduce != end; ++reduce) f(bin::NONE == reduce->m_pr ? nullptr : m_pr_recs + reduce->m_pr);
+}
+
+bool syn::BinaryTables::is_follow_allowed(const bin::PrRec* pr, InternalTk lookahead) const {
+	if (bin::NONE == pr->m_nofollow) return true;
+	for (const bin::U32* tk = m_nofollow_recs + pr->m_nofollow; bin::NONE != *tk; ++tk) {
+		if (static_cast<bin::U32>(lookahead) == *tk) return false;
+	}
+	return true;
+}
+
+std::uint64_t syn::BinaryTables::get_source_hash() const {
+	return (static_cast<std::uint64_t>(m_header->m_source_hash_hi) << 32) | m_header->m_source_hash_lo;
+}
+
+InternalTk syn::BinaryTables::get_eof_token() const {
+	return m_header->m_eof_token;
+}
+
+std::size_t syn::BinaryTables::get_token_count() const {
+	return m_header->m_token_count;
+}
+
+const char* syn::BinaryTables::get_token_name(InternalTk token) const {
+	assert(static_cast<bin::U32>(token) < m_header->m_token_count);
+	return m_strings + m_token_recs[token].m_name;
+}
+
+const char* syn::BinaryTables::get_token_str(InternalTk token) const {
+	assert(static_cast<bin::U32>(token) < m_header->m_token_count);
+	return m_strings + m_token_recs[token].m_str;
+}
+
+std::size_t syn::BinaryTables::get_nt_count() const {
+	return m_header->m_nt_count;
+}
+
+const char* syn::BinaryTables::get_nt_name(InternalNt nt) const {
+	assert(static_cast<bin::U32>(nt) < m_header->m_nt_count);
+	return m_strings + m_nt_recs[nt].m_name;
+}
+
+std::size_t syn::BinaryTables::get_production_count() const {
+	return m_header->m_pr_count;
+}
+
+InternalNt syn::BinaryTables::get_production_nt(std::size_t pr) const {
+	assert(pr < m_header->m_pr_count);
+	return m_pr_recs[pr].m_nt;
+}
+
+std::size_t syn::BinaryTables::get_production_length(std::size_t pr) const {
+	assert(pr < m_header->m_pr_count);
+	return m_pr_recs[pr].m_length;
+}
+
+InternalTk syn::BinaryTables::find_token(const std::string& name) const {
+	for (bin::U32 i = 0; i < m_header->m_token_count; ++i) {
+		if (name == m_strings + m_token_recs[i].m_name) return i;
+	}
+	return -1;
+}
+
+InternalTk syn::BinaryTables::find_token_str(const std::string& str) const {
+	if (str.empty()) return -1;
+	for (bin::U32 i = 0; i < m_header->m_token_count; ++i) {
+		if (str == m_strings + m_token_recs[i].m_str) return i;
+	}
+	return -1;
+}
+
+InternalNt syn::BinaryTables::find_nt(const std::string& name) const {
+	for (bin::U32 i = 0; i < m_header->m_nt_count; ++i) {
+		if (name == m_strings + m_nt_recs[i].m_name) return i;
+	}
+	return -1;
+}
+
+bin::U32 syn::BinaryTables::get_start_state(InternalNt nt) const {
+	for (bin::U32 i = 0; i < m_header->m_start_count; ++i) {
+		if (static_cast<bin::U32>(nt) == m_start_recs[i].m_nt) return m_start_recs[i].m_state;
+	}
+	return bin::NONE;
+}
+
+void syn::BinaryTables::parse_cst(
+	bin::U32 start_state,
+	syn::ScannerInterface& scanner,
+	std::vector<syn::CstNode>& cst) const
+{
+	typedef CoreParser<BinaryTables>::StackEl StackEl;
+	typedef CoreParser<BinaryTables>::StackEl_Nt StackEl_Nt;
+
+	assert(start_state < m_header->m_state_count);
+	CstScanner cst_scanner(scanner);
+	CoreParser<BinaryTables> parser(*this);
+	const StackEl_Nt* root = parser.parse(m_state_recs + start_state, cst_scanner, get_eof_token());
+
+	//Convert the tree to the pre-order list. The tree is traversed without recursion, since trees
+	//produced by left-recursive productions are as deep as the input is long. A null element in the
+	//queue means the end of the subtree of the node with the given index.
+	std::vector<std::pair<const StackEl*, std::size_t>> queue;
+	std::vector<const StackEl*> sub_elements;
+	queue.push_back(std::make_pair(root, 0));
+
+	while (!queue.empty()) {
+		std::pair<const StackEl*, std::size_t> item = queue.back();
+		queue.pop_back();
+
+		if (!item.first) {
+			CstNode& node = cst[item.second];
+			node.m_size = static_cast<bin::U32>(cst.size() - item.second);
+			continue;
+		}
+
+		const StackEl* element = item.first;
+		const bin::StateRec& rec = *element->state();
+
+		CstNode node;
+		node.m_symbol = rec.m_sym;
+		node.m_size = 1;
+		node.m_value = nullptr;
+
+		if (bin::SYM_NT == rec.m_sym_type) {
+			const StackEl_Nt* nt = element->as_nt();
+			node.m_production = static_cast<bin::U32>(nt->reduce() - m_pr_recs);
+			queue.push_back(std::make_pair(nullptr, cst.size()));
+
+			sub_elements.clear();
+			nt->get_sub_elements(sub_elements);
+			for (std::size_t i = sub_elements.size(); i; --i) queue.push_back(std::make_pair(sub_elements[i - 1], 0));
+		} else {
+			node.m_production = bin::NONE;
+			const void* value = element->as_value()->value();
+			if (value != &g_no_value) node.m_value = value;
+		}
+
+		cst.push_back(node);
+	}
+}
+
+//
+//MappedFile
+//
+
+#ifndef _WIN32
+
+syn::MappedFile::MappedFile(const std::string& file_name) : m_data(nullptr), m_size(0) {
+	int fd = ::open(file_name.c_str(), O_RDONLY);
+	if (fd < 0) throw std::runtime_error("Cannot open file: " + file_name);
+
+	struct stat st;
+	if (::fstat(fd, &st) < 0) {
+		::close(fd);
+		throw std::runtime_error("Cannot read file: " + file_name);
+	}
+
+	m_size = st.st_size;
+	if (m_size) {
+		void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (MAP_FAILED == data) {
+			::close(fd);
+			throw std::runtime_error("Cannot map file: " + file_name);
+		}
+		m_data = data;
+	}
+
+	::close(fd);
+}
+
+syn::MappedFile::~MappedFile() {
+	if (m_data) ::munmap(const_cast<void*>(m_data), m_size);
+}
+
+#else
+
+syn::MappedFile::MappedFile(const std::string& file_name) : m_data(nullptr), m_size(0) {
+	std::ifstream in(file_name.c_str(), std::ios_base::in | std::ios_base::binary);
+	if (!in) throw std::runtime_error("Cannot open file: " + file_name);
+	m_buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+	m_data = m_buffer.data();
+	m_size = m_buffer.size();
+}
+
+syn::MappedFile::~MappedFile(){}
+
+#endif
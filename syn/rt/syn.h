@@ -21,8 +21,10 @@
 
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
 #include <iostream>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -32,6 +34,19 @@ namespace syn {
 	typedef bool const_bool;
 	typedef std::string const_str;
 
+	//
+	//TokenPos
+	//
+
+	//Position of a token in the input. Lines and columns start from 1; zero means an unknown position.
+	struct TokenPos {
+		std::size_t m_line;
+		std::size_t m_column;
+
+		TokenPos() : m_line(0), m_column(0){}
+		TokenPos(std::size_t line, std::size_t column) : m_line(line), m_column(column){}
+	};
+
 	//
 	//SynError
 	//
@@ -43,7 +58,20 @@ namespace syn {
 	};
 
 	class SynLexicalError : public SynError {};
-	class SynSyntaxError : public SynError {};
+	class SynBinaryError : public SynError {};
+
+	//The position is the one of the unexpected token, as reported by the scanner.
+	class SynSyntaxError : public SynError {
+		TokenPos m_pos;
+
+	public:
+		SynSyntaxError(){}
+		explicit SynSyntaxError(const TokenPos& pos) : m_pos(pos){}
+
+		const TokenPos& get_pos() const {
+			return m_pos;
+		}
+	};
 
 	//
 	//Pool
@@ -123,18 +151,36 @@ namespace syn {
 	const std::size_t ACCEPT_ACTION = SIZE_MAX;
 	const std::size_t NULL_ACTION = SIZE_MAX - 1;
 
+	//Terminator of token lists.
+	const InternalTk NULL_TOKEN = -1;
+
+	//Disambiguation filters of a reduce. When two stacks reach the same state from the same origin (i. e. the same
+	//nonterminal is recognized over the same input by different productions), a stack whose top production is
+	//preferred wins over the others, and a stack whose top production is avoided loses. A rejecting production
+	//kills all the stacks which recognize the same nonterminal over the same input.
+	enum ReduceFilter {
+		REDUCE_PREFER = 1,
+		REDUCE_AVOID = 2,
+		REDUCE_REJECT = 4
+	};
+
 	struct Shift;
 	struct Goto;
 	struct Reduce;
 	struct State;
 
-	class StackElement;
-	class StackElement_Value;
-	class StackElement_Nt;
+	template<class S, class R> class BasicStackElement;
+	template<class S, class R> class BasicStackElement_Value;
+	template<class S, class R> class BasicStackElement_Nt;
+
+	//Stack elements of parsers working on linked tables (State objects).
+	typedef BasicStackElement<State, Reduce> StackElement;
+	typedef BasicStackElement_Value<State, Reduce> StackElement_Value;
+	typedef BasicStackElement_Nt<State, Reduce> StackElement_Nt;
 
 	class ConcreteCoreParser;
-	class StacksList;
-	class StackElementPool;
+	template<class T> class StacksList;
+	template<class T> class StackElementPool;
 
 	//
 	//Shift, Goto, Reduce, State
@@ -162,8 +208,15 @@ namespace syn {
 		int m_length;
 		InternalNt m_nt;
 		InternalAction m_action;
-
-		void assign(int length, InternalNt nt, InternalAction action);
+		unsigned m_filter; //Combination of ReduceFilter flags.
+		const InternalTk* m_nofollow; //Tokens which must not follow the nonterminal, terminated by NULL_TOKEN. Can be 0.
+
+		void assign(
+			int length,
+			InternalNt nt,
+			InternalAction action,
+			unsigned filter = 0,
+			const InternalTk* nofollow = nullptr);
 	};
 
 	struct State {
@@ -193,66 +246,75 @@ namespace syn {
 	};
 
 	//
-	//StackElement
+	//BasicStackElement
 	//
 
-	//GLR parser stack element.
-	class StackElement {
-		StackElement(const StackElement&) = delete;
-		StackElement(StackElement&&) = delete;
-		StackElement& operator=(const StackElement&) = delete;
-		StackElement& operator=(StackElement&&) = delete;
+	//GLR parser stack element. S is the type of states and R is the type of productions of the tables
+	//the parser works on.
+	template<class S, class R>
+	class BasicStackElement {
+		BasicStackElement(const BasicStackElement&) = delete;
+		BasicStackElement(BasicStackElement&&) = delete;
+		BasicStackElement& operator=(const BasicStackElement&) = delete;
+		BasicStackElement& operator=(BasicStackElement&&) = delete;
 
-		friend class StacksList;
-		friend class StackElementPool;
+		template<class T> friend class StacksList;
+		template<class T> friend class StackElementPool;
 
 #ifndef NDEBUG
 		const StackElType m_type;
 #endif
 
-		StackElement* m_prev;
-		const State* m_state;
-		StackElement* m_list;
+		BasicStackElement* m_prev;
+		const S* m_state;
+		BasicStackElement* m_list;
 		std::size_t m_ref_count;
 
 #ifdef NDEBUG
-		StackElement(){}
+		BasicStackElement(){}
 #else
-		StackElement() : m_type(STACKEL_NONE){}
+		BasicStackElement() : m_type(STACKEL_NONE){}
 #endif
 
 	protected:
 #ifdef NDEBUG
-		explicit StackElement(StackElType type){}
+		explicit BasicStackElement(StackElType type){}
 #else
-		explicit StackElement(StackElType type) : m_type(type){}
+		explicit BasicStackElement(StackElType type) : m_type(type){}
 #endif
 
 		//Stack elements are pooled, they can be reused. For that reason, StackElement is initialized by
 		//the init() function, not by a constructor.
-		void init(StackElement* prev, const State* state);
+		void init(BasicStackElement* prev, const S* state) {
+			m_prev = prev;
+			m_state = state;
+			m_list = 0;
+			m_ref_count = 0;
+		}
 
 	public:
-		const State* state() const { return m_state; }
-		StackElement* prev() { return m_prev; }
+		const S* state() const { return m_state; }
+		BasicStackElement* prev() { return m_prev; }
+		const BasicStackElement* prev() const { return m_prev; }
 
-		inline const StackElement_Nt* as_nt() const;
-		inline const StackElement_Value* as_value() const;
+		inline const BasicStackElement_Nt<S, R>* as_nt() const;
+		inline const BasicStackElement_Value<S, R>* as_value() const;
 	};
 
 	//
-	//StackElement_Value
+	//BasicStackElement_Value
 	//
 
 	//Stack element which corresponds to a primitive value, produced by a token.
-	class StackElement_Value : public StackElement {
-		StackElement_Value(const StackElement_Value&) = delete;
-		StackElement_Value(StackElement_Value&&) = delete;
-		StackElement_Value& operator=(const StackElement_Value&) = delete;
-		StackElement_Value& operator=(StackElement_Value&&) = delete;
+	template<class S, class R>
+	class BasicStackElement_Value : public BasicStackElement<S, R> {
+		BasicStackElement_Value(const BasicStackElement_Value&) = delete;
+		BasicStackElement_Value(BasicStackElement_Value&&) = delete;
+		BasicStackElement_Value& operator=(const BasicStackElement_Value&) = delete;
+		BasicStackElement_Value& operator=(BasicStackElement_Value&&) = delete;
 
-		friend class StacksList;
-		friend class StackElementPool;
+		template<class T> friend class StacksList;
+		template<class T> friend class StackElementPool;
 
 		//A pointer to value is stored in stack element instead of the value itself
 		//for efficiency reasons. More than one stack node can be created for one
@@ -260,61 +322,87 @@ namespace syn {
 		//in each node. This operation can be expensive for some types, like std::string.
 		const void* m_value_ptr;
 		
-		StackElement_Value() : StackElement(STACKEL_VALUE){}
+		BasicStackElement_Value() : BasicStackElement<S, R>(STACKEL_VALUE){}
 
-		void init(StackElement* prev, const State* state, const void* value_ptr);
+		void init(BasicStackElement<S, R>* prev, const S* state, const void* value_ptr) {
+			BasicStackElement<S, R>::init(prev, state);
+			m_value_ptr = value_ptr;
+		}
 
 	public:
 		const void* value() const { return m_value_ptr; }
 	};
 
 	//
-	//StackElement_Nt
+	//BasicStackElement_Nt
 	//
 
 	//Stack element corresponding to a nonterminal.
-	class StackElement_Nt : public StackElement {
-		StackElement_Nt(const StackElement_Nt&) = delete;
-		StackElement_Nt(StackElement_Nt&&) = delete;
-		StackElement_Nt& operator=(const StackElement_Nt&) = delete;
-		StackElement_Nt& operator=(StackElement_Nt&&) = delete;
+	template<class S, class R>
+	class BasicStackElement_Nt : public BasicStackElement<S, R> {
+		BasicStackElement_Nt(const BasicStackElement_Nt&) = delete;
+		BasicStackElement_Nt(BasicStackElement_Nt&&) = delete;
+		BasicStackElement_Nt& operator=(const BasicStackElement_Nt&) = delete;
+		BasicStackElement_Nt& operator=(BasicStackElement_Nt&&) = delete;
 			
-		friend class StacksList;
-		friend class StackElementPool;
+		template<class T> friend class StacksList;
+		template<class T> friend class StackElementPool;
 
 		//It is possible to remove 'm_reduce'. Since the nonterminal and the subnodes are known, the production
 		//can be determined definitely (except if there are two equal productions, but this is an ambiguity, and
 		//it had to be detected during reduce, so now just the first production can be chosen).
-		const Reduce* m_reduce;
-		StackElement* m_sub_elements;
+		const R* m_reduce;
+		BasicStackElement<S, R>* m_sub_elements;
 
-		StackElement_Nt() : StackElement(STACKEL_NT){}
+		BasicStackElement_Nt() : BasicStackElement<S, R>(STACKEL_NT){}
 		
 		void init(
-			StackElement* prev,
-			const State* state,
-			const Reduce* reduce,
-			StackElement* sub_elements);
+			BasicStackElement<S, R>* prev,
+			const S* state,
+			const R* reduce,
+			BasicStackElement<S, R>* sub_elements)
+		{
+			BasicStackElement<S, R>::init(prev, state);
+			m_reduce = reduce;
+			m_sub_elements = sub_elements;
+		}
 
 	public:
-		const Reduce* reduce() const { return m_reduce; }
-		const StackElement* sub_elements() const { return m_sub_elements; }
+		const R* reduce() const { return m_reduce; }
+		const BasicStackElement<S, R>* sub_elements() const { return m_sub_elements; }
 		InternalAction action() const { return m_reduce->m_action; }
-		void get_sub_elements(std::vector<const StackElement*>& v) const;
+		void get_sub_elements(std::vector<const BasicStackElement<S, R>*>& v) const;
 	};
 
-	const StackElement_Nt* StackElement::as_nt() const {
+	template<class S, class R>
+	const BasicStackElement_Nt<S, R>* BasicStackElement<S, R>::as_nt() const {
 #ifndef NDEBUG
 		assert(STACKEL_NT == m_type);
 #endif
-		return static_cast<const StackElement_Nt*>(this);
+		return static_cast<const BasicStackElement_Nt<S, R>*>(this);
 	}
 
-	const StackElement_Value* StackElement::as_value() const {
+	template<class S, class R>
+	const BasicStackElement_Value<S, R>* BasicStackElement<S, R>::as_value() const {
 #ifndef NDEBUG
 		assert(STACKEL_VALUE == m_type);
 #endif
-		return static_cast<const StackElement_Value*>(this);
+		return static_cast<const BasicStackElement_Value<S, R>*>(this);
+	}
+
+	template<class S, class R>
+	void BasicStackElement_Nt<S, R>::get_sub_elements(std::vector<const BasicStackElement<S, R>*>& v) const {
+		std::size_t ofs = v.size();
+		std::size_t len = m_reduce->m_length;
+		v.resize(ofs + len);
+
+		const BasicStackElement<S, R>* element = m_sub_elements;
+		while (len) {
+			assert(element);
+			--len;
+			v[ofs + len] = element;
+			element = element->prev();
+		}
 	}
 
 	//
@@ -327,6 +415,26 @@ namespace syn {
 
 	public:
 		virtual std::pair<InternalTk, const void*> scan() = 0;
+
+		//Returns the position of the last scanned token. Needed by parse_chunks(), which scans the whole input
+		//before parsing. By default, positions are unknown.
+		virtual TokenPos get_token_pos() const {
+			return TokenPos();
+		}
+	};
+
+	//
+	//ResyncTokens
+	//
+
+	//Describes candidate top-level boundaries of an input for chunked parsing. A token from m_boundaries
+	//is a boundary if it is met at nesting depth 0; the depth is increased by m_open tokens and decreased
+	//by m_close tokens. The grammar must allow the start nonterminal to be split at any such boundary,
+	//i. e. the start nonterminal is a list of items, and a boundary token always ends an item.
+	struct ResyncTokens {
+		std::vector<InternalTk> m_boundaries;
+		std::vector<InternalTk> m_open;
+		std::vector<InternalTk> m_close;
 	};
 
 	//
@@ -338,7 +446,23 @@ namespace syn {
 		ParserInterface(){}
 
 	public:
+		virtual ~ParserInterface(){}
+
 		virtual StackElement_Nt* parse(const State* start_state, ScannerInterface& scanner, InternalTk tk_eof) = 0;
+
+		//Scans the whole input, splits it into chunks at resync boundaries and parses the chunks in parallel.
+		//A chunk which ends in the middle of a sentence (the boundary was a false one) is parsed together
+		//with the next chunk, and if that does not help, together with the rest of the input. A syntax error
+		//is reported at the position of the unexpected token. The results are appended to the vector in the
+		//order of the input; each is a tree of the start nonterminal.
+		virtual void parse_chunks(
+			const State* start_state,
+			ScannerInterface& scanner,
+			InternalTk tk_eof,
+			const ResyncTokens& resync,
+			std::size_t thread_count,
+			std::vector<StackElement_Nt*>& results) = 0;
+
 		static std::unique_ptr<ParserInterface> create();
 	};
 
@@ -369,6 +493,37 @@ namespace syn {
 		ValuePool& get_value_pool() {
 			return m_value_pool;
 		}
+
+		Scanner& get_scanner() {
+			return m_scanner;
+		}
+	};
+
+	//
+	//SynPosScannerCore
+	//
+
+	//Scanner core which reports positions of tokens, used for chunked parsing. The scanner must have
+	//a function TokenPos get_token_pos() const.
+	template<class Scanner, class ValuePool, class TokenValue>
+	class SynPosScannerCore : public ScannerInterface {
+		SynPosScannerCore(const SynPosScannerCore&) = delete;
+		SynPosScannerCore(SynPosScannerCore&&) = delete;
+		SynPosScannerCore& operator=(const SynPosScannerCore&) = delete;
+		SynPosScannerCore& operator=(SynPosScannerCore&&) = delete;
+
+		SynScannerCore<Scanner, ValuePool, TokenValue>& m_core;
+
+	public:
+		explicit SynPosScannerCore(SynScannerCore<Scanner, ValuePool, TokenValue>& core) : m_core(core){}
+
+		std::pair<InternalTk, const void*> scan() override {
+			return m_core.scan();
+		}
+
+		TokenPos get_token_pos() const override {
+			return m_core.get_scanner().get_token_pos();
+		}
 	};
 
 	//
@@ -397,6 +552,219 @@ namespace syn {
 		StackElement_Nt* parse(const State* start) {
 			return m_parser->parse(start, m_scanner_core, eof_token);
 		}
+
+		void parse_chunks(
+			const State* start,
+			const ResyncTokens& resync,
+			std::size_t thread_count,
+			std::vector<StackElement_Nt*>& results)
+		{
+			SynPosScannerCore<Scanner, ValuePool, TokenValue> scanner_core(m_scanner_core);
+			m_parser->parse_chunks(start, scanner_core, eof_token, resync, thread_count, results);
+		}
+	};
+
+	//
+	//bin
+	//
+
+	//Binary LR tables format. The data consists of a Header followed by sections in this order: states,
+	//shifts, gotos, reduces, start states, tokens, nonterminals, productions, follow restrictions, strings. The sizes of the
+	//sections are defined by the header counters. All numbers are 32-bit unsigned integers in the native
+	//byte order, all references are indexes or offsets, so the data can be used at any address without
+	//modification, e. g. directly from a memory-mapped file.
+	namespace bin {
+		typedef std::uint32_t U32;
+
+		const U32 MAGIC = 0x544e5953; //"SYNT"
+		const U32 VERSION = 2;
+		const U32 NONE = UINT32_MAX;
+
+		enum SymType {
+			SYM_NONE,
+			SYM_TOKEN,
+			SYM_NT
+		};
+
+		struct Header {
+			U32 m_magic;
+			U32 m_version;
+			U32 m_source_hash_lo;
+			U32 m_source_hash_hi;
+			U32 m_eof_token;
+			U32 m_state_count;
+			U32 m_shift_count;
+			U32 m_goto_count;
+			U32 m_reduce_count;
+			U32 m_start_count;
+			U32 m_token_count;
+			U32 m_nt_count;
+			U32 m_pr_count;
+			U32 m_nofollow_size;
+			U32 m_string_size;
+		};
+
+		//m_sym is the token or the nonterminal by which the state is entered (NONE for a start state).
+		struct StateRec {
+			U32 m_sym;
+			U32 m_sym_type;
+			U32 m_shift_ofs;
+			U32 m_shift_count;
+			U32 m_goto_ofs;
+			U32 m_goto_count;
+			U32 m_reduce_ofs;
+			U32 m_reduce_count;
+		};
+
+		struct ShiftRec {
+			U32 m_state;
+			U32 m_token;
+		};
+
+		struct GotoRec {
+			U32 m_state;
+			U32 m_nt;
+		};
+
+		//m_pr is NONE for the accept action.
+		struct ReduceRec {
+			U32 m_pr;
+		};
+
+		struct StartRec {
+			U32 m_nt;
+			U32 m_state;
+		};
+
+		//Names are offsets in the strings section. m_str is the literal of a literal token, or an empty
+		//string for a named token.
+		struct TokenRec {
+			U32 m_name;
+			U32 m_str;
+		};
+
+		struct NtRec {
+			U32 m_name;
+		};
+
+		//m_filter is a combination of ReduceFilter flags. m_nofollow is the offset of the follow restriction
+		//of the nonterminal in the follow restrictions section (a NONE-terminated list of tokens), or NONE.
+		struct PrRec {
+			U32 m_nt;
+			U32 m_length;
+			U32 m_filter;
+			U32 m_nofollow;
+		};
+	}
+
+	//
+	//CstNode
+	//
+
+	//Node of a flat concrete syntax tree. Nodes are stored in pre-order, so a node is followed by its
+	//subtree; m_size is the number of nodes in the subtree, including the node itself.
+	struct CstNode {
+		bin::U32 m_symbol; //Token for a token node, nonterminal for a nonterminal node.
+		bin::U32 m_production; //bin::NONE for a token node.
+		bin::U32 m_size;
+		const void* m_value; //Value returned by the scanner for a token node.
+
+		bool is_token() const { return bin::NONE == m_production; }
+	};
+
+	//
+	//BinaryTables
+	//
+
+	//LR tables loaded from the binary format. The records are used in place: the parser refers to states by
+	//their records and follows indexes of states and productions, so loading only validates the data, which
+	//must outlive the tables.
+	class BinaryTables {
+		BinaryTables(const BinaryTables&) = delete;
+		BinaryTables(BinaryTables&&) = delete;
+		BinaryTables& operator=(const BinaryTables&) = delete;
+		BinaryTables& operator=(BinaryTables&&) = delete;
+
+		template<class T> friend class CoreParser;
+		template<class T> friend class StacksList;
+		template<class T> friend class StackElementPool;
+
+		const bin::Header* m_header;
+		const bin::StateRec* m_state_recs;
+		const bin::ShiftRec* m_shift_recs;
+		const bin::GotoRec* m_goto_recs;
+		const bin::ReduceRec* m_reduce_recs;
+		const bin::StartRec* m_start_recs;
+		const bin::TokenRec* m_token_recs;
+		const bin::NtRec* m_nt_recs;
+		const bin::PrRec* m_pr_recs;
+		const bin::U32* m_nofollow_recs;
+		const char* m_strings;
+
+		//Tables access used by the parser.
+		typedef bin::StateRec StateType;
+		typedef bin::PrRec ReduceType;
+
+		bool is_nt_state(const bin::StateRec* state) const;
+		bool is_value_state(const bin::StateRec* state) const;
+		std::size_t get_state_index(const bin::StateRec* state) const;
+		template<class F> void for_each_shift(const bin::StateRec* state, InternalTk token, F f) const;
+		const bin::StateRec* find_goto(const bin::StateRec* state, InternalNt nt) const;
+		template<class F> void for_each_reduce(const bin::StateRec* state, F f) const;
+		bool is_follow_allowed(const bin::PrRec* pr, InternalTk lookahead) const;
+
+	public:
+		//Throws SynBinaryError if the data is not valid.
+		BinaryTables(const void* data, std::size_t size);
+
+		std::uint64_t get_source_hash() const;
+		InternalTk get_eof_token() const;
+
+		std::size_t get_token_count() const;
+		const char* get_token_name(InternalTk token) const;
+		const char* get_token_str(InternalTk token) const;
+
+		std::size_t get_nt_count() const;
+		const char* get_nt_name(InternalNt nt) const;
+
+		std::size_t get_production_count() const;
+		InternalNt get_production_nt(std::size_t pr) const;
+		std::size_t get_production_length(std::size_t pr) const;
+
+		//Return -1 if not found.
+		InternalTk find_token(const std::string& name) const;
+		InternalTk find_token_str(const std::string& str) const;
+		InternalNt find_nt(const std::string& name) const;
+
+		//Returns the index of the start state, or bin::NONE if the nonterminal is not a start nonterminal.
+		bin::U32 get_start_state(InternalNt nt) const;
+
+		//Parses the input and appends the tree of the start nonterminal to the vector.
+		void parse_cst(bin::U32 start_state, ScannerInterface& scanner, std::vector<CstNode>& cst) const;
+	};
+
+	//
+	//MappedFile
+	//
+
+	//Read-only memory-mapped file. Where memory mapping is not supported, the file is read into memory.
+	class MappedFile {
+		MappedFile(const MappedFile&) = delete;
+		MappedFile(MappedFile&&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile& operator=(MappedFile&&) = delete;
+
+		const void* m_data;
+		std::size_t m_size;
+		std::vector<char> m_buffer;
+
+	public:
+		//Throws std::runtime_error if the file cannot be read.
+		explicit MappedFile(const std::string& file_name);
+		~MappedFile();
+
+		const void* data() const { return m_data; }
+		std::size_t size() const { return m_size; }
 	};
 
 	template<class Ch>
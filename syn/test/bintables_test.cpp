@@ -0,0 +1,249 @@
+/*
+ * Copyright 2014 Anton Karmanov
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//Unit tests for binary LR tables.
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/bintables.h"
+#include "core/util_string.h"
+#include "rt/syn.h"
+
+#include "unittest.h"
+
+namespace ns = synbin;
+namespace util = ns::util;
+
+namespace {
+
+	const char* const g_grammar =
+		"%token NAME;"
+		"@List : Item* ;"
+		"Item : NAME \";\" | \"(\" Item* \")\" \";\" ;";
+
+	std::string compile_test_grammar() {
+		return ns::compile_grammar_to_binary(g_grammar, util::String("test"));
+	}
+
+	//
+	//TestScanner
+	//
+
+	//Letters are NAME tokens, other characters are literal tokens.
+	class TestScanner : public syn::ScannerInterface {
+		const syn::BinaryTables& m_tables;
+		const std::string m_text;
+		std::size_t m_pos;
+
+	public:
+		TestScanner(const syn::BinaryTables& tables, const std::string& text)
+			: m_tables(tables), m_text(text), m_pos(0)
+		{}
+
+		std::pair<syn::InternalTk, const void*> scan() override {
+			if (m_pos == m_text.size()) return std::make_pair(m_tables.get_eof_token(), nullptr);
+
+			const char* ptr = m_text.c_str() + m_pos;
+			char c = m_text[m_pos++];
+			if (c >= 'a' && c <= 'z') return std::make_pair(m_tables.find_token("NAME"), ptr);
+
+			syn::InternalTk token = m_tables.find_token_str(std::string(1, c));
+			if (token < 0) throw syn::SynLexicalError();
+			return std::make_pair(token, nullptr);
+		}
+	};
+
+	//Converts a CST into a string: tokens are printed as their names or literals, nonterminals as
+	//their names followed by the subtree in parentheses.
+	std::size_t cst_to_string(
+		const syn::BinaryTables& tables,
+		const std::vector<syn::CstNode>& cst,
+		std::size_t index,
+		std::string& str)
+	{
+		const syn::CstNode& node = cst[index];
+		if (node.is_token()) {
+			if (node.m_value) {
+				str += *static_cast<const char*>(node.m_value);
+			} else {
+				str += tables.get_token_str(node.m_symbol);
+			}
+			return index + 1;
+		}
+
+		std::string name = tables.get_nt_name(node.m_symbol);
+		if (name == "Item") str += "[";
+		std::size_t end = index + node.m_size;
+		for (std::size_t i = index + 1; i < end; ) i = cst_to_string(tables, cst, i, str);
+		if (name == "Item") str += "]";
+		return end;
+	}
+
+	std::string parse_to_string(const syn::BinaryTables& tables, const std::string& text) {
+		TestScanner scanner(tables, text);
+		std::vector<syn::CstNode> cst;
+		tables.parse_cst(tables.get_start_state(tables.find_nt("List")), scanner, cst);
+		assertEquals(cst.size(), cst[0].m_size);
+
+		std::string str;
+		cst_to_string(tables, cst, 0, str);
+		return str;
+	}
+
+	std::string parse_grammar_to_string(const char* grammar, const std::string& text) {
+		std::string data = ns::compile_grammar_to_binary(grammar, util::String("test"));
+		syn::BinaryTables tables(data.data(), data.size());
+		return parse_to_string(tables, text);
+	}
+
+}
+
+namespace {//anonymous
+
+TEST(names) {
+	std::string data = compile_test_grammar();
+	syn::BinaryTables tables(data.data(), data.size());
+
+	assertEquals("SYS_EOF", tables.get_token_name(tables.get_eof_token()));
+	assertTrue(tables.find_token("NAME") >= 0);
+	assertTrue(tables.find_token_str(";") >= 0);
+	assertTrue(tables.find_token_str("(") >= 0);
+	assertEquals(-1, tables.find_token_str("+"));
+	assertEquals(-1, tables.find_token("UNKNOWN"));
+
+	syn::InternalNt list_nt = tables.find_nt("List");
+	syn::InternalNt item_nt = tables.find_nt("Item");
+	assertTrue(list_nt >= 0);
+	assertTrue(item_nt >= 0);
+	assertTrue(syn::bin::NONE != tables.get_start_state(list_nt));
+	assertEquals(syn::bin::NONE, tables.get_start_state(item_nt));
+	assertEquals(ns::get_grammar_source_hash(g_grammar), tables.get_source_hash());
+}
+
+TEST(parse_cst) {
+	std::string data = compile_test_grammar();
+	syn::BinaryTables tables(data.data(), data.size());
+
+	assertEquals("", parse_to_string(tables, ""));
+	assertEquals("[a;]", parse_to_string(tables, "a;"));
+	assertEquals("[a;][([b;][c;]);][d;]", parse_to_string(tables, "a;(b;c;);d;"));
+}
+
+TEST(parse_cst_syntax_error) {
+	std::string data = compile_test_grammar();
+	syn::BinaryTables tables(data.data(), data.size());
+
+	try {
+		parse_to_string(tables, "a;(b;");
+		fail();
+	} catch (const syn::SynSyntaxError&) {
+		//OK.
+	}
+}
+
+TEST(parse_cst_prefer) {
+	//Dangling else: the else part belongs to the outer if.
+	const char* grammar =
+		"%token NAME;"
+		"@List : Item* ;"
+		"Item : \"?\" Item | \"?\" Item \":\" Item %prefer | NAME \";\" ;";
+	assertEquals("[?[?[a;]]:[b;]]", parse_grammar_to_string(grammar, "??a;:b;"));
+}
+
+TEST(parse_cst_avoid) {
+	const char* grammar =
+		"%token NAME;"
+		"@List : Item* ;"
+		"Item : \"?\" Item %avoid | \"?\" Item \":\" Item | NAME \";\" ;";
+	assertEquals("[?[?[a;]]:[b;]]", parse_grammar_to_string(grammar, "??a;:b;"));
+}
+
+TEST(parse_cst_reject) {
+	const char* grammar =
+		"%token NAME;"
+		"@List : Item* ;"
+		"Item : Id \";\" ;"
+		"Id : Atom+ | \"#\" \"#\" %reject ;"
+		"Atom : NAME | \"#\" ;";
+	assertEquals("[#a#;][a##;]", parse_grammar_to_string(grammar, "#a#;a##;"));
+	try {
+		parse_grammar_to_string(grammar, "##;");
+		fail();
+	} catch (const syn::SynSyntaxError&) {
+		//OK.
+	}
+}
+
+TEST(parse_cst_nofollow) {
+	//A single name item cannot be followed by a name, so names are paired first.
+	const char* grammar =
+		"%token NAME;"
+		"@List : Item* ;"
+		"Item : Single | Pair ;"
+		"Single %nofollow(NAME) : NAME ;"
+		"Pair : NAME NAME ;";
+	assertEquals("[ab][c]", parse_grammar_to_string(grammar, "abc"));
+	assertEquals("[ab][cd]", parse_grammar_to_string(grammar, "abcd"));
+}
+
+TEST(invalid_data) {
+	std::string data = compile_test_grammar();
+
+	//Truncated.
+	try {
+		syn::BinaryTables tables(data.data(), data.size() - 4);
+		fail();
+	} catch (const syn::SynBinaryError&) {
+		//OK.
+	}
+
+	//Bad magic.
+	std::string bad_data = data;
+	bad_data[0] = 'X';
+	try {
+		syn::BinaryTables tables(bad_data.data(), bad_data.size());
+		fail();
+	} catch (const syn::SynBinaryError&) {
+		//OK.
+	}
+}
+
+TEST(load_binary_grammar) {
+	const std::string grammar_file = "bintables_test.txt";
+	const std::string cache_file = "bintables_test.synt";
+	{
+		std::ofstream out(grammar_file.c_str());
+		out << g_grammar;
+	}
+	std::remove(cache_file.c_str());
+
+	//First time compiled, second time loaded from the cache.
+	for (int i = 0; i < 2; ++i) {
+		std::unique_ptr<syn::MappedFile> file = ns::load_binary_grammar(grammar_file, cache_file);
+		syn::BinaryTables tables(file->data(), file->size());
+		assertEquals("[a;]", parse_to_string(tables, "a;"));
+	}
+
+	std::remove(grammar_file.c_str());
+	std::remove(cache_file.c_str());
+}
+
+}
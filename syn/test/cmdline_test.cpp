@@ -146,4 +146,26 @@ TEST(all_options) {
 	assertEquals("outfile", cmdline->get_out_file());
 }
 
+TEST(grammar_tables) {
+	const char* args[] = { "-G", "grm_tables.cpp", nullptr };
+	std::unique_ptr<const ns::CommandLine> cmdline = ns::CommandLine::parse_command_line(args);
+	assertNotNull(cmdline.get());
+	assertTrue(cmdline->is_grammar_tables());
+	assertEquals("grm_tables.cpp", cmdline->get_grammar_tables_file());
+	assertEquals("", cmdline->get_in_file());
+}
+
+TEST(grammar_tables_no_file_name) {
+	const char* args[] = { "-G", nullptr };
+	std::unique_ptr<const ns::CommandLine> cmdline = ns::CommandLine::parse_command_line(args);
+	assertNull(cmdline.get());
+}
+
+TEST(grammar_tables_source_file) {
+	//The source file must not be given, so it cannot be overwritten by mistake.
+	const char* args[] = { "-G", "grm_tables.cpp", "filename.txt", nullptr };
+	std::unique_ptr<const ns::CommandLine> cmdline = ns::CommandLine::parse_command_line(args);
+	assertNull(cmdline.get());
+}
+
 }
@@ -64,6 +64,11 @@ namespace {
 
 namespace {//anonymous
 
+TEST(tables_up_to_date) {
+	//If this fails, regenerate grm_tables.cpp: "syn -G grm_tables.cpp".
+	assertTrue(prs::check_tables());
+}
+
 TEST(empty_grammar) {
 	test_fail("", "test(1:1): Syntax error");
 }
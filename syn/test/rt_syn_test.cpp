@@ -0,0 +1,321 @@
+/*
+ * Copyright 2014 Anton Karmanov
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//Unit tests for the run-time library parser.
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rt/syn.h"
+
+#include "unittest.h"
+
+namespace {
+
+	//Grammar:
+	//	L : L S | S ;
+	//	S : 'a' ';' | '(' L ')' ';' ;
+
+	enum {
+		TK_EOF,
+		TK_A,
+		TK_SEMICOLON,
+		TK_OPEN,
+		TK_CLOSE
+	};
+
+	enum {
+		NT_L,
+		NT_S
+	};
+
+	enum {
+		ACT_L_LS,
+		ACT_L_S,
+		ACT_S_A,
+		ACT_S_BLOCK
+	};
+
+	//
+	//TestTables
+	//
+
+	struct TestTables {
+		syn::Shift shifts[16];
+		syn::Goto gotos[8];
+		syn::Reduce reduces[12];
+		syn::State states[10];
+
+		TestTables() {
+			syn::Shift* sh = shifts;
+			syn::Goto* gt = gotos;
+			syn::Reduce* rd = reduces;
+			syn::State* st = states;
+
+			//0: start.
+			const syn::Shift* sh0 = sh;
+			(sh++)->assign(st + 3, TK_A);
+			(sh++)->assign(st + 5, TK_OPEN);
+			(sh++)->assign(nullptr, 0);
+			const syn::Goto* gt0 = gt;
+			(gt++)->assign(st + 1, NT_L);
+			(gt++)->assign(st + 2, NT_S);
+			(gt++)->assign(nullptr, 0);
+			st[0].assign(0, sh0, gt0, nullptr, syn::State::sym_none);
+
+			//1: L' : L . ; L : L . S
+			const syn::Shift* sh1 = sh;
+			(sh++)->assign(st + 3, TK_A);
+			(sh++)->assign(st + 5, TK_OPEN);
+			(sh++)->assign(nullptr, 0);
+			const syn::Goto* gt1 = gt;
+			(gt++)->assign(st + 4, NT_S);
+			(gt++)->assign(nullptr, 0);
+			const syn::Reduce* rd1 = rd;
+			(rd++)->assign(0, 0, syn::ACCEPT_ACTION);
+			(rd++)->assign(0, 0, syn::NULL_ACTION);
+			st[1].assign(1, sh1, gt1, rd1, syn::State::sym_nt);
+
+			//2: L : S .
+			const syn::Reduce* rd2 = rd;
+			(rd++)->assign(1, NT_L, ACT_L_S);
+			(rd++)->assign(0, 0, syn::NULL_ACTION);
+			st[2].assign(2, nullptr, nullptr, rd2, syn::State::sym_nt);
+
+			//3: S : 'a' . ';'
+			const syn::Shift* sh3 = sh;
+			(sh++)->assign(st + 6, TK_SEMICOLON);
+			(sh++)->assign(nullptr, 0);
+			st[3].assign(3, sh3, nullptr, nullptr, syn::State::sym_none);
+
+			//4: L : L S .
+			const syn::Reduce* rd4 = rd;
+			(rd++)->assign(2, NT_L, ACT_L_LS);
+			(rd++)->assign(0, 0, syn::NULL_ACTION);
+			st[4].assign(4, nullptr, nullptr, rd4, syn::State::sym_nt);
+
+			//5: S : '(' . L ')' ';'
+			const syn::Goto* gt5 = gt;
+			(gt++)->assign(st + 7, NT_L);
+			(gt++)->assign(st + 2, NT_S);
+			(gt++)->assign(nullptr, 0);
+			st[5].assign(5, sh0, gt5, nullptr, syn::State::sym_none);
+
+			//6: S : 'a' ';' .
+			const syn::Reduce* rd6 = rd;
+			(rd++)->assign(2, NT_S, ACT_S_A);
+			(rd++)->assign(0, 0, syn::NULL_ACTION);
+			st[6].assign(6, nullptr, nullptr, rd6, syn::State::sym_none);
+
+			//7: S : '(' L . ')' ';' ; L : L . S
+			const syn::Shift* sh7 = sh;
+			(sh++)->assign(st + 8, TK_CLOSE);
+			(sh++)->assign(st + 3, TK_A);
+			(sh++)->assign(st + 5, TK_OPEN);
+			(sh++)->assign(nullptr, 0);
+			st[7].assign(7, sh7, gt1, nullptr, syn::State::sym_nt);
+
+			//8: S : '(' L ')' . ';'
+			const syn::Shift* sh8 = sh;
+			(sh++)->assign(st + 9, TK_SEMICOLON);
+			(sh++)->assign(nullptr, 0);
+			st[8].assign(8, sh8, nullptr, nullptr, syn::State::sym_none);
+
+			//9: S : '(' L ')' ';' .
+			const syn::Reduce* rd9 = rd;
+			(rd++)->assign(4, NT_S, ACT_S_BLOCK);
+			(rd++)->assign(0, 0, syn::NULL_ACTION);
+			st[9].assign(9, nullptr, nullptr, rd9, syn::State::sym_none);
+		}
+	};
+
+	const TestTables g_tables;
+
+	//
+	//TestScanner
+	//
+
+	//Spaces and line breaks are skipped.
+	class TestScanner : public syn::ScannerInterface {
+		const std::string m_text;
+		std::size_t m_pos;
+		syn::TokenPos m_next_pos;
+		syn::TokenPos m_token_pos;
+
+	public:
+		explicit TestScanner(const std::string& text) : m_text(text), m_pos(0), m_next_pos(1, 1){}
+
+		std::pair<syn::InternalTk, const void*> scan() override {
+			while (m_pos < m_text.size() && (' ' == m_text[m_pos] || '\n' == m_text[m_pos])) {
+				if ('\n' == m_text[m_pos]) {
+					++m_next_pos.m_line;
+					m_next_pos.m_column = 1;
+				} else {
+					++m_next_pos.m_column;
+				}
+				++m_pos;
+			}
+			m_token_pos = m_next_pos;
+
+			syn::InternalTk token = TK_EOF;
+			if (m_pos < m_text.size()) {
+				++m_next_pos.m_column;
+				char c = m_text[m_pos++];
+				if ('a' == c) {
+					token = TK_A;
+				} else if (';' == c) {
+					token = TK_SEMICOLON;
+				} else if ('(' == c) {
+					token = TK_OPEN;
+				} else if (')' == c) {
+					token = TK_CLOSE;
+				} else {
+					throw syn::SynLexicalError();
+				}
+			}
+			return std::make_pair(token, nullptr);
+		}
+
+		syn::TokenPos get_token_pos() const override {
+			return m_token_pos;
+		}
+	};
+
+	//Counts 'S' nodes. Iterative, since the trees of large inputs are deep.
+	std::size_t count_statements(const syn::StackElement_Nt* root) {
+		std::size_t count = 0;
+		std::vector<const syn::StackElement*> queue;
+		queue.push_back(root);
+		while (!queue.empty()) {
+			const syn::StackElement* element = queue.back();
+			queue.pop_back();
+			if (syn::State::sym_nt == element->state()->m_sym_type) {
+				const syn::StackElement_Nt* nt = element->as_nt();
+				if (NT_S == nt->reduce()->m_nt) ++count;
+				nt->get_sub_elements(queue);
+			}
+		}
+		return count;
+	}
+
+	syn::ResyncTokens create_resync_tokens(bool brackets) {
+		syn::ResyncTokens resync;
+		resync.m_boundaries.push_back(TK_SEMICOLON);
+		if (brackets) {
+			resync.m_open.push_back(TK_OPEN);
+			resync.m_close.push_back(TK_CLOSE);
+		}
+		return resync;
+	}
+
+	std::size_t parse_chunks(
+		const std::string& text,
+		bool brackets,
+		std::size_t thread_count,
+		std::size_t* chunk_count)
+	{
+		TestScanner scanner(text);
+		std::unique_ptr<syn::ParserInterface> parser = syn::ParserInterface::create();
+		std::vector<syn::StackElement_Nt*> results;
+		parser->parse_chunks(&g_tables.states[0], scanner, TK_EOF, create_resync_tokens(brackets), thread_count, results);
+
+		std::size_t count = 0;
+		for (const syn::StackElement_Nt* result : results) count += count_statements(result);
+		*chunk_count = results.size();
+		return count;
+	}
+
+	std::string repeat(const std::string& str, std::size_t n) {
+		std::string result;
+		for (std::size_t i = 0; i < n; ++i) result += str;
+		return result;
+	}
+
+}
+
+namespace {//anonymous
+
+TEST(parse_sequential) {
+	TestScanner scanner("a;(a;a;);");
+	std::unique_ptr<syn::ParserInterface> parser = syn::ParserInterface::create();
+	syn::StackElement_Nt* result = parser->parse(&g_tables.states[0], scanner, TK_EOF);
+	assertEquals(4, count_statements(result));
+}
+
+TEST(parse_chunks__single_thread) {
+	std::size_t chunk_count;
+	assertEquals(40000, parse_chunks(repeat("a;(a;a;);", 10000), true, 1, &chunk_count));
+	assertEquals(1, chunk_count);
+}
+
+TEST(parse_chunks__parallel) {
+	std::size_t chunk_count;
+	assertEquals(40000, parse_chunks(repeat("a;(a;a;);", 10000), true, 4, &chunk_count));
+	assertTrue(chunk_count > 1);
+}
+
+TEST(parse_chunks__false_boundaries) {
+	//Without brackets, semicolons inside the brackets are boundaries too. Chunks starting or ending
+	//inside brackets must be merged.
+	std::string nested = "(" + repeat("a;", 3000) + ");";
+	std::string text = repeat("a;", 5000) + nested + repeat("a;", 5000) + nested + repeat("a;", 5000);
+	std::size_t chunk_count;
+	assertEquals(15000 + 2 * 3001, parse_chunks(text, false, 4, &chunk_count));
+}
+
+TEST(parse_chunks__syntax_error) {
+	std::string text = repeat("a;", 10000) + "a" + repeat("a;", 10000);
+	try {
+		std::size_t chunk_count;
+		parse_chunks(text, true, 4, &chunk_count);
+		fail();
+	} catch (const syn::SynSyntaxError&) {
+		//OK.
+	}
+}
+
+TEST(parse_chunks__syntax_error_position) {
+	//The error is in a middle chunk. It must be reported at the unexpected token, like by the sequential parser,
+	//though the whole input has been scanned before parsing.
+	std::string text = repeat("a;\n", 10000) + "a; (a; a a;);\n" + repeat("a;\n", 10000);
+	const std::size_t thread_counts[] = { 1, 4 };
+	for (std::size_t thread_count : thread_counts) {
+		try {
+			std::size_t chunk_count;
+			parse_chunks(text, true, thread_count, &chunk_count);
+			fail();
+		} catch (const syn::SynSyntaxError& e) {
+			assertEquals(10001, e.get_pos().m_line);
+			assertEquals(10, e.get_pos().m_column);
+		}
+	}
+}
+
+TEST(parse_chunks__syntax_error_at_eof) {
+	std::string text = repeat("a;\n", 10000) + "(a;\n" + repeat("a;\n", 10000);
+	try {
+		std::size_t chunk_count;
+		parse_chunks(text, false, 4, &chunk_count);
+		fail();
+	} catch (const syn::SynSyntaxError& e) {
+		assertEquals(20002, e.get_pos().m_line);
+		assertEquals(1, e.get_pos().m_column);
+	}
+}
+
+}